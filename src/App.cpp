@@ -25,15 +25,21 @@
 #include "AudioSingletons.h"
 #include "ColourScheme.h"
 #include "CrashProtection.h"
+#include "DiskIOScheduler.h"
 #include "Images.h"
 #include "JuceHelperStuff.h"
+#include "LibraryWatcher.h"
 #include "LogFile.h"
 #include "MainTransport.h"
+#include "MediaCache.h"
 #include "MidiMappingManager.h"
 #include "NiallsAudioPluginFormat.h"
 #include "OscMappingManager.h"
+#include "PartitionedConvolver.h"
+#include "PerfTrace.h"
 #include "SettingsManager.h"
 #include "TrayIcon.h"
+#include "WaveformCache.h"
 
 #include <spdlog/sinks/basic_file_sink.h>
 #include <spdlog/spdlog.h>
@@ -86,6 +92,18 @@ void App::initialise(const String& commandLine)
         LogFile::getInstance().logEvent("Pedalboard", "Pedalboard3 v3.0 starting...");
     }
 
+    // --trace <file> records a performance trace of the whole session
+    {
+        StringArray args;
+        args.addTokens(commandLine, true);
+        const int traceArg = args.indexOf("--trace");
+        if (traceArg >= 0 && traceArg + 1 < args.size())
+        {
+            traceFile = File::getCurrentWorkingDirectory().getChildFile(args[traceArg + 1].unquoted());
+            PerfTrace::getInstance().start();
+        }
+    }
+
     win = new StupidWindow(commandLine, (useTrayIcon && startInTray));
 
 #ifndef __APPLE__
@@ -116,6 +134,9 @@ void App::shutdown()
 
     MainTransport::deleteInstance();
 
+    if (traceFile != File())
+        PerfTrace::getInstance().exportChromeTrace(traceFile);
+
     // Stop crash protection watchdog
     CrashProtection::getInstance().stopWatchdog();
 }
@@ -229,8 +250,14 @@ StupidWindow::~StupidWindow()
     setContentOwned(0, true);
     LookAndFeel::setDefaultLookAndFeel(0);
 
+    WaveformCache::getInstance().shutdown(); // Reads through the AudioFormatManager
+    MediaCache::getInstance().shutdown();    // So does its setlist prefetch
+    if (auto* libraryWatcher = LibraryWatcher::getInstanceWithoutCreating())
+        libraryWatcher->shutdown(); // Posts to the message thread
+    PartitionedConvolver::shutdownBackgroundThreads();
     AudioPluginFormatManagerSingleton::killInstance();
     AudioFormatManagerSingleton::killInstance();
+    DiskIOScheduler::getInstance().shutdown();
     AudioThumbnailCacheSingleton::killInstance();
     // PropertiesSingleton::killInstance();
 }
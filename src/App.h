@@ -65,6 +65,8 @@ class App : public JUCEApplication
     DocumentWindow* win;
     ///	Pointer to our tray icon.
     TrayIcon* trayIcon;
+    ///	Where to write the performance trace at exit, if started with --trace.
+    File traceFile;
 };
 
 //------------------------------------------------------------------------------
@@ -188,6 +188,8 @@ void BypassableInstance::processBlock(AudioSampleBuffer& buffer, MidiBuffer& mid
     if (!prepared.load())
         return;
 
+    const DspLoadMeter::ScopedMeasurement measurement(loadMeter, buffer.getNumSamples());
+
     int i, j;
     float rampVal = bypassRamp;
     MidiBuffer tempMidi;
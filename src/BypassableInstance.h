@@ -21,6 +21,8 @@
 #ifndef BYPASSABLEINSTANCE_H_
 #define BYPASSABLEINSTANCE_H_
 
+#include "DspProfiler.h"
+
 #include <JuceHeader.h>
 #include <atomic>
 
@@ -299,6 +301,9 @@ class BypassableInstance : public AudioPluginInstance
 
     /// True during constructor while reconfiguring buses to match inner plugin.
     bool configuringBuses = false;
+
+    ///	Times processBlock for the DSP profiler.
+    DspLoadMeter loadMeter{*this};
 };
 
 #endif
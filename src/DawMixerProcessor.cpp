@@ -312,6 +312,7 @@ void DawMixerProcessor::processBlock(AudioBuffer<float>& buffer, MidiBuffer& /*m
     masterPeakR.store(masterPkR, std::memory_order_relaxed);
     masterVuL.store(masterPkL, std::memory_order_relaxed);
     masterVuR.store(masterPkR, std::memory_order_relaxed);
+    meterVersion.bump();
 
     // Clear unused output channels
     for (int ch = 2; ch < buffer.getNumChannels(); ++ch)
@@ -319,8 +320,17 @@ void DawMixerProcessor::processBlock(AudioBuffer<float>& buffer, MidiBuffer& /*m
 }
 
 //==============================================================================
-// Shared VU painting helper (used by both DawStripRow and DawMasterRow)
+// Shared VU painting helpers (used by both DawStripRow and DawMasterRow)
 //==============================================================================
+
+/// Width of a bar's fill; the rows only repaint their meters when it moves
+static int getVUFillWidth(float peak, int barWidth)
+{
+    float dbVal = Decibels::gainToDecibels(peak, -60.0f);
+    float norm = jlimit(0.0f, 1.0f, (dbVal + 60.0f) / 72.0f);
+    return static_cast<int>(norm * barWidth);
+}
+
 static void paintStereoVUHelper(Graphics& g, Rectangle<int> area, float peakL, float peakR)
 {
     if (area.isEmpty())
@@ -332,10 +342,9 @@ static void paintStereoVUHelper(Graphics& g, Rectangle<int> area, float peakL, f
     auto drawBar = [&](Rectangle<int> bar, float peak)
     {
         float dbVal = Decibels::gainToDecibels(peak, -60.0f);
-        float norm = jlimit(0.0f, 1.0f, (dbVal + 60.0f) / 72.0f);
         g.setColour(Colour(0xFF1A1A1A));
         g.fillRect(bar);
-        int fillW = static_cast<int>(norm * bar.getWidth());
+        int fillW = getVUFillWidth(peak, bar.getWidth());
         auto filled = bar.withWidth(fillW);
         if (dbVal > 0.0f)
             g.setColour(ColourScheme::getInstance().colours["Danger Colour"]);
@@ -521,6 +530,25 @@ class DawStripRow : public Component
         }
     }
 
+    /// Repaints the meter if either bar's fill has moved
+    void updateMeter()
+    {
+        if (auto* s = processor->getStrip(index))
+        {
+            const int width = vuArea.getWidth();
+            const int fillL = getVUFillWidth(s->peakL.load(std::memory_order_relaxed), width);
+            const int fillR = s->stereo.load(std::memory_order_relaxed)
+                                  ? getVUFillWidth(s->peakR.load(std::memory_order_relaxed), width)
+                                  : -1;
+            if (fillL != shownFillL || fillR != shownFillR)
+            {
+                shownFillL = fillL;
+                shownFillR = fillR;
+                repaint(vuArea);
+            }
+        }
+    }
+
     static void paintMonoVU(Graphics& g, Rectangle<int> area, float peak)
     {
         if (area.isEmpty())
@@ -528,10 +556,9 @@ class DawStripRow : public Component
         auto bar = area.reduced(0, 2);
 
         float dbVal = Decibels::gainToDecibels(peak, -60.0f);
-        float norm = jlimit(0.0f, 1.0f, (dbVal + 60.0f) / 72.0f);
         g.setColour(Colour(0xFF1A1A1A));
         g.fillRect(bar);
-        int fillW = static_cast<int>(norm * bar.getWidth());
+        int fillW = getVUFillWidth(peak, bar.getWidth());
         auto filled = bar.withWidth(fillW);
         if (dbVal > 0.0f)
             g.setColour(ColourScheme::getInstance().colours["Danger Colour"]);
@@ -552,6 +579,7 @@ class DawStripRow : public Component
     Slider fader, panKnob;
     Label nameLabel;
     Rectangle<int> vuArea;
+    int shownFillL = -1, shownFillR = -1;
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DawStripRow)
 };
 
@@ -610,18 +638,33 @@ class DawMasterRow : public Component
         paintStereoVUHelper(g, vuArea, peakL, peakR);
     }
 
+    /// Repaints the meter if either bar's fill has moved
+    void updateMeter()
+    {
+        const int width = vuArea.getWidth();
+        const int fillL = getVUFillWidth(processor->masterPeakL.load(std::memory_order_relaxed), width);
+        const int fillR = getVUFillWidth(processor->masterPeakR.load(std::memory_order_relaxed), width);
+        if (fillL != shownFillL || fillR != shownFillR)
+        {
+            shownFillL = fillL;
+            shownFillR = fillR;
+            repaint(vuArea);
+        }
+    }
+
   private:
     DawMixerProcessor* processor;
     TextButton muteBtn;
     Slider fader;
     Label nameLabel;
     Rectangle<int> vuArea;
+    int shownFillL = -1, shownFillR = -1;
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DawMasterRow)
 };
 
 //==============================================================================
 // Main control -- returned by getControls()
-class DawMixerControl : public Component, private Timer
+class DawMixerControl : public Component
 {
   public:
     DawMixerControl(DawMixerProcessor* proc) : processor(proc)
@@ -644,11 +687,8 @@ class DawMixerControl : public Component, private Timer
         addAndMakeVisible(masterRow.get());
 
         rebuildStrips();
-        startTimerHz(24);
     }
 
-    ~DawMixerControl() override { stopTimer(); }
-
     void rebuildStrips()
     {
         stripRows.clear();
@@ -710,13 +750,20 @@ class DawMixerControl : public Component, private Timer
             pc->refreshPins();
     }
 
-    void timerCallback() override
+    void updateMeters()
     {
+        // No block processed since the last frame means no meter has moved
+        if (!processor->meterVersion.changedSince(lastMeterVersion))
+            return;
+
         for (auto* row : stripRows)
-            row->repaint();
-        masterRow->repaint();
+            row->updateMeter();
+        masterRow->updateMeter();
     }
 
+    juce::uint32 lastMeterVersion = 0;
+    UiFrameScheduler::Client frameClient{this, 24.0, [this]() { updateMeters(); }};
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DawMixerControl)
 };
 
@@ -19,6 +19,7 @@
 #pragma once
 
 #include "PedalboardProcessors.h"
+#include "UiFrameScheduler.h"
 #include "VuMeterDsp.h"
 
 #include <JuceHeader.h>
@@ -106,6 +107,7 @@ class DawMixerProcessor : public PedalboardProcessor
     std::atomic<float> masterVuR{0.0f};
     std::atomic<float> masterPeakL{0.0f};
     std::atomic<float> masterPeakR{0.0f};
+    DisplayVersion meterVersion; // Bumped after each block's meter levels are stored
 
     // PedalboardProcessor overrides
     Component* getControls() override;
@@ -289,6 +289,7 @@ void DawSplitterProcessor::processBlock(AudioBuffer<float>& buffer, MidiBuffer&
         strip.vuL.store(peakL, std::memory_order_relaxed);
         strip.vuR.store(peakR, std::memory_order_relaxed);
     }
+    meterVersion.bump();
 
     // Clear unused output channels beyond what we wrote
     for (int ch = currentOutputChannel; ch < totalOutputChannels; ++ch)
@@ -296,8 +297,17 @@ void DawSplitterProcessor::processBlock(AudioBuffer<float>& buffer, MidiBuffer&
 }
 
 //==============================================================================
-// Shared VU painting helper (used by both SplitterStripRow and SplitterInputRow)
+// Shared VU painting helpers (used by both SplitterStripRow and SplitterInputRow)
 //==============================================================================
+
+/// Width of a bar's fill; the rows only repaint their meters when it moves
+static int getVUFillWidth(float peak, int barWidth)
+{
+    float dbVal = Decibels::gainToDecibels(peak, -60.0f);
+    float norm = jlimit(0.0f, 1.0f, (dbVal + 60.0f) / 72.0f);
+    return static_cast<int>(norm * barWidth);
+}
+
 static void paintStereoVUHelper(Graphics& g, Rectangle<int> area, float peakL, float peakR)
 {
     if (area.isEmpty())
@@ -309,10 +319,9 @@ static void paintStereoVUHelper(Graphics& g, Rectangle<int> area, float peakL, f
     auto drawBar = [&](Rectangle<int> bar, float peak)
     {
         float dbVal = Decibels::gainToDecibels(peak, -60.0f);
-        float norm = jlimit(0.0f, 1.0f, (dbVal + 60.0f) / 72.0f);
         g.setColour(Colour(0xFF1A1A1A));
         g.fillRect(bar);
-        int fillW = static_cast<int>(norm * bar.getWidth());
+        int fillW = getVUFillWidth(peak, bar.getWidth());
         auto filled = bar.withWidth(fillW);
         if (dbVal > 0.0f)
             g.setColour(ColourScheme::getInstance().colours["Danger Colour"]);
@@ -468,6 +477,25 @@ class SplitterStripRow : public Component
         }
     }
 
+    /// Repaints the meter if either bar's fill has moved
+    void updateMeter()
+    {
+        if (auto* s = processor->getStrip(index))
+        {
+            const int width = vuArea.getWidth();
+            const int fillL = getVUFillWidth(s->peakL.load(std::memory_order_relaxed), width);
+            const int fillR = s->stereo.load(std::memory_order_relaxed)
+                                  ? getVUFillWidth(s->peakR.load(std::memory_order_relaxed), width)
+                                  : -1;
+            if (fillL != shownFillL || fillR != shownFillR)
+            {
+                shownFillL = fillL;
+                shownFillR = fillR;
+                repaint(vuArea);
+            }
+        }
+    }
+
     static void paintMonoVU(Graphics& g, Rectangle<int> area, float peak)
     {
         if (area.isEmpty())
@@ -475,10 +503,9 @@ class SplitterStripRow : public Component
         auto bar = area.reduced(0, 2);
 
         float dbVal = Decibels::gainToDecibels(peak, -60.0f);
-        float norm = jlimit(0.0f, 1.0f, (dbVal + 60.0f) / 72.0f);
         g.setColour(Colour(0xFF1A1A1A));
         g.fillRect(bar);
-        int fillW = static_cast<int>(norm * bar.getWidth());
+        int fillW = getVUFillWidth(peak, bar.getWidth());
         auto filled = bar.withWidth(fillW);
         if (dbVal > 0.0f)
             g.setColour(ColourScheme::getInstance().colours["Danger Colour"]);
@@ -499,6 +526,7 @@ class SplitterStripRow : public Component
     Slider fader;
     Label nameLabel;
     Rectangle<int> vuArea;
+    int shownFillL = -1, shownFillR = -1;
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SplitterStripRow)
 };
 
@@ -534,16 +562,31 @@ class SplitterInputRow : public Component
         paintStereoVUHelper(g, vuArea, peakL, peakR);
     }
 
+    /// Repaints the meter if either bar's fill has moved
+    void updateMeter()
+    {
+        const int width = vuArea.getWidth();
+        const int fillL = getVUFillWidth(processor->inputPeakL.load(std::memory_order_relaxed), width);
+        const int fillR = getVUFillWidth(processor->inputPeakR.load(std::memory_order_relaxed), width);
+        if (fillL != shownFillL || fillR != shownFillR)
+        {
+            shownFillL = fillL;
+            shownFillR = fillR;
+            repaint(vuArea);
+        }
+    }
+
   private:
     DawSplitterProcessor* processor;
     Label nameLabel;
     Rectangle<int> vuArea;
+    int shownFillL = -1, shownFillR = -1;
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SplitterInputRow)
 };
 
 //==============================================================================
 // Main control -- returned by getControls()
-class DawSplitterControl : public Component, private Timer
+class DawSplitterControl : public Component
 {
   public:
     DawSplitterControl(DawSplitterProcessor* proc) : processor(proc)
@@ -566,11 +609,8 @@ class DawSplitterControl : public Component, private Timer
         addAndMakeVisible(inputRow.get());
 
         rebuildStrips();
-        startTimerHz(24);
     }
 
-    ~DawSplitterControl() override { stopTimer(); }
-
     void rebuildStrips()
     {
         stripRows.clear();
@@ -635,13 +675,20 @@ class DawSplitterControl : public Component, private Timer
             pc->refreshPins();
     }
 
-    void timerCallback() override
+    void updateMeters()
     {
+        // No block processed since the last frame means no meter has moved
+        if (!processor->meterVersion.changedSince(lastMeterVersion))
+            return;
+
         for (auto* row : stripRows)
-            row->repaint();
-        inputRow->repaint();
+            row->updateMeter();
+        inputRow->updateMeter();
     }
 
+    juce::uint32 lastMeterVersion = 0;
+    UiFrameScheduler::Client frameClient{this, 24.0, [this]() { updateMeters(); }};
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DawSplitterControl)
 };
 
@@ -19,6 +19,7 @@
 #pragma once
 
 #include "PedalboardProcessors.h"
+#include "UiFrameScheduler.h"
 #include "VuMeterDsp.h"
 
 #include <JuceHeader.h>
@@ -104,6 +105,7 @@ class DawSplitterProcessor : public PedalboardProcessor
     std::atomic<float> inputVuR{0.0f};
     std::atomic<float> inputPeakL{0.0f};
     std::atomic<float> inputPeakR{0.0f};
+    DisplayVersion meterVersion; // Bumped after each block's meter levels are stored
 
     // PedalboardProcessor overrides
     Component* getControls() override;
@@ -0,0 +1,165 @@
+/*
+  ==============================================================================
+
+    DiskIOScheduler.cpp
+    Prioritised disk I/O threads for recording, streaming and thumbnails
+
+  ==============================================================================
+*/
+
+#include "DiskIOScheduler.h"
+
+#include "AudioSingletons.h"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+
+namespace
+{
+constexpr int gatePollMs = 5;
+constexpr int idlePollMs = 20;
+constexpr int maxThumbnailHoldMs = 500; // Let thumbnails through now and then, however starved
+constexpr int stopTimeoutMs = 2000;
+
+const char* queueName(DiskIOScheduler::Queue queue)
+{
+    switch (queue)
+    {
+    case DiskIOScheduler::Queue::Write:
+        return "write";
+    case DiskIOScheduler::Queue::Read:
+        return "read";
+    default:
+        return "thumbnail";
+    }
+}
+} // namespace
+
+//==============================================================================
+DiskIOScheduler& DiskIOScheduler::getInstance()
+{
+    static DiskIOScheduler instance;
+    return instance;
+}
+
+DiskIOScheduler::DiskIOScheduler()
+{
+    writeThread.startThread(juce::Thread::Priority::high);
+    readThread.startThread(juce::Thread::Priority::high);
+    AudioThumbnailCacheSingleton::getInstance().getTimeSliceThread().addTimeSliceClient(&gate);
+    running = true;
+}
+
+DiskIOScheduler::~DiskIOScheduler()
+{
+    shutdown();
+}
+
+void DiskIOScheduler::shutdown()
+{
+    if (!running)
+        return;
+    running = false;
+
+    AudioThumbnailCacheSingleton::getInstance().getTimeSliceThread().removeTimeSliceClient(&gate);
+    writeThread.stopThread(stopTimeoutMs);
+    readThread.stopThread(stopTimeoutMs);
+
+    for (auto queue : {Queue::Write, Queue::Read})
+    {
+        const auto stats = getStats(queue);
+        if (stats.underruns > 0 || stats.overruns > 0)
+            spdlog::warn("[DiskIOScheduler] {} queue: {} underruns, {} overruns, lowest headroom {:.0f}%",
+                         queueName(queue), stats.underruns, stats.overruns, stats.lowestHeadroom * 100.0f);
+    }
+}
+
+//==============================================================================
+juce::TimeSliceThread& DiskIOScheduler::getThread(Queue queue)
+{
+    switch (queue)
+    {
+    case Queue::Write:
+        return writeThread;
+    case Queue::Read:
+        return readThread;
+    default:
+        return AudioThumbnailCacheSingleton::getInstance().getTimeSliceThread();
+    }
+}
+
+void DiskIOScheduler::addStream(Queue queue, Stream* stream)
+{
+    std::lock_guard<std::mutex> lock(streamMutex);
+    streams.push_back({queue, stream});
+}
+
+void DiskIOScheduler::removeStream(Stream* stream)
+{
+    std::lock_guard<std::mutex> lock(streamMutex);
+    streams.erase(std::remove_if(streams.begin(), streams.end(),
+                                 [stream](const Registration& r) { return r.stream == stream; }),
+                  streams.end());
+}
+
+//==============================================================================
+DiskIOScheduler::Stats DiskIOScheduler::getStats(Queue queue) const
+{
+    const auto& c = counters[index(queue)];
+
+    Stats stats;
+    stats.underruns = c.underruns.load(std::memory_order_relaxed);
+    stats.overruns = c.overruns.load(std::memory_order_relaxed);
+    stats.lowestHeadroom = c.lowestHeadroom.load(std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(streamMutex);
+    stats.streams = static_cast<int>(
+        std::count_if(streams.begin(), streams.end(), [queue](const Registration& r) { return r.queue == queue; }));
+    return stats;
+}
+
+void DiskIOScheduler::resetStats()
+{
+    for (auto& c : counters)
+    {
+        c.underruns.store(0, std::memory_order_relaxed);
+        c.overruns.store(0, std::memory_order_relaxed);
+        c.lowestHeadroom.store(1.0f, std::memory_order_relaxed);
+    }
+}
+
+//==============================================================================
+bool DiskIOScheduler::updateThrottle()
+{
+    float lowest = 1.0f;
+    {
+        std::lock_guard<std::mutex> lock(streamMutex);
+        for (const auto& registration : streams)
+        {
+            const float headroom = juce::jlimit(0.0f, 1.0f, registration.stream->getHeadroom());
+            lowest = juce::jmin(lowest, headroom);
+
+            auto& low = counters[index(registration.queue)].lowestHeadroom;
+            if (headroom < low.load(std::memory_order_relaxed))
+                low.store(headroom, std::memory_order_relaxed);
+        }
+    }
+
+    // Hysteresis, so thumbnails don't flap on and off around one level
+    const bool wasThrottling = throttling.load(std::memory_order_relaxed);
+    const bool nowThrottling = wasThrottling ? lowest < highWatermark : lowest < lowWatermark;
+    throttling.store(nowThrottling, std::memory_order_release);
+
+    return nowThrottling;
+}
+
+//==============================================================================
+int DiskIOScheduler::ThumbnailGate::useTimeSlice()
+{
+    // Holding this client holds the whole thumbnail thread
+    for (int held = 0; scheduler.updateThrottle() && held < maxThumbnailHoldMs; held += gatePollMs)
+        juce::Thread::sleep(gatePollMs);
+
+    return scheduler.isThrottlingThumbnails() ? gatePollMs : idlePollMs;
+}
@@ -0,0 +1,153 @@
+/*
+  ==============================================================================
+
+    DiskIOScheduler.h
+    Prioritised disk I/O threads for recording, streaming and thumbnails
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_audio_utils/juce_audio_utils.h>
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+//==============================================================================
+/**
+    Keeps real-time disk streaming off the thumbnail thread.
+
+    Each queue is its own TimeSliceThread. Recording write-behind (DiskWriter)
+    runs on Write and streaming read-ahead (file players, looper storage)
+    runs on Read; both are high priority and do nothing but keep audio
+    buffers topped up. Waveform thumbnails stay on the AudioThumbnailCache
+    thread, which is the Thumbnail queue, so a thumbnail rebuild can no
+    longer hold up a recording.
+
+    Buffered streams register themselves with their queue and report their
+    headroom: the fraction of their buffer left before the audio thread
+    would glitch (free space for a writer, buffered audio for a reader).
+    When any stream drops below lowWatermark, thumbnail work is paused until
+    every stream is back above highWatermark, leaving the disk to the
+    streams that need it.
+
+    Underruns and overruns are counted per queue; the report calls are
+    lock-free and safe from the audio thread.
+*/
+class DiskIOScheduler
+{
+  public:
+    enum class Queue
+    {
+        Write,
+        Read,
+        Thumbnail,
+        NumQueues
+    };
+
+    static constexpr float lowWatermark = 0.25f;
+    static constexpr float highWatermark = 0.5f;
+
+    /// A buffered real-time stream serviced by one of the queues
+    class Stream
+    {
+      public:
+        virtual ~Stream() = default;
+
+        /// Fraction of the stream's buffer left before the audio thread
+        /// would under/overrun (0-1). Called from the thumbnail thread.
+        virtual float getHeadroom() const = 0;
+    };
+
+    struct Stats
+    {
+        juce::int64 underruns = 0;
+        juce::int64 overruns = 0;
+        float lowestHeadroom = 1.0f; // Low-water mark since the last resetStats()
+        int streams = 0;
+    };
+
+    //==========================================================================
+    // Singleton Access
+
+    static DiskIOScheduler& getInstance();
+
+    /// Stops the threads. Call once at exit, before the AudioThumbnailCache
+    /// singleton is killed.
+    void shutdown();
+
+    //==========================================================================
+    // Queues
+
+    /// The thread that services queue; add TimeSliceClients to it
+    juce::TimeSliceThread& getThread(Queue queue);
+
+    void addStream(Queue queue, Stream* stream);
+    void removeStream(Stream* stream);
+
+    //==========================================================================
+    // Counters (any thread)
+
+    void reportUnderrun(Queue queue) { counters[index(queue)].underruns.fetch_add(1, std::memory_order_relaxed); }
+    void reportOverrun(Queue queue) { counters[index(queue)].overruns.fetch_add(1, std::memory_order_relaxed); }
+
+    Stats getStats(Queue queue) const;
+    void resetStats();
+
+    //==========================================================================
+    // Throttling
+
+    /// True while thumbnail work is paused for a starved stream
+    bool isThrottlingThumbnails() const { return throttling.load(std::memory_order_acquire); }
+
+    /// Samples every stream's headroom and applies the watermarks. Returns
+    /// isThrottlingThumbnails(). Called by the thumbnail thread.
+    bool updateThrottle();
+
+  private:
+    DiskIOScheduler();
+    ~DiskIOScheduler();
+
+    /// Runs on the thumbnail thread and holds it while streams are starved
+    class ThumbnailGate : public juce::TimeSliceClient
+    {
+      public:
+        explicit ThumbnailGate(DiskIOScheduler& owner) : scheduler(owner) {}
+        int useTimeSlice() override;
+
+      private:
+        DiskIOScheduler& scheduler;
+    };
+
+    struct Counters
+    {
+        std::atomic<juce::int64> underruns{0};
+        std::atomic<juce::int64> overruns{0};
+        std::atomic<float> lowestHeadroom{1.0f};
+    };
+
+    struct Registration
+    {
+        Queue queue;
+        Stream* stream;
+    };
+
+    static size_t index(Queue queue) { return static_cast<size_t>(queue); }
+
+    juce::TimeSliceThread writeThread{"Disk Write"};
+    juce::TimeSliceThread readThread{"Disk Read"};
+    ThumbnailGate gate{*this};
+    bool running = false;
+
+    mutable std::mutex streamMutex;
+    std::vector<Registration> streams;
+
+    std::array<Counters, static_cast<size_t>(Queue::NumQueues)> counters;
+    std::atomic<bool> throttling{false};
+
+    JUCE_DECLARE_NON_COPYABLE(DiskIOScheduler)
+};
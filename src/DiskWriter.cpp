@@ -0,0 +1,110 @@
+/*
+  ==============================================================================
+
+    DiskWriter.cpp
+    Write-behind audio file writer on the DiskIOScheduler write queue
+
+  ==============================================================================
+*/
+
+#include "DiskWriter.h"
+
+namespace
+{
+constexpr int idleWaitMs = 10;
+} // namespace
+
+//==============================================================================
+DiskWriter::DiskWriter(juce::AudioFormatWriter* w, int bufferSize)
+    : fifo(bufferSize), buffer(static_cast<int>(w->getNumChannels()), bufferSize), writer(w)
+{
+    auto& scheduler = DiskIOScheduler::getInstance();
+    scheduler.addStream(DiskIOScheduler::Queue::Write, this);
+    scheduler.getThread(DiskIOScheduler::Queue::Write).addTimeSliceClient(this);
+}
+
+DiskWriter::~DiskWriter()
+{
+    auto& scheduler = DiskIOScheduler::getInstance();
+    scheduler.getThread(DiskIOScheduler::Queue::Write).removeTimeSliceClient(this);
+    scheduler.removeStream(this);
+
+    while (writePendingData() == 0)
+    {
+    }
+}
+
+//==============================================================================
+bool DiskWriter::write(const float* const* data, int numSamples)
+{
+    if (numSamples <= 0)
+        return true;
+
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite(numSamples, start1, size1, start2, size2);
+
+    if (size1 + size2 < numSamples)
+    {
+        overruns.fetch_add(1, std::memory_order_relaxed);
+        DiskIOScheduler::getInstance().reportOverrun(DiskIOScheduler::Queue::Write);
+        return false;
+    }
+
+    for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+    {
+        buffer.copyFrom(channel, start1, data[channel], size1);
+        if (size2 > 0)
+            buffer.copyFrom(channel, start2, data[channel] + size1, size2);
+    }
+
+    fifo.finishedWrite(size1 + size2);
+    return true;
+}
+
+void DiskWriter::setDataReceiver(IncomingDataReceiver* newReceiver)
+{
+    if (newReceiver != nullptr)
+        newReceiver->reset(buffer.getNumChannels(), writer->getSampleRate(), 0);
+
+    const juce::ScopedLock sl(receiverLock);
+    receiver = newReceiver;
+    samplesWritten = 0;
+}
+
+float DiskWriter::getHeadroom() const
+{
+    return static_cast<float>(fifo.getFreeSpace()) / static_cast<float>(juce::jmax(1, fifo.getTotalSize() - 1));
+}
+
+//==============================================================================
+int DiskWriter::useTimeSlice()
+{
+    return writePendingData();
+}
+
+int DiskWriter::writePendingData()
+{
+    int start1, size1, start2, size2;
+    fifo.prepareToRead(fifo.getTotalSize() / 4, start1, size1, start2, size2);
+
+    if (size1 <= 0)
+        return idleWaitMs;
+
+    writer->writeFromAudioSampleBuffer(buffer, start1, size1);
+    if (size2 > 0)
+        writer->writeFromAudioSampleBuffer(buffer, start2, size2);
+
+    {
+        const juce::ScopedLock sl(receiverLock);
+        if (receiver != nullptr)
+        {
+            receiver->addBlock(samplesWritten, buffer, start1, size1);
+            if (size2 > 0)
+                receiver->addBlock(samplesWritten + size1, buffer, start2, size2);
+        }
+        samplesWritten += size1 + size2;
+    }
+
+    fifo.finishedRead(size1 + size2);
+    return 0;
+}
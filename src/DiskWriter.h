@@ -0,0 +1,70 @@
+/*
+  ==============================================================================
+
+    DiskWriter.h
+    Write-behind audio file writer on the DiskIOScheduler write queue
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "DiskIOScheduler.h"
+
+#include <juce_audio_formats/juce_audio_formats.h>
+
+#include <atomic>
+#include <memory>
+
+//==============================================================================
+/**
+    Drop-in replacement for AudioFormatWriter::ThreadedWriter that runs on the
+    DiskIOScheduler's write thread and reports its buffer fill.
+
+    The audio thread copies blocks into a FIFO with write(); the write thread
+    drains it to the AudioFormatWriter in quarter-buffer blocks and forwards
+    the same audio to an optional data receiver (e.g. an AudioThumbnail). The
+    writer's free space is its headroom, so a recording that's falling
+    behind pauses thumbnail work. A block that doesn't fit is dropped and
+    counted as an overrun rather than blocking the audio thread.
+
+    Anything still buffered is written out when the DiskWriter is deleted.
+*/
+class DiskWriter : public DiskIOScheduler::Stream, private juce::TimeSliceClient
+{
+  public:
+    using IncomingDataReceiver = juce::AudioFormatWriter::ThreadedWriter::IncomingDataReceiver;
+
+    /// Takes ownership of writer. bufferSize is in samples per channel.
+    DiskWriter(juce::AudioFormatWriter* writer, int bufferSize);
+    ~DiskWriter() override;
+
+    /// Queues numSamples from each channel of data. Audio thread; returns
+    /// false (and drops the block) if the buffer is full.
+    bool write(const float* const* data, int numSamples);
+
+    /// Sends everything written from now on to receiver (nullptr to stop)
+    void setDataReceiver(IncomingDataReceiver* receiver);
+
+    /// Free fraction of the buffer
+    float getHeadroom() const override;
+    juce::int64 getOverruns() const { return overruns.load(std::memory_order_relaxed); }
+
+  private:
+    int useTimeSlice() override;
+    /// Writes one block from the FIFO. Returns 0 if it wrote anything,
+    /// otherwise how long to wait before checking again.
+    int writePendingData();
+
+    juce::AbstractFifo fifo;
+    juce::AudioBuffer<float> buffer;
+    std::unique_ptr<juce::AudioFormatWriter> writer;
+
+    juce::CriticalSection receiverLock;
+    IncomingDataReceiver* receiver = nullptr;
+    juce::int64 samplesWritten = 0;
+
+    std::atomic<juce::int64> overruns{0};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DiskWriter)
+};
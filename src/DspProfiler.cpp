@@ -0,0 +1,244 @@
+/*
+  ==============================================================================
+
+    DspProfiler.cpp
+    Per-node DSP load measurement with lock-free telemetry
+
+  ==============================================================================
+*/
+
+#include "DspProfiler.h"
+
+#include "FlightRecorder.h"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+std::atomic<juce::uint32> nextMeterId{1};
+} // namespace
+
+//==============================================================================
+DspLoadMeter::DspLoadMeter(const juce::AudioProcessor& ownerToMeasure)
+    : owner(ownerToMeasure), id(nextMeterId.fetch_add(1, std::memory_order_relaxed))
+{
+    DspProfiler::getInstance().addMeter(this);
+}
+
+DspLoadMeter::~DspLoadMeter()
+{
+    DspProfiler::getInstance().removeMeter(this);
+}
+
+//==============================================================================
+DspLoadMeter::ScopedMeasurement::ScopedMeasurement(DspLoadMeter& meterToUse, int samples) noexcept
+    : meter(meterToUse), numSamples(samples)
+{
+    if (DspProfiler::isEnabled() || FlightRecorder::isRecording())
+        startTicks = juce::Time::getHighResolutionTicks();
+}
+
+DspLoadMeter::ScopedMeasurement::~ScopedMeasurement() noexcept
+{
+    if (startTicks == 0)
+        return;
+
+    const auto elapsed = juce::Time::getHighResolutionTicks() - startTicks;
+    const auto nanos = static_cast<juce::int64>(juce::Time::highResolutionTicksToSeconds(elapsed) * 1.0e9);
+
+    if (DspProfiler::isEnabled())
+        meter.addMeasurement(nanos, numSamples);
+    if (FlightRecorder::isRecording())
+        FlightRecorder::getInstance().recordNode(meter.getId(), nanos);
+}
+
+//==============================================================================
+void DspLoadMeter::addMeasurement(juce::int64 nanos, int numSamples) noexcept
+{
+    const auto sampleRate = owner.getSampleRate();
+    const auto budget =
+        sampleRate > 0.0 ? static_cast<juce::uint64>(numSamples * 1.0e9 / sampleRate) : juce::uint64{0};
+    const auto duration = static_cast<juce::uint32>(juce::jlimit<juce::int64>(0, 0xffffffff, nanos));
+
+    // Single writer, so plain load/store pairs rather than read-modify-writes
+    auto& bin = histogram[static_cast<size_t>(getBin(duration))];
+    bin.store(bin.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    totalNanos.store(totalNanos.load(std::memory_order_relaxed) + duration, std::memory_order_relaxed);
+    totalBudgetNanos.store(totalBudgetNanos.load(std::memory_order_relaxed) + budget, std::memory_order_relaxed);
+
+    // The reader resets the maximum, so this one has to compare-and-swap
+    auto currentMax = maxNanos.load(std::memory_order_relaxed);
+    while (duration > currentMax && !maxNanos.compare_exchange_weak(currentMax, duration, std::memory_order_relaxed))
+    {
+    }
+
+    // Last, so a reader never sees a block counted without its duration
+    blocks.store(blocks.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+DspLoadMeter::Totals DspLoadMeter::read() noexcept
+{
+    Totals totals;
+    totals.blocks = blocks.load(std::memory_order_acquire);
+    totals.totalNanos = totalNanos.load(std::memory_order_relaxed);
+    totals.totalBudgetNanos = totalBudgetNanos.load(std::memory_order_relaxed);
+    totals.maxNanos = maxNanos.exchange(0, std::memory_order_relaxed);
+    for (size_t i = 0; i < histogram.size(); ++i)
+        totals.histogram[i] = histogram[i].load(std::memory_order_relaxed);
+    return totals;
+}
+
+int DspLoadMeter::getBin(juce::int64 nanos) noexcept
+{
+    if (nanos < 1000)
+        return 0;
+
+    // Quarter octaves from 1us
+    const auto bin = 1 + static_cast<int>(4.0 * std::log2(static_cast<double>(nanos) / 1000.0));
+    return juce::jmin(bin, numBins - 1);
+}
+
+double DspLoadMeter::getBinUpperNanos(int bin) noexcept
+{
+    return 1000.0 * std::pow(2.0, bin / 4.0);
+}
+
+//==============================================================================
+DspProfiler& DspProfiler::getInstance()
+{
+    static DspProfiler instance;
+    return instance;
+}
+
+void DspProfiler::setEnabled(bool shouldBeEnabled)
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+
+    const bool wasEnabled = enabledCount > 0;
+    enabledCount = juce::jmax(0, enabledCount + (shouldBeEnabled ? 1 : -1));
+    if ((enabledCount > 0) == wasEnabled)
+        return;
+
+    if (shouldBeEnabled)
+    {
+        // Drop anything counted before, so the first window starts now
+        {
+            const juce::ScopedLock sl(lock);
+            for (auto* meter : meters)
+                meter->previous = meter->read();
+            spdlog::info("[DspProfiler] Profiling {} processors", meters.size());
+        }
+        loads.clear();
+
+        enabled.store(true, std::memory_order_relaxed);
+        startTimer(updateIntervalMs);
+    }
+    else
+    {
+        enabled.store(false, std::memory_order_relaxed);
+        stopTimer();
+        loads.clear();
+        spdlog::info("[DspProfiler] Profiling stopped");
+    }
+
+    sendChangeMessage();
+}
+
+void DspProfiler::update()
+{
+    std::vector<NodeLoad> newLoads;
+    {
+        const juce::ScopedLock sl(lock);
+        newLoads.reserve(meters.size());
+        for (auto* meter : meters)
+        {
+            const auto current = meter->read();
+            auto load = summarise(meter->previous, current);
+            meter->previous = current;
+
+            load.processor = &meter->owner;
+            load.name = meter->owner.getName();
+            newLoads.push_back(std::move(load));
+        }
+    }
+
+    loads = std::move(newLoads);
+    sendChangeMessage();
+}
+
+const DspProfiler::NodeLoad* DspProfiler::getLoad(const juce::AudioProcessor* processor) const
+{
+    for (const auto& load : loads)
+    {
+        if (load.processor == processor)
+            return &load;
+    }
+    return nullptr;
+}
+
+std::vector<std::pair<juce::uint32, juce::String>> DspProfiler::getMeterNames()
+{
+    const juce::ScopedLock sl(lock);
+    std::vector<std::pair<juce::uint32, juce::String>> names;
+    names.reserve(meters.size());
+    for (auto* meter : meters)
+        names.emplace_back(meter->id, meter->owner.getName());
+    return names;
+}
+
+DspProfiler::NodeLoad DspProfiler::summarise(const DspLoadMeter::Totals& previous, const DspLoadMeter::Totals& current)
+{
+    NodeLoad load;
+    load.blocks = current.blocks - previous.blocks;
+    if (load.blocks == 0)
+        return load;
+
+    const auto nanos = static_cast<double>(current.totalNanos - previous.totalNanos);
+    const auto budget = static_cast<double>(current.totalBudgetNanos - previous.totalBudgetNanos);
+
+    // The bin holding the 99th percentile block, capped by the real maximum
+    const auto rank = static_cast<juce::uint64>(std::ceil(0.99 * static_cast<double>(load.blocks)));
+    juce::uint64 counted = 0;
+    double p99Nanos = 0.0;
+    for (int bin = 0; bin < DspLoadMeter::numBins; ++bin)
+    {
+        counted += current.histogram[static_cast<size_t>(bin)] - previous.histogram[static_cast<size_t>(bin)];
+        if (counted >= rank)
+        {
+            p99Nanos = DspLoadMeter::getBinUpperNanos(bin);
+            break;
+        }
+    }
+    const auto maxNanos = static_cast<double>(current.maxNanos);
+    if (maxNanos > 0.0)
+        p99Nanos = juce::jmin(p99Nanos, maxNanos);
+
+    load.meanMicros = nanos / static_cast<double>(load.blocks) / 1000.0;
+    load.p99Micros = p99Nanos / 1000.0;
+    load.maxMicros = maxNanos / 1000.0;
+
+    if (budget > 0.0)
+    {
+        const double blockBudget = budget / static_cast<double>(load.blocks);
+        load.meanLoad = static_cast<float>(nanos / budget);
+        load.p99Load = static_cast<float>(p99Nanos / blockBudget);
+        load.maxLoad = static_cast<float>(maxNanos / blockBudget);
+    }
+    return load;
+}
+
+void DspProfiler::addMeter(DspLoadMeter* meter)
+{
+    const juce::ScopedLock sl(lock);
+    meter->previous = meter->read();
+    meters.push_back(meter);
+}
+
+void DspProfiler::removeMeter(DspLoadMeter* meter)
+{
+    const juce::ScopedLock sl(lock);
+    meters.erase(std::remove(meters.begin(), meters.end(), meter), meters.end());
+}
@@ -0,0 +1,167 @@
+/*
+  ==============================================================================
+
+    DspProfiler.h
+    Per-node DSP load measurement with lock-free telemetry
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include <array>
+#include <atomic>
+#include <utility>
+#include <vector>
+
+//==============================================================================
+/**
+    Timing stats for one processor's processBlock, written by the audio thread.
+
+    Every field has a single writer (the audio thread) and is read without
+    locks by DspProfiler, so a reader sees each counter whole, if not always
+    all of them from the same block. Durations go into a histogram of
+    quarter-octave bins from 1us, so the 99th percentile can be read for any
+    window by differencing two readings.
+
+    Also feeds FlightRecorder each block's time while it's recording. Costs
+    two relaxed atomic loads per block while both are off.
+*/
+class DspLoadMeter
+{
+  public:
+    static constexpr int numBins = 64;
+
+    /// Cumulative counts since the meter was created
+    struct Totals
+    {
+        juce::uint64 blocks = 0;
+        juce::uint64 totalNanos = 0;
+        juce::uint64 totalBudgetNanos = 0;
+        juce::uint32 maxNanos = 0; // Since the previous reading, not cumulative
+        std::array<juce::uint32, numBins> histogram{};
+    };
+
+    /// Registers with DspProfiler under owner, which must outlive it
+    explicit DspLoadMeter(const juce::AudioProcessor& owner);
+    ~DspLoadMeter();
+
+    /// Times the enclosing processBlock, if profiling or the flight recorder is on
+    class ScopedMeasurement
+    {
+      public:
+        ScopedMeasurement(DspLoadMeter& meter, int numSamples) noexcept;
+        ~ScopedMeasurement() noexcept;
+
+      private:
+        DspLoadMeter& meter;
+        const int numSamples;
+        juce::int64 startTicks = 0;
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedMeasurement)
+    };
+
+    /// Audio thread: adds one block that took nanos to process numSamples
+    void addMeasurement(juce::int64 nanos, int numSamples) noexcept;
+
+    /// Any thread. Also restarts the running maximum.
+    Totals read() noexcept;
+
+    const juce::AudioProcessor& getOwner() const { return owner; }
+    /// Unique for the session; names the node in flight recorder dumps
+    juce::uint32 getId() const { return id; }
+
+    static int getBin(juce::int64 nanos) noexcept;
+    /// The longest duration that falls in bin
+    static double getBinUpperNanos(int bin) noexcept;
+
+  private:
+    friend class DspProfiler;
+
+    const juce::AudioProcessor& owner;
+    const juce::uint32 id;
+
+    std::atomic<juce::uint64> blocks{0};
+    std::atomic<juce::uint64> totalNanos{0};
+    std::atomic<juce::uint64> totalBudgetNanos{0};
+    std::atomic<juce::uint32> maxNanos{0};
+    std::array<std::atomic<juce::uint32>, numBins> histogram{};
+
+    // Message thread only, under DspProfiler's lock: the last reading, for differencing
+    Totals previous;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DspLoadMeter)
+};
+
+//==============================================================================
+/**
+    Collects every DspLoadMeter's stats once a second while profiling is on.
+
+    Each update covers the second since the last one: mean, 99th percentile
+    and maximum time per block, and the same as a fraction of the block's
+    real-time budget (block length / sample rate). Listeners are notified on
+    the message thread after every update.
+*/
+class DspProfiler : public juce::ChangeBroadcaster, private juce::Timer
+{
+  public:
+    static constexpr int updateIntervalMs = 1000;
+
+    /// One processor's stats over the last update interval
+    struct NodeLoad
+    {
+        const juce::AudioProcessor* processor = nullptr; // Identifies the node; may be gone, never dereferenced
+        juce::String name;
+        juce::uint64 blocks = 0;
+        double meanMicros = 0.0;
+        double p99Micros = 0.0;
+        double maxMicros = 0.0;
+        float meanLoad = 0.0f; // Fractions of the callback budget
+        float p99Load = 0.0f;
+        float maxLoad = 0.0f;
+    };
+
+    static DspProfiler& getInstance();
+
+    /// Cheap enough for the audio thread
+    static bool isEnabled() noexcept { return enabled.load(std::memory_order_relaxed); }
+
+    /// Message thread. Counted, so profiling runs until every user that turned
+    /// it on has turned it off. Turning it on starts a fresh measurement window.
+    void setEnabled(bool shouldBeEnabled);
+
+    /// Message thread: reads every meter and replaces getLoads(). Called by the timer.
+    void update();
+
+    /// Message thread: the loads from the last update
+    const std::vector<NodeLoad>& getLoads() const { return loads; }
+    /// Message thread: the last update's load for processor, or nullptr
+    const NodeLoad* getLoad(const juce::AudioProcessor* processor) const;
+
+    /// Any thread: every meter's id and its processor's name
+    std::vector<std::pair<juce::uint32, juce::String>> getMeterNames();
+
+    /// The stats for the window between two readings of one meter
+    static NodeLoad summarise(const DspLoadMeter::Totals& previous, const DspLoadMeter::Totals& current);
+
+  private:
+    DspProfiler() = default;
+    ~DspProfiler() override = default;
+
+    friend class DspLoadMeter;
+    void addMeter(DspLoadMeter* meter);
+    void removeMeter(DspLoadMeter* meter);
+
+    void timerCallback() override { update(); }
+
+    inline static std::atomic<bool> enabled{false};
+    int enabledCount = 0;
+
+    juce::CriticalSection lock;
+    std::vector<DspLoadMeter*> meters;
+    std::vector<NodeLoad> loads;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DspProfiler)
+};
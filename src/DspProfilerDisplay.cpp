@@ -0,0 +1,181 @@
+/*
+  ==============================================================================
+
+    DspProfilerDisplay.cpp
+    Sortable table of every node's DSP load
+
+  ==============================================================================
+*/
+
+#include "DspProfilerDisplay.h"
+#include "ColourScheme.h"
+
+#include <algorithm>
+
+namespace
+{
+/// The value a column sorts by
+double getSortValue(const DspProfiler::NodeLoad& load, int columnId)
+{
+    switch (columnId)
+    {
+    case DspProfilerDisplay::MeanLoadColumn:
+        return load.meanLoad;
+    case DspProfilerDisplay::P99LoadColumn:
+        return load.p99Load;
+    case DspProfilerDisplay::MaxLoadColumn:
+        return load.maxLoad;
+    case DspProfilerDisplay::MeanTimeColumn:
+        return load.meanMicros;
+    case DspProfilerDisplay::P99TimeColumn:
+        return load.p99Micros;
+    case DspProfilerDisplay::MaxTimeColumn:
+        return load.maxMicros;
+    default:
+        return 0.0;
+    }
+}
+} // namespace
+
+//==============================================================================
+DspProfilerDisplay::DspProfilerDisplay()
+{
+    auto& colours = ColourScheme::getInstance().colours;
+
+    infoLabel.setText("Time spent in each node's processBlock over the last second, and as a share of the audio "
+                      "callback's budget. Racks include the nodes inside them.",
+                      dontSendNotification);
+    infoLabel.setColour(Label::textColourId, colours["Text Colour"].withAlpha(0.7f));
+    addAndMakeVisible(infoLabel);
+
+    auto& header = table.getHeader();
+    const int sortable = TableHeaderComponent::defaultFlags;
+    header.addColumn("Node", NodeColumn, 180, 80, -1, sortable);
+    header.addColumn("Mean %", MeanLoadColumn, 70, 50, -1, sortable);
+    header.addColumn("p99 %", P99LoadColumn, 70, 50, -1, sortable);
+    header.addColumn("Max %", MaxLoadColumn, 70, 50, -1, sortable);
+    header.addColumn("Mean us", MeanTimeColumn, 70, 50, -1, sortable);
+    header.addColumn("p99 us", P99TimeColumn, 70, 50, -1, sortable);
+    header.addColumn("Max us", MaxTimeColumn, 70, 50, -1, sortable);
+    header.setSortColumnId(sortColumn, sortForwards);
+
+    table.setModel(this);
+    table.setColour(ListBox::backgroundColourId, colours["Dialog Inner Background"]);
+    table.setColour(ListBox::outlineColourId, colours["Text Colour"].withAlpha(0.3f));
+    table.setOutlineThickness(1);
+    addAndMakeVisible(table);
+
+    auto& profiler = DspProfiler::getInstance();
+    profiler.addChangeListener(this);
+    profiler.setEnabled(true);
+}
+
+DspProfilerDisplay::~DspProfilerDisplay()
+{
+    auto& profiler = DspProfiler::getInstance();
+    profiler.removeChangeListener(this);
+    profiler.setEnabled(false);
+}
+
+//==============================================================================
+void DspProfilerDisplay::paint(Graphics& g)
+{
+    g.fillAll(ColourScheme::getInstance().colours["Window Background"]);
+}
+
+void DspProfilerDisplay::resized()
+{
+    auto bounds = getLocalBounds().reduced(8);
+    infoLabel.setBounds(bounds.removeFromTop(36));
+    bounds.removeFromTop(4);
+    table.setBounds(bounds);
+}
+
+//==============================================================================
+void DspProfilerDisplay::paintRowBackground(Graphics& g, int rowNumber, int, int, bool rowIsSelected)
+{
+    auto& colours = ColourScheme::getInstance().colours;
+
+    if (rowIsSelected)
+        g.fillAll(colours["List Selection"]);
+    else if (rowNumber % 2)
+        g.fillAll(colours["Dialog Inner Background"].darker(0.05f));
+}
+
+void DspProfilerDisplay::paintCell(Graphics& g, int rowNumber, int columnId, int width, int height, bool)
+{
+    if (rowNumber < 0 || rowNumber >= getNumRows())
+        return;
+
+    auto& colours = ColourScheme::getInstance().colours;
+    const auto& load = rows[static_cast<size_t>(rowNumber)];
+
+    String text;
+    Colour colour = colours["Text Colour"];
+    Justification justification = Justification::centredRight;
+
+    if (columnId == NodeColumn)
+    {
+        text = load.name;
+        justification = Justification::centredLeft;
+    }
+    else if (load.blocks == 0)
+    {
+        // Not processed in the last second (e.g. not connected)
+        text = "-";
+        colour = colour.withAlpha(0.4f);
+    }
+    else
+    {
+        const double value = getSortValue(load, columnId);
+        const bool isLoad = columnId <= MaxLoadColumn;
+        text = isLoad ? String(value * 100.0, 1) : String(value, 1);
+
+        if (isLoad && value > 0.5)
+            colour = colours["Danger Colour"];
+        else if (isLoad && value > 0.2)
+            colour = colours["Warning Colour"];
+    }
+
+    g.setColour(colour);
+    g.setFont(13.0f);
+    g.drawText(text, 4, 0, width - 8, height, justification, true);
+}
+
+void DspProfilerDisplay::sortOrderChanged(int newSortColumnId, bool isForwards)
+{
+    sortColumn = newSortColumnId;
+    sortForwards = isForwards;
+    sortRows();
+    table.updateContent();
+    table.repaint();
+}
+
+//==============================================================================
+void DspProfilerDisplay::changeListenerCallback(ChangeBroadcaster*)
+{
+    rows = DspProfiler::getInstance().getLoads();
+    sortRows();
+    table.updateContent();
+    table.repaint();
+}
+
+void DspProfilerDisplay::sortRows()
+{
+    const int column = sortColumn;
+    const bool forwards = sortForwards;
+
+    std::stable_sort(rows.begin(), rows.end(),
+                     [column, forwards](const DspProfiler::NodeLoad& a, const DspProfiler::NodeLoad& b)
+                     {
+                         if (column == NodeColumn)
+                         {
+                             const int order = a.name.compareNatural(b.name);
+                             return forwards ? order < 0 : order > 0;
+                         }
+
+                         const double first = getSortValue(a, column);
+                         const double second = getSortValue(b, column);
+                         return forwards ? first < second : first > second;
+                     });
+}
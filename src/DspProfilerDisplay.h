@@ -0,0 +1,61 @@
+/*
+  ==============================================================================
+
+    DspProfilerDisplay.h
+    Sortable table of every node's DSP load
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "DspProfiler.h"
+
+#include <JuceHeader.h>
+
+#include <vector>
+
+//==============================================================================
+/**
+    Shows DspProfiler's per-node stats, refreshed once a second.
+    Profiling runs while this is open, so the audio thread pays nothing for it
+    the rest of the time. Click a column header to sort by it.
+*/
+class DspProfilerDisplay : public Component, public TableListBoxModel, private ChangeListener
+{
+  public:
+    enum ColumnIds
+    {
+        NodeColumn = 1,
+        MeanLoadColumn,
+        P99LoadColumn,
+        MaxLoadColumn,
+        MeanTimeColumn,
+        P99TimeColumn,
+        MaxTimeColumn
+    };
+
+    DspProfilerDisplay();
+    ~DspProfilerDisplay() override;
+
+    void paint(Graphics& g) override;
+    void resized() override;
+
+    int getNumRows() override { return static_cast<int>(rows.size()); }
+    void paintRowBackground(Graphics& g, int rowNumber, int width, int height, bool rowIsSelected) override;
+    void paintCell(Graphics& g, int rowNumber, int columnId, int width, int height, bool rowIsSelected) override;
+    void sortOrderChanged(int newSortColumnId, bool isForwards) override;
+
+  private:
+    void changeListenerCallback(ChangeBroadcaster* source) override;
+    void sortRows();
+
+    std::vector<DspProfiler::NodeLoad> rows;
+    int sortColumn = P99LoadColumn;
+    bool sortForwards = false;
+
+    Label infoLabel;
+    TableListBox table;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DspProfilerDisplay)
+};
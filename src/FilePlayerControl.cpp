@@ -44,6 +44,7 @@ FilePlayerControl::FilePlayerControl (FilePlayerProcessor *proc)
       filename (0),
       syncButton (0),
       loopButton (0),
+      preloadButton (0),
       playPauseButton (0),
       rtzButton (0)
 {
@@ -63,6 +64,11 @@ FilePlayerControl::FilePlayerControl (FilePlayerProcessor *proc)
     loopButton->setButtonText ("Loop");
     loopButton->addListener (this);
 
+    addAndMakeVisible (preloadButton = new ToggleButton ("preloadButton"));
+    preloadButton->setTooltip ("Decode the whole file into memory ahead of time, so playback never touches the disk");
+    preloadButton->setButtonText ("Preload");
+    preloadButton->addListener (this);
+
     addAndMakeVisible (playPauseButton = new DrawableButton ("playPauseButton", DrawableButton::ImageOnButtonBackground));
     playPauseButton->setName ("playPauseButton");
 
@@ -113,6 +119,8 @@ FilePlayerControl::FilePlayerControl (FilePlayerProcessor *proc)
 							   false);
 	syncButton->setToggleState(processor->getParameter(FilePlayerProcessor::SyncToMainTransport) > 0.5f,
 							   false);
+	preloadButton->setToggleState(processor->getParameter(FilePlayerProcessor::Preload) > 0.5f,
+								  false);
 
 	filename->addListener(this);
 	fileDisplay->addChangeListener(this);
@@ -141,6 +149,7 @@ FilePlayerControl::~FilePlayerControl()
     delete filename; filename = nullptr;
     delete syncButton; syncButton = nullptr;
     delete loopButton; loopButton = nullptr;
+    delete preloadButton; preloadButton = nullptr;
     delete playPauseButton; playPauseButton = nullptr;
     delete rtzButton; rtzButton = nullptr;
 
@@ -165,6 +174,7 @@ void FilePlayerControl::resized()
     filename->setBounds (0, 0, getWidth() - 58, 24);
     syncButton->setBounds (0, getHeight() - 23, 168, 24);
     loopButton->setBounds (176, getHeight() - 23, 56, 24);
+    preloadButton->setBounds (232, getHeight() - 23, 68, 24);
     playPauseButton->setBounds (getWidth() - 54, 0, 24, 24);
     rtzButton->setBounds (getWidth() - 26, 0, 24, 24);
     //[UserResized] Add your own custom resize handling here..
@@ -198,6 +208,17 @@ void FilePlayerControl::buttonClicked (Button* buttonThatWasClicked)
 
         //[/UserButtonCode_loopButton]
     }
+    else if (buttonThatWasClicked == preloadButton)
+    {
+        //[UserButtonCode_preloadButton] -- add your button handler code here..
+
+		bool val = preloadButton->getToggleState();
+
+		processor->setParameter(FilePlayerProcessor::Preload,
+								val ? 1.0f : 0.0f);
+
+        //[/UserButtonCode_preloadButton]
+    }
 
     //[UserbuttonClicked_Post]
 	else if(buttonThatWasClicked == playPauseButton)
@@ -261,6 +282,8 @@ void FilePlayerControl::changeListenerCallback(ChangeBroadcaster *source)
 		fileDisplay->setReadPointer((float)processor->getReadPosition());
 		loopButton->setToggleState(processor->getParameter(FilePlayerProcessor::Looping) > 0.5f, false);
 		syncButton->setToggleState(processor->getParameter(FilePlayerProcessor::SyncToMainTransport) > 0.5f, false);
+		preloadButton->setToggleState(processor->getParameter(FilePlayerProcessor::Preload) > 0.5f, false);
+		preloadButton->setButtonText(processor->isPlayingFromMemory() ? "Preloaded" : "Preload");
 	}
 }
 
@@ -301,6 +324,10 @@ BEGIN_JUCER_METADATA
                 virtualName="" explicitFocusOrder="0" pos="176 23R 56 24" tooltip="Loop this file"
                 buttonText="Loop" connectedEdges="0" needsCallback="1" radioGroupId="0"
                 state="0"/>
+  <TOGGLEBUTTON name="preloadButton" id="3c1f8e20d4a95b71" memberName="preloadButton"
+                virtualName="" explicitFocusOrder="0" pos="232 23R 68 24" tooltip="Decode the whole file into memory ahead of time, so playback never touches the disk"
+                buttonText="Preload" connectedEdges="0" needsCallback="1" radioGroupId="0"
+                state="0"/>
   <GENERICCOMPONENT name="playPauseButton" id="da66be207abe8144" memberName="playPauseButton"
                     virtualName="" explicitFocusOrder="0" pos="54R 0 24 24" class="DrawableButton"
                     params="&quot;playPauseButton&quot;, DrawableButton::ImageOnButtonBackground"/>
@@ -93,6 +93,7 @@ class FilePlayerControl : public Component,
     FilenameComponent* filename;
     ToggleButton* syncButton;
     ToggleButton* loopButton;
+    ToggleButton* preloadButton;
     DrawableButton* playPauseButton;
     DrawableButton* rtzButton;
 
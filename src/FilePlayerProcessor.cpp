@@ -22,24 +22,28 @@
 #include "MainTransport.h"
 #include "PedalboardProcessorEditors.h"
 #include "PedalboardProcessors.h"
+#include "ReadAheadSource.h"
 
 
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
-FilePlayerProcessor::FilePlayerProcessor() : looping(false), syncToMainTransport(false), justPaused(false)
+FilePlayerProcessor::FilePlayerProcessor()
+    : looping(false), syncToMainTransport(false), preload(false), justPaused(false)
 {
     setPlayConfigDetails(0, 2, 0, 0);
     transportSource.addChangeListener(this);
+    preloader.addChangeListener(this);
 
     MainTransport::getInstance()->registerTransport(this);
 }
 
 //------------------------------------------------------------------------------
 FilePlayerProcessor::FilePlayerProcessor(const File& phil)
-    : looping(false), syncToMainTransport(false), justPaused(false)
+    : looping(false), syncToMainTransport(false), preload(false), justPaused(false)
 {
     setPlayConfigDetails(0, 2, 0, 0);
     transportSource.addChangeListener(this);
+    preloader.addChangeListener(this);
 
     MainTransport::getInstance()->registerTransport(this);
 
@@ -51,20 +55,21 @@ FilePlayerProcessor::~FilePlayerProcessor()
 {
     removeAllChangeListeners();
     MainTransport::getInstance()->unregisterTransport(this);
+    preloader.removeChangeListener(this);
     transportSource.setSource(0);
 }
 
 //------------------------------------------------------------------------------
 void FilePlayerProcessor::setFile(const File& phil)
 {
-    int readAheadSize;
-
     soundFile = phil;
 
     // Unload the previous file source and delete it.
     transportSource.stop();
     transportSource.setSource(0);
+    readAheadSource = 0;
     soundFileSource = 0;
+    preloadedSource = 0;
 
     AudioFormatReader* reader = AudioFormatManagerSingleton::getInstance().createReaderFor(phil);
 
@@ -73,16 +78,82 @@ void FilePlayerProcessor::setFile(const File& phil)
         soundFileSource.reset(new AudioFormatReaderSource(reader, true));
         soundFileSource->setLooping(looping);
 
-        if (soundFileSource->getTotalLength() < 32768)
-            readAheadSize = 0;
-        else
-            readAheadSize = 32768;
+        streamFromDisk();
+    }
 
-        // Plug it into our transport source.
-        transportSource.setSource(soundFileSource.get(),
-                                  readAheadSize, // Tells it to buffer this many samples ahead.
-                                  &(AudioThumbnailCacheSingleton::getInstance().getTimeSliceThread()));
+    startPreload();
+}
+
+//------------------------------------------------------------------------------
+void FilePlayerProcessor::streamFromDisk()
+{
+    PositionableAudioSource* source = soundFileSource.get();
+
+    // Buffer 32768 samples ahead on the disk read queue, registered there so
+    // a stream running dry holds up thumbnails and its dropouts are counted.
+    // Shorter files are read directly.
+    readAheadSource = 0;
+    if (soundFileSource->getTotalLength() >= 32768)
+    {
+        readAheadSource.reset(new ReadAheadSource(soundFileSource.get(), 32768));
+        source = readAheadSource.get();
     }
+
+    // Plug it into our transport source.
+    transportSource.setSource(source, 0, 0, soundFileSource->getAudioFormatReader()->sampleRate);
+}
+
+//------------------------------------------------------------------------------
+void FilePlayerProcessor::startPreload()
+{
+    if (!preload || !soundFileSource || getSampleRate() <= 0.0)
+    {
+        preloader.clear();
+        return;
+    }
+
+    // Already done (or under way) for this file and rate.
+    if (preloader.getAudio() && preloader.getFile() == soundFile && preloader.getSampleRate() == getSampleRate())
+        return;
+
+    preloader.load(soundFile, getSampleRate());
+}
+
+//------------------------------------------------------------------------------
+void FilePlayerProcessor::updatePlaybackSource()
+{
+    if (!soundFileSource || transportSource.isPlaying())
+        return;
+
+    std::shared_ptr<const AudioBuffer<float>> audio = preloader.getAudio();
+    const bool fromMemory = preload && audio && (preloader.getFile() == soundFile) &&
+                            (preloader.getSampleRate() == getSampleRate());
+
+    if (fromMemory == (preloadedSource != nullptr))
+        return;
+
+    // Positions are at the playback rate either way.
+    const int64 position = transportSource.getNextReadPosition();
+
+    if (fromMemory)
+    {
+        preloadedSource.reset(new PreloadedAudioSource(audio));
+        preloadedSource->setLooping(looping);
+
+        // Already at the playback rate, so there's no read-ahead or resampling.
+        transportSource.setSource(preloadedSource.get());
+        readAheadSource = 0;
+    }
+    else
+    {
+        transportSource.setSource(0);
+        preloadedSource = 0;
+
+        streamFromDisk();
+    }
+
+    transportSource.setNextReadPosition(position);
+    sendChangeMessage();
 }
 
 //------------------------------------------------------------------------------
@@ -102,7 +173,15 @@ void FilePlayerProcessor::updateEditorBounds(const Rectangle<int>& bounds)
 //------------------------------------------------------------------------------
 void FilePlayerProcessor::changeListenerCallback(ChangeBroadcaster* source)
 {
-    if (source == MainTransport::getInstance())
+    if (source == &preloader)
+    {
+        // Finished for a sample rate we've since moved away from.
+        if (preload && preloader.getAudio() && preloader.getSampleRate() != getSampleRate())
+            startPreload();
+        else
+            updatePlaybackSource();
+    }
+    else if (source == MainTransport::getInstance())
     {
         if (syncToMainTransport)
         {
@@ -139,6 +218,9 @@ void FilePlayerProcessor::changeListenerCallback(ChangeBroadcaster* source)
         if (justPaused)
             justPaused = false;
 
+        // Switch to or from the preloaded audio now we're stopped.
+        updatePlaybackSource();
+
         sendChangeMessage();
     }
 }
@@ -179,6 +261,16 @@ void FilePlayerProcessor::prepareToPlay(double sampleRate, int estimatedSamplesP
 {
     // Why are the arguments the opposite way round???
     transportSource.prepareToPlay(estimatedSamplesPerBlock, sampleRate);
+
+    // Preloaded audio is only any good at the rate it was converted to.
+    if (preloadedSource && (preloader.getSampleRate() != sampleRate))
+    {
+        transportSource.setSource(0);
+        preloadedSource = 0;
+        streamFromDisk();
+    }
+    if (preload && !preloader.isLoading())
+        startPreload();
 }
 
 //------------------------------------------------------------------------------
@@ -218,6 +310,9 @@ const String FilePlayerProcessor::getParameterName(int parameterIndex)
     case Trigger:
         retval = "Trigger";
         break;
+    case Preload:
+        retval = "Preload";
+        break;
     }
 
     return retval;
@@ -236,6 +331,9 @@ float FilePlayerProcessor::getParameter(int parameterIndex)
     case SyncToMainTransport:
         retval = syncToMainTransport ? 1.0f : 0.0f;
         break;
+    case Preload:
+        retval = preload ? 1.0f : 0.0f;
+        break;
     }
 
     return retval;
@@ -260,6 +358,12 @@ const String FilePlayerProcessor::getParameterText(int parameterIndex)
         else
             retval = "not synced";
         break;
+    case Preload:
+        if (preload)
+            retval = "preloaded";
+        else
+            retval = "streamed";
+        break;
     }
 
     return retval;
@@ -294,6 +398,8 @@ void FilePlayerProcessor::setParameter(int parameterIndex, float newValue)
             looping = false;
         if (soundFileSource)
             soundFileSource->setLooping(looping);
+        if (preloadedSource)
+            preloadedSource->setLooping(looping);
         sendChangeMessage();
         break;
     case ReadPosition:
@@ -318,6 +424,15 @@ void FilePlayerProcessor::setParameter(int parameterIndex, float newValue)
             sendChangeMessage();
         }
         break;
+    case Preload:
+        if (newValue > 0.5f)
+            preload = true;
+        else
+            preload = false;
+        startPreload();
+        updatePlaybackSource();
+        sendChangeMessage();
+        break;
     }
 }
 
@@ -329,6 +444,7 @@ void FilePlayerProcessor::getStateInformation(MemoryBlock& destData)
     xml.setAttribute("file", soundFile.getFullPathName());
     xml.setAttribute("looping", looping);
     xml.setAttribute("syncToMainTransport", syncToMainTransport);
+    xml.setAttribute("preload", preload);
 
     xml.setAttribute("editorX", editorBounds.getX());
     xml.setAttribute("editorY", editorBounds.getY());
@@ -347,6 +463,8 @@ void FilePlayerProcessor::setStateInformation(const void* data, int sizeInBytes)
     {
         if (xmlState->hasTagName("Pedalboard3FilePlayerSettings"))
         {
+            // Before setFile(), so a preloaded file starts decoding straight away.
+            preload = xmlState->getBoolAttribute("preload");
             setFile(xmlState->getStringAttribute("file"));
             looping = xmlState->getBoolAttribute("looping");
             if (soundFileSource)
@@ -37,6 +37,7 @@
 #include "MidiMappingManager.h"
 #include "OscMappingManager.h"
 #include "PedalboardProcessors.h"
+#include "PerfTrace.h"
 #include "PluginBlacklist.h"
 #include "SettingsManager.h"
 #include "SubGraphProcessor.h"
@@ -416,8 +417,12 @@ AudioProcessorGraph::NodeID FilterGraph::addFilterRaw(const PluginDescription* d
     spdlog::debug("[addFilterRaw] Adding plugin: {}", desc->name.toStdString());
 
     String errorMessage;
-    auto tempInstance =
-        AudioPluginFormatManagerSingleton::getInstance().createPluginInstance(*desc, 44100.0, 512, errorMessage);
+    std::unique_ptr<AudioPluginInstance> tempInstance;
+    {
+        const PerfTrace::Zone zone("Create plugin instance", "plugin");
+        tempInstance =
+            AudioPluginFormatManagerSingleton::getInstance().createPluginInstance(*desc, 44100.0, 512, errorMessage);
+    }
 
     if (!tempInstance)
     {
@@ -763,6 +768,7 @@ static XmlElement* createNodeXml(AudioProcessorGraph::Node::Ptr node, const OscM
 
 void FilterGraph::createNodeFromXml(const XmlElement& xml, OscMappingManager& oscManager)
 {
+    const PerfTrace::Zone zone("FilterGraph::createNodeFromXml", "patch");
     String midiAddress;
     String errorMessage;
     PluginDescription pd;
@@ -780,8 +786,11 @@ void FilterGraph::createNodeFromXml(const XmlElement& xml, OscMappingManager& os
     spdlog::debug("[createNodeFromXml] Creating node uid={} plugin={}", uid, pd.name.toStdString());
 
     // JUCE 8: createPluginInstance (not createPluginInstanceSync)
-    tempInstance =
-        AudioPluginFormatManagerSingleton::getInstance().createPluginInstance(pd, 44100.0, 512, errorMessage);
+    {
+        const PerfTrace::Zone instanceZone("Create plugin instance", "plugin");
+        tempInstance =
+            AudioPluginFormatManagerSingleton::getInstance().createPluginInstance(pd, 44100.0, 512, errorMessage);
+    }
 
     // VST3 instruments may have disabled output buses by default (confirmed by Carla source).
     // Enable all buses to ensure output pins are visible for synths.
@@ -830,6 +839,7 @@ void FilterGraph::createNodeFromXml(const XmlElement& xml, OscMappingManager& os
         MemoryBlock m;
         m.fromBase64Encoding(state->getAllSubText());
 
+        const PerfTrace::Zone stateZone("setStateInformation", "plugin");
         node->getProcessor()->setStateInformation(m.getData(), m.getSize());
     }
 
@@ -895,6 +905,7 @@ XmlElement* FilterGraph::createXml(const OscMappingManager& oscManager) const
 
 void FilterGraph::restoreFromXml(const XmlElement& xml, OscMappingManager& oscManager)
 {
+    const PerfTrace::Zone zone("FilterGraph::restoreFromXml", "patch");
     clear(false, false, false, false);
 
     int nodeCount = 0;
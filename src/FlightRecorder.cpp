@@ -0,0 +1,473 @@
+/*
+  ==============================================================================
+
+    FlightRecorder.cpp
+    Audio callback deadline monitor that dumps recent timing on a glitch
+
+  ==============================================================================
+*/
+
+#include "FlightRecorder.h"
+
+#include "DiskIOScheduler.h"
+#include "DspProfiler.h"
+
+#include <spdlog/spdlog.h>
+
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+constexpr int pollMs = 100;
+
+juce::uint32 toUint32(juce::int64 nanos)
+{
+    return static_cast<juce::uint32>(juce::jlimit<juce::int64>(0, 0xffffffff, nanos));
+}
+} // namespace
+
+//==============================================================================
+FlightRecorder& FlightRecorder::getInstance()
+{
+    static FlightRecorder instance;
+    return instance;
+}
+
+FlightRecorder::FlightRecorder() : epochTicks(juce::Time::getHighResolutionTicks())
+{
+    DiskIOScheduler::getInstance().getThread(DiskIOScheduler::Queue::Write).addTimeSliceClient(this);
+}
+
+FlightRecorder::~FlightRecorder()
+{
+    DiskIOScheduler::getInstance().getThread(DiskIOScheduler::Queue::Write).removeTimeSliceClient(this);
+}
+
+//==============================================================================
+void FlightRecorder::setEnabled(bool shouldBeEnabled)
+{
+    enabled.store(shouldBeEnabled, std::memory_order_relaxed);
+    updateRecording();
+    spdlog::info("[FlightRecorder] {}", shouldBeEnabled ? "Enabled" : "Disabled");
+}
+
+void FlightRecorder::setOutputDirectory(const juce::File& directory)
+{
+    const juce::ScopedLock sl(infoLock);
+    outputDirectory = directory;
+}
+
+void FlightRecorder::setActivePatch(int index, const juce::String& name)
+{
+    {
+        const juce::ScopedLock sl(infoLock);
+        patchIndex = index;
+        patchName = name;
+    }
+    recordEvent(EventSource::PatchChange, 0, index, 0.0f);
+}
+
+juce::File FlightRecorder::getLastDump() const
+{
+    const juce::ScopedLock sl(infoLock);
+    return lastDump;
+}
+
+//==============================================================================
+void FlightRecorder::prepare(double sampleRate, int blockSize)
+{
+    const juce::ScopedLock sl(storageLock);
+
+    currentSampleRate = sampleRate;
+    currentBlockSize = juce::jmax(1, blockSize);
+
+    const double callbacksPerSecond = sampleRate / currentBlockSize;
+    postMissCallbacks = static_cast<juce::uint32>(std::ceil(postMissSeconds * callbacksPerSecond));
+    const auto capacity = static_cast<size_t>(std::ceil(historySeconds * callbacksPerSecond)) + postMissCallbacks;
+
+    callbacks.assign(capacity, {});
+    nodes.assign(capacity * nodesPerCallback, {});
+    callbackCount.store(0, std::memory_order_relaxed);
+    nodeCount.store(0, std::memory_order_relaxed);
+
+    hasPrevious = false;
+    missPending = false;
+    restartPending.store(false, std::memory_order_relaxed);
+    frozen.store(false, std::memory_order_release);
+    prepared.store(true, std::memory_order_relaxed);
+    updateRecording();
+
+    spdlog::info("[FlightRecorder] Prepared {} callbacks of history ({:.1f} MB) at {} Hz, {} samples", capacity,
+                 static_cast<double>(capacity * (sizeof(CallbackRecord) + nodesPerCallback * sizeof(NodeRecord))) /
+                     (1024.0 * 1024.0),
+                 sampleRate, blockSize);
+}
+
+void FlightRecorder::release()
+{
+    prepared.store(false, std::memory_order_relaxed);
+    updateRecording();
+}
+
+void FlightRecorder::updateRecording()
+{
+    recording.store(enabled.load(std::memory_order_relaxed) && prepared.load(std::memory_order_relaxed) &&
+                        !frozen.load(std::memory_order_acquire),
+                    std::memory_order_relaxed);
+}
+
+//==============================================================================
+juce::int64 FlightRecorder::beginCallback() noexcept
+{
+    callbackThread.store(juce::Thread::getCurrentThreadId(), std::memory_order_relaxed);
+    return juce::Time::getHighResolutionTicks();
+}
+
+void FlightRecorder::endCallback(juce::int64 startTicks, int numSamples) noexcept
+{
+    if (!isRecording())
+        return;
+
+    const auto startNanos = ticksToNanos(startTicks);
+    addCallback(startNanos, ticksToNanos(juce::Time::getHighResolutionTicks()) - startNanos, numSamples);
+}
+
+void FlightRecorder::addCallback(juce::int64 startNanos, juce::int64 durationNanos, int numSamples) noexcept
+{
+    // frozen is checked too, in case setEnabled() raced the freeze
+    if (!isRecording() || frozen.load(std::memory_order_relaxed) || callbacks.empty() || currentSampleRate <= 0.0)
+        return;
+
+    if (restartPending.load(std::memory_order_acquire))
+    {
+        restartPending.store(false, std::memory_order_relaxed);
+        hasPrevious = false;
+    }
+
+    const double periodNanos = numSamples * 1.0e9 / currentSampleRate;
+
+    CallbackRecord record;
+    record.sequence = sequence;
+    record.numSamples = static_cast<juce::uint32>(numSamples);
+    record.startNanos = startNanos;
+    record.durationNanos = toUint32(durationNanos);
+    record.intervalNanos = hasPrevious ? toUint32(startNanos - previousStartNanos) : 0;
+
+    if (static_cast<double>(durationNanos) > periodNanos)
+        record.flags |= Overran;
+    if (hasPrevious && static_cast<double>(record.intervalNanos) > lateFactor * periodNanos)
+        record.flags |= Late;
+
+    previousStartNanos = startNanos;
+    hasPrevious = true;
+
+    // Single writer: plain load/store, and the count last so a reader never sees a half-written record
+    const auto count = callbackCount.load(std::memory_order_relaxed);
+    callbacks[static_cast<size_t>(count % callbacks.size())] = record;
+    callbackCount.store(count + 1, std::memory_order_release);
+
+    if (record.flags != 0)
+    {
+        misses.fetch_add(1, std::memory_order_relaxed);
+
+        if (!missPending && startNanos >= holdOffUntilNanos && dumps.load(std::memory_order_relaxed) < maxDumps)
+        {
+            missPending = true;
+            freezeAtSequence = sequence + postMissCallbacks;
+            missSequence.store(sequence, std::memory_order_relaxed);
+            missWallClock.store(juce::Time::currentTimeMillis(), std::memory_order_relaxed);
+        }
+    }
+
+    if (missPending && sequence == freezeAtSequence)
+    {
+        // The write thread takes it from here; see useTimeSlice()
+        missPending = false;
+        holdOffUntilNanos = startNanos + static_cast<juce::int64>(dumpHoldOffSeconds * 1.0e9);
+        recording.store(false, std::memory_order_relaxed);
+        frozen.store(true, std::memory_order_release);
+    }
+
+    ++sequence;
+}
+
+void FlightRecorder::recordNode(juce::uint32 nodeId, juce::int64 nanos) noexcept
+{
+    // Nodes run outside a device callback too (offline renders, other players)
+    if (!isRecording() || frozen.load(std::memory_order_relaxed) || nodes.empty() ||
+        callbackThread.load(std::memory_order_relaxed) != juce::Thread::getCurrentThreadId())
+        return;
+
+    // Tagged with the sequence addCallback() will give the enclosing callback
+    const auto count = nodeCount.load(std::memory_order_relaxed);
+    nodes[static_cast<size_t>(count % nodes.size())] = {sequence, nodeId, toUint32(nanos)};
+    nodeCount.store(count + 1, std::memory_order_release);
+}
+
+//==============================================================================
+void FlightRecorder::recordEvent(EventSource source, int channel, int number, float value,
+                                 const char* address) noexcept
+{
+    if (!isEnabled())
+        return;
+
+    // Any number of writers, so each slot is a small seqlock
+    const auto index = eventCount.fetch_add(1, std::memory_order_relaxed);
+    auto& slot = events[static_cast<size_t>(index % eventCapacity)];
+    slot.stamp.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    auto& event = slot.event;
+    event.timeNanos = getNanosSinceStart();
+    event.source = source;
+    event.channel = channel;
+    event.number = number;
+    event.value = value;
+    event.address[0] = 0;
+    if (address != nullptr)
+    {
+        std::strncpy(event.address, address, sizeof(event.address) - 1);
+        event.address[sizeof(event.address) - 1] = 0;
+    }
+
+    slot.stamp.store(2 * (index + 1), std::memory_order_release);
+}
+
+//==============================================================================
+int FlightRecorder::useTimeSlice()
+{
+    if (!frozen.load(std::memory_order_acquire))
+        return pollMs;
+
+    const auto trace = snapshot();
+
+    juce::File directory;
+    {
+        const juce::ScopedLock sl(infoLock);
+        directory = outputDirectory;
+    }
+    if (directory == juce::File())
+        directory = juce::File::getSpecialLocation(juce::File::tempDirectory);
+    directory.createDirectory();
+
+    const auto name = juce::Time(trace.wallClockMillis).formatted("flight-%Y%m%d-%H%M%S");
+    const auto file = directory.getChildFile(name + ".pbfr").getNonexistentSibling();
+
+    const bool written = writeTrace(trace, file);
+    resume();
+
+    if (written)
+    {
+        {
+            const juce::ScopedLock sl(infoLock);
+            lastDump = file;
+        }
+        dumps.fetch_add(1, std::memory_order_release);
+        spdlog::warn("[FlightRecorder] Callback {} missed its deadline; wrote {} callbacks, {} node timings and {} "
+                     "events to {}",
+                     trace.missSequence, trace.callbacks.size(), trace.nodes.size(), trace.events.size(),
+                     file.getFullPathName().toStdString());
+    }
+    else
+    {
+        spdlog::error("[FlightRecorder] Could not write {}", file.getFullPathName().toStdString());
+    }
+
+    return pollMs;
+}
+
+FlightRecorder::Trace FlightRecorder::snapshot()
+{
+    Trace trace;
+    {
+        const juce::ScopedLock sl(infoLock);
+        trace.patchIndex = patchIndex;
+        trace.patchName = patchName;
+    }
+
+    {
+        const juce::ScopedLock sl(storageLock);
+        trace.wallClockMillis = missWallClock.load(std::memory_order_relaxed);
+        trace.missSequence = missSequence.load(std::memory_order_relaxed);
+        trace.sampleRate = currentSampleRate;
+        trace.blockSize = currentBlockSize;
+
+        // Oldest first. The audio thread has stopped writing, so the rings are stable.
+        if (!callbacks.empty())
+        {
+            const auto count = callbackCount.load(std::memory_order_acquire);
+            const auto first = count > callbacks.size() ? count - callbacks.size() : 0;
+            trace.callbacks.reserve(static_cast<size_t>(count - first));
+            for (auto i = first; i < count; ++i)
+                trace.callbacks.push_back(callbacks[static_cast<size_t>(i % callbacks.size())]);
+        }
+
+        if (!nodes.empty() && !trace.callbacks.empty())
+        {
+            const auto oldest = trace.callbacks.front().sequence;
+            const auto count = nodeCount.load(std::memory_order_acquire);
+            const auto first = count > nodes.size() ? count - nodes.size() : 0;
+            for (auto i = first; i < count; ++i)
+            {
+                const auto& node = nodes[static_cast<size_t>(i % nodes.size())];
+                if (node.sequence - oldest < 0x80000000u) // Not older than the oldest callback, allowing for wrap
+                    trace.nodes.push_back(node);
+            }
+        }
+    }
+
+    // Events may still be arriving; skip any slot that changes while it's copied
+    const auto count = eventCount.load(std::memory_order_acquire);
+    const auto first = count > eventCapacity ? count - eventCapacity : 0;
+    for (auto i = first; i < count; ++i)
+    {
+        const auto& slot = events[static_cast<size_t>(i % eventCapacity)];
+        const auto stamp = slot.stamp.load(std::memory_order_acquire);
+        if (stamp != 2 * (i + 1))
+            continue;
+
+        const auto event = slot.event;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.stamp.load(std::memory_order_relaxed) == stamp)
+            trace.events.push_back(event);
+    }
+
+    trace.nodeNames = DspProfiler::getInstance().getMeterNames();
+    return trace;
+}
+
+void FlightRecorder::resume()
+{
+    {
+        const juce::ScopedLock sl(storageLock);
+        callbackCount.store(0, std::memory_order_relaxed);
+        nodeCount.store(0, std::memory_order_relaxed);
+    }
+
+    restartPending.store(true, std::memory_order_release);
+    frozen.store(false, std::memory_order_release);
+    updateRecording();
+}
+
+//==============================================================================
+bool FlightRecorder::writeTrace(const Trace& trace, const juce::File& file)
+{
+    juce::FileOutputStream out(file);
+    if (!out.openedOk())
+        return false;
+
+    out.writeInt(static_cast<int>(fileMagic));
+    out.writeInt(fileVersion);
+    out.writeInt64(trace.wallClockMillis);
+    out.writeDouble(trace.sampleRate);
+    out.writeInt(trace.blockSize);
+    out.writeInt(static_cast<int>(trace.missSequence));
+    out.writeInt(trace.patchIndex);
+    out.writeString(trace.patchName);
+
+    out.writeInt(static_cast<int>(trace.callbacks.size()));
+    for (const auto& record : trace.callbacks)
+    {
+        out.writeInt(static_cast<int>(record.sequence));
+        out.writeInt(static_cast<int>(record.numSamples));
+        out.writeInt64(record.startNanos);
+        out.writeInt(static_cast<int>(record.durationNanos));
+        out.writeInt(static_cast<int>(record.intervalNanos));
+        out.writeInt(static_cast<int>(record.flags));
+    }
+
+    out.writeInt(static_cast<int>(trace.nodeNames.size()));
+    for (const auto& [id, name] : trace.nodeNames)
+    {
+        out.writeInt(static_cast<int>(id));
+        out.writeString(name);
+    }
+
+    out.writeInt(static_cast<int>(trace.nodes.size()));
+    for (const auto& node : trace.nodes)
+    {
+        out.writeInt(static_cast<int>(node.sequence));
+        out.writeInt(static_cast<int>(node.node));
+        out.writeInt(static_cast<int>(node.nanos));
+    }
+
+    out.writeInt(static_cast<int>(trace.events.size()));
+    for (const auto& event : trace.events)
+    {
+        out.writeInt64(event.timeNanos);
+        out.writeInt(static_cast<int>(event.source));
+        out.writeInt(event.channel);
+        out.writeInt(event.number);
+        out.writeFloat(event.value);
+        out.writeString(juce::String::fromUTF8(event.address));
+    }
+
+    out.flush();
+    return out.getStatus().wasOk();
+}
+
+bool FlightRecorder::readTrace(const juce::File& file, Trace& trace)
+{
+    juce::FileInputStream in(file);
+    if (!in.openedOk() || static_cast<juce::uint32>(in.readInt()) != fileMagic || in.readInt() != fileVersion)
+        return false;
+
+    trace = {};
+    trace.wallClockMillis = in.readInt64();
+    trace.sampleRate = in.readDouble();
+    trace.blockSize = in.readInt();
+    trace.missSequence = static_cast<juce::uint32>(in.readInt());
+    trace.patchIndex = in.readInt();
+    trace.patchName = in.readString();
+
+    // Counts are checked against what's left, so a corrupt file can't ask for a huge allocation
+    bool valid = true;
+    const auto readCount = [&in, &valid](int minimumBytesEach)
+    {
+        const auto count = static_cast<juce::uint32>(in.readInt());
+        if (static_cast<juce::int64>(count) * minimumBytesEach <= in.getNumBytesRemaining())
+            return static_cast<size_t>(count);
+        valid = false;
+        return size_t{0};
+    };
+
+    trace.callbacks.resize(readCount(28));
+    for (auto& record : trace.callbacks)
+    {
+        record.sequence = static_cast<juce::uint32>(in.readInt());
+        record.numSamples = static_cast<juce::uint32>(in.readInt());
+        record.startNanos = in.readInt64();
+        record.durationNanos = static_cast<juce::uint32>(in.readInt());
+        record.intervalNanos = static_cast<juce::uint32>(in.readInt());
+        record.flags = static_cast<juce::uint32>(in.readInt());
+    }
+
+    trace.nodeNames.resize(readCount(5));
+    for (auto& [id, name] : trace.nodeNames)
+    {
+        id = static_cast<juce::uint32>(in.readInt());
+        name = in.readString();
+    }
+
+    trace.nodes.resize(readCount(12));
+    for (auto& node : trace.nodes)
+    {
+        node.sequence = static_cast<juce::uint32>(in.readInt());
+        node.node = static_cast<juce::uint32>(in.readInt());
+        node.nanos = static_cast<juce::uint32>(in.readInt());
+    }
+
+    trace.events.resize(readCount(25));
+    for (auto& event : trace.events)
+    {
+        event.timeNanos = in.readInt64();
+        event.source = static_cast<EventSource>(in.readInt());
+        event.channel = in.readInt();
+        event.number = in.readInt();
+        event.value = in.readFloat();
+        in.readString().copyToUTF8(event.address, sizeof(event.address));
+    }
+
+    return valid && in.getNumBytesRemaining() == 0;
+}
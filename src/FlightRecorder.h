@@ -0,0 +1,252 @@
+/*
+  ==============================================================================
+
+    FlightRecorder.h
+    Audio callback deadline monitor that dumps recent timing on a glitch
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include <array>
+#include <atomic>
+#include <utility>
+#include <vector>
+
+//==============================================================================
+/**
+    Records the last historySeconds of audio callbacks and dumps them to a
+    file when one misses its deadline, so a single glitch in a long show can
+    be examined afterwards.
+
+    MeteringProcessorPlayer timestamps every device callback. A callback
+    misses when it takes longer than its buffer period (Overran) or starts
+    more than lateFactor periods after the previous one (Late: the device or
+    the OS stalled us). Each callback's record goes into a preallocated ring,
+    along with the time every DspLoadMeter'd node took inside it. MIDI and
+    OSC mapping events and patch changes go into a smaller ring of their own.
+
+    On a miss the recorder keeps going for postMissSeconds, to show the
+    recovery, then freezes: the rings stop advancing and the disk write
+    thread dumps them, with the active patch, to a .pbfr file in the output
+    directory. Recording resumes once the file is written. Dumps are at
+    least dumpHoldOffSeconds apart and capped at maxDumps per session;
+    getNumMisses() counts every miss regardless.
+
+    The audio thread never locks or allocates. The ring memory is sized in
+    prepare(), which runs while the device is stopped.
+
+    Off until setEnabled(true); the app turns it on only if the user has
+    (the FlightRecorder setting, Options > Flight Recorder).
+
+    File layout (little-endian; strings are null-terminated UTF-8):
+
+        uint32 magic ('PBFR'), int32 version
+        int64 wall clock at the miss (ms since 1970), double sample rate,
+        int32 block size, uint32 sequence of the callback that missed
+        int32 patch index, string patch name
+        uint32 count, then per callback: uint32 sequence, uint32 samples,
+            int64 start (ns), uint32 duration (ns), uint32 interval since
+            the previous start (ns, 0 if unknown), uint32 flags
+        uint32 count, then per node: uint32 id, string name
+        uint32 count, then per node timing: uint32 callback sequence,
+            uint32 node id, uint32 duration (ns)
+        uint32 count, then per event: int64 time (ns), uint32 source,
+            int32 channel, int32 number, float value, string OSC address
+
+    All times are on one clock, in nanoseconds from when the recorder was
+    created.
+*/
+class FlightRecorder : private juce::TimeSliceClient
+{
+  public:
+    static constexpr double historySeconds = 10.0;
+    static constexpr double postMissSeconds = 0.5;
+    static constexpr double lateFactor = 1.5;
+    static constexpr int nodesPerCallback = 32; // Node ring capacity per callback of history
+    static constexpr int eventCapacity = 256;
+    static constexpr double dumpHoldOffSeconds = 30.0;
+    static constexpr int maxDumps = 20;
+
+    static constexpr juce::uint32 fileMagic = 0x52464250; // "PBFR"
+    static constexpr int fileVersion = 1;
+
+    enum CallbackFlags : juce::uint32
+    {
+        Overran = 1,
+        Late = 2
+    };
+
+    enum class EventSource : juce::uint32
+    {
+        MidiCc,
+        ProgramChange,
+        Osc,
+        PatchChange
+    };
+
+    struct CallbackRecord
+    {
+        juce::uint32 sequence = 0;
+        juce::uint32 numSamples = 0;
+        juce::int64 startNanos = 0;
+        juce::uint32 durationNanos = 0;
+        juce::uint32 intervalNanos = 0;
+        juce::uint32 flags = 0;
+    };
+
+    struct NodeRecord
+    {
+        juce::uint32 sequence = 0; // The callback it ran in
+        juce::uint32 node = 0;     // DspLoadMeter::getId()
+        juce::uint32 nanos = 0;
+    };
+
+    struct Event
+    {
+        juce::int64 timeNanos = 0;
+        EventSource source = EventSource::MidiCc;
+        juce::int32 channel = 0;
+        juce::int32 number = 0;
+        float value = 0.0f;
+        char address[32] = {}; // OSC only, truncated
+    };
+
+    /// A dump file's contents
+    struct Trace
+    {
+        juce::int64 wallClockMillis = 0;
+        double sampleRate = 0.0;
+        int blockSize = 0;
+        juce::uint32 missSequence = 0;
+        int patchIndex = -1;
+        juce::String patchName;
+        std::vector<CallbackRecord> callbacks;
+        std::vector<std::pair<juce::uint32, juce::String>> nodeNames;
+        std::vector<NodeRecord> nodes;
+        std::vector<Event> events;
+    };
+
+    static FlightRecorder& getInstance();
+
+    /// True while callbacks are being recorded. Cheap enough for the audio thread.
+    static bool isRecording() noexcept { return recording.load(std::memory_order_relaxed); }
+
+    //==========================================================================
+    // Setup (message thread)
+
+    void setEnabled(bool shouldBeEnabled);
+    bool isEnabled() const { return enabled.load(std::memory_order_relaxed); }
+
+    void setOutputDirectory(const juce::File& directory);
+
+    /// Called on every patch switch, for the dump's header
+    void setActivePatch(int index, const juce::String& name);
+
+    //==========================================================================
+    // Device (not while callbacks are running)
+
+    /// Sizes the rings for historySeconds of blockSize callbacks and clears them
+    void prepare(double sampleRate, int blockSize);
+    /// Stops recording until the next prepare()
+    void release();
+
+    //==========================================================================
+    // Audio thread
+
+    /// Returns the callback's start, for endCallback()
+    juce::int64 beginCallback() noexcept;
+    void endCallback(juce::int64 startTicks, int numSamples) noexcept;
+
+    /// Adds one callback's record and checks it against the deadline
+    void addCallback(juce::int64 startNanos, juce::int64 durationNanos, int numSamples) noexcept;
+
+    /// A node's processBlock time within the current callback
+    void recordNode(juce::uint32 nodeId, juce::int64 nanos) noexcept;
+
+    //==========================================================================
+    // Any thread
+
+    void recordEvent(EventSource source, int channel, int number, float value,
+                     const char* address = nullptr) noexcept;
+
+    juce::int64 getNanosSinceStart() const noexcept { return ticksToNanos(juce::Time::getHighResolutionTicks()); }
+
+    bool isFrozen() const { return frozen.load(std::memory_order_acquire); }
+    int getNumMisses() const { return misses.load(std::memory_order_relaxed); }
+    int getNumDumps() const { return dumps.load(std::memory_order_acquire); }
+    juce::File getLastDump() const;
+
+    /// Reads a dump file back; false if it isn't one
+    static bool readTrace(const juce::File& file, Trace& trace);
+
+  private:
+    FlightRecorder();
+    ~FlightRecorder() override;
+
+    int useTimeSlice() override;
+    Trace snapshot();
+    static bool writeTrace(const Trace& trace, const juce::File& file);
+    void resume();
+    void updateRecording();
+
+    juce::int64 ticksToNanos(juce::int64 ticks) const noexcept
+    {
+        return static_cast<juce::int64>(juce::Time::highResolutionTicksToSeconds(ticks - epochTicks) * 1.0e9);
+    }
+
+    struct EventSlot
+    {
+        std::atomic<juce::uint64> stamp{0}; // Odd while being written, else 2 * (index + 1)
+        Event event;
+    };
+
+    const juce::int64 epochTicks;
+
+    inline static std::atomic<bool> recording{false};
+    std::atomic<bool> enabled{false};
+    std::atomic<bool> prepared{false};
+    std::atomic<bool> frozen{false};
+    std::atomic<int> misses{0};
+    std::atomic<int> dumps{0};
+
+    // Storage, resized by prepare() and read by the dump under storageLock
+    juce::CriticalSection storageLock;
+    double currentSampleRate = 0.0;
+    int currentBlockSize = 0;
+    std::vector<CallbackRecord> callbacks;
+    std::vector<NodeRecord> nodes;
+    std::array<EventSlot, eventCapacity> events;
+
+    juce::uint32 postMissCallbacks = 0;
+
+    // Audio thread only
+    juce::uint32 sequence = 0;
+    juce::int64 previousStartNanos = 0;
+    bool hasPrevious = false;
+    juce::uint32 freezeAtSequence = 0;
+    bool missPending = false;
+    juce::int64 holdOffUntilNanos = 0;
+
+    std::atomic<juce::Thread::ThreadID> callbackThread{nullptr};
+    std::atomic<bool> restartPending{false}; // Set on resume, so the gap isn't counted as a late callback
+
+    // Written by the audio thread, read by the dump once frozen
+    std::atomic<juce::uint64> callbackCount{0};
+    std::atomic<juce::uint64> nodeCount{0};
+    std::atomic<juce::uint32> missSequence{0};
+    std::atomic<juce::int64> missWallClock{0};
+
+    std::atomic<juce::uint64> eventCount{0};
+
+    juce::CriticalSection infoLock;
+    juce::File outputDirectory;
+    juce::File lastDump;
+    int patchIndex = -1;
+    juce::String patchName;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(FlightRecorder)
+};
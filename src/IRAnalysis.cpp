@@ -0,0 +1,283 @@
+/*
+  ==============================================================================
+
+    IRAnalysis.cpp
+    Load-time impulse response analysis: noise-floor tail truncation,
+    leading-silence removal and minimum-phase conversion
+
+  ==============================================================================
+*/
+
+#include "IRAnalysis.h"
+
+#include <juce_dsp/juce_dsp.h>
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <vector>
+
+namespace
+{
+constexpr double envelopeWindowSeconds = 0.001;
+constexpr double tailFadeSeconds = 0.005;
+constexpr float floorMarginDb = 6.0f;      // Cut this far above the noise floor
+constexpr float maxTailRangeDb = -80.0f;   // Never keep a tail below this
+constexpr float leadThresholdDb = -60.0f;  // Pre-delay ends at the first sample above this
+constexpr float silentFloorDb = -120.0f;
+constexpr float maxFloorDb = -40.0f;       // A "floor" louder than this is really decay
+constexpr int maxMinimumPhaseOrder = 21;
+
+int getWindowSize(double sampleRate)
+{
+    return juce::jmax(1, juce::roundToInt(sampleRate * envelopeWindowSeconds));
+}
+
+/// Mean-square energy per envelope window, loudest channel
+std::vector<float> getEnvelope(const juce::AudioBuffer<float>& ir, int windowSize)
+{
+    const int length = ir.getNumSamples();
+    std::vector<float> envelope(static_cast<size_t>((length + windowSize - 1) / windowSize), 0.0f);
+
+    for (int ch = 0; ch < ir.getNumChannels(); ++ch)
+    {
+        const float* data = ir.getReadPointer(ch);
+        for (size_t w = 0; w < envelope.size(); ++w)
+        {
+            const int first = static_cast<int>(w) * windowSize;
+            const int count = juce::jmin(windowSize, length - first);
+
+            float energy = 0.0f;
+            for (int i = first; i < first + count; ++i)
+                energy += data[i] * data[i];
+            envelope[w] = juce::jmax(envelope[w], energy / static_cast<float>(count));
+        }
+    }
+    return envelope;
+}
+
+float getPeak(const std::vector<float>& envelope)
+{
+    float peak = 0.0f;
+    for (auto energy : envelope)
+        peak = juce::jmax(peak, energy);
+    return peak;
+}
+
+float getMean(const std::vector<float>& envelope, size_t first, size_t last)
+{
+    double sum = 0.0;
+    for (size_t w = first; w < last; ++w)
+        sum += envelope[w];
+    return last > first ? static_cast<float>(sum / static_cast<double>(last - first)) : 0.0f;
+}
+
+/// Shortens ir to the last envelope window above thresholdDb (relative to
+/// the envelope peak) and fades the new end out. Returns the kept length.
+int trimTail(juce::AudioBuffer<float>& ir, double sampleRate, float thresholdDb)
+{
+    const int windowSize = getWindowSize(sampleRate);
+    const auto envelope = getEnvelope(ir, windowSize);
+    const float threshold = getPeak(envelope) * std::pow(10.0f, thresholdDb / 10.0f);
+
+    int lastWindow = -1;
+    for (int w = static_cast<int>(envelope.size()) - 1; w >= 0; --w)
+    {
+        if (envelope[static_cast<size_t>(w)] >= threshold && threshold > 0.0f)
+        {
+            lastWindow = w;
+            break;
+        }
+    }
+
+    const int length = juce::jmin(ir.getNumSamples(), (lastWindow + 1) * windowSize);
+    if (length >= ir.getNumSamples())
+        return ir.getNumSamples();
+
+    // Half-cosine fade so the cut doesn't add a click to every note
+    const int fadeLength = juce::jmin(juce::roundToInt(sampleRate * tailFadeSeconds), length / 4);
+    for (int ch = 0; ch < ir.getNumChannels(); ++ch)
+    {
+        float* data = ir.getWritePointer(ch);
+        for (int i = 0; i < fadeLength; ++i)
+        {
+            const float phase = static_cast<float>(i + 1) / static_cast<float>(fadeLength);
+            data[length - fadeLength + i] *= 0.5f * (1.0f + std::cos(juce::MathConstants<float>::pi * phase));
+        }
+    }
+
+    ir.setSize(ir.getNumChannels(), length, true);
+    return length;
+}
+
+/// Removes samples before the first one within leadThresholdDb of the peak,
+/// but no more than maxSamples
+int stripLeadingSilence(juce::AudioBuffer<float>& ir, int maxSamples)
+{
+    const int length = ir.getNumSamples();
+    const float threshold = ir.getMagnitude(0, length) * juce::Decibels::decibelsToGain(leadThresholdDb);
+    if (threshold <= 0.0f)
+        return 0;
+
+    int first = length;
+    for (int ch = 0; ch < ir.getNumChannels(); ++ch)
+    {
+        const float* data = ir.getReadPointer(ch);
+        for (int i = 0; i < first; ++i)
+        {
+            if (std::abs(data[i]) >= threshold)
+            {
+                first = i;
+                break;
+            }
+        }
+    }
+
+    if (first >= length)
+        return 0;
+
+    first = juce::jmin(first, maxSamples);
+    if (first <= 0)
+        return 0;
+
+    juce::AudioBuffer<float> stripped(ir.getNumChannels(), length - first);
+    for (int ch = 0; ch < ir.getNumChannels(); ++ch)
+        stripped.copyFrom(ch, 0, ir, ch, first, length - first);
+    ir = std::move(stripped);
+    return first;
+}
+
+} // namespace
+
+//==============================================================================
+namespace IRAnalysis
+{
+juce::String Report::toString() const
+{
+    juce::String text = juce::String(getLengthMs(), 1) + " ms of " + juce::String(getOriginalLengthMs(), 1) + " ms";
+    if (noiseFloorDb > silentFloorDb)
+        text << ", floor " << juce::roundToInt(noiseFloorDb) << " dB";
+    if (minimumPhase)
+        text << ", minimum phase";
+    if (getComputeSavings() > 0.005)
+        text << ", " << juce::roundToInt(100.0 * getComputeSavings()) << "% less CPU";
+    return text;
+}
+
+float estimateNoiseFloorDb(const juce::AudioBuffer<float>& ir, double sampleRate)
+{
+    const auto envelope = getEnvelope(ir, getWindowSize(sampleRate));
+    const float peak = getPeak(envelope);
+    if (envelope.size() < 10 || peak <= 0.0f)
+        return silentFloorDb;
+
+    // Noise is flat; a tail region that is still decaying holds no floor
+    const size_t tailStart = envelope.size() - envelope.size() / 10;
+    const size_t tailMiddle = (tailStart + envelope.size()) / 2;
+    const float early = getMean(envelope, tailStart, tailMiddle);
+    const float late = getMean(envelope, tailMiddle, envelope.size());
+    if (late <= 0.0f || early > 2.0f * late)
+        return silentFloorDb;
+
+    const float floorEnergy = getMean(envelope, tailStart, envelope.size());
+    const float floorDb = 10.0f * std::log10(floorEnergy / peak);
+    if (floorDb > maxFloorDb)
+        return silentFloorDb;
+
+    return juce::jmax(silentFloorDb, floorDb);
+}
+
+void makeMinimumPhase(juce::AudioBuffer<float>& ir)
+{
+    const int length = ir.getNumSamples();
+    if (length < 2)
+        return;
+
+    // Generous zero padding keeps cepstral aliasing out of the result
+    int order = 1;
+    while ((1 << order) < length)
+        ++order;
+    order = juce::jmin(order + 2, juce::jmax(order, maxMinimumPhaseOrder));
+
+    const int size = 1 << order;
+    juce::dsp::FFT fft(order);
+    std::vector<juce::dsp::Complex<float>> time(static_cast<size_t>(size));
+    std::vector<juce::dsp::Complex<float>> freq(static_cast<size_t>(size));
+
+    for (int ch = 0; ch < ir.getNumChannels(); ++ch)
+    {
+        float* data = ir.getWritePointer(ch);
+
+        std::fill(time.begin(), time.end(), juce::dsp::Complex<float>());
+        for (int i = 0; i < length; ++i)
+            time[static_cast<size_t>(i)] = {data[i], 0.0f};
+        fft.perform(time.data(), freq.data(), false);
+
+        // Real cepstrum of the log magnitude (floored to avoid log(0))
+        float maxMagnitude = 0.0f;
+        for (const auto& bin : freq)
+            maxMagnitude = juce::jmax(maxMagnitude, std::abs(bin));
+        if (maxMagnitude <= 0.0f)
+            continue;
+
+        const float magnitudeFloor = maxMagnitude * 1.0e-6f;
+        for (auto& bin : freq)
+            bin = {std::log(juce::jmax(magnitudeFloor, std::abs(bin))), 0.0f};
+        fft.perform(freq.data(), time.data(), true);
+
+        // Fold the anti-causal part onto the causal part
+        for (int n = 1; n < size / 2; ++n)
+            time[static_cast<size_t>(n)] *= 2.0f;
+        for (int n = size / 2 + 1; n < size; ++n)
+            time[static_cast<size_t>(n)] = {};
+
+        fft.perform(time.data(), freq.data(), false);
+        for (auto& bin : freq)
+            bin = std::exp(bin);
+        fft.perform(freq.data(), time.data(), true);
+
+        for (int i = 0; i < length; ++i)
+            data[i] = time[static_cast<size_t>(i)].real();
+    }
+}
+
+Report process(juce::AudioBuffer<float>& ir, double sampleRate, const Options& options)
+{
+    Report report;
+    report.sampleRate = sampleRate;
+    report.originalLength = ir.getNumSamples();
+    report.length = ir.getNumSamples();
+
+    if (ir.getNumSamples() == 0)
+        return report;
+
+    if (ir.getMagnitude(0, ir.getNumSamples()) <= 0.0f)
+    {
+        ir.setSize(ir.getNumChannels(), 0);
+        report.length = 0;
+        return report;
+    }
+
+    report.noiseFloorDb = estimateNoiseFloorDb(ir, sampleRate);
+    const float tailThresholdDb = juce::jmax(maxTailRangeDb, report.noiseFloorDb + floorMarginDb);
+
+    if (options.stripLeadingSilence)
+        report.leadingSamplesRemoved = stripLeadingSilence(ir, options.maxLeadingSamples);
+
+    if (options.trimTail)
+        trimTail(ir, sampleRate, tailThresholdDb);
+
+    if (options.minimumPhase)
+    {
+        makeMinimumPhase(ir);
+        report.minimumPhase = true;
+
+        // Energy now arrives earlier, so the same relative threshold cuts sooner
+        if (options.trimTail)
+            trimTail(ir, sampleRate, tailThresholdDb);
+    }
+
+    report.length = ir.getNumSamples();
+    return report;
+}
+} // namespace IRAnalysis
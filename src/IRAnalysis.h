@@ -0,0 +1,88 @@
+/*
+  ==============================================================================
+
+    IRAnalysis.h
+    Load-time impulse response analysis: noise-floor tail truncation,
+    leading-silence removal and minimum-phase conversion
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+#include <limits>
+
+//==============================================================================
+/**
+    Shortens impulse responses before they are partitioned.
+
+    Many commercial cab IRs are 500 ms or longer while only the first few tens
+    of milliseconds sit above the capture's noise floor. The analysis
+    estimates that floor from the end of the file, cuts the tail where the
+    envelope sinks into it (with a short fade), and can optionally strip
+    pre-delay and convert the IR to minimum phase, which pulls the energy to
+    the front and usually lets the tail be cut much earlier.
+
+    Pre-delay stripping is off by default: it moves the IR's onset, which
+    changes its timing against the dry signal and against a second IR it is
+    blended with (see Options::maxLeadingSamples).
+*/
+namespace IRAnalysis
+{
+struct Options
+{
+    bool trimTail = true;
+    bool stripLeadingSilence = false;
+    bool minimumPhase = false;
+
+    /// Strips at most this much pre-delay, so two IRs blended together can
+    /// both lose the same (the smaller) onset and stay aligned
+    int maxLeadingSamples = std::numeric_limits<int>::max();
+
+    bool operator==(const Options& other) const
+    {
+        return trimTail == other.trimTail && stripLeadingSilence == other.stripLeadingSilence &&
+               minimumPhase == other.minimumPhase && maxLeadingSamples == other.maxLeadingSamples;
+    }
+    bool operator!=(const Options& other) const { return !(*this == other); }
+};
+
+struct Report
+{
+    double sampleRate = 0.0;
+    int originalLength = 0; // Samples at sampleRate, before analysis
+    int leadingSamplesRemoved = 0;
+    int length = 0;                 // Samples kept
+    float noiseFloorDb = -120.0f;   // Relative to the envelope peak
+    bool minimumPhase = false;
+
+    // Convolution cost per sample (arbitrary units), filled in by the
+    // engine since it depends on the partition layout
+    double originalCost = 0.0;
+    double cost = 0.0;
+
+    double getOriginalLengthMs() const { return sampleRate > 0.0 ? 1000.0 * originalLength / sampleRate : 0.0; }
+    double getLengthMs() const { return sampleRate > 0.0 ? 1000.0 * length / sampleRate : 0.0; }
+
+    /// Fraction of convolution work saved (0..1)
+    double getComputeSavings() const { return originalCost > 0.0 ? 1.0 - cost / originalCost : 0.0; }
+
+    /// e.g. "42.3 ms of 512.0 ms, floor -91 dB, 86% less CPU"
+    juce::String toString() const;
+};
+
+/// Analyses ir in place according to options. Returns an empty buffer
+/// (zero samples) if nothing rises above the noise floor.
+Report process(juce::AudioBuffer<float>& ir, double sampleRate, const Options& options);
+
+/// Noise floor in dB relative to the envelope peak, estimated from the
+/// last 10% of the IR. -120 dB if the tail is digitally silent or still
+/// decaying (no floor was reached).
+float estimateNoiseFloorDb(const juce::AudioBuffer<float>& ir, double sampleRate);
+
+/// Replaces each channel with its minimum-phase equivalent (same magnitude
+/// response) using the real cepstrum.
+void makeMinimumPhase(juce::AudioBuffer<float>& ir);
+} // namespace IRAnalysis
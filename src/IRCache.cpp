@@ -0,0 +1,165 @@
+/*
+  ==============================================================================
+
+    IRCache.cpp
+    Process-wide cache of prepared impulse response kernels
+
+  ==============================================================================
+*/
+
+#include "IRCache.h"
+
+#include <spdlog/spdlog.h>
+
+//==============================================================================
+IRCache& IRCache::getInstance()
+{
+    static IRCache instance;
+    return instance;
+}
+
+juce::String IRCache::makeKey(const juce::File& file, double sampleRate, int headSize,
+                             const IRAnalysis::Options& options)
+{
+    const int optionBits = (options.trimTail ? 1 : 0) | (options.stripLeadingSilence ? 2 : 0) |
+                           (options.minimumPhase ? 4 : 0);
+
+    const int maxLeading = options.stripLeadingSilence ? options.maxLeadingSamples : 0;
+
+    return file.getFullPathName() + "|" + juce::String(file.getLastModificationTime().toMilliseconds()) + "|" +
+           juce::String(file.getSize()) + "|" + juce::String(sampleRate) + "|" + juce::String(headSize) + "|" +
+           juce::String(optionBits) + "|" + juce::String(maxLeading);
+}
+
+//==============================================================================
+PartitionedConvolver::KernelPtr IRCache::getKernel(const juce::File& file, double sampleRate, int headSize,
+                                                   const IRAnalysis::Options& options)
+{
+    const auto key = makeKey(file, sampleRate, headSize, options);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        // Kernels released since the last call count against the limit now
+        enforceLimit();
+
+        auto it = entries.find(key);
+        if (it != entries.end())
+        {
+            lru.splice(lru.begin(), lru, it->second.lruPosition);
+            ++hits;
+            return it->second.kernel;
+        }
+        ++misses;
+    }
+
+    // Decode and transform outside the lock so other lookups aren't held up
+    IRAnalysis::Report report;
+    const auto ir = PartitionedConvolver::readImpulseResponse(file, sampleRate, options, &report);
+    if (ir.getNumSamples() == 0)
+    {
+        spdlog::error("[IRCache] Could not read IR: {}", file.getFullPathName().toStdString());
+        return nullptr;
+    }
+
+    report.originalCost = PartitionedConvolver::estimateCostPerSample(report.originalLength, headSize);
+    report.cost = PartitionedConvolver::estimateCostPerSample(report.length, headSize);
+
+    auto built = std::make_shared<PartitionedConvolver::Kernel>(ir, headSize);
+    built->analysis = report;
+    PartitionedConvolver::KernelPtr kernel = std::move(built);
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    // Another caller may have built the same kernel meanwhile
+    auto it = entries.find(key);
+    if (it != entries.end())
+    {
+        lru.splice(lru.begin(), lru, it->second.lruPosition);
+        return it->second.kernel;
+    }
+
+    lru.push_front(key);
+    Entry entry;
+    entry.kernel = kernel;
+    entry.bytes = kernel->getMemoryUsage();
+    entry.lruPosition = lru.begin();
+    entries.emplace(key, std::move(entry));
+
+    spdlog::info("[IRCache] Cached {}: {} ({} KB, {} entries)", file.getFileName().toStdString(),
+                 report.toString().toStdString(), kernel->getMemoryUsage() / 1024, entries.size());
+
+    enforceLimit();
+    return kernel;
+}
+
+//==============================================================================
+void IRCache::enforceLimit()
+{
+    size_t unusedBytes = 0;
+    for (const auto& [key, entry] : entries)
+        if (entry.kernel.use_count() == 1)
+            unusedBytes += entry.bytes;
+
+    // Walk from least recently used; kernels still held by a convolver stay
+    for (auto it = lru.end(); it != lru.begin() && unusedBytes > memoryLimit;)
+    {
+        --it;
+        auto entryIt = entries.find(*it);
+        if (entryIt->second.kernel.use_count() != 1)
+            continue;
+
+        unusedBytes -= entryIt->second.bytes;
+        entries.erase(entryIt);
+        it = lru.erase(it);
+    }
+}
+
+void IRCache::purgeUnused()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto it = lru.begin(); it != lru.end();)
+    {
+        auto entryIt = entries.find(*it);
+        if (entryIt->second.kernel.use_count() == 1)
+        {
+            entries.erase(entryIt);
+            it = lru.erase(it);
+        }
+        else
+            ++it;
+    }
+}
+
+void IRCache::setMemoryLimit(size_t bytes)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    memoryLimit = bytes;
+    enforceLimit();
+}
+
+size_t IRCache::getMemoryLimit() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return memoryLimit;
+}
+
+IRCache::Stats IRCache::getStats() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    Stats stats;
+    stats.entries = static_cast<int>(entries.size());
+    stats.hits = hits;
+    stats.misses = misses;
+    for (const auto& [key, entry] : entries)
+    {
+        stats.bytes += entry.bytes;
+        if (entry.kernel.use_count() > 1)
+        {
+            ++stats.entriesInUse;
+            stats.bytesInUse += entry.bytes;
+        }
+    }
+    return stats;
+}
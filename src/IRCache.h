@@ -0,0 +1,98 @@
+/*
+  ==============================================================================
+
+    IRCache.h
+    Process-wide cache of prepared impulse response kernels
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "PartitionedConvolver.h"
+
+#include <juce_core/juce_core.h>
+
+#include <list>
+#include <map>
+#include <mutex>
+
+//==============================================================================
+/**
+    Shares decoded, resampled and partition-transformed IR kernels between
+    every IRLoaderProcessor and NAMProcessor in the process.
+
+    Entries are keyed by file (path, modification time and size), sample rate,
+    analysis options and head size - the head size is derived from the host's maximum block
+    size and fully determines the partition layout. Kernels are reference
+    counted through KernelPtr: a kernel in use by any convolver is always
+    kept, and unused kernels stay cached (least recently used first out)
+    until their total size exceeds the memory limit. A patch change back to
+    a cab that was used recently is therefore a lookup rather than a reload.
+
+    Message-thread (or loader-thread) only; never call from the audio thread.
+*/
+class IRCache
+{
+  public:
+    struct Stats
+    {
+        int entries = 0;
+        int entriesInUse = 0;
+        size_t bytes = 0;
+        size_t bytesInUse = 0;
+        juce::int64 hits = 0;
+        juce::int64 misses = 0;
+    };
+
+    //==========================================================================
+    // Singleton Access
+
+    static IRCache& getInstance();
+
+    //==========================================================================
+    // Kernels
+
+    /// Returns the shared kernel for file in the given format, reading and
+    /// transforming it on a miss. Returns nullptr if the file can't be read.
+    PartitionedConvolver::KernelPtr getKernel(const juce::File& file, double sampleRate, int headSize,
+                                              const IRAnalysis::Options& options = {});
+
+    /// Drops every unused kernel
+    void purgeUnused();
+
+    /// Memory allowed for kernels that no convolver is using
+    void setMemoryLimit(size_t bytes);
+    size_t getMemoryLimit() const;
+
+    Stats getStats() const;
+
+  private:
+    IRCache() = default;
+
+    struct Entry
+    {
+        PartitionedConvolver::KernelPtr kernel;
+        size_t bytes = 0;
+        std::list<juce::String>::iterator lruPosition;
+    };
+
+    static juce::String makeKey(const juce::File& file, double sampleRate, int headSize,
+                                const IRAnalysis::Options& options);
+
+    /// Evicts least recently used unreferenced kernels until under the limit.
+    /// Caller must hold mutex.
+    void enforceLimit();
+
+    mutable std::mutex mutex;
+    std::map<juce::String, Entry> entries;
+    std::list<juce::String> lru; // Most recently used at the front
+    size_t memoryLimit = DEFAULT_MEMORY_LIMIT;
+    juce::int64 hits = 0;
+    juce::int64 misses = 0;
+
+    // Configuration
+    static constexpr size_t DEFAULT_MEMORY_LIMIT = 128 * 1024 * 1024;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(IRCache)
+};
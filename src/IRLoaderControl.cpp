@@ -504,21 +504,25 @@ void IRLoaderControl::updateIRDisplay()
     {
         irNameLabel->setText(irProcessor->getIRName(), dontSendNotification);
         irNameLabel->setColour(Label::textColourId, Colour(kTextBright));
+        irNameLabel->setTooltip(irProcessor->getIRAnalysisSummary(false));
     }
     else
     {
         irNameLabel->setText("No IR Loaded", dontSendNotification);
         irNameLabel->setColour(Label::textColourId, Colour(kTextDim));
+        irNameLabel->setTooltip({});
     }
 
     if (irProcessor->isIR2Loaded())
     {
         irName2Label->setText(irProcessor->getIR2Name(), dontSendNotification);
         irName2Label->setColour(Label::textColourId, Colour(kTextBright));
+        irName2Label->setTooltip(irProcessor->getIRAnalysisSummary(true));
     }
     else
     {
         irName2Label->setText("No IR 2 Loaded", dontSendNotification);
         irName2Label->setColour(Label::textColourId, Colour(kTextDim));
+        irName2Label->setTooltip({});
     }
 }
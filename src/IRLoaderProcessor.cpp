@@ -10,13 +10,10 @@
 #include "IRLoaderProcessor.h"
 
 #include "IRLoaderControl.h"
+#include "SettingsManager.h"
 
 //==============================================================================
-IRLoaderProcessor::IRLoaderProcessor() : PedalboardProcessor()
-{
-    convolver.reset();
-    convolver2.reset();
-}
+IRLoaderProcessor::IRLoaderProcessor() : PedalboardProcessor() {}
 
 IRLoaderProcessor::~IRLoaderProcessor() {}
 
@@ -29,18 +26,22 @@ void IRLoaderProcessor::prepareToPlay(double sampleRate, int estimatedSamplesPer
     spec.maximumBlockSize = static_cast<juce::uint32>(estimatedSamplesPerBlock);
     spec.numChannels = 2;
 
-    convolver.prepare(spec);
-    convolver2.prepare(spec);
+    convolver.prepare(sampleRate, estimatedSamplesPerBlock);
     lowCutFilter.prepare(spec);
     highCutFilter.prepare(spec);
 
     dryBuffer.setSize(2, estimatedSamplesPerBlock);
-    ir2Buffer.setSize(2, estimatedSamplesPerBlock);
 
     updateFilters();
     isPrepared = true;
 }
 
+void IRLoaderProcessor::setNonRealtime(bool isNonRealtime) noexcept
+{
+    PedalboardProcessor::setNonRealtime(isNonRealtime);
+    convolver.setNonRealtime(isNonRealtime);
+}
+
 //==============================================================================
 void IRLoaderProcessor::loadIRFile(const File& irFile)
 {
@@ -51,8 +52,8 @@ void IRLoaderProcessor::loadIRFile(const File& irFile)
     }
 
     currentIRFile = irFile;
-    convolver.loadImpulseResponse(irFile, juce::dsp::Convolution::Stereo::yes, juce::dsp::Convolution::Trim::yes, 0);
     irLoaded.store(true);
+    updateConvolver();
 }
 
 //==============================================================================
@@ -65,15 +66,57 @@ void IRLoaderProcessor::loadIRFile2(const File& irFile)
     }
 
     currentIRFile2 = irFile;
-    convolver2.loadImpulseResponse(irFile, juce::dsp::Convolution::Stereo::yes, juce::dsp::Convolution::Trim::yes, 0);
     ir2Loaded.store(true);
+    updateConvolver();
 }
 
 void IRLoaderProcessor::clearIR2()
 {
     currentIRFile2 = File();
     ir2Loaded.store(false);
-    convolver2.reset();
+    updateConvolver();
+}
+
+//==============================================================================
+void IRLoaderProcessor::updateConvolver()
+{
+    IRAnalysis::Options options;
+    options.minimumPhase = SettingsManager::getInstance().getBool("IRMinimumPhase", false);
+    options.stripLeadingSilence = SettingsManager::getInstance().getBool("IRStripPreDelay", false);
+    convolver.setAnalysisOptions(options);
+
+    // Both slots share one engine; with two IRs it blends them itself.
+    // A slot whose file is missing is dropped.
+    if (irLoaded.load() && ir2Loaded.load() && convolver.loadImpulseResponses(currentIRFile, currentIRFile2))
+        return;
+
+    if (irLoaded.load())
+    {
+        if (convolver.loadImpulseResponse(currentIRFile))
+        {
+            ir2Loaded.store(false);
+            return;
+        }
+        irLoaded.store(false);
+    }
+
+    if (ir2Loaded.load())
+    {
+        if (convolver.loadImpulseResponse(currentIRFile2))
+            return;
+        ir2Loaded.store(false);
+    }
+
+    convolver.clear();
+}
+
+String IRLoaderProcessor::getIRAnalysisSummary(bool secondIR) const
+{
+    // With a single slot loaded the engine holds it as its only IR
+    const bool slotLoaded = secondIR ? ir2Loaded.load() : irLoaded.load();
+    const bool blending = irLoaded.load() && ir2Loaded.load();
+    const auto report = slotLoaded ? convolver.getAnalysis(secondIR && blending) : nullptr;
+    return report != nullptr ? report->toString() : String();
 }
 
 //==============================================================================
@@ -104,53 +147,12 @@ void IRLoaderProcessor::processBlock(AudioSampleBuffer& buffer, MidiBuffer& midi
         lowCutFilter.process(context);
     }
 
-    // Dual IR processing with equal-power crossfade
-    if (hasIR1 && hasIR2 && blend > 0.0f && blend < 1.0f)
-    {
-        // Copy pre-filtered signal for IR2 processing
-        for (int ch = 0; ch < numChannels; ++ch)
-            ir2Buffer.copyFrom(ch, 0, buffer, ch, 0, numSamples);
-
-        // Process IR1
-        {
-            juce::dsp::AudioBlock<float> block(buffer);
-            juce::dsp::ProcessContextReplacing<float> context(block);
-            convolver.process(context);
-        }
-
-        // Process IR2
-        {
-            juce::dsp::AudioBlock<float> block2(ir2Buffer);
-            juce::dsp::ProcessContextReplacing<float> context2(block2);
-            convolver2.process(context2);
-        }
-
-        // Equal-power crossfade: gain1 = cos(blend * pi/2), gain2 = sin(blend * pi/2)
-        const float angle = blend * juce::MathConstants<float>::halfPi;
-        const float gain1 = std::cos(angle);
-        const float gain2 = std::sin(angle);
-
-        for (int ch = 0; ch < numChannels; ++ch)
-        {
-            float* out = buffer.getWritePointer(ch);
-            const float* ir2Data = ir2Buffer.getReadPointer(ch);
-            for (int i = 0; i < numSamples; ++i)
-                out[i] = out[i] * gain1 + ir2Data[i] * gain2;
-        }
-    }
-    else if (hasIR1 && (blend == 0.0f || !hasIR2))
+    // IR convolution; with both slots loaded the engine does the equal-power
+    // blend itself, pre-mixing the IRs once the blend knob settles
+    if (hasIR1 || hasIR2)
     {
-        // IR1 only
-        juce::dsp::AudioBlock<float> block(buffer);
-        juce::dsp::ProcessContextReplacing<float> context(block);
-        convolver.process(context);
-    }
-    else if (hasIR2 && (blend == 1.0f || !hasIR1))
-    {
-        // IR2 only
-        juce::dsp::AudioBlock<float> block(buffer);
-        juce::dsp::ProcessContextReplacing<float> context(block);
-        convolver2.process(context);
+        convolver.setBlend(blend);
+        convolver.process(buffer);
     }
 
     // Apply high cut filter (post-IR)
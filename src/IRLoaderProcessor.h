@@ -2,7 +2,7 @@
   ==============================================================================
 
     IRLoaderProcessor.h
-    Cabinet Impulse Response loader using JUCE's built-in convolution
+    Cabinet Impulse Response loader using zero-latency partitioned convolution
 
   ==============================================================================
 */
@@ -11,6 +11,7 @@
 
 #include <juce_dsp/juce_dsp.h>
 
+#include "PartitionedConvolver.h"
 #include "PedalboardProcessors.h"
 
 #include <atomic>
@@ -18,7 +19,7 @@
 //==============================================================================
 /**
     IR Loader processor for cabinet simulation.
-    Uses juce::dsp::Convolution for FFT-based convolution.
+    Uses PartitionedConvolver for zero-latency FFT-based convolution.
     Supports .wav and .aiff impulse response files.
 */
 class IRLoaderProcessor : public PedalboardProcessor
@@ -48,6 +49,16 @@ class IRLoaderProcessor : public PedalboardProcessor
     bool isIR2Loaded() const { return ir2Loaded.load(); }
     String getIR2Name() const { return currentIRFile2.getFileNameWithoutExtension(); }
 
+    /// Load-time analysis of a slot ("42.3 ms of 512.0 ms, ..."), empty if unloaded
+    String getIRAnalysisSummary(bool secondIR) const;
+
+    /// Reloads the loaded IRs, e.g. after the IR analysis settings changed
+    void reloadIRs() { updateConvolver(); }
+
+    /// True once the loaded IRs are playing; loads finish in the background
+    /// after loadIRFile() and prepareToPlay()
+    bool isIRReady() const { return convolver.isLoaded(); }
+
     //==========================================================================
     // Parameters
     float getMix() const { return mix.load(); }
@@ -70,6 +81,8 @@ class IRLoaderProcessor : public PedalboardProcessor
     const String getName() const override { return "IR Loader"; }
     void prepareToPlay(double sampleRate, int estimatedSamplesPerBlock) override;
     void releaseResources() override {}
+    /// Offline, the convolution waits for its worker rather than glitching
+    void setNonRealtime(bool isNonRealtime) noexcept override;
 
     const String getInputChannelName(int channelIndex) const override { return ""; }
     const String getOutputChannelName(int channelIndex) const override { return ""; }
@@ -110,11 +123,12 @@ class IRLoaderProcessor : public PedalboardProcessor
 
   private:
     void updateFilters();
+    /// Points the engine at whichever IR slots are loaded
+    void updateConvolver();
 
     //==========================================================================
-    // Convolution engines
-    juce::dsp::Convolution convolver;
-    juce::dsp::Convolution convolver2;
+    // Convolution engine (both IR slots)
+    PartitionedConvolver convolver;
     juce::dsp::ProcessSpec spec;
 
     // Pre/post filters for tone shaping (coefficients updated on audio thread only)
@@ -127,8 +141,6 @@ class IRLoaderProcessor : public PedalboardProcessor
 
     // Dry buffer for wet/dry mixing
     juce::AudioBuffer<float> dryBuffer;
-    // Buffer for second IR convolution output
-    juce::AudioBuffer<float> ir2Buffer;
 
     //==========================================================================
     // State
@@ -45,6 +45,7 @@
 #include "OscilloscopeProcessor.h"
 #include "PedalboardProcessors.h"
 #include "RoutingProcessors.h"
+#include "StemRecorderProcessor.h"
 #include "SubGraphProcessor.h"
 #include "ToneGeneratorProcessor.h"
 #include "TunerProcessor.h"
@@ -226,6 +227,12 @@ InternalPluginFormat::InternalPluginFormat()
         p.fillInPluginDescription(dawSplitterProcDesc);
         dawSplitterProcDesc.category = "Built-in";
     }
+
+    {
+        StemRecorderProcessor p;
+        p.fillInPluginDescription(stemRecorderProcDesc);
+        stemRecorderProcDesc.category = "Built-in";
+    }
 }
 
 AudioPluginInstance* InternalPluginFormat::createInstanceFromDescription(const PluginDescription& desc)
@@ -305,6 +312,10 @@ AudioPluginInstance* InternalPluginFormat::createInstanceFromDescription(const P
     {
         return new DawSplitterProcessor();
     }
+    else if (desc.name == stemRecorderProcDesc.name)
+    {
+        return new StemRecorderProcessor();
+    }
     else if (desc.name == irLoaderProcDesc.name)
     {
         return new IRLoaderProcessor();
@@ -415,6 +426,8 @@ const PluginDescription* InternalPluginFormat::getDescriptionFor(const InternalF
         return &dawMixerProcDesc;
     case dawSplitterProcFilter:
         return &dawSplitterProcDesc;
+    case stemRecorderProcFilter:
+        return &stemRecorderProcDesc;
     default:
         return 0;
     }
@@ -441,7 +454,8 @@ void InternalPluginFormat::getUserFacingTypes(OwnedArray<PluginDescription>& res
                                                          keyboardSplitProcFilter, notesProcFilter,
                                                          labelProcFilter,         midiFilePlayerProcFilter,
                                                          subGraphProcFilter,      virtualMidiInputProcFilter,
-                                                         dawMixerProcFilter,      dawSplitterProcFilter};
+                                                         dawMixerProcFilter,      dawSplitterProcFilter,
+                                                         stemRecorderProcFilter};
 
     for (auto type : userFacingTypes)
         results.add(new PluginDescription(*getDescriptionFor(type)));
@@ -81,6 +81,7 @@ class InternalPluginFormat : public AudioPluginFormat
         virtualMidiInputProcFilter,
         dawMixerProcFilter,
         dawSplitterProcFilter,
+        stemRecorderProcFilter,
 
         endOfFilterTypes
     };
@@ -156,6 +157,7 @@ class InternalPluginFormat : public AudioPluginFormat
     PluginDescription virtualMidiInputProcDesc;
     PluginDescription dawMixerProcDesc;
     PluginDescription dawSplitterProcDesc;
+    PluginDescription stemRecorderProcDesc;
 };
 
 #endif
@@ -0,0 +1,822 @@
+/*
+  ==============================================================================
+
+    LibraryWatcher.cpp
+    Background catalogue of NAM models and IR files with filesystem watching
+
+  ==============================================================================
+*/
+
+#include "LibraryWatcher.h"
+
+#include "SettingsManager.h"
+
+#include <algorithm>
+#include <nlohmann/json.hpp>
+#include <set>
+#include <spdlog/spdlog.h>
+
+#if JUCE_LINUX
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+// Guards against symlink cycles when recursing into subdirectories
+constexpr int maxDirectoryDepth = 16;
+
+// inotify poll timeout; also bounds how long a new watch/rescan request waits
+constexpr int eventPollTimeoutMs = 250;
+
+const char* kindToString(LibraryWatcher::EntryKind kind)
+{
+    return kind == LibraryWatcher::EntryKind::Model ? "model" : "ir";
+}
+
+std::atomic<LibraryWatcher*> sharedInstance{nullptr};
+} // namespace
+
+//==============================================================================
+LibraryWatcher& LibraryWatcher::getInstance()
+{
+    static LibraryWatcher instance(
+        SettingsManager::getInstance().getUserDataDirectory().getChildFile("LibraryCatalogue.json"));
+    sharedInstance.store(&instance, std::memory_order_release);
+    return instance;
+}
+
+LibraryWatcher* LibraryWatcher::getInstanceWithoutCreating()
+{
+    return sharedInstance.load(std::memory_order_acquire);
+}
+
+LibraryWatcher::LibraryWatcher(const juce::File& snapshot) : Thread("LibraryWatcher"), snapshotFile(snapshot)
+{
+    formatManager.registerBasicFormats();
+
+#if JUCE_LINUX
+    inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotifyFd < 0)
+        spdlog::warn("[LibraryWatcher] inotify unavailable, falling back to polling");
+#endif
+
+    // Load synchronously so browsers opened straight after startup see the
+    // previous session's catalogue while the watcher thread reconciles it.
+    loadSnapshot();
+
+    {
+        std::lock_guard<std::mutex> lock(requestMutex);
+        for (const auto& root : roots)
+            pendingRequests.push_back({juce::File(root), false});
+    }
+
+    startThread(juce::Thread::Priority::low);
+}
+
+LibraryWatcher::~LibraryWatcher()
+{
+    shutdown();
+}
+
+void LibraryWatcher::shutdown()
+{
+    // run() saves the snapshot on its way out
+    stopThread(5000);
+
+#if JUCE_LINUX
+    if (inotifyFd >= 0)
+    {
+        ::close(inotifyFd);
+        inotifyFd = -1;
+    }
+#endif
+}
+
+//==============================================================================
+// Roots
+
+void LibraryWatcher::watchDirectory(const juce::File& root)
+{
+    queueRequest(root, false);
+}
+
+void LibraryWatcher::unwatchDirectory(const juce::File& root)
+{
+    const auto path = root.getFullPathName().toStdString();
+
+    {
+        std::lock_guard<std::mutex> lock(catalogueMutex);
+        auto it = std::find(roots.begin(), roots.end(), path);
+        if (it == roots.end())
+            return;
+
+        roots.erase(it);
+        snapshotDirty = true;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(requestMutex);
+        pendingRequests.push_back({root, false, true});
+    }
+
+    notify();
+}
+
+void LibraryWatcher::rescan(const juce::File& root)
+{
+    queueRequest(root, true);
+}
+
+void LibraryWatcher::queueRequest(const juce::File& root, bool force)
+{
+    const auto path = root.getFullPathName().toStdString();
+
+    {
+        std::lock_guard<std::mutex> lock(catalogueMutex);
+        if (std::find(roots.begin(), roots.end(), path) == roots.end())
+        {
+            roots.push_back(path);
+            snapshotDirty = true;
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(requestMutex);
+        pendingRequests.push_back({root, force});
+    }
+
+    notify();
+}
+
+//==============================================================================
+// Catalogue Queries
+
+bool LibraryWatcher::isBelow(const std::string& filePath, const juce::File& root)
+{
+    juce::File file(filePath);
+    return file == root || file.isAChildOf(root);
+}
+
+std::vector<NAMModelInfo> LibraryWatcher::getModels(const juce::File& root) const
+{
+    std::vector<NAMModelInfo> result;
+
+    std::lock_guard<std::mutex> lock(catalogueMutex);
+    for (const auto& [path, record] : files)
+    {
+        if (record.kind == EntryKind::Model && isBelow(path, root))
+            result.push_back(record.model);
+    }
+
+    return result;
+}
+
+std::vector<IRFileInfo> LibraryWatcher::getImpulseResponses(const juce::File& root) const
+{
+    std::vector<IRFileInfo> result;
+
+    std::lock_guard<std::mutex> lock(catalogueMutex);
+    for (const auto& [path, record] : files)
+    {
+        if (record.kind == EntryKind::ImpulseResponse && isBelow(path, root))
+            result.push_back(record.ir);
+    }
+
+    return result;
+}
+
+//==============================================================================
+// Listeners
+
+void LibraryWatcher::addListener(Listener* listener)
+{
+    listeners.add(listener);
+}
+
+void LibraryWatcher::removeListener(Listener* listener)
+{
+    listeners.remove(listener);
+}
+
+void LibraryWatcher::publish(std::vector<Change> changes)
+{
+    if (changes.empty())
+        return;
+
+    spdlog::debug("[LibraryWatcher] Publishing {} catalogue changes", changes.size());
+
+    // Delivered after the watcher may have gone, if it was a test's own instance
+    juce::MessageManager::callAsync(
+        [self = juce::WeakReference<LibraryWatcher>(this), changes = std::move(changes)]()
+        {
+            if (self != nullptr)
+                self->listeners.call(&Listener::libraryChanged, changes);
+        });
+}
+
+void LibraryWatcher::publishScanFinished(const juce::File& root)
+{
+    juce::MessageManager::callAsync(
+        [self = juce::WeakReference<LibraryWatcher>(this), root]()
+        {
+            if (self != nullptr)
+                self->listeners.call(&Listener::libraryScanFinished, root);
+        });
+}
+
+//==============================================================================
+// Thread
+
+void LibraryWatcher::run()
+{
+    spdlog::info("[LibraryWatcher] Watcher thread started");
+
+    while (!threadShouldExit())
+    {
+        // Service watch/rescan requests from the browsers first
+        for (;;)
+        {
+            Request request;
+            {
+                std::lock_guard<std::mutex> lock(requestMutex);
+                if (pendingRequests.empty())
+                    break;
+                request = pendingRequests.front();
+                pendingRequests.pop_front();
+            }
+
+            if (request.forget)
+            {
+                std::vector<Change> changes;
+                forgetRoot(request.root, changes);
+                publish(std::move(changes));
+                continue;
+            }
+
+            scanning.store(true, std::memory_order_release);
+
+            std::vector<Change> changes;
+            auto startTime = juce::Time::getMillisecondCounter();
+            reconcileDirectory(request.root, request.force, changes);
+
+            scanning.store(false, std::memory_order_release);
+
+            spdlog::info("[LibraryWatcher] Reconciled {} in {} ms ({} changes)",
+                         request.root.getFullPathName().toStdString(),
+                         juce::Time::getMillisecondCounter() - startTime, changes.size());
+
+            publish(std::move(changes));
+            publishScanFinished(request.root);
+
+            if (threadShouldExit())
+                break;
+        }
+
+        syncWatches();
+        processFilesystemEvents();
+
+        if (snapshotDirty &&
+            juce::Time::getMillisecondCounter() - lastSnapshotTime > static_cast<juce::uint32>(SNAPSHOT_SAVE_INTERVAL_MS))
+            saveSnapshot();
+    }
+
+    if (snapshotDirty)
+        saveSnapshot();
+
+    spdlog::info("[LibraryWatcher] Watcher thread stopped");
+}
+
+void LibraryWatcher::processFilesystemEvents()
+{
+#if JUCE_LINUX
+    if (inotifyFd >= 0 && !usePolling)
+    {
+        pollfd pfd{inotifyFd, POLLIN, 0};
+        if (::poll(&pfd, 1, eventPollTimeoutMs) <= 0)
+            return;
+
+        alignas(inotify_event) char buffer[4096];
+        std::set<std::string> changedDirectories;
+        bool overflowed = false;
+
+        ssize_t length;
+        while ((length = ::read(inotifyFd, buffer, sizeof(buffer))) > 0)
+        {
+            for (char* ptr = buffer; ptr < buffer + length;)
+            {
+                const auto* event = reinterpret_cast<const inotify_event*>(ptr);
+
+                if (event->mask & IN_Q_OVERFLOW)
+                {
+                    overflowed = true;
+                }
+                else if (event->mask & IN_IGNORED)
+                {
+                    auto it = watchDescriptors.find(event->wd);
+                    if (it != watchDescriptors.end())
+                    {
+                        watchedDirectories.erase(it->second);
+                        watchDescriptors.erase(it);
+                    }
+                }
+                else
+                {
+                    auto it = watchDescriptors.find(event->wd);
+                    if (it != watchDescriptors.end())
+                        changedDirectories.insert(it->second);
+                }
+
+                ptr += sizeof(inotify_event) + event->len;
+            }
+        }
+
+        std::vector<Change> changes;
+
+        if (overflowed)
+        {
+            // Lost events - fall back to an mtime reconcile of every root
+            spdlog::warn("[LibraryWatcher] inotify queue overflowed, reconciling all roots");
+            for (const auto& root : getRoots())
+                reconcileDirectory(juce::File(root), false, changes);
+        }
+        else
+        {
+            // Only the touched directories are re-listed; their subdirectories
+            // are skipped via the mtime check unless they changed too (and
+            // have watches of their own for files written in place). Events
+            // for a directory forgotten since are dropped.
+            for (const auto& directory : changedDirectories)
+            {
+                if (directories.count(directory) > 0)
+                    reconcileDirectory(juce::File(directory), true, changes, false);
+            }
+        }
+
+        publish(std::move(changes));
+        return;
+    }
+#endif
+
+    wait(POLL_INTERVAL_MS);
+
+    {
+        std::lock_guard<std::mutex> lock(requestMutex);
+        if (threadShouldExit() || !pendingRequests.empty())
+            return;
+    }
+
+    // Directory mtimes only: stat'ing every file under every root each poll
+    // would keep the disk busy on a large library
+    std::vector<Change> changes;
+    for (const auto& root : getRoots())
+        reconcileDirectory(juce::File(root), false, changes, false);
+
+    publish(std::move(changes));
+}
+
+std::vector<std::string> LibraryWatcher::getRoots() const
+{
+    std::lock_guard<std::mutex> lock(catalogueMutex);
+    return roots;
+}
+
+//==============================================================================
+// Reconciliation (watcher thread only - the only writer of the catalogue, so
+// reads here do not need the lock)
+
+void LibraryWatcher::reconcileDirectory(const juce::File& directory, bool force, std::vector<Change>& changes,
+                                        bool statFiles, int depth)
+{
+    const auto path = directory.getFullPathName().toStdString();
+
+    if (!directory.isDirectory())
+    {
+        forgetDirectory(path, changes);
+        return;
+    }
+
+    if (depth > maxDirectoryDepth || threadShouldExit())
+        return;
+
+    const auto lastModified = directory.getLastModificationTime().toMilliseconds();
+    auto existing = directories.find(path);
+
+    // A directory's mtime changes whenever entries are added, removed or
+    // renamed, so an unchanged mtime means the previous listing still holds.
+    const bool relist = force || existing == directories.end() || existing->second.lastModified != lastModified;
+    if (relist)
+    {
+        DirectoryState state;
+        state.lastModified = lastModified;
+
+        for (const auto& entry :
+             juce::RangedDirectoryIterator(directory, false, "*", juce::File::findFilesAndDirectories))
+        {
+            const auto& file = entry.getFile();
+            EntryKind kind;
+
+            if (entry.isDirectory())
+                state.subdirectories.push_back(file.getFullPathName().toStdString());
+            else if (classify(file, kind))
+                state.files.push_back(file.getFullPathName().toStdString());
+        }
+
+        if (existing != directories.end())
+        {
+            const auto& previous = existing->second;
+
+            for (const auto& oldFile : previous.files)
+            {
+                if (std::find(state.files.begin(), state.files.end(), oldFile) == state.files.end())
+                    forgetFile(oldFile, changes);
+            }
+
+            for (const auto& oldDirectory : previous.subdirectories)
+            {
+                if (std::find(state.subdirectories.begin(), state.subdirectories.end(), oldDirectory) ==
+                    state.subdirectories.end())
+                    forgetDirectory(oldDirectory, changes);
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(catalogueMutex);
+            directories[path] = state;
+        }
+
+        snapshotDirty = true;
+        watchesDirty = true;
+    }
+
+    // Copy - recursion below may rehash the map
+    const auto state = directories[path];
+
+    // File contents can change without touching the directory mtime, so stat
+    // unless the caller only wants listing changes. Metadata is only re-read
+    // when mtime or size differ.
+    if (relist || statFiles)
+    {
+        for (const auto& filePath : state.files)
+            updateFile(juce::File(filePath), changes);
+    }
+
+    for (const auto& subdirectory : state.subdirectories)
+        reconcileDirectory(juce::File(subdirectory), false, changes, statFiles, depth + 1);
+}
+
+void LibraryWatcher::forgetDirectory(const std::string& path, std::vector<Change>& changes,
+                                     const std::vector<std::string>& keep)
+{
+    auto it = directories.find(path);
+    if (it == directories.end())
+        return;
+
+    const auto state = it->second;
+
+    for (const auto& filePath : state.files)
+        forgetFile(filePath, changes);
+    for (const auto& subdirectory : state.subdirectories)
+    {
+        if (std::find(keep.begin(), keep.end(), subdirectory) == keep.end())
+            forgetDirectory(subdirectory, changes, keep);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(catalogueMutex);
+        directories.erase(path);
+    }
+
+    snapshotDirty = true;
+    watchesDirty = true;
+}
+
+void LibraryWatcher::forgetRoot(const juce::File& root, std::vector<Change>& changes)
+{
+    const auto path = root.getFullPathName().toStdString();
+    const auto remaining = getRoots();
+
+    // Watched again since, or still covered by a root above it
+    for (const auto& other : remaining)
+    {
+        if (isBelow(path, juce::File(other)))
+            return;
+    }
+
+    // Roots below this one keep their entries
+    std::vector<std::string> keep;
+    for (const auto& other : remaining)
+    {
+        if (isBelow(other, root))
+            keep.push_back(other);
+    }
+
+    forgetDirectory(path, changes, keep);
+    spdlog::info("[LibraryWatcher] Stopped watching {} ({} changes)", path, changes.size());
+}
+
+void LibraryWatcher::updateFile(const juce::File& file, std::vector<Change>& changes)
+{
+    const auto path = file.getFullPathName().toStdString();
+    const auto lastModified = file.getLastModificationTime().toMilliseconds();
+    const auto size = file.getSize();
+
+    auto existing = files.find(path);
+    if (existing != files.end() && existing->second.lastModified == lastModified && existing->second.size == size)
+        return;
+
+    FileRecord record;
+    record.lastModified = lastModified;
+    record.size = size;
+
+    if (!readFileInfo(file, record))
+    {
+        forgetFile(path, changes);
+        return;
+    }
+
+    const auto type = existing == files.end() ? ChangeType::Added : ChangeType::Modified;
+
+    {
+        std::lock_guard<std::mutex> lock(catalogueMutex);
+        files[path] = record;
+    }
+
+    changes.push_back(makeChange(type, path, record));
+    snapshotDirty = true;
+}
+
+void LibraryWatcher::forgetFile(const std::string& path, std::vector<Change>& changes)
+{
+    auto it = files.find(path);
+    if (it == files.end())
+        return;
+
+    Change change;
+    change.type = ChangeType::Removed;
+    change.kind = it->second.kind;
+    change.filePath = path;
+
+    {
+        std::lock_guard<std::mutex> lock(catalogueMutex);
+        files.erase(it);
+    }
+
+    changes.push_back(std::move(change));
+    snapshotDirty = true;
+}
+
+bool LibraryWatcher::classify(const juce::File& file, EntryKind& kind)
+{
+    if (file.hasFileExtension("nam"))
+    {
+        kind = EntryKind::Model;
+        return true;
+    }
+
+    if (file.hasFileExtension("wav;aiff;aif"))
+    {
+        kind = EntryKind::ImpulseResponse;
+        return true;
+    }
+
+    return false;
+}
+
+bool LibraryWatcher::readFileInfo(const juce::File& file, FileRecord& record)
+{
+    if (!classify(file, record.kind))
+        return false;
+
+    if (record.kind == EntryKind::Model)
+        return NAMCore::getModelInfo(file.getFullPathName().toStdString(), record.model);
+
+    auto& info = record.ir;
+    info.name = file.getFileNameWithoutExtension().toStdString();
+    info.filePath = file.getFullPathName().toStdString();
+    info.fileSize = record.size;
+
+    std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
+    if (reader)
+    {
+        info.sampleRate = reader->sampleRate;
+        info.numChannels = static_cast<int>(reader->numChannels);
+        if (reader->sampleRate > 0)
+            info.durationSeconds = static_cast<double>(reader->lengthInSamples) / reader->sampleRate;
+    }
+    else
+    {
+        // Still listed (as the browsers always did) so the user can see it
+        spdlog::warn("[LibraryWatcher] Failed to read audio file: {}", info.filePath);
+    }
+
+    return true;
+}
+
+LibraryWatcher::Change LibraryWatcher::makeChange(ChangeType type, const std::string& path,
+                                                  const FileRecord& record) const
+{
+    Change change;
+    change.type = type;
+    change.kind = record.kind;
+    change.filePath = path;
+    change.model = record.model;
+    change.ir = record.ir;
+    return change;
+}
+
+//==============================================================================
+// Filesystem Watches
+
+void LibraryWatcher::syncWatches()
+{
+#if JUCE_LINUX
+    if (!watchesDirty || inotifyFd < 0 || usePolling)
+        return;
+
+    watchesDirty = false;
+
+    constexpr uint32_t mask =
+        IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_CLOSE_WRITE | IN_DELETE_SELF | IN_ONLYDIR;
+
+    for (const auto& [path, state] : directories)
+    {
+        if (watchedDirectories.count(path) > 0)
+            continue;
+
+        int wd = inotify_add_watch(inotifyFd, path.c_str(), mask);
+        if (wd < 0)
+        {
+            // Usually fs.inotify.max_user_watches - polling still catches everything
+            spdlog::warn("[LibraryWatcher] inotify_add_watch failed for {} (errno {}), falling back to polling",
+                         path, errno);
+            usePolling = true;
+            return;
+        }
+
+        watchDescriptors[wd] = path;
+        watchedDirectories[path] = wd;
+    }
+
+    for (auto it = watchedDirectories.begin(); it != watchedDirectories.end();)
+    {
+        if (directories.count(it->first) == 0)
+        {
+            inotify_rm_watch(inotifyFd, it->second);
+            watchDescriptors.erase(it->second);
+            it = watchedDirectories.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+#endif
+}
+
+//==============================================================================
+// Snapshot
+
+void LibraryWatcher::loadSnapshot()
+{
+    if (!snapshotFile.existsAsFile())
+        return;
+
+    try
+    {
+        auto json = nlohmann::json::parse(snapshotFile.loadFileAsString().toStdString());
+
+        if (json.value("version", 0) != SNAPSHOT_VERSION)
+        {
+            spdlog::info("[LibraryWatcher] Ignoring snapshot with old version");
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(catalogueMutex);
+
+        roots = json.value("roots", std::vector<std::string>{});
+
+        for (const auto& [path, entry] : json["directories"].items())
+        {
+            DirectoryState state;
+            state.lastModified = entry.value("mtime", int64_t(0));
+            state.files = entry.value("files", std::vector<std::string>{});
+            state.subdirectories = entry.value("subdirs", std::vector<std::string>{});
+            directories[path] = std::move(state);
+        }
+
+        for (const auto& [path, entry] : json["files"].items())
+        {
+            FileRecord record;
+            record.kind = entry.value("kind", "") == "model" ? EntryKind::Model : EntryKind::ImpulseResponse;
+            record.lastModified = entry.value("mtime", int64_t(0));
+            record.size = entry.value("size", int64_t(0));
+
+            if (record.kind == EntryKind::Model)
+            {
+                auto& info = record.model;
+                info.filePath = path;
+                info.name = entry.value("name", "");
+                info.architecture = entry.value("architecture", "");
+                info.expectedSampleRate = entry.value("expectedSampleRate", -1.0);
+                info.hasLoudness = entry.value("hasLoudness", false);
+                info.loudness = entry.value("loudness", 0.0);
+                info.version = entry.value("modelVersion", "");
+                info.metadata = entry.value("metadata", "");
+            }
+            else
+            {
+                auto& info = record.ir;
+                info.filePath = path;
+                info.name = entry.value("name", "");
+                info.fileSize = record.size;
+                info.durationSeconds = entry.value("duration", 0.0);
+                info.sampleRate = entry.value("sampleRate", 0.0);
+                info.numChannels = entry.value("channels", 0);
+            }
+
+            files[path] = std::move(record);
+        }
+
+        // Left behind by a root that was unwatched without the watcher getting to it
+        const auto isUnderRoot = [this](const std::string& path)
+        {
+            return std::any_of(roots.begin(), roots.end(),
+                               [&path](const std::string& root) { return isBelow(path, juce::File(root)); });
+        };
+
+        for (auto it = directories.begin(); it != directories.end();)
+            it = isUnderRoot(it->first) ? std::next(it) : directories.erase(it);
+        for (auto it = files.begin(); it != files.end();)
+            it = isUnderRoot(it->first) ? std::next(it) : files.erase(it);
+
+        spdlog::info("[LibraryWatcher] Loaded snapshot: {} roots, {} directories, {} files", roots.size(),
+                     directories.size(), files.size());
+    }
+    catch (const std::exception& e)
+    {
+        spdlog::warn("[LibraryWatcher] Failed to load snapshot: {}", e.what());
+
+        std::lock_guard<std::mutex> lock(catalogueMutex);
+        roots.clear();
+        directories.clear();
+        files.clear();
+    }
+}
+
+void LibraryWatcher::saveSnapshot()
+{
+    nlohmann::json json;
+    json["version"] = SNAPSHOT_VERSION;
+
+    {
+        std::lock_guard<std::mutex> lock(catalogueMutex);
+
+        json["roots"] = roots;
+
+        auto& directoriesJson = json["directories"];
+        directoriesJson = nlohmann::json::object();
+        for (const auto& [path, state] : directories)
+        {
+            directoriesJson[path] = {
+                {"mtime", state.lastModified}, {"files", state.files}, {"subdirs", state.subdirectories}};
+        }
+
+        auto& filesJson = json["files"];
+        filesJson = nlohmann::json::object();
+        for (const auto& [path, record] : files)
+        {
+            nlohmann::json entry = {
+                {"kind", kindToString(record.kind)}, {"mtime", record.lastModified}, {"size", record.size}};
+
+            if (record.kind == EntryKind::Model)
+            {
+                entry["name"] = record.model.name;
+                entry["architecture"] = record.model.architecture;
+                entry["expectedSampleRate"] = record.model.expectedSampleRate;
+                entry["hasLoudness"] = record.model.hasLoudness;
+                entry["loudness"] = record.model.loudness;
+                entry["modelVersion"] = record.model.version;
+                entry["metadata"] = record.model.metadata;
+            }
+            else
+            {
+                entry["name"] = record.ir.name;
+                entry["duration"] = record.ir.durationSeconds;
+                entry["sampleRate"] = record.ir.sampleRate;
+                entry["channels"] = record.ir.numChannels;
+            }
+
+            filesJson[path] = std::move(entry);
+        }
+    }
+
+    snapshotFile.getParentDirectory().createDirectory();
+
+    if (!snapshotFile.replaceWithText(juce::String(json.dump())))
+        spdlog::warn("[LibraryWatcher] Failed to write snapshot: {}", snapshotFile.getFullPathName().toStdString());
+
+    snapshotDirty = false;
+    lastSnapshotTime = juce::Time::getMillisecondCounter();
+}
@@ -0,0 +1,244 @@
+/*
+  ==============================================================================
+
+    LibraryWatcher.h
+    Background catalogue of NAM models and IR files with filesystem watching
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "NAMCore.h"
+
+#include <JuceHeader.h>
+
+#include <atomic>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+//==============================================================================
+/**
+    Info structure for IR files (impulse responses).
+*/
+struct IRFileInfo
+{
+    std::string name;
+    std::string filePath;
+    int64_t fileSize = 0;
+    double durationSeconds = 0.0;
+    double sampleRate = 0.0;
+    int numChannels = 0;
+};
+
+//==============================================================================
+/**
+    Maintains an in-memory catalogue of NAM models (.nam) and impulse responses
+    (.wav/.aiff/.aif) below a set of watched root directories.
+
+    The catalogue is built on a background thread and kept current with inotify
+    on Linux (elsewhere a cheap directory-mtime poll is used). Listeners receive
+    add/remove/modify deltas on the message thread instead of re-walking the
+    tree. The catalogue is persisted to LibraryCatalogue.json so that startup
+    only re-lists directories whose modification time has changed.
+
+    The poll only looks inside directories whose mtime changed, so a file
+    rewritten in place (which doesn't touch its directory) is picked up at the
+    next rescan or startup rather than within POLL_INTERVAL_MS.
+*/
+class LibraryWatcher : public juce::Thread
+{
+  public:
+    enum class EntryKind
+    {
+        Model,
+        ImpulseResponse
+    };
+
+    enum class ChangeType
+    {
+        Added,
+        Removed,
+        Modified
+    };
+
+    /// A single catalogue delta. Only the info matching `kind` is valid, and
+    /// neither is valid for removals.
+    struct Change
+    {
+        ChangeType type = ChangeType::Added;
+        EntryKind kind = EntryKind::Model;
+        std::string filePath;
+        NAMModelInfo model;
+        IRFileInfo ir;
+    };
+
+    //==========================================================================
+    // Listener Interface
+
+    class Listener
+    {
+      public:
+        virtual ~Listener() = default;
+
+        /// Called on the message thread with a batch of catalogue deltas
+        virtual void libraryChanged(const std::vector<Change>& changes) = 0;
+
+        /// Called on the message thread when a requested (re)scan of a root completes
+        virtual void libraryScanFinished(const juce::File& root) {}
+    };
+
+    //==========================================================================
+    // Singleton Access
+
+    static LibraryWatcher& getInstance();
+
+    /// The shared instance, or nullptr if nothing has used it yet
+    static LibraryWatcher* getInstanceWithoutCreating();
+
+    /// A watcher of its own, persisting to snapshotFile. Public for tests;
+    /// the app uses getInstance().
+    explicit LibraryWatcher(const juce::File& snapshotFile);
+    ~LibraryWatcher() override;
+
+    /// Stops the watcher thread and saves the catalogue. Call once at exit,
+    /// while the MessageManager still exists.
+    void shutdown();
+
+    //==========================================================================
+    // Roots
+
+    /// Adds a root directory to the catalogue. Returns immediately; the root is
+    /// reconciled on the watcher thread and listeners are sent the deltas.
+    void watchDirectory(const juce::File& root);
+
+    /// Stops watching a root and drops its entries from the catalogue (and the
+    /// snapshot). Anything still covered by another root is kept.
+    void unwatchDirectory(const juce::File& root);
+
+    /// Forces every directory below root to be re-listed (the Refresh button).
+    void rescan(const juce::File& root);
+
+    /// True while the watcher thread is reconciling a root.
+    bool isScanning() const { return scanning.load(std::memory_order_acquire); }
+
+    //==========================================================================
+    // Catalogue Queries (any thread)
+
+    /// All NAM models at or below root
+    std::vector<NAMModelInfo> getModels(const juce::File& root) const;
+
+    /// All impulse responses at or below root
+    std::vector<IRFileInfo> getImpulseResponses(const juce::File& root) const;
+
+    /// True if the entry's path is at or below root
+    static bool isBelow(const std::string& filePath, const juce::File& root);
+
+    //==========================================================================
+    // Listeners
+
+    void addListener(Listener* listener);
+    void removeListener(Listener* listener);
+
+  private:
+    void run() override;
+
+    struct DirectoryState
+    {
+        int64_t lastModified = 0;
+        std::vector<std::string> files;
+        std::vector<std::string> subdirectories;
+    };
+
+    struct FileRecord
+    {
+        EntryKind kind = EntryKind::Model;
+        int64_t lastModified = 0;
+        int64_t size = 0;
+        NAMModelInfo model;
+        IRFileInfo ir;
+    };
+
+    struct Request
+    {
+        juce::File root;
+        bool force = false;
+        bool forget = false;
+    };
+
+    /// Re-lists directory if its mtime changed (or force) and recurses into
+    /// subdirectories. Files are stat'd in re-listed directories, and in every
+    /// directory if statFiles is set. Must be called on the watcher thread.
+    void reconcileDirectory(const juce::File& directory, bool force, std::vector<Change>& changes,
+                            bool statFiles = true, int depth = 0);
+
+    /// Drops a directory and everything below it from the catalogue, except
+    /// the subdirectories in keep (and everything below those)
+    void forgetDirectory(const std::string& path, std::vector<Change>& changes,
+                         const std::vector<std::string>& keep = {});
+
+    /// Drops an unwatched root, unless it's still at or below another root
+    void forgetRoot(const juce::File& root, std::vector<Change>& changes);
+
+    /// Reads metadata for a file and updates the catalogue if it is new or changed
+    void updateFile(const juce::File& file, std::vector<Change>& changes);
+    void forgetFile(const std::string& path, std::vector<Change>& changes);
+
+    static bool classify(const juce::File& file, EntryKind& kind);
+    bool readFileInfo(const juce::File& file, FileRecord& record);
+    Change makeChange(ChangeType type, const std::string& path, const FileRecord& record) const;
+
+    void publish(std::vector<Change> changes);
+    void publishScanFinished(const juce::File& root);
+
+    void loadSnapshot();
+    void saveSnapshot();
+
+    void queueRequest(const juce::File& root, bool force);
+    std::vector<std::string> getRoots() const;
+
+    /// Adds/removes inotify watches so every catalogued directory is watched
+    void syncWatches();
+    /// Blocks until filesystem events arrive (or the poll interval elapses) and
+    /// reconciles the affected directories
+    void processFilesystemEvents();
+
+    //==========================================================================
+    // Members
+
+    const juce::File snapshotFile;
+
+    std::vector<std::string> roots;
+    std::map<std::string, DirectoryState> directories;
+    std::map<std::string, FileRecord> files;
+    mutable std::mutex catalogueMutex;
+
+    std::deque<Request> pendingRequests;
+    std::mutex requestMutex;
+
+    std::atomic<bool> scanning{false};
+    std::atomic<bool> snapshotDirty{false};
+    bool watchesDirty = true;
+    juce::uint32 lastSnapshotTime = 0;
+
+    juce::AudioFormatManager formatManager;
+    juce::ListenerList<Listener> listeners;
+
+#if JUCE_LINUX
+    int inotifyFd = -1;
+    std::map<int, std::string> watchDescriptors;
+    std::map<std::string, int> watchedDirectories;
+    bool usePolling = false;
+#endif
+
+    // Configuration
+    static constexpr int POLL_INTERVAL_MS = 2000;
+    static constexpr int SNAPSHOT_SAVE_INTERVAL_MS = 5000;
+    static constexpr int SNAPSHOT_VERSION = 1;
+
+    JUCE_DECLARE_WEAK_REFERENCEABLE(LibraryWatcher)
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LibraryWatcher)
+};
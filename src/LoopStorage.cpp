@@ -0,0 +1,827 @@
+/*
+  ==============================================================================
+
+    LoopStorage.cpp
+    Looper audio storage: a RAM window over a memory-mapped scratch file
+
+  ==============================================================================
+*/
+
+#include "LoopStorage.h"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+
+namespace
+{
+// Head, current and lookahead chunks
+constexpr int windowChunks = LoopStorage::headChunks + 1 + LoopStorage::lookaheadChunks;
+// Windows of the playing, undo and redo versions, the overdub layer's
+// current and lookahead chunks, plus room for chunks waiting to be flushed
+constexpr int numSlots = 3 * windowChunks + 1 + LoopStorage::lookaheadChunks + 3;
+constexpr int zeroBlockBytes = 64 * 1024;
+constexpr int segmentIdlePasses = 40; // service() calls before an unused segment is unmapped
+} // namespace
+
+//==============================================================================
+LoopStorage::Version::Version(size_t numChunks)
+    : chunks(numChunks), delta(numChunks), pending(numChunks), mixed(numChunks, -1)
+{
+    for (size_t i = 0; i < numChunks; ++i)
+    {
+        chunks[i].store(static_cast<juce::int64>(i), std::memory_order_relaxed);
+        delta[i].store(-1, std::memory_order_relaxed);
+        pending[i].store(false, std::memory_order_relaxed);
+    }
+}
+
+//==============================================================================
+LoopStorage::LoopStorage() = default;
+
+LoopStorage::~LoopStorage()
+{
+    const juce::ScopedLock sl(lock);
+    deleteScratch();
+}
+
+//==============================================================================
+void LoopStorage::prepare(double newSampleRate)
+{
+    const juce::ScopedLock sl(lock);
+
+    const int newChunkSize = juce::jmax(1, juce::roundToInt(newSampleRate * chunkSeconds));
+    if (newChunkSize == chunkSize && !slots.empty())
+    {
+        sampleRate = newSampleRate;
+        resetLocked();
+        return;
+    }
+
+    // The scratch file layout depends on the chunk size
+    deleteScratch();
+
+    sampleRate = newSampleRate;
+    chunkSize = newChunkSize;
+    segmentChunks = juce::jmax(1, juce::roundToInt(segmentSeconds / chunkSeconds));
+
+    slots.clear();
+    for (int i = 0; i < numSlots; ++i)
+    {
+        auto slot = std::make_unique<Slot>();
+        slot->audio.setSize(numChannels, chunkSize);
+        slots.push_back(std::move(slot));
+    }
+    mixBuffer.setSize(numChannels, chunkSize);
+    resetLocked();
+
+    spdlog::info("[LoopStorage] {} s chunks at {} Hz, {} KB resident", chunkSeconds, sampleRate,
+                 getResidentBytes() / 1024);
+}
+
+void LoopStorage::reset()
+{
+    const juce::ScopedLock sl(lock);
+    resetLocked();
+}
+
+void LoopStorage::resetLocked()
+{
+    playingVersion.store(nullptr, std::memory_order_release);
+    overdubVersion.store(nullptr, std::memory_order_release);
+    {
+        const juce::SpinLock::ScopedLockType versionsLocked(versionLock);
+        oldestVersion = 0;
+        newestVersion = -1;
+        currentVersion = -1;
+    }
+    for (auto& version : versions)
+        version.reset();
+    retired.clear();
+    firstLayerChunk = std::numeric_limits<juce::int64>::max();
+    nextChunk = 0;
+
+    // Start with the head of an empty loop resident, so recording can begin
+    // before the background thread has run
+    for (size_t i = 0; i < slots.size(); ++i)
+    {
+        auto& slot = *slots[i];
+        const bool ready = i < static_cast<size_t>(windowChunks);
+
+        slot.chunk.store(-1, std::memory_order_release);
+        slot.dirty.store(false, std::memory_order_relaxed);
+        if (ready)
+        {
+            slot.audio.clear();
+            slot.chunk.store(static_cast<juce::int64>(i), std::memory_order_release);
+        }
+    }
+    underruns.store(0, std::memory_order_relaxed);
+}
+
+//==============================================================================
+bool LoopStorage::beginOverdub(juce::int64 position, juce::int64 length)
+{
+    const juce::ScopedLock sl(lock);
+
+    const juce::int64 numChunks = chunkSize > 0 ? (length + chunkSize - 1) / chunkSize : 0;
+    if (slots.empty() || numChunks == 0 || isOverdubbing())
+        return false;
+
+    // The first overdub turns the recorded take into version 0
+    if (currentVersion < 0)
+    {
+        versions[0] = std::make_unique<Version>(static_cast<size_t>(numChunks));
+        firstLayerChunk = nextChunk = numChunks;
+
+        const juce::SpinLock::ScopedLockType versionsLocked(versionLock);
+        oldestVersion = newestVersion = currentVersion = 0;
+        playingVersion.store(versions[0].get(), std::memory_order_release);
+    }
+
+    Version& base = *getVersion(currentVersion);
+    if (base.chunks.size() != static_cast<size_t>(numChunks))
+        return false;
+
+    // Record over the base's final mix
+    mixPending(base, -1, length);
+    retired.clear();
+
+    int number;
+    {
+        const juce::SpinLock::ScopedLockType versionsLocked(versionLock);
+
+        // Drops the redo history, and the oldest layer once we're at the limit
+        newestVersion = currentVersion;
+        number = currentVersion + 1;
+        if (number - oldestVersion >= maxVersions)
+            ++oldestVersion;
+    }
+
+    auto layer = std::make_unique<Version>(static_cast<size_t>(numChunks));
+    layer->previous = number - 1;
+    for (size_t i = 0; i < layer->chunks.size(); ++i)
+        layer->chunks[i].store(base.chunks[i].load(std::memory_order_acquire), std::memory_order_relaxed);
+
+    // The version this replaces can't be reached any more, but the audio
+    // thread may still be reading it; keep it until the next overdub
+    Version* opened = layer.get();
+    auto& entry = versions[static_cast<size_t>(number % maxVersions)];
+    if (entry != nullptr)
+        retired.push_back(std::move(entry));
+    entry = std::move(layer);
+
+    {
+        const juce::SpinLock::ScopedLockType versionsLocked(versionLock);
+        newestVersion = currentVersion = number;
+        playingVersion.store(opened, std::memory_order_release);
+    }
+    overdubVersion.store(opened, std::memory_order_release);
+
+    // Have the layer's first delta chunks ready before the audio thread needs them
+    serviceLocked(position, length, false);
+
+    spdlog::info("[LoopStorage] Overdub layer {} opened", number);
+    return true;
+}
+
+void LoopStorage::endOverdub()
+{
+    overdubVersion.store(nullptr, std::memory_order_release);
+}
+
+bool LoopStorage::undoLayer()
+{
+    const juce::SpinLock::ScopedLockType versionsLocked(versionLock);
+
+    if (currentVersion <= oldestVersion)
+        return false;
+
+    --currentVersion;
+    playingVersion.store(getVersion(currentVersion), std::memory_order_release);
+    return true;
+}
+
+bool LoopStorage::redoLayer()
+{
+    const juce::SpinLock::ScopedLockType versionsLocked(versionLock);
+
+    if (currentVersion >= newestVersion)
+        return false;
+
+    ++currentVersion;
+    playingVersion.store(getVersion(currentVersion), std::memory_order_release);
+    return true;
+}
+
+bool LoopStorage::canUndoLayer() const
+{
+    const juce::SpinLock::ScopedLockType versionsLocked(versionLock);
+    return currentVersion > oldestVersion;
+}
+
+bool LoopStorage::canRedoLayer() const
+{
+    const juce::SpinLock::ScopedLockType versionsLocked(versionLock);
+    return currentVersion < newestVersion;
+}
+
+int LoopStorage::getNumLayers() const
+{
+    const juce::SpinLock::ScopedLockType versionsLocked(versionLock);
+    return juce::jmax(0, currentVersion);
+}
+
+//==============================================================================
+LoopStorage::Slot* LoopStorage::findSlot(juce::int64 chunk) const
+{
+    for (auto& slot : slots)
+        if (slot->chunk.load(std::memory_order_acquire) == chunk)
+            return slot.get();
+    return nullptr;
+}
+
+int LoopStorage::write(const juce::AudioBuffer<float>& source, int sourceStart, juce::int64 position, int numSamples)
+{
+    const int sourceChannels = source.getNumChannels();
+    int written = 0;
+
+    while (written < numSamples && chunkSize > 0)
+    {
+        const juce::int64 samplePosition = position + written;
+        Slot* slot = findSlot(samplePosition / chunkSize);
+        if (slot == nullptr)
+        {
+            underruns.fetch_add(1, std::memory_order_relaxed);
+            break;
+        }
+
+        const int offset = static_cast<int>(samplePosition % chunkSize);
+        const int count = juce::jmin(numSamples - written, chunkSize - offset);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            slot->audio.copyFrom(channel, offset, source, juce::jmin(channel, sourceChannels - 1),
+                                 sourceStart + written, count);
+        slot->dirty.store(true, std::memory_order_release);
+
+        written += count;
+    }
+
+    return written;
+}
+
+bool LoopStorage::overdub(const juce::AudioBuffer<float>& source, int sourceStart, juce::int64 position,
+                          int numSamples)
+{
+    Version* layer = overdubVersion.load(std::memory_order_acquire);
+    if (layer == nullptr)
+        return true;
+
+    const int sourceChannels = source.getNumChannels();
+    int done = 0;
+
+    while (done < numSamples && chunkSize > 0)
+    {
+        const juce::int64 samplePosition = position + done;
+        const auto chunk = static_cast<size_t>(samplePosition / chunkSize);
+        Slot* slot = chunk < layer->delta.size() ? findSlot(layer->delta[chunk].load(std::memory_order_acquire))
+                                                 : nullptr;
+        if (slot == nullptr)
+        {
+            underruns.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        const int offset = static_cast<int>(samplePosition % chunkSize);
+        const int count = juce::jmin(numSamples - done, chunkSize - offset);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            slot->audio.addFrom(channel, offset, source, juce::jmin(channel, sourceChannels - 1), sourceStart + done,
+                                count);
+        slot->dirty.store(true, std::memory_order_release);
+        layer->pending[chunk].store(true, std::memory_order_release);
+        layer->anyPending.store(true, std::memory_order_release);
+
+        done += count;
+    }
+
+    return true;
+}
+
+int LoopStorage::addTo(juce::AudioBuffer<float>& dest, int destStart, juce::int64 position, int numSamples,
+                       float startGain, float endGain)
+{
+    const Version* version = playingVersion.load(std::memory_order_acquire);
+    const int destChannels = juce::jmin(numChannels, dest.getNumChannels());
+    int done = 0, resident = 0;
+    bool missed = false;
+
+    while (done < numSamples && chunkSize > 0)
+    {
+        const juce::int64 samplePosition = position + done;
+        const int offset = static_cast<int>(samplePosition % chunkSize);
+        const int count = juce::jmin(numSamples - done, chunkSize - offset);
+
+        juce::int64 chunk = samplePosition / chunkSize;
+        if (version != nullptr)
+            chunk = static_cast<size_t>(chunk) < version->chunks.size()
+                        ? version->chunks[static_cast<size_t>(chunk)].load(std::memory_order_acquire)
+                        : -1;
+
+        if (const Slot* slot = chunk >= 0 ? findSlot(chunk) : nullptr)
+        {
+            const float gainFrom = startGain + (endGain - startGain) * static_cast<float>(done) / numSamples;
+            const float gainTo = startGain + (endGain - startGain) * static_cast<float>(done + count) / numSamples;
+
+            for (int channel = 0; channel < destChannels; ++channel)
+            {
+                if (gainFrom == gainTo)
+                    dest.addFrom(channel, destStart + done, slot->audio, channel, offset, count, gainFrom);
+                else
+                    dest.addFromWithRamp(channel, destStart + done, slot->audio.getReadPointer(channel, offset), count,
+                                         gainFrom, gainTo);
+            }
+            resident += count;
+        }
+        else
+            missed = true;
+
+        done += count;
+    }
+
+    if (missed)
+        underruns.fetch_add(1, std::memory_order_relaxed);
+
+    return resident;
+}
+
+//==============================================================================
+bool LoopStorage::service(juce::int64 position, juce::int64 length, bool recording)
+{
+    const juce::ScopedLock sl(lock);
+    return serviceLocked(position, length, recording);
+}
+
+bool LoopStorage::serviceLocked(juce::int64 position, juce::int64 length, bool recording)
+{
+    if (slots.empty())
+        return false;
+
+    ++servicePass;
+
+    const juce::int64 current = juce::jmax<juce::int64>(0, position) / chunkSize;
+    const juce::int64 numChunks = (length + chunkSize - 1) / chunkSize;
+
+    Version* playing = playingVersion.load(std::memory_order_acquire);
+    Version* layer = overdubVersion.load(std::memory_order_acquire);
+    const Version *undoTarget = nullptr, *redoTarget = nullptr;
+    int oldest, newest;
+    {
+        const juce::SpinLock::ScopedLockType versionsLocked(versionLock);
+        oldest = oldestVersion;
+        newest = newestVersion;
+        if (currentVersion > oldestVersion)
+            undoTarget = getVersion(currentVersion - 1);
+        if (currentVersion < newestVersion)
+            redoTarget = getVersion(currentVersion + 1);
+    }
+
+    // Keep a segment of scratch file ready ahead of the record head and the
+    // open layer's allocations, so a flush never waits on the file growing.
+    // It grows a chunk per call; come back soon while it's short.
+    bool pending = false;
+    juce::int64 scratchWanted = 0;
+    if (recording)
+        scratchWanted = current + lookaheadChunks + segmentChunks;
+    if (layer != nullptr)
+        scratchWanted = juce::jmax(scratchWanted, nextChunk + segmentChunks);
+    if (scratchWanted > 0 && !ensureScratch(scratchWanted))
+        pending = true;
+
+    // Flush recorded chunks, apart from the overdub chunk under the head.
+    // The dirty flag is cleared before copying, so a chunk the audio thread
+    // writes to meanwhile gets flushed again later.
+    const juce::int64 overdubChunk = (layer != nullptr && current < numChunks)
+                                         ? layer->delta[static_cast<size_t>(current)].load(std::memory_order_acquire)
+                                         : -1;
+    for (auto& slot : slots)
+    {
+        const juce::int64 chunk = slot->chunk.load(std::memory_order_acquire);
+        if (chunk < 0 || chunk == overdubChunk || (recording && (chunk + 1) * chunkSize > length))
+            continue;
+
+        if (slot->dirty.exchange(false, std::memory_order_acquire) && !flush(*slot, chunk, length))
+            slot->dirty.store(true, std::memory_order_relaxed);
+    }
+
+    // Mix overdubs down, oldest layer first. The open layer's chunk under
+    // the head is left until the head moves on (unless it's the whole loop).
+    for (int number = oldest; number <= newest; ++number)
+    {
+        Version* version = getVersion(number);
+        const juce::int64 skip = (version == layer && numChunks > 1) ? current : -1;
+        if (version != nullptr && !mixPending(*version, skip, length))
+            pending = true;
+    }
+
+    // Loop chunks around the playhead, most urgent first
+    std::vector<juce::int64> window, head;
+    for (int i = 0; i <= lookaheadChunks; ++i)
+    {
+        if (recording)
+            window.push_back(current + i);
+        else if (numChunks > 0)
+            window.push_back((current + i) % numChunks);
+    }
+    for (int i = 0; i < headChunks; ++i)
+        if (recording || i < numChunks)
+            head.push_back(i);
+
+    // Physical chunks that should be resident, most urgent first
+    std::vector<juce::int64> wanted;
+    auto want = [&wanted](juce::int64 chunk)
+    {
+        if (chunk >= 0 && wanted.size() < static_cast<size_t>(numSlots) &&
+            std::find(wanted.begin(), wanted.end(), chunk) == wanted.end())
+            wanted.push_back(chunk);
+    };
+    auto wantAll = [&want](const Version* version, const std::vector<juce::int64>& chunks)
+    {
+        for (const auto chunk : chunks)
+        {
+            if (version == nullptr)
+                want(chunk);
+            else if (static_cast<size_t>(chunk) < version->chunks.size())
+                want(version->chunks[static_cast<size_t>(chunk)].load(std::memory_order_acquire));
+        }
+    };
+
+    wantAll(playing, window);
+
+    // Give the open layer cleared delta chunks ahead of its head
+    if (layer != nullptr)
+    {
+        for (const auto chunk : window)
+        {
+            if (static_cast<size_t>(chunk) >= layer->delta.size())
+                continue;
+
+            auto& delta = layer->delta[static_cast<size_t>(chunk)];
+            if (delta.load(std::memory_order_acquire) < 0)
+            {
+                Slot* victim = findVictim(wanted);
+                const juce::int64 fresh = victim != nullptr ? allocateChunk() : -1;
+                if (fresh < 0)
+                {
+                    pending = true;
+                    break;
+                }
+
+                victim->chunk.store(-1, std::memory_order_release);
+                victim->audio.clear();
+                victim->dirty.store(true, std::memory_order_relaxed); // Not in the scratch file yet
+                victim->chunk.store(fresh, std::memory_order_release);
+                delta.store(fresh, std::memory_order_release);
+            }
+            want(delta.load(std::memory_order_acquire));
+        }
+    }
+
+    // Keep the undo/redo targets warm too, so switching never drops out
+    wantAll(playing, head);
+    wantAll(undoTarget, window);
+    wantAll(redoTarget, window);
+    wantAll(undoTarget, head);
+    wantAll(redoTarget, head);
+
+    for (const auto chunk : wanted)
+    {
+        if (findSlot(chunk) != nullptr)
+            continue;
+
+        // Every slot holds a wanted or unflushed chunk
+        Slot* victim = findVictim(wanted);
+        if (victim == nullptr)
+        {
+            pending = true;
+            break;
+        }
+
+        victim->chunk.store(-1, std::memory_order_release);
+        fill(*victim, chunk, length);
+        victim->chunk.store(chunk, std::memory_order_release);
+    }
+
+    unmapIdleSegments();
+
+    return pending;
+}
+
+LoopStorage::Slot* LoopStorage::findVictim(const std::vector<juce::int64>& wanted) const
+{
+    for (auto& slot : slots)
+    {
+        const juce::int64 held = slot->chunk.load(std::memory_order_acquire);
+        if (!slot->dirty.load(std::memory_order_acquire) &&
+            (held < 0 || std::find(wanted.begin(), wanted.end(), held) == wanted.end()))
+            return slot.get();
+    }
+    return nullptr;
+}
+
+bool LoopStorage::reserve(juce::int64 numSamples)
+{
+    const juce::ScopedLock sl(lock);
+    return chunkSize > 0 && ensureScratch((numSamples + chunkSize - 1) / chunkSize);
+}
+
+bool LoopStorage::import(const juce::AudioBuffer<float>& source, int numSamples, juce::int64 position)
+{
+    const juce::ScopedLock sl(lock);
+
+    if (chunkSize <= 0 || numSamples <= 0)
+        return numSamples <= 0;
+
+    if (!ensureScratch((position + numSamples + chunkSize - 1) / chunkSize))
+        return false;
+
+    const int sourceChannels = source.getNumChannels();
+    int done = 0;
+
+    while (done < numSamples)
+    {
+        const juce::int64 samplePosition = position + done;
+        const juce::int64 chunk = samplePosition / chunkSize;
+        const int offset = static_cast<int>(samplePosition % chunkSize);
+        const int count = juce::jmin(numSamples - done, chunkSize - offset);
+
+        float* scratch = getScratchChunk(chunk);
+        if (scratch == nullptr)
+            return false;
+
+        Slot* slot = findSlot(chunk);
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            const float* from = source.getReadPointer(juce::jmin(channel, sourceChannels - 1), done);
+            juce::FloatVectorOperations::copy(scratch + channel * chunkSize + offset, from, count);
+            if (slot != nullptr)
+                slot->audio.copyFrom(channel, offset, from, count);
+        }
+
+        done += count;
+    }
+
+    return true;
+}
+
+//==============================================================================
+bool LoopStorage::mixPending(Version& version, juce::int64 skipChunk, juce::int64 length)
+{
+    if (!version.anyPending.exchange(false, std::memory_order_acquire))
+        return true;
+
+    bool complete = true;
+    for (size_t i = 0; i < version.pending.size(); ++i)
+    {
+        const auto chunk = static_cast<juce::int64>(i);
+        if (chunk == skipChunk)
+        {
+            complete = complete && !version.pending[i].load(std::memory_order_acquire);
+            continue;
+        }
+
+        if (version.pending[i].exchange(false, std::memory_order_acquire) && !mixChunk(version, chunk, length))
+        {
+            version.pending[i].store(true, std::memory_order_relaxed);
+            complete = false;
+        }
+    }
+
+    if (!complete)
+        version.anyPending.store(true, std::memory_order_release);
+    return complete;
+}
+
+bool LoopStorage::mixChunk(Version& version, juce::int64 chunk, juce::int64 length)
+{
+    const auto index = static_cast<size_t>(chunk);
+    const juce::int64 delta = version.delta[index].load(std::memory_order_acquire);
+    const Version* previous = version.previous >= oldestVersion ? getVersion(version.previous) : nullptr;
+    if (delta < 0 || previous == nullptr)
+        return true;
+
+    // Each layer gets its own mix chunk the first time; later passes over
+    // the same chunk rewrite it in place
+    if (version.mixed[index] < 0)
+        version.mixed[index] = allocateChunk();
+    float* scratch = getScratchChunk(version.mixed[index]);
+    if (scratch == nullptr)
+        return false;
+
+    readChunk(previous->chunks[index].load(std::memory_order_acquire), length, mixBuffer, false);
+    readChunk(delta, length, mixBuffer, true);
+
+    Slot* slot = findSlot(version.mixed[index]);
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        juce::FloatVectorOperations::copy(scratch + channel * chunkSize, mixBuffer.getReadPointer(channel), chunkSize);
+        if (slot != nullptr)
+            slot->audio.copyFrom(channel, 0, mixBuffer, channel, 0, chunkSize);
+    }
+
+    version.chunks[index].store(version.mixed[index], std::memory_order_release);
+    return true;
+}
+
+juce::int64 LoopStorage::allocateChunk()
+{
+    if (!ensureScratch(nextChunk + 1))
+        return -1;
+    return nextChunk++;
+}
+
+//==============================================================================
+int LoopStorage::getStoredSamples(juce::int64 chunk, juce::int64 length) const
+{
+    // Layer chunks are always whole. Past the end of the recorded take is
+    // fresh space for recording.
+    if (chunk >= firstLayerChunk)
+        return chunkSize;
+    return static_cast<int>(juce::jlimit<juce::int64>(0, chunkSize, length - chunk * chunkSize));
+}
+
+bool LoopStorage::flush(Slot& slot, juce::int64 chunk, juce::int64 length)
+{
+    float* scratch = getScratchChunk(chunk);
+    if (scratch == nullptr)
+        return false;
+
+    const int count = getStoredSamples(chunk, length);
+    for (int channel = 0; channel < numChannels; ++channel)
+        juce::FloatVectorOperations::copy(scratch + channel * chunkSize, slot.audio.getReadPointer(channel), count);
+
+    return true;
+}
+
+void LoopStorage::fill(Slot& slot, juce::int64 chunk, juce::int64 length)
+{
+    const int stored = getStoredSamples(chunk, length);
+    const float* scratch = stored > 0 ? getScratchChunk(chunk) : nullptr;
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        if (scratch != nullptr)
+        {
+            slot.audio.copyFrom(channel, 0, scratch + channel * chunkSize, stored);
+            slot.audio.clear(channel, stored, chunkSize - stored);
+        }
+        else
+            slot.audio.clear(channel, 0, chunkSize);
+    }
+}
+
+void LoopStorage::readChunk(juce::int64 chunk, juce::int64 length, juce::AudioBuffer<float>& into, bool add)
+{
+    // A resident copy may hold audio that hasn't been flushed yet
+    const Slot* slot = findSlot(chunk);
+    const float* scratch = slot == nullptr ? getScratchChunk(chunk) : nullptr;
+    const int count = slot != nullptr ? chunkSize : (scratch != nullptr ? getStoredSamples(chunk, length) : 0);
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        const float* from = slot != nullptr ? slot->audio.getReadPointer(channel)
+                                            : (scratch != nullptr ? scratch + channel * chunkSize : nullptr);
+
+        if (add)
+        {
+            if (count > 0)
+                into.addFrom(channel, 0, from, count);
+        }
+        else
+        {
+            if (count > 0)
+                into.copyFrom(channel, 0, from, count);
+            into.clear(channel, count, chunkSize - count);
+        }
+    }
+}
+
+//==============================================================================
+bool LoopStorage::ensureScratch(juce::int64 numChunks)
+{
+    if (numChunks <= scratchChunks)
+        return true;
+
+    if (scratchFile == juce::File())
+    {
+        scratchFile = juce::File::getSpecialLocation(juce::File::tempDirectory)
+                          .getNonexistentChildFile("Pedalboard3Loop", ".tmp", false);
+        if (!scratchFile.create())
+        {
+            spdlog::error("[LoopStorage] Could not create scratch file {}",
+                          scratchFile.getFullPathName().toStdString());
+            scratchFile = juce::File();
+            return false;
+        }
+    }
+
+    // Write real zeros rather than seeking past the end, so the space is
+    // actually allocated now instead of when a page is first touched. Only a
+    // chunk's worth per call: a whole segment is tens of MB, and this runs on
+    // the disk thread the file players read ahead on.
+    const auto chunkBytes = static_cast<juce::int64>(getChunkBytes());
+    const juce::int64 segmentBytes = chunkBytes * segmentChunks;
+    const juce::HeapBlock<char> zeros(zeroBlockBytes, true);
+
+    juce::FileOutputStream out(scratchFile);
+    if (out.failedToOpen())
+        return false;
+
+    // The file ends part way through the segment being grown
+    const juce::int64 grown = out.getPosition() - scratchChunks * chunkBytes;
+    const juce::int64 step = juce::jmin(chunkBytes, segmentBytes - grown);
+
+    for (juce::int64 remaining = step; remaining > 0; remaining -= zeroBlockBytes)
+    {
+        if (!out.write(zeros.getData(), static_cast<size_t>(juce::jmin<juce::int64>(remaining, zeroBlockBytes))))
+        {
+            spdlog::error("[LoopStorage] Could not grow scratch file: {}",
+                          out.getStatus().getErrorMessage().toStdString());
+            return false;
+        }
+    }
+
+    out.flush();
+    if (!out.getStatus().wasOk())
+        return false;
+
+    if (grown + step >= segmentBytes)
+        scratchChunks += segmentChunks;
+
+    return numChunks <= scratchChunks;
+}
+
+float* LoopStorage::getScratchChunk(juce::int64 chunk)
+{
+    if (chunk < 0 || chunk >= scratchChunks)
+        return nullptr;
+
+    const auto segment = static_cast<size_t>(chunk / segmentChunks);
+    if (segments.size() <= segment)
+    {
+        segments.resize(segment + 1);
+        segmentLastUse.resize(segment + 1, 0);
+    }
+
+    if (segments[segment] == nullptr)
+    {
+        const juce::int64 segmentBytes = static_cast<juce::int64>(getChunkBytes()) * segmentChunks;
+        const juce::int64 start = static_cast<juce::int64>(segment) * segmentBytes;
+
+        auto mapped = std::make_unique<juce::MemoryMappedFile>(
+            scratchFile, juce::Range<juce::int64>(start, start + segmentBytes), juce::MemoryMappedFile::readWrite);
+        if (mapped->getData() == nullptr || static_cast<juce::int64>(mapped->getSize()) < segmentBytes)
+        {
+            spdlog::error("[LoopStorage] Could not map scratch segment {}", segment);
+            return nullptr;
+        }
+        segments[segment] = std::move(mapped);
+    }
+    segmentLastUse[segment] = servicePass;
+
+    auto* base = static_cast<char*>(segments[segment]->getData());
+    return reinterpret_cast<float*>(base + static_cast<size_t>(chunk % segmentChunks) * getChunkBytes());
+}
+
+void LoopStorage::unmapIdleSegments()
+{
+    // The head segment stays mapped for wrap-around
+    for (size_t i = 1; i < segments.size(); ++i)
+        if (segments[i] != nullptr && servicePass - segmentLastUse[i] > segmentIdlePasses)
+            segments[i].reset();
+}
+
+void LoopStorage::deleteScratch()
+{
+    segments.clear();
+    segmentLastUse.clear();
+    scratchChunks = 0;
+
+    if (scratchFile != juce::File())
+    {
+        scratchFile.deleteFile();
+        scratchFile = juce::File();
+    }
+}
+
+//==============================================================================
+size_t LoopStorage::getResidentBytes() const
+{
+    return slots.size() * getChunkBytes();
+}
+
+juce::int64 LoopStorage::getScratchBytes() const
+{
+    const juce::ScopedLock sl(lock);
+    return scratchChunks * static_cast<juce::int64>(getChunkBytes());
+}
@@ -0,0 +1,234 @@
+/*
+  ==============================================================================
+
+    LoopStorage.h
+    Looper audio storage: a RAM window over a memory-mapped scratch file
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+#include <array>
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <vector>
+
+//==============================================================================
+/**
+    Stores a stereo loop of any length, with overdub layers, in a fixed
+    amount of RAM.
+
+    The loop is divided into chunks of chunkSeconds, sized from the actual
+    sample rate. A small, fixed set of chunk slots lives in RAM. These hold
+    the first headChunks of the loop, so wrapping around (and starting to
+    play straight after recording) never waits on the disk. They also hold
+    the chunk under the playhead and the next lookaheadChunks. Everything
+    else lives in a scratch file in the temp directory. The file is grown
+    ahead of the record head and accessed through memory-mapped segments
+    of segmentSeconds. A segment is filled in one chunk per service() call
+    and only used once it's complete, so the shared disk thread is never
+    held up writing a whole segment. Segments that haven't been used for a
+    while are unmapped.
+
+    Overdubs are copy-on-write. Each layer owns a version of the loop: a
+    table mapping every loop chunk to a physical chunk of the pre-summed
+    mix. A new layer starts as a copy of the table it was recorded over.
+    The audio thread adds the input into the layer's own delta chunks.
+    The background thread then mixes each touched chunk (the previous
+    version's mix plus the delta) into a new physical chunk and swaps it
+    into the layer's table. Playback therefore always reads one summed
+    chunk, however many layers there are. Untouched chunks stay shared
+    between versions.
+
+    Undo and redo just switch which version is playing. The neighbouring
+    versions' chunks around the playhead are kept resident too, so the
+    switch is O(1), allocation-free and never drops out. Up to maxLayers
+    layers can be undone. A new overdub after an undo discards the redo
+    history. The chunks of discarded layers stay in the scratch file until
+    reset().
+
+    The audio thread only ever touches RAM slots, through write(),
+    overdub() and addTo(). service() runs on a background thread. It
+    flushes recorded chunks to the scratch file, mixes overdubs, grows
+    the file ahead of the record and overdub heads, and loads chunks into
+    the slots ahead of the playhead. A chunk that isn't resident when the
+    audio thread needs it is written short or played as silence, and
+    counted as an underrun, rather than blocking.
+
+    prepare() and reset() must not run concurrently with the audio thread
+    calls. The layer calls are safe while the loop plays; endOverdub(),
+    undoLayer() and redoLayer() can be called from any thread.
+*/
+class LoopStorage
+{
+  public:
+    static constexpr int numChannels = 2;
+    static constexpr double chunkSeconds = 2.0;
+    static constexpr double segmentSeconds = 60.0;
+    static constexpr int headChunks = 2;
+    static constexpr int lookaheadChunks = 2;
+    static constexpr int maxLayers = 16;
+
+    LoopStorage();
+    ~LoopStorage();
+
+    //==========================================================================
+    // Setup (message thread)
+
+    /// Sizes the RAM window for sampleRate and forgets any stored audio.
+    /// Allocates; a no-op apart from reset() if the rate hasn't changed.
+    void prepare(double sampleRate);
+
+    /// Forgets the stored audio and layers, keeping the RAM window and
+    /// scratch file.
+    void reset();
+
+    double getSampleRate() const { return sampleRate; }
+    int getChunkSize() const { return chunkSize; }
+
+    //==========================================================================
+    // Layers
+
+    /// Opens a new overdub layer over the playing version of a loop of
+    /// length samples, with its first chunks ready at position. Message
+    /// thread; allocates. Returns false if there's no loop to overdub.
+    bool beginOverdub(juce::int64 position, juce::int64 length);
+    /// Closes the overdub layer; it's mixed down in the background.
+    void endOverdub();
+    bool isOverdubbing() const { return overdubVersion.load(std::memory_order_acquire) != nullptr; }
+
+    /// Steps back/forward one layer. O(1); returns false if there's nothing
+    /// to undo/redo.
+    bool undoLayer();
+    bool redoLayer();
+    bool canUndoLayer() const;
+    bool canRedoLayer() const;
+    /// Overdub layers in the playing version
+    int getNumLayers() const;
+
+    //==========================================================================
+    // Audio thread
+
+    /// Records numSamples from source at position. Returns the number of
+    /// samples written, which is less than numSamples only if the chunk
+    /// they belong in isn't ready yet.
+    int write(const juce::AudioBuffer<float>& source, int sourceStart, juce::int64 position, int numSamples);
+
+    /// Adds numSamples from source into the open overdub layer at position
+    /// (which must lie within the loop). Returns false if a chunk wasn't
+    /// ready; true if it was written or no layer is open.
+    bool overdub(const juce::AudioBuffer<float>& source, int sourceStart, juce::int64 position, int numSamples);
+
+    /// Adds numSamples from position into dest, with a linear gain ramp.
+    /// Returns the number of samples that were resident; the rest are left
+    /// silent.
+    int addTo(juce::AudioBuffer<float>& dest, int destStart, juce::int64 position, int numSamples, float startGain,
+              float endGain);
+
+    //==========================================================================
+    // Background thread
+
+    /// Flushes, mixes, preallocates and loads chunks around position, for a
+    /// loop of length samples. Returns true if there's work it couldn't
+    /// finish yet.
+    bool service(juce::int64 position, juce::int64 length, bool recording);
+
+    /// Grows the scratch file towards holding numSamples, by at most one
+    /// chunk per call. Returns true once it's big enough.
+    bool reserve(juce::int64 numSamples);
+
+    /// Stores numSamples of source at position directly in the scratch file
+    /// (used when loading a loop from disk). reserve() the space first.
+    /// Returns false on I/O failure, or if the space isn't there yet.
+    bool import(const juce::AudioBuffer<float>& source, int numSamples, juce::int64 position);
+
+    //==========================================================================
+    // Stats
+
+    /// RAM held by the chunk slots; independent of the loop length
+    size_t getResidentBytes() const;
+    /// Size of the scratch file
+    juce::int64 getScratchBytes() const;
+    /// Audio-thread reads or writes that found their chunk missing
+    juce::int64 getUnderruns() const { return underruns.load(std::memory_order_relaxed); }
+
+  private:
+    struct Slot
+    {
+        juce::AudioBuffer<float> audio;
+        std::atomic<juce::int64> chunk{-1}; // Physical chunk, published once audio is ready; -1 if free
+        std::atomic<bool> dirty{false};     // Recorded into since the last flush
+    };
+
+    /// One layer's view of the loop
+    struct Version
+    {
+        explicit Version(size_t numChunks);
+
+        std::vector<std::atomic<juce::int64>> chunks; // Loop chunk -> physical chunk of the mix
+        std::vector<std::atomic<juce::int64>> delta;  // Loop chunk -> physical chunk of this layer's input, or -1
+        std::vector<std::atomic<bool>> pending;       // Overdubbed since it was last mixed
+        std::vector<juce::int64> mixed;               // This layer's own mix chunks, or -1 (background only)
+        std::atomic<bool> anyPending{false};
+        int previous = -1; // Version number this layer was recorded over; -1 for the base take
+    };
+
+    static constexpr int maxVersions = maxLayers + 1;
+
+    Slot* findSlot(juce::int64 chunk) const;
+    Slot* findVictim(const std::vector<juce::int64>& wanted) const;
+    void resetLocked();
+    bool serviceLocked(juce::int64 position, juce::int64 length, bool recording);
+
+    Version* getVersion(int number) const { return versions[static_cast<size_t>(number % maxVersions)].get(); }
+    bool mixPending(Version& version, juce::int64 skipChunk, juce::int64 length);
+    bool mixChunk(Version& version, juce::int64 chunk, juce::int64 length);
+    juce::int64 allocateChunk();
+
+    /// Grows the scratch file by at most one chunk towards numChunks; true if
+    /// they're all usable
+    bool ensureScratch(juce::int64 numChunks);
+    float* getScratchChunk(juce::int64 chunk);
+    void unmapIdleSegments();
+    void deleteScratch();
+
+    int getStoredSamples(juce::int64 chunk, juce::int64 length) const;
+    bool flush(Slot& slot, juce::int64 chunk, juce::int64 length);
+    void fill(Slot& slot, juce::int64 chunk, juce::int64 length);
+    void readChunk(juce::int64 chunk, juce::int64 length, juce::AudioBuffer<float>& into, bool add);
+
+    size_t getChunkBytes() const { return static_cast<size_t>(chunkSize) * numChannels * sizeof(float); }
+
+    double sampleRate = 0.0;
+    int chunkSize = 0;
+    int segmentChunks = 1;
+
+    std::vector<std::unique_ptr<Slot>> slots;
+
+    juce::CriticalSection lock; // Serialises the background and setup calls
+    juce::File scratchFile;
+    juce::int64 scratchChunks = 0; // Chunks in complete segments of the scratch file
+    std::vector<std::unique_ptr<juce::MemoryMappedFile>> segments;
+    std::vector<int> segmentLastUse;
+    int servicePass = 0;
+
+    // Versions are numbered from 0 (the base take) and kept in a ring
+    std::array<std::unique_ptr<Version>, maxVersions> versions;
+    std::vector<std::unique_ptr<Version>> retired; // Replaced versions, freed one overdub later
+    mutable juce::SpinLock versionLock;
+    int oldestVersion = 0, newestVersion = -1, currentVersion = -1; // -1 until the first overdub
+    std::atomic<Version*> playingVersion{nullptr};                   // nullptr plays the base take directly
+    std::atomic<Version*> overdubVersion{nullptr};
+    // Physical chunks from firstLayerChunk on belong to layers
+    juce::int64 firstLayerChunk = std::numeric_limits<juce::int64>::max();
+    juce::int64 nextChunk = 0;
+    juce::AudioBuffer<float> mixBuffer;
+
+    std::atomic<juce::int64> underruns{0};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LoopStorage)
+};
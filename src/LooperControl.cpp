@@ -40,7 +40,7 @@ File LooperControl::lastDir(File::getSpecialLocation(File::userHomeDirectory));
 //==============================================================================
 LooperControl::LooperControl(LooperProcessor* proc, AudioThumbnail* thumbnail)
     : processor(proc), fileDisplay(0), filename(0), syncButton(0), stopAfterBarButton(0), playPauseButton(0),
-      rtzButton(0), recordButton(0)
+      rtzButton(0), recordButton(0), dubButton(0), undoButton(0), redoButton(0)
 {
     addAndMakeVisible(fileDisplay = new WaveformDisplay(thumbnail, false));
     fileDisplay->setName("fileDisplay");
@@ -68,6 +68,21 @@ LooperControl::LooperControl(LooperProcessor* proc, AudioThumbnail* thumbnail)
     addAndMakeVisible(recordButton = new DrawableButton("recordButton", DrawableButton::ImageOnButtonBackground));
     recordButton->setName("recordButton");
 
+    addAndMakeVisible(dubButton = new TextButton("dubButton"));
+    dubButton->setTooltip("Overdub a new layer onto the playing loop");
+    dubButton->setButtonText("Dub");
+    dubButton->addListener(this);
+
+    addAndMakeVisible(undoButton = new TextButton("undoButton"));
+    undoButton->setTooltip("Undo the last overdub layer");
+    undoButton->setButtonText("Undo");
+    undoButton->addListener(this);
+
+    addAndMakeVisible(redoButton = new TextButton("redoButton"));
+    redoButton->setTooltip("Redo the last undone overdub layer");
+    redoButton->setButtonText("Redo");
+    redoButton->addListener(this);
+
     //[UserPreSize]
     std::unique_ptr<Drawable> rtzImage(
         JuceHelperStuff::loadSVGFromMemory(Vectors::rtzbutton_svg, Vectors::rtzbutton_svgSize));
@@ -124,7 +139,7 @@ LooperControl::LooperControl(LooperProcessor* proc, AudioThumbnail* thumbnail)
 
     //[/UserPreSize]
 
-    setSize(300, 100);
+    setSize(360, 100);
 
     //[Constructor] You can add your own custom stuff here..
     //[/Constructor]
@@ -152,6 +167,12 @@ LooperControl::~LooperControl()
     rtzButton = nullptr;
     delete recordButton;
     recordButton = nullptr;
+    delete dubButton;
+    dubButton = nullptr;
+    delete undoButton;
+    undoButton = nullptr;
+    delete redoButton;
+    redoButton = nullptr;
 
     //[Destructor]. You can add your own custom destruction code here..
     //[/Destructor]
@@ -170,12 +191,15 @@ void LooperControl::paint(Graphics& g)
 void LooperControl::resized()
 {
     fileDisplay->setBounds(0, 28, getWidth() - 2, getHeight() - 48);
-    filename->setBounds(0, 0, getWidth() - 84, 24);
+    filename->setBounds(0, 0, getWidth() - 204, 24);
     syncButton->setBounds(0, getHeight() - 23, 168, 24);
     stopAfterBarButton->setBounds(176, getHeight() - 23, 112, 24);
     playPauseButton->setBounds(getWidth() - 80, 0, 24, 24);
     rtzButton->setBounds(getWidth() - 52, 0, 24, 24);
     recordButton->setBounds(getWidth() - 24, 0, 24, 24);
+    dubButton->setBounds(getWidth() - 200, 0, 36, 24);
+    undoButton->setBounds(getWidth() - 160, 0, 36, 24);
+    redoButton->setBounds(getWidth() - 120, 0, 36, 24);
     //[UserResized] Add your own custom resize handling here..
     //[/UserResized]
 }
@@ -240,6 +264,12 @@ void LooperControl::buttonClicked(Button* buttonThatWasClicked)
 
         processor->setParameter(LooperProcessor::Record, 1.0f);
     }
+    else if (buttonThatWasClicked == dubButton)
+        processor->setParameter(LooperProcessor::Overdub, 1.0f);
+    else if (buttonThatWasClicked == undoButton)
+        processor->setParameter(LooperProcessor::UndoLayer, 1.0f);
+    else if (buttonThatWasClicked == redoButton)
+        processor->setParameter(LooperProcessor::RedoLayer, 1.0f);
 
     // So LooperEditor gets updated too.
     processor->sendChangeMessage();
@@ -285,7 +315,7 @@ void LooperControl::changeListenerCallback(ChangeBroadcaster* source)
         if (processor->getAndClearMemoryError())
         {
             AlertWindow::showMessageBoxAsync(AlertWindow::WarningIcon, "Looper Error",
-                                             "Not enough memory to continue. Recording stopped.");
+                                             "Loop storage couldn't keep up (out of disk space?). Recording stopped.");
         }
 
         if (processor->getNewFileLoaded())
@@ -321,6 +351,12 @@ void LooperControl::changeListenerCallback(ChangeBroadcaster* source)
                 playing = false;
             }
         }
+        // Overdubbing needs a playing loop; undo/redo act on finished layers.
+        dubButton->setEnabled(processor->isPlaying() && !processor->isRecording());
+        dubButton->setToggleState(processor->isOverdubbing(), dontSendNotification);
+        undoButton->setEnabled(processor->canUndoLayer() && !processor->isRecording());
+        redoButton->setEnabled(processor->canRedoLayer() && !processor->isRecording());
+
         fileDisplay->setReadPointer((float)processor->getReadPosition());
         syncButton->setToggleState(processor->getParameter(LooperProcessor::SyncToMainTransport) > 0.5f, false);
         stopAfterBarButton->setToggleState(processor->getParameter(LooperProcessor::StopAfterBar) > 0.5f, false);
@@ -105,6 +105,9 @@ class LooperControl : public Component,
     DrawableButton* playPauseButton;
     DrawableButton* rtzButton;
     DrawableButton* recordButton;
+    TextButton* dubButton;
+    TextButton* undoButton;
+    TextButton* redoButton;
 
     //==============================================================================
     // (prevent copy constructor and operator= being generated..)
@@ -30,14 +30,12 @@ LooperProcessor::LooperProcessor()
     : threadWriter(0),
       thumbnail(512, AudioFormatManagerSingleton::getInstance(), AudioThumbnailCacheSingleton::getInstance()),
       numerator(4), denominator(4), clickCount(0.0f), clickDec(0.0f), measureCount(0), currentRate(44100.0),
-      justPaused(false), loopLength(0), loopPos(0), loopIndex(0), deleteLastBuffer(false), tempBufferWrite(0),
-      fadeOutCount(-1), fadeInCount(0), autoPlayFade(1.0f), fileReader(0), fileReaderPos(0), fileReaderBufIndex(0),
-      newFileLoaded(false), inputAudio(2, 2560)
+      justPaused(false), loopLength(0), loopPos(0), tempBufferWrite(0), fadeOutCount(-1), fadeInCount(0),
+      autoPlayFade(1.0f), fileReader(0), fileReaderPos(0), newFileLoaded(false), inputAudio(2, 2560)
 {
     int i;
 
-    loopBuffer.add(new AudioSampleBuffer(2, (44100 * 8)));
-    loopBuffer[0]->clear();
+    loopStorage.prepare(currentRate);
 
     for (i = 0; i < FadeBufferSize; ++i)
     {
@@ -51,7 +49,8 @@ LooperProcessor::LooperProcessor()
         fadeOutBuffer[1][i] = 0.0f;
     }
 
-    AudioThumbnailCacheSingleton::getInstance().getTimeSliceThread().addTimeSliceClient(this);
+    // Loop streaming is real-time critical, so it runs on the disk read queue.
+    DiskIOScheduler::getInstance().getThread(DiskIOScheduler::Queue::Read).addTimeSliceClient(this);
 
     setPlayConfigDetails(2, 2, 0, 0);
 
@@ -71,7 +70,7 @@ LooperProcessor::~LooperProcessor()
     cancelPendingUpdate();
 
     // Remove from time slice thread FIRST to ensure no more callbacks
-    AudioThumbnailCacheSingleton::getInstance().getTimeSliceThread().removeTimeSliceClient(this);
+    DiskIOScheduler::getInstance().getThread(DiskIOScheduler::Queue::Read).removeTimeSliceClient(this);
 
     // Small delay to let any in-progress audio callbacks complete
     Thread::sleep(10);
@@ -92,8 +91,6 @@ LooperProcessor::~LooperProcessor()
 //------------------------------------------------------------------------------
 void LooperProcessor::setFile(const File& phil)
 {
-    int i;
-
     if (recording)
     {
         stopRecording = true;
@@ -131,7 +128,6 @@ void LooperProcessor::setFile(const File& phil)
             delete fileReader;
         fileReader = AudioFormatManagerSingleton::getInstance().createReaderFor(soundFile);
         fileReaderPos = 0;
-        fileReaderBufIndex = 0;
 
         // Calculate ratio for resampling if file sample rate differs from device rate
         if (fileReader && currentRate > 0)
@@ -141,25 +137,34 @@ void LooperProcessor::setFile(const File& phil)
     }
 
     loopLength = 0;
-    loopIndex = 0;
     loopPos = 0;
+    overdubbing = false;
 
-    // Remove all loop buffers except the 1st one.
-    for (i = (loopBuffer.size() - 1); i > 0; --i)
-        loopBuffer.remove(i);
+    // Forget the old loop and its layers; the RAM window and scratch file
+    // are reused.
+    loopStorage.reset();
 }
 
 //------------------------------------------------------------------------------
 double LooperProcessor::getReadPosition() const
 {
     if (loopLength > 0)
-        return (double)(((double)loopIndex * (double)LoopBufferSize) + (double)loopPos) / (double)loopLength;
+        return (double)loopPos.load() / (double)loopLength.load();
     else
         return 0.0;
 }
 
 //------------------------------------------------------------------------------
 void LooperProcessor::handleAsyncUpdate()
+{
+    if (overdubRequested.exchange(false))
+        startOverdub();
+    if (recordRequested.exchange(false))
+        startRecording();
+}
+
+//------------------------------------------------------------------------------
+void LooperProcessor::startRecording()
 {
     int abortCounter = 2000; //== 2 seconds, assuming a perfect 1 millisecond wait
                              // from Thread::sleep().
@@ -219,8 +224,8 @@ void LooperProcessor::handleAsyncUpdate()
         }
         else
         {
-            threadWriter = new AudioFormatWriter::ThreadedWriter(
-                writer, AudioThumbnailCacheSingleton::getInstance().getTimeSliceThread(), 16384);
+            // Runs on the disk write queue, so thumbnail work can't starve it.
+            threadWriter = new DiskWriter(writer, 65536);
             threadWriter->setDataReceiver(&thumbnail);
         }
     }
@@ -245,78 +250,84 @@ void LooperProcessor::handleAsyncUpdate()
     }
 }
 
+//------------------------------------------------------------------------------
+void LooperProcessor::startOverdub()
+{
+    // Layers go over a loop that's already playing, and fully loaded.
+    if (!isPlaying() || recording || fileReader || (loopLength.load() == 0))
+        return;
+
+    if (loopStorage.beginOverdub(loopPos.load(), (int64)loopLength.load()))
+        overdubbing = true;
+    else
+        memoryError.store(true, std::memory_order_relaxed);
+
+    sendChangeMessage();
+}
+
+//------------------------------------------------------------------------------
+void LooperProcessor::endOverdub()
+{
+    overdubbing = false;
+    loopStorage.endOverdub();
+}
+
 //------------------------------------------------------------------------------
 int LooperProcessor::useTimeSlice()
 {
     int retval = 250; // Wait 1/4 second before checking again.
 
-    if (recording)
+    if (fileReader && !recording)
     {
-        if (loopIndex == (loopBuffer.size() - 1))
-        {
-            // 16538 = ~3/8 of a second. Should be enough considering the wait
-            // time we return from this method?
-            if (loopPos > (LoopBufferSize - 16538))
-            {
-                loopBuffer.add(new AudioSampleBuffer(2, LoopBufferSize));
-                loopBuffer[loopBuffer.size() - 1]->clear();
-            }
-        }
-    }
-    else if (deleteLastBuffer)
-    {
-        loopBuffer.remove(loopBuffer.size() - 1);
-        deleteLastBuffer = false;
-    }
-    else if (fileReader)
-    {
-        if (fileReaderBufIndex >= loopBuffer.size())
-        {
-            loopBuffer.add(new AudioSampleBuffer(2, LoopBufferSize));
-            loopBuffer[loopBuffer.size() - 1]->clear();
-
-            jassert(fileReaderBufIndex < loopBuffer.size());
-        }
+        // Read one storage chunk's worth of output at a time.
+        const int chunkSize = loopStorage.getChunkSize();
 
         // Calculate how many source samples we need to read
-        int64 sourceSamplesToRead = (int64)std::ceil(LoopBufferSize * fileReaderRatio);
+        int64 sourceSamplesToRead = (int64)std::ceil(chunkSize * fileReaderRatio);
 
         // Clamp to remaining samples in file
         int64 remainingInFile = fileReader->lengthInSamples - fileReaderPos;
         if (sourceSamplesToRead > remainingInFile)
             sourceSamplesToRead = remainingInFile;
 
-        if (sourceSamplesToRead > 0 && fileReaderRatio != 1.0)
+        bool ok = true;
+
+        // The scratch file grows a chunk per call; read on once there's room.
+        if (!loopStorage.reserve((int64)loopLength.load() + chunkSize))
+            sourceSamplesToRead = 0;
+
+        if (sourceSamplesToRead > 0)
         {
-            // Need to resample: read into temp buffer, then resample into loop buffer
             AudioSampleBuffer tempBuffer(2, (int)sourceSamplesToRead);
             fileReader->read(&tempBuffer, 0, (int)sourceSamplesToRead, fileReaderPos, true, true);
 
-            // Use LagrangeInterpolator for each channel
-            int outputSamples = (int)(sourceSamplesToRead / fileReaderRatio);
-            if (outputSamples > LoopBufferSize)
-                outputSamples = LoopBufferSize;
+            AudioSampleBuffer resampled;
+            const AudioSampleBuffer* source = &tempBuffer;
+            int outputSamples = (int)sourceSamplesToRead;
 
-            LagrangeInterpolator interpolatorL, interpolatorR;
-            interpolatorL.process(fileReaderRatio, tempBuffer.getReadPointer(0),
-                                  loopBuffer[fileReaderBufIndex]->getWritePointer(0), outputSamples);
-            interpolatorR.process(fileReaderRatio, tempBuffer.getReadPointer(1),
-                                  loopBuffer[fileReaderBufIndex]->getWritePointer(1), outputSamples);
+            if (fileReaderRatio != 1.0)
+            {
+                // Need to resample: use LagrangeInterpolator for each channel
+                outputSamples = jmin(chunkSize, (int)(sourceSamplesToRead / fileReaderRatio));
+                resampled.setSize(2, outputSamples);
+
+                LagrangeInterpolator interpolatorL, interpolatorR;
+                interpolatorL.process(fileReaderRatio, tempBuffer.getReadPointer(0), resampled.getWritePointer(0),
+                                      outputSamples);
+                interpolatorR.process(fileReaderRatio, tempBuffer.getReadPointer(1), resampled.getWritePointer(1),
+                                      outputSamples);
+                source = &resampled;
+            }
 
-            fileReaderPos += sourceSamplesToRead;
-            loopLength += outputSamples;
-        }
-        else if (sourceSamplesToRead > 0)
-        {
-            // No resampling needed (same sample rate)
-            fileReader->read(loopBuffer[fileReaderBufIndex], 0, (int)sourceSamplesToRead, fileReaderPos, true, true);
-            fileReaderPos += sourceSamplesToRead;
-            loopLength += sourceSamplesToRead;
+            ok = loopStorage.import(*source, outputSamples, (int64)loopLength.load());
+            if (ok)
+            {
+                fileReaderPos += sourceSamplesToRead;
+                loopLength += (uint64_t)outputSamples;
+            }
         }
 
-        ++fileReaderBufIndex;
-
-        if (fileReaderPos >= fileReader->lengthInSamples)
+        if (!ok || (fileReaderPos >= fileReader->lengthInSamples))
         {
             delete fileReader;
             fileReader = 0;
@@ -327,6 +338,20 @@ int LooperProcessor::useTimeSlice()
         retval = 20;
     }
 
+    // Keep the RAM window around the play/record head filled, recorded
+    // chunks flushed to the scratch file, and overdub layers mixed down.
+    if (loopStorage.service(loopPos.load(), (int64)loopLength.load(), recording.load()))
+        retval = 20;
+    else if (recording || playing)
+        retval = jmin(retval, 50);
+
+    // Pass storage misses on to the read queue's counters.
+    const int64 underruns = loopStorage.getUnderruns();
+    if (underruns < reportedUnderruns)
+        reportedUnderruns = underruns;
+    for (; reportedUnderruns < underruns; ++reportedUnderruns)
+        DiskIOScheduler::getInstance().reportUnderrun(DiskIOScheduler::Queue::Read);
+
     return retval;
 }
 
@@ -384,13 +409,14 @@ void LooperProcessor::processBlock(AudioSampleBuffer& buffer, MidiBuffer& midiMe
     int i, j;
     float tempf;
     float* data[2];
-    uint64_t end, end2;
+    uint64_t end;
     float* inputData[2];
     int fadeOutStart = 0;
     int samplesToRecord = buffer.getNumSamples();
     const int numSamples = buffer.getNumSamples();
     const float curInputLevel = inputLevel.load();
     const float curLoopLevel = loopLevel.load();
+    int64_t pos = loopPos.load();
 
     jassert(buffer.getNumChannels() > 1);
 
@@ -451,49 +477,16 @@ void LooperProcessor::processBlock(AudioSampleBuffer& buffer, MidiBuffer& midiMe
         threadWriter->write((const float**)data, samplesToRecord);
 
         // Copy fade in buffer if necessary.
-        if ((loopPos == 0) && (loopIndex == 0))
+        if (pos == 0)
             fillFadeInBuffer();
 
-        if (loopIndex < loopBuffer.size())
-        {
-            if ((loopPos + samplesToRecord) < LoopBufferSize)
-                i = samplesToRecord;
-            else
-                i = LoopBufferSize - loopPos;
-
-            // Write the audio data to the current loop buffer.
-            loopBuffer[loopIndex]->copyFrom(0, loopPos, buffer, 0, 0, i);
-            loopBuffer[loopIndex]->copyFrom(1, loopPos, buffer, 1, 0, i);
+        // Write the audio data into the loop storage. This only falls short
+        // if the storage thread hasn't got the next chunk ready in time.
+        i = loopStorage.write(buffer, 0, pos, samplesToRecord);
+        pos += i;
+        loopLength += (uint64_t)i;
 
-            tempf = loopBuffer[loopIndex]->getWritePointer(0, 0)[0];
-            tempf = fadeInBuffer[0][127];
-            if (i < samplesToRecord)
-            {
-                ++loopIndex;
-                loopPos = 0;
-                if (loopIndex >= loopBuffer.size())
-                {
-                    memoryError.store(true, std::memory_order_relaxed);
-                    stopRecording = true;
-                    loopLength += i;
-                    fadeOutStart = i;
-                }
-                else
-                {
-                    loopBuffer[loopIndex]->copyFrom(0, 0, buffer, 0, i, (samplesToRecord - i));
-                    loopBuffer[loopIndex]->copyFrom(1, 0, buffer, 1, i, (samplesToRecord - i));
-
-                    loopPos = samplesToRecord - i;
-                    loopLength += samplesToRecord;
-                }
-            }
-            else
-            {
-                loopPos += samplesToRecord;
-                loopLength += samplesToRecord;
-            }
-        }
-        else
+        if (i < samplesToRecord)
         {
             memoryError.store(true, std::memory_order_relaxed);
             stopRecording = true;
@@ -507,11 +500,7 @@ void LooperProcessor::processBlock(AudioSampleBuffer& buffer, MidiBuffer& midiMe
                 playing = true;
             stateChanged.store(true, std::memory_order_relaxed);
 
-            if (loopIndex < (loopBuffer.size() - 1))
-                deleteLastBuffer = true;
-
-            loopPos = 0;
-            loopIndex = 0;
+            pos = 0;
             fadeInCount = (loopLength - 1);
 
             // Starts the count of [NumBufferSize] samples so we can store the
@@ -528,39 +517,36 @@ void LooperProcessor::processBlock(AudioSampleBuffer& buffer, MidiBuffer& midiMe
             playing = true;
         stateChanged.store(true, std::memory_order_relaxed);
 
-        loopPos = 0;
-        loopIndex = 0;
+        pos = 0;
     }
 
     // Apply input level gain change.
     buffer.applyGain(0, numSamples, curInputLevel);
 
-    if (playing && (loopLength > 0))
+    const uint64_t length = loopLength.load();
+
+    if (playing && (length > 0))
     {
-        if (loopBuffer.size() == 1)
-            end = (uint64_t)loopLength;
-        else if (loopIndex < (loopBuffer.size() - 1))
-            end = (uint64_t)LoopBufferSize;
-        else
-            end = loopLength - (uint64_t)(LoopBufferSize * (loopBuffer.size() - 1));
+        if ((uint64_t)pos >= length)
+            pos = 0;
 
-        if ((loopPos + numSamples) < end)
+        if (((uint64_t)pos + numSamples) < length)
             i = numSamples;
         else
-            i = (int)(end - (uint64_t)loopPos);
+            i = (int)(length - (uint64_t)pos);
 
         // Output the fade out buffer.
-        if ((loopPos < FadeBufferSize) && (fadeOutCount == -1))
+        if ((pos < FadeBufferSize) && (fadeOutCount == -1))
         {
-            end2 = FadeBufferSize - loopPos;
-            if (end2 > numSamples)
-                end2 = numSamples;
+            end = FadeBufferSize - pos;
+            if (end > numSamples)
+                end = numSamples;
 
-            for (j = 0; j < end2; ++j)
+            for (j = 0; j < end; ++j)
             {
-                tempf = 1.0f - ((float)(loopPos + j) / (float)FadeBufferSize);
-                data[0][j] += fadeOutBuffer[0][loopPos + j] * tempf * curLoopLevel;
-                data[1][j] += fadeOutBuffer[1][loopPos + j] * tempf * curLoopLevel;
+                tempf = 1.0f - ((float)(pos + j) / (float)FadeBufferSize);
+                data[0][j] += fadeOutBuffer[0][pos + j] * tempf * curLoopLevel;
+                data[1][j] += fadeOutBuffer[1][pos + j] * tempf * curLoopLevel;
             }
         }
 
@@ -572,69 +558,85 @@ void LooperProcessor::processBlock(AudioSampleBuffer& buffer, MidiBuffer& midiMe
                 tempf = 1.0f - ((float)fadeInCount / (float)(FadeBufferSize - 1));
                 data[0][j] += fadeInBuffer[0][FadeBufferSize - 1 - fadeInCount] * tempf * curLoopLevel;
                 data[1][j] += fadeInBuffer[1][FadeBufferSize - 1 - fadeInCount] * tempf * curLoopLevel;
-
-                if ((FadeBufferSize - 1 - fadeInCount) == 127)
-                    tempf = fadeInBuffer[0][127];
             }
 
             if (fadeInCount == 0)
-                fadeInCount = loopLength;
+                fadeInCount = length;
         }
 
-        tempf = loopBuffer[loopIndex]->getWritePointer(0, 0)[0];
         if (autoPlayFade < 1.0f)
         {
-            buffer.addFromWithRamp(0, 0, loopBuffer[loopIndex]->getWritePointer(0, loopPos), i, 0.0f, curLoopLevel);
-            buffer.addFromWithRamp(1, 0, loopBuffer[loopIndex]->getWritePointer(1, loopPos), i, 0.0f, curLoopLevel);
+            loopStorage.addTo(buffer, 0, pos, i, 0.0f, curLoopLevel);
             autoPlayFade = 1.0f;
         }
         else
-        {
-            buffer.addFrom(0, 0, *(loopBuffer[loopIndex]), 0, loopPos, i, curLoopLevel);
-            buffer.addFrom(1, 0, *(loopBuffer[loopIndex]), 1, loopPos, i, curLoopLevel);
-        }
+            loopStorage.addTo(buffer, 0, pos, i, curLoopLevel, curLoopLevel);
+
+        // Add the input into the open overdub layer. It's heard from the
+        // loop once it's been mixed down, on the next pass.
+        bool dubbed = true;
+        if (overdubbing)
+            dubbed = loopStorage.overdub(inputAudio, 0, pos, i);
+
         if (i < numSamples)
         {
-            ++loopIndex;
-            if (loopIndex >= loopBuffer.size())
-                loopIndex = 0;
-            loopPos = 0;
+            // Wrap around to the start of the loop.
+            const int remaining = (int)jmin((uint64_t)(numSamples - i), length);
 
             if (fadeOutCount == -1)
             {
-                end = FadeBufferSize - loopPos;
+                end = FadeBufferSize;
                 if (end > (numSamples - i))
                     end = (numSamples - i);
 
                 for (j = 0; j < end; ++j)
                 {
-                    tempf = 1.0f - ((float)(loopPos + j) / (float)FadeBufferSize);
-                    data[0][i + j] += fadeOutBuffer[0][loopPos + j] * tempf * curLoopLevel;
-                    data[1][i + j] += fadeOutBuffer[1][loopPos + j] * tempf * curLoopLevel;
+                    tempf = 1.0f - ((float)j / (float)FadeBufferSize);
+                    data[0][i + j] += fadeOutBuffer[0][j] * tempf * curLoopLevel;
+                    data[1][i + j] += fadeOutBuffer[1][j] * tempf * curLoopLevel;
                 }
             }
 
-            buffer.addFrom(0, i, *(loopBuffer[loopIndex]), 0, loopPos, (numSamples - i), curLoopLevel);
-            buffer.addFrom(1, i, *(loopBuffer[loopIndex]), 1, loopPos, (numSamples - i), curLoopLevel);
-            tempf = buffer.getWritePointer(0, 0)[0];
+            loopStorage.addTo(buffer, i, 0, remaining, curLoopLevel, curLoopLevel);
+            if (overdubbing && dubbed)
+                dubbed = loopStorage.overdub(inputAudio, i, 0, remaining);
 
-            loopPos = numSamples - i;
+            pos = remaining;
         }
         else
-            loopPos += i;
+            pos += i;
+
+        if (!dubbed)
+        {
+            memoryError.store(true, std::memory_order_relaxed);
+            endOverdub();
+            stateChanged.store(true, std::memory_order_relaxed);
+        }
 
         if (stopPlaying)
         {
             playing = false;
             stopPlaying = false;
+            if (overdubbing)
+            {
+                endOverdub();
+                stateChanged.store(true, std::memory_order_relaxed);
+            }
         }
     }
     else if (stopPlaying)
     {
         playing = false;
         stopPlaying = false;
+        if (overdubbing)
+        {
+            endOverdub();
+            stateChanged.store(true, std::memory_order_relaxed);
+        }
     }
 
+    loopPos.store(pos);
+
     for (i = 0; i < numSamples; ++i)
     {
         if (fadeOutCount >= FadeBufferSize)
@@ -660,6 +662,21 @@ void LooperProcessor::prepareToPlay(double sampleRate, int estimatedSamplesPerBl
     currentRate = sampleRate;
 
     inputAudio.setSize(2, estimatedSamplesPerBlock);
+
+    // The storage chunks are sized in time, so a new rate means a new
+    // layout. The audio thread isn't running, so stop immediately and reload
+    // the loop's file at the new rate.
+    if (sampleRate != loopStorage.getSampleRate())
+    {
+        playing = false;
+        stopPlaying = false;
+        recording = false;
+        stopRecording = false;
+        overdubbing = false;
+
+        loopStorage.prepare(sampleRate);
+        setFile(soundFile);
+    }
 }
 
 //------------------------------------------------------------------------------
@@ -708,6 +725,15 @@ const String LooperProcessor::getParameterName(int parameterIndex)
     case LoopLevel:
         retval = "Loop Level";
         break;
+    case Overdub:
+        retval = "Overdub";
+        break;
+    case UndoLayer:
+        retval = "Undo Layer";
+        break;
+    case RedoLayer:
+        retval = "Redo Layer";
+        break;
     }
 
     return retval;
@@ -770,7 +796,6 @@ void LooperProcessor::setParameter(int parameterIndex, float newValue)
         sendChangeMessage();
         break;
     case ReturnToZero:
-        loopIndex = 0;
         loopPos = 0;
         fadeInCount = loopLength - 1;
         break;
@@ -780,8 +805,12 @@ void LooperProcessor::setParameter(int parameterIndex, float newValue)
             if (playing)
                 stopPlaying = true;
 
+            if (overdubbing)
+                endOverdub();
+
             if (!recording && !stopRecording) // && threadWriter)
             {
+                recordRequested = true;
                 triggerAsyncUpdate();
             }
             else if (recording)
@@ -796,21 +825,14 @@ void LooperProcessor::setParameter(int parameterIndex, float newValue)
         break;
     case ReadPosition:
     {
-        int tempindex = 0;
-        uint64_t tempint = 0;
-        uint64_t pos = (uint64_t)(newValue * (float)loopLength);
+        const uint64_t length = loopLength.load();
+        uint64_t pos = (uint64_t)(jlimit(0.0, 1.0, (double)newValue) * (double)length);
 
-        fadeInCount = loopLength - 1 - pos;
+        if (length > 0 && pos >= length)
+            pos = length - 1;
 
-        // This is a stupid way of doing this, but my brain's not working
-        // right now...
-        while (tempint < pos)
-        {
-            ++tempindex;
-            tempint += LoopBufferSize;
-        }
-        loopIndex = tempindex - 1;
-        loopPos = pos % LoopBufferSize;
+        fadeInCount = length - 1 - pos;
+        loopPos = (int64_t)pos;
 
         sendChangeMessage();
     }
@@ -837,6 +859,34 @@ void LooperProcessor::setParameter(int parameterIndex, float newValue)
     case LoopLevel:
         loopLevel.store(newValue * 2.0f);
         break;
+    case Overdub:
+        if (newValue > 0.5f)
+        {
+            if (overdubbing)
+                endOverdub();
+            else if (isPlaying() && !recording)
+            {
+                overdubRequested = true;
+                triggerAsyncUpdate();
+            }
+            sendChangeMessage();
+        }
+        break;
+    case UndoLayer:
+    case RedoLayer:
+        if (newValue > 0.5f)
+        {
+            // Undo/redo acts on finished layers only.
+            if (overdubbing)
+                endOverdub();
+
+            if (parameterIndex == UndoLayer)
+                loopStorage.undoLayer();
+            else
+                loopStorage.redoLayer();
+            sendChangeMessage();
+        }
+        break;
     }
 }
 
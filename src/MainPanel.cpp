@@ -31,6 +31,7 @@
 #include "CrashProtection.h"
 #include "DawMixerProcessor.h"
 #include "DawSplitterProcessor.h"
+#include "DspProfilerDisplay.h"
 #include "FontManager.h"
 #include "IRLoaderProcessor.h"
 #include "Images.h"
@@ -49,6 +50,8 @@
 #include "NotesProcessor.h"
 #include "OscilloscopeProcessor.h"
 #include "PatchOrganiser.h"
+#include "PatchSwitchTimingDisplay.h"
+#include "PerfTrace.h"
 #include "PedalboardProcessors.h"
 #include "PluginField.h"
 #include "PluginPoolManager.h"
@@ -57,15 +60,20 @@
 #include "SafePluginScanner.h"
 #include "SettingsManager.h"
 #include "StageView.h"
+#include "StemRecorderProcessor.h"
 #include "SubGraphEditorComponent.h"
+#include "SubGraphProcessor.h"
 #include "TapTempoBox.h"
 #include "ToastOverlay.h"
 #include "ToneGeneratorProcessor.h"
 #include "TunerProcessor.h"
+#include "UiFrameScheduler.h"
 #include "UserPresetWindow.h"
 #include "Vectors.h"
 #include "VirtualMidiInputProcessor.h"
+#include "WaveformCache.h"
 
+#include <functional>
 #include <iostream>
 #include <sstream>
 
@@ -403,6 +411,10 @@ MainPanel::MainPanel(ApplicationCommandManager* appManager)
         DawSplitterProcessor dawSplitter;
         dawSplitter.fillInPluginDescription(desc);
         pluginList.addType(desc);
+
+        StemRecorderProcessor stemRecorder;
+        stemRecorder.fillInPluginDescription(desc);
+        pluginList.addType(desc);
     }
     pluginList.addChangeListener(this);
 
@@ -548,6 +560,23 @@ MainPanel::MainPanel(ApplicationCommandManager* appManager)
         outputGainSlider->setValue(gs.masterOutputGainDb.load(std::memory_order_relaxed), dontSendNotification);
     }
 
+    // Opt-in: time every audio callback, and dump the last few seconds of them on a glitch
+    {
+        auto& recorder = FlightRecorder::getInstance();
+        recorder.setOutputDirectory(
+            SettingsManager::getInstance().getUserDataDirectory().getChildFile("Flight Recorder"));
+        recorder.setEnabled(SettingsManager::getInstance().getBool("FlightRecorder", false));
+        lastFlightRecorderDumps = recorder.getNumDumps();
+    }
+    PatchSwitchTimer::getInstance().setEnabled(SettingsManager::getInstance().getBool("PatchSwitchTiming", false));
+
+    // Waveform overviews outlive the session, so reopened files draw at once
+    WaveformCache::getInstance().setDirectory(
+        SettingsManager::getInstance().getUserDataDirectory().getChildFile("Waveforms"));
+
+    // Meters and live displays all refresh in step with this window's display
+    UiFrameScheduler::getInstance().attachTo(this);
+
     // Start timers.
     startTimer(CpuTimer, 100);
     startTimer(MidiAppTimer, 5);
@@ -592,6 +621,8 @@ MainPanel::~MainPanel()
     // Save gain state before shutdown
     MasterGainState::getInstance().saveToSettings();
 
+    UiFrameScheduler::getInstance().attachTo(nullptr);
+
     // Remove keyboard listener before destruction
     keyboardState.removeListener(this);
 
@@ -1137,6 +1168,10 @@ PopupMenu MainPanel::getMenuForIndex(int topLevelMenuIndex, const String& menuNa
         retval.addCommandItem(commandManager, OptionsColourSchemes);
         retval.addSeparator();
         retval.addCommandItem(commandManager, OptionsSnapToGrid);
+        retval.addCommandItem(commandManager, OptionsMinimumPhaseIRs);
+        retval.addCommandItem(commandManager, OptionsStripIRPreDelay);
+        retval.addCommandItem(commandManager, OptionsFlightRecorder);
+        retval.addCommandItem(commandManager, OptionsPatchSwitchTiming);
         retval.addCommandItem(commandManager, OptionsKeyMappings);
         retval.addSeparator();
         retval.addCommandItem(commandManager, ToggleStageMode);
@@ -1145,6 +1180,9 @@ PopupMenu MainPanel::getMenuForIndex(int topLevelMenuIndex, const String& menuNa
     {
         retval.addCommandItem(commandManager, HelpDocumentation);
         retval.addCommandItem(commandManager, HelpLog);
+        retval.addCommandItem(commandManager, HelpDspProfiler);
+        retval.addCommandItem(commandManager, HelpPerfTrace);
+        retval.addCommandItem(commandManager, HelpPatchSwitchTiming);
         retval.addSeparator();
         retval.addCommandItem(commandManager, HelpAbout);
     }
@@ -1192,7 +1230,14 @@ void MainPanel::getAllCommands(Array<CommandID>& commands)
                              TransportTapTempo,
                              ToggleStageMode,
                              OptionsPluginBlacklist,
-                             OptionsSnapToGrid};
+                             OptionsSnapToGrid,
+                             OptionsMinimumPhaseIRs,
+                             HelpDspProfiler,
+                             OptionsFlightRecorder,
+                             HelpPerfTrace,
+                             OptionsPatchSwitchTiming,
+                             HelpPatchSwitchTiming,
+                             OptionsStripIRPreDelay};
     commands.addArray(ids, numElementsInArray(ids));
 }
 
@@ -1279,6 +1324,19 @@ void MainPanel::getCommandInfo(const CommandID commandID, ApplicationCommandInfo
     case HelpLog:
         result.setInfo("Event Log", "Displays an event log for the program.", helpCategory, 0);
         break;
+    case HelpDspProfiler:
+        result.setInfo("DSP Profiler", "Shows how much of the audio callback each node takes.", helpCategory, 0);
+        break;
+    case HelpPerfTrace:
+        result.setInfo("Record Performance Trace",
+                       "Records a timeline of the audio, loader and UI threads for chrome://tracing or Perfetto.",
+                       helpCategory, 0);
+        result.setTicked(PerfTrace::isEnabled());
+        break;
+    case HelpPatchSwitchTiming:
+        result.setInfo("Patch Switch Timing", "Shows how long each stage of recent patch switches took.", helpCategory,
+                       0);
+        break;
     case HelpAbout:
         result.setInfo("About", "Shows some details about the program.", helpCategory, 0);
         break;
@@ -1309,6 +1367,30 @@ void MainPanel::getCommandInfo(const CommandID commandID, ApplicationCommandInfo
         result.setInfo("Snap to Grid", "Snap plugin nodes to a 20px grid when dragging.", optionsCategory, 0);
         result.setTicked(SettingsManager::getInstance().getBool("SnapToGrid", false));
         break;
+    case OptionsMinimumPhaseIRs:
+        result.setInfo("Minimum-Phase IRs",
+                       "Convert cabinet IRs to minimum phase on load, which usually lets them be trimmed shorter.",
+                       optionsCategory, 0);
+        result.setTicked(SettingsManager::getInstance().getBool("IRMinimumPhase", false));
+        break;
+    case OptionsStripIRPreDelay:
+        result.setInfo("Strip IR Pre-Delay",
+                       "Remove the silence before an IR's onset on load. Blended IRs lose only what they share.",
+                       optionsCategory, 0);
+        result.setTicked(SettingsManager::getInstance().getBool("IRStripPreDelay", false));
+        break;
+    case OptionsFlightRecorder:
+        result.setInfo("Flight Recorder",
+                       "Time every audio callback and save the last few seconds to a file when one glitches.",
+                       optionsCategory, 0);
+        result.setTicked(FlightRecorder::getInstance().isEnabled());
+        break;
+    case OptionsPatchSwitchTiming:
+        result.setInfo("Time Patch Switches",
+                       "Time every patch switch from Program Change to audible output, and log each one.",
+                       optionsCategory, 0);
+        result.setTicked(PatchSwitchTimer::isEnabled());
+        break;
     }
 }
 
@@ -1535,6 +1617,55 @@ bool MainPanel::perform(const InvocationInfo& info)
             L"Event Log", dlg, 0, ColourScheme::getInstance().colours["Window Background"], true, true, false, true);
     }
     break;
+    case HelpDspProfiler:
+    {
+        // Profiling (and the load badges on the nodes) runs while this is open
+        DspProfilerDisplay* dlg = new DspProfilerDisplay();
+
+        dlg->setSize(620, 400);
+
+        JuceHelperStuff::showNonModalDialog("DSP Profiler", dlg, 0,
+                                            ColourScheme::getInstance().colours["Window Background"], true, true);
+    }
+    break;
+    case HelpPerfTrace:
+    {
+        if (!PerfTrace::isEnabled())
+        {
+            PerfTrace::getInstance().start();
+            showToast("Recording performance trace");
+            break;
+        }
+
+        PerfTrace::getInstance().stop();
+        traceChooser = std::make_unique<FileChooser>(
+            "Save Performance Trace",
+            File::getSpecialLocation(File::userDocumentsDirectory).getChildFile("Pedalboard3 Trace.json"), "*.json");
+        traceChooser->launchAsync(FileBrowserComponent::saveMode | FileBrowserComponent::canSelectFiles |
+                                      FileBrowserComponent::warnAboutOverwriting,
+                                  [this](const FileChooser& chooser)
+                                  {
+                                      const File file = chooser.getResult();
+                                      if (file == File())
+                                          return;
+
+                                      if (PerfTrace::getInstance().exportChromeTrace(file))
+                                          showToast("Trace saved - open it in ui.perfetto.dev");
+                                      else
+                                          showToast("Could not save the trace");
+                                  });
+    }
+    break;
+    case HelpPatchSwitchTiming:
+    {
+        PatchSwitchTimingDisplay* dlg = new PatchSwitchTimingDisplay();
+
+        dlg->setSize(560, 460);
+
+        JuceHelperStuff::showNonModalDialog("Patch Switch Timing", dlg, 0,
+                                            ColourScheme::getInstance().colours["Window Background"], true, true);
+    }
+    break;
     case PatchNextPatch:
         if (patchComboBox->getSelectedItemIndex() < (patchComboBox->getNumItems() - 2))
             patchComboBox->setSelectedItemIndex(patchComboBox->getSelectedItemIndex() + 1);
@@ -1622,6 +1753,38 @@ bool MainPanel::perform(const InvocationInfo& info)
         showToast(!current ? "Snap to Grid enabled" : "Snap to Grid disabled");
     }
     break;
+    case OptionsMinimumPhaseIRs:
+    {
+        bool current = SettingsManager::getInstance().getBool("IRMinimumPhase", false);
+        SettingsManager::getInstance().setValue("IRMinimumPhase", !current);
+        reloadImpulseResponses();
+        showToast(!current ? "Minimum-phase IRs enabled" : "Minimum-phase IRs disabled");
+    }
+    break;
+    case OptionsStripIRPreDelay:
+    {
+        bool current = SettingsManager::getInstance().getBool("IRStripPreDelay", false);
+        SettingsManager::getInstance().setValue("IRStripPreDelay", !current);
+        reloadImpulseResponses();
+        showToast(!current ? "IR pre-delay stripping enabled" : "IR pre-delay stripping disabled");
+    }
+    break;
+    case OptionsFlightRecorder:
+    {
+        bool current = FlightRecorder::getInstance().isEnabled();
+        SettingsManager::getInstance().setValue("FlightRecorder", !current);
+        FlightRecorder::getInstance().setEnabled(!current);
+        showToast(!current ? "Flight Recorder enabled" : "Flight Recorder disabled");
+    }
+    break;
+    case OptionsPatchSwitchTiming:
+    {
+        bool current = PatchSwitchTimer::isEnabled();
+        SettingsManager::getInstance().setValue("PatchSwitchTiming", !current);
+        PatchSwitchTimer::getInstance().setEnabled(!current);
+        showToast(!current ? "Patch switch timing enabled" : "Patch switch timing disabled");
+    }
+    break;
     }
     return true;
 }
@@ -1644,9 +1807,35 @@ void MainPanel::updateTempoFromOtherThread(double tempo)
     midiAppFifo.writeTempo(tempo);
 }
 
+//------------------------------------------------------------------------------
+void MainPanel::reloadImpulseResponses()
+{
+    // Effect racks have their own graphs, so walk into those too
+    std::function<void(AudioProcessorGraph&)> reloadIn = [&](AudioProcessorGraph& graph)
+    {
+        for (auto* node : graph.getNodes())
+        {
+            auto* processor = node->getProcessor();
+            if (auto* bypassable = dynamic_cast<BypassableInstance*>(processor))
+                processor = bypassable->getPlugin();
+
+            if (auto* irLoader = dynamic_cast<IRLoaderProcessor*>(processor))
+                irLoader->reloadIRs();
+            else if (auto* nam = dynamic_cast<NAMProcessor*>(processor))
+                nam->reloadIRs();
+            else if (auto* subGraph = dynamic_cast<SubGraphProcessor*>(processor))
+                reloadIn(subGraph->getInternalGraph());
+        }
+    };
+
+    reloadIn(signalPath.getGraph());
+}
+
 //------------------------------------------------------------------------------
 void MainPanel::switchPatch(int newPatch, bool savePrev, bool reloadPatch)
 {
+    const PerfTrace::Zone zone("MainPanel::switchPatch", "patch");
+
     if (doNotSaveNextPatch)
     {
         savePrev = false;
@@ -1657,6 +1846,10 @@ void MainPanel::switchPatch(int newPatch, bool savePrev, bool reloadPatch)
     {
         PluginField* field = ((PluginField*)viewport->getViewedComponent());
         XmlElement* patch = 0;
+        auto& switchTimer = PatchSwitchTimer::getInstance();
+
+        if ((newPatch > -1) && (newPatch < patches.size()))
+            switchTimer.beginSwitch(newPatch);
 
         if (savePrev)
         {
@@ -1674,6 +1867,7 @@ void MainPanel::switchPatch(int newPatch, bool savePrev, bool reloadPatch)
                 patches.set(currentPatch, patch);
                 updatePluginPoolDefinition(currentPatch, patch);
             }
+            switchTimer.markStage(PatchSwitchTimer::SavePrevious);
 
             // Load new patch if it exists.
             currentPatch = newPatch;
@@ -1703,10 +1897,16 @@ void MainPanel::switchPatch(int newPatch, bool savePrev, bool reloadPatch)
                 tempoEditor->setText("120.00");
             }
             lastTempoTicks = 0;
+
+            FlightRecorder::getInstance().setActivePatch(currentPatch, patch->getStringAttribute("name"));
         }
 
         // Update Stage View
         updateStageView();
+
+        // The rest happens on the audio thread, up to the first audible block
+        switchTimer.markStage(PatchSwitchTimer::RebuildComponents);
+        switchTimer.endSwitch();
     }
 
     PluginPoolManager::getInstance().setCurrentPosition(currentPatch);
@@ -1730,6 +1930,19 @@ void MainPanel::timerCallback(int timerId)
             }
         }
 
+        // Announce each glitch the flight recorder has saved
+        {
+            auto& recorder = FlightRecorder::getInstance();
+            if (recorder.getNumDumps() != lastFlightRecorderDumps)
+            {
+                lastFlightRecorderDumps = recorder.getNumDumps();
+                showToast("Audio glitch recorded to " + recorder.getLastDump().getFileName());
+            }
+        }
+
+        // Finish timing the last patch switch once its audio has come through
+        PatchSwitchTimer::getInstance().update();
+
         // Sync master gain sliders from MasterGainState (when not being dragged)
         {
             auto& gs = MasterGainState::getInstance();
@@ -26,11 +26,14 @@
 #include "ColourScheme.h"
 #include "DeviceMeterTap.h"
 #include "FilterGraph.h"
+#include "FlightRecorder.h"
 #include "FontManager.h"
 #include "MasterBusProcessor.h"
 #include "MasterGainState.h"
 #include "MidiAppFifo.h"
 #include "NiallsSocketLib/UDPSocket.h"
+#include "PatchSwitchTimer.h"
+#include "PerfTrace.h"
 #include "PluginField.h"
 
 #include <JuceHeader.h>
@@ -44,7 +47,8 @@ class TunerProcessor;
 //==============================================================================
 /// AudioProcessorPlayer subclass that applies master gain and taps device
 /// buffers for VU metering. All operations are RT-safe: pre-allocated buffers,
-/// atomic reads, no allocations or locks in the audio callback.
+/// atomic reads, no allocations or locks in the audio callback. Every callback
+/// is timed against its deadline by the FlightRecorder.
 class MeteringProcessorPlayer : public AudioProcessorPlayer
 {
   public:
@@ -66,13 +70,27 @@ class MeteringProcessorPlayer : public AudioProcessorPlayer
 
             // Initialize gain smoothing at device sample rate
             gainState.prepareSmoothing(device->getCurrentSampleRate());
+
+            FlightRecorder::getInstance().prepare(device->getCurrentSampleRate(),
+                                                  device->getCurrentBufferSizeSamples());
         }
     }
 
+    void audioDeviceStopped() override
+    {
+        FlightRecorder::getInstance().release();
+        AudioProcessorPlayer::audioDeviceStopped();
+    }
+
     void audioDeviceIOCallbackWithContext(const float* const* inputChannelData, int numInputChannels,
                                           float* const* outputChannelData, int numOutputChannels, int numSamples,
                                           const AudioIODeviceCallbackContext& context) override
     {
+        auto& recorder = FlightRecorder::getInstance();
+        const auto callbackStart = recorder.beginCallback();
+        const PerfTrace::Zone zone("Audio callback", "audio");
+        PerfTrace::nameThread("Audio");
+
         auto& gainState = MasterGainState::getInstance();
 
         // Update smoothed gain targets from atomic dB values (once per block)
@@ -119,8 +137,11 @@ class MeteringProcessorPlayer : public AudioProcessorPlayer
         }
 
         // Process graph with (possibly gained) input
-        AudioProcessorPlayer::audioDeviceIOCallbackWithContext(actualInput, numInputChannels, outputChannelData,
-                                                               numOutputChannels, numSamples, context);
+        {
+            const PerfTrace::Zone graphZone("Graph", "audio");
+            AudioProcessorPlayer::audioDeviceIOCallbackWithContext(actualInput, numInputChannels, outputChannelData,
+                                                                   numOutputChannels, numSamples, context);
+        }
 
         // Process master bus insert rack (between graph output and output gain)
         // Only when user has inserted plugins - empty rack is pure passthrough
@@ -135,6 +156,7 @@ class MeteringProcessorPlayer : public AudioProcessorPlayer
                     masterBusBuffer.copyFrom(ch, 0, outputChannelData[ch], numSamples);
 
                 MidiBuffer emptyMidi;
+                const PerfTrace::Zone masterBusZone("Master bus", "audio");
                 masterBus.processBlock(masterBusBuffer, emptyMidi);
 
                 // Copy processed data back to output
@@ -169,6 +191,11 @@ class MeteringProcessorPlayer : public AudioProcessorPlayer
             limiter->updateInputLevelsFromDevice(actualInput, numInputChannels, numSamples);
             limiter->updateOutputLevelsFromDevice(outputChannelData, numOutputChannels, numSamples);
         }
+
+        // Ends a patch switch's timing once its audio reaches the device
+        PatchSwitchTimer::getInstance().processOutput(outputChannelData, numOutputChannels, numSamples);
+
+        recorder.endCallback(callbackStart, numSamples);
     }
 
   private:
@@ -360,7 +387,14 @@ class MainPanel : public Component,
         EditPanic,
         ToggleStageMode,
         OptionsPluginBlacklist,
-        OptionsSnapToGrid
+        OptionsSnapToGrid,
+        OptionsMinimumPhaseIRs,
+        HelpDspProfiler,
+        OptionsFlightRecorder,
+        HelpPerfTrace,
+        OptionsPatchSwitchTiming,
+        HelpPatchSwitchTiming,
+        OptionsStripIRPreDelay
     };
 
     //[/UserMethods]
@@ -385,6 +419,13 @@ class MainPanel : public Component,
      */
     void switchPatch(int newPatch, bool savePrev = true, bool reloadPatch = false);
 
+    ///	Reloads the IRs of every IR Loader and NAM processor in the patch.
+    /*!
+            Called when an IR analysis option changes, so it applies to the
+            cabs already loaded rather than only to the next load.
+     */
+    void reloadImpulseResponses();
+
     ///	The IDs of the three timers.
     enum
     {
@@ -455,6 +496,12 @@ class MainPanel : public Component,
     ///	Used for tap tempo when the user does it via keyboard.
     int64 lastTempoTicks;
 
+    ///	FlightRecorder dumps already announced, so each new one gets a toast.
+    int lastFlightRecorderDumps = 0;
+
+    ///	Asks where to save a performance trace when recording stops.
+    std::unique_ptr<FileChooser> traceChooser;
+
     ///	Used to pass messages from the audio thread to the message thread.
     MidiAppFifo midiAppFifo;
 
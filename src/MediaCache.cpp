@@ -0,0 +1,359 @@
+/*
+  ==============================================================================
+
+    MediaCache.cpp
+    Bounded cache of media prefetched for the setlist's preload window
+
+  ==============================================================================
+*/
+
+#include "MediaCache.h"
+
+#include "AudioSingletons.h"
+#include "DiskIOScheduler.h"
+
+#include <spdlog/spdlog.h>
+
+namespace
+{
+constexpr int warmChunkBytes = 1024 * 1024; // Per time slice, so streams sharing the thread aren't held up
+constexpr int busyWaitMs = 10;
+constexpr int idleWaitMs = 100;
+} // namespace
+
+//==============================================================================
+MediaCache& MediaCache::getInstance()
+{
+    static MediaCache instance;
+    return instance;
+}
+
+MediaCache::MediaCache()
+{
+    DiskIOScheduler::getInstance().getThread(DiskIOScheduler::Queue::Read).addTimeSliceClient(this);
+}
+
+MediaCache::~MediaCache()
+{
+    DiskIOScheduler::getInstance().getThread(DiskIOScheduler::Queue::Read).removeTimeSliceClient(this);
+}
+
+//==============================================================================
+void MediaCache::setSampleRate(double newSampleRate)
+{
+    const juce::ScopedLock sl(lock);
+    sampleRate = newSampleRate;
+}
+
+double MediaCache::getSampleRate() const
+{
+    const juce::ScopedLock sl(lock);
+    return sampleRate;
+}
+
+void MediaCache::setMemoryLimit(size_t bytes)
+{
+    const juce::ScopedLock sl(lock);
+    memoryLimit = bytes;
+    makeRoomFor(0);
+}
+
+size_t MediaCache::getMemoryLimit() const
+{
+    const juce::ScopedLock sl(lock);
+    return memoryLimit;
+}
+
+size_t MediaCache::getMemoryUsage() const
+{
+    const juce::ScopedLock sl(lock);
+    return memoryUsage;
+}
+
+//==============================================================================
+void MediaCache::setWindow(const std::vector<MediaReference>& media)
+{
+    {
+        const juce::ScopedLock sl(lock);
+        window = media;
+        queue = media;
+    }
+
+    spdlog::debug("[MediaCache] Window set to {} files", media.size());
+    DiskIOScheduler::getInstance().getThread(DiskIOScheduler::Queue::Read).moveToFrontOfQueue(this);
+}
+
+bool MediaCache::isBusy() const
+{
+    const juce::ScopedLock sl(lock);
+    return !queue.empty() || jobRunning;
+}
+
+void MediaCache::shutdown()
+{
+    // Waits out a slice in progress, so nothing is reading after this
+    DiskIOScheduler::getInstance().getThread(DiskIOScheduler::Queue::Read).removeTimeSliceClient(this);
+
+    {
+        const juce::ScopedLock sl(lock);
+        queue.clear();
+        jobRunning = false;
+    }
+    warmStream.reset();
+    decoder.clear();
+}
+
+void MediaCache::clear()
+{
+    // Outside our lock: the decoder calls addAudio() while holding its own
+    decoder.clear();
+
+    const juce::ScopedLock sl(lock);
+    entries.clear();
+    window.clear();
+    queue.clear();
+    memoryUsage = 0;
+}
+
+//==============================================================================
+std::shared_ptr<const juce::AudioBuffer<float>> MediaCache::getAudio(const juce::File& file, double rate)
+{
+    const juce::ScopedLock sl(lock);
+    auto* entry = find(keyFor(file, rate), file);
+    return entry != nullptr ? entry->audio : nullptr;
+}
+
+void MediaCache::addAudio(const juce::File& file, double rate, std::shared_ptr<const juce::AudioBuffer<float>> audio)
+{
+    if (audio == nullptr)
+        return;
+
+    Entry entry;
+    entry.audio = std::move(audio);
+    entry.modified = file.getLastModificationTime();
+    entry.fileSize = file.getSize();
+    entry.bytes = static_cast<size_t>(entry.audio->getNumChannels()) *
+                  static_cast<size_t>(entry.audio->getNumSamples()) * sizeof(float);
+
+    const juce::ScopedLock sl(lock);
+    const auto key = keyFor(file, rate);
+    erase(key);
+
+    if (makeRoomFor(entry.bytes))
+        insert(key, std::move(entry));
+    else
+        spdlog::debug("[MediaCache] No room to keep {}", file.getFileName().toStdString());
+}
+
+std::shared_ptr<const juce::MemoryBlock> MediaCache::getFileData(const juce::File& file)
+{
+    const juce::ScopedLock sl(lock);
+    auto* entry = find(keyFor(file, 0.0), file);
+    return entry != nullptr ? entry->data : nullptr;
+}
+
+//==============================================================================
+int MediaCache::useTimeSlice()
+{
+    // The finished audio is in the cache now; don't hold a second reference
+    if (decoder.isLoading())
+        return busyWaitMs;
+    if (decoder.getAudio() != nullptr)
+        decoder.clear();
+
+    // Prefetching can always wait for a stream that's running low
+    const bool throttled = DiskIOScheduler::getInstance().isThrottlingThumbnails();
+
+    if (warmStream != nullptr)
+    {
+        if (throttled)
+            return busyWaitMs;
+
+        warmNextChunk();
+        return 0;
+    }
+
+    if (throttled)
+        return idleWaitMs;
+
+    return startNextJob() ? 0 : idleWaitMs;
+}
+
+bool MediaCache::startNextJob()
+{
+    MediaReference job;
+    double rate = 0.0;
+    {
+        const juce::ScopedLock sl(lock);
+        if (queue.empty())
+        {
+            jobRunning = false;
+            return false;
+        }
+
+        job = queue.front();
+        queue.erase(queue.begin());
+        jobRunning = true;
+        rate = sampleRate;
+    }
+
+    if (!job.file.existsAsFile())
+        return true;
+
+    switch (job.kind)
+    {
+    case MediaReference::Kind::PreloadedAudio:
+    {
+        // Nothing to decode for until a player has told us the playback rate
+        if (rate <= 0.0 || getAudio(job.file, rate) != nullptr)
+            return true;
+
+        std::unique_ptr<juce::AudioFormatReader> reader(
+            AudioFormatManagerSingleton::getInstance().createReaderFor(job.file));
+        if (reader == nullptr || reader->sampleRate <= 0.0)
+            return true;
+
+        const double seconds = static_cast<double>(reader->lengthInSamples) / reader->sampleRate;
+        if (seconds > AudioPreloader::maxPreloadSeconds)
+            return true;
+
+        const auto bytes = static_cast<size_t>(seconds * rate) * reader->numChannels * sizeof(float);
+        {
+            const juce::ScopedLock sl(lock);
+            if (!makeRoomFor(bytes))
+            {
+                spdlog::warn("[MediaCache] Not enough room to prefetch {}", job.file.getFileName().toStdString());
+                return true;
+            }
+        }
+
+        spdlog::info("[MediaCache] Prefetching {}", job.file.getFileName().toStdString());
+        decoder.load(job.file, rate);
+        return true;
+    }
+
+    case MediaReference::Kind::MidiFile:
+    {
+        if (getFileData(job.file) != nullptr || job.file.getSize() > maxMidiFileBytes)
+            return true;
+
+        auto data = std::make_shared<juce::MemoryBlock>();
+        if (!job.file.loadFileAsData(*data))
+            return true;
+
+        Entry entry;
+        entry.modified = job.file.getLastModificationTime();
+        entry.fileSize = job.file.getSize();
+        entry.bytes = data->getSize();
+        entry.data = std::move(data);
+
+        const juce::ScopedLock sl(lock);
+        if (makeRoomFor(entry.bytes))
+            insert(keyFor(job.file, 0.0), std::move(entry));
+        return true;
+    }
+
+    case MediaReference::Kind::StreamedAudio:
+    {
+        warmStream = std::make_unique<juce::FileInputStream>(job.file);
+        if (!warmStream->openedOk())
+        {
+            warmStream.reset();
+            return true;
+        }
+
+        warmRemaining = juce::jmin(warmBytes, job.file.getSize());
+        return true;
+    }
+    }
+
+    return true;
+}
+
+void MediaCache::warmNextChunk()
+{
+    if (warmBuffer.getData() == nullptr)
+        warmBuffer.malloc(warmChunkBytes);
+
+    const int toRead = static_cast<int>(juce::jmin<juce::int64>(warmChunkBytes, warmRemaining));
+    const int read = toRead > 0 ? warmStream->read(warmBuffer.getData(), toRead) : 0;
+    warmRemaining -= read;
+
+    if (read <= 0 || warmRemaining <= 0)
+        warmStream.reset();
+}
+
+//==============================================================================
+juce::String MediaCache::keyFor(const juce::File& file, double rate)
+{
+    return file.getFullPathName() + "|" + juce::String(juce::roundToInt(rate));
+}
+
+bool MediaCache::isPinned(const juce::String& key) const
+{
+    for (const auto& media : window)
+    {
+        if (media.kind == MediaReference::Kind::PreloadedAudio && keyFor(media.file, sampleRate) == key)
+            return true;
+        if (media.kind == MediaReference::Kind::MidiFile && keyFor(media.file, 0.0) == key)
+            return true;
+    }
+    return false;
+}
+
+bool MediaCache::makeRoomFor(size_t bytes)
+{
+    if (bytes > memoryLimit)
+        return false;
+
+    while (memoryUsage + bytes > memoryLimit)
+    {
+        auto oldest = entries.end();
+        for (auto it = entries.begin(); it != entries.end(); ++it)
+        {
+            if (!isPinned(it->first) && (oldest == entries.end() || it->second.lastUsed < oldest->second.lastUsed))
+                oldest = it;
+        }
+
+        // Everything left belongs to the window
+        if (oldest == entries.end())
+            return false;
+
+        spdlog::debug("[MediaCache] Evicting {}", oldest->first.toStdString());
+        erase(oldest->first);
+    }
+    return true;
+}
+
+void MediaCache::insert(const juce::String& key, Entry entry)
+{
+    entry.lastUsed = ++useCounter;
+    memoryUsage += entry.bytes;
+    entries[key] = std::move(entry);
+}
+
+void MediaCache::erase(const juce::String& key)
+{
+    auto it = entries.find(key);
+    if (it == entries.end())
+        return;
+
+    memoryUsage -= it->second.bytes;
+    entries.erase(it);
+}
+
+MediaCache::Entry* MediaCache::find(const juce::String& key, const juce::File& file)
+{
+    auto it = entries.find(key);
+    if (it == entries.end())
+        return nullptr;
+
+    if (file.getLastModificationTime() != it->second.modified || file.getSize() != it->second.fileSize)
+    {
+        erase(key);
+        return nullptr;
+    }
+
+    it->second.lastUsed = ++useCounter;
+    return &it->second;
+}
@@ -0,0 +1,154 @@
+/*
+  ==============================================================================
+
+    MediaCache.h
+    Bounded cache of media prefetched for the setlist's preload window
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "PreloadedAudio.h"
+
+#include <juce_audio_formats/juce_audio_formats.h>
+
+#include <map>
+#include <memory>
+#include <vector>
+
+//==============================================================================
+/** A media file a patch will open when it loads, and how it will open it. */
+struct MediaReference
+{
+    enum class Kind
+    {
+        PreloadedAudio, // File Player in preload mode: decoded into RAM
+        StreamedAudio,  // File Player streaming from disk, or a looper file
+        MidiFile        // MIDI File Player: parsed from the whole file
+    };
+
+    juce::File file;
+    Kind kind = Kind::StreamedAudio;
+
+    bool operator==(const MediaReference& other) const { return file == other.file && kind == other.kind; }
+};
+
+//==============================================================================
+/**
+    Keeps the media of the patches around the current setlist position ready
+    before they're needed.
+
+    PluginPoolManager hands over the media referenced by its preload window
+    whenever the window slides. Audio for preloading File Players is decoded
+    ahead of time at the playback rate, so AudioPreloader finds it here and
+    the backing track can start the moment its patch loads. MIDI files are
+    held as raw bytes. Streamed files (which are read from disk by the audio
+    stream anyway) just have their start read through once, so the OS has
+    them cached.
+
+    All work runs in slices on the DiskIOScheduler read queue and backs off
+    while any real-time stream is starved. Entries for the current window are
+    pinned; everything else is evicted, least recently used first, once the
+    memory limit is reached.
+*/
+class MediaCache : private juce::TimeSliceClient
+{
+  public:
+    static constexpr size_t defaultMemoryLimit = static_cast<size_t>(1024) * 1024 * 1024;
+    /// Bytes of a streamed file read ahead to warm the OS cache
+    static constexpr juce::int64 warmBytes = 32 * 1024 * 1024;
+    /// Larger MIDI files are left to be read when their patch loads
+    static constexpr juce::int64 maxMidiFileBytes = 16 * 1024 * 1024;
+
+    static MediaCache& getInstance();
+
+    //==========================================================================
+    // Configuration
+
+    /// The rate audio is decoded for. AudioPreloader sets this on every load,
+    /// so it follows the device.
+    void setSampleRate(double sampleRate);
+    double getSampleRate() const;
+
+    void setMemoryLimit(size_t bytes);
+    size_t getMemoryLimit() const;
+    /// Bytes of decoded audio and MIDI data held
+    size_t getMemoryUsage() const;
+
+    //==========================================================================
+    // Prefetching
+
+    /// Replaces the pinned window with media, in priority order, and queues
+    /// whatever isn't already cached. Anything no longer in the window
+    /// becomes evictable.
+    void setWindow(const std::vector<MediaReference>& media);
+
+    /// True while queued prefetches are outstanding
+    bool isBusy() const;
+
+    /// Drops every entry and any queued work
+    void clear();
+
+    /// Stops prefetching for good: drops queued work, cancels the decode and
+    /// leaves the read queue. Call at exit before the AudioFormatManager
+    /// singleton is deleted, as both read through it.
+    void shutdown();
+
+    //==========================================================================
+    // Lookup (any thread)
+
+    /// Decoded audio for file at sampleRate, or nullptr
+    std::shared_ptr<const juce::AudioBuffer<float>> getAudio(const juce::File& file, double sampleRate);
+    /// Adds decoded audio; called by AudioPreloader when a decode finishes
+    void addAudio(const juce::File& file, double sampleRate, std::shared_ptr<const juce::AudioBuffer<float>> audio);
+
+    /// The whole of a prefetched MIDI file, or nullptr
+    std::shared_ptr<const juce::MemoryBlock> getFileData(const juce::File& file);
+
+  private:
+    MediaCache();
+    ~MediaCache() override;
+
+    struct Entry
+    {
+        std::shared_ptr<const juce::AudioBuffer<float>> audio;
+        std::shared_ptr<const juce::MemoryBlock> data;
+        juce::Time modified; // Of the file, so edits on disk aren't masked
+        juce::int64 fileSize = 0;
+        size_t bytes = 0;
+        juce::uint32 lastUsed = 0;
+    };
+
+    int useTimeSlice() override;
+    /// Starts the next queued job, or returns false if there's nothing to do
+    bool startNextJob();
+    /// Reads the next chunk of the file being warmed
+    void warmNextChunk();
+
+    static juce::String keyFor(const juce::File& file, double sampleRate);
+    bool isPinned(const juce::String& key) const;
+    /// Evicts unpinned entries until bytes more would fit; false if they can't
+    bool makeRoomFor(size_t bytes);
+    void insert(const juce::String& key, Entry entry);
+    void erase(const juce::String& key);
+    /// Returns the live entry for key, dropping it if its file has changed
+    Entry* find(const juce::String& key, const juce::File& file);
+
+    AudioPreloader decoder;
+    std::unique_ptr<juce::FileInputStream> warmStream;
+    juce::HeapBlock<char> warmBuffer;
+    juce::int64 warmRemaining = 0;
+
+    mutable juce::CriticalSection lock;
+    std::map<juce::String, Entry> entries;
+    std::vector<MediaReference> window;
+    std::vector<MediaReference> queue;
+    double sampleRate = 0.0;
+    size_t memoryLimit = defaultMemoryLimit;
+    size_t memoryUsage = 0;
+    juce::uint32 useCounter = 0;
+    bool jobRunning = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MediaCache)
+};
@@ -19,6 +19,7 @@
 
 #include "MidiFilePlayer.h"
 
+#include "MediaCache.h"
 #include "MidiFilePlayerControl.h"
 
 #include <spdlog/spdlog.h>
@@ -42,12 +43,18 @@ bool MidiFilePlayerProcessor::setFile(const File& file)
     if (!file.existsAsFile())
         return false;
 
-    FileInputStream stream(file);
-    if (!stream.openedOk())
+    // Prefetched along with the setlist's preload window, if it's coming up
+    std::unique_ptr<InputStream> stream;
+    if (auto data = MediaCache::getInstance().getFileData(file))
+        stream = std::make_unique<MemoryInputStream>(*data, true);
+    else
+        stream = file.createInputStream();
+
+    if (stream == nullptr)
         return false;
 
     MidiFile midi;
-    if (!midi.readFrom(stream))
+    if (!midi.readFrom(*stream))
     {
         spdlog::error("[MidiFilePlayer] Failed to parse MIDI file: {}", file.getFullPathName().toStdString());
         return false;
@@ -20,8 +20,10 @@
 
 #include "MidiMappingManager.h"
 
+#include "FlightRecorder.h"
 #include "LogFile.h"
 #include "MainPanel.h"
+#include "PatchSwitchTimer.h"
 #include "SettingsManager.h"
 
 #include <spdlog/spdlog.h>
@@ -240,6 +242,9 @@ void MidiMappingManager::midiCcReceived(const MidiMessage& message, double secon
         int value = message.getControllerValue();
         int messageChan = message.getChannel();
 
+        FlightRecorder::getInstance().recordEvent(FlightRecorder::EventSource::MidiCc, messageChan, cc,
+                                                  static_cast<float>(value));
+
         {
             MidiLearnCallback* cb = midiLearnCallback.load();
             if (cb)
@@ -313,6 +318,9 @@ void MidiMappingManager::midiCcReceived(const MidiMessage& message, double secon
     }
     else if (message.isProgramChange())
     {
+        FlightRecorder::getInstance().recordEvent(FlightRecorder::EventSource::ProgramChange, message.getChannel(),
+                                                  message.getProgramChangeNumber(), 0.0f);
+
         if (SettingsManager::getInstance().getBool("midiProgramChange", false))
         {
             int newPatch;
@@ -321,7 +329,11 @@ void MidiMappingManager::midiCcReceived(const MidiMessage& message, double secon
             newPatch = message.getProgramChangeNumber();
 
             if (panel)
+            {
+                // Arrival as seen by the graph, i.e. to the audio block it came in with
+                PatchSwitchTimer::programChangeReceived();
                 panel->switchPatchFromProgramChange(newPatch);
+            }
         }
     }
 }
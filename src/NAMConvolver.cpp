@@ -10,13 +10,12 @@
 */
 
 #include "NAMConvolver.h"
-#include <juce_dsp/juce_dsp.h>
+#include "PartitionedConvolver.h"
 
 //==============================================================================
 struct ConvolverImpl
 {
-    juce::dsp::Convolution convolution;
-    juce::dsp::ProcessSpec spec;
+    PartitionedConvolver convolution;
 };
 
 //==============================================================================
@@ -29,26 +28,59 @@ NAMConvolver::~NAMConvolver() = default;
 
 void NAMConvolver::prepare(double sampleRate, int blockSize)
 {
-    impl->spec.sampleRate = sampleRate;
-    impl->spec.maximumBlockSize = static_cast<juce::uint32>(blockSize);
-    impl->spec.numChannels = 2;
-    impl->convolution.prepare(impl->spec);
+    impl->convolution.prepare(sampleRate, blockSize);
 }
 
-void NAMConvolver::loadIR(const juce::File& file)
+bool NAMConvolver::loadIR(const juce::File& file)
 {
-    impl->convolution.loadImpulseResponse(file, juce::dsp::Convolution::Stereo::yes,
-                                          juce::dsp::Convolution::Trim::yes, 0);
+    return impl->convolution.loadImpulseResponse(file);
+}
+
+bool NAMConvolver::loadIRs(const juce::File& fileA, const juce::File& fileB)
+{
+    return impl->convolution.loadImpulseResponses(fileA, fileB);
+}
+
+void NAMConvolver::setBlend(float blend)
+{
+    impl->convolution.setBlend(blend);
+}
+
+void NAMConvolver::setMinimumPhase(bool enabled)
+{
+    auto options = impl->convolution.getAnalysisOptions();
+    options.minimumPhase = enabled;
+    impl->convolution.setAnalysisOptions(options);
+}
+
+void NAMConvolver::setStripPreDelay(bool enabled)
+{
+    auto options = impl->convolution.getAnalysisOptions();
+    options.stripLeadingSilence = enabled;
+    impl->convolution.setAnalysisOptions(options);
 }
 
 void NAMConvolver::process(juce::AudioBuffer<float>& buffer)
 {
-    juce::dsp::AudioBlock<float> block(buffer);
-    juce::dsp::ProcessContextReplacing<float> context(block);
-    impl->convolution.process(context);
+    impl->convolution.process(buffer);
 }
 
 void NAMConvolver::reset()
 {
     impl->convolution.reset();
 }
+
+void NAMConvolver::clear()
+{
+    impl->convolution.clear();
+}
+
+bool NAMConvolver::isLoaded() const
+{
+    return impl->convolution.isLoaded();
+}
+
+void NAMConvolver::setNonRealtime(bool shouldWaitForWorker)
+{
+    impl->convolution.setNonRealtime(shouldWaitForWorker);
+}
@@ -18,9 +18,10 @@
 struct ConvolverImpl;
 
 /**
-    Wrapper for juce::dsp::Convolution that isolates it from AudioDSPTools
-    namespace conflicts. The dsp namespace from AudioDSPTools conflicts with
-    juce::dsp, so we keep convolution in a separate compilation unit.
+    Wrapper for the partitioned convolution engine that isolates it from
+    AudioDSPTools namespace conflicts. The dsp namespace from AudioDSPTools
+    conflicts with juce::dsp, so we keep convolution in a separate compilation
+    unit.
 */
 class NAMConvolver
 {
@@ -29,9 +30,21 @@ public:
     ~NAMConvolver();
 
     void prepare(double sampleRate, int blockSize);
-    void loadIR(const juce::File& file);
+    bool loadIR(const juce::File& file);
+    /// Loads two IRs blended with setBlend (0 = fileA, 1 = fileB)
+    bool loadIRs(const juce::File& fileA, const juce::File& fileB);
+    void setBlend(float blend);
+    /// Converts IRs to minimum phase from the next load on
+    void setMinimumPhase(bool enabled);
+    /// Strips IR pre-delay from the next load on
+    void setStripPreDelay(bool enabled);
     void process(juce::AudioBuffer<float>& buffer);
     void reset();
+    void clear();
+    /// True once a kernel is playing (a load finishes in the background)
+    bool isLoaded() const;
+    /// Offline rendering: waits for the convolution worker instead of glitching
+    void setNonRealtime(bool shouldWaitForWorker);
 
 private:
     std::unique_ptr<ConvolverImpl> impl;
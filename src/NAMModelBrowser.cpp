@@ -17,9 +17,34 @@
 
 #include <melatonin_blur/melatonin_blur.h>
 #include <nlohmann/json.hpp>
-#include <set>
 #include <spdlog/spdlog.h>
 
+namespace
+{
+/// The folders the browsers start in; these stay catalogued whatever the user browses to
+bool isLibraryFolder(const File& directory)
+{
+    const auto pedalboard3Dir = File::getSpecialLocation(File::userDocumentsDirectory).getChildFile("Pedalboard3");
+    return directory == pedalboard3Dir.getChildFile("NAM Models") || directory == pedalboard3Dir.getChildFile("IR");
+}
+
+/// Stops the catalogue following a folder the user has browsed away from, so
+/// every folder ever opened doesn't stay a root that's rescanned and saved
+void releaseDirectory(const File& directory, std::initializer_list<File> stillShown = {})
+{
+    if (directory == File() || isLibraryFolder(directory))
+        return;
+
+    for (const auto& shown : stillShown)
+    {
+        if (shown == directory)
+            return;
+    }
+
+    LibraryWatcher::getInstance().unwatchDirectory(directory);
+}
+} // namespace
+
 //==============================================================================
 // Custom LookAndFeel for browser windows — rounded corners + dark title bar
 //==============================================================================
@@ -865,12 +890,18 @@ NAMModelBrowserComponent::NAMModelBrowserComponent(NAMProcessor* processor, std:
 
     setSize(700, 500);
 
+    LibraryWatcher::getInstance().addListener(this);
+
     // Auto-scan on creation
     scanDirectory(currentDirectory);
 }
 
 NAMModelBrowserComponent::~NAMModelBrowserComponent()
 {
+    LibraryWatcher::getInstance().removeListener(this);
+    releaseDirectory(watchedModelDirectory);
+    releaseDirectory(watchedIRDirectory, {watchedModelDirectory});
+
     // Clear custom LookAndFeel before destruction
     localTabButton->setLookAndFeel(nullptr);
     onlineTabButton->setLookAndFeel(nullptr);
@@ -1408,10 +1439,16 @@ void NAMModelBrowserComponent::buttonClicked(Button* button)
     }
     else if (button == refreshButton.get())
     {
+        auto& watcher = LibraryWatcher::getInstance();
         if (currentTab == 0)
-            scanDirectory(currentDirectory);
+        {
+            watcher.rescan(currentDirectory);
+        }
         else if (currentTab == 2)
-            scanIRDirectory(irDirectory);
+        {
+            watcher.rescan(irDirectory);
+            watcher.rescan(currentDirectory);
+        }
     }
     else if (button == browseFolderButton.get())
     {
@@ -1508,8 +1545,14 @@ void NAMModelBrowserComponent::deleteSelectedModel()
                                            }
                                        }
 
-                                       // Refresh the list
-                                       scanDirectory(currentDirectory);
+                                       // Drop it from the list now; the watcher's removal delta
+                                       // arrives later and is a no-op
+                                       const auto path = modelFile.getFullPathName().toStdString();
+                                       models.erase(std::remove_if(models.begin(), models.end(),
+                                                                   [&path](const NAMModelInfo& m)
+                                                                   { return m.filePath == path; }),
+                                                    models.end());
+                                       showModels();
                                    }
                                    else
                                    {
@@ -1570,36 +1613,37 @@ void NAMModelBrowserComponent::textEditorTextChanged(TextEditor& editor)
 
 void NAMModelBrowserComponent::scanDirectory(const File& directory)
 {
-    models.clear();
+    if (directory != watchedModelDirectory)
+    {
+        const auto previous = watchedModelDirectory;
+        watchedModelDirectory = directory;
+        releaseDirectory(previous, {watchedModelDirectory, watchedIRDirectory});
+    }
 
     if (!directory.isDirectory())
     {
+        models.clear();
         listModel.setModels(models);
         modelList->updateContent();
         return;
     }
 
-    // Show scanning indicator
-    isScanning = true;
-    statusLabel->setText("Scanning for NAM models...", dontSendNotification);
-    statusLabel->repaint();
-
-    spdlog::info("[NAMModelBrowser] Scanning directory: {}", directory.getFullPathName().toStdString());
+    // The watcher catalogue answers immediately; anything it hasn't seen yet
+    // arrives later through libraryChanged().
+    auto& watcher = LibraryWatcher::getInstance();
+    watcher.watchDirectory(directory);
+    models = watcher.getModels(directory);
 
-    // Find all .nam files recursively
-    auto namFiles = directory.findChildFiles(File::findFiles, true, "*.nam");
+    spdlog::info("[NAMModelBrowser] {} NAM models catalogued in {}", models.size(),
+                 directory.getFullPathName().toStdString());
 
-    for (const auto& file : namFiles)
-    {
-        NAMModelInfo info;
-        if (NAMCore::getModelInfo(file.getFullPathName().toStdString(), info))
-        {
-            models.push_back(std::move(info));
-        }
-    }
+    showModels();
+}
 
-    isScanning = false;
-    spdlog::info("[NAMModelBrowser] Found {} NAM models", models.size());
+void NAMModelBrowserComponent::showModels()
+{
+    const auto* selected = listModel.getModelAt(modelList->getSelectedRow());
+    const std::string selectedPath = selected != nullptr ? selected->filePath : std::string();
 
     // Sort by name
     std::sort(models.begin(), models.end(),
@@ -1609,25 +1653,90 @@ void NAMModelBrowserComponent::scanDirectory(const File& directory)
     modelList->updateContent();
     modelList->repaint();
 
-    // Update status bar with result
-    String statusText = currentDirectory.getFullPathName();
-    if (models.empty())
-        statusText += " - No models found";
-    else if (models.size() == 1)
-        statusText += " - 1 model";
-    else
-        statusText += " - " + String(models.size()) + " models";
-    statusLabel->setText(statusText, dontSendNotification);
+    // Update status bar and empty state (only while the Local tab owns them)
+    if (currentTab == 0)
+    {
+        String statusText = currentDirectory.getFullPathName();
+        if (models.empty() && LibraryWatcher::getInstance().isScanning())
+            statusText += " - Scanning for NAM models...";
+        else if (models.empty())
+            statusText += " - No models found";
+        else if (models.size() == 1)
+            statusText += " - 1 model";
+        else
+            statusText += " - " + String(models.size()) + " models";
+        statusLabel->setText(statusText, dontSendNotification);
 
-    // Update empty state visibility
-    bool hasModels = !models.empty();
-    modelList->setVisible(hasModels);
-    emptyStateLabel->setVisible(!hasModels);
+        bool hasModels = !models.empty();
+        modelList->setVisible(hasModels);
+        emptyStateLabel->setVisible(!hasModels);
+    }
+
+    // Restore the selection (deltas shouldn't make the details panel jump)
+    for (int i = 0; i < listModel.getFilteredCount(); ++i)
+    {
+        if (!selectedPath.empty() && listModel.getModelAt(i)->filePath == selectedPath)
+        {
+            modelList->selectRow(i, true, true);
+            updateDetailsPanel(listModel.getModelAt(i));
+            return;
+        }
+    }
 
-    // Clear details
+    modelList->deselectAllRows();
     updateDetailsPanel(nullptr);
 }
 
+void NAMModelBrowserComponent::libraryChanged(const std::vector<LibraryWatcher::Change>& changes)
+{
+    bool modelsChanged = false;
+    bool irFilesChanged = false;
+
+    for (const auto& change : changes)
+    {
+        if (change.kind == LibraryWatcher::EntryKind::Model)
+        {
+            if (!LibraryWatcher::isBelow(change.filePath, currentDirectory))
+                continue;
+
+            models.erase(std::remove_if(models.begin(), models.end(),
+                                        [&change](const NAMModelInfo& m) { return m.filePath == change.filePath; }),
+                         models.end());
+            if (change.type != LibraryWatcher::ChangeType::Removed)
+                models.push_back(change.model);
+            modelsChanged = true;
+        }
+        else
+        {
+            // IRs come from the IR folder and the NAM Models folder (TONE3000 downloads IRs there too)
+            if (!LibraryWatcher::isBelow(change.filePath, irDirectory) &&
+                !LibraryWatcher::isBelow(change.filePath, currentDirectory))
+                continue;
+
+            irFiles.erase(std::remove_if(irFiles.begin(), irFiles.end(),
+                                         [&change](const IRFileInfo& f) { return f.filePath == change.filePath; }),
+                          irFiles.end());
+            if (change.type != LibraryWatcher::ChangeType::Removed)
+                irFiles.push_back(change.ir);
+            irFilesChanged = true;
+        }
+    }
+
+    if (modelsChanged)
+        showModels();
+    if (irFilesChanged)
+        showIRFiles();
+}
+
+void NAMModelBrowserComponent::libraryScanFinished(const File& root)
+{
+    // Only the status text can be stale here ("Scanning..." on an empty list)
+    if (root == currentDirectory && models.empty())
+        showModels();
+    if ((root == irDirectory || root == currentDirectory) && irFiles.empty())
+        showIRFiles();
+}
+
 void NAMModelBrowserComponent::refreshModelList()
 {
     scanDirectory(currentDirectory);
@@ -1855,65 +1964,39 @@ void NAMModelBrowserComponent::mouseExit(const MouseEvent& /*event*/)
 
 void NAMModelBrowserComponent::scanIRDirectory(const File& directory)
 {
-    irFiles.clear();
-
-    // Show scanning indicator
-    isScanning = true;
-    statusLabel->setText("Scanning for IR files...", dontSendNotification);
-    statusLabel->repaint();
-
-    // Track seen file paths to avoid duplicates
-    std::set<String> seenPaths;
-
-    auto scanDir = [this, &seenPaths](const File& dir)
+    if (directory != watchedIRDirectory)
     {
-        if (!dir.isDirectory())
-            return;
+        const auto previous = watchedIRDirectory;
+        watchedIRDirectory = directory;
+        releaseDirectory(previous, {watchedModelDirectory, watchedIRDirectory});
+    }
 
-        spdlog::info("[NAMModelBrowser] Scanning IR directory: {}", dir.getFullPathName().toStdString());
+    auto& watcher = LibraryWatcher::getInstance();
 
-        // Find all IR files recursively (.wav, .aiff, .aif)
-        auto wavFiles = dir.findChildFiles(File::findFiles, true, "*.wav");
-        auto aiffFiles = dir.findChildFiles(File::findFiles, true, "*.aiff");
-        auto aifFiles = dir.findChildFiles(File::findFiles, true, "*.aif");
+    // Primary IR directory
+    watcher.watchDirectory(directory);
+    irFiles = watcher.getImpulseResponses(directory);
 
-        for (const auto& file : wavFiles)
-        {
-            if (seenPaths.find(file.getFullPathName()) == seenPaths.end())
-            {
-                seenPaths.insert(file.getFullPathName());
-                addIRFileInfo(file);
-            }
-        }
-        for (const auto& file : aiffFiles)
-        {
-            if (seenPaths.find(file.getFullPathName()) == seenPaths.end())
-            {
-                seenPaths.insert(file.getFullPathName());
-                addIRFileInfo(file);
-            }
-        }
-        for (const auto& file : aifFiles)
+    // Also the NAM Models directory (TONE3000 downloads IRs there too)
+    if (currentDirectory.isDirectory() && currentDirectory != directory)
+    {
+        watcher.watchDirectory(currentDirectory);
+        for (auto& info : watcher.getImpulseResponses(currentDirectory))
         {
-            if (seenPaths.find(file.getFullPathName()) == seenPaths.end())
-            {
-                seenPaths.insert(file.getFullPathName());
-                addIRFileInfo(file);
-            }
+            if (!LibraryWatcher::isBelow(info.filePath, directory))
+                irFiles.push_back(std::move(info));
         }
-    };
+    }
 
-    // Scan primary IR directory
-    scanDir(directory);
+    spdlog::info("[NAMModelBrowser] {} IR files catalogued", irFiles.size());
 
-    // Also scan NAM Models directory (TONE3000 downloads IRs there too)
-    if (currentDirectory.isDirectory() && currentDirectory != directory)
-    {
-        scanDir(currentDirectory);
-    }
+    showIRFiles();
+}
 
-    isScanning = false;
-    spdlog::info("[NAMModelBrowser] Found {} IR files total", irFiles.size());
+void NAMModelBrowserComponent::showIRFiles()
+{
+    const auto* selected = irListModel.getFileAt(irList->getSelectedRow());
+    const std::string selectedPath = selected != nullptr ? selected->filePath : std::string();
 
     // Sort by name
     std::sort(irFiles.begin(), irFiles.end(), [](const IRFileInfo& a, const IRFileInfo& b) { return a.name < b.name; });
@@ -1922,43 +2005,36 @@ void NAMModelBrowserComponent::scanIRDirectory(const File& directory)
     irList->updateContent();
     irList->repaint();
 
-    // Update status bar
-    String statusText = irDirectory.getFullPathName();
-    if (currentDirectory != irDirectory)
-        statusText += " + " + currentDirectory.getFileName();
-    if (irFiles.empty())
-        statusText += " - No IR files found";
-    else if (irFiles.size() == 1)
-        statusText += " - 1 IR file";
-    else
-        statusText += " - " + String(irFiles.size()) + " IR files";
-    statusLabel->setText(statusText, dontSendNotification);
-
-    // Clear details
-    updateIRDetailsPanel(nullptr);
-}
-
-void NAMModelBrowserComponent::addIRFileInfo(const File& file)
-{
-    IRFileInfo info;
-    info.name = file.getFileNameWithoutExtension().toStdString();
-    info.filePath = file.getFullPathName().toStdString();
-    info.fileSize = file.getSize();
-
-    // Read audio file metadata
-    AudioFormatManager formatManager;
-    formatManager.registerBasicFormats();
+    // Update status bar (only while the IR tab owns it)
+    if (currentTab == 2)
+    {
+        String statusText = irDirectory.getFullPathName();
+        if (currentDirectory != irDirectory)
+            statusText += " + " + currentDirectory.getFileName();
+        if (irFiles.empty() && LibraryWatcher::getInstance().isScanning())
+            statusText += " - Scanning for IR files...";
+        else if (irFiles.empty())
+            statusText += " - No IR files found";
+        else if (irFiles.size() == 1)
+            statusText += " - 1 IR file";
+        else
+            statusText += " - " + String(irFiles.size()) + " IR files";
+        statusLabel->setText(statusText, dontSendNotification);
+    }
 
-    std::unique_ptr<AudioFormatReader> reader(formatManager.createReaderFor(file));
-    if (reader)
+    // Restore the selection
+    for (int i = 0; i < irListModel.getFilteredCount(); ++i)
     {
-        info.sampleRate = reader->sampleRate;
-        info.numChannels = static_cast<int>(reader->numChannels);
-        if (reader->sampleRate > 0)
-            info.durationSeconds = static_cast<double>(reader->lengthInSamples) / reader->sampleRate;
+        if (!selectedPath.empty() && irListModel.getFileAt(i)->filePath == selectedPath)
+        {
+            irList->selectRow(i, true, true);
+            updateIRDetailsPanel(irListModel.getFileAt(i));
+            return;
+        }
     }
 
-    irFiles.push_back(std::move(info));
+    irList->deselectAllRows();
+    updateIRDetailsPanel(nullptr);
 }
 
 void NAMModelBrowserComponent::updateIRDetailsPanel(const IRFileInfo* irInfo)
@@ -2220,9 +2296,17 @@ IRBrowserComponent::IRBrowserComponent(std::function<void(const File&)> onIRSele
     if (!currentDirectory.isDirectory())
         currentDirectory = File::getSpecialLocation(File::userDocumentsDirectory);
 
+    LibraryWatcher::getInstance().addListener(this);
+
     scanDirectory(currentDirectory);
 }
 
+IRBrowserComponent::~IRBrowserComponent()
+{
+    LibraryWatcher::getInstance().removeListener(this);
+    releaseDirectory(watchedDirectory);
+}
+
 void IRBrowserComponent::paint(Graphics& g)
 {
     auto& colours = ColourScheme::getInstance().colours;
@@ -2359,7 +2443,9 @@ void IRBrowserComponent::buttonClicked(Button* button)
 {
     if (button == refreshButton.get())
     {
-        scanDirectory(currentDirectory);
+        LibraryWatcher::getInstance().rescan(currentDirectory);
+        if (namModelsDirectory.isDirectory() && namModelsDirectory != currentDirectory)
+            LibraryWatcher::getInstance().rescan(namModelsDirectory);
     }
     else if (button == browseFolderButton.get())
     {
@@ -2440,73 +2526,39 @@ void IRBrowserComponent::mouseExit(const MouseEvent& /*event*/)
 
 void IRBrowserComponent::scanDirectory(const File& directory)
 {
-    irFiles.clear();
-
-    statusLabel->setText("Scanning for IR files...", dontSendNotification);
-
-    std::set<String> seenPaths;
-    AudioFormatManager formatManager;
-    formatManager.registerBasicFormats();
-
-    auto addFile = [&](const File& file)
+    if (directory != watchedDirectory)
     {
-        if (seenPaths.find(file.getFullPathName()) != seenPaths.end())
-            return;
-        seenPaths.insert(file.getFullPathName());
+        const auto previous = watchedDirectory;
+        watchedDirectory = directory;
+        releaseDirectory(previous);
+    }
 
-        IRFileInfo info;
-        info.name = file.getFileNameWithoutExtension().toStdString();
-        info.filePath = file.getFullPathName().toStdString();
-        info.fileSize = file.getSize();
+    auto& watcher = LibraryWatcher::getInstance();
 
-        std::unique_ptr<AudioFormatReader> reader(formatManager.createReaderFor(file));
-        if (reader)
-        {
-            info.sampleRate = reader->sampleRate;
-            info.numChannels = static_cast<int>(reader->numChannels);
-            if (reader->sampleRate > 0)
-                info.durationSeconds = static_cast<double>(reader->lengthInSamples) / reader->sampleRate;
+    // Primary IR directory
+    watcher.watchDirectory(directory);
+    irFiles = watcher.getImpulseResponses(directory);
 
-            spdlog::debug("[IRBrowser] Loaded IR: {} - {}Hz, {}ch, {:.3f}s", info.name, info.sampleRate,
-                          info.numChannels, info.durationSeconds);
-        }
-        else
+    // Also the NAM Models directory (TONE3000 downloads IRs there too)
+    if (namModelsDirectory.isDirectory() && namModelsDirectory != directory)
+    {
+        watcher.watchDirectory(namModelsDirectory);
+        for (auto& info : watcher.getImpulseResponses(namModelsDirectory))
         {
-            spdlog::warn("[IRBrowser] Failed to read audio file: {}", file.getFullPathName().toStdString());
+            if (!LibraryWatcher::isBelow(info.filePath, directory))
+                irFiles.push_back(std::move(info));
         }
+    }
 
-        irFiles.push_back(std::move(info));
-    };
-
-    auto scanDir = [&](const File& dir)
-    {
-        if (!dir.isDirectory())
-            return;
-
-        spdlog::info("[IRBrowser] Scanning directory: {}", dir.getFullPathName().toStdString());
-
-        auto wavFiles = dir.findChildFiles(File::findFiles, true, "*.wav");
-        auto aiffFiles = dir.findChildFiles(File::findFiles, true, "*.aiff");
-        auto aifFiles = dir.findChildFiles(File::findFiles, true, "*.aif");
-
-        for (const auto& f : wavFiles)
-            addFile(f);
-        for (const auto& f : aiffFiles)
-            addFile(f);
-        for (const auto& f : aifFiles)
-            addFile(f);
-    };
-
-    // Scan primary IR directory
-    scanDir(directory);
+    spdlog::info("[IRBrowser] {} IR files catalogued", irFiles.size());
 
-    // Also scan NAM Models directory (TONE3000 downloads IRs there too)
-    if (namModelsDirectory.isDirectory() && namModelsDirectory != directory)
-    {
-        scanDir(namModelsDirectory);
-    }
+    showIRFiles();
+}
 
-    spdlog::info("[IRBrowser] Found {} IR files total", irFiles.size());
+void IRBrowserComponent::showIRFiles()
+{
+    const auto* selected = listModel.getFileAt(irList->getSelectedRow());
+    const std::string selectedPath = selected != nullptr ? selected->filePath : std::string();
 
     std::sort(irFiles.begin(), irFiles.end(), [](const IRFileInfo& a, const IRFileInfo& b) { return a.name < b.name; });
 
@@ -2514,11 +2566,13 @@ void IRBrowserComponent::scanDirectory(const File& directory)
     irList->updateContent();
     irList->repaint();
 
-    // Update status to show both directories being scanned
+    // Update status to show both directories being watched
     String statusText = currentDirectory.getFullPathName();
     if (namModelsDirectory.isDirectory() && namModelsDirectory != currentDirectory)
         statusText += " + " + namModelsDirectory.getFileName();
-    if (irFiles.empty())
+    if (irFiles.empty() && LibraryWatcher::getInstance().isScanning())
+        statusText += " - Scanning for IR files...";
+    else if (irFiles.empty())
         statusText += " - No IR files found";
     else if (irFiles.size() == 1)
         statusText += " - 1 IR file";
@@ -2526,9 +2580,50 @@ void IRBrowserComponent::scanDirectory(const File& directory)
         statusText += " - " + String(irFiles.size()) + " IR files";
     statusLabel->setText(statusText, dontSendNotification);
 
+    for (int i = 0; i < listModel.getFilteredCount(); ++i)
+    {
+        if (!selectedPath.empty() && listModel.getFileAt(i)->filePath == selectedPath)
+        {
+            irList->selectRow(i, true, true);
+            updateDetailsPanel(listModel.getFileAt(i));
+            return;
+        }
+    }
+
+    irList->deselectAllRows();
     updateDetailsPanel(nullptr);
 }
 
+void IRBrowserComponent::libraryChanged(const std::vector<LibraryWatcher::Change>& changes)
+{
+    bool changed = false;
+
+    for (const auto& change : changes)
+    {
+        if (change.kind != LibraryWatcher::EntryKind::ImpulseResponse)
+            continue;
+        if (!LibraryWatcher::isBelow(change.filePath, currentDirectory) &&
+            !LibraryWatcher::isBelow(change.filePath, namModelsDirectory))
+            continue;
+
+        irFiles.erase(std::remove_if(irFiles.begin(), irFiles.end(),
+                                     [&change](const IRFileInfo& f) { return f.filePath == change.filePath; }),
+                      irFiles.end());
+        if (change.type != LibraryWatcher::ChangeType::Removed)
+            irFiles.push_back(change.ir);
+        changed = true;
+    }
+
+    if (changed)
+        showIRFiles();
+}
+
+void IRBrowserComponent::libraryScanFinished(const File& root)
+{
+    if ((root == currentDirectory || root == namModelsDirectory) && irFiles.empty())
+        showIRFiles();
+}
+
 void IRBrowserComponent::updateDetailsPanel(const IRFileInfo* irInfo)
 {
     if (irInfo)
@@ -9,6 +9,7 @@
 
 #pragma once
 
+#include "LibraryWatcher.h"
 #include "NAMCore.h"
 
 #include <JuceHeader.h>
@@ -50,20 +51,6 @@ class NAMModelListModel : public ListBoxModel
     int hoveredRow = -1;
 };
 
-//==============================================================================
-/**
-    Info structure for IR files (impulse responses).
-*/
-struct IRFileInfo
-{
-    std::string name;
-    std::string filePath;
-    int64_t fileSize = 0;
-    double durationSeconds = 0.0;
-    double sampleRate = 0.0;
-    int numChannels = 0;
-};
-
 //==============================================================================
 /**
     ListBox model for displaying IR files with filtering support.
@@ -99,7 +86,10 @@ class IRListModel : public ListBoxModel
     Main component for the NAM model browser.
     Contains a model list, search box, and details panel.
 */
-class NAMModelBrowserComponent : public Component, public Button::Listener, public TextEditor::Listener
+class NAMModelBrowserComponent : public Component,
+                                 public Button::Listener,
+                                 public TextEditor::Listener,
+                                 public LibraryWatcher::Listener
 {
   public:
     NAMModelBrowserComponent(NAMProcessor* processor, std::function<void()> onModelLoaded);
@@ -119,7 +109,13 @@ class NAMModelBrowserComponent : public Component, public Button::Listener, publ
     void refreshModelList();
     void refreshColours();
 
+    // LibraryWatcher::Listener
+    void libraryChanged(const std::vector<LibraryWatcher::Change>& changes) override;
+    void libraryScanFinished(const File& root) override;
+
   private:
+    /// Pushes `models` into the list, keeping the selected model selected
+    void showModels();
     void updateDetailsPanel(const NAMModelInfo* model);
     void loadSelectedModel();
     void deleteSelectedModel();
@@ -128,7 +124,7 @@ class NAMModelBrowserComponent : public Component, public Button::Listener, publ
 
     // IR browser methods
     void scanIRDirectory(const File& directory);
-    void addIRFileInfo(const File& file);
+    void showIRFiles();
     void updateIRDetailsPanel(const IRFileInfo* irInfo);
     void loadSelectedIR();
     void onIRListSelectionChanged();
@@ -184,6 +180,10 @@ class NAMModelBrowserComponent : public Component, public Button::Listener, publ
     File currentDirectory;
     std::vector<NAMModelInfo> models;
 
+    // The folders this browser has the LibraryWatcher following
+    File watchedModelDirectory;
+    File watchedIRDirectory;
+
     std::unique_ptr<FileChooser> folderChooser;
 
     // IR browser components (separate directory from NAM models)
@@ -212,9 +212,6 @@ class NAMModelBrowserComponent : public Component, public Button::Listener, publ
     std::vector<IRFileInfo> irFiles;
     std::unique_ptr<FileChooser> irFolderChooser;
 
-    // Scanning state
-    bool isScanning = false;
-
     // Section separator Y positions (computed in resized, drawn in paint)
     std::vector<int> detailsSeparatorPositions;
 
@@ -252,11 +249,14 @@ class NAMModelBrowser : public DocumentWindow
     Simple IR browser component for standalone IR loading.
     Used by IRLoaderProcessor to browse and load IR files.
 */
-class IRBrowserComponent : public Component, public Button::Listener, public TextEditor::Listener
+class IRBrowserComponent : public Component,
+                           public Button::Listener,
+                           public TextEditor::Listener,
+                           public LibraryWatcher::Listener
 {
   public:
     IRBrowserComponent(std::function<void(const File&)> onIRSelected);
-    ~IRBrowserComponent() override = default;
+    ~IRBrowserComponent() override;
 
     void paint(Graphics& g) override;
     void paintOverChildren(Graphics& g) override;
@@ -270,7 +270,13 @@ class IRBrowserComponent : public Component, public Button::Listener, public Tex
 
     void scanDirectory(const File& directory);
 
+    // LibraryWatcher::Listener
+    void libraryChanged(const std::vector<LibraryWatcher::Change>& changes) override;
+    void libraryScanFinished(const File& root) override;
+
   private:
+    /// Pushes `irFiles` into the list, keeping the selected IR selected
+    void showIRFiles();
     void updateDetailsPanel(const IRFileInfo* irInfo);
     void loadSelectedIR();
     void onListSelectionChanged();
@@ -305,6 +311,7 @@ class IRBrowserComponent : public Component, public Button::Listener, public Tex
 
     File currentDirectory;
     File namModelsDirectory; // Also scan NAM Models folder for IRs
+    File watchedDirectory;   // The folder this browser has the LibraryWatcher following
     std::vector<IRFileInfo> irFiles;
 
     std::unique_ptr<FileChooser> folderChooser;
@@ -12,6 +12,7 @@
 #include "NAMControl.h"
 #include "NAMConvolver.h"
 #include "NAMCore.h"
+#include "SettingsManager.h"
 #include "SubGraphProcessor.h"
 
 #include <spdlog/spdlog.h>
@@ -26,7 +27,6 @@ NAMProcessor::NAMProcessor() : PedalboardProcessor()
 
     // Initialize convolvers for IR loading
     convolver = std::make_unique<NAMConvolver>();
-    convolver2 = std::make_unique<NAMConvolver>();
 
     // Initialize effects loop (SubGraph for hosting plugins between tone stack and IR)
     effectsLoop = std::make_unique<SubGraphProcessor>();
@@ -50,16 +50,11 @@ void NAMProcessor::prepareToPlay(double sampleRate, int estimatedSamplesPerBlock
     outputBuffer.setSize(1, estimatedSamplesPerBlock, false, false, false);
     outputBuffer.clear();
 
-    // Pre-allocate IR2 blend buffer (RT-safe: avoids per-block allocation)
-    ir2Buffer.setSize(2, estimatedSamplesPerBlock, false, false, false);
-    ir2Buffer.clear();
-
     // Prepare NAM core
     namCore->prepare(sampleRate, estimatedSamplesPerBlock);
 
-    // Prepare convolvers for IR
+    // Prepare convolver for IR (both cabinet slots)
     convolver->prepare(sampleRate, estimatedSamplesPerBlock);
-    convolver2->prepare(sampleRate, estimatedSamplesPerBlock);
 
     // Prepare IR filters
     juce::dsp::ProcessSpec spec;
@@ -86,6 +81,12 @@ void NAMProcessor::releaseResources()
     isPrepared = false;
 }
 
+void NAMProcessor::setNonRealtime(bool isNonRealtime) noexcept
+{
+    PedalboardProcessor::setNonRealtime(isNonRealtime);
+    convolver->setNonRealtime(isNonRealtime);
+}
+
 //==============================================================================
 bool NAMProcessor::loadModel(const juce::File& modelFile)
 {
@@ -142,7 +143,24 @@ bool NAMProcessor::loadIR(const juce::File& irFile)
 
     try
     {
-        convolver->loadIR(irFile);
+        applyIRSettings();
+
+        // With IR2 present the convolver blends both slots itself
+        bool loaded = false;
+        if (ir2Loaded.load())
+        {
+            loaded = convolver->loadIRs(irFile, currentIRFile2);
+            if (!loaded)
+                ir2Loaded.store(false);
+        }
+        if (!loaded)
+            loaded = convolver->loadIR(irFile);
+
+        if (!loaded)
+        {
+            spdlog::error("NAMProcessor: Could not read IR: {}", irFile.getFullPathName().toStdString());
+            return false;
+        }
 
         currentIRFile = irFile;
         irLoaded.store(true);
@@ -160,8 +178,8 @@ bool NAMProcessor::loadIR(const juce::File& irFile)
 
 void NAMProcessor::clearIR()
 {
-    convolver->reset();
     irLoaded.store(false);
+    convolver->clear();
     currentIRFile = juce::File();
 }
 
@@ -187,7 +205,14 @@ bool NAMProcessor::loadIR2(const juce::File& irFile)
 
     try
     {
-        convolver2->loadIR(irFile);
+        applyIRSettings();
+
+        // IR2 only sounds alongside IR1; without it the file is paired on the next IR1 load
+        if (irLoaded.load() && !convolver->loadIRs(currentIRFile, irFile))
+        {
+            spdlog::error("NAMProcessor: Could not read IR2: {}", irFile.getFullPathName().toStdString());
+            return false;
+        }
         currentIRFile2 = irFile;
         ir2Loaded.store(true);
         spdlog::info("NAMProcessor: IR2 loaded successfully");
@@ -203,11 +228,30 @@ bool NAMProcessor::loadIR2(const juce::File& irFile)
 
 void NAMProcessor::clearIR2()
 {
-    convolver2->reset();
     ir2Loaded.store(false);
+    if (irLoaded.load())
+        convolver->loadIR(currentIRFile);
     currentIRFile2 = juce::File();
 }
 
+void NAMProcessor::reloadIRs()
+{
+    if (irLoaded.load())
+        loadIR(currentIRFile);
+}
+
+bool NAMProcessor::isIRReady() const
+{
+    return convolver->isLoaded();
+}
+
+void NAMProcessor::applyIRSettings()
+{
+    auto& settings = SettingsManager::getInstance();
+    convolver->setMinimumPhase(settings.getBool("IRMinimumPhase", false));
+    convolver->setStripPreDelay(settings.getBool("IRStripPreDelay", false));
+}
+
 juce::String NAMProcessor::getIR2Name() const
 {
     if (currentIRFile2.existsAsFile())
@@ -327,39 +371,11 @@ void NAMProcessor::processBlock(AudioSampleBuffer& buffer, MidiBuffer& midiMessa
             irLowCutFilter.process(context);
         }
 
-        if (doIR2)
-        {
-            // Dual IR mode: process both convolvers and blend
-            const int numChannels = buffer.getNumChannels();
-            ir2Buffer.setSize(numChannels, numSamples, false, false, true); // no-alloc if already big enough
-            for (int ch = 0; ch < numChannels; ++ch)
-                ir2Buffer.copyFrom(ch, 0, buffer, ch, 0, numSamples);
-
-            // Convolve IR1 into buffer, IR2 into ir2Buffer
-            convolver->process(buffer);
-            convolver2->process(ir2Buffer);
-
-            // Equal-power crossfade blend
-            const float blendVal = irBlend.load();
-            const float angle = blendVal * juce::MathConstants<float>::halfPi;
-            const float gain1 = std::cos(angle);
-            const float gain2 = std::sin(angle);
-
-            for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
-            {
-                float* dst = buffer.getWritePointer(ch);
-                const float* src2 = ir2Buffer.getReadPointer(ch);
-                for (int i = 0; i < numSamples; ++i)
-                {
-                    dst[i] = dst[i] * gain1 + src2[i] * gain2;
-                }
-            }
-        }
-        else
-        {
-            // Single IR mode
-            convolver->process(buffer);
-        }
+        // IR1, or IR1/IR2 blended by the convolver (pre-mixed once the blend
+        // settles, so steady-state cost is one convolution). Disabling IR2
+        // is a blend of 0.
+        convolver->setBlend(doIR2 ? irBlend.load() : 0.0f);
+        convolver->process(buffer);
 
         // High cut (low-pass) filter AFTER convolution - tames harshness
         {
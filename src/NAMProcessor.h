@@ -71,6 +71,13 @@ class NAMProcessor : public PedalboardProcessor
     juce::String getIR2Name() const;
     const juce::File& getIR2File() const { return currentIRFile2; }
 
+    /// Reloads the loaded IRs, e.g. after the IR analysis settings changed
+    void reloadIRs();
+
+    /// True once the loaded IRs are playing; loads finish in the background
+    /// after loadIR() and prepareToPlay()
+    bool isIRReady() const;
+
     //==========================================================================
     // Parameters
     float getInputGain() const { return inputGain.load(); }
@@ -132,6 +139,8 @@ class NAMProcessor : public PedalboardProcessor
     const String getName() const override { return "NAM Loader"; }
     void prepareToPlay(double sampleRate, int estimatedSamplesPerBlock) override;
     void releaseResources() override;
+    /// Offline, the cabinet convolution waits for its worker rather than glitching
+    void setNonRealtime(bool isNonRealtime) noexcept override;
 
     const String getInputChannelName(int channelIndex) const override { return ""; }
     const String getOutputChannelName(int channelIndex) const override { return ""; }
@@ -178,6 +187,8 @@ class NAMProcessor : public PedalboardProcessor
     void setStateInformation(const void* data, int sizeInBytes) override;
 
   private:
+    /// Applies the IRMinimumPhase / IRStripPreDelay settings to the convolver
+    void applyIRSettings();
     void updateNoiseGate();
     void updateToneStack();
     void updateIRFilters();
@@ -196,8 +207,7 @@ class NAMProcessor : public PedalboardProcessor
     std::atomic<bool> irEnabled{true};
     juce::File currentIRFile;
 
-    // IR2 (second cabinet slot)
-    std::unique_ptr<NAMConvolver> convolver2;
+    // IR2 (second cabinet slot, blended by convolver)
     std::atomic<bool> ir2Loaded{false};
     std::atomic<bool> ir2Enabled{true};
     juce::File currentIRFile2;
@@ -221,7 +231,6 @@ class NAMProcessor : public PedalboardProcessor
 
     // Processing buffers
     juce::AudioBuffer<float> outputBuffer;
-    juce::AudioBuffer<float> ir2Buffer; // Pre-allocated for dual-IR blend (RT-safe)
 
     //==========================================================================
     // Parameters (atomic for thread safety)
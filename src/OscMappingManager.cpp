@@ -20,6 +20,7 @@
 #include "OscMappingManager.h"
 
 #include "BypassableInstance.h"
+#include "FlightRecorder.h"
 #include "LogFile.h"
 #include "MainPanel.h"
 
@@ -242,6 +243,8 @@ void OscMappingManager::handleFloatMessage(const String& address, int index, flo
     multimap<String, OscMapping*>::iterator it;
     multimap<String, OscAppMapping*>::iterator it2;
 
+    FlightRecorder::getInstance().recordEvent(FlightRecorder::EventSource::Osc, 0, index, val, address.toRawUTF8());
+
     // Check against any OscMappings.
     for (it = mappings.lower_bound(address); it != mappings.upper_bound(address); ++it)
     {
@@ -11,26 +11,60 @@
 #include "OscilloscopeProcessor.h"
 #include "ColourScheme.h"
 
+namespace
+{
+const char* triggerNames[] = {"Free", "Edge", "Pitch"};
+} // namespace
+
 //==============================================================================
 OscilloscopeControl::OscilloscopeControl(OscilloscopeProcessor* processor)
     : oscilloscopeProcessor(processor)
 {
-    displayBuffer.fill(0.0f);
-    startTimer(16); // ~60 FPS
+    triggerButton.setTooltip("Trigger: free run, rising edge at the trigger level, or locked to the pitch");
+    triggerButton.onClick = [this]()
+    {
+        auto& capture = oscilloscopeProcessor->getCapture();
+        const int next = (static_cast<int>(capture.getTriggerMode()) + 1) %
+                         static_cast<int>(ScopeCapture::TriggerMode::NumModes);
+        capture.setTriggerMode(static_cast<ScopeCapture::TriggerMode>(next));
+        updateButtonText();
+    };
+    addAndMakeVisible(triggerButton);
+
+    timebaseButton.setTooltip("Timebase: the time across the display");
+    timebaseButton.onClick = [this]()
+    {
+        auto& capture = oscilloscopeProcessor->getCapture();
+        const int current = capture.getDecimation();
+        capture.setDecimation(current >= ScopeCapture::maxDecimation ? 1 : current * 2);
+        updateButtonText();
+    };
+    addAndMakeVisible(timebaseButton);
+
+    updateButtonText();
 }
 
-OscilloscopeControl::~OscilloscopeControl()
+OscilloscopeControl::~OscilloscopeControl() = default;
+
+//==============================================================================
+void OscilloscopeControl::refresh()
 {
-    stopTimer();
+    if (auto* newFrame = oscilloscopeProcessor->getCapture().acquireLatestFrame())
+    {
+        frame = newFrame;
+        repaint();
+    }
 }
 
-//==============================================================================
-void OscilloscopeControl::timerCallback()
+void OscilloscopeControl::updateButtonText()
 {
-    std::array<float, OscilloscopeProcessor::DISPLAY_SAMPLES> buffer;
-    oscilloscopeProcessor->getDisplayBuffer(buffer);
-    displayBuffer = buffer;
-    repaint();
+    const auto& capture = oscilloscopeProcessor->getCapture();
+    triggerButton.setButtonText(triggerNames[static_cast<int>(capture.getTriggerMode())]);
+
+    const double sampleRate = oscilloscopeProcessor->getSampleRate() > 0.0 ? oscilloscopeProcessor->getSampleRate()
+                                                                            : 44100.0;
+    const double spanMs = 1000.0 * ScopeCapture::frameSize * capture.getDecimation() / sampleRate;
+    timebaseButton.setButtonText(String(spanMs, spanMs < 10.0 ? 1 : 0) + " ms");
 }
 
 void OscilloscopeControl::paint(Graphics& g)
@@ -56,27 +90,34 @@ void OscilloscopeControl::paint(Graphics& g)
 
     // Waveform path
     Path waveform;
-    float xScale = bounds.getWidth() / (float)DISPLAY_SAMPLES;
+    float xScale = bounds.getWidth() / (float)ScopeCapture::frameSize;
     float yScale = bounds.getHeight() * 0.45f; // Leave margin
 
-    bool started = false;
-    for (int i = 0; i < DISPLAY_SAMPLES; ++i)
+    auto toY = [&](float value) { return juce::jlimit(bounds.getY(), bounds.getBottom(), centerY - value * yScale); };
+
+    if (frame == nullptr)
+    {
+        waveform.startNewSubPath(bounds.getX(), centerY);
+        waveform.lineTo(bounds.getRight(), centerY);
+    }
+    else if (frame->decimation == 1)
+    {
+        waveform.startNewSubPath(bounds.getX(), toY(frame->maximum[0]));
+        for (int i = 1; i < ScopeCapture::frameSize; ++i)
+            waveform.lineTo(bounds.getX() + i * xScale, toY(frame->maximum[(size_t)i]));
+    }
+    else
     {
-        float x = bounds.getX() + i * xScale;
-        float y = centerY - displayBuffer[i] * yScale;
-
-        // Clamp to bounds
-        y = juce::jlimit(bounds.getY(), bounds.getBottom(), y);
-
-        if (!started)
-        {
-            waveform.startNewSubPath(x, y);
-            started = true;
-        }
-        else
-        {
-            waveform.lineTo(x, y);
-        }
+        // Min/max envelope: along the maxima, then back along the minima
+        waveform.startNewSubPath(bounds.getX(), toY(frame->maximum[0]));
+        for (int i = 1; i < ScopeCapture::frameSize; ++i)
+            waveform.lineTo(bounds.getX() + i * xScale, toY(frame->maximum[(size_t)i]));
+        for (int i = ScopeCapture::frameSize - 1; i >= 0; --i)
+            waveform.lineTo(bounds.getX() + i * xScale, toY(frame->minimum[(size_t)i]));
+        waveform.closeSubPath();
+
+        g.setColour(colours["Audio Connection"].withAlpha(0.5f));
+        g.fillPath(waveform);
     }
 
     // Draw waveform with glow effect
@@ -86,6 +127,18 @@ void OscilloscopeControl::paint(Graphics& g)
     g.setColour(colours["Audio Connection"]);
     g.strokePath(waveform, PathStrokeType(1.5f));
 
+    // Trigger status: dimmed while free running on the auto timeout
+    if (frame != nullptr && oscilloscopeProcessor->getCapture().getTriggerMode() != ScopeCapture::TriggerMode::FreeRun)
+    {
+        String status = frame->triggered ? "Trig'd" : "Auto";
+        if (frame->frequency > 0.0f)
+            status << "  " << String(frame->frequency, 1) << " Hz";
+
+        g.setColour(colours["Text Colour"].withAlpha(frame->triggered ? 0.7f : 0.35f));
+        g.setFont(11.0f);
+        g.drawText(status, bounds.reduced(6.0f, 3.0f), Justification::bottomLeft, false);
+    }
+
     // Border
     g.setColour(colours["Text Colour"].withAlpha(0.3f));
     g.drawRoundedRectangle(bounds, 6.0f, 1.0f);
@@ -93,5 +146,8 @@ void OscilloscopeControl::paint(Graphics& g)
 
 void OscilloscopeControl::resized()
 {
-    // No child components
+    auto buttons = getLocalBounds().reduced(8).removeFromTop(18).removeFromRight(104);
+    timebaseButton.setBounds(buttons.removeFromRight(56));
+    buttons.removeFromRight(4);
+    triggerButton.setBounds(buttons);
 }
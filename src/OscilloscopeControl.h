@@ -9,17 +9,20 @@
 
 #pragma once
 
+#include "ScopeCapture.h"
+#include "UiFrameScheduler.h"
+
 #include <JuceHeader.h>
-#include <array>
 
 class OscilloscopeProcessor;
 
 //==============================================================================
 /**
     Real-time waveform display component.
-    Uses timer-driven updates to poll processor for audio data.
+    Picks up the processor's newest complete frame on each display refresh,
+    and only repaints when there is one.
 */
-class OscilloscopeControl : public Component, private Timer
+class OscilloscopeControl : public Component
 {
   public:
     OscilloscopeControl(OscilloscopeProcessor* processor);
@@ -29,12 +32,18 @@ class OscilloscopeControl : public Component, private Timer
     void resized() override;
 
   private:
-    void timerCallback() override;
+    void refresh();
+    void updateButtonText();
 
     OscilloscopeProcessor* oscilloscopeProcessor;
 
-    static constexpr int DISPLAY_SAMPLES = 512;
-    std::array<float, DISPLAY_SAMPLES> displayBuffer;
+    // Owned by us until the next acquireLatestFrame()
+    const ScopeCapture::Frame* frame = nullptr;
+
+    TextButton triggerButton;
+    TextButton timebaseButton;
+
+    UiFrameScheduler::Client frameClient{this, 0.0, [this]() { refresh(); }};
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(OscilloscopeControl)
 };
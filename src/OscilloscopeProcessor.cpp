@@ -13,9 +13,7 @@
 //==============================================================================
 OscilloscopeProcessor::OscilloscopeProcessor()
 {
-    circularBuffer.fill(0.0f);
-    displayBuffers[0].fill(0.0f);
-    displayBuffers[1].fill(0.0f);
+    capture.prepare(currentSampleRate);
 }
 
 OscilloscopeProcessor::~OscilloscopeProcessor() = default;
@@ -31,12 +29,6 @@ void OscilloscopeProcessor::updateEditorBounds(const Rectangle<int>& bounds)
     editorBounds = bounds;
 }
 
-void OscilloscopeProcessor::getDisplayBuffer(std::array<float, DISPLAY_SAMPLES>& output) const
-{
-    // Read from front buffer (last completed capture)
-    output = displayBuffers[frontBuffer.load()];
-}
-
 //==============================================================================
 void OscilloscopeProcessor::fillInPluginDescription(PluginDescription& description) const
 {
@@ -55,14 +47,7 @@ void OscilloscopeProcessor::fillInPluginDescription(PluginDescription& descripti
 void OscilloscopeProcessor::prepareToPlay(double sampleRate, int)
 {
     currentSampleRate = sampleRate;
-    circularBuffer.fill(0.0f);
-    displayBuffers[0].fill(0.0f);
-    displayBuffers[1].fill(0.0f);
-    frontBuffer.store(0);
-    backBuffer = 1;
-    writePos = 0;
-    lastSampleWasNegative = true;
-    samplesSinceTrigger = DISPLAY_SAMPLES; // Start ready for new trigger
+    capture.prepare(sampleRate);
 }
 
 void OscilloscopeProcessor::processBlock(AudioSampleBuffer& buffer, MidiBuffer&)
@@ -70,43 +55,7 @@ void OscilloscopeProcessor::processBlock(AudioSampleBuffer& buffer, MidiBuffer&)
     if (buffer.getNumChannels() == 0)
         return;
 
-    const float* inputData = buffer.getReadPointer(0);
-    int numSamples = buffer.getNumSamples();
-
-    float trigger = triggerLevel.load();
-
-    for (int i = 0; i < numSamples; ++i)
-    {
-        float sample = inputData[i];
-
-        // Write to circular buffer
-        circularBuffer[writePos] = sample;
-
-        // Check for trigger (rising edge zero-crossing)
-        bool isNegative = sample < trigger;
-        if (lastSampleWasNegative && !isNegative && samplesSinceTrigger >= DISPLAY_SAMPLES)
-        {
-            // New trigger - start counting samples for snapshot
-            samplesSinceTrigger = 0;
-        }
-        lastSampleWasNegative = isNegative;
-
-        // Build snapshot in back buffer after trigger
-        if (samplesSinceTrigger < DISPLAY_SAMPLES)
-        {
-            displayBuffers[backBuffer][samplesSinceTrigger] = sample;
-            samplesSinceTrigger++;
-
-            // Capture complete - swap front/back buffers
-            if (samplesSinceTrigger >= DISPLAY_SAMPLES)
-            {
-                frontBuffer.store(backBuffer);
-                backBuffer = 1 - backBuffer;
-            }
-        }
-
-        writePos = (writePos + 1) % BUFFER_SIZE;
-    }
+    capture.push(buffer.getReadPointer(0), buffer.getNumSamples());
 }
 
 //==============================================================================
@@ -117,10 +66,23 @@ AudioProcessorEditor* OscilloscopeProcessor::createEditor()
 
 void OscilloscopeProcessor::getStateInformation(MemoryBlock& destData)
 {
-    // Could save trigger level here if needed
+    XmlElement xml("Oscilloscope");
+    xml.setAttribute("triggerMode", static_cast<int>(capture.getTriggerMode()));
+    xml.setAttribute("triggerLevel", capture.getTriggerLevel());
+    xml.setAttribute("decimation", capture.getDecimation());
+
+    copyXmlToBinary(xml, destData);
 }
 
 void OscilloscopeProcessor::setStateInformation(const void* data, int sizeInBytes)
 {
-    // Could restore trigger level here if needed
+    auto xml = getXmlFromBinary(data, sizeInBytes);
+    if (xml == nullptr || !xml->hasTagName("Oscilloscope"))
+        return;
+
+    const int lastMode = static_cast<int>(ScopeCapture::TriggerMode::NumModes) - 1;
+    const int mode = xml->getIntAttribute("triggerMode", static_cast<int>(ScopeCapture::TriggerMode::RisingEdge));
+    capture.setTriggerMode(static_cast<ScopeCapture::TriggerMode>(jlimit(0, lastMode, mode)));
+    capture.setTriggerLevel(static_cast<float>(xml->getDoubleAttribute("triggerLevel", 0.0)));
+    capture.setDecimation(xml->getIntAttribute("decimation", 1));
 }
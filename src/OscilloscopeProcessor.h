@@ -10,13 +10,13 @@
 #pragma once
 
 #include "PedalboardProcessors.h"
-#include <array>
-#include <atomic>
+#include "ScopeCapture.h"
 
 //==============================================================================
 /**
     Simple real-time oscilloscope processor with embedded waveform display.
-    Uses zero-crossing trigger for stable waveform visualization.
+    The left input is captured by a ScopeCapture, which triggers on the audio
+    thread and hands complete frames to the display.
 */
 class OscilloscopeProcessor : public PedalboardProcessor
 {
@@ -33,10 +33,7 @@ class OscilloscopeProcessor : public PedalboardProcessor
 
     //==========================================================================
     // Thread-safe data access for UI
-    static constexpr int DISPLAY_SAMPLES = 512;
-    void getDisplayBuffer(std::array<float, DISPLAY_SAMPLES>& output) const;
-    float getTriggerLevel() const { return triggerLevel.load(); }
-    void setTriggerLevel(float level) { triggerLevel.store(level); }
+    ScopeCapture& getCapture() { return capture; }
 
     //==========================================================================
     // AudioProcessor overrides
@@ -75,22 +72,7 @@ class OscilloscopeProcessor : public PedalboardProcessor
     void setStateInformation(const void* data, int sizeInBytes) override;
 
   private:
-    // Circular buffer for audio capture
-    static constexpr int BUFFER_SIZE = 2048;
-    std::array<float, BUFFER_SIZE> circularBuffer;
-    int writePos = 0;
-
-    // Double-buffer for thread-safe display.
-    // Audio writes to displayBuffers[backBuffer], flips frontBuffer on capture complete.
-    // UI reads from displayBuffers[frontBuffer.load()].
-    std::array<float, DISPLAY_SAMPLES> displayBuffers[2];
-    std::atomic<int> frontBuffer{0};
-    int backBuffer = 1;
-
-    // Simple zero-crossing trigger
-    std::atomic<float> triggerLevel{0.0f};
-    bool lastSampleWasNegative = true;
-    int samplesSinceTrigger = 0;
+    ScopeCapture capture;
 
     double currentSampleRate = 44100.0;
     Rectangle<int> editorBounds;
@@ -0,0 +1,1305 @@
+/*
+  ==============================================================================
+
+    PartitionedConvolver.cpp
+    Zero-latency non-uniform partitioned convolution engine
+
+  ==============================================================================
+*/
+
+#include "PartitionedConvolver.h"
+
+#include "IRCache.h"
+
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <juce_dsp/juce_dsp.h>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <condition_variable>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+#if JUCE_WINDOWS
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#elif JUCE_MAC || JUCE_IOS
+#include <dispatch/dispatch.h>
+#else
+#include <cerrno>
+#include <ctime>
+#include <semaphore.h>
+#endif
+
+namespace
+{
+constexpr int tailRatio = 8;            // Partition growth per tail level
+constexpr int maxPartitionSize = 8192;  // Largest tail partition
+constexpr int minHeadSize = 32;
+constexpr int maxHeadSize = 128;
+constexpr double crossfadeSeconds = 0.05;
+constexpr double maxImpulseSeconds = 10.0;
+constexpr float silenceThresholdDb = -80.0f; // Files quieter than this are treated as empty
+constexpr int blendSettleMs = 100; // Blend must be still this long before pre-mixing
+constexpr int loaderIdleWaitMs = 100;
+constexpr int workerIdleWaitMs = 100; // Only a fallback; queued jobs wake the worker
+constexpr int workerMixWaitMs = 10;   // While a blend is waiting to settle
+constexpr int stopTimeoutMs = 2000;
+
+enum JobStatus
+{
+    JobIdle = 0,
+    JobQueued,
+    JobRunning,
+    JobDone
+};
+
+/// A counting semaphore the audio thread can post without taking a lock (C++17
+/// has none of its own): posting is a single non-blocking call on each platform.
+class WakeSignal
+{
+  public:
+    WakeSignal()
+    {
+#if JUCE_WINDOWS
+        handle = CreateSemaphoreW(nullptr, 0, LONG_MAX, nullptr);
+#elif JUCE_MAC || JUCE_IOS
+        semaphore = dispatch_semaphore_create(0);
+#else
+        sem_init(&semaphore, 0, 0);
+#endif
+    }
+
+    ~WakeSignal()
+    {
+#if JUCE_WINDOWS
+        CloseHandle(handle);
+#elif JUCE_MAC || JUCE_IOS
+        dispatch_release(semaphore);
+#else
+        sem_destroy(&semaphore);
+#endif
+    }
+
+    /// Any thread, including the audio thread
+    void post()
+    {
+#if JUCE_WINDOWS
+        ReleaseSemaphore(handle, 1, nullptr);
+#elif JUCE_MAC || JUCE_IOS
+        dispatch_semaphore_signal(semaphore);
+#else
+        sem_post(&semaphore);
+#endif
+    }
+
+    /// Returns after a post, or once timeoutMs has passed
+    void wait(int timeoutMs)
+    {
+#if JUCE_WINDOWS
+        WaitForSingleObject(handle, static_cast<DWORD>(timeoutMs));
+#elif JUCE_MAC || JUCE_IOS
+        dispatch_semaphore_wait(semaphore,
+                                dispatch_time(DISPATCH_TIME_NOW, static_cast<int64_t>(timeoutMs) * NSEC_PER_MSEC));
+#else
+        timespec until;
+        clock_gettime(CLOCK_REALTIME, &until);
+        until.tv_nsec += static_cast<long>(timeoutMs % 1000) * 1000000L;
+        until.tv_sec += timeoutMs / 1000 + until.tv_nsec / 1000000000L;
+        until.tv_nsec %= 1000000000L;
+        while (sem_timedwait(&semaphore, &until) != 0 && errno == EINTR)
+        {
+        }
+#endif
+    }
+
+  private:
+#if JUCE_WINDOWS
+    HANDLE handle;
+#elif JUCE_MAC || JUCE_IOS
+    dispatch_semaphore_t semaphore;
+#else
+    sem_t semaphore;
+#endif
+
+    JUCE_DECLARE_NON_COPYABLE(WakeSignal)
+};
+
+int log2Of(int n)
+{
+    int order = 0;
+    while ((1 << order) < n)
+        ++order;
+    return order;
+}
+
+/// acc += gain * a * b over interleaved complex bins
+void complexMultiplyAccumulate(float* acc, const float* a, const float* b, int numBins, float gain)
+{
+    for (int i = 0; i < numBins; ++i)
+    {
+        const float ar = a[2 * i], ai = a[2 * i + 1];
+        const float br = b[2 * i] * gain, bi = b[2 * i + 1] * gain;
+        acc[2 * i] += ar * br - ai * bi;
+        acc[2 * i + 1] += ar * bi + ai * br;
+    }
+}
+
+/// Equal-power gains: blend 0 is kernel A only, 1 is kernel B only
+void getBlendGains(float blend, float& gainA, float& gainB)
+{
+    const float angle = blend * juce::MathConstants<float>::halfPi;
+    gainA = std::cos(angle);
+    gainB = std::sin(angle);
+}
+
+/// Level layout as (partition, offset) pairs. The first level starts right
+/// after the head; each tail level starts at twice its partition size.
+std::vector<std::pair<int, int>> getLevelLayout(int length, int headSize)
+{
+    std::vector<std::pair<int, int>> layout;
+    layout.emplace_back(headSize, headSize);
+    for (int p = headSize * tailRatio; p <= maxPartitionSize && 2 * p < length; p *= tailRatio)
+        layout.emplace_back(p, 2 * p);
+    return layout;
+}
+
+} // namespace
+
+//==============================================================================
+PartitionedConvolver::Kernel::Kernel(const juce::AudioBuffer<float>& ir, int headSizeToUse)
+    : numChannels(juce::jlimit(1, maxChannels, ir.getNumChannels())), length(ir.getNumSamples()),
+      headSize(headSizeToUse)
+{
+    // Head taps are stored reversed so the FIR is a straight dot product
+    head.resize(static_cast<size_t>(numChannels));
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        head[ch].assign(static_cast<size_t>(headSize), 0.0f);
+        for (int k = 0; k < juce::jmin(headSize, length); ++k)
+            head[ch][static_cast<size_t>(headSize - 1 - k)] = ir.getSample(ch, k);
+    }
+
+    const auto layout = getLevelLayout(length, headSize);
+    for (size_t i = 0; i < layout.size(); ++i)
+    {
+        const int partition = layout[i].first;
+        const int offset = layout[i].second;
+        if (offset >= length)
+            break;
+
+        const int end = i + 1 < layout.size() ? layout[i + 1].second : length;
+
+        Segment segment;
+        segment.partitionSize = partition;
+        segment.offset = offset;
+        segment.numPartitions = (end - offset + partition - 1) / partition;
+        segment.background = i > 0;
+
+        const int spectrumSize = 2 * (partition + 1);
+        juce::dsp::FFT fft(log2Of(2 * partition));
+        std::vector<float> work(static_cast<size_t>(4 * partition));
+
+        segment.spectra.resize(static_cast<size_t>(numChannels));
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            auto& spectra = segment.spectra[static_cast<size_t>(ch)];
+            spectra.assign(static_cast<size_t>(segment.numPartitions * spectrumSize), 0.0f);
+
+            const float* source = ir.getReadPointer(ch);
+            for (int m = 0; m < segment.numPartitions; ++m)
+            {
+                const int first = offset + m * partition;
+                const int count = juce::jmin(partition, end - first);
+
+                std::fill(work.begin(), work.end(), 0.0f);
+                std::copy(source + first, source + first + count, work.begin());
+                fft.performRealOnlyForwardTransform(work.data(), true);
+                std::copy(work.begin(), work.begin() + spectrumSize, spectra.begin() + m * spectrumSize);
+            }
+        }
+
+        segments.push_back(std::move(segment));
+    }
+}
+
+size_t PartitionedConvolver::Kernel::getMemoryUsage() const
+{
+    size_t floats = 0;
+    for (const auto& taps : head)
+        floats += taps.size();
+    for (const auto& segment : segments)
+        for (const auto& spectra : segment.spectra)
+            floats += spectra.size();
+    return floats * sizeof(float);
+}
+
+//==============================================================================
+/**
+    Per-instance convolution history for one kernel, or for two kernels that
+    share the input history and are blended with equal-power gains. Everything
+    is allocated up front; process() and the worker never allocate.
+*/
+struct PartitionedConvolver::State
+{
+    /// Kernel A and B pre-mixed at one blend value. Two sets are kept so the
+    /// worker can fill one while the audio thread reads the other.
+    struct MixSet
+    {
+        float blend = -1.0f;
+        std::vector<std::vector<float>> head;                 // [channel]
+        std::vector<std::vector<std::vector<float>>> spectra; // [level][channel]
+    };
+
+    struct Level
+    {
+        Level(const Kernel::Segment* a, const Kernel::Segment* b)
+            : segmentA(a), segmentB(b), partitionSize(a != nullptr ? a->partitionSize : b->partitionSize),
+              numPartitions(juce::jmax(a != nullptr ? a->numPartitions : 0, b != nullptr ? b->numPartitions : 0)),
+              spectrumSize(2 * (partitionSize + 1)), background((a != nullptr ? a : b)->background),
+              fft(log2Of(2 * partitionSize))
+        {
+            const int p = partitionSize;
+            inputWindow.setSize(maxChannels, 2 * p);
+            output.setSize(maxChannels, p);
+            jobInput.setSize(maxChannels, 2 * p);
+            jobOutput.setSize(maxChannels, p);
+            inputWindow.clear();
+            output.clear();
+            jobInput.clear();
+            jobOutput.clear();
+
+            delayLine.resize(maxChannels);
+            for (auto& line : delayLine)
+                line.assign(static_cast<size_t>(numPartitions * spectrumSize), 0.0f);
+
+            fftBuffer.assign(static_cast<size_t>(4 * p), 0.0f);
+            accumulator.assign(static_cast<size_t>(spectrumSize), 0.0f);
+        }
+
+        /// Accumulates the spectra of one kernel against the delay line
+        void multiplyAccumulate(const float* line, const float* spectra, int count, float gain)
+        {
+            for (int i = 0; i < count; ++i)
+            {
+                const int slot = (delayLinePosition - i + numPartitions) % numPartitions;
+                complexMultiplyAccumulate(accumulator.data(), line + slot * spectrumSize, spectra + i * spectrumSize,
+                                          partitionSize + 1, gain);
+            }
+        }
+
+        const Kernel::Segment* segmentA;
+        const Kernel::Segment* segmentB; // nullptr unless blending
+        const int partitionSize;
+        const int numPartitions; // Delay line length: the larger of A and B
+        const int spectrumSize;
+        const bool background;
+        juce::dsp::FFT fft;
+
+        juce::AudioBuffer<float> inputWindow; // [previous P | current P]
+        juce::AudioBuffer<float> output;      // Output for the current period
+        std::vector<std::vector<float>> delayLine;
+        int delayLinePosition = 0;
+        std::vector<float> fftBuffer;
+        std::vector<float> accumulator;
+
+        // Background hand-off (tail levels only)
+        juce::AudioBuffer<float> jobInput;
+        juce::AudioBuffer<float> jobOutput;
+        int jobChannels = 0;
+        float jobBlend = 0.0f;
+        std::atomic<int> jobStatus{JobIdle};
+        std::atomic<juce::int64> jobDeadline{0};
+    };
+
+    State(KernelPtr a, KernelPtr b, double rate, std::atomic<int>& misses, const std::atomic<bool>& offline)
+        : kernel(std::move(a)), kernelB(std::move(b)), headSize(kernel->headSize), sampleRate(rate),
+          deadlineMisses(misses), nonRealtime(offline)
+    {
+        jassert(kernelB == nullptr || kernelB->headSize == headSize);
+
+        headHistory.setSize(maxChannels, 2 * headSize - 1);
+        headHistory.clear();
+
+        const size_t numSegmentsB = kernelB != nullptr ? kernelB->segments.size() : 0;
+        const size_t numLevels = juce::jmax(kernel->segments.size(), numSegmentsB);
+        for (size_t i = 0; i < numLevels; ++i)
+        {
+            const auto* a = i < kernel->segments.size() ? &kernel->segments[i] : nullptr;
+            const auto* b = i < numSegmentsB ? &kernelB->segments[i] : nullptr;
+            levels.push_back(std::make_unique<Level>(a, b));
+        }
+
+        if (kernelB != nullptr)
+        {
+            for (auto& set : mixSets)
+            {
+                set.head.assign(maxChannels, std::vector<float>(static_cast<size_t>(headSize), 0.0f));
+                for (auto& level : levels)
+                    set.spectra.emplace_back(
+                        maxChannels, std::vector<float>(static_cast<size_t>(level->numPartitions * level->spectrumSize)));
+            }
+        }
+    }
+
+    bool isBlending() const { return kernelB != nullptr; }
+
+    void process(float* const* channels, int numChannels, int numSamples, float blend)
+    {
+        activeChannels = numChannels;
+
+        if (isBlending() && blend != currentBlend)
+        {
+            currentBlend = blend;
+            blendTarget.store(blend, std::memory_order_relaxed);
+            blendChangedAt.store(juce::Time::getMillisecondCounter(), std::memory_order_relaxed);
+        }
+
+        int done = 0;
+        while (done < numSamples)
+        {
+            if (position % headSize == 0)
+                advanceLevels();
+
+            const int untilBoundary = headSize - static_cast<int>(position % headSize);
+            const int chunk = juce::jmin(untilBoundary, numSamples - done);
+
+            float* chunkChannels[maxChannels] = {};
+            for (int ch = 0; ch < numChannels; ++ch)
+                chunkChannels[ch] = channels[ch] + done;
+
+            processChunk(chunkChannels, numChannels, chunk);
+            position += chunk;
+            done += chunk;
+        }
+    }
+
+    /// Processes samples that don't cross a head-size boundary
+    void processChunk(float* const* channels, int numChannels, int numSamples)
+    {
+        const MixSet* mix = acquireMix(currentBlend);
+        float gainA = 1.0f, gainB = 0.0f;
+        if (isBlending())
+            getBlendGains(currentBlend, gainA, gainB);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            float* data = channels[ch];
+            float* history = headHistory.getWritePointer(ch);
+
+            std::copy(data, data + numSamples, history + headSize - 1);
+            for (auto& level : levels)
+            {
+                const int p = level->partitionSize;
+                const int offset = static_cast<int>(position % p);
+                std::copy(data, data + numSamples, level->inputWindow.getWritePointer(ch, p + offset));
+            }
+
+            // Direct-form head: pre-mixed taps, or both kernels while the blend moves
+            if (mix != nullptr)
+                applyHead(data, history, mix->head[static_cast<size_t>(ch)].data(), numSamples, 1.0f, false);
+            else
+            {
+                applyHead(data, history, getHeadTaps(*kernel, ch), numSamples, gainA, false);
+                if (isBlending())
+                    applyHead(data, history, getHeadTaps(*kernelB, ch), numSamples, gainB, true);
+            }
+            std::copy(history + numSamples, history + numSamples + headSize - 1, history);
+
+            // Partitioned levels
+            for (auto& level : levels)
+            {
+                const int offset = static_cast<int>(position % level->partitionSize);
+                juce::FloatVectorOperations::add(data, level->output.getReadPointer(ch, offset), numSamples);
+            }
+        }
+
+        releaseMix(mix);
+    }
+
+    void applyHead(float* data, const float* history, const float* taps, int numSamples, float gain, bool accumulate)
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float* x = history + i;
+            float sum = 0.0f;
+            for (int k = 0; k < headSize; ++k)
+                sum += taps[k] * x[k];
+            data[i] = (accumulate ? data[i] : 0.0f) + gain * sum;
+        }
+    }
+
+    static const float* getHeadTaps(const Kernel& k, int channel)
+    {
+        return k.head[static_cast<size_t>(juce::jmin(channel, k.numChannels - 1))].data();
+    }
+
+    static const float* getSpectra(const Kernel& k, const Kernel::Segment& segment, int channel)
+    {
+        return segment.spectra[static_cast<size_t>(juce::jmin(channel, k.numChannels - 1))].data();
+    }
+
+    /// Overlap-save: convolves the 2P window with every partition of the
+    /// level and writes the P valid output samples to destination.
+    void computeLevel(Level& level, size_t levelIndex, const juce::AudioBuffer<float>& window,
+                      juce::AudioBuffer<float>& destination, int numChannels, float blend)
+    {
+        const int p = level.partitionSize;
+        float* work = level.fftBuffer.data();
+        float* acc = level.accumulator.data();
+
+        const MixSet* mix = acquireMix(blend);
+        float gainA = 1.0f, gainB = 0.0f;
+        if (isBlending())
+            getBlendGains(blend, gainA, gainB);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            float* line = level.delayLine[static_cast<size_t>(ch)].data();
+
+            std::copy(window.getReadPointer(ch), window.getReadPointer(ch) + 2 * p, work);
+            std::fill(work + 2 * p, work + 4 * p, 0.0f);
+            level.fft.performRealOnlyForwardTransform(work, true);
+            std::copy(work, work + level.spectrumSize, line + level.delayLinePosition * level.spectrumSize);
+
+            std::fill(acc, acc + level.spectrumSize, 0.0f);
+            if (mix != nullptr)
+                level.multiplyAccumulate(line, mix->spectra[levelIndex][static_cast<size_t>(ch)].data(),
+                                         level.numPartitions, 1.0f);
+            else
+            {
+                if (level.segmentA != nullptr)
+                    level.multiplyAccumulate(line, getSpectra(*kernel, *level.segmentA, ch),
+                                             level.segmentA->numPartitions, gainA);
+                if (level.segmentB != nullptr)
+                    level.multiplyAccumulate(line, getSpectra(*kernelB, *level.segmentB, ch),
+                                             level.segmentB->numPartitions, gainB);
+            }
+
+            std::copy(acc, acc + level.spectrumSize, work);
+            std::fill(work + level.spectrumSize, work + 4 * p, 0.0f);
+            level.fft.performRealOnlyInverseTransform(work);
+            std::copy(work + p, work + 2 * p, destination.getWritePointer(ch));
+        }
+
+        releaseMix(mix);
+        level.delayLinePosition = (level.delayLinePosition + 1) % level.numPartitions;
+    }
+
+    /// Called at every head-size boundary: levels whose period just ended
+    /// produce the output for their next period.
+    void advanceLevels()
+    {
+        for (size_t i = 0; i < levels.size(); ++i)
+        {
+            auto& level = *levels[i];
+            const int p = level.partitionSize;
+            if (position % p != 0)
+                continue;
+
+            if (!level.background)
+                computeLevel(level, i, level.inputWindow, level.output, activeChannels, currentBlend);
+            else
+            {
+                collect(level, i);
+                submit(level);
+            }
+
+            for (int ch = 0; ch < activeChannels; ++ch)
+                level.inputWindow.copyFrom(ch, 0, level.inputWindow, ch, p, p);
+        }
+    }
+
+    void collect(Level& level, size_t levelIndex)
+    {
+        int status = level.jobStatus.load(std::memory_order_acquire);
+        if (status == JobIdle)
+        {
+            level.output.clear();
+            return;
+        }
+
+        if (status == JobQueued &&
+            level.jobStatus.compare_exchange_strong(status, JobRunning, std::memory_order_acq_rel))
+        {
+            // Worker never got to it: do it here rather than drop out
+            computeLevel(level, levelIndex, level.jobInput, level.jobOutput, level.jobChannels, level.jobBlend);
+            level.jobStatus.store(JobDone, std::memory_order_release);
+            deadlineMisses.fetch_add(1, std::memory_order_relaxed);
+        }
+        else if (status != JobDone)
+        {
+            deadlineMisses.fetch_add(1, std::memory_order_relaxed);
+
+            // The worker is partway through it. Never wait for it in real time: play the
+            // previous period's output again and pick the result up at the next boundary.
+            if (!nonRealtime.load(std::memory_order_relaxed))
+                return;
+
+            while (level.jobStatus.load(std::memory_order_acquire) != JobDone)
+                std::this_thread::yield();
+        }
+
+        for (int ch = 0; ch < level.jobChannels; ++ch)
+            level.output.copyFrom(ch, 0, level.jobOutput, ch, 0, level.partitionSize);
+        level.jobStatus.store(JobIdle, std::memory_order_release);
+    }
+
+    void submit(Level& level);
+
+    //==========================================================================
+    // Pre-mixed kernel hand-off. The worker fills the inactive set and
+    // publishes it; readers pin a set so it is never rewritten under them.
+
+    const MixSet* acquireMix(float blend)
+    {
+        if (!isBlending())
+            return nullptr;
+
+        for (;;)
+        {
+            const int index = activeMix.load(std::memory_order_acquire);
+            if (index < 0)
+                return nullptr;
+
+            mixReaders[index].fetch_add(1, std::memory_order_acq_rel);
+            if (activeMix.load(std::memory_order_acquire) == index)
+            {
+                if (mixSets[static_cast<size_t>(index)].blend == blend)
+                    return &mixSets[static_cast<size_t>(index)];
+
+                mixReaders[index].fetch_sub(1, std::memory_order_release);
+                return nullptr;
+            }
+            mixReaders[index].fetch_sub(1, std::memory_order_release);
+        }
+    }
+
+    void releaseMix(const MixSet* mix)
+    {
+        if (mix != nullptr)
+            mixReaders[mix == &mixSets[0] ? 0 : 1].fetch_sub(1, std::memory_order_release);
+    }
+
+    /// True once the blend has been still long enough and differs from the
+    /// published pre-mix. Worker thread.
+    /// True while the blend has moved away from the published pre-mix
+    bool isMixPending() const
+    {
+        return isBlending() &&
+               blendTarget.load(std::memory_order_relaxed) != mixedBlend.load(std::memory_order_relaxed);
+    }
+
+    bool needsMix(juce::uint32 now) const
+    {
+        if (!isBlending())
+            return false;
+
+        const float target = blendTarget.load(std::memory_order_relaxed);
+        return target != mixedBlend.load(std::memory_order_relaxed) &&
+               now - blendChangedAt.load(std::memory_order_relaxed) >= static_cast<juce::uint32>(blendSettleMs);
+    }
+
+    /// Builds the pre-mixed kernel for the current target blend. Worker thread.
+    void buildMix()
+    {
+        const float blend = blendTarget.load(std::memory_order_relaxed);
+        const int target = activeMix.load(std::memory_order_acquire) == 0 ? 1 : 0;
+        while (mixReaders[target].load(std::memory_order_acquire) != 0)
+            std::this_thread::yield();
+
+        float gainA, gainB;
+        getBlendGains(blend, gainA, gainB);
+        auto& set = mixSets[static_cast<size_t>(target)];
+
+        for (int ch = 0; ch < maxChannels; ++ch)
+        {
+            const float* a = getHeadTaps(*kernel, ch);
+            const float* b = getHeadTaps(*kernelB, ch);
+            auto& taps = set.head[static_cast<size_t>(ch)];
+            for (int k = 0; k < headSize; ++k)
+                taps[static_cast<size_t>(k)] = gainA * a[k] + gainB * b[k];
+        }
+
+        for (size_t i = 0; i < levels.size(); ++i)
+        {
+            const auto& level = *levels[i];
+            for (int ch = 0; ch < maxChannels; ++ch)
+            {
+                auto& spectra = set.spectra[i][static_cast<size_t>(ch)];
+                std::fill(spectra.begin(), spectra.end(), 0.0f);
+
+                if (level.segmentA != nullptr)
+                    juce::FloatVectorOperations::addWithMultiply(
+                        spectra.data(), getSpectra(*kernel, *level.segmentA, ch), gainA,
+                        level.segmentA->numPartitions * level.spectrumSize);
+                if (level.segmentB != nullptr)
+                    juce::FloatVectorOperations::addWithMultiply(
+                        spectra.data(), getSpectra(*kernelB, *level.segmentB, ch), gainB,
+                        level.segmentB->numPartitions * level.spectrumSize);
+            }
+        }
+
+        set.blend = blend;
+        mixedBlend.store(blend, std::memory_order_relaxed);
+        activeMix.store(target, std::memory_order_release);
+    }
+
+    bool hasMixFor(float blend) const
+    {
+        return isBlending() && activeMix.load(std::memory_order_acquire) >= 0 &&
+               mixedBlend.load(std::memory_order_relaxed) == blend;
+    }
+
+    //==========================================================================
+    KernelPtr kernel;
+    KernelPtr kernelB; // Second IR when blending
+    const int headSize;
+    const double sampleRate;
+
+    juce::AudioBuffer<float> headHistory; // [B - 1 previous | B current]
+    std::vector<std::unique_ptr<Level>> levels;
+    juce::int64 position = 0;
+    int activeChannels = maxChannels;
+    std::atomic<int>& deadlineMisses;
+    const std::atomic<bool>& nonRealtime;
+
+    // Blend (audio thread writes, worker reads)
+    float currentBlend = 0.0f;
+    std::atomic<float> blendTarget{0.0f};
+    std::atomic<juce::uint32> blendChangedAt{0};
+
+    std::array<MixSet, 2> mixSets;
+    std::atomic<int> activeMix{-1};
+    std::atomic<int> mixReaders[2] = {};
+    std::atomic<float> mixedBlend{-1.0f};
+};
+
+//==============================================================================
+/**
+    Shared background thread for tail levels of every convolver instance.
+    Picks the queued job with the earliest deadline; when idle, pre-mixes
+    blended kernels whose blend has settled.
+*/
+class PartitionedConvolver::Worker : public juce::Thread
+{
+  public:
+    static Worker& getInstance()
+    {
+        static Worker instance;
+        return instance;
+    }
+
+    void add(State* state)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        states.push_back(state);
+    }
+
+    /// Unregisters state, blocking until the worker has finished any job of it
+    void remove(State* state)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        states.erase(std::remove(states.begin(), states.end(), state), states.end());
+        jobFinished.wait(lock, [&] { return runningState != state; });
+    }
+
+    /// Audio thread: a job was queued. Wakes the worker through the semaphore,
+    /// as notify() takes a lock; only the first job since the worker last
+    /// looked posts it.
+    void jobQueued()
+    {
+        if (!jobsPending.exchange(true, std::memory_order_acq_rel))
+            wakeSignal.post();
+    }
+
+    /// Stops the thread for good. Jobs queued after this are computed by the
+    /// audio thread when they fall due.
+    void shutdown()
+    {
+        signalThreadShouldExit();
+        wakeSignal.post();
+        stopThread(stopTimeoutMs);
+    }
+
+  private:
+    Worker() : juce::Thread("ConvolutionWorker") { startThread(juce::Thread::Priority::highest); }
+    ~Worker() override { shutdown(); }
+
+    void run() override
+    {
+        while (!threadShouldExit())
+        {
+            State::Level* job = nullptr;
+            size_t jobIndex = 0;
+            State* owner = nullptr;
+            State* mixOwner = nullptr;
+            bool mixWaiting = false;
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                juce::int64 earliest = std::numeric_limits<juce::int64>::max();
+
+                for (auto* state : states)
+                {
+                    for (size_t i = 0; i < state->levels.size(); ++i)
+                    {
+                        auto& level = *state->levels[i];
+                        if (!level.background || level.jobStatus.load(std::memory_order_acquire) != JobQueued)
+                            continue;
+
+                        const auto deadline = level.jobDeadline.load(std::memory_order_relaxed);
+                        if (deadline < earliest)
+                        {
+                            earliest = deadline;
+                            job = &level;
+                            jobIndex = i;
+                            owner = state;
+                        }
+                    }
+                }
+
+                int expected = JobQueued;
+                if (job != nullptr &&
+                    job->jobStatus.compare_exchange_strong(expected, JobRunning, std::memory_order_acq_rel))
+                    runningState = owner;
+                else
+                    job = nullptr;
+
+                // Nothing due: use the slack for a settled blend
+                if (job == nullptr)
+                {
+                    const auto now = juce::Time::getMillisecondCounter();
+                    for (auto* state : states)
+                    {
+                        if (state->needsMix(now))
+                        {
+                            mixOwner = state;
+                            runningState = state;
+                            break;
+                        }
+                        mixWaiting = mixWaiting || state->isMixPending();
+                    }
+                }
+            }
+
+            if (job != nullptr)
+            {
+                owner->computeLevel(*job, jobIndex, job->jobInput, job->jobOutput, job->jobChannels, job->jobBlend);
+                job->jobStatus.store(JobDone, std::memory_order_release);
+            }
+            else if (mixOwner != nullptr)
+                mixOwner->buildMix();
+            else
+            {
+                // Nothing to do: sleep until process() queues a job, unless one came in
+                // during the scan. A blend that's settling is looked at again shortly.
+                if (!jobsPending.exchange(false, std::memory_order_acq_rel))
+                    wakeSignal.wait(mixWaiting ? workerMixWaitMs : workerIdleWaitMs);
+                continue;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                runningState = nullptr;
+            }
+            jobFinished.notify_all();
+        }
+    }
+
+    std::mutex mutex;
+    std::condition_variable jobFinished;
+    std::vector<State*> states;
+    State* runningState = nullptr;
+    std::atomic<bool> jobsPending{false};
+    WakeSignal wakeSignal;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Worker)
+};
+
+//==============================================================================
+/**
+    Builds the kernels for a convolver's file loads on a shared background
+    thread, so decoding and the partition FFTs stay off the message thread.
+    Only the newest request is kept, and its result is dropped if a later
+    load, clear() or prepare() has superseded it by the time it's ready.
+*/
+class PartitionedConvolver::Loader : public juce::TimeSliceClient
+{
+  public:
+    struct Request
+    {
+        juce::File fileA;
+        juce::File fileB; // Empty for a single IR
+        double sampleRate = 0.0;
+        int headSize = 0;
+        IRAnalysis::Options options;
+        juce::uint32 generation = 0;
+    };
+
+    explicit Loader(PartitionedConvolver& ownerToUse) : owner(ownerToUse) {}
+
+    /// Blocks until any load in progress for the owner has finished
+    ~Loader() override { getThread().removeTimeSliceClient(this); }
+
+    void post(Request request)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            pending = std::move(request);
+        }
+
+        if (stopped.load())
+            return;
+
+        auto& thread = getThread();
+        thread.addTimeSliceClient(this);
+        if (!thread.isThreadRunning())
+            thread.startThread();
+    }
+
+    /// Stops the thread for good; later loads are ignored
+    static void shutdown()
+    {
+        stopped.store(true);
+        getThread().stopThread(stopTimeoutMs);
+    }
+
+    int useTimeSlice() override
+    {
+        std::optional<Request> request;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            request.swap(pending);
+        }
+        if (!request.has_value())
+            return loaderIdleWaitMs;
+
+        auto& cache = IRCache::getInstance();
+        const auto build = [&](const juce::File& file) -> KernelPtr
+        {
+            if (file == juce::File())
+                return nullptr;
+            return cache.getKernel(file, request->sampleRate, request->headSize, request->options);
+        };
+
+        auto kernelA = build(request->fileA);
+        auto kernelB = build(request->fileB);
+
+        // Blended IRs only lose the pre-delay they have in common, so they keep
+        // their alignment: the one that lost more is rebuilt with the smaller cut
+        if (request->options.stripLeadingSilence && kernelA != nullptr && kernelB != nullptr)
+        {
+            const int removedA = kernelA->analysis.leadingSamplesRemoved;
+            const int removedB = kernelB->analysis.leadingSamplesRemoved;
+            request->options.maxLeadingSamples = juce::jmin(removedA, removedB);
+
+            if (removedA > removedB)
+                kernelA = build(request->fileA);
+            else if (removedB > removedA)
+                kernelB = build(request->fileB);
+        }
+
+        owner.finishLoad(request->generation, std::move(kernelA), std::move(kernelB));
+        return 0;
+    }
+
+  private:
+    static juce::TimeSliceThread& getThread()
+    {
+        static juce::TimeSliceThread thread("IR Loader");
+        return thread;
+    }
+
+    PartitionedConvolver& owner;
+    std::mutex mutex;
+    std::optional<Request> pending;
+
+    static inline std::atomic<bool> stopped{false};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Loader)
+};
+
+//==============================================================================
+void PartitionedConvolver::State::submit(Level& level)
+{
+    // The worker still has the last job (see collect): skip this period rather
+    // than overwrite its input
+    if (level.jobStatus.load(std::memory_order_acquire) != JobIdle)
+        return;
+
+    for (int ch = 0; ch < activeChannels; ++ch)
+        level.jobInput.copyFrom(ch, 0, level.inputWindow, ch, 0, 2 * level.partitionSize);
+    level.jobChannels = activeChannels;
+    level.jobBlend = currentBlend;
+
+    // Output is due one partition period from now
+    const auto period = juce::Time::secondsToHighResolutionTicks(level.partitionSize / sampleRate);
+    level.jobDeadline.store(juce::Time::getHighResolutionTicks() + period, std::memory_order_relaxed);
+    level.jobStatus.store(JobQueued, std::memory_order_release);
+
+    Worker::getInstance().jobQueued();
+}
+
+//==============================================================================
+PartitionedConvolver::PartitionedConvolver() : loader(std::make_unique<Loader>(*this)) {}
+
+PartitionedConvolver::~PartitionedConvolver()
+{
+    loader.reset();
+
+    std::lock_guard<std::mutex> lock(loadLock);
+    swapState(nullptr, false);
+}
+
+void PartitionedConvolver::prepare(double newSampleRate, int newMaxBlockSize)
+{
+    std::lock_guard<std::mutex> lock(loadLock);
+
+    const int newHeadSize = chooseHeadSize(newMaxBlockSize);
+    const bool formatChanged = newSampleRate != sampleRate || newHeadSize != headSize;
+
+    sampleRate = newSampleRate;
+    maxBlockSize = juce::jmax(1, newMaxBlockSize);
+    headSize = newHeadSize;
+    fadeLength = juce::jmax(1, static_cast<int>(sampleRate * crossfadeSeconds));
+    fadeBuffer.setSize(maxChannels, maxBlockSize);
+
+    // The current kernels keep playing (at the old format, if that changed)
+    // until the loader has rebuilt them
+    swapState(kernel != nullptr ? createState(kernel, kernelB) : nullptr, false);
+
+    const bool missing = kernel == nullptr || (currentFileB != juce::File() && kernelB == nullptr);
+    if (currentFile != juce::File() && (formatChanged || missing))
+        postLoad();
+}
+
+bool PartitionedConvolver::loadImpulseResponse(const juce::File& file)
+{
+    if (!file.existsAsFile())
+        return false;
+
+    std::lock_guard<std::mutex> lock(loadLock);
+    currentFile = file;
+    currentFileB = juce::File();
+    postLoad();
+    return true;
+}
+
+bool PartitionedConvolver::loadImpulseResponses(const juce::File& fileA, const juce::File& fileB)
+{
+    if (!fileA.existsAsFile() || !fileB.existsAsFile())
+        return false;
+
+    std::lock_guard<std::mutex> lock(loadLock);
+    currentFile = fileA;
+    currentFileB = fileB;
+    postLoad();
+    return true;
+}
+
+void PartitionedConvolver::postLoad()
+{
+    ++generation;
+
+    // Not prepared yet: prepare() posts it
+    if (sampleRate <= 0.0)
+        return;
+
+    Loader::Request request;
+    request.fileA = currentFile;
+    request.fileB = currentFileB;
+    request.sampleRate = sampleRate;
+    request.headSize = headSize;
+    request.options = analysisOptions;
+    request.generation = generation;
+    loader->post(std::move(request));
+}
+
+void PartitionedConvolver::finishLoad(juce::uint32 loadGeneration, KernelPtr newKernelA, KernelPtr newKernelB)
+{
+    std::lock_guard<std::mutex> lock(loadLock);
+    if (loadGeneration != generation)
+        return;
+
+    // A file that couldn't be read drops out; the other one plays on its own
+    if (newKernelA == nullptr)
+        std::swap(newKernelA, newKernelB);
+    if (newKernelA == nullptr)
+        spdlog::warn("[PartitionedConvolver] No readable IR in {}", currentFile.getFileName().toStdString());
+
+    kernel = std::move(newKernelA);
+    kernelB = std::move(newKernelB);
+    swapState(kernel != nullptr ? createState(kernel, kernelB) : nullptr, true);
+}
+
+void PartitionedConvolver::shutdownBackgroundThreads()
+{
+    Loader::shutdown();
+    Worker::getInstance().shutdown();
+}
+
+void PartitionedConvolver::setAnalysisOptions(const IRAnalysis::Options& newOptions)
+{
+    std::lock_guard<std::mutex> lock(loadLock);
+    analysisOptions = newOptions;
+}
+
+std::shared_ptr<const IRAnalysis::Report> PartitionedConvolver::getAnalysis(bool secondIR) const
+{
+    std::lock_guard<std::mutex> lock(loadLock);
+    const auto& source = secondIR ? kernelB : kernel;
+    return source != nullptr ? std::shared_ptr<const IRAnalysis::Report>(source, &source->analysis) : nullptr;
+}
+
+void PartitionedConvolver::setKernel(KernelPtr newKernel)
+{
+    setKernels(std::move(newKernel), nullptr);
+}
+
+void PartitionedConvolver::setKernels(KernelPtr newKernelA, KernelPtr newKernelB)
+{
+    std::lock_guard<std::mutex> lock(loadLock);
+    ++generation;
+    kernel = std::move(newKernelA);
+    kernelB = kernel != nullptr ? std::move(newKernelB) : nullptr;
+    swapState(kernel != nullptr ? createState(kernel, kernelB) : nullptr, true);
+}
+
+void PartitionedConvolver::clear()
+{
+    std::lock_guard<std::mutex> lock(loadLock);
+    ++generation;
+    currentFile = juce::File();
+    currentFileB = juce::File();
+    kernel = nullptr;
+    kernelB = nullptr;
+    swapState(nullptr, false);
+}
+
+void PartitionedConvolver::reset()
+{
+    std::lock_guard<std::mutex> lock(loadLock);
+    swapState(kernel != nullptr ? createState(kernel, kernelB) : nullptr, false);
+}
+
+bool PartitionedConvolver::isLoaded() const
+{
+    std::lock_guard<std::mutex> lock(loadLock);
+    return kernel != nullptr;
+}
+
+bool PartitionedConvolver::isBlending() const
+{
+    std::lock_guard<std::mutex> lock(loadLock);
+    return kernelB != nullptr;
+}
+
+void PartitionedConvolver::setNonRealtime(bool shouldWaitForWorker)
+{
+    nonRealtime.store(shouldWaitForWorker, std::memory_order_relaxed);
+}
+
+void PartitionedConvolver::setBlend(float newBlend)
+{
+    blend.store(juce::jlimit(0.0f, 1.0f, newBlend), std::memory_order_relaxed);
+}
+
+bool PartitionedConvolver::isUsingPremixedBlend() const
+{
+    const juce::SpinLock::ScopedLockType lock(stateLock);
+    return active != nullptr && active->hasMixFor(active->currentBlend);
+}
+
+//==============================================================================
+void PartitionedConvolver::process(juce::AudioBuffer<float>& buffer)
+{
+    const int numChannels = juce::jmin(buffer.getNumChannels(), maxChannels);
+    const int numSamples = buffer.getNumSamples();
+    if (numChannels == 0 || numSamples == 0)
+        return;
+
+    const float currentBlend = blend.load(std::memory_order_relaxed);
+    const juce::SpinLock::ScopedLockType lock(stateLock);
+
+    for (int start = 0; start < numSamples; start += maxBlockSize)
+    {
+        const int n = juce::jmin(maxBlockSize, numSamples - start);
+
+        float* channels[maxChannels] = {};
+        float* fadeChannels[maxChannels] = {};
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            channels[ch] = buffer.getWritePointer(ch, start);
+            fadeChannels[ch] = fadeBuffer.getWritePointer(ch);
+        }
+
+        const bool isFading = fading != nullptr && fadeSamplesRemaining > 0;
+        if (isFading)
+            for (int ch = 0; ch < numChannels; ++ch)
+                fadeBuffer.copyFrom(ch, 0, buffer, ch, start, n);
+
+        if (active != nullptr)
+            active->process(channels, numChannels, n, currentBlend);
+        else
+            for (int ch = 0; ch < numChannels; ++ch)
+                juce::FloatVectorOperations::clear(channels[ch], n);
+
+        if (isFading)
+        {
+            fading->process(fadeChannels, numChannels, n, currentBlend);
+
+            // Linear crossfade, old kernel out, new kernel in
+            const float step = 1.0f / static_cast<float>(fadeLength);
+            const float startGain = 1.0f - static_cast<float>(fadeSamplesRemaining) * step;
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                for (int i = 0; i < n; ++i)
+                {
+                    const float gain = juce::jlimit(0.0f, 1.0f, startGain + static_cast<float>(i) * step);
+                    channels[ch][i] = channels[ch][i] * gain + fadeChannels[ch][i] * (1.0f - gain);
+                }
+            }
+            fadeSamplesRemaining = juce::jmax(0, fadeSamplesRemaining - n);
+        }
+    }
+}
+
+//==============================================================================
+std::unique_ptr<PartitionedConvolver::State> PartitionedConvolver::createState(KernelPtr forKernel,
+                                                                              KernelPtr forKernelB)
+{
+    return std::make_unique<State>(std::move(forKernel), std::move(forKernelB), sampleRate, deadlineMisses,
+                                   nonRealtime);
+}
+
+void PartitionedConvolver::swapState(std::unique_ptr<State> newState, bool crossfade)
+{
+    if (newState != nullptr)
+        Worker::getInstance().add(newState.get());
+
+    std::unique_ptr<State> retiredFading, retiredActive;
+    {
+        const juce::SpinLock::ScopedLockType lock(stateLock);
+
+        retiredFading = std::move(fading);
+        if (crossfade && active != nullptr)
+        {
+            fading = std::move(active);
+            fadeSamplesRemaining = fadeLength;
+        }
+        else
+        {
+            retiredActive = std::move(active);
+            fadeSamplesRemaining = 0;
+        }
+        active = std::move(newState);
+    }
+
+    // Off the audio thread: wait out any in-flight job, then free
+    for (auto* retired : {retiredFading.get(), retiredActive.get()})
+        if (retired != nullptr)
+            Worker::getInstance().remove(retired);
+}
+
+//==============================================================================
+int PartitionedConvolver::chooseHeadSize(int maxBlockSize)
+{
+    return juce::jlimit(minHeadSize, maxHeadSize, juce::nextPowerOfTwo(juce::jmax(1, maxBlockSize)));
+}
+
+juce::AudioBuffer<float> PartitionedConvolver::readImpulseResponse(const juce::File& file, double sampleRate,
+                                                                   const IRAnalysis::Options& options,
+                                                                   IRAnalysis::Report* report)
+{
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+
+    std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
+    if (reader == nullptr || reader->lengthInSamples <= 0)
+        return {};
+
+    const int numChannels = juce::jlimit(1, maxChannels, static_cast<int>(reader->numChannels));
+    const auto maxLength = static_cast<juce::int64>(reader->sampleRate * maxImpulseSeconds);
+    const int length = static_cast<int>(juce::jmin(reader->lengthInSamples, maxLength));
+
+    juce::AudioBuffer<float> ir(numChannels, length);
+    reader->read(&ir, 0, length, 0, true, numChannels > 1);
+
+    if (ir.getMagnitude(0, length) < juce::Decibels::decibelsToGain(silenceThresholdDb))
+        return {};
+
+    // Resample to the processing rate
+    if (std::abs(reader->sampleRate - sampleRate) > 1.0e-3)
+    {
+        const double ratio = reader->sampleRate / sampleRate;
+        const int resampledLength = static_cast<int>(std::ceil(length / ratio));
+
+        juce::MemoryAudioSource memorySource(ir, false);
+        juce::ResamplingAudioSource resampler(&memorySource, false, numChannels);
+        resampler.setResamplingRatio(ratio);
+        resampler.prepareToPlay(resampledLength, sampleRate);
+
+        juce::AudioBuffer<float> resampled(numChannels, resampledLength);
+        juce::AudioSourceChannelInfo info(resampled);
+        resampler.getNextAudioBlock(info);
+        ir = std::move(resampled);
+    }
+
+    // Trim pre-delay and the noise tail (replaces a fixed -80 dB trim)
+    const auto analysis = IRAnalysis::process(ir, sampleRate, options);
+    if (report != nullptr)
+        *report = analysis;
+    if (ir.getNumSamples() == 0)
+        return {};
+
+    // Normalise by the loudest channel's energy
+    float maxPower = 0.0f;
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        const float* data = ir.getReadPointer(ch);
+        float power = 0.0f;
+        for (int i = 0; i < ir.getNumSamples(); ++i)
+            power += data[i] * data[i];
+        maxPower = juce::jmax(maxPower, power);
+    }
+
+    if (maxPower > 0.0f)
+        ir.applyGain(0.125f / std::sqrt(maxPower));
+
+    return ir;
+}
+
+double PartitionedConvolver::estimateCostPerSample(int length, int headSize)
+{
+    if (length <= 0)
+        return 0.0;
+
+    // Head FIR: one multiply-add per tap
+    double cost = 2.0 * juce::jmin(headSize, length);
+
+    const auto layout = getLevelLayout(length, headSize);
+    for (size_t i = 0; i < layout.size(); ++i)
+    {
+        const int partition = layout[i].first;
+        const int offset = layout[i].second;
+        if (offset >= length)
+            break;
+
+        const int end = i + 1 < layout.size() ? layout[i + 1].second : length;
+        const int numPartitions = (end - offset + partition - 1) / partition;
+
+        // Per period: forward + inverse real FFT of 2P, plus M complex MACs
+        const double fftSize = 2.0 * partition;
+        const double fftCost = 2.0 * 2.5 * fftSize * std::log2(fftSize);
+        const double macCost = 8.0 * (partition + 1) * numPartitions;
+        cost += (fftCost + macCost) / partition;
+    }
+    return cost;
+}
@@ -0,0 +1,229 @@
+/*
+  ==============================================================================
+
+    PartitionedConvolver.h
+    Zero-latency non-uniform partitioned convolution engine for cabinet and
+    room impulse responses
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "IRAnalysis.h"
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_core/juce_core.h>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+//==============================================================================
+/**
+    Non-uniform partitioned convolution with zero added latency.
+
+    The impulse response is split into:
+    - a direct-form FIR head covering the first B samples (B = head size,
+      derived from the host block size),
+    - a uniformly partitioned FFT level (partition B) computed on the audio
+      thread, and
+    - progressively larger tail levels (8x per step) that are convolved on a
+      shared background worker. A tail level with partition P starts at offset
+      2P, which gives the worker one full partition period to deliver the
+      result. Jobs are picked earliest-deadline-first; if one is still queued
+      when its output is due the audio thread computes it inline, so a late
+      worker costs CPU rather than a dropout. One the worker has already
+      started is never waited for: that level repeats its previous output
+      (see setNonRealtime for offline rendering).
+
+    Frequency-domain partitions live in an immutable Kernel obtained from
+    IRCache, so every instance loading the same file at the same sample rate
+    and head size shares one copy. Files are run through IRAnalysis on load,
+    which trims the tail at the capture's noise floor (and optionally
+    converts to minimum phase) before anything is partitioned.
+
+    Two kernels can be loaded at once and blended with equal-power gains
+    (setBlend). Both share one input history, so while the blend moves each
+    partition is multiplied against both kernels (one FFT pair, two
+    multiply-accumulates); once the blend has been still for 100 ms the
+    worker pre-mixes the kernels and the engine drops back to one.
+
+    Threading: prepare/load/clear are message-thread calls; process() is the
+    audio thread. Files are decoded and transformed on a shared loader thread,
+    and the previous IR keeps playing until the new one is ready. Kernel swaps
+    crossfade over ~50 ms and never allocate or free on the audio thread.
+    Call shutdownBackgroundThreads() once at application exit.
+*/
+class PartitionedConvolver
+{
+  public:
+    //==========================================================================
+    /**
+        Immutable, shareable frequency-domain representation of an IR.
+    */
+    struct Kernel
+    {
+        /// Builds the head taps and per-level partition spectra for ir.
+        Kernel(const juce::AudioBuffer<float>& ir, int headSize);
+
+        /// Approximate heap footprint, for cache accounting
+        size_t getMemoryUsage() const;
+
+        struct Segment
+        {
+            int partitionSize = 0; // P
+            int offset = 0;        // First IR sample covered
+            int numPartitions = 0; // M
+            bool background = false;
+
+            // Per channel: M spectra of (P + 1) interleaved complex bins
+            std::vector<std::vector<float>> spectra;
+        };
+
+        int numChannels = 0;
+        int length = 0;
+        int headSize = 0;
+
+        // Per channel, time-reversed head taps (headSize)
+        std::vector<std::vector<float>> head;
+        std::vector<Segment> segments;
+
+        // Load-time analysis of the source file (filled in by IRCache)
+        IRAnalysis::Report analysis;
+    };
+
+    using KernelPtr = std::shared_ptr<const Kernel>;
+
+    //==========================================================================
+    PartitionedConvolver();
+    ~PartitionedConvolver();
+
+    /// Sets the processing format. Rebuilds the current IR in the background
+    /// if the sample rate or head size changed. Must not run concurrently with
+    /// process().
+    void prepare(double sampleRate, int maxBlockSize);
+
+    /// Queues the file to be decoded, resampled, analysed (see
+    /// setAnalysisOptions) and normalised on the loader thread (like
+    /// juce::dsp::Convolution with Stereo::yes, Normalise::yes), then
+    /// crossfades to it. Returns false if the file doesn't exist; one that
+    /// turns out not to be readable is logged and leaves silence.
+    bool loadImpulseResponse(const juce::File& file);
+
+    /// Loads two IRs for blending (see setBlend). Returns false if either
+    /// file doesn't exist. If only one is readable it plays alone.
+    bool loadImpulseResponses(const juce::File& fileA, const juce::File& fileB);
+
+    /// Crossfades to an already-built kernel (nullptr fades to silence) straight
+    /// away, superseding any load in progress.
+    void setKernel(KernelPtr newKernel);
+
+    /// Crossfades to a pair of kernels built with the same head size.
+    /// kernelB may be nullptr for a single IR.
+    void setKernels(KernelPtr kernelA, KernelPtr kernelB);
+
+    /// Trimming / minimum-phase options for IR files, used from the next
+    /// load on. Message thread only.
+    void setAnalysisOptions(const IRAnalysis::Options& newOptions);
+    const IRAnalysis::Options& getAnalysisOptions() const { return analysisOptions; }
+
+    /// Analysis of the loaded IR (or of the second IR when blending), or
+    /// nullptr if none is loaded yet.
+    std::shared_ptr<const IRAnalysis::Report> getAnalysis(bool secondIR = false) const;
+
+    /// Equal-power blend between the two loaded IRs: 0 = A only, 1 = B only.
+    /// Ignored with a single IR. Safe to call from the audio thread.
+    void setBlend(float newBlend);
+
+    /// True if the current blend is being served by a pre-mixed kernel
+    bool isUsingPremixedBlend() const;
+
+    /// Drops the IR. Subsequent process() calls output silence.
+    void clear();
+
+    /// Clears convolution history without unloading the IR.
+    void reset();
+
+    /// Convolves up to two channels in place. Audio thread only.
+    void process(juce::AudioBuffer<float>& buffer);
+
+    /// True once a kernel is playing (a load finishes in the background)
+    bool isLoaded() const;
+    bool isBlending() const;
+    int getHeadSize() const { return headSize; }
+    double getSampleRate() const { return sampleRate; }
+
+    /// Offline rendering: the audio thread waits for a tail job the worker is
+    /// still running rather than repeating the previous output, so the result
+    /// is exact. Off by default.
+    void setNonRealtime(bool shouldWaitForWorker);
+
+    /// Number of tail jobs the audio thread had to compute (or stand in for)
+    /// because the worker missed its deadline.
+    int getDeadlineMisses() const { return deadlineMisses.load(std::memory_order_relaxed); }
+
+    /// Stops the shared worker and loader threads. Call once at application
+    /// exit; loads after this are ignored and tail levels run on the audio thread.
+    static void shutdownBackgroundThreads();
+
+    /// Reads an IR file into a buffer resampled to sampleRate, analysed with
+    /// options and normalised. Returns an empty buffer on failure or if the
+    /// file is silent. If report is given it receives the analysis.
+    static juce::AudioBuffer<float> readImpulseResponse(const juce::File& file, double sampleRate,
+                                                        const IRAnalysis::Options& options = {},
+                                                        IRAnalysis::Report* report = nullptr);
+
+    /// Rough audio + worker cost per sample (flops) of convolving an IR of
+    /// length samples, using the same partition layout as Kernel.
+    static double estimateCostPerSample(int length, int headSize);
+
+    /// Head size (and first-level partition size) used for a host block size
+    static int chooseHeadSize(int maxBlockSize);
+
+    static constexpr int maxChannels = 2;
+
+  private:
+    struct State;
+    class Worker;
+    class Loader;
+
+    // Callers hold loadLock
+    void postLoad();
+    std::unique_ptr<State> createState(KernelPtr forKernel, KernelPtr forKernelB);
+    void swapState(std::unique_ptr<State> newState, bool crossfade);
+
+    /// Loader thread: swaps in the kernels for a load unless it was superseded
+    void finishLoad(juce::uint32 loadGeneration, KernelPtr newKernelA, KernelPtr newKernelB);
+
+    double sampleRate = 0.0;
+    int maxBlockSize = 0;
+    int headSize = 0;
+
+    // Files, kernels and format, shared with the loader thread. Also
+    // serialises state swaps; never taken on the audio thread.
+    mutable std::mutex loadLock;
+    juce::File currentFile;
+    juce::File currentFileB;
+    IRAnalysis::Options analysisOptions;
+    KernelPtr kernel;
+    KernelPtr kernelB;
+    juce::uint32 generation = 0; // Bumped by every load, clear and kernel change
+    std::unique_ptr<Loader> loader;
+
+    std::atomic<float> blend{0.0f};
+    std::atomic<bool> nonRealtime{false};
+
+    // Audio-thread state, swapped under stateLock (held only for pointer moves)
+    mutable juce::SpinLock stateLock;
+    std::unique_ptr<State> active;
+    std::unique_ptr<State> fading;
+    int fadeSamplesRemaining = 0;
+    int fadeLength = 0;
+    juce::AudioBuffer<float> fadeBuffer;
+
+    std::atomic<int> deadlineMisses{0};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PartitionedConvolver)
+};
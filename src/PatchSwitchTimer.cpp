@@ -0,0 +1,353 @@
+/*
+  ==============================================================================
+
+    PatchSwitchTimer.cpp
+    End-to-end patch switch latency, from Program Change to audible output
+
+  ==============================================================================
+*/
+
+#include "PatchSwitchTimer.h"
+
+#include "LogFile.h"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+double ticksToMs(juce::int64 ticks)
+{
+    return juce::Time::highResolutionTicksToSeconds(ticks) * 1000.0;
+}
+
+/// Nearest-rank percentile of sorted values
+double percentile(const std::vector<double>& sorted, double fraction)
+{
+    const auto rank = static_cast<size_t>(std::ceil(fraction * static_cast<double>(sorted.size())));
+    return sorted[juce::jlimit<size_t>(1, sorted.size(), rank) - 1];
+}
+
+constexpr std::array<double, PatchSwitchTimer::numBins - 1> binEdgesMs{1.0,   2.0,   5.0,   10.0,   20.0,  50.0,
+                                                                       100.0, 200.0, 500.0, 1000.0, 2000.0};
+} // namespace
+
+//==============================================================================
+PatchSwitchTimer& PatchSwitchTimer::getInstance()
+{
+    static PatchSwitchTimer instance;
+    return instance;
+}
+
+void PatchSwitchTimer::setEnabled(bool shouldBeEnabled)
+{
+    if (enabled.exchange(shouldBeEnabled) == shouldBeEnabled)
+        return;
+
+    // Whatever was in flight started under the other setting, so drop it
+    armedTicks.store(0, std::memory_order_relaxed);
+    programChangeTicks.store(0, std::memory_order_relaxed);
+    inSwitch = false;
+    awaitingAudio = false;
+
+    spdlog::info("[PatchSwitchTimer] Switch timing {}", shouldBeEnabled ? "on" : "off");
+    sendChangeMessage();
+}
+
+const char* PatchSwitchTimer::getStageName(int stage)
+{
+    switch (stage)
+    {
+    case Queue:
+        return "Queue";
+    case SavePrevious:
+        return "Save previous";
+    case CrossfadeWait:
+        return "Crossfade wait";
+    case RestoreGraph:
+        return "Restore graph";
+    case RebuildComponents:
+        return "Rebuild components";
+    case FirstAudible:
+        return "First audible";
+    default:
+        return "Total";
+    }
+}
+
+//==============================================================================
+void PatchSwitchTimer::programChangeReceived() noexcept
+{
+    if (isEnabled())
+        programChangeTicks.store(juce::Time::getHighResolutionTicks(), std::memory_order_relaxed);
+}
+
+void PatchSwitchTimer::processOutput(const float* const* channels, int numChannels, int numSamples) noexcept
+{
+    auto armed = armedTicks.load(std::memory_order_relaxed);
+    if (armed == 0)
+        return;
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        if (channels[ch] == nullptr)
+            continue;
+
+        const auto range = juce::FloatVectorOperations::findMinAndMax(channels[ch], numSamples);
+        if (juce::jmax(-range.getStart(), range.getEnd()) > audibleThreshold)
+        {
+            // The message thread may have given up on this switch in the meantime
+            const auto now = juce::Time::getHighResolutionTicks();
+            if (armedTicks.compare_exchange_strong(armed, 0, std::memory_order_acq_rel))
+                audibleTicks.store(now, std::memory_order_release);
+            return;
+        }
+    }
+}
+
+//==============================================================================
+void PatchSwitchTimer::beginSwitch(int patch)
+{
+    if (!isEnabled() || inSwitch)
+        return;
+
+    const auto now = juce::Time::getHighResolutionTicks();
+
+    // A switch still listening for audio is cut short by this one
+    if (awaitingAudio)
+    {
+        if (armedTicks.exchange(0, std::memory_order_acq_rel) != 0)
+            completeSwitch(0);
+        else
+        {
+            // The audio thread claimed it and is about to publish the time, which can only be a moment ago
+            const auto heard = audibleTicks.load(std::memory_order_acquire);
+            completeSwitch(heard != 0 ? heard : now);
+        }
+    }
+
+    current = {};
+    current.patch = patch;
+    startTicks = now;
+    lastMarkTicks = now;
+    inSwitch = true;
+
+    const auto programChange = programChangeTicks.exchange(0, std::memory_order_relaxed);
+    const auto sinceProgramChange = juce::Time::highResolutionTicksToSeconds(now - programChange);
+    if (programChange != 0 && sinceProgramChange < programChangeWindowSeconds)
+    {
+        current.fromProgramChange = true;
+        current.stageMs[Queue] = ticksToMs(now - programChange);
+        startTicks = programChange;
+    }
+}
+
+void PatchSwitchTimer::markStage(Stage stage)
+{
+    if (!inSwitch)
+        return;
+
+    const auto now = juce::Time::getHighResolutionTicks();
+    current.stageMs[static_cast<size_t>(stage)] += ticksToMs(now - lastMarkTicks);
+    lastMarkTicks = now;
+}
+
+void PatchSwitchTimer::endSwitch()
+{
+    if (!inSwitch)
+        return;
+
+    inSwitch = false;
+    awaitingAudio = true;
+    lastMarkTicks = juce::Time::getHighResolutionTicks();
+
+    audibleTicks.store(0, std::memory_order_relaxed);
+    armedTicks.store(lastMarkTicks, std::memory_order_release);
+}
+
+void PatchSwitchTimer::update()
+{
+    if (!awaitingAudio)
+        return;
+
+    if (const auto heard = audibleTicks.load(std::memory_order_acquire); heard != 0)
+    {
+        completeSwitch(heard);
+        return;
+    }
+
+    const auto waited = juce::Time::getHighResolutionTicks() - lastMarkTicks;
+    if (juce::Time::highResolutionTicksToSeconds(waited) < audibleTimeoutSeconds)
+        return;
+
+    // If the exchange loses, the audio thread heard it just now and the next update picks that up
+    if (armedTicks.exchange(0, std::memory_order_acq_rel) != 0)
+        completeSwitch(0);
+}
+
+void PatchSwitchTimer::completeSwitch(juce::int64 heardTicks)
+{
+    awaitingAudio = false;
+
+    current.audible = heardTicks != 0;
+    if (current.audible)
+    {
+        current.stageMs[FirstAudible] = ticksToMs(heardTicks - lastMarkTicks);
+        current.totalMs = ticksToMs(heardTicks - startTicks);
+    }
+    else
+        current.totalMs = ticksToMs(lastMarkTicks - startTicks);
+    current.time = juce::Time::getCurrentTime();
+
+    juce::StringArray stages;
+    for (int stage = 0; stage < numStages; ++stage)
+    {
+        if ((stage == Queue && !current.fromProgramChange) || (stage == FirstAudible && !current.audible))
+            continue;
+        stages.add(juce::String(getStageName(stage)) + " " +
+                   juce::String(current.stageMs[static_cast<size_t>(stage)], 1));
+    }
+
+    juce::String message;
+    message << "Patch " << current.patch << (current.fromProgramChange ? " (Program Change)" : "") << ": "
+            << juce::String(current.totalMs, 1) << " ms" << (current.audible ? " to audio" : ", output stayed silent")
+            << " - " << stages.joinIntoString(", ");
+    spdlog::info("[PatchSwitchTimer] {}", message.toStdString());
+    LogFile::getInstance().logEvent("Patch", message);
+
+    history.push_back(current);
+    if (history.size() > static_cast<size_t>(historySize))
+        history.erase(history.begin());
+
+    sendChangeMessage();
+}
+
+void PatchSwitchTimer::clearHistory()
+{
+    history.clear();
+    sendChangeMessage();
+}
+
+//==============================================================================
+std::vector<double> PatchSwitchTimer::getStageTimes(int stage) const
+{
+    std::vector<double> times;
+    times.reserve(history.size());
+    for (const auto& record : history)
+    {
+        // Queue only means something for Program Changes, and silent switches never reached audio
+        if (stage == Queue && !record.fromProgramChange)
+            continue;
+        if ((stage == FirstAudible || stage == numStages) && !record.audible)
+            continue;
+
+        times.push_back(stage == numStages ? record.totalMs : record.stageMs[static_cast<size_t>(stage)]);
+    }
+    return times;
+}
+
+PatchSwitchTimer::Stats PatchSwitchTimer::getStats(int stage) const
+{
+    auto times = getStageTimes(stage);
+    Stats stats;
+    if (times.empty())
+        return stats;
+
+    std::sort(times.begin(), times.end());
+    double sum = 0.0;
+    for (const auto t : times)
+        sum += t;
+
+    stats.count = static_cast<int>(times.size());
+    stats.meanMs = sum / static_cast<double>(times.size());
+    stats.medianMs = percentile(times, 0.5);
+    stats.p95Ms = percentile(times, 0.95);
+    stats.maxMs = times.back();
+    return stats;
+}
+
+std::array<int, PatchSwitchTimer::numBins> PatchSwitchTimer::getHistogram(int stage) const
+{
+    std::array<int, numBins> histogram{};
+    for (const auto t : getStageTimes(stage))
+    {
+        const auto edge = std::lower_bound(binEdgesMs.begin(), binEdgesMs.end(), t);
+        ++histogram[static_cast<size_t>(edge - binEdgesMs.begin())];
+    }
+    return histogram;
+}
+
+double PatchSwitchTimer::getBinUpperMs(int bin)
+{
+    if (bin < 0 || bin >= static_cast<int>(binEdgesMs.size()))
+        return std::numeric_limits<double>::infinity();
+    return binEdgesMs[static_cast<size_t>(bin)];
+}
+
+//==============================================================================
+juce::var PatchSwitchTimer::toJson() const
+{
+    juce::Array<juce::var> switches;
+    for (const auto& record : history)
+    {
+        auto* entry = new juce::DynamicObject();
+        entry->setProperty("time", record.time.toISO8601(true));
+        entry->setProperty("patch", record.patch);
+        entry->setProperty("fromProgramChange", record.fromProgramChange);
+        entry->setProperty("audible", record.audible);
+        entry->setProperty("totalMs", record.totalMs);
+
+        auto* stages = new juce::DynamicObject();
+        for (int stage = 0; stage < numStages; ++stage)
+            stages->setProperty(getStageName(stage), record.stageMs[static_cast<size_t>(stage)]);
+        entry->setProperty("stagesMs", juce::var(stages));
+
+        switches.add(juce::var(entry));
+    }
+
+    // The last bin has no upper edge
+    juce::Array<juce::var> edges;
+    for (const auto edge : binEdgesMs)
+        edges.add(edge);
+
+    juce::Array<juce::var> summaries;
+    for (int stage = 0; stage <= numStages; ++stage)
+    {
+        const auto stats = getStats(stage);
+        auto* summary = new juce::DynamicObject();
+        summary->setProperty("stage", getStageName(stage));
+        summary->setProperty("count", stats.count);
+        summary->setProperty("meanMs", stats.meanMs);
+        summary->setProperty("medianMs", stats.medianMs);
+        summary->setProperty("p95Ms", stats.p95Ms);
+        summary->setProperty("maxMs", stats.maxMs);
+
+        juce::Array<juce::var> counts;
+        for (const auto count : getHistogram(stage))
+            counts.add(count);
+        summary->setProperty("histogram", counts);
+
+        summaries.add(juce::var(summary));
+    }
+
+    auto* root = new juce::DynamicObject();
+    root->setProperty("binUpperMs", edges);
+    root->setProperty("stages", summaries);
+    root->setProperty("switches", switches);
+    return juce::var(root);
+}
+
+bool PatchSwitchTimer::exportJson(const juce::File& file) const
+{
+    if (!file.replaceWithText(juce::JSON::toString(toJson())))
+    {
+        spdlog::error("[PatchSwitchTimer] Could not write {}", file.getFullPathName().toStdString());
+        return false;
+    }
+
+    spdlog::info("[PatchSwitchTimer] Wrote {} switches to {}", history.size(), file.getFullPathName().toStdString());
+    return true;
+}
@@ -0,0 +1,144 @@
+/*
+  ==============================================================================
+
+    PatchSwitchTimer.h
+    End-to-end patch switch latency, from Program Change to audible output
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include <array>
+#include <atomic>
+#include <vector>
+
+//==============================================================================
+/**
+    Times every patch switch stage by stage, while switch timing is on.
+
+    MainPanel::switchPatch opens a switch with beginSwitch() and closes it
+    with endSwitch(); in between, it and PluginField::loadFromXml charge the
+    time since the previous mark to a stage with markStage(). If a MIDI
+    Program Change arrived shortly before, the switch is timed from its
+    arrival, and the wait for the message thread to act on it is the Queue
+    stage.
+
+    endSwitch() arms the audio thread, which checks each output block until
+    one rises above audibleThreshold; the time to that block is the
+    FirstAudible stage. update() (message thread, polled by MainPanel)
+    completes the switch when that block is seen, or after
+    audibleTimeoutSeconds as a silent switch, logs it, adds it to the
+    history and notifies listeners.
+
+    Costs the audio thread one relaxed atomic load per callback unless a
+    switch is waiting for audio.
+*/
+class PatchSwitchTimer : public juce::ChangeBroadcaster
+{
+  public:
+    enum Stage
+    {
+        Queue = 0,         // Program Change arrival to switchPatch
+        SavePrevious,      // Serialising the outgoing patch
+        CrossfadeWait,     // Waiting for the fade out
+        RestoreGraph,      // FilterGraph::restoreFromXml
+        RebuildComponents, // Tearing down and re-adding the patch's components
+        FirstAudible,      // End of switchPatch to the first non-silent output block
+        numStages
+    };
+
+    /// One completed switch. Stage times are in ms; total covers every stage.
+    struct Switch
+    {
+        int patch = -1;
+        bool fromProgramChange = false;
+        bool audible = false; // False if the output stayed silent, so FirstAudible is unknown
+        std::array<double, numStages> stageMs{};
+        double totalMs = 0.0;
+        juce::Time time;
+    };
+
+    /// Summary of one stage (or the total, for numStages) over the history
+    struct Stats
+    {
+        int count = 0;
+        double meanMs = 0.0;
+        double medianMs = 0.0;
+        double p95Ms = 0.0;
+        double maxMs = 0.0;
+    };
+
+    static constexpr int historySize = 500;
+    static constexpr float audibleThreshold = 0.001f; // -60 dBFS
+    static constexpr double audibleTimeoutSeconds = 2.0;
+    static constexpr double programChangeWindowSeconds = 1.0; // Older Program Changes didn't cause this switch
+    static constexpr int numBins = 12;
+
+    static PatchSwitchTimer& getInstance();
+
+    static bool isEnabled() noexcept { return enabled.load(std::memory_order_relaxed); }
+    void setEnabled(bool shouldBeEnabled);
+
+    static const char* getStageName(int stage);
+
+    //==========================================================================
+    // MIDI and audio threads
+
+    /// Stamps the arrival of a Program Change that will switch patch
+    static void programChangeReceived() noexcept;
+
+    /// Looks for the first audible block after a switch. Call with each
+    /// device output block, after every gain stage.
+    void processOutput(const float* const* channels, int numChannels, int numSamples) noexcept;
+
+    //==========================================================================
+    // Message thread
+
+    void beginSwitch(int patch);
+    /// Charges the time since the last mark (or beginSwitch) to stage
+    void markStage(Stage stage);
+    void endSwitch();
+
+    /// Completes a switch once its audio is heard or it times out. Polled by MainPanel.
+    void update();
+
+    const std::vector<Switch>& getHistory() const { return history; }
+    void clearHistory();
+
+    /// stage is a Stage, or numStages for the total. Silent switches count only before FirstAudible.
+    Stats getStats(int stage) const;
+    /// Counts per bin of getBinUpperMs(); the last bin is everything slower
+    std::array<int, numBins> getHistogram(int stage) const;
+    static double getBinUpperMs(int bin);
+
+    /// Every switch in the history, with the stats and histograms, as JSON
+    juce::var toJson() const;
+    bool exportJson(const juce::File& file) const;
+
+  private:
+    PatchSwitchTimer() = default;
+    ~PatchSwitchTimer() override = default;
+
+    void completeSwitch(juce::int64 audibleTicks);
+    std::vector<double> getStageTimes(int stage) const;
+
+    inline static std::atomic<bool> enabled{false};
+    inline static std::atomic<juce::int64> programChangeTicks{0};
+
+    // Nonzero while the audio thread is looking for output: the ticks at endSwitch()
+    std::atomic<juce::int64> armedTicks{0};
+    std::atomic<juce::int64> audibleTicks{0};
+
+    // Message thread only
+    bool inSwitch = false;
+    bool awaitingAudio = false;
+    Switch current;
+    juce::int64 startTicks = 0;
+    juce::int64 lastMarkTicks = 0;
+    std::vector<Switch> history;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PatchSwitchTimer)
+};
@@ -0,0 +1,246 @@
+/*
+  ==============================================================================
+
+    PatchSwitchTimingDisplay.cpp
+    Per-stage patch switch latency, with a histogram of the selected stage
+
+  ==============================================================================
+*/
+
+#include "PatchSwitchTimingDisplay.h"
+#include "ColourScheme.h"
+
+#include <cmath>
+
+namespace
+{
+String getBinLabel(int bin)
+{
+    const double upper = PatchSwitchTimer::getBinUpperMs(bin);
+    if (std::isinf(upper))
+        return ">" + String(PatchSwitchTimer::getBinUpperMs(bin - 1), 0);
+    return "<" + String(upper, 0);
+}
+} // namespace
+
+//==============================================================================
+PatchSwitchTimingDisplay::PatchSwitchTimingDisplay()
+{
+    auto& colours = ColourScheme::getInstance().colours;
+
+    infoLabel.setColour(Label::textColourId, colours["Text Colour"].withAlpha(0.7f));
+    addAndMakeVisible(infoLabel);
+
+    auto& header = table.getHeader();
+    const int flags = TableHeaderComponent::visible;
+    header.addColumn("Stage", StageColumn, 160, 80, -1, flags);
+    header.addColumn("Count", CountColumn, 60, 40, -1, flags);
+    header.addColumn("Mean ms", MeanColumn, 70, 50, -1, flags);
+    header.addColumn("Median ms", MedianColumn, 70, 50, -1, flags);
+    header.addColumn("p95 ms", P95Column, 70, 50, -1, flags);
+    header.addColumn("Max ms", MaxColumn, 70, 50, -1, flags);
+
+    table.setModel(this);
+    table.setColour(ListBox::backgroundColourId, colours["Dialog Inner Background"]);
+    table.setColour(ListBox::outlineColourId, colours["Text Colour"].withAlpha(0.3f));
+    table.setOutlineThickness(1);
+    addAndMakeVisible(table);
+
+    exportButton.onClick = [this]() { exportTimings(); };
+    addAndMakeVisible(exportButton);
+
+    clearButton.onClick = []() { PatchSwitchTimer::getInstance().clearHistory(); };
+    addAndMakeVisible(clearButton);
+
+    PatchSwitchTimer::getInstance().addChangeListener(this);
+    refresh();
+    table.selectRow(PatchSwitchTimer::numStages);
+}
+
+PatchSwitchTimingDisplay::~PatchSwitchTimingDisplay()
+{
+    PatchSwitchTimer::getInstance().removeChangeListener(this);
+}
+
+//==============================================================================
+void PatchSwitchTimingDisplay::paint(Graphics& g)
+{
+    auto& colours = ColourScheme::getInstance().colours;
+    g.fillAll(colours["Window Background"]);
+
+    auto area = histogramArea;
+    g.setColour(colours["Dialog Inner Background"]);
+    g.fillRect(area);
+    g.setColour(colours["Text Colour"].withAlpha(0.3f));
+    g.drawRect(area);
+
+    area = area.reduced(6);
+    auto labels = area.removeFromBottom(16);
+
+    int highest = 0;
+    for (const auto count : histogram)
+        highest = jmax(highest, count);
+
+    const float binWidth = static_cast<float>(area.getWidth()) / static_cast<float>(PatchSwitchTimer::numBins);
+    g.setFont(11.0f);
+    for (int bin = 0; bin < PatchSwitchTimer::numBins; ++bin)
+    {
+        const float x = static_cast<float>(area.getX()) + binWidth * static_cast<float>(bin);
+        const int count = histogram[static_cast<size_t>(bin)];
+
+        if (count > 0)
+        {
+            const float height = static_cast<float>(area.getHeight() - 14) * static_cast<float>(count) /
+                                 static_cast<float>(highest);
+            const Rectangle<float> bar(x + 2.0f, static_cast<float>(area.getBottom()) - height, binWidth - 4.0f,
+                                       height);
+
+            // Past 50ms is a noticeable gap in a live set, past 100ms an obvious one
+            const double upper = PatchSwitchTimer::getBinUpperMs(bin);
+            g.setColour(upper > 100.0 ? colours["Danger Colour"]
+                                      : upper > 50.0 ? colours["Warning Colour"] : colours["Accent Colour"]);
+            g.fillRect(bar);
+
+            g.setColour(colours["Text Colour"]);
+            g.drawText(String(count), bar.withY(bar.getY() - 14.0f).withHeight(14.0f), Justification::centred, false);
+        }
+
+        g.setColour(colours["Text Colour"].withAlpha(0.7f));
+        g.drawText(getBinLabel(bin), Rectangle<float>(x, static_cast<float>(labels.getY()), binWidth, 16.0f),
+                   Justification::centred, false);
+    }
+
+    if (highest == 0)
+    {
+        g.setColour(colours["Text Colour"].withAlpha(0.4f));
+        g.setFont(13.0f);
+        g.drawText("No switches timed yet", area, Justification::centred, false);
+    }
+}
+
+void PatchSwitchTimingDisplay::resized()
+{
+    auto bounds = getLocalBounds().reduced(8);
+    infoLabel.setBounds(bounds.removeFromTop(36));
+    bounds.removeFromTop(4);
+
+    auto buttons = bounds.removeFromBottom(24);
+    clearButton.setBounds(buttons.removeFromRight(80));
+    buttons.removeFromRight(8);
+    exportButton.setBounds(buttons.removeFromRight(80));
+    bounds.removeFromBottom(8);
+
+    table.setBounds(bounds.removeFromTop(table.getRowHeight() * (getNumRows() + 1) + 4));
+    bounds.removeFromTop(8);
+    histogramArea = bounds;
+}
+
+//==============================================================================
+void PatchSwitchTimingDisplay::paintRowBackground(Graphics& g, int rowNumber, int, int, bool rowIsSelected)
+{
+    auto& colours = ColourScheme::getInstance().colours;
+
+    if (rowIsSelected)
+        g.fillAll(colours["List Selection"]);
+    else if (rowNumber % 2)
+        g.fillAll(colours["Dialog Inner Background"].darker(0.05f));
+}
+
+void PatchSwitchTimingDisplay::paintCell(Graphics& g, int rowNumber, int columnId, int width, int height, bool)
+{
+    if (rowNumber < 0 || rowNumber >= getNumRows())
+        return;
+
+    auto& colours = ColourScheme::getInstance().colours;
+    const auto& stage = stats[static_cast<size_t>(rowNumber)];
+
+    String text;
+    Colour colour = colours["Text Colour"];
+    Justification justification = Justification::centredRight;
+
+    switch (columnId)
+    {
+    case StageColumn:
+        text = PatchSwitchTimer::getStageName(rowNumber);
+        justification = Justification::centredLeft;
+        break;
+    case CountColumn:
+        text = String(stage.count);
+        break;
+    case MeanColumn:
+        text = String(stage.meanMs, 1);
+        break;
+    case MedianColumn:
+        text = String(stage.medianMs, 1);
+        break;
+    case P95Column:
+        text = String(stage.p95Ms, 1);
+        break;
+    case MaxColumn:
+        text = String(stage.maxMs, 1);
+        break;
+    default:
+        break;
+    }
+
+    if (columnId != StageColumn && stage.count == 0)
+    {
+        text = "-";
+        colour = colour.withAlpha(0.4f);
+    }
+
+    g.setColour(colour);
+    g.setFont(rowNumber == PatchSwitchTimer::numStages ? Font(13.0f, Font::bold) : Font(13.0f));
+    g.drawText(text, 4, 0, width - 8, height, justification, true);
+}
+
+void PatchSwitchTimingDisplay::selectedRowsChanged(int)
+{
+    refresh();
+}
+
+//==============================================================================
+void PatchSwitchTimingDisplay::changeListenerCallback(ChangeBroadcaster*)
+{
+    refresh();
+}
+
+void PatchSwitchTimingDisplay::refresh()
+{
+    auto& timer = PatchSwitchTimer::getInstance();
+
+    for (int stage = 0; stage <= PatchSwitchTimer::numStages; ++stage)
+        stats[static_cast<size_t>(stage)] = timer.getStats(stage);
+
+    const int selected = table.getSelectedRow();
+    histogram = timer.getHistogram(selected >= 0 ? selected : PatchSwitchTimer::numStages);
+
+    String info;
+    if (PatchSwitchTimer::isEnabled())
+        info << "The last " << static_cast<int>(timer.getHistory().size())
+             << " switches, from Program Change (or the patch selection) to the first audible output block.";
+    else
+        info << "Switch timing is off. Turn on Options > Time Patch Switches to measure switches.";
+    infoLabel.setText(info, dontSendNotification);
+
+    table.updateContent();
+    table.repaint();
+    repaint(histogramArea);
+}
+
+void PatchSwitchTimingDisplay::exportTimings()
+{
+    chooser = std::make_unique<FileChooser>(
+        "Export Patch Switch Timings",
+        File::getSpecialLocation(File::userDocumentsDirectory).getChildFile("Pedalboard3 Patch Switches.json"),
+        "*.json");
+
+    chooser->launchAsync(FileBrowserComponent::saveMode | FileBrowserComponent::canSelectFiles |
+                             FileBrowserComponent::warnAboutOverwriting,
+                         [](const FileChooser& fc)
+                         {
+                             const File file = fc.getResult();
+                             if (file != File())
+                                 PatchSwitchTimer::getInstance().exportJson(file);
+                         });
+}
@@ -0,0 +1,66 @@
+/*
+  ==============================================================================
+
+    PatchSwitchTimingDisplay.h
+    Per-stage patch switch latency, with a histogram of the selected stage
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "PatchSwitchTimer.h"
+
+#include <JuceHeader.h>
+
+#include <array>
+#include <memory>
+
+//==============================================================================
+/**
+    Shows PatchSwitchTimer's stats for each stage of a patch switch, plus the
+    total, over the switches it has kept. Select a row to see its histogram.
+    Updates as each switch completes, and can export everything as JSON.
+*/
+class PatchSwitchTimingDisplay : public Component, public TableListBoxModel, private ChangeListener
+{
+  public:
+    enum ColumnIds
+    {
+        StageColumn = 1,
+        CountColumn,
+        MeanColumn,
+        MedianColumn,
+        P95Column,
+        MaxColumn
+    };
+
+    PatchSwitchTimingDisplay();
+    ~PatchSwitchTimingDisplay() override;
+
+    void paint(Graphics& g) override;
+    void resized() override;
+
+    /// A row per stage, then the total
+    int getNumRows() override { return PatchSwitchTimer::numStages + 1; }
+    void paintRowBackground(Graphics& g, int rowNumber, int width, int height, bool rowIsSelected) override;
+    void paintCell(Graphics& g, int rowNumber, int columnId, int width, int height, bool rowIsSelected) override;
+    void selectedRowsChanged(int lastRowSelected) override;
+
+  private:
+    void changeListenerCallback(ChangeBroadcaster* source) override;
+    void refresh();
+    void exportTimings();
+
+    std::array<PatchSwitchTimer::Stats, PatchSwitchTimer::numStages + 1> stats;
+    std::array<int, PatchSwitchTimer::numBins> histogram{};
+
+    Label infoLabel;
+    TableListBox table;
+    TextButton exportButton{"Export..."};
+    TextButton clearButton{"Clear"};
+    Rectangle<int> histogramArea;
+    std::unique_ptr<FileChooser> chooser;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PatchSwitchTimingDisplay)
+};
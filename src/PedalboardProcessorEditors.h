@@ -21,6 +21,8 @@
 #ifndef PEDALBOARDPROCESSOREDITORS_H_
 #define PEDALBOARDPROCESSOREDITORS_H_
 
+#include "UiFrameScheduler.h"
+
 #include <JuceHeader.h>
 
 class LevelProcessor;
@@ -194,8 +196,7 @@ class OutputToggleEditor : public AudioProcessorEditor,
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
 ///	The PluginComponent control for the VuMeter processor.
-class VuMeterControl : public Component,
-					   public Timer
+class VuMeterControl : public Component
 {
   public:
 	///	Constructor.
@@ -208,8 +209,8 @@ class VuMeterControl : public Component,
 	///	Resizes the meter.
 	void resized();
 
-	///	Updates the meter.
-	void timerCallback();
+	///	Updates the meter, if the processor has new levels.
+	void updateLevels();
 
 
   private:
@@ -220,6 +221,11 @@ class VuMeterControl : public Component,
 	float levelLeft;
 	///	The current right level.
 	float levelRight;
+
+	///	The processor's display version when we last read its levels.
+	juce::uint32 lastVersion = 0;
+	///	Calls updateLevels() every 60ms, off the display refresh.
+	UiFrameScheduler::Client frameClient{this, 1000.0 / 60.0, [this]() { updateLevels(); }};
 };
 
 //------------------------------------------------------------------------------
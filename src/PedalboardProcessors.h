@@ -20,12 +20,18 @@
 #ifndef PEDALBOARDPROCESSORS_H_
 #define PEDALBOARDPROCESSORS_H_
 
+#include "DiskWriter.h"
+#include "LoopStorage.h"
+#include "PreloadedAudio.h"
+#include "UiFrameScheduler.h"
+
 #include <JuceHeader.h>
 #include <atomic>
 #include <stdint.h>
 #include <vector>
 
 class LooperControl;
+class ReadAheadSource;
 
 //------------------------------------------------------------------------------
 ///	Abstract base of all the internal processors.
@@ -164,6 +170,8 @@ class FilePlayerProcessor : public PedalboardProcessor, public ChangeListener, p
     };
     ///	Returns whether the file is currently playing.
     bool isPlaying() const { return transportSource.isPlaying(); };
+    ///	Returns whether playback comes from the preloaded copy of the file.
+    bool isPlayingFromMemory() const { return preloadedSource != nullptr; };
 
     ///	Returns the component which is added to the instance's PluginComponent.
     Component* getControls();
@@ -191,6 +199,7 @@ class FilePlayerProcessor : public PedalboardProcessor, public ChangeListener, p
         ReadPosition,
         SyncToMainTransport,
         Trigger,
+        Preload,
 
         NumParameters
     };
@@ -247,10 +256,27 @@ class FilePlayerProcessor : public PedalboardProcessor, public ChangeListener, p
     void setStateInformation(const void* data, int sizeInBytes);
 
   private:
+    ///	Starts decoding the file into memory, if we're preloading.
+    void startPreload();
+    ///	Switches between the preloaded audio and streaming from disk.
+    /*!
+        Only done while stopped, since AudioTransportSource::setSource()
+        stops playback.
+     */
+    void updatePlaybackSource();
+    ///	Plays soundFileSource through a read-ahead buffer.
+    void streamFromDisk();
+
     ///	The transport source which plays the file.
     AudioTransportSource transportSource;
     ///	The actual sound file source.
     std::unique_ptr<AudioFormatReaderSource> soundFileSource;
+    ///	Reads soundFileSource ahead on the disk read queue, while streaming.
+    std::unique_ptr<ReadAheadSource> readAheadSource;
+    ///	Decodes and resamples the whole file ahead of time.
+    AudioPreloader preloader;
+    ///	Plays the preloaded audio, once it's in use.
+    std::unique_ptr<PreloadedAudioSource> preloadedSource;
 
     ///	The file we're playing.
     File soundFile;
@@ -258,6 +284,8 @@ class FilePlayerProcessor : public PedalboardProcessor, public ChangeListener, p
     bool looping;
     ///	Whether or not we're syncing to the main transport.
     bool syncToMainTransport;
+    ///	Whether the whole file is decoded into memory ahead of playback.
+    bool preload;
 
     ///	The editor's bounds.
     Rectangle<int> editorBounds;
@@ -370,6 +398,8 @@ class VuMeterProcessor : public PedalboardProcessor
     float getLeftLevel() const { return levelLeft.load(); };
     ///	Returns the current right level.
     float getRightLevel() const { return levelRight.load(); };
+    ///	Bumped after every block's levels are stored.
+    const DisplayVersion& getDisplayVersion() const { return displayVersion; };
 
     ///	Updates the bounds of our editor window.
     void updateEditorBounds(const Rectangle<int>& bounds);
@@ -436,6 +466,8 @@ class VuMeterProcessor : public PedalboardProcessor
     std::atomic<float> levelLeft{0.0f};
     ///	The current level (audio thread writes, UI thread reads).
     std::atomic<float> levelRight{0.0f};
+    ///	Lets the meter skip frames with no new levels.
+    DisplayVersion displayVersion;
 
     ///	The editor's bounds.
     Rectangle<int> editorBounds;
@@ -545,7 +577,7 @@ class RecorderProcessor : public PedalboardProcessor, public ChangeListener, pub
     ///	The file being recorded to.
     File soundFile;
     ///	Used to record the audio input.
-    AudioFormatWriter::ThreadedWriter* threadWriter;
+    DiskWriter* threadWriter;
 
     ///	The thumbnail image which gets passed to the Controls and Editor.
     AudioThumbnail thumbnail;
@@ -768,6 +800,12 @@ class LooperProcessor : public PedalboardProcessor,
     {
         return (recording.load(std::memory_order_relaxed) && !stopRecording.load(std::memory_order_relaxed));
     };
+    ///	Returns whether or not we're currently overdubbing a layer.
+    bool isOverdubbing() const { return overdubbing.load(std::memory_order_relaxed); };
+    ///	Returns whether there's an overdub layer to undo.
+    bool canUndoLayer() const { return loopStorage.canUndoLayer(); };
+    ///	Returns whether there's an undone overdub layer to redo.
+    bool canRedoLayer() const { return loopStorage.canRedoLayer(); };
 
     /// Returns true and clears the flag if an out-of-memory error occurred during recording.
     bool getAndClearMemoryError() { return memoryError.exchange(false, std::memory_order_relaxed); }
@@ -786,7 +824,7 @@ class LooperProcessor : public PedalboardProcessor,
      */
     bool getNewFileLoaded() const { return newFileLoaded; };
 
-    ///	Used to start recording.
+    ///	Used to start recording or overdubbing.
     /*!
         This is necessary because recording may be started via a MidiMessage,
         which will happen in the audio thread. If we do our setup in the audio
@@ -795,13 +833,13 @@ class LooperProcessor : public PedalboardProcessor,
         from the main thread. Hence the use of an AsyncUpdater.
      */
     void handleAsyncUpdate();
-    ///	Used to allocate new loop buffers if necessary.
+    ///	Services the loop storage and reads any file being loaded.
     int useTimeSlice();
 
     ///	Returns the component which is added to the instance's PluginComponent.
     Component* getControls();
     ///	Returns the size of the controls component.
-    Point<int> getSize() { return Point<int>(300, 100); };
+    Point<int> getSize() { return Point<int>(360, 100); };
 
     ///	Updates the bounds of our editor window.
     void updateEditorBounds(const Rectangle<int>& bounds);
@@ -832,6 +870,9 @@ class LooperProcessor : public PedalboardProcessor,
         BarDenominator,
         InputLevel,
         LoopLevel,
+        Overdub,
+        UndoLayer,
+        RedoLayer,
 
         NumParameters
     };
@@ -886,15 +927,20 @@ class LooperProcessor : public PedalboardProcessor,
     void setStateInformation(const void* data, int sizeInBytes);
 
   private:
+    ///	Helper method. Sets up the loop file and starts recording.
+    void startRecording();
+    ///	Helper method. Opens a new overdub layer over the playing loop.
+    void startOverdub();
+    ///	Helper method. Closes any open overdub layer.
+    void endOverdub();
     ///	Helper method. Copies the contents of tempBuffer into fadeInBuffer.
     void fillFadeInBuffer();
     ///	Helper method. Copies the contents of tempBuffer into fadeOutBuffer.
     void fillFadeOutBuffer();
 
-    ///	The size of each memory buffer we use.
+    ///	The size of the fade buffers.
     enum
     {
-        LoopBufferSize = (44100 * 8),
         FadeBufferSize = 128
     };
 
@@ -908,13 +954,19 @@ class LooperProcessor : public PedalboardProcessor,
     std::atomic<bool> recording{false};
     ///	Safeguard in case the user tries to change the file while we're recording.
     std::atomic<bool> stopRecording{false};
+    ///	If we're currently overdubbing a layer or not.
+    std::atomic<bool> overdubbing{false};
+    ///	Set when a recording is waiting on handleAsyncUpdate().
+    std::atomic<bool> recordRequested{false};
+    ///	Set when an overdub is waiting on handleAsyncUpdate().
+    std::atomic<bool> overdubRequested{false};
     ///	Whether or not we're syncing to the main transport.
     std::atomic<bool> syncToMainTransport{false};
     ///	Whether or not recording should stop after a bar.
     std::atomic<bool> stopAfterBar{false};
     ///	True if playback should start immediately after recording has stopped.
     std::atomic<bool> autoPlay{false};
-    ///	Set from audio thread when out-of-memory during recording.
+    ///	Set from audio thread when the loop storage can't keep up with recording.
     std::atomic<bool> memoryError{false};
     ///	Set from audio thread when state changes (recording stopped, etc.). Polled by UI timer.
     std::atomic<bool> stateChanged{false};
@@ -924,7 +976,7 @@ class LooperProcessor : public PedalboardProcessor,
     std::atomic<float> loopLevel{1.0f};
 
     ///	Used to record the audio input.
-    AudioFormatWriter::ThreadedWriter* threadWriter;
+    DiskWriter* threadWriter;
 
     ///	The thumbnail image which gets passed to the Controls and Editor.
     AudioThumbnail thumbnail;
@@ -951,19 +1003,13 @@ class LooperProcessor : public PedalboardProcessor,
     bool justPaused;
 
     ///	The length of the loop in samples.
-    uint64_t loopLength;
-    ///	The loop buffer in memory.
-    OwnedArray<AudioSampleBuffer> loopBuffer;
-    ///	Our playback position in the loop buffer.
-    int loopPos;
-    ///	Which loop buffer we're currently playing back.
-    int loopIndex;
-    ///	Used to ensure the last loop buffer is deleted.
-    /*!
-        This is necessary for when we stop recording after a new loop buffer
-        has been created, but before we've actually started writing into it.
-     */
-    bool deleteLastBuffer;
+    std::atomic<uint64_t> loopLength;
+    ///	The loop audio: a RAM window around the playhead over a scratch file.
+    LoopStorage loopStorage;
+    ///	Storage underruns already passed on to the DiskIOScheduler.
+    int64 reportedUnderruns = 0;
+    ///	Our playback/record position in the loop, in samples.
+    std::atomic<int64_t> loopPos;
 
     ///	The temporary buffer which is copied into the two fade buffers.
     float tempBuffer[2][FadeBufferSize];
@@ -980,12 +1026,10 @@ class LooperProcessor : public PedalboardProcessor,
     ///	Used to fade in the loop buffer after recording stops (& autoPlay is on).
     float autoPlayFade;
 
-    ///	Used to read a file into the loopBuffers.
+    ///	Used to read a file into the loop storage.
     AudioFormatReader* fileReader;
-    ///	Used to read a file into the loopBuffers.
+    ///	Used to read a file into the loop storage.
     int64 fileReaderPos;
-    ///	Which loopBuffer we are writing to next.
-    int fileReaderBufIndex;
     ///	The ratio of file sample rate to device sample rate (for resampling).
     double fileReaderRatio;
 
@@ -0,0 +1,233 @@
+/*
+  ==============================================================================
+
+    PerfTrace.cpp
+    Scoped timeline zones for the engine, loader and UI, exported for
+    chrome://tracing and Perfetto
+
+  ==============================================================================
+*/
+
+#include "PerfTrace.h"
+
+#include <spdlog/spdlog.h>
+
+#include <map>
+
+namespace
+{
+juce::int64 ticksToNanos(juce::int64 ticks)
+{
+    return static_cast<juce::int64>(juce::Time::highResolutionTicksToSeconds(ticks) * 1.0e9);
+}
+
+/// Microseconds with nanosecond precision, as the trace format wants
+juce::String toMicros(juce::int64 nanos)
+{
+    return juce::String(static_cast<double>(nanos) / 1000.0, 3);
+}
+} // namespace
+
+//==============================================================================
+PerfTrace::Zone::Zone(const char* zoneName, const char* zoneCategory) noexcept
+    : name(zoneName), category(zoneCategory)
+{
+    if (PerfTrace::isEnabled())
+        startTicks = juce::Time::getHighResolutionTicks();
+}
+
+PerfTrace::Zone::~Zone() noexcept
+{
+    if (startTicks != 0)
+        PerfTrace::getInstance().addEvent(name, category, startTicks, juce::Time::getHighResolutionTicks());
+}
+
+//==============================================================================
+PerfTrace& PerfTrace::getInstance()
+{
+    static PerfTrace instance;
+    return instance;
+}
+
+void PerfTrace::nameThread(const char* name) noexcept
+{
+    if (!isEnabled())
+        return;
+
+    if (auto* buffer = getInstance().getBufferForThisThread())
+        buffer->label.store(name, std::memory_order_relaxed);
+}
+
+//==============================================================================
+void PerfTrace::start()
+{
+    stop();
+
+    // Allocated on first use and never resized, so a zone that raced stop() can't write into freed memory
+    for (auto& buffer : buffers)
+    {
+        if (buffer.events.empty())
+            buffer.events.resize(eventsPerThread);
+        buffer.owner.store(nullptr, std::memory_order_relaxed);
+        buffer.label.store(nullptr, std::memory_order_relaxed);
+        buffer.threadName = {};
+        buffer.count.store(0, std::memory_order_relaxed);
+    }
+    dropped.store(0, std::memory_order_relaxed);
+    startTicks.store(juce::Time::getHighResolutionTicks(), std::memory_order_relaxed);
+
+    // Threads re-claim a buffer when they see the new generation
+    generation.fetch_add(1, std::memory_order_release);
+    enabled.store(true, std::memory_order_release);
+
+    spdlog::info("[PerfTrace] Tracing started");
+}
+
+void PerfTrace::stop()
+{
+    if (!enabled.exchange(false))
+        return;
+
+    spdlog::info("[PerfTrace] Tracing stopped: {} events, {} dropped", getNumEvents(), getNumDropped());
+}
+
+int PerfTrace::getNumEvents() const
+{
+    juce::uint64 total = 0;
+    for (const auto& buffer : buffers)
+    {
+        const auto size = static_cast<juce::uint64>(buffer.events.size());
+        total += juce::jmin(buffer.count.load(std::memory_order_acquire), size);
+    }
+    return static_cast<int>(total);
+}
+
+//==============================================================================
+PerfTrace::ThreadBuffer* PerfTrace::getBufferForThisThread() noexcept
+{
+    thread_local ThreadBuffer* claimed = nullptr;
+    thread_local juce::uint32 claimedGeneration = 0;
+
+    const auto currentGeneration = generation.load(std::memory_order_acquire);
+    if (claimedGeneration == currentGeneration)
+        return claimed;
+
+    claimed = nullptr;
+    claimedGeneration = currentGeneration;
+
+    const auto self = juce::Thread::getCurrentThreadId();
+    for (auto& buffer : buffers)
+    {
+        juce::Thread::ThreadID expected = nullptr;
+        if (!buffer.owner.compare_exchange_strong(expected, self, std::memory_order_acq_rel))
+            continue;
+
+        // A String copy only bumps a reference count, so this is fine on the audio thread too
+        if (auto* thread = juce::Thread::getCurrentThread())
+            buffer.threadName = thread->getThreadName();
+        else if (juce::MessageManager::existsAndIsCurrentThread())
+            buffer.label.store("Message thread", std::memory_order_relaxed);
+
+        claimed = &buffer;
+        break;
+    }
+    return claimed;
+}
+
+void PerfTrace::addEvent(const char* name, const char* category, juce::int64 zoneStartTicks,
+                         juce::int64 zoneEndTicks) noexcept
+{
+    auto* buffer = getBufferForThisThread();
+    if (buffer == nullptr || buffer->events.empty())
+    {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    Event event;
+    event.name = name;
+    event.category = category;
+    event.startNanos = ticksToNanos(zoneStartTicks - startTicks.load(std::memory_order_relaxed));
+    event.durationNanos = ticksToNanos(zoneEndTicks - zoneStartTicks);
+
+    // Single writer: the event first, then the count that publishes it
+    const auto count = buffer->count.load(std::memory_order_relaxed);
+    buffer->events[static_cast<size_t>(count % buffer->events.size())] = event;
+    buffer->count.store(count + 1, std::memory_order_release);
+}
+
+//==============================================================================
+bool PerfTrace::exportChromeTrace(const juce::File& file)
+{
+    stop();
+
+    file.deleteFile();
+    juce::FileOutputStream out(file);
+    if (!out.openedOk())
+    {
+        spdlog::error("[PerfTrace] Could not write {}", file.getFullPathName().toStdString());
+        return false;
+    }
+
+    writeChromeTrace(out);
+    out.flush();
+
+    spdlog::info("[PerfTrace] Wrote {} events to {}", getNumEvents(), file.getFullPathName().toStdString());
+    return out.getStatus().wasOk();
+}
+
+void PerfTrace::writeChromeTrace(juce::OutputStream& out)
+{
+    // Names are a handful of literals, so escape each once
+    std::map<const char*, juce::String> quoted;
+    const auto quote = [&quoted](const char* text) -> const juce::String&
+    {
+        auto it = quoted.find(text);
+        if (it == quoted.end())
+            it = quoted.emplace(text, juce::JSON::toString(juce::String(text != nullptr ? text : ""))).first;
+        return it->second;
+    };
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    const auto beginEvent = [&out, &first]()
+    {
+        out << (first ? "\n" : ",\n");
+        first = false;
+    };
+
+    int tid = 0;
+    for (const auto& buffer : buffers)
+    {
+        ++tid;
+        const auto count = buffer.count.load(std::memory_order_acquire);
+        if (count == 0 || buffer.events.empty())
+            continue;
+
+        juce::String threadName;
+        if (const auto* label = buffer.label.load(std::memory_order_relaxed))
+            threadName = label;
+        else if (buffer.threadName.isNotEmpty())
+            threadName = buffer.threadName;
+        else
+            threadName = "Thread " + juce::String(tid);
+
+        beginEvent();
+        out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << tid
+            << ",\"args\":{\"name\":" << juce::JSON::toString(threadName) << "}}";
+
+        // Oldest first. If the ring wrapped, skip the oldest slot: a zone that raced stop() may be overwriting it.
+        const auto size = static_cast<juce::uint64>(buffer.events.size());
+        const auto firstEvent = count > size ? count - size + 1 : 0;
+        for (auto i = firstEvent; i < count; ++i)
+        {
+            const auto& event = buffer.events[static_cast<size_t>(i % size)];
+            beginEvent();
+            out << "{\"name\":" << quote(event.name) << ",\"cat\":" << quote(event.category)
+                << ",\"ph\":\"X\",\"ts\":" << toMicros(event.startNanos) << ",\"dur\":" << toMicros(event.durationNanos)
+                << ",\"pid\":1,\"tid\":" << tid << "}";
+        }
+    }
+
+    out << "\n]}\n";
+}
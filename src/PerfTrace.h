@@ -0,0 +1,117 @@
+/*
+  ==============================================================================
+
+    PerfTrace.h
+    Scoped timeline zones for the engine, loader and UI, exported for
+    chrome://tracing and Perfetto
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include <array>
+#include <atomic>
+#include <vector>
+
+//==============================================================================
+/**
+    A low-overhead timeline of what each thread was doing.
+
+    Code marks a region with a Zone; while tracing is on, each zone's start
+    and duration go into its thread's own buffer. A thread claims one of
+    maxThreads preallocated buffers with a compare-and-swap the first time
+    it records, and after that writes to it with plain stores, so zones are
+    safe on the audio thread. Each buffer is a ring that keeps the newest
+    eventsPerThread zones.
+
+    exportChromeTrace() writes the Chrome trace-event JSON that both
+    chrome://tracing and ui.perfetto.dev open: one track per thread, with
+    nested zones stacked.
+
+    Zone names and categories must be string literals (or otherwise live
+    for the session), since only the pointers are stored. Costs one relaxed
+    atomic load per zone while tracing is off.
+*/
+class PerfTrace
+{
+  public:
+    static constexpr int maxThreads = 16;
+    static constexpr int eventsPerThread = 32768;
+
+    struct Event
+    {
+        const char* name = nullptr;
+        const char* category = nullptr;
+        juce::int64 startNanos = 0; // Since start()
+        juce::int64 durationNanos = 0;
+    };
+
+    /// Times the enclosing scope, if tracing is on
+    class Zone
+    {
+      public:
+        Zone(const char* name, const char* category) noexcept;
+        ~Zone() noexcept;
+
+      private:
+        const char* const name;
+        const char* const category;
+        juce::int64 startTicks = 0;
+
+        JUCE_DECLARE_NON_COPYABLE(Zone)
+    };
+
+    static PerfTrace& getInstance();
+
+    static bool isEnabled() noexcept { return enabled.load(std::memory_order_relaxed); }
+
+    /// Labels the calling thread's track in the export; name must be a literal.
+    /// Only takes effect while tracing, so call it where the thread records.
+    static void nameThread(const char* name) noexcept;
+
+    //==========================================================================
+    // Control (message thread)
+
+    /// Clears every buffer and starts recording
+    void start();
+    void stop();
+
+    /// Stops tracing and writes everything recorded as Chrome trace JSON
+    bool exportChromeTrace(const juce::File& file);
+    void writeChromeTrace(juce::OutputStream& out);
+
+    /// Events held across every thread's buffer
+    int getNumEvents() const;
+    /// Zones that found no free thread buffer
+    int getNumDropped() const { return dropped.load(std::memory_order_relaxed); }
+
+    /// Audio thread or any other: adds one finished zone
+    void addEvent(const char* name, const char* category, juce::int64 startTicks, juce::int64 endTicks) noexcept;
+
+  private:
+    PerfTrace() = default;
+    ~PerfTrace() = default;
+
+    struct ThreadBuffer
+    {
+        std::atomic<juce::Thread::ThreadID> owner{nullptr};
+        std::atomic<const char*> label{nullptr};
+        juce::String threadName; // Written once by the owner when it claims the buffer
+        std::vector<Event> events;
+        std::atomic<juce::uint64> count{0};
+    };
+
+    ThreadBuffer* getBufferForThisThread() noexcept;
+
+    inline static std::atomic<bool> enabled{false};
+
+    std::array<ThreadBuffer, maxThreads> buffers;
+    std::atomic<juce::uint32> generation{0};
+    std::atomic<int> dropped{0};
+    std::atomic<juce::int64> startTicks{0};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PerfTrace)
+};
@@ -0,0 +1,130 @@
+/*
+  ==============================================================================
+
+    PitchDetector.cpp
+    FFT-based YIN pitch detector
+
+  ==============================================================================
+*/
+
+#include "PitchDetector.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+constexpr int minWindowSize = 64;
+constexpr float lagHeadroom = 1.25f; // Search past the lowest period so its dip is complete
+} // namespace
+
+//==============================================================================
+void PitchDetector::setWindowSize(int newWindowSize)
+{
+    const int size = juce::nextPowerOfTwo(juce::jmax(minWindowSize, newWindowSize));
+    if (size == windowSize)
+        return;
+
+    windowSize = size;
+
+    // Linear cross-correlation of W/2 against W samples needs 2W points
+    int order = 0;
+    while ((1 << order) < 2 * windowSize)
+        ++order;
+    fft = std::make_unique<juce::dsp::FFT>(order);
+
+    spectrumA.assign(static_cast<size_t>(4 * windowSize), 0.0f);
+    spectrumB.assign(static_cast<size_t>(4 * windowSize), 0.0f);
+    yin.assign(static_cast<size_t>(windowSize / 2), 1.0f);
+}
+
+int PitchDetector::getWindowSizeFor(double sampleRate, float lowestFrequency)
+{
+    const double longestPeriod = sampleRate / juce::jmax(1.0f, lowestFrequency);
+    return juce::nextPowerOfTwo(
+        juce::jmax(minWindowSize, static_cast<int>(std::ceil(2.0 * lagHeadroom * longestPeriod))));
+}
+
+//==============================================================================
+float PitchDetector::detect(const float* samples, double sampleRate)
+{
+    jassert(windowSize > 0);
+
+    const int halfSize = windowSize / 2;
+    const int fftSize = 2 * windowSize;
+
+    // r(tau) = sum_{j < W/2} x[j] * x[j + tau], via conj(A) * B
+    std::fill(spectrumA.begin(), spectrumA.end(), 0.0f);
+    std::fill(spectrumB.begin(), spectrumB.end(), 0.0f);
+    std::copy(samples, samples + halfSize, spectrumA.begin());
+    std::copy(samples, samples + windowSize, spectrumB.begin());
+
+    fft->performRealOnlyForwardTransform(spectrumA.data(), true);
+    fft->performRealOnlyForwardTransform(spectrumB.data(), true);
+
+    for (int bin = 0; bin <= fftSize / 2; ++bin)
+    {
+        const float ar = spectrumA[2 * bin], ai = spectrumA[2 * bin + 1];
+        const float br = spectrumB[2 * bin], bi = spectrumB[2 * bin + 1];
+        spectrumB[2 * bin] = ar * br + ai * bi;
+        spectrumB[2 * bin + 1] = ar * bi - ai * br;
+    }
+    fft->performRealOnlyInverseTransform(spectrumB.data());
+    const float* correlation = spectrumB.data();
+
+    // d(tau) = E(0) + E(tau) - 2 r(tau), with E(tau) the energy of
+    // x[tau, tau + W/2) kept as a running sum
+    double energyZero = 0.0;
+    for (int j = 0; j < halfSize; ++j)
+        energyZero += static_cast<double>(samples[j]) * samples[j];
+
+    double energyTau = energyZero;
+    double runningSum = 0.0;
+    yin[0] = 1.0f;
+
+    for (int tau = 1; tau < halfSize; ++tau)
+    {
+        energyTau += static_cast<double>(samples[tau + halfSize - 1]) * samples[tau + halfSize - 1] -
+                     static_cast<double>(samples[tau - 1]) * samples[tau - 1];
+
+        const double difference = juce::jmax(0.0, energyZero + energyTau - 2.0 * correlation[tau]);
+        runningSum += difference;
+        yin[static_cast<size_t>(tau)] =
+            runningSum > 0.0 ? static_cast<float>(difference * tau / runningSum) : 1.0f;
+    }
+
+    // Absolute threshold, then walk down to the local minimum
+    int tauEstimate = -1;
+    for (int tau = 2; tau < halfSize; ++tau)
+    {
+        if (yin[static_cast<size_t>(tau)] < threshold)
+        {
+            while (tau + 1 < halfSize && yin[static_cast<size_t>(tau + 1)] < yin[static_cast<size_t>(tau)])
+                ++tau;
+            tauEstimate = tau;
+            break;
+        }
+    }
+
+    if (tauEstimate == -1)
+    {
+        lastAperiodicity = 1.0f;
+        return 0.0f;
+    }
+
+    lastAperiodicity = yin[static_cast<size_t>(tauEstimate)];
+
+    // Parabolic interpolation for sub-sample accuracy
+    float betterTau = static_cast<float>(tauEstimate);
+    if (tauEstimate < halfSize - 1)
+    {
+        const float s0 = yin[static_cast<size_t>(tauEstimate - 1)];
+        const float s1 = yin[static_cast<size_t>(tauEstimate)];
+        const float s2 = yin[static_cast<size_t>(tauEstimate + 1)];
+        const float denominator = 2.0f * (2.0f * s1 - s2 - s0);
+        if (std::abs(denominator) > 1.0e-9f)
+            betterTau += (s2 - s0) / denominator;
+    }
+
+    return static_cast<float>(sampleRate) / betterTau;
+}
@@ -0,0 +1,59 @@
+/*
+  ==============================================================================
+
+    PitchDetector.h
+    FFT-based YIN pitch detector
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+
+#include <memory>
+#include <vector>
+
+//==============================================================================
+/**
+    YIN fundamental-frequency estimator with the difference function computed
+    through an FFT cross-correlation, O(N log N) per analysis instead of the
+    O(N^2) direct sum.
+
+    For a window of W samples the integration length is W/2 and lags up to
+    W/2 are searched, so the lowest detectable frequency is roughly
+    2 * sampleRate / W (see getWindowSizeFor).
+
+    Not thread-safe; allocate with setWindowSize() off the audio thread.
+*/
+class PitchDetector
+{
+  public:
+    PitchDetector() = default;
+
+    /// Sets the analysis window (rounded up to a power of two, min 64)
+    void setWindowSize(int newWindowSize);
+    int getWindowSize() const { return windowSize; }
+
+    /// Returns the fundamental of the last getWindowSize() samples in Hz, or
+    /// 0 if no periodicity is found.
+    float detect(const float* samples, double sampleRate);
+
+    /// YIN aperiodicity of the last detection (0 = perfectly periodic)
+    float getLastAperiodicity() const { return lastAperiodicity; }
+
+    /// Smallest power-of-two window that resolves lowestFrequency
+    static int getWindowSizeFor(double sampleRate, float lowestFrequency);
+
+    static constexpr float threshold = 0.15f;
+
+  private:
+    int windowSize = 0;
+    std::unique_ptr<juce::dsp::FFT> fft;
+    std::vector<float> spectrumA; // First half of the window, zero padded
+    std::vector<float> spectrumB; // Whole window, zero padded
+    std::vector<float> yin;       // Cumulative mean normalised difference
+    float lastAperiodicity = 1.0f;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PitchDetector)
+};
@@ -24,6 +24,7 @@
 #include "ColourScheme.h"
 #include "CrashProtection.h"
 #include "DeviceMeterTap.h"
+#include "DspProfiler.h"
 #include "FilterGraph.h"
 #include "FontManager.h"
 #include "IconManager.h"
@@ -32,6 +33,7 @@
 #include "MappingsDialog.h"
 #include "MasterGainState.h"
 #include "PedalboardProcessors.h"
+#include "PerfTrace.h"
 #include "PluginField.h"
 #include "PresetBar.h"
 #include "SafetyLimiter.h"
@@ -39,6 +41,7 @@
 #include "SubGraphEditorComponent.h"
 #include "Vectors.h"
 
+#include <algorithm>
 #include <melatonin_blur/melatonin_blur.h>
 #include <spdlog/spdlog.h>
 
@@ -286,12 +289,27 @@ PluginComponent::~PluginComponent()
 //------------------------------------------------------------------------------
 void PluginComponent::paint(Graphics& g)
 {
+    const PerfTrace::Zone zone("PluginComponent::paint", "ui");
     int i;
     auto& colours = ColourScheme::getInstance().colours;
     float w = (float)getWidth();
     float h = (float)getHeight();
     const float cornerRadius = 8.0f;
 
+    // === ZOOMED FAR OUT: just the node and a name big enough to read ===
+    if (detailLevel == BoxOnly)
+    {
+        g.setColour(colours["Plugin Background"]);
+        g.fillRoundedRectangle(2.0f, 2.0f, w - 4.0f, h - 4.0f, cornerRadius);
+        g.setColour(isAudioIONode() ? colours["Audio Connection"].withAlpha(0.6f) : colours["Plugin Border"]);
+        g.drawRoundedRectangle(2.0f, 2.0f, w - 4.0f, h - 4.0f, cornerRadius, 2.0f);
+
+        g.setColour(colours["Text Colour"]);
+        g.setFont(FontManager::getInstance().getHeadingFont().withHeight(jlimit(14.0f, 48.0f, h * 0.25f)));
+        g.drawFittedText(titleLabel->getText(), getLocalBounds().reduced(10), Justification::centred, 3);
+        return;
+    }
+
     // === MAIN FILL (gradient for premium feel) ===
     Colour bgTop = colours["Plugin Background"].brighter(0.08f);
     Colour bgBottom = colours["Plugin Background"].darker(0.08f);
@@ -391,7 +409,7 @@ void PluginComponent::paint(Graphics& g)
         outputText[i]->draw(g);
 
     // Draw horizontal VU meters for Audio I/O nodes (full width)
-    if (isAudioIONode() && cachedMeterChannelCount > 0)
+    if (isAudioIONode() && cachedMeterChannelCount > 0 && detailLevel == FullDetail)
     {
         const float pinMargin = 22.0f;
         const float edgeMargin = 8.0f;
@@ -478,6 +496,34 @@ void PluginComponent::paint(Graphics& g)
     }
 }
 
+//------------------------------------------------------------------------------
+void PluginComponent::paintOverChildren(Graphics& g)
+{
+    if (dspMeanLoad < 0.0f || detailLevel == BoxOnly)
+        return;
+
+    auto& colours = ColourScheme::getInstance().colours;
+    const String text = "DSP " + String(dspMeanLoad * 100.0f, 1) + "%  p99 " + String(dspP99Load * 100.0f, 1) + "%";
+
+    Colour colour = colours["Text Colour"];
+    if (dspP99Load > 0.5f)
+        colour = colours["Danger Colour"];
+    else if (dspP99Load > 0.2f)
+        colour = colours["Warning Colour"];
+
+    // Bottom-left, just above the footer buttons
+    const auto font = FontManager::getInstance().getCaptionFont();
+    const float width = font.getStringWidthFloat(text) + 10.0f;
+    const Rectangle<float> badge(6.0f, (float)getHeight() - 54.0f, width, 15.0f);
+
+    g.setColour(colours["Plugin Background"].darker(0.6f).withAlpha(0.85f));
+    g.fillRoundedRectangle(badge, 4.0f);
+    g.setColour(colour.withAlpha(0.8f));
+    g.drawRoundedRectangle(badge, 4.0f, 1.0f);
+    g.setFont(font);
+    g.drawText(text, badge, Justification::centred, false);
+}
+
 //------------------------------------------------------------------------------
 void PluginComponent::moved()
 {
@@ -492,8 +538,30 @@ void PluginComponent::timerUpdate()
     if (bypassable)
         bypassButton->setToggleState(bypassable->getBypass(), false);
 
+    // Nothing else is drawn
+    if (detailLevel == BoxOnly)
+        return;
+
+    // DSP load badge, while the profiler is running
+    float meanLoad = -1.0f;
+    float p99Load = 0.0f;
+    if (DspProfiler::isEnabled())
+    {
+        if (auto* load = DspProfiler::getInstance().getLoad(node->getProcessor()); load != nullptr && load->blocks > 0)
+        {
+            meanLoad = load->meanLoad;
+            p99Load = load->p99Load;
+        }
+    }
+    if (meanLoad != dspMeanLoad || p99Load != dspP99Load)
+    {
+        dspMeanLoad = meanLoad;
+        dspP99Load = p99Load;
+        repaint();
+    }
+
     // Update meter levels for Audio I/O nodes
-    if (isAudioIONode())
+    if (isAudioIONode() && detailLevel == FullDetail)
     {
         bool needsRepaint = false;
         int numChannels = 0;
@@ -551,26 +619,95 @@ void PluginComponent::timerUpdate()
 
         if (needsRepaint || peakHoldLevels[0] > 0.0f || peakHoldLevels[1] > 0.0f)
             repaint();
+    }
 
-        // Sync per-channel gain sliders from MasterGainState (when not being dragged)
-        if (channelGainSliders.size() > 0)
+    // Sync per-channel gain sliders from MasterGainState (when not being dragged)
+    if (channelGainSliders.size() > 0)
+    {
+        bool isInput = (pluginName == "Audio Input");
+        auto& state = MasterGainState::getInstance();
+        for (int ch = 0; ch < channelGainSliders.size(); ++ch)
         {
-            bool isInput = (pluginName == "Audio Input");
-            auto& state = MasterGainState::getInstance();
-            for (int ch = 0; ch < channelGainSliders.size(); ++ch)
+            auto* slider = channelGainSliders[ch];
+            if (slider != nullptr && !slider->isMouseButtonDown())
             {
-                auto* slider = channelGainSliders[ch];
-                if (slider != nullptr && !slider->isMouseButtonDown())
-                {
-                    float currentDb = isInput ? state.inputChannelGainDb[ch].load(std::memory_order_relaxed)
-                                              : state.outputChannelGainDb[ch].load(std::memory_order_relaxed);
+                float currentDb = isInput ? state.inputChannelGainDb[ch].load(std::memory_order_relaxed)
+                                          : state.outputChannelGainDb[ch].load(std::memory_order_relaxed);
 
-                    if (std::abs((float)slider->getValue() - currentDb) > 0.01f)
-                        slider->setValue(currentDb, dontSendNotification);
-                }
+                if (std::abs((float)slider->getValue() - currentDb) > 0.01f)
+                    slider->setValue(currentDb, dontSendNotification);
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+void PluginComponent::componentVisibilityChanged(Component& component)
+{
+    // Whoever changed it owns its visibility now; zooming back in mustn't undo that
+    component.removeComponentListener(this);
+    hiddenForDetail.removeAllInstancesOf(&component);
+}
+
+//------------------------------------------------------------------------------
+void PluginComponent::childrenChanged()
+{
+    // A removed child isn't ours to show again, and mustn't keep calling us after we've gone
+    hiddenForDetail.removeIf(
+        [this](Component::SafePointer<Component>& child)
+        {
+            if (child != nullptr && child->getParentComponent() == this)
+                return false;
+            if (child != nullptr)
+                child->removeComponentListener(this);
+            return true;
+        });
+}
+
+//------------------------------------------------------------------------------
+void PluginComponent::setDetailLevel(DetailLevel level)
+{
+    if (level == detailLevel)
+        return;
+
+    if (level == BoxOnly)
+    {
+        // Keep the pins, so cables still end at them and can be dragged out
+        for (auto* child : getChildren())
+        {
+            if (child->isVisible() && !dynamic_cast<PluginPinComponent*>(child))
+            {
+                child->setVisible(false);
+                hiddenForDetail.add(child);
+
+                // So we hear if anything else shows it (and maybe hides it again) before we zoom back in
+                child->addComponentListener(this);
             }
         }
     }
+    else if (detailLevel == BoxOnly)
+    {
+        // Anything shown for another reason in the meantime, or removed, has already been dropped
+        for (auto& child : hiddenForDetail)
+        {
+            if (child != nullptr && child->getParentComponent() == this)
+            {
+                child->removeComponentListener(this);
+                child->setVisible(true);
+            }
+        }
+        hiddenForDetail.clear();
+    }
+
+    // Don't show a held peak from before the meters were switched off
+    if (level != FullDetail)
+    {
+        std::fill(std::begin(peakHoldLevels), std::end(peakHoldLevels), 0.0f);
+        std::fill(std::begin(peakHoldCounters), std::end(peakHoldCounters), 0);
+    }
+
+    detailLevel = level;
+    repaint();
 }
 
 //------------------------------------------------------------------------------
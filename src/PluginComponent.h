@@ -38,9 +38,18 @@ class PluginComponent : public Component,
                         public Button::Listener,
                         public Label::Listener,
                         public Slider::Listener,
+                        private ComponentListener,
                         private Timer
 {
   public:
+    ///	How much of the node is drawn, chosen by the PluginField from its zoom level.
+    enum DetailLevel
+    {
+        FullDetail = 0, ///<	Everything.
+        NoMeters,       ///<	No level meters or their updates.
+        BoxOnly         ///<	Just the node and its name; only the pins are left visible.
+    };
+
     ///	Constructor.
     PluginComponent(AudioProcessorGraph::Node* n);
     ///	Destructor.
@@ -48,13 +57,22 @@ class PluginComponent : public Component,
 
     ///	Draws the component.
     void paint(Graphics& g);
+    ///	Draws the DSP load badge over the plugin's controls.
+    void paintOverChildren(Graphics& g) override;
 
     ///	Used to redraw any connections to this component's pins.
     void moved();
+    ///	Forgets any child removed while it was hidden for BoxOnly.
+    void childrenChanged() override;
 
     ///	Used to update the bypass button if it needs it.
     void timerUpdate();
 
+    ///	Sets how much of the node to draw.
+    void setDetailLevel(DetailLevel level);
+    ///	Returns how much of the node is drawn.
+    DetailLevel getDetailLevel() const { return detailLevel; };
+
     ///	Used to move the component about the PluginField.
     void mouseDown(const MouseEvent& e);
     ///	Used to move the component about the PluginField.
@@ -202,9 +220,21 @@ class PluginComponent : public Component,
     /// Peak hold countdown timers (frames remaining before decay)
     int peakHoldCounters[16]{};
 
+    /// DSP load from the profiler's last update, as fractions of the callback budget (-1 = not shown)
+    float dspMeanLoad = -1.0f;
+    float dspP99Load = 0.0f;
+
     /// Per-channel gain sliders for Audio I/O nodes
     OwnedArray<Slider> channelGainSliders;
 
+    ///	How much of the node is drawn.
+    DetailLevel detailLevel = FullDetail;
+    ///	Forgets a child hidden for BoxOnly once something else shows it.
+    void componentVisibilityChanged(Component& component) override;
+
+    ///	The children hidden only for BoxOnly, to show again when zoomed back in.
+    Array<Component::SafePointer<Component>> hiddenForDetail;
+
     /// Drop shadow for premium floating-node effect (melatonin_blur, cached internally)
     melatonin::DropShadow nodeShadow{Colours::black.withAlpha(0.35f), 8, {2, 3}};
 
@@ -326,8 +356,18 @@ class PluginConnection : public Component, public ChangeListener, public Settabl
     ///	Destructor.
     ~PluginConnection();
 
-    ///	Draws the connection.
+    ///	Draws the connection while it's being dragged out from a pin.
+    /*!
+        Once connected, the cable is drawn by its canvas via paintCables(), and
+        this component only handles hit testing, clicks and the tooltip.
+     */
     void paint(Graphics& g);
+    ///	Draws every connected cable on canvas that intersects the clip region.
+    /*!
+        Called from the canvas's own paint(), so all the cables are drawn in one
+        layer behind the plugin components from their cached geometry.
+     */
+    static void paintCables(Graphics& g, const Component& canvas);
 
     ///	Used to select the connection (e.g. to delete it).
     void mouseDown(const MouseEvent& e);
@@ -363,7 +403,12 @@ class PluginConnection : public Component, public ChangeListener, public Settabl
      */
     void getPoints(int& sX, int& sY, int& dX, int& dY);
     ///	Helper method to work out (and update) the component's bounds.
+    /*!
+        Only rebuilds the cable's geometry when its end points have moved.
+     */
     void updateBounds(int sX, int sY, int dX, int dY);
+    ///	Draws the cable from its cached geometry, offset by origin.
+    void paintCable(Graphics& g, Colour cableColour, Point<float> origin);
 
     ///	The source plugin pin.
     PluginPinComponent* source;
@@ -374,6 +419,21 @@ class PluginConnection : public Component, public ChangeListener, public Settabl
     Path drawnCurve;
     ///	The original bezier curve for glow rendering.
     Path glowPath;
+    ///	The thin highlight drawn along the curve.
+    Path highlightCurve;
+    ///	Bounds of glowPath, for the cable's gradient.
+    Rectangle<float> curveBounds;
+    ///	The end points the cached geometry was built for.
+    Point<int> cachedStart, cachedEnd;
+    ///	Whether the geometry has been built yet.
+    bool hasGeometry = false;
+
+    ///	The selection glow, blurred once per shape, colour and scale.
+    Image glowImage;
+    ///	The physical pixel scale glowImage was rendered at.
+    float glowScale = 0.0f;
+    ///	The cable colour glowImage was rendered with.
+    Colour glowColour;
 
     ///	Whether the connection is selected or not.
     bool selected;
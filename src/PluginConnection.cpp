@@ -19,6 +19,7 @@
 
 #include "ColourScheme.h"
 #include "PluginComponent.h"
+#include "PerfTrace.h"
 #include "PluginField.h"
 #include "SubGraphEditorComponent.h"
 
@@ -75,10 +76,42 @@ PluginConnection::~PluginConnection()
 //------------------------------------------------------------------------------
 void PluginConnection::paint(Graphics& g)
 {
+    // Connected cables are drawn by the canvas, in paintCables()
+    if (destination)
+        return;
+
     auto& colours = ColourScheme::getInstance().colours;
-    Colour cableColour = paramCon ? colours["Parameter Connection"] : colours["Audio Connection"];
+    paintCable(g, paramCon ? colours["Parameter Connection"] : colours["Audio Connection"], {});
+}
 
-    auto bounds = getLocalBounds().toFloat();
+//------------------------------------------------------------------------------
+void PluginConnection::paintCables(Graphics& g, const Component& canvas)
+{
+    const PerfTrace::Zone zone("PluginConnection::paintCables", "ui");
+    auto& colours = ColourScheme::getInstance().colours;
+    const Colour audioColour = colours["Audio Connection"];
+    const Colour paramColour = colours["Parameter Connection"];
+    const auto clip = g.getClipBounds();
+
+    for (auto* child : canvas.getChildren())
+    {
+        auto* connection = dynamic_cast<PluginConnection*>(child);
+
+        // A cable still being dragged out draws itself, in front of the plugins
+        if (!connection || !connection->destination || !connection->isVisible())
+            continue;
+        if (!connection->getBounds().intersects(clip))
+            continue;
+
+        connection->paintCable(g, connection->paramCon ? paramColour : audioColour,
+                               connection->getPosition().toFloat());
+    }
+}
+
+//------------------------------------------------------------------------------
+void PluginConnection::paintCable(Graphics& g, Colour cableColour, Point<float> origin)
+{
+    const auto offset = AffineTransform::translation(origin);
 
     // === Signal-based glow (DISABLED - low priority, potentially distracting) ===
     // TODO: Re-enable when true per-connection signal detection is implemented
@@ -102,7 +135,8 @@ void PluginConnection::paint(Graphics& g)
             float strokeWidth = 8.0f + (i * 3.0f);
             float alpha = 0.06f / (float)i;
             g.setColour(cableColour.withAlpha(alpha));
-            g.strokePath(glowPath, PathStrokeType(strokeWidth, PathStrokeType::mitered, PathStrokeType::rounded));
+            g.strokePath(glowPath, PathStrokeType(strokeWidth, PathStrokeType::mitered, PathStrokeType::rounded),
+                         offset);
         }
     }
     */
@@ -110,8 +144,22 @@ void PluginConnection::paint(Graphics& g)
     // === Selection glow (soft halo around selected cables) ===
     if (selected)
     {
-        melatonin::DropShadow cableGlow{cableColour.withAlpha(0.4f), 8, {0, 0}};
-        cableGlow.render(g, glowPath);
+        // Blurring is the expensive part, so it's only redone when the shape, colour or zoom changes
+        const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+        if (glowImage.isNull() || scale != glowScale || cableColour != glowColour)
+        {
+            glowScale = scale;
+            glowColour = cableColour;
+            glowImage = Image(Image::ARGB, jmax(1, roundToInt(getWidth() * scale)),
+                              jmax(1, roundToInt(getHeight() * scale)), true);
+
+            Graphics glowGraphics(glowImage);
+            glowGraphics.addTransform(AffineTransform::scale(scale));
+            melatonin::DropShadow cableGlow{cableColour.withAlpha(0.4f), 8, {0, 0}};
+            cableGlow.render(glowGraphics, glowPath);
+        }
+
+        g.drawImageTransformed(glowImage, AffineTransform::scale(1.0f / glowScale).followedBy(offset));
     }
 
     // === Gradient fill from source to destination (bidirectional) ===
@@ -119,16 +167,14 @@ void PluginConnection::paint(Graphics& g)
     Colour endCol = cableColour.darker(selected ? 0.0f : 0.15f);
 
     // Use actual start/end points from the bezier curve for proper bidirectional gradient
-    Point<float> gradStart = glowPath.getBounds().getTopLeft();
-    Point<float> gradEnd = glowPath.getBounds().getBottomRight();
-
-    ColourGradient wireGrad(startCol, gradStart.x, gradStart.y, endCol, gradEnd.x, gradEnd.y, false);
+    ColourGradient wireGrad(startCol, curveBounds.getTopLeft() + origin, endCol, curveBounds.getBottomRight() + origin,
+                            false);
     g.setGradientFill(wireGrad);
-    g.fillPath(drawnCurve);
+    g.fillPath(drawnCurve, offset);
 
     // === Thin highlight stroke for depth ===
     g.setColour(Colours::white.withAlpha(0.12f));
-    g.strokePath(glowPath, PathStrokeType(1.0f, PathStrokeType::mitered, PathStrokeType::rounded));
+    g.fillPath(highlightCurve, offset);
 }
 
 //------------------------------------------------------------------------------
@@ -158,6 +204,8 @@ void PluginConnection::mouseDown(const MouseEvent& e)
     else // Left-click
     {
         selected = !selected;
+        if (!selected)
+            glowImage = {};
         repaint();
     }
 }
@@ -222,6 +270,9 @@ void PluginConnection::setDestination(PluginPinComponent* d)
     if (source && destination)
         setTooltip(String(paramCon ? "MIDI" : "Audio") + " connection");
 
+    // The canvas draws the cable from now on
+    repaint();
+
     if (source && destination && parentCanvas)
     {
         Point<int> sourcePoint(source->getX() + 7, source->getY() + 8);
@@ -317,6 +368,14 @@ void PluginConnection::updateBounds(int sX, int sY, int dX, int dY)
     // 3. Build path by subtracting getPosition() for local coords
 
     // Calculate bounding rectangle with 5px padding (JUCE uses 4, we use 5 for thicker cables)
+    // Nodes send change messages for more than moves; only rebuild the geometry when an end has moved
+    const Point<int> start(sX, sY), end(dX, dY);
+    if (hasGeometry && start == cachedStart && end == cachedEnd)
+        return;
+    cachedStart = start;
+    cachedEnd = end;
+    hasGeometry = true;
+
     auto p1 = Point<float>((float)sX, (float)sY);
     auto p2 = Point<float>((float)dX, (float)dY);
 
@@ -343,8 +402,12 @@ void PluginConnection::updateBounds(int sX, int sY, int dX, int dY)
 
     // Store for glow rendering
     glowPath = tempPath;
+    curveBounds = glowPath.getBounds();
+    glowImage = {};
 
-    // Create stroked path for hit testing and rendering
+    // Create stroked paths for hit testing and rendering, once per shape rather than on every paint
     PathStrokeType drawnType(9.0f, PathStrokeType::mitered, PathStrokeType::rounded);
     drawnType.createStrokedPath(drawnCurve, tempPath);
+    PathStrokeType highlightType(1.0f, PathStrokeType::mitered, PathStrokeType::rounded);
+    highlightType.createStrokedPath(highlightCurve, tempPath);
 }
@@ -31,6 +31,7 @@
 #include "NiallsOSCLib/OSCBundle.h"
 #include "NiallsOSCLib/OSCMessage.h"
 #include "PedalboardProcessors.h"
+#include "PerfTrace.h"
 #include "PluginComponent.h"
 #include "PluginSearchOverlay.h"
 #include "SettingsManager.h"
@@ -156,8 +157,6 @@ PluginField::PluginField(FilterGraph* filterGraph, KnownPluginList* list, Applic
             }
         }
     };
-
-    startTimer(50);
 }
 
 //------------------------------------------------------------------------------
@@ -190,14 +189,19 @@ PluginField::~PluginField()
 //------------------------------------------------------------------------------
 void PluginField::paint(Graphics& g)
 {
+    const PerfTrace::Zone zone("PluginField::paint", "ui");
     auto& colours = ColourScheme::getInstance().colours;
     auto bounds = getLocalBounds().toFloat();
 
+    // Zoomed out, the field can be many times the size of the view, so only
+    // fill and grid the part being repainted
+    auto clip = g.getClipBounds().toFloat().getIntersection(bounds);
+
     // === Gradient background ===
     Colour bgCol = colours["Field Background"];
     ColourGradient bgGrad(bgCol.brighter(0.08f), 0.0f, 0.0f, bgCol.darker(0.15f), 0.0f, bounds.getHeight(), false);
     g.setGradientFill(bgGrad);
-    g.fillRect(bounds);
+    g.fillRect(clip);
 
     // === Grid pattern ===
     float gridSize = 30.0f;
@@ -205,15 +209,15 @@ void PluginField::paint(Graphics& g)
     g.setColour(gridCol);
 
     // Vertical lines
-    for (float x = 0.0f; x < bounds.getWidth(); x += gridSize)
+    for (float x = std::floor(clip.getX() / gridSize) * gridSize; x < clip.getRight(); x += gridSize)
     {
-        g.drawVerticalLine((int)x, 0.0f, bounds.getHeight());
+        g.drawVerticalLine((int)x, clip.getY(), clip.getBottom());
     }
 
     // Horizontal lines
-    for (float y = 0.0f; y < bounds.getHeight(); y += gridSize)
+    for (float y = std::floor(clip.getY() / gridSize) * gridSize; y < clip.getBottom(); y += gridSize)
     {
-        g.drawHorizontalLine((int)y, 0.0f, bounds.getWidth());
+        g.drawHorizontalLine((int)y, clip.getX(), clip.getRight());
     }
 
     if (displayDoubleClickMessage)
@@ -250,6 +254,9 @@ void PluginField::paint(Graphics& g)
         g.drawText(subHint, (int)(centerX - subWidth / 2), (int)(centerY + 18), subWidth + 20, 24,
                    Justification::centred, false);
     }
+
+    // === Connection cables, all in one layer behind the plugins ===
+    PluginConnection::paintCables(g, *this);
 }
 
 //------------------------------------------------------------------------------
@@ -584,6 +591,8 @@ void PluginField::mouseWheelMove(const MouseEvent& e, const MouseWheelDetails& w
                 setTransform(AffineTransform::scale(zoomLevel));
             }
 
+            // Switch detail levels now rather than on the next update
+            updateComponents();
             repaint();
         }
     }
@@ -647,6 +656,7 @@ void PluginField::fitToScreen()
                           bounds.getX(), bounds.getY(), bounds.getWidth(), bounds.getHeight(), (int)viewWidth,
                           (int)viewHeight, zoomLevel, getWidth(), getHeight(), centeredX, centeredY);
 
+            updateComponents();
             repaint();
         }
     }
@@ -680,19 +690,47 @@ void PluginField::changeListenerCallback(ChangeBroadcaster* source)
 }
 
 //------------------------------------------------------------------------------
-void PluginField::timerCallback()
+void PluginField::updateComponents()
 {
     int i;
+    const PluginComponent::DetailLevel detail = getDetailLevel();
+    const Rectangle<int> visibleArea = getVisibleArea();
 
     for (i = 0; i < getNumChildComponents(); ++i)
     {
         PluginComponent* comp = dynamic_cast<PluginComponent*>(getChildComponent(i));
 
         if (comp)
-            comp->timerUpdate();
+        {
+            comp->setDetailLevel(detail);
+
+            // Nodes scrolled out of view are brought up to date when they come back
+            if (comp->getBounds().intersects(visibleArea))
+                comp->timerUpdate();
+        }
     }
 }
 
+//------------------------------------------------------------------------------
+PluginComponent::DetailLevel PluginField::getDetailLevel() const
+{
+    if (zoomLevel < boxOnlyZoom)
+        return PluginComponent::BoxOnly;
+    if (zoomLevel < noMetersZoom)
+        return PluginComponent::NoMeters;
+    return PluginComponent::FullDetail;
+}
+
+//------------------------------------------------------------------------------
+Rectangle<int> PluginField::getVisibleArea() const
+{
+    // getLocalArea() takes the zoom transform into account
+    if (auto* viewport = findParentComponentOfClass<Viewport>())
+        return getLocalArea(viewport, viewport->getLocalBounds());
+
+    return getLocalBounds();
+}
+
 //------------------------------------------------------------------------------
 bool PluginField::isInterestedInFileDrag(const StringArray& files)
 {
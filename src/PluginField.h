@@ -22,6 +22,8 @@
 
 #include "MidiMappingManager.h"
 #include "OscMappingManager.h"
+#include "PluginComponent.h"
+#include "UiFrameScheduler.h"
 
 #include <JuceHeader.h>
 #include <map>
@@ -49,8 +51,7 @@ class PluginField : public Component,
                     public ChangeBroadcaster,
                     public ChangeListener,
                     public FileDragAndDropTarget,
-                    public AudioPlayHead,
-                    public Timer
+                    public AudioPlayHead
 {
   public:
     ///	Constructor.
@@ -75,7 +76,11 @@ class PluginField : public Component,
     void changeListenerCallback(ChangeBroadcaster* source);
 
     ///	Used to periodically update PluginComponents etc.
-    void timerCallback();
+    /*!
+        Also sets each PluginComponent's detail level from the zoom, and skips
+        updating those scrolled out of view.
+     */
+    void updateComponents();
 
     ///	Used to accept dragged plugin files.
     bool isInterestedInFileDrag(const StringArray& files);
@@ -238,15 +243,26 @@ class PluginField : public Component,
     static constexpr float minZoom = 0.25f;
     ///	Maximum zoom level.
     static constexpr float maxZoom = 3.0f;
+    ///	Below this zoom level, nodes stop drawing and updating their level meters.
+    static constexpr float noMetersZoom = 0.6f;
+    ///	Below this zoom level, nodes are drawn as plain boxes with their names.
+    static constexpr float boxOnlyZoom = 0.4f;
 
     ///	Floating search overlay for plugin selection.
     std::unique_ptr<PluginSearchWindow> searchWindow;
 
+    ///	Calls updateComponents() 20 times a second, off the display refresh.
+    UiFrameScheduler::Client frameClient{this, 20.0, [this]() { updateComponents(); }};
+
   public:
     ///	Fits all nodes to the visible viewport.
     void fitToScreen();
     ///	Returns current zoom level.
     float getZoomLevel() const { return zoomLevel; }
+    ///	Returns how much of each node to draw at the current zoom level.
+    PluginComponent::DetailLevel getDetailLevel() const;
+    ///	Returns the part of the field currently visible in the viewport.
+    Rectangle<int> getVisibleArea() const;
 };
 
 #endif
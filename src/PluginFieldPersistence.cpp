@@ -20,6 +20,8 @@
 #include "FilterGraph.h"
 #include "InternalFilters.h"
 #include "Mapping.h"
+#include "PatchSwitchTimer.h"
+#include "PerfTrace.h"
 #include "PluginComponent.h"
 #include "PluginField.h"
 #include "PluginSearchOverlay.h"
@@ -86,6 +88,8 @@ struct NodeAndId
 //------------------------------------------------------------------------------
 void PluginField::loadFromXml(XmlElement* patch)
 {
+    const PerfTrace::Zone zone("PluginField::loadFromXml", "patch");
+    auto& switchTimer = PatchSwitchTimer::getInstance();
     int i, j;
     Array<uint32> paramConnections;
 
@@ -106,6 +110,7 @@ void PluginField::loadFromXml(XmlElement* patch)
             waited += 5;
         }
     }
+    switchTimer.markStage(PatchSwitchTimer::CrossfadeWait);
 
     // Delete all the filter and connection components.
     {
@@ -127,6 +132,7 @@ void PluginField::loadFromXml(XmlElement* patch)
 
     // Wipe userNames.
     userNames.clear();
+    switchTimer.markStage(PatchSwitchTimer::RebuildComponents);
 
     // Clear and possibly load the signal path.
     clearMappings();
@@ -141,6 +147,7 @@ void PluginField::loadFromXml(XmlElement* patch)
     }
     else
         signalPath->clear(audioInputEnabled, midiInputEnabled);
+    switchTimer.markStage(PatchSwitchTimer::RestoreGraph);
 
     // === FADE BACK IN ===
     // Start crossfade in after loading is complete
@@ -21,6 +21,7 @@
 
 #include "AudioSingletons.h"
 #include "BypassableInstance.h"
+#include "PerfTrace.h"
 
 #include <spdlog/spdlog.h>
 
@@ -147,6 +148,78 @@ void extractPluginsFromFilter(const XmlElement& filterElem, std::vector<PluginDe
         result.push_back(desc);
 }
 
+/// Decodes an internal processor's STATE, which is copyXmlToBinary() XML
+std::unique_ptr<XmlElement> getInternalStateXml(const XmlElement& filterElem)
+{
+    auto* descElem = filterElem.getChildByName("PLUGIN");
+    auto* stateElem = filterElem.getChildByName("STATE");
+    if (descElem == nullptr || stateElem == nullptr)
+        return nullptr;
+
+    PluginDescription desc;
+    if (!desc.loadFromXml(*descElem) || desc.pluginFormatName != "Internal")
+        return nullptr;
+
+    juce::MemoryBlock state;
+    if (!state.fromBase64Encoding(stateElem->getAllSubText()))
+        return nullptr;
+
+    return juce::AudioProcessor::getXmlFromBinary(state.getData(), (int)state.getSize());
+}
+
+void extractMediaFromFilter(const XmlElement& filterElem, std::vector<MediaReference>& result)
+{
+    auto stateXml = getInternalStateXml(filterElem);
+    if (!stateXml)
+        return;
+
+    auto add = [&result](const String& path, MediaReference::Kind kind)
+    {
+        if (path.isNotEmpty() && File::isAbsolutePath(path))
+            result.push_back({File(path), kind});
+    };
+
+    if (stateXml->hasTagName("RACK"))
+    {
+        for (auto* rackFilter : stateXml->getChildWithTagNameIterator("FILTER"))
+            extractMediaFromFilter(*rackFilter, result);
+    }
+    else if (stateXml->hasTagName("Pedalboard3FilePlayerSettings"))
+    {
+        add(stateXml->getStringAttribute("file"), stateXml->getBoolAttribute("preload", false)
+                                                      ? MediaReference::Kind::PreloadedAudio
+                                                      : MediaReference::Kind::StreamedAudio);
+    }
+    else if (stateXml->hasTagName("Pedalboard3LooperSettings"))
+    {
+        add(stateXml->getStringAttribute("soundFile"), MediaReference::Kind::StreamedAudio);
+    }
+    else if (stateXml->hasTagName("MidiFilePlayer"))
+    {
+        add(stateXml->getStringAttribute("file"), MediaReference::Kind::MidiFile);
+    }
+}
+
+std::vector<MediaReference> extractMediaFromPatchImpl(const XmlElement* patchXml)
+{
+    std::vector<MediaReference> result;
+
+    if (!patchXml)
+        return result;
+
+    const XmlElement* graphXml = patchXml;
+    if (patchXml->hasTagName("Patch"))
+        graphXml = patchXml->getChildByName("FILTERGRAPH");
+
+    if (graphXml == nullptr)
+        return result;
+
+    for (auto* filterElem : graphXml->getChildWithTagNameIterator("FILTER"))
+        extractMediaFromFilter(*filterElem, result);
+
+    return result;
+}
+
 std::vector<PluginDescription> extractPluginsFromPatchImpl(const XmlElement* patchXml)
 {
     std::vector<PluginDescription> result;
@@ -257,11 +330,15 @@ void PluginPoolManager::clear()
     pluginPool.clear();
     patchDefinitions.clear();
     patchPluginRequirements.clear();
+    patchMediaRequirements.clear();
     loadedPatches.clear();
     patchLoadProgress.clear();
 
     currentPatchIndex.store(0);
 
+    // Nothing is pinned any more; the cache keeps what fits
+    MediaCache::getInstance().setWindow({});
+
     spdlog::info("[PluginPoolManager] Pool cleared");
 }
 
@@ -285,8 +362,11 @@ void PluginPoolManager::addPatchDefinition(int patchIndex, std::unique_ptr<XmlEl
     }
     patchPluginRequirements[patchIndex] = std::move(identifiers);
 
-    spdlog::debug("[PluginPoolManager] Added patch {} with {} plugins", patchIndex,
-                  patchPluginRequirements[patchIndex].size());
+    // And the backing tracks, loops and MIDI files it will open
+    patchMediaRequirements[patchIndex] = extractMediaFromPatchImpl(patchDefinitions[patchIndex].get());
+
+    spdlog::debug("[PluginPoolManager] Added patch {} with {} plugins, {} media files", patchIndex,
+                  patchPluginRequirements[patchIndex].size(), patchMediaRequirements[patchIndex].size());
 }
 
 //------------------------------------------------------------------------------
@@ -334,6 +414,9 @@ void PluginPoolManager::setCurrentPosition(int setlistIndex)
 
     // Release plugins outside new window
     releaseUnusedPlugins();
+
+    // Prefetch the new window's media; the cache lets go of the old
+    prefetchWindowMedia();
 }
 
 //------------------------------------------------------------------------------
@@ -378,8 +461,12 @@ AudioPluginInstance* PluginPoolManager::getOrCreatePlugin(const PluginDescriptio
     spdlog::info("[PluginPoolManager] Creating new plugin: {}", desc.name.toStdString());
 
     String errorMessage;
-    auto newInstance =
-        AudioPluginFormatManagerSingleton::getInstance().createPluginInstance(desc, 44100.0, 512, errorMessage);
+    std::unique_ptr<AudioPluginInstance> newInstance;
+    {
+        const PerfTrace::Zone zone("Create plugin instance", "plugin");
+        newInstance =
+            AudioPluginFormatManagerSingleton::getInstance().createPluginInstance(desc, 44100.0, 512, errorMessage);
+    }
 
     if (!newInstance)
     {
@@ -486,6 +573,7 @@ void PluginPoolManager::queuePatchLoad(int patchIndex)
 //------------------------------------------------------------------------------
 void PluginPoolManager::loadPatchPlugins(int patchIndex)
 {
+    const PerfTrace::Zone zone("PluginPoolManager::loadPatchPlugins", "loader");
     spdlog::info("[PluginPoolManager] Loading patch {}", patchIndex);
 
     std::vector<PluginDescription> plugins;
@@ -570,8 +658,45 @@ std::vector<PluginDescription> PluginPoolManager::extractPluginsFromPatchForTest
 {
     return extractPluginsFromPatchImpl(patchXml);
 }
+
+std::vector<MediaReference> PluginPoolManager::extractMediaFromPatchForTest(const XmlElement* patchXml)
+{
+    return extractMediaFromPatchImpl(patchXml);
+}
 #endif
 
+//------------------------------------------------------------------------------
+void PluginPoolManager::prefetchWindowMedia()
+{
+    std::vector<MediaReference> media;
+
+    {
+        ScopedLock lock(poolLock);
+
+        // Same priority order as the plugin load queue: current, next, previous
+        const int currentPos = currentPatchIndex.load();
+        std::vector<int> window{currentPos};
+        for (int i = 1; i <= preloadRange; ++i)
+            window.push_back(currentPos + i);
+        window.push_back(currentPos - 1);
+
+        for (int patch : window)
+        {
+            auto it = patchMediaRequirements.find(patch);
+            if (it == patchMediaRequirements.end())
+                continue;
+
+            for (const auto& ref : it->second)
+            {
+                if (std::find(media.begin(), media.end(), ref) == media.end())
+                    media.push_back(ref);
+            }
+        }
+    }
+
+    MediaCache::getInstance().setWindow(media);
+}
+
 //------------------------------------------------------------------------------
 void PluginPoolManager::releaseUnusedPlugins()
 {
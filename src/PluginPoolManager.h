@@ -21,6 +21,8 @@
 #ifndef PLUGINPOOLMANAGER_H_
 #define PLUGINPOOLMANAGER_H_
 
+#include "MediaCache.h"
+
 #include <JuceHeader.h>
 #include <map>
 #include <memory>
@@ -165,12 +167,18 @@ class PluginPoolManager : private Thread
     /// Test-only helper to exercise patch plugin extraction.
     static std::vector<PluginDescription> extractPluginsFromPatchForTest(const XmlElement* patchXml);
 
+    /// Test-only helper to exercise patch media extraction.
+    static std::vector<MediaReference> extractMediaFromPatchForTest(const XmlElement* patchXml);
+
   private:
 #endif
 
     /// Release plugins that are outside the current window.
     void releaseUnusedPlugins();
 
+    /// Hands the media referenced by the current window to the MediaCache.
+    void prefetchWindowMedia();
+
     /// Creates identifier string for a plugin description.
     static String createPluginIdentifier(const PluginDescription& desc);
 
@@ -186,6 +194,9 @@ class PluginPoolManager : private Thread
     /// Which plugins each patch needs - key is patch index.
     std::map<int, std::vector<String>> patchPluginRequirements;
 
+    /// Which media files each patch opens - key is patch index.
+    std::map<int, std::vector<MediaReference>> patchMediaRequirements;
+
     /// Set of patches that are fully loaded.
     std::set<int> loadedPatches;
 
@@ -0,0 +1,274 @@
+/*
+  ==============================================================================
+
+    PreloadedAudio.cpp
+    Whole-file decode-ahead for glitch-free backing track playback
+
+  ==============================================================================
+*/
+
+#include "PreloadedAudio.h"
+
+#include "AudioSingletons.h"
+#include "DiskIOScheduler.h"
+#include "MediaCache.h"
+
+#include <spdlog/spdlog.h>
+
+namespace
+{
+constexpr int sliceSamples = 65536; // Per channel, per time slice
+constexpr int inputPadding = 16;    // Zeros after the decoded audio, for the interpolators' look-ahead
+constexpr int idleWaitMs = 100;
+} // namespace
+
+//==============================================================================
+AudioPreloader::AudioPreloader()
+{
+    DiskIOScheduler::getInstance().getThread(DiskIOScheduler::Queue::Read).addTimeSliceClient(this);
+}
+
+AudioPreloader::~AudioPreloader()
+{
+    DiskIOScheduler::getInstance().getThread(DiskIOScheduler::Queue::Read).removeTimeSliceClient(this);
+}
+
+//==============================================================================
+void AudioPreloader::load(const juce::File& file, double sampleRate)
+{
+    clear();
+
+    if (sampleRate <= 0.0)
+        return;
+
+    // Prefetched for the setlist, or played earlier: no need to decode again
+    auto& cache = MediaCache::getInstance();
+    cache.setSampleRate(sampleRate);
+    if (auto cached = cache.getAudio(file, sampleRate))
+    {
+        const juce::ScopedLock sl(jobLock);
+        jobFile = file;
+        jobRate = sampleRate;
+        publish(std::move(cached));
+        return;
+    }
+
+    auto& formatManager = AudioFormatManagerSingleton::getInstance();
+    std::unique_ptr<juce::AudioFormatReader> newReader(formatManager.createReaderFor(file));
+    if (newReader == nullptr || newReader->lengthInSamples <= 0)
+        return;
+
+    if (static_cast<double>(newReader->lengthInSamples) / newReader->sampleRate > maxPreloadSeconds)
+    {
+        spdlog::warn("[AudioPreloader] {} is too long to preload; it will stream from disk",
+                     file.getFileName().toStdString());
+        return;
+    }
+
+    const juce::ScopedLock sl(jobLock);
+
+    const int numChannels = static_cast<int>(newReader->numChannels);
+    decoded.setSize(numChannels, static_cast<int>(newReader->lengthInSamples) + inputPadding);
+    decoded.clear();
+    decodedLength = 0;
+
+    jobFile = file;
+    jobRate = sampleRate;
+    jobRatio = newReader->sampleRate / sampleRate;
+    reader = std::move(newReader);
+
+    progress.store(0.0f, std::memory_order_relaxed);
+    loading.store(true, std::memory_order_release);
+
+    DiskIOScheduler::getInstance().getThread(DiskIOScheduler::Queue::Read).moveToFrontOfQueue(this);
+}
+
+void AudioPreloader::clear()
+{
+    {
+        const juce::ScopedLock sl(jobLock);
+        loading.store(false, std::memory_order_release);
+        reader.reset();
+        decoded.setSize(0, 0);
+        resampled.reset();
+        interpolators.clear();
+    }
+
+    const juce::ScopedLock sl(resultLock);
+    audio.reset();
+    audioFile = juce::File();
+    audioRate = 0.0;
+}
+
+std::shared_ptr<const juce::AudioBuffer<float>> AudioPreloader::getAudio() const
+{
+    const juce::ScopedLock sl(resultLock);
+    return audio;
+}
+
+juce::File AudioPreloader::getFile() const
+{
+    const juce::ScopedLock sl(resultLock);
+    return audioFile;
+}
+
+double AudioPreloader::getSampleRate() const
+{
+    const juce::ScopedLock sl(resultLock);
+    return audioRate;
+}
+
+//==============================================================================
+int AudioPreloader::useTimeSlice()
+{
+    const juce::ScopedLock sl(jobLock);
+
+    if (!loading.load(std::memory_order_acquire))
+        return idleWaitMs;
+
+    // Decode, one slice of the file at a time
+    if (reader != nullptr)
+    {
+        const auto length = reader->lengthInSamples;
+        const int count = static_cast<int>(juce::jmin<juce::int64>(sliceSamples, length - decodedLength));
+        reader->read(&decoded, static_cast<int>(decodedLength), count, decodedLength, true, true);
+        decodedLength += count;
+
+        const float decodeShare = jobRatio == 1.0 ? 1.0f : 0.5f;
+        progress.store(decodeShare * static_cast<float>(decodedLength) / static_cast<float>(length),
+                       std::memory_order_relaxed);
+
+        if (decodedLength < length)
+            return 0;
+
+        reader.reset();
+
+        if (jobRatio == 1.0)
+        {
+            decoded.setSize(decoded.getNumChannels(), static_cast<int>(decodedLength), true, false, true);
+            publish(std::move(decoded));
+            return idleWaitMs;
+        }
+
+        // Set up sample rate conversion of the whole file
+        resampledLength = static_cast<int>(std::ceil(static_cast<double>(decodedLength) / jobRatio));
+        resampled = std::make_unique<juce::AudioBuffer<float>>(decoded.getNumChannels(), resampledLength);
+        resampledDone = 0;
+        interpolators.clear();
+        inputUsed = 0;
+
+        // Prime the interpolators' history so output sample 0 lines up with input sample 0
+        const int latency = juce::roundToInt(juce::LagrangeInterpolator::getBaseLatency());
+        float primed[8];
+        for (int channel = 0; channel < decoded.getNumChannels(); ++channel)
+        {
+            auto* interpolator = interpolators.add(new juce::LagrangeInterpolator());
+            inputUsed = interpolator->process(1.0, decoded.getReadPointer(channel), primed, latency);
+        }
+        return 0;
+    }
+
+    // Resample, one slice of output at a time
+    const int count = juce::jmin(sliceSamples, resampledLength - resampledDone);
+    const int available = decoded.getNumSamples() - inputUsed;
+    int used = 0;
+    for (int channel = 0; channel < decoded.getNumChannels(); ++channel)
+        used = interpolators[channel]->process(jobRatio, decoded.getReadPointer(channel, inputUsed),
+                                               resampled->getWritePointer(channel, resampledDone), count, available, 0);
+    inputUsed += used;
+    resampledDone += count;
+
+    progress.store(0.5f + 0.5f * static_cast<float>(resampledDone) / static_cast<float>(resampledLength),
+                   std::memory_order_relaxed);
+
+    if (resampledDone < resampledLength)
+        return 0;
+
+    decoded.setSize(0, 0);
+    interpolators.clear();
+    publish(std::move(*resampled));
+    resampled.reset();
+    return idleWaitMs;
+}
+
+void AudioPreloader::publish(juce::AudioBuffer<float>&& result)
+{
+    auto finished = std::make_shared<const juce::AudioBuffer<float>>(std::move(result));
+    MediaCache::getInstance().addAudio(jobFile, jobRate, finished);
+
+    spdlog::info("[AudioPreloader] Preloaded {} ({:.1f} s, {:.1f} MB)", jobFile.getFileName().toStdString(),
+                 static_cast<double>(finished->getNumSamples()) / jobRate,
+                 static_cast<double>(finished->getNumChannels()) * finished->getNumSamples() * sizeof(float) /
+                     (1024.0 * 1024.0));
+    publish(std::move(finished));
+}
+
+void AudioPreloader::publish(std::shared_ptr<const juce::AudioBuffer<float>> finished)
+{
+    loading.store(false, std::memory_order_release);
+    progress.store(1.0f, std::memory_order_relaxed);
+
+    {
+        const juce::ScopedLock sl(resultLock);
+        audio = finished;
+        audioFile = jobFile;
+        audioRate = jobRate;
+    }
+
+    sendChangeMessage();
+}
+
+//==============================================================================
+PreloadedAudioSource::PreloadedAudioSource(std::shared_ptr<const juce::AudioBuffer<float>> preloaded)
+    : audio(std::move(preloaded))
+{
+    jassert(audio != nullptr);
+}
+
+void PreloadedAudioSource::getNextAudioBlock(const juce::AudioSourceChannelInfo& info)
+{
+    const int length = audio->getNumSamples();
+    const int numSourceChannels = audio->getNumChannels();
+    const bool loop = looping.load(std::memory_order_relaxed);
+
+    auto pos = position.load(std::memory_order_relaxed);
+    int done = 0;
+
+    while (done < info.numSamples)
+    {
+        if (pos >= length)
+        {
+            if (!loop || length == 0)
+                break;
+            pos %= length;
+        }
+
+        const int count = static_cast<int>(juce::jmin<juce::int64>(info.numSamples - done, length - pos));
+        for (int channel = 0; channel < info.buffer->getNumChannels(); ++channel)
+        {
+            info.buffer->copyFrom(channel, info.startSample + done, *audio, juce::jmin(channel, numSourceChannels - 1),
+                                  static_cast<int>(pos), count);
+        }
+
+        pos += count;
+        done += count;
+    }
+
+    if (done < info.numSamples)
+        info.buffer->clear(info.startSample + done, info.numSamples - done);
+
+    // Past the end when not looping, so AudioTransportSource sees the end of the stream
+    position.store(pos < length || loop ? pos : pos + info.numSamples - done, std::memory_order_relaxed);
+}
+
+void PreloadedAudioSource::setNextReadPosition(juce::int64 newPosition)
+{
+    position.store(juce::jmax<juce::int64>(0, newPosition), std::memory_order_relaxed);
+}
+
+juce::int64 PreloadedAudioSource::getNextReadPosition() const
+{
+    const auto pos = position.load(std::memory_order_relaxed);
+    const auto length = getTotalLength();
+    return isLooping() && length > 0 ? pos % length : pos;
+}
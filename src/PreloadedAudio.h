@@ -0,0 +1,119 @@
+/*
+  ==============================================================================
+
+    PreloadedAudio.h
+    Whole-file decode-ahead for glitch-free backing track playback
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_audio_formats/juce_audio_formats.h>
+
+#include <atomic>
+#include <memory>
+
+//==============================================================================
+/**
+    Decodes an audio file into RAM in the background, already converted to
+    the playback sample rate.
+
+    Audio already in the MediaCache (prefetched for the setlist, or decoded
+    by an earlier load) is published straight away; everything this decodes
+    is added to it.
+
+    Work is done in slices on the DiskIOScheduler read queue, so a long file
+    never holds up the streams that share it: each slice reads one block from
+    the file, then, once everything is in, resamples one block per channel.
+    Listeners get a change message on the message thread when the audio is
+    ready. Loading a new file or calling clear() abandons the current job.
+*/
+class AudioPreloader : public juce::ChangeBroadcaster, private juce::TimeSliceClient
+{
+  public:
+    /// Longer files are left to stream from disk
+    static constexpr double maxPreloadSeconds = 15.0 * 60.0;
+
+    AudioPreloader();
+    ~AudioPreloader() override;
+
+    /// Starts decoding file at sampleRate, replacing any previous job or result
+    void load(const juce::File& file, double sampleRate);
+    /// Abandons any job and frees the audio
+    void clear();
+
+    bool isLoading() const { return loading.load(std::memory_order_acquire); }
+    /// 0-1 through the current job
+    float getProgress() const { return progress.load(std::memory_order_relaxed); }
+
+    /// The finished audio (nullptr until a load completes)
+    std::shared_ptr<const juce::AudioBuffer<float>> getAudio() const;
+    /// The file and sample rate getAudio() was decoded from and for
+    juce::File getFile() const;
+    double getSampleRate() const;
+
+  private:
+    int useTimeSlice() override;
+    /// Called under jobLock once the job's audio is complete; adds it to the MediaCache
+    void publish(juce::AudioBuffer<float>&& result);
+    /// Makes finished the result and tells the listeners
+    void publish(std::shared_ptr<const juce::AudioBuffer<float>> finished);
+
+    juce::CriticalSection jobLock;
+
+    // The job in progress
+    std::unique_ptr<juce::AudioFormatReader> reader;
+    juce::File jobFile;
+    double jobRate = 0.0;
+    double jobRatio = 1.0; // File rate / playback rate
+    juce::AudioBuffer<float> decoded;
+    juce::int64 decodedLength = 0;
+    std::unique_ptr<juce::AudioBuffer<float>> resampled;
+    juce::OwnedArray<juce::LagrangeInterpolator> interpolators;
+    int resampledLength = 0;
+    int resampledDone = 0;
+    int inputUsed = 0;
+    std::atomic<bool> loading{false};
+    std::atomic<float> progress{0.0f};
+
+    // The last finished job
+    juce::CriticalSection resultLock;
+    std::shared_ptr<const juce::AudioBuffer<float>> audio;
+    juce::File audioFile;
+    double audioRate = 0.0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioPreloader)
+};
+
+//==============================================================================
+/**
+    Plays a preloaded buffer: a pointer walk with no disk access or sample
+    rate conversion on the audio thread.
+
+    Positions are in samples of the buffer, so seeks are exact, and looping
+    wraps inside the block at the last sample. Mono audio is copied to every
+    output channel.
+*/
+class PreloadedAudioSource : public juce::PositionableAudioSource
+{
+  public:
+    explicit PreloadedAudioSource(std::shared_ptr<const juce::AudioBuffer<float>> audio);
+
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override {}
+    void releaseResources() override {}
+    void getNextAudioBlock(const juce::AudioSourceChannelInfo& info) override;
+
+    void setNextReadPosition(juce::int64 newPosition) override;
+    juce::int64 getNextReadPosition() const override;
+    juce::int64 getTotalLength() const override { return audio->getNumSamples(); }
+    bool isLooping() const override { return looping.load(std::memory_order_relaxed); }
+    void setLooping(bool shouldLoop) override { looping.store(shouldLoop, std::memory_order_relaxed); }
+
+  private:
+    std::shared_ptr<const juce::AudioBuffer<float>> audio;
+    std::atomic<juce::int64> position{0};
+    std::atomic<bool> looping{false};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PreloadedAudioSource)
+};
@@ -0,0 +1,144 @@
+/*
+  ==============================================================================
+
+    ReadAheadSource.cpp
+    Disk read-ahead on the DiskIOScheduler read queue, reporting its headroom
+
+  ==============================================================================
+*/
+
+#include "ReadAheadSource.h"
+
+//==============================================================================
+/**
+    Sits between the BufferingAudioSource and the file, on the read thread,
+    and records the run of positions read since the last seek. Positions
+    are as the buffer asks for them, so they keep counting up through loops.
+*/
+class ReadAheadSource::Tap : public juce::PositionableAudioSource
+{
+  public:
+    explicit Tap(juce::PositionableAudioSource* sourceToUse) : source(sourceToUse) {}
+
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override
+    {
+        source->prepareToPlay(samplesPerBlockExpected, sampleRate);
+    }
+
+    void releaseResources() override { source->releaseResources(); }
+
+    void getNextAudioBlock(const juce::AudioSourceChannelInfo& info) override
+    {
+        source->getNextAudioBlock(info);
+        runEnd.fetch_add(info.numSamples, std::memory_order_release);
+    }
+
+    void setNextReadPosition(juce::int64 newPosition) override
+    {
+        source->setNextReadPosition(newPosition);
+
+        // Anything else starts a new run
+        if (newPosition != runEnd.load(std::memory_order_relaxed))
+        {
+            runEnd.store(newPosition, std::memory_order_release);
+            runStart.store(newPosition, std::memory_order_release);
+        }
+    }
+
+    juce::int64 getNextReadPosition() const override { return source->getNextReadPosition(); }
+    juce::int64 getTotalLength() const override { return source->getTotalLength(); }
+    bool isLooping() const override { return source->isLooping(); }
+    void setLooping(bool shouldLoop) override { source->setLooping(shouldLoop); }
+
+    std::atomic<juce::int64> runStart{0};
+    std::atomic<juce::int64> runEnd{0};
+
+  private:
+    juce::PositionableAudioSource* source;
+};
+
+//==============================================================================
+ReadAheadSource::ReadAheadSource(juce::PositionableAudioSource* source, int size, int numChannels)
+    : bufferSize(juce::jmax(1, size)), tap(std::make_unique<Tap>(source))
+{
+    auto& scheduler = DiskIOScheduler::getInstance();
+    buffer = std::make_unique<juce::BufferingAudioSource>(
+        tap.get(), scheduler.getThread(DiskIOScheduler::Queue::Read), false, bufferSize, numChannels);
+    scheduler.addStream(DiskIOScheduler::Queue::Read, this);
+}
+
+ReadAheadSource::~ReadAheadSource()
+{
+    DiskIOScheduler::getInstance().removeStream(this);
+
+    // Takes the buffer off the read thread before the tap goes
+    buffer.reset();
+}
+
+//==============================================================================
+void ReadAheadSource::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
+{
+    buffer->prepareToPlay(samplesPerBlockExpected, sampleRate);
+}
+
+void ReadAheadSource::releaseResources()
+{
+    buffer->releaseResources();
+}
+
+void ReadAheadSource::getNextAudioBlock(const juce::AudioSourceChannelInfo& info)
+{
+    // Running off the end of a file that doesn't loop isn't a dropout
+    const bool atEnd = !isLooping() && getNextReadPosition() + info.numSamples >= getTotalLength();
+    if (!atEnd && getSamplesReadAhead() < info.numSamples)
+        DiskIOScheduler::getInstance().reportUnderrun(DiskIOScheduler::Queue::Read);
+
+    buffer->getNextAudioBlock(info);
+}
+
+//==============================================================================
+void ReadAheadSource::setNextReadPosition(juce::int64 newPosition)
+{
+    buffer->setNextReadPosition(newPosition);
+}
+
+juce::int64 ReadAheadSource::getNextReadPosition() const
+{
+    return buffer->getNextReadPosition();
+}
+
+juce::int64 ReadAheadSource::getTotalLength() const
+{
+    return buffer->getTotalLength();
+}
+
+bool ReadAheadSource::isLooping() const
+{
+    return buffer->isLooping();
+}
+
+void ReadAheadSource::setLooping(bool shouldLoop)
+{
+    // The buffer asks the source
+    tap->setLooping(shouldLoop);
+}
+
+//==============================================================================
+float ReadAheadSource::getHeadroom() const
+{
+    return juce::jlimit(0.0f, 1.0f, static_cast<float>(getSamplesReadAhead()) / static_cast<float>(bufferSize));
+}
+
+juce::int64 ReadAheadSource::getSamplesReadAhead() const
+{
+    const juce::int64 end = tap->runEnd.load(std::memory_order_acquire);
+    const juce::int64 start = tap->runStart.load(std::memory_order_acquire);
+    juce::int64 position = buffer->getNextReadPosition();
+
+    // A looping play position wraps, while the run keeps counting; find the lap it's on
+    const juce::int64 length = getTotalLength();
+    if (isLooping() && length > 0 && position < start)
+        position += (start - position + length - 1) / length * length;
+
+    return (position >= start && position <= end) ? end - position : 0;
+}
@@ -0,0 +1,68 @@
+/*
+  ==============================================================================
+
+    ReadAheadSource.h
+    Disk read-ahead on the DiskIOScheduler read queue, reporting its headroom
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "DiskIOScheduler.h"
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+#include <atomic>
+#include <memory>
+
+//==============================================================================
+/**
+    A BufferingAudioSource on the DiskIOScheduler's read thread that
+    registers itself as a Read-queue stream.
+
+    BufferingAudioSource doesn't say how full it is, so the source it reads
+    from is wrapped in a tap that records the run of samples read so far.
+    The headroom is how much of the buffer lies between the audio thread's
+    read position and the end of that run. A stream that's running dry
+    therefore pauses thumbnail work like a recording that's falling behind
+    does. A block the audio thread asks for before it's been read is
+    counted as a Read-queue underrun (BufferingAudioSource plays silence
+    for it).
+
+    Use it in place of AudioTransportSource's own read-ahead: pass it to
+    setSource() with a readAheadSize of 0.
+*/
+class ReadAheadSource : public juce::PositionableAudioSource, public DiskIOScheduler::Stream
+{
+  public:
+    /// Doesn't take ownership of source. bufferSize is in samples per channel.
+    ReadAheadSource(juce::PositionableAudioSource* source, int bufferSize, int numChannels = 2);
+    ~ReadAheadSource() override;
+
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+    void releaseResources() override;
+    /// Audio thread; counts an underrun if the block hasn't been read yet
+    void getNextAudioBlock(const juce::AudioSourceChannelInfo& info) override;
+
+    void setNextReadPosition(juce::int64 newPosition) override;
+    juce::int64 getNextReadPosition() const override;
+    juce::int64 getTotalLength() const override;
+    bool isLooping() const override;
+    void setLooping(bool shouldLoop) override;
+
+    /// Fraction of the buffer read ahead of the play position
+    float getHeadroom() const override;
+
+  private:
+    class Tap;
+
+    /// Samples read ahead of the play position (0 if it's outside the run read so far)
+    juce::int64 getSamplesReadAhead() const;
+
+    const int bufferSize;
+    std::unique_ptr<Tap> tap;
+    std::unique_ptr<juce::BufferingAudioSource> buffer;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ReadAheadSource)
+};
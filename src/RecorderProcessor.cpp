@@ -25,6 +25,11 @@
 
 #include <spdlog/spdlog.h>
 
+namespace
+{
+/// Write-behind buffer, in samples (about 1.4 s at 48 kHz).
+constexpr int writeBufferSize = 65536;
+} // namespace
 
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
@@ -103,8 +108,8 @@ void RecorderProcessor::setFile(const File& phil)
         }
         else
         {
-            threadWriter = new AudioFormatWriter::ThreadedWriter(
-                writer, AudioThumbnailCacheSingleton::getInstance().getTimeSliceThread(), 16384);
+            // Runs on the disk write queue, so thumbnail work can't starve it.
+            threadWriter = new DiskWriter(writer, writeBufferSize);
             threadWriter->setDataReceiver(&thumbnail);
         }
     }
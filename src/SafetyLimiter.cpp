@@ -18,7 +18,7 @@ SafetyLimiterProcessor::SafetyLimiterProcessor()
 {
 }
 
-void SafetyLimiterProcessor::prepareToPlay(double sampleRate, int /*samplesPerBlock*/)
+void SafetyLimiterProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
     currentSampleRate = sampleRate;
 
@@ -27,20 +27,36 @@ void SafetyLimiterProcessor::prepareToPlay(double sampleRate, int /*samplesPerBl
     dcOffsetHoldSamples = static_cast<int>(sampleRate * 0.5);      // 500ms
     ultrasonicHoldSamples = static_cast<int>(sampleRate * 0.2);    // 200ms
 
-    // Release coefficient for ~50ms release time
-    releaseCoeff = std::exp(-1.0f / static_cast<float>(sampleRate * 0.05));
+    // DC tracker at ~5Hz
+    dcCoeff = 1.0f - std::exp(-MathConstants<float>::twoPi * 5.0f / static_cast<float>(sampleRate));
+
+    // Ultrasonic band: 18kHz up, or the top of the band at low sample rates
+    const auto hfCoefficients =
+        IIRCoefficients::makeHighPass(sampleRate, jmin(ultrasonicCutoffHz, sampleRate * 0.4));
+    for (auto& channelFilters : ultrasonicFilters)
+    {
+        for (auto& filter : channelFilters)
+        {
+            filter.setCoefficients(hfCoefficients);
+            filter.reset();
+        }
+    }
+    ultrasonicScratch.assign(static_cast<size_t>(jmax(1, samplesPerBlock)), 0.0f);
+
+    limiter.setThreshold(softLimitThreshold);
+    limiter.prepare(sampleRate, samplesPerBlock);
+    setLatencySamples(limiter.getLatencySamples());
 
     // Output meter decay: ~300ms from peak to -60dB
     double samplesFor300ms = sampleRate * 0.3;
     outputDecayCoeff = static_cast<float>(std::pow(0.001, 1.0 / samplesFor300ms));
 
     // Reset state
-    currentGain = 1.0f;
     dangerousGainCounter = 0;
     dcOffsetCounter = 0;
     ultrasonicCounter = 0;
     ultrasonicEnergy = 0.0f;
-    dcBlockerState[0] = dcBlockerState[1] = 0.0f;
+    dcEstimate[0] = dcEstimate[1] = 0.0f;
     outputLevels[0].store(0.0f, std::memory_order_relaxed);
     outputLevels[1].store(0.0f, std::memory_order_relaxed);
     inputLevels[0].store(0.0f, std::memory_order_relaxed);
@@ -65,6 +81,8 @@ void SafetyLimiterProcessor::releaseResources()
 
 void SafetyLimiterProcessor::processBlock(AudioBuffer<float>& buffer, MidiBuffer& /*midiMessages*/)
 {
+    const DspLoadMeter::ScopedMeasurement measurement(loadMeter, buffer.getNumSamples());
+
     // If muted, output silence
     if (muted.load())
     {
@@ -72,120 +90,120 @@ void SafetyLimiterProcessor::processBlock(AudioBuffer<float>& buffer, MidiBuffer
         return;
     }
 
-    const int numChannels = buffer.getNumChannels();
+    const int numChannels = jmin(buffer.getNumChannels(), 2);
     const int numSamples = buffer.getNumSamples();
+    float* const* channels = buffer.getArrayOfWritePointers();
 
-    bool limitingThisBlock = false;
-    bool dangerousDetected = false;
-    bool dcDetected = false;
+    // Every check runs so all three counters stay current, then any of them can mute
+    const bool dangerous = detectDangerousLevel(channels, numChannels, numSamples);
+    const bool dcOffset = detectDcOffset(channels, numChannels, numSamples);
+    const bool ultrasonic = detectUltrasonic(channels, numChannels, numSamples);
 
-    for (int sample = 0; sample < numSamples; ++sample)
+    if (dangerous || dcOffset || ultrasonic)
     {
-        float maxPeak = 0.0f;
-        float dcSum = 0.0f;
+        muted.store(true);
+        muteTriggered.store(true);
+        buffer.clear();
 
-        // Process each channel
-        for (int ch = 0; ch < jmin(numChannels, 2); ++ch)
-        {
-            float* channelData = buffer.getWritePointer(ch);
-            float inputSample = channelData[sample];
-
-            // DC Blocker (high-pass filter)
-            float dcBlockedSample = inputSample - dcBlockerState[ch] + dcBlockerCoeff * dcBlockerState[ch];
-            dcBlockerState[ch] = inputSample;
-
-            // Track DC offset (before blocking)
-            dcSum += std::abs(inputSample - dcBlockedSample);
-
-            // Use DC-blocked signal
-            inputSample = dcBlockedSample;
-
-            // Track peak for limiting/danger detection
-            float absSample = std::abs(inputSample);
-            maxPeak = jmax(maxPeak, absSample);
-
-            // Simple ultrasonic detection (track high-frequency energy)
-            // This is a rough approximation - we detect large sample-to-sample changes
-            if (sample > 0)
-            {
-                float prevSample = channelData[sample - 1];
-                float delta = std::abs(inputSample - prevSample);
-                ultrasonicEnergy = ultrasonicEnergy * ultrasonicDecay + delta * delta;
-            }
-
-            // Apply limiting
-            float outputSample = inputSample;
-
-            if (absSample > softLimitThreshold)
-            {
-                // Soft knee limiting
-                float excess = absSample - softLimitThreshold;
-                float reduction = excess / (1.0f + excess);
-                float targetGain = (softLimitThreshold + reduction) / absSample;
-                currentGain = jmin(currentGain, targetGain);
-                limitingThisBlock = true;
-            }
-            else
-            {
-                // Release gain back to 1.0
-                currentGain = currentGain * releaseCoeff + (1.0f - releaseCoeff);
-            }
+        // Nothing from before the mute may come out of the look-ahead after Panic
+        limiter.reset();
+        dangerousGainCounter = dcOffsetCounter = ultrasonicCounter = 0;
+        return;
+    }
 
-            outputSample = inputSample * currentGain;
+    const float lowestGain = limiter.process(channels, numChannels, numSamples);
+    limiting.store(lowestGain < 0.999f);
 
-            // Final hard clip at 1.0 (safety net)
-            outputSample = jlimit(-1.0f, 1.0f, outputSample);
+    // Final hard clip at 1.0 (safety net)
+    for (int ch = 0; ch < numChannels; ++ch)
+        FloatVectorOperations::clip(channels[ch], channels[ch], -1.0f, 1.0f, numSamples);
 
-            channelData[sample] = outputSample;
-        }
+    // Note: Output level metering for the Audio Output VU is handled by
+    // MeteringProcessorPlayer::audioDeviceIOCallbackWithContext, which taps
+    // the real device output buffers after graph processing completes.
+}
 
-        // Check for dangerous conditions
-        if (maxPeak > dangerousGainThreshold)
-        {
-            dangerousGainCounter++;
-            dangerousDetected = true;
-        }
-        else
-        {
-            dangerousGainCounter = jmax(0, dangerousGainCounter - 1);
-        }
+//------------------------------------------------------------------------------
+bool SafetyLimiterProcessor::detectDangerousLevel(const float* const* channels, int numChannels, int numSamples)
+{
+    // Samples over the threshold on the worst channel count up, the rest count down
+    int dangerousSamples = 0;
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        const float* data = channels[ch];
+        int count = 0;
+        for (int i = 0; i < numSamples; ++i)
+            count += std::abs(data[i]) > dangerousGainThreshold ? 1 : 0;
+        dangerousSamples = jmax(dangerousSamples, count);
+    }
 
-        if ((dcSum / numChannels) > dcOffsetThreshold)
-        {
-            dcOffsetCounter++;
-            dcDetected = true;
-        }
-        else
-        {
-            dcOffsetCounter = jmax(0, dcOffsetCounter - 1);
-        }
+    dangerousGainCounter = jmax(0, dangerousGainCounter + 2 * dangerousSamples - numSamples);
+    return dangerousGainCounter > dangerousGainHoldSamples;
+}
 
-        // Check ultrasonic (threshold is empirical)
-        if (ultrasonicEnergy > 0.1f)
-        {
-            ultrasonicCounter++;
-        }
-        else
+bool SafetyLimiterProcessor::detectDcOffset(float* const* channels, int numChannels, int numSamples)
+{
+    // Removes the offset in place; the tracked offset itself is what's checked
+    float offset = 0.0f;
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        float* data = channels[ch];
+        float estimate = dcEstimate[ch];
+        for (int i = 0; i < numSamples; ++i)
         {
-            ultrasonicCounter = jmax(0, ultrasonicCounter - 1);
+            estimate += dcCoeff * (data[i] - estimate);
+            data[i] -= estimate;
         }
+        dcEstimate[ch] = estimate;
+        offset = jmax(offset, std::abs(estimate));
+    }
+
+    if (offset > dcOffsetThreshold)
+        dcOffsetCounter += numSamples;
+    else
+        dcOffsetCounter = jmax(0, dcOffsetCounter - numSamples);
+    return dcOffsetCounter > dcOffsetHoldSamples;
+}
 
-        // Trigger auto-mute if any threshold exceeded
-        if (dangerousGainCounter > dangerousGainHoldSamples || dcOffsetCounter > dcOffsetHoldSamples ||
-            ultrasonicCounter > ultrasonicHoldSamples)
+bool SafetyLimiterProcessor::detectUltrasonic(const float* const* channels, int numChannels, int numSamples)
+{
+    const int scratchSize = static_cast<int>(ultrasonicScratch.size());
+    float* scratch = ultrasonicScratch.data();
+
+    // Mean square above the cutoff, on the loudest channel
+    double highestSum = 0.0;
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        double sum = 0.0;
+        for (int done = 0; done < numSamples; done += scratchSize)
         {
-            muted.store(true);
-            muteTriggered.store(true);
-            buffer.clear();
-            return;
+            const int count = jmin(scratchSize, numSamples - done);
+            FloatVectorOperations::copy(scratch, channels[ch] + done, count);
+            for (auto& filter : ultrasonicFilters[ch])
+                filter.processSamples(scratch, count);
+            FloatVectorOperations::multiply(scratch, scratch, count);
+
+            float chunkSum = 0.0f;
+            for (int i = 0; i < count; ++i)
+                chunkSum += scratch[i];
+            sum += chunkSum;
         }
+        highestSum = jmax(highestSum, sum);
     }
 
-    limiting.store(limitingThisBlock);
+    if (numSamples > 0)
+    {
+        // ~20ms smoothing, applied once per block
+        const auto blockCoeff = static_cast<float>(std::exp(-numSamples / (currentSampleRate * 0.02)));
+        const auto meanSquare = static_cast<float>(highestSum / numSamples);
+        ultrasonicEnergy = meanSquare + blockCoeff * (ultrasonicEnergy - meanSquare);
+    }
 
-    // Note: Output level metering for the Audio Output VU is handled by
-    // MeteringProcessorPlayer::audioDeviceIOCallbackWithContext, which taps
-    // the real device output buffers after graph processing completes.
+    if (ultrasonicEnergy > ultrasonicThreshold * ultrasonicThreshold)
+        ultrasonicCounter += numSamples;
+    else
+        ultrasonicCounter = jmax(0, ultrasonicCounter - numSamples);
+    return ultrasonicCounter > ultrasonicHoldSamples;
 }
 
 void SafetyLimiterProcessor::updateOutputLevelsFromDevice(const float* const* outputData, int numChannels,
@@ -10,6 +10,8 @@
 #ifndef SAFETYLIMITER_H_INCLUDED
 #define SAFETYLIMITER_H_INCLUDED
 
+#include "DspProfiler.h"
+#include "TruePeakLimiter.h"
 #include "VuMeterDsp.h"
 
 #include <JuceHeader.h>
@@ -20,11 +22,14 @@
     SafetyLimiterProcessor
 
     Final output protection that:
-    - Soft-limits peaks above -0.5 dBFS
+    - Soft-limits true peaks above -0.5 dBFS, with 1ms look-ahead (see TruePeakLimiter)
     - Auto-mutes on sustained dangerous levels (+6 dBFS for 100ms)
     - Auto-mutes on DC offset (>0.5 for 500ms)
-    - Auto-mutes on sustained ultrasonic content (>18kHz)
+    - Auto-mutes on sustained ultrasonic content (>18kHz for 200ms)
     - Requires manual unmute via Panic command
+
+    Works a block at a time: detection per channel over the whole block, then
+    the limiter, then a hard clip at full scale as the last resort.
 */
 class SafetyLimiterProcessor : public AudioProcessor
 {
@@ -41,7 +46,7 @@ class SafetyLimiterProcessor : public AudioProcessor
     const String getName() const override { return "SafetyLimiter"; }
     bool acceptsMidi() const override { return false; }
     bool producesMidi() const override { return false; }
-    double getTailLengthSeconds() const override { return 0.0; }
+    double getTailLengthSeconds() const override { return TruePeakLimiter::lookAheadSeconds; }
 
     int getNumPrograms() override { return 1; }
     int getCurrentProgram() override { return 0; }
@@ -118,6 +123,13 @@ class SafetyLimiterProcessor : public AudioProcessor
     static constexpr float softLimitThreshold = 0.944f;   // -0.5 dBFS
     static constexpr float dangerousGainThreshold = 2.0f; // +6 dBFS
     static constexpr float dcOffsetThreshold = 0.5f;
+    static constexpr float ultrasonicThreshold = 0.15f; // RMS above 18kHz
+    static constexpr double ultrasonicCutoffHz = 18000.0;
+
+    /// Block-rate checks; each returns true if its condition has lasted long enough to mute
+    bool detectDangerousLevel(const float* const* channels, int numChannels, int numSamples);
+    bool detectDcOffset(float* const* channels, int numChannels, int numSamples);
+    bool detectUltrasonic(const float* const* channels, int numChannels, int numSamples);
 
     // Timing (in samples, set in prepareToPlay)
     int dangerousGainHoldSamples = 0; // 100ms
@@ -130,22 +142,23 @@ class SafetyLimiterProcessor : public AudioProcessor
     std::atomic<bool> muteTriggered{false};
     std::atomic<bool> audioActive{false}; // Set when audio is flowing
 
-    // Detection counters
+    // Detection counters, in samples
     int dangerousGainCounter = 0;
     int dcOffsetCounter = 0;
     int ultrasonicCounter = 0;
 
-    // DC blocker state (per channel)
-    float dcBlockerState[2] = {0.0f, 0.0f};
-    float dcBlockerCoeff = 0.995f;
+    // DC blocker: a ~5Hz one-pole lowpass per channel tracks the offset, which is subtracted
+    float dcEstimate[2] = {0.0f, 0.0f};
+    float dcCoeff = 0.0f;
 
-    // Ultrasonic detection (simple high-pass energy tracker)
+    // Ultrasonic detection: two cascaded 18kHz highpasses per channel, mean square smoothed at block rate
+    IIRFilter ultrasonicFilters[2][2];
+    std::vector<float> ultrasonicScratch;
     float ultrasonicEnergy = 0.0f;
-    float ultrasonicDecay = 0.99f;
 
-    // Limiter state
-    float currentGain = 1.0f;
-    float releaseCoeff = 0.0f; // Calculated in prepareToPlay
+    TruePeakLimiter limiter;
+
+    DspLoadMeter loadMeter{*this};
 
     double currentSampleRate = 44100.0;
 
@@ -0,0 +1,171 @@
+/*
+  ==============================================================================
+
+    ScopeCapture.cpp
+    Triggered, triple-buffered waveform capture for the oscilloscope
+
+  ==============================================================================
+*/
+
+#include "ScopeCapture.h"
+
+#include <cmath>
+
+namespace
+{
+// Pitch sync's low-pass sits this far above the tracked fundamental
+constexpr float cutoffRatio = 1.5f;
+constexpr float initialCutoff = 200.0f;
+constexpr float minCutoff = 30.0f;
+constexpr float maxCutoff = 2000.0f;
+
+// Crossings further apart than this are gaps in the signal, not periods
+constexpr float lowestFrequency = 20.0f;
+
+float lowPassCoefficient(float cutoff, double sampleRate)
+{
+    return 1.0f - std::exp(-juce::MathConstants<float>::twoPi * cutoff / static_cast<float>(sampleRate));
+}
+} // namespace
+
+//==============================================================================
+void ScopeCapture::prepare(double newSampleRate)
+{
+    sampleRate = newSampleRate;
+
+    for (auto& frame : frames)
+        frame = Frame();
+    writeIndex = 0;
+    latest.store(1, std::memory_order_release);
+    readIndex = 2;
+
+    clock = 0;
+    armed = false;
+    capturing = false;
+    waiting = 0;
+    autoTimeout = static_cast<int>(sampleRate * autoTimeoutSeconds);
+    sequence = 0;
+
+    lowPass1 = 0.0f;
+    lowPass2 = 0.0f;
+    lowPassCoeff = lowPassCoefficient(initialCutoff, sampleRate);
+    lastCrossing = 0;
+    frequency = 0.0f;
+}
+
+void ScopeCapture::setDecimation(int samplesPerPoint)
+{
+    int rounded = 1;
+    while (rounded * 2 <= juce::jmin(samplesPerPoint, maxDecimation))
+        rounded *= 2;
+    decimation.store(rounded, std::memory_order_relaxed);
+}
+
+//==============================================================================
+void ScopeCapture::push(const float* samples, int numSamples)
+{
+    const auto mode = triggerMode.load(std::memory_order_relaxed);
+    const bool pitchSync = mode == TriggerMode::PitchSync;
+    const float level = pitchSync ? 0.0f : triggerLevel.load(std::memory_order_relaxed);
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float sample = samples[i];
+        ++clock;
+
+        // Trigger detection
+        float detected = sample;
+        if (pitchSync)
+        {
+            lowPass1 += lowPassCoeff * (sample - lowPass1);
+            lowPass2 += lowPassCoeff * (lowPass1 - lowPass2);
+            detected = lowPass2;
+        }
+
+        bool crossed = false;
+        if (detected < level - hysteresis)
+        {
+            armed = true;
+        }
+        else if (armed && detected >= level)
+        {
+            armed = false;
+            crossed = true;
+            if (pitchSync)
+                updatePitch();
+        }
+
+        if (!capturing)
+        {
+            if (mode == TriggerMode::FreeRun || crossed)
+                beginFrame(mode != TriggerMode::FreeRun);
+            else if (++waiting >= autoTimeout)
+                beginFrame(false);
+            else
+                continue;
+        }
+
+        // Min/max decimation into the frame being captured
+        pointMin = samplesInPoint == 0 ? sample : juce::jmin(pointMin, sample);
+        pointMax = samplesInPoint == 0 ? sample : juce::jmax(pointMax, sample);
+
+        if (++samplesInPoint == frameDecimation)
+        {
+            auto& frame = frames[static_cast<size_t>(writeIndex)];
+            frame.minimum[static_cast<size_t>(point)] = pointMin;
+            frame.maximum[static_cast<size_t>(point)] = pointMax;
+            samplesInPoint = 0;
+
+            if (++point == frameSize)
+                publishFrame();
+        }
+    }
+}
+
+const ScopeCapture::Frame* ScopeCapture::acquireLatestFrame()
+{
+    if ((latest.load(std::memory_order_acquire) & newFrameBit) == 0)
+        return nullptr;
+
+    readIndex = latest.exchange(readIndex, std::memory_order_acq_rel) & indexMask;
+    return &frames[static_cast<size_t>(readIndex)];
+}
+
+//==============================================================================
+void ScopeCapture::updatePitch()
+{
+    const auto period = clock - lastCrossing;
+    lastCrossing = clock;
+
+    if (period <= 0 || period > static_cast<juce::int64>(sampleRate / lowestFrequency))
+        return;
+
+    // Smoothed, so one odd crossing doesn't throw the filter off
+    const auto measured = static_cast<float>(sampleRate / static_cast<double>(period));
+    frequency = frequency > 0.0f ? 0.8f * frequency + 0.2f * measured : measured;
+
+    lowPassCoeff = lowPassCoefficient(juce::jlimit(minCutoff, maxCutoff, frequency * cutoffRatio), sampleRate);
+}
+
+void ScopeCapture::beginFrame(bool triggered)
+{
+    capturing = true;
+    waiting = 0;
+    point = 0;
+    samplesInPoint = 0;
+    frameDecimation = decimation.load(std::memory_order_relaxed);
+
+    auto& frame = frames[static_cast<size_t>(writeIndex)];
+    frame.decimation = frameDecimation;
+    frame.triggered = triggered;
+}
+
+void ScopeCapture::publishFrame()
+{
+    auto& frame = frames[static_cast<size_t>(writeIndex)];
+    frame.frequency = triggerMode.load(std::memory_order_relaxed) == TriggerMode::PitchSync ? frequency : 0.0f;
+    frame.sequence = ++sequence;
+
+    writeIndex = latest.exchange(writeIndex | newFrameBit, std::memory_order_acq_rel) & indexMask;
+    capturing = false;
+}
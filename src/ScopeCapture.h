@@ -0,0 +1,128 @@
+/*
+  ==============================================================================
+
+    ScopeCapture.h
+    Triggered, triple-buffered waveform capture for the oscilloscope
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+#include <array>
+#include <atomic>
+
+//==============================================================================
+/**
+    Captures whole oscilloscope frames on the audio thread and hands the
+    latest complete one to the UI without locks or torn reads.
+
+    Frames live in three slots: the audio thread fills one, the UI owns
+    another, and the third holds the newest finished frame. Publishing swaps
+    the filled slot with the newest; acquiring swaps the UI's slot with it,
+    so neither side ever waits or copies.
+
+    A frame starts on the trigger: a rising crossing of the trigger level
+    (with hysteresis), or in pitch sync mode, a rising zero crossing of the
+    input low-passed just above its fundamental, so harmonics that cross
+    zero several times a period don't retrigger it. If nothing triggers for
+    autoTimeoutSeconds, a frame is captured anyway so the trace never freezes.
+
+    Each of the frame's points covers `decimation` samples and keeps their
+    minimum and maximum, so longer timebases cost no more to draw or copy.
+*/
+class ScopeCapture
+{
+  public:
+    static constexpr int frameSize = 512; // Points per frame
+    static constexpr int maxDecimation = 32;
+    static constexpr double autoTimeoutSeconds = 0.1;
+    static constexpr float hysteresis = 0.005f;
+
+    enum class TriggerMode
+    {
+        FreeRun,
+        RisingEdge,
+        PitchSync,
+        NumModes
+    };
+
+    struct Frame
+    {
+        std::array<float, frameSize> minimum{};
+        std::array<float, frameSize> maximum{};
+        int decimation = 1;     // Samples per point
+        bool triggered = false; // False if captured on the auto timeout
+        float frequency = 0.0f; // Pitch sync's estimate of the fundamental (Hz), else 0
+        juce::uint32 sequence = 0;
+    };
+
+    ScopeCapture() = default;
+
+    /// Resets the capture. Not while push() can be called.
+    void prepare(double sampleRate);
+
+    /// Audio thread
+    void push(const float* samples, int numSamples);
+
+    /// UI thread (one reader only). Returns the newest complete frame if one
+    /// has been published since the last call, otherwise nullptr. The frame
+    /// stays valid and unchanged until the next call.
+    const Frame* acquireLatestFrame();
+
+    //==========================================================================
+    // Settings (any thread; applied from the next frame)
+
+    void setTriggerMode(TriggerMode mode) { triggerMode.store(mode, std::memory_order_relaxed); }
+    TriggerMode getTriggerMode() const { return triggerMode.load(std::memory_order_relaxed); }
+
+    void setTriggerLevel(float level) { triggerLevel.store(level, std::memory_order_relaxed); }
+    float getTriggerLevel() const { return triggerLevel.load(std::memory_order_relaxed); }
+
+    /// Samples per point, rounded down to a power of two from 1 to maxDecimation
+    void setDecimation(int samplesPerPoint);
+    int getDecimation() const { return decimation.load(std::memory_order_relaxed); }
+
+  private:
+    static constexpr int indexMask = 3;
+    static constexpr int newFrameBit = 4;
+
+    /// Tracks the fundamental from the spacing of pitch sync's crossings
+    void updatePitch();
+    void beginFrame(bool triggered);
+    void publishFrame();
+
+    std::array<Frame, 3> frames;
+    int writeIndex = 0;
+    std::atomic<int> latest{1}; // Slot index, plus newFrameBit once published
+    int readIndex = 2;
+
+    std::atomic<TriggerMode> triggerMode{TriggerMode::RisingEdge};
+    std::atomic<float> triggerLevel{0.0f};
+    std::atomic<int> decimation{1};
+
+    // Audio thread state
+    double sampleRate = 44100.0;
+    juce::int64 clock = 0;
+    bool armed = false;
+    bool capturing = false;
+    int waiting = 0;
+    int autoTimeout = 4410;
+    int frameDecimation = 1;
+    int point = 0;
+    int samplesInPoint = 0;
+    float pointMin = 0.0f;
+    float pointMax = 0.0f;
+    juce::uint32 sequence = 0;
+
+    // Pitch sync's tracking low-pass
+    float lowPass1 = 0.0f;
+    float lowPass2 = 0.0f;
+    float lowPassCoeff = 0.0f;
+    juce::int64 lastCrossing = 0;
+    float frequency = 0.0f;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ScopeCapture)
+};
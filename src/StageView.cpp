@@ -132,6 +132,7 @@ void StageView::timerCallback()
         needleAngle += (targetAngle - needleAngle) * NEEDLE_SMOOTHING;
 
         detectedNote = tunerProcessor->getDetectedNote();
+        numStrings = tunerProcessor->isPolyphonic() ? tunerProcessor->getStringResults(stringResults) : 0;
         needsRepaint = true;
     }
 
@@ -409,6 +410,12 @@ void StageView::drawTunerDisplay(Graphics& g, Rectangle<float> bounds)
     auto centreX = bounds.getCentreX();
     auto centreY = bounds.getCentreY();
 
+    if (numStrings > 0)
+    {
+        drawStringResults(g, bounds);
+        return;
+    }
+
     if (tunerProcessor == nullptr || !tunerProcessor->isPitchDetected())
     {
         g.setColour(colours["Text Colour"].withAlpha(0.25f));
@@ -452,6 +459,46 @@ void StageView::drawTunerDisplay(Graphics& g, Rectangle<float> bounds)
     g.fillEllipse(indicatorX - 8, barY - 2, 16, barHeight + 4);
 }
 
+void StageView::drawStringResults(Graphics& g, Rectangle<float> bounds)
+{
+    auto& fonts = FontManager::getInstance();
+    auto& colours = ColourScheme::getInstance().colours;
+
+    // One column per string: note name, cents, and a short horizontal bar
+    auto area = bounds.reduced(40.0f, 20.0f);
+    const float columnWidth = area.getWidth() / static_cast<float>(numStrings);
+
+    for (int s = 0; s < numStrings; ++s)
+    {
+        const auto& result = stringResults[static_cast<size_t>(s)];
+        auto column = area.withX(area.getX() + s * columnWidth).withWidth(columnWidth).reduced(8.0f, 0.0f);
+        const Colour colour = result.detected ? getTuningColour(result.cents) : colours["Text Colour"].withAlpha(0.25f);
+
+        g.setColour(colour);
+        g.setFont(fonts.getDisplayFont(48.0f));
+        g.drawText(getNoteName(result.midiNote), column.removeFromTop(64), Justification::centred);
+
+        g.setFont(fonts.getMonoDisplayFont(24.0f));
+        const String centsStr =
+            result.detected ? (result.cents >= 0 ? "+" : "") + String(roundToInt(result.cents)) : String("--");
+        g.drawText(centsStr, column.removeFromTop(36), Justification::centred);
+
+        auto bar = column.removeFromTop(12.0f);
+        g.setColour(colours["Plugin Border"].darker(0.3f));
+        g.fillRoundedRectangle(bar, 6.0f);
+        g.setColour(colours["Text Colour"].withAlpha(0.5f));
+        g.fillRect(bar.getCentreX() - 1.5f, bar.getY() - 4, 3.0f, bar.getHeight() + 8);
+
+        if (result.detected)
+        {
+            const float position = jlimit(-1.0f, 1.0f, result.cents / 50.0f);
+            const float x = bar.getCentreX() + position * (bar.getWidth() / 2 - 8);
+            g.setColour(colour);
+            g.fillEllipse(x - 8, bar.getY() - 2, 16, bar.getHeight() + 4);
+        }
+    }
+}
+
 //==============================================================================
 void StageView::resized()
 {
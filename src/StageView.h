@@ -11,6 +11,7 @@
 #pragma once
 
 #include "JuceHeader.h"
+#include "StrumAnalyser.h"
 
 class MainPanel;
 class TunerProcessor;
@@ -67,6 +68,10 @@ class StageView : public Component, public Button::Listener, public Slider::List
     int detectedNote = -1;
     bool showTuner = true;
 
+    // Polyphonic tuner results (when the tuner is in strum mode)
+    StrumAnalyser::Results stringResults;
+    int numStrings = 0;
+
     // UI Components
     std::unique_ptr<TextButton> prevButton;
     std::unique_ptr<TextButton> nextButton;
@@ -93,6 +98,7 @@ class StageView : public Component, public Button::Listener, public Slider::List
     // Drawing helpers
     void drawPatchDisplay(Graphics& g, Rectangle<float> bounds);
     void drawTunerDisplay(Graphics& g, Rectangle<float> bounds);
+    void drawStringResults(Graphics& g, Rectangle<float> bounds);
     void drawStatusBar(Graphics& g, Rectangle<float> bounds);
     String getNoteName(int midiNote) const;
     Colour getTuningColour(float cents) const;
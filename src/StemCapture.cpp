@@ -0,0 +1,293 @@
+/*
+  ==============================================================================
+
+    StemCapture.cpp
+    Multichannel capture engine with an always-on pre-roll ring buffer
+
+  ==============================================================================
+*/
+
+#include "StemCapture.h"
+
+#include <spdlog/spdlog.h>
+
+namespace
+{
+constexpr int drainBlockSize = 16384; // Samples per channel per write-thread slice
+constexpr int idleWaitMs = 10;
+} // namespace
+
+//==============================================================================
+StemCapture::StemCapture() = default;
+
+StemCapture::~StemCapture()
+{
+    if (registered)
+    {
+        auto& scheduler = DiskIOScheduler::getInstance();
+        scheduler.getThread(DiskIOScheduler::Queue::Write).removeTimeSliceClient(this);
+        scheduler.removeStream(this);
+    }
+
+    const juce::ScopedLock sl(writerLock);
+    if (isRecording())
+        stop();
+    finish();
+}
+
+//==============================================================================
+void StemCapture::prepare(double newSampleRate, int newNumChannels, double preRollSeconds, double writeBehindSeconds)
+{
+    // Joins the write queue on first use, so processors that are only created
+    // (e.g. to list them) never start the scheduler's threads
+    if (!registered)
+    {
+        auto& scheduler = DiskIOScheduler::getInstance();
+        scheduler.addStream(DiskIOScheduler::Queue::Write, this);
+        scheduler.getThread(DiskIOScheduler::Queue::Write).addTimeSliceClient(this);
+        registered = true;
+    }
+
+    const juce::ScopedLock sl(writerLock);
+
+    // Whatever's in the ring belongs to the old configuration, so write it out first
+    if (isRecording())
+        stop();
+    finish();
+
+    sampleRate = newSampleRate > 0.0 ? newSampleRate : 44100.0;
+    numChannels = juce::jmax(0, newNumChannels);
+    preRollSamples = juce::roundToInt(juce::jlimit(0.0, maxPreRollSeconds, preRollSeconds) * sampleRate);
+    capacity = preRollSamples + juce::jmax(1, juce::roundToInt(writeBehindSeconds * sampleRate));
+
+    ring.setSize(numChannels, capacity);
+    ring.clear();
+    channelPointers.assign(static_cast<size_t>(numChannels), nullptr);
+
+    writePos.store(0, std::memory_order_release);
+    readPos.store(0, std::memory_order_release);
+}
+
+void StemCapture::push(const float* const* channels, int numInputChannels, int numSamples)
+{
+    if (numSamples <= 0 || capacity <= 0)
+        return;
+
+    const auto pos = writePos.load(std::memory_order_relaxed);
+    const auto current = state.load(std::memory_order_acquire);
+
+    if (current != State::Idle)
+    {
+        // Would overwrite audio the write thread hasn't got to yet
+        const auto unread = pos - readPos.load(std::memory_order_acquire);
+        if (unread + numSamples > capacity)
+        {
+            if (current == State::Recording)
+            {
+                overruns.fetch_add(1, std::memory_order_relaxed);
+                DiskIOScheduler::getInstance().reportOverrun(DiskIOScheduler::Queue::Write);
+            }
+            return;
+        }
+    }
+
+    // Only the newest capacity samples of an oversized block can survive
+    const int skip = juce::jmax(0, numSamples - capacity);
+    const int count = numSamples - skip;
+    const int start = static_cast<int>((pos + skip) % capacity);
+    const int size1 = juce::jmin(count, capacity - start);
+    const int size2 = count - size1;
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        const float* source = channel < numInputChannels ? channels[channel] : nullptr;
+        if (source != nullptr)
+        {
+            ring.copyFrom(channel, start, source + skip, size1);
+            if (size2 > 0)
+                ring.copyFrom(channel, 0, source + skip + size1, size2);
+        }
+        else
+        {
+            ring.clear(channel, start, size1);
+            if (size2 > 0)
+                ring.clear(channel, 0, size2);
+        }
+    }
+
+    writePos.store(pos + numSamples, std::memory_order_release);
+}
+
+//==============================================================================
+bool StemCapture::start(const juce::File& folder, const juce::String& baseName, Format format, int bitsPerSample)
+{
+    if (isRecording() || numChannels == 0)
+        return false;
+
+    const juce::ScopedLock sl(writerLock);
+    closeWriters();
+    files.clear();
+
+    if (folder.createDirectory().failed())
+    {
+        spdlog::warn("[StemCapture] Could not create {}", folder.getFullPathName().toStdString());
+        return false;
+    }
+
+    juce::WavAudioFormat wav;
+    auto open = [&](const juce::File& file, int channelsInFile)
+    {
+        auto* stream = new juce::FileOutputStream(file);
+        if (stream->failedToOpen())
+        {
+            delete stream;
+            return false;
+        }
+
+        auto* writer = wav.createWriterFor(stream, sampleRate, static_cast<unsigned int>(channelsInFile),
+                                           bitsPerSample, {}, 0);
+        if (writer == nullptr)
+        {
+            delete stream;
+            return false;
+        }
+
+        writers.emplace_back(writer);
+        files.add(file);
+        return true;
+    };
+
+    bool opened = true;
+    if (format == Format::Polyphonic)
+    {
+        opened = open(folder.getNonexistentChildFile(baseName, ".wav", false), numChannels);
+    }
+    else
+    {
+        for (int first = 0; opened && first < numChannels; first += 2)
+        {
+            const auto name = baseName + " Stem " + juce::String(first / 2 + 1).paddedLeft('0', 2);
+            opened = open(folder.getNonexistentChildFile(name, ".wav", false), juce::jmin(2, numChannels - first));
+        }
+    }
+
+    if (!opened)
+    {
+        spdlog::warn("[StemCapture] Could not create output files in {}", folder.getFullPathName().toStdString());
+        closeWriters();
+        for (const auto& file : files)
+            file.deleteFile();
+        files.clear();
+        return false;
+    }
+
+    samplesWritten.store(0, std::memory_order_relaxed);
+    overruns.store(0, std::memory_order_relaxed);
+
+    // Rewind into the pre-roll; the audio thread stays well clear of it
+    const auto pos = writePos.load(std::memory_order_acquire);
+    readPos.store(juce::jmax<juce::int64>(0, pos - preRollSamples), std::memory_order_release);
+    state.store(State::Recording, std::memory_order_release);
+
+    spdlog::info("[StemCapture] Recording {} channels to {} file(s), {:.1f} s pre-roll", numChannels,
+                 files.size(), static_cast<double>(pos - readPos.load()) / sampleRate);
+    return true;
+}
+
+void StemCapture::stop()
+{
+    if (state.load(std::memory_order_acquire) != State::Recording)
+        return;
+
+    stopPos.store(writePos.load(std::memory_order_acquire), std::memory_order_release);
+    state.store(State::Stopping, std::memory_order_release);
+}
+
+juce::Array<juce::File> StemCapture::getFiles() const
+{
+    return files;
+}
+
+float StemCapture::getHeadroom() const
+{
+    if (!isRecording() || capacity <= 0)
+        return 1.0f;
+
+    const auto unread = writePos.load(std::memory_order_relaxed) - readPos.load(std::memory_order_relaxed);
+    return 1.0f - static_cast<float>(unread) / static_cast<float>(capacity);
+}
+
+//==============================================================================
+int StemCapture::useTimeSlice()
+{
+    const juce::ScopedLock sl(writerLock);
+
+    switch (state.load(std::memory_order_acquire))
+    {
+    case State::Recording:
+        return writePending(drainBlockSize) > 0 ? 0 : idleWaitMs;
+    case State::Stopping:
+        finish();
+        return idleWaitMs;
+    default:
+        return idleWaitMs;
+    }
+}
+
+int StemCapture::writePending(int maxSamples)
+{
+    auto end = writePos.load(std::memory_order_acquire);
+    if (state.load(std::memory_order_acquire) == State::Stopping)
+        end = juce::jmin(end, stopPos.load(std::memory_order_acquire));
+
+    const auto from = readPos.load(std::memory_order_relaxed);
+    const int count = static_cast<int>(juce::jmin<juce::int64>(maxSamples, end - from));
+    if (count <= 0)
+        return 0;
+
+    const int start = static_cast<int>(from % capacity);
+    const int size1 = juce::jmin(count, capacity - start);
+
+    for (auto [offset, length] : {std::make_pair(start, size1), std::make_pair(0, count - size1)})
+    {
+        if (length <= 0)
+            continue;
+
+        int channel = 0;
+        for (auto& writer : writers)
+        {
+            const int channelsInFile = static_cast<int>(writer->getNumChannels());
+            for (int i = 0; i < channelsInFile; ++i)
+                channelPointers[static_cast<size_t>(i)] = ring.getReadPointer(channel + i, offset);
+
+            writer->writeFromFloatArrays(channelPointers.data(), channelsInFile, length);
+            channel += channelsInFile;
+        }
+    }
+
+    readPos.store(from + count, std::memory_order_release);
+    samplesWritten.fetch_add(count, std::memory_order_relaxed);
+    return count;
+}
+
+void StemCapture::finish()
+{
+    if (state.load(std::memory_order_acquire) != State::Stopping)
+        return;
+
+    while (writePending(drainBlockSize) > 0)
+    {
+    }
+
+    closeWriters();
+    state.store(State::Idle, std::memory_order_release);
+
+    spdlog::info("[StemCapture] Recorded {:.1f} s, {} overruns",
+                 static_cast<double>(samplesWritten.load()) / sampleRate, overruns.load());
+}
+
+void StemCapture::closeWriters()
+{
+    // Deleting a writer finalises its header
+    writers.clear();
+}
@@ -0,0 +1,133 @@
+/*
+  ==============================================================================
+
+    StemCapture.h
+    Multichannel capture engine with an always-on pre-roll ring buffer
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "DiskIOScheduler.h"
+
+#include <juce_audio_formats/juce_audio_formats.h>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+//==============================================================================
+/**
+    Records any number of channels to disk through one lock-free ring.
+
+    The audio thread push()es every block into a single multichannel ring,
+    whether or not we're recording, so the ring always holds the last
+    pre-roll's worth of audio. start() rewinds the read position by the
+    pre-roll, and the DiskIOScheduler write thread drains the ring from
+    there into the output file(s); the rest of the ring is the write-behind
+    buffer that absorbs disk stalls. The audio thread never takes a lock or
+    touches a file.
+
+    Channels are written either as one polyphonic file or as one stereo file
+    per pair (stem). While recording, a block that would overwrite audio not
+    yet on disk is dropped and counted as an overrun, as DiskWriter does.
+*/
+class StemCapture : public DiskIOScheduler::Stream, private juce::TimeSliceClient
+{
+  public:
+    enum class Format
+    {
+        Polyphonic, // One WAV with every channel (RF64 once it passes 4 GB)
+        PerStem,    // One stereo WAV per channel pair
+        NumFormats
+    };
+
+    static constexpr double defaultPreRollSeconds = 10.0;
+    static constexpr double defaultWriteBehindSeconds = 5.0;
+    static constexpr double maxPreRollSeconds = 30.0;
+
+    StemCapture();
+    ~StemCapture() override;
+
+    /// Allocates the ring and, the first time, registers with the
+    /// DiskIOScheduler write queue. Finishes any recording in progress. Not
+    /// while push() can be called.
+    void prepare(double sampleRate, int numChannels, double preRollSeconds,
+                 double writeBehindSeconds = defaultWriteBehindSeconds);
+
+    /// Audio thread. Channels past getNumChannels() are ignored; missing ones
+    /// are recorded as silence.
+    void push(const float* const* channels, int numChannels, int numSamples);
+
+    //==========================================================================
+    // Recording (message thread)
+
+    /// Opens the output file(s) in folder and starts draining the ring from
+    /// one pre-roll ago. Returns false if already recording or a file can't
+    /// be created.
+    bool start(const juce::File& folder, const juce::String& baseName, Format format, int bitsPerSample = 24);
+
+    /// Stops at the current position; the write thread finishes the files
+    /// shortly after. isRecording() stays true until they're closed.
+    void stop();
+
+    bool isRecording() const { return state.load(std::memory_order_acquire) != State::Idle; }
+    bool isStopping() const { return state.load(std::memory_order_acquire) == State::Stopping; }
+
+    /// The files of the current (or last) recording
+    juce::Array<juce::File> getFiles() const;
+
+    //==========================================================================
+    // Status (any thread)
+
+    int getNumChannels() const { return numChannels; }
+    double getSampleRate() const { return sampleRate; }
+    double getPreRollSeconds() const { return static_cast<double>(preRollSamples) / sampleRate; }
+
+    /// Samples per channel written to disk since start()
+    juce::int64 getSamplesWritten() const { return samplesWritten.load(std::memory_order_relaxed); }
+    juce::int64 getOverruns() const { return overruns.load(std::memory_order_relaxed); }
+
+    /// Free fraction of the ring while recording
+    float getHeadroom() const override;
+
+  private:
+    enum class State
+    {
+        Idle,
+        Recording,
+        Stopping
+    };
+
+    int useTimeSlice() override;
+    /// Writes up to maxSamples from the ring. Returns the number written.
+    int writePending(int maxSamples);
+    /// Write thread, under writerLock: drains to the stop position and closes
+    void finish();
+    void closeWriters();
+
+    double sampleRate = 44100.0;
+    int numChannels = 0;
+    int capacity = 0;
+    int preRollSamples = 0;
+    juce::AudioBuffer<float> ring;
+
+    // Total samples pushed / drained; ring index is position % capacity
+    std::atomic<juce::int64> writePos{0};
+    std::atomic<juce::int64> readPos{0};
+    std::atomic<juce::int64> stopPos{0};
+    std::atomic<State> state{State::Idle};
+
+    juce::CriticalSection writerLock;
+    std::vector<std::unique_ptr<juce::AudioFormatWriter>> writers;
+    juce::Array<juce::File> files;
+    std::vector<const float*> channelPointers;
+
+    std::atomic<juce::int64> samplesWritten{0};
+    std::atomic<juce::int64> overruns{0};
+
+    bool registered = false; // With the DiskIOScheduler, from the first prepare()
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(StemCapture)
+};
@@ -0,0 +1,179 @@
+/*
+  ==============================================================================
+
+    StemRecorderControl.cpp
+    Record button, take settings and status for StemRecorderProcessor
+
+  ==============================================================================
+*/
+
+#include "StemRecorderControl.h"
+
+#include "ColourScheme.h"
+#include "PluginComponent.h"
+#include "StemRecorderProcessor.h"
+
+namespace
+{
+constexpr int preRollChoices[] = {0, 5, 10, 20, 30}; // Seconds
+} // namespace
+
+//==============================================================================
+StemRecorderControl::StemRecorderControl(StemRecorderProcessor* processor) : stemRecorder(processor)
+{
+    recordButton.setClickingTogglesState(false);
+    recordButton.setTooltip("Start a take, including the pre-roll; click again to stop");
+    recordButton.onClick = [this]()
+    {
+        stemRecorder->toggleRecording();
+        updateSettings();
+    };
+    addAndMakeVisible(recordButton);
+
+    statusLabel.setJustificationType(Justification::centredLeft);
+    addAndMakeVisible(statusLabel);
+
+    for (int stems = 1; stems <= StemRecorderProcessor::MaxStems; ++stems)
+        stemsBox.addItem(String(stems) + (stems == 1 ? " stem" : " stems"), stems);
+    stemsBox.setSelectedId(stemRecorder->getNumStems(), dontSendNotification);
+    stemsBox.onChange = [this]()
+    {
+        stemRecorder->setNumStems(stemsBox.getSelectedId());
+        refreshPins();
+    };
+    addAndMakeVisible(stemsBox);
+
+    formatBox.addItem("Per-stem files", static_cast<int>(StemCapture::Format::PerStem) + 1);
+    formatBox.addItem("Polyphonic file", static_cast<int>(StemCapture::Format::Polyphonic) + 1);
+    formatBox.setSelectedId(static_cast<int>(stemRecorder->getFormat()) + 1, dontSendNotification);
+    formatBox.onChange = [this]()
+    { stemRecorder->setFormat(static_cast<StemCapture::Format>(formatBox.getSelectedId() - 1)); };
+    addAndMakeVisible(formatBox);
+
+    for (int seconds : preRollChoices)
+        preRollBox.addItem(seconds == 0 ? String("No pre-roll") : String(seconds) + " s pre-roll", seconds + 1);
+    preRollBox.setSelectedId(roundToInt(stemRecorder->getPreRollSeconds()) + 1, dontSendNotification);
+    preRollBox.onChange = [this]() { stemRecorder->setPreRollSeconds(preRollBox.getSelectedId() - 1); };
+    addAndMakeVisible(preRollBox);
+
+    folderButton.setTooltip("Folder new takes are written to");
+    folderButton.onClick = [this]() { chooseFolder(); };
+    addAndMakeVisible(folderButton);
+
+    updateSettings();
+    startTimerHz(10);
+
+    setSize(300, 120);
+}
+
+StemRecorderControl::~StemRecorderControl()
+{
+    stopTimer();
+}
+
+//==============================================================================
+void StemRecorderControl::paint(Graphics& g)
+{
+    auto& colours = ColourScheme::getInstance().colours;
+    auto bounds = getLocalBounds().toFloat().reduced(1.0f);
+
+    g.setColour(colours["Plugin Background"]);
+    g.fillRoundedRectangle(bounds, 4.0f);
+
+    g.setColour(colours["Plugin Border"]);
+    g.drawRoundedRectangle(bounds, 4.0f, 1.0f);
+}
+
+void StemRecorderControl::resized()
+{
+    auto r = getLocalBounds().reduced(4);
+
+    auto top = r.removeFromTop(28);
+    recordButton.setBounds(top.removeFromLeft(60));
+    top.removeFromLeft(6);
+    statusLabel.setBounds(top);
+
+    r.removeFromTop(4);
+    auto settings = r.removeFromTop(24);
+    const int third = settings.getWidth() / 3;
+    stemsBox.setBounds(settings.removeFromLeft(third).reduced(1, 0));
+    formatBox.setBounds(settings.removeFromLeft(third).reduced(1, 0));
+    preRollBox.setBounds(settings.reduced(1, 0));
+
+    r.removeFromTop(4);
+    folderButton.setBounds(r.removeFromTop(24));
+}
+
+//==============================================================================
+void StemRecorderControl::timerCallback()
+{
+    const auto& capture = stemRecorder->getCapture();
+    auto& colours = ColourScheme::getInstance().colours;
+
+    if (!capture.isRecording())
+    {
+        statusLabel.setText("Armed, " + String(capture.getPreRollSeconds(), 0) + " s pre-roll", dontSendNotification);
+        statusLabel.setColour(Label::textColourId, colours["Text Colour"]);
+    }
+    else
+    {
+        const double seconds = static_cast<double>(capture.getSamplesWritten()) / capture.getSampleRate();
+        const auto overruns = capture.getOverruns();
+
+        String status = capture.isStopping() ? "Finishing " : "";
+        status << String(static_cast<int>(seconds) / 60).paddedLeft('0', 2) << ":"
+               << String(static_cast<int>(seconds) % 60).paddedLeft('0', 2) << "  buffer "
+               << roundToInt(capture.getHeadroom() * 100.0f) << "%";
+        if (overruns > 0)
+            status << "  " << String(overruns) << " dropped";
+
+        statusLabel.setText(status, dontSendNotification);
+        statusLabel.setColour(Label::textColourId, overruns > 0 ? colours["Danger Colour"] : colours["Text Colour"]);
+    }
+
+    // Settings unlock once the write thread has closed the files
+    if (stemsBox.isEnabled() == capture.isRecording())
+        updateSettings();
+}
+
+void StemRecorderControl::updateSettings()
+{
+    auto& colours = ColourScheme::getInstance().colours;
+    const bool recording = stemRecorder->isRecording();
+
+    recordButton.setButtonText(recording ? "STOP" : "REC");
+    recordButton.setColour(TextButton::buttonColourId, recording ? colours["Danger Colour"] : colours["Button Colour"]);
+
+    // The ring and the inputs can't change under a take
+    stemsBox.setEnabled(!recording);
+    preRollBox.setEnabled(!recording);
+    formatBox.setEnabled(!recording);
+    folderButton.setEnabled(!recording);
+
+    folderButton.setButtonText(stemRecorder->getFolder().getFullPathName());
+}
+
+void StemRecorderControl::chooseFolder()
+{
+    folderChooser = std::make_unique<FileChooser>("Select Stem Folder", stemRecorder->getFolder());
+
+    auto chooserFlags = FileBrowserComponent::openMode | FileBrowserComponent::canSelectDirectories;
+
+    folderChooser->launchAsync(chooserFlags,
+                               [this](const FileChooser& fc)
+                               {
+                                   auto result = fc.getResult();
+                                   if (result != File())
+                                   {
+                                       stemRecorder->setFolder(result);
+                                       updateSettings();
+                                   }
+                               });
+}
+
+void StemRecorderControl::refreshPins()
+{
+    // The PluginComponent that hosts us has to re-read our input count
+    if (auto* pc = findParentComponentOfClass<PluginComponent>())
+        pc->refreshPins();
+}
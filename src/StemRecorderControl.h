@@ -0,0 +1,48 @@
+/*
+  ==============================================================================
+
+    StemRecorderControl.h
+    Record button, take settings and status for StemRecorderProcessor
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include <memory>
+
+class StemRecorderProcessor;
+
+//==============================================================================
+/**
+    Controls for the stem recorder: record/stop, stem count, file layout,
+    pre-roll length and output folder. A timer shows the take length, ring
+    headroom and overruns while recording.
+*/
+class StemRecorderControl : public Component, private Timer
+{
+  public:
+    StemRecorderControl(StemRecorderProcessor* processor);
+    ~StemRecorderControl() override;
+
+    void paint(Graphics& g) override;
+    void resized() override;
+
+  private:
+    void timerCallback() override;
+    void updateSettings();
+    void chooseFolder();
+    void refreshPins();
+
+    StemRecorderProcessor* stemRecorder;
+
+    TextButton recordButton{"REC"};
+    Label statusLabel;
+    ComboBox stemsBox, formatBox, preRollBox;
+    TextButton folderButton;
+    std::unique_ptr<FileChooser> folderChooser;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(StemRecorderControl)
+};
@@ -0,0 +1,154 @@
+/*
+  ==============================================================================
+
+    StemRecorderProcessor.cpp
+    Multitrack stem recorder with an always-on pre-roll
+
+  ==============================================================================
+*/
+
+#include "StemRecorderProcessor.h"
+
+#include "StemRecorderControl.h"
+
+#include <spdlog/spdlog.h>
+
+//==============================================================================
+StemRecorderProcessor::StemRecorderProcessor()
+    : PedalboardProcessor(),
+      folder(File::getSpecialLocation(File::userDocumentsDirectory).getChildFile("Pedalboard3").getChildFile("Stems"))
+{
+    updateChannelConfig();
+}
+
+StemRecorderProcessor::~StemRecorderProcessor()
+{
+}
+
+//==============================================================================
+bool StemRecorderProcessor::toggleRecording()
+{
+    if (capture.isRecording())
+    {
+        capture.stop();
+        return true;
+    }
+
+    const auto baseName = Time::getCurrentTime().formatted("Stems %Y-%m-%d %H-%M-%S");
+    if (capture.start(folder, baseName, format))
+        return true;
+
+    spdlog::warn("[StemRecorder] Could not start recording in {}", folder.getFullPathName().toStdString());
+    return false;
+}
+
+void StemRecorderProcessor::setNumStems(int newNumStems)
+{
+    newNumStems = jlimit(1, MaxStems, newNumStems);
+    if (capture.isRecording() || newNumStems == getNumStems())
+        return;
+
+    numStems.store(newNumStems, std::memory_order_release);
+    updateChannelConfig();
+}
+
+void StemRecorderProcessor::setPreRollSeconds(double seconds)
+{
+    seconds = jlimit(0.0, StemCapture::maxPreRollSeconds, seconds);
+    if (capture.isRecording() || seconds == preRollSeconds)
+        return;
+
+    preRollSeconds = seconds;
+    updateChannelConfig();
+}
+
+void StemRecorderProcessor::updateChannelConfig()
+{
+    const int numChannels = getNumStems() * 2;
+    setPlayConfigDetails(numChannels, 0, getSampleRate(), getBlockSize());
+
+    // Not prepared yet; prepareToPlay() will size the ring
+    if (getSampleRate() <= 0.0)
+        return;
+
+    suspendProcessing(true);
+    capture.prepare(getSampleRate(), numChannels, preRollSeconds);
+    suspendProcessing(false);
+}
+
+//==============================================================================
+void StemRecorderProcessor::prepareToPlay(double sampleRate, int estimatedSamplesPerBlock)
+{
+    // Keeps the pre-roll if nothing has changed, e.g. when the graph is rebuilt
+    if (capture.getNumChannels() == getNumStems() * 2 && capture.getSampleRate() == sampleRate &&
+        capture.getPreRollSeconds() == preRollSeconds)
+        return;
+
+    capture.prepare(sampleRate, getNumStems() * 2, preRollSeconds);
+}
+
+void StemRecorderProcessor::processBlock(AudioSampleBuffer& buffer, MidiBuffer& midiMessages)
+{
+    capture.push(buffer.getArrayOfReadPointers(), jmin(buffer.getNumChannels(), getTotalNumInputChannels()),
+                 buffer.getNumSamples());
+}
+
+//==============================================================================
+const String StemRecorderProcessor::getInputChannelName(int channelIndex) const
+{
+    return "Stem " + String(channelIndex / 2 + 1) + ((channelIndex % 2) == 0 ? " L" : " R");
+}
+
+//==============================================================================
+Component* StemRecorderProcessor::getControls()
+{
+    return new StemRecorderControl(this);
+}
+
+//==============================================================================
+void StemRecorderProcessor::getStateInformation(MemoryBlock& destData)
+{
+    XmlElement xml("StemRecorder");
+    xml.setAttribute("version", 1);
+    xml.setAttribute("numStems", getNumStems());
+    xml.setAttribute("format", static_cast<int>(format));
+    xml.setAttribute("preRoll", preRollSeconds);
+    xml.setAttribute("folder", folder.getFullPathName());
+    copyXmlToBinary(xml, destData);
+}
+
+void StemRecorderProcessor::setStateInformation(const void* data, int sizeInBytes)
+{
+    auto xml = getXmlFromBinary(data, sizeInBytes);
+    if (!xml || xml->getTagName() != "StemRecorder")
+        return;
+
+    const int savedFormat = xml->getIntAttribute("format", static_cast<int>(StemCapture::Format::PerStem));
+    format = static_cast<StemCapture::Format>(jlimit(0, static_cast<int>(StemCapture::Format::NumFormats) - 1,
+                                                     savedFormat));
+
+    const auto savedFolder = xml->getStringAttribute("folder");
+    if (File::isAbsolutePath(savedFolder))
+        folder = File(savedFolder);
+
+    numStems.store(jlimit(1, MaxStems, xml->getIntAttribute("numStems", DefaultStems)), std::memory_order_release);
+    preRollSeconds = jlimit(0.0, StemCapture::maxPreRollSeconds,
+                            xml->getDoubleAttribute("preRoll", StemCapture::defaultPreRollSeconds));
+    updateChannelConfig();
+}
+
+//==============================================================================
+void StemRecorderProcessor::fillInPluginDescription(PluginDescription& description) const
+{
+    description.name = "Stem Recorder";
+    description.descriptiveName = "Multitrack stem recorder with pre-roll";
+    description.pluginFormatName = "Internal";
+    description.category = "Pedalboard Processors";
+    description.manufacturerName = "Pedalboard3";
+    description.version = "1.0.0";
+    description.fileOrIdentifier = "Stem Recorder";
+    description.uniqueId = 0x5354454D; // "STEM"
+    description.isInstrument = false;
+    description.numInputChannels = getTotalNumInputChannels();
+    description.numOutputChannels = 0;
+}
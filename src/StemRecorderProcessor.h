@@ -0,0 +1,112 @@
+/*
+  ==============================================================================
+
+    StemRecorderProcessor.h
+    Multitrack stem recorder with an always-on pre-roll
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "PedalboardProcessors.h"
+#include "StemCapture.h"
+
+#include <atomic>
+
+//==============================================================================
+/**
+    Records up to MaxStems stereo stems in one take.
+
+    Each stem is a stereo input pair; connecting any node's output to a stem
+    taps it, since the graph fans the signal out without disturbing the
+    existing connections. The processor has no outputs and does nothing on
+    the audio thread but copy its inputs into a StemCapture ring, so the
+    previous pre-roll seconds are always available when record is pressed.
+    Files go to the chosen folder, named after the time recording started.
+*/
+class StemRecorderProcessor : public PedalboardProcessor
+{
+  public:
+    static constexpr int MaxStems = 16;
+    static constexpr int DefaultStems = 4;
+
+    StemRecorderProcessor();
+    ~StemRecorderProcessor() override;
+
+    //==========================================================================
+    // Recording (message thread)
+
+    /// Starts or stops a take. Returns false if a take couldn't be started.
+    bool toggleRecording();
+    bool isRecording() const { return capture.isRecording(); }
+    const StemCapture& getCapture() const { return capture; }
+
+    int getNumStems() const { return numStems.load(std::memory_order_acquire); }
+    /// Changes the input count; ignored while recording
+    void setNumStems(int newNumStems);
+
+    StemCapture::Format getFormat() const { return format; }
+    void setFormat(StemCapture::Format newFormat) { format = newFormat; }
+
+    double getPreRollSeconds() const { return preRollSeconds; }
+    /// Reallocates the ring; ignored while recording
+    void setPreRollSeconds(double seconds);
+
+    const File& getFolder() const { return folder; }
+    void setFolder(const File& newFolder) { folder = newFolder; }
+
+    //==========================================================================
+    // PedalboardProcessor interface
+    Component* getControls() override;
+    Point<int> getSize() override { return Point<int>(300, 120); }
+
+    //==========================================================================
+    // AudioProcessor overrides
+    void fillInPluginDescription(PluginDescription& description) const override;
+    void processBlock(AudioSampleBuffer& buffer, MidiBuffer& midiMessages) override;
+
+    const String getName() const override { return "Stem Recorder"; }
+    void prepareToPlay(double sampleRate, int estimatedSamplesPerBlock) override;
+    void releaseResources() override {}
+
+    const String getInputChannelName(int channelIndex) const override;
+    const String getOutputChannelName(int channelIndex) const override { return ""; }
+    bool isInputChannelStereoPair(int index) const override { return true; }
+    bool isOutputChannelStereoPair(int index) const override { return false; }
+    bool silenceInProducesSilenceOut() const override { return true; }
+    double getTailLengthSeconds() const override { return 0.0; }
+    bool acceptsMidi() const override { return false; }
+    bool producesMidi() const override { return false; }
+
+    AudioProcessorEditor* createEditor() override { return nullptr; }
+    bool hasEditor() const override { return false; }
+
+    int getNumParameters() override { return 0; }
+    const String getParameterName(int parameterIndex) override { return ""; }
+    float getParameter(int parameterIndex) override { return 0.0f; }
+    const String getParameterText(int parameterIndex) override { return ""; }
+    void setParameter(int parameterIndex, float newValue) override {}
+
+    int getNumPrograms() override { return 0; }
+    int getCurrentProgram() override { return 0; }
+    void setCurrentProgram(int index) override {}
+    const String getProgramName(int index) override { return ""; }
+    void changeProgramName(int index, const String& newName) override {}
+
+    void getStateInformation(MemoryBlock& destData) override;
+    void setStateInformation(const void* data, int sizeInBytes) override;
+
+  private:
+    /// Matches the inputs and the ring to the current settings. Pauses the
+    /// audio callback while the ring is reallocated.
+    void updateChannelConfig();
+
+    StemCapture capture;
+    std::atomic<int> numStems{DefaultStems};
+    StemCapture::Format format = StemCapture::Format::PerStem;
+    double preRollSeconds = StemCapture::defaultPreRollSeconds;
+    File folder;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(StemRecorderProcessor)
+};
@@ -0,0 +1,179 @@
+/*
+  ==============================================================================
+
+    StrumAnalyser.cpp
+    Polyphonic (strum) tuning analysis: per-string cents from one chord
+
+  ==============================================================================
+*/
+
+#include "StrumAnalyser.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+constexpr float searchCents = 100.0f;    // Search +/- this around each harmonic
+constexpr float collisionCents = 50.0f;  // Harmonics closer than this are inseparable
+constexpr float presenceDb = -40.0f;     // Peak level relative to the loudest partial
+constexpr float minFrequency = 20.0f;
+constexpr float maxFrequency = 2000.0f;
+
+float centsBetween(float frequency, float reference)
+{
+    return 1200.0f * std::log2(frequency / reference);
+}
+} // namespace
+
+//==============================================================================
+const std::vector<StrumAnalyser::Tuning>& StrumAnalyser::getTunings()
+{
+    static const std::vector<Tuning> tunings = {
+        {"Standard", {40, 45, 50, 55, 59, 64}},
+        {"Drop D", {38, 45, 50, 55, 59, 64}},
+        {"Eb Standard", {39, 44, 49, 54, 58, 63}},
+        {"7-String", {35, 40, 45, 50, 55, 59, 64}},
+        {"Bass 4", {28, 33, 38, 43}},
+        {"Bass 5", {23, 28, 33, 38, 43}},
+    };
+    return tunings;
+}
+
+//==============================================================================
+void StrumAnalyser::prepare(double newSampleRate, int tuningIndex, float referenceA4)
+{
+    const auto& tunings = getTunings();
+    const auto& tuning = tunings[static_cast<size_t>(juce::jlimit(0, static_cast<int>(tunings.size()) - 1, tuningIndex))];
+
+    sampleRate = newSampleRate;
+    midiNotes.assign(tuning.midiNotes.begin(),
+                     tuning.midiNotes.begin() + juce::jmin(static_cast<int>(tuning.midiNotes.size()), maxStrings));
+
+    targets.clear();
+    for (int note : midiNotes)
+        targets.push_back(referenceA4 * std::pow(2.0f, static_cast<float>(note - 69) / 12.0f));
+
+    // A harmonic is contested if another string has a harmonic of the same
+    // or lower order on top of it; that string owns the peak
+    contested.assign(targets.size(), {});
+    for (size_t i = 0; i < targets.size(); ++i)
+        for (int h = 1; h <= numHarmonics; ++h)
+            for (size_t j = 0; j < targets.size(); ++j)
+                for (int k = 1; k <= h && j != i; ++k)
+                    if (std::abs(centsBetween(targets[j] * k, targets[i] * h)) < collisionCents)
+                        contested[i][static_cast<size_t>(h - 1)] = true;
+
+    // Long enough to resolve a few cents on the lowest string
+    const float lowest = *std::min_element(targets.begin(), targets.end());
+    const double seconds = juce::jlimit(0.5, 1.5, 30.0 / lowest);
+    const int newWindowSize = juce::nextPowerOfTwo(static_cast<int>(sampleRate * seconds));
+
+    if (newWindowSize != windowSize || fft == nullptr)
+    {
+        windowSize = newWindowSize;
+
+        int order = 0;
+        while ((1 << order) < 2 * windowSize)
+            ++order;
+        fft = std::make_unique<juce::dsp::FFT>(order);
+
+        window.resize(static_cast<size_t>(windowSize));
+        for (int i = 0; i < windowSize; ++i)
+            window[static_cast<size_t>(i)] =
+                0.5f - 0.5f * std::cos(juce::MathConstants<float>::twoPi * static_cast<float>(i) / windowSize);
+
+        spectrum.assign(static_cast<size_t>(4 * windowSize), 0.0f);
+    }
+}
+
+//==============================================================================
+int StrumAnalyser::analyse(const float* samples, Results& results)
+{
+    jassert(fft != nullptr);
+
+    std::fill(spectrum.begin(), spectrum.end(), 0.0f);
+    for (int i = 0; i < windowSize; ++i)
+        spectrum[static_cast<size_t>(i)] = samples[i] * window[static_cast<size_t>(i)];
+    fft->performFrequencyOnlyForwardTransform(spectrum.data(), true);
+
+    const float binWidth = static_cast<float>(sampleRate) / static_cast<float>(2 * windowSize);
+    const int numBins = windowSize + 1;
+    auto toBin = [binWidth, numBins](float frequency)
+    { return juce::jlimit(1, numBins - 2, static_cast<int>(frequency / binWidth)); };
+
+    float loudest = 0.0f;
+    for (int bin = toBin(minFrequency); bin <= toBin(maxFrequency); ++bin)
+        loudest = juce::jmax(loudest, spectrum[static_cast<size_t>(bin)]);
+    const float presence = loudest * juce::Decibels::decibelsToGain(presenceDb);
+
+    /// Interpolated peak frequency near centre, or 0 if there is none
+    auto findPeak = [&](float centre, float& magnitude) -> float
+    {
+        const float spread = std::pow(2.0f, searchCents / 1200.0f);
+        const int first = toBin(centre / spread);
+        const int last = toBin(centre * spread) + 1;
+
+        int peak = first;
+        for (int bin = first; bin <= last; ++bin)
+            if (spectrum[static_cast<size_t>(bin)] > spectrum[static_cast<size_t>(peak)])
+                peak = bin;
+
+        magnitude = spectrum[static_cast<size_t>(peak)];
+        if (peak == first || peak == last || magnitude < presence || magnitude <= 0.0f)
+            return 0.0f;
+
+        const float a = std::log(juce::jmax(1.0e-20f, spectrum[static_cast<size_t>(peak - 1)]));
+        const float b = std::log(magnitude);
+        const float c = std::log(juce::jmax(1.0e-20f, spectrum[static_cast<size_t>(peak + 1)]));
+        const float denominator = a - 2.0f * b + c;
+        const float offset = std::abs(denominator) > 1.0e-12f ? 0.5f * (a - c) / denominator : 0.0f;
+        return (static_cast<float>(peak) + offset) * binWidth;
+    };
+
+    const int numStrings = getNumStrings();
+    for (int s = 0; s < numStrings; ++s)
+    {
+        auto& result = results[static_cast<size_t>(s)];
+        const float target = targets[static_cast<size_t>(s)];
+        result = {};
+        result.midiNote = midiNotes[static_cast<size_t>(s)];
+
+        float fundamentalMagnitude = 0.0f;
+        result.detected = loudest > 0.0f && findPeak(target, fundamentalMagnitude) > 0.0f;
+        if (!result.detected)
+            continue;
+
+        double weightedCents = 0.0, totalWeight = 0.0;
+        for (int h = 1; h <= numHarmonics; ++h)
+        {
+            if (contested[static_cast<size_t>(s)][static_cast<size_t>(h - 1)])
+                continue;
+
+            float magnitude = 0.0f;
+            const float peak = findPeak(target * h, magnitude);
+            if (peak <= 0.0f)
+                continue;
+
+            weightedCents += static_cast<double>(magnitude) * centsBetween(peak / h, target);
+            totalWeight += magnitude;
+        }
+
+        // Every usable harmonic is shared with another string: fall back to
+        // the fundamental
+        if (totalWeight <= 0.0)
+        {
+            float magnitude = 0.0f;
+            weightedCents = centsBetween(findPeak(target, magnitude), target);
+            totalWeight = 1.0;
+        }
+
+        result.cents = static_cast<float>(weightedCents / totalWeight);
+        result.frequency = target * std::pow(2.0f, result.cents / 1200.0f);
+    }
+
+    for (int s = numStrings; s < maxStrings; ++s)
+        results[static_cast<size_t>(s)] = {};
+
+    return numStrings;
+}
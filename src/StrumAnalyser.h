@@ -0,0 +1,85 @@
+/*
+  ==============================================================================
+
+    StrumAnalyser.h
+    Polyphonic (strum) tuning analysis: per-string cents from one chord
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+
+#include <array>
+#include <memory>
+#include <vector>
+
+//==============================================================================
+/**
+    Measures every string of a tuning from one strummed open chord.
+
+    A Hann-windowed, 2x zero-padded FFT of a long window (0.5-1.5 s, longer
+    for bass tunings) is searched around the first three harmonics of each
+    string's target note. Each harmonic peak is located to sub-bin accuracy
+    with log-magnitude parabolic interpolation and converted to an implied
+    fundamental. The string's deviation is the magnitude-weighted mean over
+    its harmonics.
+
+    Harmonics that collide with a lower-order harmonic of another string
+    (e.g. low E's 3rd against the B string in standard tuning) are left out
+    of the estimate, since the two can't be separated at this resolution.
+    A string counts as sounding when its fundamental region holds a clear
+    peak. A muted string whose fundamental coincides with another string's
+    overtone can therefore still read as sounding.
+
+    Not thread-safe; call prepare() and analyse() from one non-audio thread.
+*/
+class StrumAnalyser
+{
+  public:
+    static constexpr int maxStrings = 8;
+
+    struct Tuning
+    {
+        const char* name;
+        std::vector<int> midiNotes; // Lowest string first
+    };
+
+    struct StringResult
+    {
+        int midiNote = -1;
+        float frequency = 0.0f; // Measured fundamental
+        float cents = 0.0f;     // Deviation from midiNote
+        bool detected = false;
+    };
+
+    using Results = std::array<StringResult, maxStrings>;
+
+    /// Built-in tunings (standard, drop D, half step down, 7-string, bass)
+    static const std::vector<Tuning>& getTunings();
+
+    /// Sets the tuning (index into getTunings) and sample rate. Allocates.
+    void prepare(double sampleRate, int tuningIndex, float referenceA4 = 440.0f);
+
+    /// Samples needed per analysis
+    int getWindowSize() const { return windowSize; }
+    int getNumStrings() const { return static_cast<int>(targets.size()); }
+
+    /// Analyses the last getWindowSize() samples. Fills one result per
+    /// string and returns the number of strings.
+    int analyse(const float* samples, Results& results);
+
+    static constexpr int numHarmonics = 3;
+
+  private:
+    double sampleRate = 0.0;
+    int windowSize = 0;
+    std::vector<int> midiNotes;
+    std::vector<float> targets; // Target fundamentals (Hz)
+    std::vector<std::array<bool, numHarmonics>> contested;
+
+    std::unique_ptr<juce::dsp::FFT> fft;
+    std::vector<float> window;
+    std::vector<float> spectrum;
+};
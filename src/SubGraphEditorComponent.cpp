@@ -104,6 +104,9 @@ void SubGraphCanvas::paint(Graphics& g)
         g.drawText(subHint, (int)(centerX - subWidth / 2), (int)(centerY + 18), subWidth + 20, 24,
                    Justification::centred, false);
     }
+
+    // === Connection cables, all in one layer behind the plugins ===
+    PluginConnection::paintCables(g, *this);
 }
 
 void SubGraphCanvas::resized()
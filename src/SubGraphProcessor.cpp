@@ -112,6 +112,8 @@ void SubGraphProcessor::releaseResources()
 
 void SubGraphProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
+    const DspLoadMeter::ScopedMeasurement measurement(loadMeter, buffer.getNumSamples());
+
     // Graph is already initialized in constructor - just delegate
     internalGraph.processBlock(buffer, midiMessages);
 }
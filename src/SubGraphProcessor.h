@@ -11,6 +11,8 @@
 
 #pragma once
 
+#include "DspProfiler.h"
+
 #include <JuceHeader.h>
 
 //==============================================================================
@@ -117,6 +119,9 @@ class SubGraphProcessor : public juce::AudioPluginInstance
     // This eliminates message thread / audio thread race condition
     std::atomic<bool> internalGraphInitialized{false};
 
+    // Times the whole rack, inner nodes included
+    DspLoadMeter loadMeter{*this};
+
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SubGraphProcessor)
 };
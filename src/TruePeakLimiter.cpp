@@ -0,0 +1,217 @@
+/*
+  ==============================================================================
+
+    TruePeakLimiter.cpp
+    Look-ahead brickwall limiter driven by 4x oversampled true-peak detection
+
+  ==============================================================================
+*/
+
+#include "TruePeakLimiter.h"
+
+#include <cmath>
+#include <cstring>
+
+//==============================================================================
+void TruePeakLimiter::prepare(double newSampleRate, int maximumBlockSize)
+{
+    sampleRate = newSampleRate;
+    maxBlockSize = juce::jmax(1, maximumBlockSize);
+
+    window = juce::jmax(1, juce::roundToInt(sampleRate * lookAheadSeconds));
+    latency = window + firDelay;
+    releaseCoeff = static_cast<float>(std::exp(-1.0 / (sampleRate * releaseSeconds)));
+
+    // Blackman-windowed sinc, cut off at the original Nyquist, split into phases.
+    // Centred on a tap of the last phase, which then passes the input unchanged
+    // and the other phases fall evenly between the samples.
+    constexpr int centre = oversampling * firDelay + oversampling - 1;
+    constexpr double halfWidth = centre + 1.0;
+    for (int phase = 0; phase < oversampling; ++phase)
+    {
+        double sum = 0.0;
+        std::array<double, tapsPerPhase> taps{};
+        for (int k = 0; k < tapsPerPhase; ++k)
+        {
+            const int m = oversampling * k + phase;
+            const double x = static_cast<double>(m - centre) / oversampling;
+            const double sinc = m == centre ? 1.0 : std::sin(juce::MathConstants<double>::pi * x) /
+                                                        (juce::MathConstants<double>::pi * x);
+            const double d = (m - centre) / halfWidth;
+            const double w = std::abs(d) >= 1.0 ? 0.0
+                                                : 0.42 + 0.5 * std::cos(juce::MathConstants<double>::pi * d) +
+                                                      0.08 * std::cos(juce::MathConstants<double>::twoPi * d);
+            taps[static_cast<size_t>(k)] = sinc * w;
+            sum += sinc * w;
+        }
+
+        // Unity gain at DC for every phase; reversed, so each output is a dot
+        // product with the history in time order
+        for (int k = 0; k < tapsPerPhase; ++k)
+            phases[static_cast<size_t>(phase)][static_cast<size_t>(tapsPerPhase - 1 - k)] =
+                static_cast<float>(taps[static_cast<size_t>(k)] / sum);
+    }
+
+    for (auto& channel : history)
+        channel.assign(static_cast<size_t>(tapsPerPhase - 1 + maxBlockSize), 0.0f);
+    for (auto& channel : delayLine)
+        channel.assign(static_cast<size_t>(latency + maxBlockSize), 0.0f);
+
+    truePeaks.assign(static_cast<size_t>(maxBlockSize), 0.0f);
+    channelPeaks.assign(static_cast<size_t>(maxBlockSize), 0.0f);
+    minValues.assign(static_cast<size_t>(window + 2), 1.0f);
+    minIndices.assign(static_cast<size_t>(window + 2), 0);
+    boxValues.assign(static_cast<size_t>(window), 1.0f);
+
+    reset();
+}
+
+void TruePeakLimiter::reset()
+{
+    for (auto& channel : history)
+        std::fill(channel.begin(), channel.end(), 0.0f);
+    for (auto& channel : delayLine)
+        std::fill(channel.begin(), channel.end(), 0.0f);
+
+    minHead = 0;
+    minSize = 0;
+    sampleIndex = 0;
+
+    std::fill(boxValues.begin(), boxValues.end(), 1.0f);
+    boxPos = 0;
+    boxSum = static_cast<double>(window);
+    releasedGain = 1.0f;
+    lastTruePeak = 0.0f;
+}
+
+//==============================================================================
+float TruePeakLimiter::process(float* const* channels, int numChannels, int numSamples)
+{
+    jassert(maxBlockSize > 0); // prepare() first
+
+    numChannels = juce::jmin(numChannels, maxChannels);
+    float lowest = 1.0f;
+    float highestPeak = 0.0f;
+
+    std::array<float*, maxChannels> chunk{};
+    for (int done = 0; done < numSamples; done += maxBlockSize)
+    {
+        const int count = juce::jmin(maxBlockSize, numSamples - done);
+        for (int ch = 0; ch < numChannels; ++ch)
+            chunk[static_cast<size_t>(ch)] = channels[ch] + done;
+
+        detectTruePeaks(chunk.data(), numChannels, count);
+        highestPeak = juce::jmax(highestPeak, lastTruePeak);
+        lowest = juce::jmin(lowest, computeGains(count));
+        processChunk(chunk.data(), numChannels, count);
+    }
+
+    lastTruePeak = highestPeak;
+    return lowest;
+}
+
+void TruePeakLimiter::detectTruePeaks(const float* const* channels, int numChannels, int numSamples)
+{
+    if (numChannels == 0)
+    {
+        juce::FloatVectorOperations::clear(truePeaks.data(), numSamples);
+        lastTruePeak = 0.0f;
+        return;
+    }
+
+    constexpr int historyLength = tapsPerPhase - 1;
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        auto& channelHistory = history[static_cast<size_t>(ch)];
+        juce::FloatVectorOperations::copy(channelHistory.data() + historyLength, channels[ch], numSamples);
+
+        float* peaks = ch == 0 ? truePeaks.data() : channelPeaks.data();
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float* taps = channelHistory.data() + i;
+            float peak = 0.0f;
+            for (const auto& phase : phases)
+            {
+                float y = 0.0f;
+                for (int k = 0; k < tapsPerPhase; ++k)
+                    y += phase[static_cast<size_t>(k)] * taps[k];
+                peak = juce::jmax(peak, std::abs(y));
+            }
+            peaks[i] = peak;
+        }
+
+        if (ch > 0)
+            juce::FloatVectorOperations::max(truePeaks.data(), truePeaks.data(), channelPeaks.data(), numSamples);
+
+        std::memmove(channelHistory.data(), channelHistory.data() + numSamples, historyLength * sizeof(float));
+    }
+
+    lastTruePeak = juce::FloatVectorOperations::findMaximum(truePeaks.data(), numSamples);
+}
+
+float TruePeakLimiter::computeGains(int numSamples)
+{
+    // One sample longer than the average, for peaks just before the detected sample
+    const int hold = window + 1;
+    const int capacity = hold + 1;
+    float lowest = 1.0f;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float required = requiredGain(truePeaks[static_cast<size_t>(i)]);
+
+        // Hold the lowest gain needed anywhere in the look-ahead window
+        while (minSize > 0 && minValues[static_cast<size_t>((minHead + minSize - 1) % capacity)] >= required)
+            --minSize;
+        const auto back = static_cast<size_t>((minHead + minSize) % capacity);
+        minValues[back] = required;
+        minIndices[back] = sampleIndex;
+        ++minSize;
+
+        while (minIndices[static_cast<size_t>(minHead)] <= sampleIndex - hold)
+        {
+            minHead = (minHead + 1) % capacity;
+            --minSize;
+        }
+        const float held = minValues[static_cast<size_t>(minHead)];
+
+        // Attack is instant here, the moving average below spreads it across the window
+        releasedGain = held < releasedGain ? held : held + releaseCoeff * (releasedGain - held);
+
+        boxSum += releasedGain - boxValues[static_cast<size_t>(boxPos)];
+        boxValues[static_cast<size_t>(boxPos)] = releasedGain;
+        boxPos = (boxPos + 1) % window;
+
+        const auto gain = static_cast<float>(boxSum / window);
+        truePeaks[static_cast<size_t>(i)] = gain;
+        lowest = juce::jmin(lowest, gain);
+        ++sampleIndex;
+    }
+
+    return lowest;
+}
+
+float TruePeakLimiter::requiredGain(float truePeak) const
+{
+    if (truePeak <= threshold)
+        return 1.0f;
+
+    // Soft knee that approaches the ceiling but never reaches it
+    const float range = ceiling - threshold;
+    const float limited = threshold + range * std::tanh((truePeak - threshold) / range);
+    return limited / truePeak;
+}
+
+void TruePeakLimiter::processChunk(float* const* channels, int numChannels, int numSamples)
+{
+    const float* gains = truePeaks.data();
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        auto& delay = delayLine[static_cast<size_t>(ch)];
+        juce::FloatVectorOperations::copy(delay.data() + latency, channels[ch], numSamples);
+        juce::FloatVectorOperations::multiply(channels[ch], delay.data(), gains, numSamples);
+        std::memmove(delay.data(), delay.data() + numSamples, static_cast<size_t>(latency) * sizeof(float));
+    }
+}
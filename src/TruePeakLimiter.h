@@ -0,0 +1,108 @@
+/*
+  ==============================================================================
+
+    TruePeakLimiter.h
+    Look-ahead brickwall limiter driven by 4x oversampled true-peak detection
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+#include <array>
+#include <vector>
+
+//==============================================================================
+/**
+    Stereo-linked look-ahead limiter for the output safety stage.
+
+    Peaks are measured between the samples as well as on them: each channel
+    is upsampled 4x by a polyphase FIR (as ITU-R BS.1770 does for true-peak
+    metering), so a peak a DAC would reconstruct above full scale is caught
+    even when no sample reaches it. The audio is delayed by a short
+    look-ahead; the gain each peak needs is held across the look-ahead window
+    and smoothed over it, so gain reduction is complete by the time the peak
+    comes out, without a hard clip.
+
+    Work is done a block at a time: true peaks for the whole block first, then
+    the gain curve, then the delay and gain are applied to each channel with
+    vector operations. Only the gain recursion runs per sample.
+*/
+class TruePeakLimiter
+{
+  public:
+    static constexpr int maxChannels = 2;
+    static constexpr int oversampling = 4;
+    static constexpr int tapsPerPhase = 12;
+    static constexpr int firDelay = tapsPerPhase / 2 - 1; // Input samples the interpolator lags by
+    static constexpr double lookAheadSeconds = 0.001;
+    static constexpr double releaseSeconds = 0.05;
+
+    static constexpr float defaultThreshold = 0.944f; // -0.5 dBFS: the soft knee starts here
+    static constexpr float defaultCeiling = 0.989f;   // -0.1 dBTP: true peaks never pass this
+
+    TruePeakLimiter() = default;
+
+    /// Allocates for blocks up to maximumBlockSize. Not while process() can be called.
+    void prepare(double sampleRate, int maximumBlockSize);
+    /// Clears the delay line and detector history, and releases the gain
+    void reset();
+
+    /// Samples the audio is delayed by: the look-ahead plus the FIR's delay
+    int getLatencySamples() const { return latency; }
+
+    void setThreshold(float linearThreshold) { threshold = linearThreshold; }
+    void setCeiling(float linearCeiling) { ceiling = linearCeiling; }
+
+    /// Limits the first maxChannels of channels in place, all with the same
+    /// gain. Returns the lowest gain applied in the block.
+    float process(float* const* channels, int numChannels, int numSamples);
+
+    /// Highest true peak seen by the last process() call
+    float getLastTruePeak() const { return lastTruePeak; }
+
+  private:
+    /// Fills truePeaks with the linked true peak of each input sample
+    void detectTruePeaks(const float* const* channels, int numChannels, int numSamples);
+    /// Turns truePeaks into gains, in place
+    float computeGains(int numSamples);
+    float requiredGain(float truePeak) const;
+    void processChunk(float* const* channels, int numChannels, int numSamples);
+
+    double sampleRate = 44100.0;
+    int maxBlockSize = 0;
+    int window = 1;  // Look-ahead, in samples
+    int latency = 0; // Look-ahead plus the interpolator's delay
+    float threshold = defaultThreshold;
+    float ceiling = defaultCeiling;
+    float releaseCoeff = 0.0f;
+
+    // Polyphase interpolator: one reversed set of taps per phase
+    std::array<std::array<float, tapsPerPhase>, oversampling> phases{};
+
+    // Per channel: the FIR's history then the block, and the delay line then the block
+    std::array<std::vector<float>, maxChannels> history;
+    std::array<std::vector<float>, maxChannels> delayLine;
+
+    std::vector<float> truePeaks; // Then the gains, in place
+    std::vector<float> channelPeaks;
+
+    // Running minimum of the required gain over the window (monotonic queue)
+    std::vector<float> minValues;
+    std::vector<juce::int64> minIndices;
+    int minHead = 0;
+    int minSize = 0;
+    juce::int64 sampleIndex = 0;
+
+    // Moving average over the window, after the release
+    std::vector<float> boxValues;
+    int boxPos = 0;
+    double boxSum = 0.0;
+    float releasedGain = 1.0f;
+
+    float lastTruePeak = 0.0f;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TruePeakLimiter)
+};
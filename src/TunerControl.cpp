@@ -19,20 +19,26 @@ TunerControl::TunerControl(TunerProcessor* processor) : tunerProcessor(processor
 {
     // Mode toggle button
     modeButton = std::make_unique<TextButton>("NEEDLE");
-    modeButton->setTooltip("Toggle between Needle and Strobe tuner modes");
+    modeButton->setTooltip("Cycle between Needle, Strobe and Poly (strum) tuner modes");
     modeButton->addListener(this);
     addAndMakeVisible(modeButton.get());
 
-    // 60 fps for smooth animation
-    startTimerHz(60);
+    // Range toggle: a lower range uses a longer analysis window
+    rangeButton = std::make_unique<TextButton>();
+    rangeButton->addListener(this);
+    addAndMakeVisible(rangeButton.get());
+
+    if (processor->isPolyphonic())
+    {
+        currentMode = TunerMode::Poly;
+        modeButton->setButtonText("POLY");
+    }
+    updateRangeButtonText();
 
     setSize(300, 200);
 }
 
-TunerControl::~TunerControl()
-{
-    stopTimer();
-}
+TunerControl::~TunerControl() = default;
 
 //==============================================================================
 void TunerControl::buttonClicked(Button* button)
@@ -44,21 +50,63 @@ void TunerControl::buttonClicked(Button* button)
             currentMode = TunerMode::Strobe;
             modeButton->setButtonText("STROBE");
         }
+        else if (currentMode == TunerMode::Strobe)
+        {
+            currentMode = TunerMode::Poly;
+            modeButton->setButtonText("POLY");
+        }
         else
         {
             currentMode = TunerMode::Needle;
             modeButton->setButtonText("NEEDLE");
         }
+        tunerProcessor->setPolyphonic(currentMode == TunerMode::Poly);
+        updateRangeButtonText();
         repaint();
     }
+    else if (button == rangeButton.get())
+    {
+        if (currentMode == TunerMode::Poly)
+        {
+            const int numTunings = static_cast<int>(StrumAnalyser::getTunings().size());
+            tunerProcessor->setTuning((tunerProcessor->getTuning() + 1) % numTunings);
+        }
+        else
+        {
+            const int numRanges = static_cast<int>(TunerProcessor::Range::NumRanges);
+            tunerProcessor->setRange(
+                static_cast<TunerProcessor::Range>((static_cast<int>(tunerProcessor->getRange()) + 1) % numRanges));
+        }
+        updateRangeButtonText();
+    }
+}
+
+void TunerControl::updateRangeButtonText()
+{
+    if (currentMode == TunerMode::Poly)
+    {
+        const auto& tunings = StrumAnalyser::getTunings();
+        const int index = jlimit(0, static_cast<int>(tunings.size()) - 1, tunerProcessor->getTuning());
+        rangeButton->setButtonText(String(tunings[static_cast<size_t>(index)].name).toUpperCase());
+        rangeButton->setTooltip("Tuning to check against when strumming all open strings");
+    }
+    else
+    {
+        rangeButton->setButtonText(TunerProcessor::getRangeName(tunerProcessor->getRange()).toUpperCase());
+        rangeButton->setTooltip("Lowest string to tune: Guitar, 7-String (low B) or Bass (5-string low B)");
+    }
 }
 
 //==============================================================================
-void TunerControl::timerCallback()
+void TunerControl::updateFrame()
 {
     if (tunerProcessor == nullptr)
         return;
 
+    const bool hasNewResults = tunerProcessor->getDisplayVersion().changedSince(lastVersion);
+    if (!hasNewResults && !isAnimating)
+        return;
+
     float targetCents = tunerProcessor->getCentsDeviation();
     displayedCents += (targetCents - displayedCents) * NEEDLE_SMOOTHING;
 
@@ -69,9 +117,16 @@ void TunerControl::timerCallback()
     float targetGlow = (absCents < 5.0f) ? 1.0f - (absCents / 5.0f) : 0.0f;
     glowIntensity += (targetGlow - glowIntensity) * GLOW_SMOOTHING;
 
-    if (currentMode == TunerMode::Strobe)
+    // Keep easing after the results stop changing, until nothing would visibly move
+    isAnimating = std::abs(targetCents - displayedCents) > 0.05f || std::abs(targetAngle - needleAngle) > 0.05f ||
+                  std::abs(targetGlow - glowIntensity) > 0.005f;
+
+    if (hasNewResults)
     {
-        strobeRotation = tunerProcessor->getStrobePhase() * MathConstants<float>::twoPi * STROBE_BANDS;
+        if (currentMode == TunerMode::Strobe)
+            strobeRotation = tunerProcessor->getStrobePhase() * MathConstants<float>::twoPi * STROBE_BANDS;
+        else if (currentMode == TunerMode::Poly)
+            numStrings = tunerProcessor->getStringResults(stringResults);
     }
 
     repaint();
@@ -95,6 +150,12 @@ void TunerControl::paint(Graphics& g)
 
     auto area = bounds.reduced(6);
 
+    if (currentMode == TunerMode::Poly)
+    {
+        drawStringMeters(g, area.withTrimmedBottom(18));
+        return;
+    }
+
     auto noteArea = area.removeFromTop(52);
     drawNoteDisplay(g, noteArea);
 
@@ -419,6 +480,56 @@ void TunerControl::drawLedIndicators(Graphics& g, Rectangle<float> bounds)
     drawSharpSymbol(g, bounds.getRight() - 12, symbolY, 12.0f, colours["Text Colour"].withAlpha(0.6f));
 }
 
+//==============================================================================
+void TunerControl::drawStringMeters(Graphics& g, Rectangle<float> bounds)
+{
+    auto& colours = ColourScheme::getInstance().colours;
+    auto& fonts = FontManager::getInstance();
+
+    if (numStrings == 0)
+    {
+        g.setColour(colours["Text Colour"].withAlpha(0.4f));
+        g.setFont(fonts.getMonoFont(11.0f));
+        g.drawText("Strum all open strings...", bounds, Justification::centred);
+        return;
+    }
+
+    const float columnWidth = bounds.getWidth() / static_cast<float>(numStrings);
+    for (int s = 0; s < numStrings; ++s)
+    {
+        const auto& result = stringResults[static_cast<size_t>(s)];
+        auto column = bounds.withX(bounds.getX() + s * columnWidth).withWidth(columnWidth).reduced(3.0f, 0.0f);
+
+        // Note name on top, cents underneath, meter between
+        auto nameArea = column.removeFromTop(16);
+        auto centsArea = column.removeFromBottom(14);
+        auto track = column.withSizeKeepingCentre(6.0f, column.getHeight() - 8.0f);
+
+        const Colour colour = result.detected ? getTuningColour(result.cents) : colours["Text Colour"].withAlpha(0.3f);
+
+        g.setColour(colours["Plugin Border"].darker(0.3f));
+        g.fillRoundedRectangle(track, 3.0f);
+        g.setColour(colours["Text Colour"].withAlpha(0.5f));
+        g.fillRect(track.getX() - 4.0f, track.getCentreY() - 0.5f, track.getWidth() + 8.0f, 1.0f);
+
+        g.setFont(fonts.getMonoFont(11.0f));
+        g.setColour(colour);
+        g.drawText(getNoteName(result.midiNote), nameArea, Justification::centred);
+
+        if (result.detected)
+        {
+            // Sharp is up, flat is down; clamped at +/-50 cents
+            const float position = jlimit(-1.0f, 1.0f, result.cents / 50.0f);
+            const float y = track.getCentreY() - position * track.getHeight() * 0.5f;
+            g.fillEllipse(track.getCentreX() - 6.0f, y - 6.0f, 12.0f, 12.0f);
+
+            g.setFont(fonts.getMonoFont(10.0f));
+            g.drawText((result.cents >= 0 ? "+" : "") + String(roundToInt(result.cents)), centsArea,
+                       Justification::centred);
+        }
+    }
+}
+
 //==============================================================================
 void TunerControl::drawFrequencyDisplay(Graphics& g, Rectangle<float> bounds)
 {
@@ -459,6 +570,10 @@ void TunerControl::resized()
     modeButton->setBounds(bounds.getRight() - 55, bounds.getBottom() - 14, 50, 13);
     modeButton->setColour(TextButton::buttonColourId, colours["Plugin Border"].darker(0.1f));
     modeButton->setColour(TextButton::textColourOffId, colours["Text Colour"].withAlpha(0.8f));
+
+    rangeButton->setBounds(bounds.getX() + 5, bounds.getBottom() - 14, 50, 13);
+    rangeButton->setColour(TextButton::buttonColourId, colours["Plugin Border"].darker(0.1f));
+    rangeButton->setColour(TextButton::textColourOffId, colours["Text Colour"].withAlpha(0.8f));
 }
 
 //==============================================================================
@@ -9,24 +9,29 @@
 
 #pragma once
 
+#include "StrumAnalyser.h"
+#include "UiFrameScheduler.h"
+
 #include <JuceHeader.h>
 
 class TunerProcessor;
 
 //==============================================================================
 /**
-    Professional tuner display with two modes:
+    Professional tuner display with three modes:
     - NEEDLE: Large analog-style needle meter
     - STROBE: "Turbo Tuner" style strobe disc for ±0.1 cent accuracy
+    - POLY: Per-string meters from one strummed chord
 */
-class TunerControl : public Component, private Timer, public Button::Listener
+class TunerControl : public Component, public Button::Listener
 {
   public:
     /// Tuner display modes
     enum class TunerMode
     {
         Needle,
-        Strobe
+        Strobe,
+        Poly
     };
 
     TunerControl(TunerProcessor* processor);
@@ -37,7 +42,8 @@ class TunerControl : public Component, private Timer, public Button::Listener
     void buttonClicked(Button* button) override;
 
   private:
-    void timerCallback() override;
+    /// Picks up new results and eases the needle towards them
+    void updateFrame();
 
     // Drawing methods - Needle mode
     void drawNeedleMeter(Graphics& g, Rectangle<float> bounds);
@@ -46,6 +52,12 @@ class TunerControl : public Component, private Timer, public Button::Listener
     // Drawing methods - Strobe mode
     void drawStrobeDisc(Graphics& g, Rectangle<float> bounds);
 
+    // Drawing methods - Poly mode
+    void drawStringMeters(Graphics& g, Rectangle<float> bounds);
+
+    // Left button shows the range (Needle/Strobe) or the tuning (Poly)
+    void updateRangeButtonText();
+
     // Common drawing methods
     void drawNoteDisplay(Graphics& g, Rectangle<float> bounds);
     void drawFrequencyDisplay(Graphics& g, Rectangle<float> bounds);
@@ -66,6 +78,13 @@ class TunerControl : public Component, private Timer, public Button::Listener
     // Current mode
     TunerMode currentMode = TunerMode::Needle;
     std::unique_ptr<TextButton> modeButton;
+    std::unique_ptr<TextButton> rangeButton; // Cycles ranges, or tunings in Poly mode
+
+    // Poly mode results, fetched when the processor publishes new ones
+    StrumAnalyser::Results stringResults;
+    int numStrings = 0;
+    juce::uint32 lastVersion = 0;
+    bool isAnimating = false; // Needle or glow still settling
 
     // Display values with smoothing
     float displayedCents = 0.0f;
@@ -81,5 +100,8 @@ class TunerControl : public Component, private Timer, public Button::Listener
     static constexpr int NUM_LEDS = 11;    // -50 to +50 cents
     static constexpr int STROBE_BANDS = 8; // Number of strobe bands
 
+    // 60 fps for smooth animation, but only while there's something new to show
+    UiFrameScheduler::Client frameClient{this, 60.0, [this]() { updateFrame(); }};
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TunerControl)
 };
@@ -11,21 +11,99 @@
 
 #include "TunerControl.h"
 
+#include <algorithm>
 #include <cmath>
 
+namespace
+{
+constexpr int pollIntervalMs = 5; // Under one analysis hop at any common sample rate
+} // namespace
+
+//==============================================================================
+/**
+    Background thread for one tuner. Polls the FIFO's ready count rather than
+    being woken, since notify() would take a lock on the audio thread.
+*/
+class TunerProcessor::Analyser : public Thread
+{
+  public:
+    explicit Analyser(TunerProcessor& tuner) : Thread("TunerAnalysis"), owner(tuner) {}
+    ~Analyser() override { stopThread(2000); }
+
+    void run() override
+    {
+        while (!threadShouldExit())
+        {
+            if (owner.inputFifo.getNumReady() < ANALYSIS_HOP)
+            {
+                wait(pollIntervalMs);
+                continue;
+            }
+            owner.analysePendingInput();
+        }
+    }
+
+  private:
+    TunerProcessor& owner;
+};
+
 //==============================================================================
-TunerProcessor::TunerProcessor() : PedalboardProcessor() {}
+TunerProcessor::TunerProcessor() : PedalboardProcessor()
+{
+    fifoBuffer.assign(FIFO_SIZE, 0.0f);
+    analyser = std::make_unique<Analyser>(*this);
+}
 
-TunerProcessor::~TunerProcessor() {}
+TunerProcessor::~TunerProcessor()
+{
+    analyser->stopThread(2000);
+}
 
 //==============================================================================
 void TunerProcessor::prepareToPlay(double newSampleRate, int estimatedSamplesPerBlock)
 {
+    analyser->stopThread(2000);
+
     sampleRate = newSampleRate;
-    bufferWritePos = 0;
-    samplesUntilNextAnalysis = 0;
-    analysisBuffer.fill(0.0f);
-    yinBuffer.fill(0.0f);
+    inputFifo.reset();
+    samplesSinceAnalysis = 0;
+    samplesSinceStrumAnalysis = 0;
+    preparedTuning = -1;
+    history.clear(); // Resized to the range's window on the next analysis
+
+    analyser->startThread(Thread::Priority::low);
+}
+
+void TunerProcessor::releaseResources()
+{
+    analyser->stopThread(2000);
+}
+
+//==============================================================================
+float TunerProcessor::getLowestFrequency(Range range)
+{
+    switch (range)
+    {
+    case Range::SevenString:
+        return 50.0f;
+    case Range::Bass:
+        return 27.0f;
+    default:
+        return 70.0f;
+    }
+}
+
+String TunerProcessor::getRangeName(Range range)
+{
+    switch (range)
+    {
+    case Range::SevenString:
+        return "7-String";
+    case Range::Bass:
+        return "Bass";
+    default:
+        return "Guitar";
+    }
 }
 
 //==============================================================================
@@ -36,105 +114,112 @@ void TunerProcessor::processBlock(AudioSampleBuffer& buffer, MidiBuffer& midiMes
     if (buffer.getNumChannels() == 0 || buffer.getNumSamples() == 0)
         return;
 
-    // Use first channel for pitch detection
+    // Use first channel for pitch detection. If the analysis thread has
+    // fallen a whole FIFO behind, the end of this block that doesn't fit is
+    // dropped (the read position belongs to the analysis thread, so the
+    // oldest input can't be discarded from here).
     const float* inputData = buffer.getReadPointer(0);
-    const int numSamples = buffer.getNumSamples();
-
-    for (int i = 0; i < numSamples; ++i)
-    {
-        // Fill analysis buffer
-        analysisBuffer[bufferWritePos] = inputData[i];
-        bufferWritePos = (bufferWritePos + 1) % BUFFER_SIZE;
+    const int numSamples = juce::jmin(buffer.getNumSamples(), inputFifo.getFreeSpace());
 
-        --samplesUntilNextAnalysis;
-
-        if (samplesUntilNextAnalysis <= 0)
-        {
-            samplesUntilNextAnalysis = ANALYSIS_HOP;
-
-            // Create contiguous buffer for analysis
-            std::array<float, BUFFER_SIZE> contiguousBuffer;
-            for (int j = 0; j < BUFFER_SIZE; ++j)
-            {
-                contiguousBuffer[j] = analysisBuffer[(bufferWritePos + j) % BUFFER_SIZE];
-            }
-
-            // Run pitch detection
-            float frequency = detectPitchYIN(contiguousBuffer.data(), BUFFER_SIZE);
-
-            if (frequency > 20.0f && frequency < 5000.0f)
-            {
-                detectedFrequency.store(frequency);
-                pitchDetected.store(true);
-                updateNoteAndCents(frequency);
-                updateStrobePhase(frequency);
-            }
-            else
-            {
-                pitchDetected.store(false);
-                detectedNote.store(-1);
-                centsDeviation.store(0.0f);
-            }
-        }
-    }
+    int start1, size1, start2, size2;
+    inputFifo.prepareToWrite(numSamples, start1, size1, start2, size2);
+    std::copy(inputData, inputData + size1, fifoBuffer.begin() + start1);
+    std::copy(inputData + size1, inputData + size1 + size2, fifoBuffer.begin() + start2);
+    inputFifo.finishedWrite(size1 + size2);
 
     if (muteOutput.load())
         buffer.clear();
 }
 
 //==============================================================================
-float TunerProcessor::detectPitchYIN(const float* samples, int numSamples)
+void TunerProcessor::analysePendingInput()
 {
-    const int halfSize = numSamples / 2;
-    const float yinThreshold = 0.15f;
+    const int windowSize = PitchDetector::getWindowSizeFor(sampleRate, getLowestFrequency(getRange()));
+    pitchDetector.setWindowSize(windowSize);
 
-    // Step 1 & 2: Calculate difference function and cumulative mean normalized difference
-    yinBuffer[0] = 1.0f;
-    float runningSum = 0.0f;
+    const bool poly = isPolyphonic();
+    if (poly && preparedTuning != getTuning())
+    {
+        strumAnalyser.prepare(sampleRate, getTuning(), A4_FREQ);
+        preparedTuning = getTuning();
+    }
+
+    // The history covers the longest window in use; each analysis reads its tail
+    const int historySize = poly ? juce::jmax(windowSize, strumAnalyser.getWindowSize()) : windowSize;
+    if (static_cast<int>(history.size()) != historySize)
+        history.assign(static_cast<size_t>(historySize), 0.0f);
 
-    for (int tau = 1; tau < halfSize; ++tau)
+    int start1, size1, start2, size2;
+    inputFifo.prepareToRead(inputFifo.getNumReady(), start1, size1, start2, size2);
+    const int numNew = size1 + size2;
+
+    // Slide the newest samples into the history window
+    auto append = [this](const float* source, int count)
     {
-        float sum = 0.0f;
-        for (int j = 0; j < halfSize; ++j)
+        const int window = static_cast<int>(history.size());
+        if (count >= window)
         {
-            float delta = samples[j] - samples[j + tau];
-            sum += delta * delta;
+            std::copy(source + count - window, source + count, history.begin());
+            return;
         }
-
-        runningSum += sum;
-        yinBuffer[tau] = (runningSum > 0.0f) ? (sum * tau / runningSum) : 1.0f;
+        std::move(history.begin() + count, history.end(), history.begin());
+        std::copy(source, source + count, history.end() - count);
+    };
+    append(fifoBuffer.data() + start1, size1);
+    append(fifoBuffer.data() + start2, size2);
+    inputFifo.finishedRead(numNew);
+
+    samplesSinceStrumAnalysis += numNew;
+    if (poly && samplesSinceStrumAnalysis >= POLY_HOP)
+    {
+        samplesSinceStrumAnalysis = 0;
+        analyseStrum(history.data() + history.size() - strumAnalyser.getWindowSize());
     }
 
-    // Step 3: Absolute threshold
-    int tauEstimate = -1;
-    for (int tau = 2; tau < halfSize; ++tau)
+    samplesSinceAnalysis += numNew;
+    if (samplesSinceAnalysis < ANALYSIS_HOP)
+        return;
+
+    // One analysis covers however many hops arrived since the last one
+    const int numHops = samplesSinceAnalysis / ANALYSIS_HOP;
+    samplesSinceAnalysis -= numHops * ANALYSIS_HOP;
+
+    const float frequency = pitchDetector.detect(history.data() + history.size() - windowSize, sampleRate);
+
+    if (frequency > 20.0f && frequency < 5000.0f)
     {
-        if (yinBuffer[tau] < yinThreshold)
-        {
-            // Find local minimum
-            while (tau + 1 < halfSize && yinBuffer[tau + 1] < yinBuffer[tau])
-            {
-                ++tau;
-            }
-            tauEstimate = tau;
-            break;
-        }
+        detectedFrequency.store(frequency);
+        pitchDetected.store(true);
+        updateNoteAndCents(frequency);
+        updateStrobePhase(frequency, numHops);
     }
+    else
+    {
+        pitchDetected.store(false);
+        detectedNote.store(-1);
+        centsDeviation.store(0.0f);
+    }
+    displayVersion.bump();
+}
 
-    if (tauEstimate == -1)
-        return 0.0f;
+void TunerProcessor::analyseStrum(const float* samples)
+{
+    StrumAnalyser::Results results;
+    const int numStrings = strumAnalyser.analyse(samples, results);
 
-    // Step 4: Parabolic interpolation for better accuracy
-    float betterTau = static_cast<float>(tauEstimate);
-    if (tauEstimate > 0 && tauEstimate < halfSize - 1)
     {
-        float s0 = yinBuffer[tauEstimate - 1];
-        float s1 = yinBuffer[tauEstimate];
-        float s2 = yinBuffer[tauEstimate + 1];
-        betterTau = tauEstimate + (s2 - s0) / (2.0f * (2.0f * s1 - s2 - s0));
+        const SpinLock::ScopedLockType lock(resultsLock);
+        stringResults = results;
+        numStringResults = numStrings;
     }
+    displayVersion.bump();
+}
 
-    return static_cast<float>(sampleRate) / betterTau;
+int TunerProcessor::getStringResults(StrumAnalyser::Results& results) const
+{
+    const SpinLock::ScopedLockType lock(resultsLock);
+    results = stringResults;
+    return numStringResults;
 }
 
 //==============================================================================
@@ -153,7 +238,7 @@ void TunerProcessor::updateNoteAndCents(float frequency)
 }
 
 //==============================================================================
-void TunerProcessor::updateStrobePhase(float frequency)
+void TunerProcessor::updateStrobePhase(float frequency, int numHops)
 {
     // Calculate target frequency for the detected note
     int midiNote = detectedNote.load();
@@ -164,7 +249,7 @@ void TunerProcessor::updateStrobePhase(float frequency)
     float phaseRate = freqError * 0.01f; // Scale down for visible rotation
 
     float currentPhase = strobePhase.load();
-    currentPhase += phaseRate;
+    currentPhase += phaseRate * static_cast<float>(numHops);
 
     // Wrap phase to 0-1
     while (currentPhase >= 1.0f)
@@ -178,16 +263,24 @@ void TunerProcessor::updateStrobePhase(float frequency)
 //==============================================================================
 void TunerProcessor::getStateInformation(MemoryBlock& destData)
 {
-    // Save strobe mode preference if desired
     MemoryOutputStream stream(destData, false);
-    stream.writeInt(1); // version
+    stream.writeInt(3); // version
+    stream.writeInt(range.load());
+    stream.writeBool(polyphonic.load());
+    stream.writeInt(tuning.load());
 }
 
 void TunerProcessor::setStateInformation(const void* data, int sizeInBytes)
 {
     MemoryInputStream stream(data, static_cast<size_t>(sizeInBytes), false);
     int version = stream.readInt();
-    ignoreUnused(version);
+    if (version >= 2)
+        range.store(jlimit(0, static_cast<int>(Range::NumRanges) - 1, stream.readInt()));
+    if (version >= 3)
+    {
+        polyphonic.store(stream.readBool());
+        tuning.store(jlimit(0, static_cast<int>(StrumAnalyser::getTunings().size()) - 1, stream.readInt()));
+    }
 }
 
 //==============================================================================
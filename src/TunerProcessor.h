@@ -10,19 +10,41 @@
 #pragma once
 
 #include "PedalboardProcessors.h"
+#include "PitchDetector.h"
+#include "StrumAnalyser.h"
+#include "UiFrameScheduler.h"
 
-#include <array>
 #include <atomic>
+#include <memory>
+#include <vector>
 
 //==============================================================================
 /**
     Chromatic tuner with two modes:
     - Simple: YIN-based pitch detection (±2 cents)
     - Pro: Phase-based strobe for ±0.1 cent accuracy
+
+    The audio thread only copies input into a lock-free FIFO; pitch detection
+    (FFT-based YIN) runs on a per-tuner analysis thread. The analysis window
+    follows the selected range, so extended ranges (7-string low B, 5-string
+    bass low B) cost the audio thread nothing extra.
+
+    In polyphonic mode the same thread also runs a StrumAnalyser over a
+    longer window every POLY_HOP samples and publishes per-string results
+    for the selected tuning, so a single strum checks every string.
 */
 class TunerProcessor : public PedalboardProcessor
 {
   public:
+    /// Lowest string the tuner has to resolve; sets the analysis window
+    enum class Range
+    {
+        Guitar,      // Down to ~70 Hz (E2 and drop D)
+        SevenString, // Down to ~55 Hz (B1, A1)
+        Bass,        // Down to ~28 Hz (5-string B0)
+        NumRanges
+    };
+
     TunerProcessor();
     ~TunerProcessor();
 
@@ -43,6 +65,29 @@ class TunerProcessor : public PedalboardProcessor
     /// For strobe mode: phase accumulator (0-1)
     float getStrobePhase() const { return strobePhase.load(); }
 
+    /// Bumped each time the analysis thread publishes new results
+    const DisplayVersion& getDisplayVersion() const { return displayVersion; }
+
+    //==========================================================================
+    // Analysis range
+    void setRange(Range newRange) { range.store(static_cast<int>(newRange)); }
+    Range getRange() const { return static_cast<Range>(range.load()); }
+    static float getLowestFrequency(Range range);
+    static String getRangeName(Range range);
+
+    //==========================================================================
+    // Polyphonic (strum) mode
+    void setPolyphonic(bool shouldBePolyphonic) { polyphonic.store(shouldBePolyphonic); }
+    bool isPolyphonic() const { return polyphonic.load(); }
+
+    /// Index into StrumAnalyser::getTunings()
+    void setTuning(int index) { tuning.store(index); }
+    int getTuning() const { return tuning.load(); }
+
+    /// Copies the latest per-string results; returns the number of strings
+    /// (0 until the first polyphonic analysis).
+    int getStringResults(StrumAnalyser::Results& results) const;
+
     //==========================================================================
     // AudioProcessor overrides
     void fillInPluginDescription(PluginDescription& description) const override;
@@ -50,7 +95,7 @@ class TunerProcessor : public PedalboardProcessor
 
     const String getName() const override { return "Tuner"; }
     void prepareToPlay(double sampleRate, int estimatedSamplesPerBlock) override;
-    void releaseResources() override {}
+    void releaseResources() override;
 
     const String getInputChannelName(int channelIndex) const override { return ""; }
     const String getOutputChannelName(int channelIndex) const override { return ""; }
@@ -83,26 +128,43 @@ class TunerProcessor : public PedalboardProcessor
     void setMuteOutput(bool shouldMute) { muteOutput.store(shouldMute); }
 
   private:
+    class Analyser;
+
     std::atomic<bool> muteOutput{false};
 
     //==========================================================================
-    // YIN pitch detection
-    float detectPitchYIN(const float* samples, int numSamples);
+    // Analysis thread: drains the FIFO and publishes results
+    void analysePendingInput();
+    void analyseStrum(const float* samples);
 
     // Calculate cents deviation from nearest note
     void updateNoteAndCents(float frequency);
 
-    // Update strobe phase based on frequency error
-    void updateStrobePhase(float frequency);
+    // Update strobe phase based on frequency error, advanced by numHops
+    void updateStrobePhase(float frequency, int numHops);
 
     //==========================================================================
-    // Audio buffer for analysis
-    static constexpr int BUFFER_SIZE = 2048;
-    std::array<float, BUFFER_SIZE> analysisBuffer;
-    int bufferWritePos = 0;
-
-    // YIN working arrays
-    std::array<float, BUFFER_SIZE / 2> yinBuffer;
+    // Audio thread -> analysis thread
+    static constexpr int FIFO_SIZE = 32768;
+    AbstractFifo inputFifo{FIFO_SIZE};
+    std::vector<float> fifoBuffer;
+    std::unique_ptr<Analyser> analyser;
+
+    // Analysis thread only
+    PitchDetector pitchDetector;
+    std::vector<float> history; // Last window of input, oldest first
+    int samplesSinceAnalysis = 0;
+    std::atomic<int> range{static_cast<int>(Range::Guitar)};
+
+    // Polyphonic mode (analysis thread, results published under resultsLock)
+    std::atomic<bool> polyphonic{false};
+    std::atomic<int> tuning{0};
+    StrumAnalyser strumAnalyser;
+    int preparedTuning = -1;
+    int samplesSinceStrumAnalysis = 0;
+    mutable SpinLock resultsLock;
+    StrumAnalyser::Results stringResults;
+    int numStringResults = 0;
 
     // Detection results (atomic for thread safety)
     std::atomic<float> detectedFrequency{0.0f};
@@ -110,11 +172,12 @@ class TunerProcessor : public PedalboardProcessor
     std::atomic<int> detectedNote{-1};
     std::atomic<bool> pitchDetected{false};
     std::atomic<float> strobePhase{0.0f};
+    DisplayVersion displayVersion;
 
     // Processing state
     double sampleRate = 44100.0;
-    int samplesUntilNextAnalysis = 0;
     static constexpr int ANALYSIS_HOP = 512;
+    static constexpr int POLY_HOP = 4096;
 
     // Tuning reference (A4 = 440 Hz)
     static constexpr float A4_FREQ = 440.0f;
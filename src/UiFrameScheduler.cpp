@@ -0,0 +1,84 @@
+/*
+  ==============================================================================
+
+    UiFrameScheduler.cpp
+    One display-refresh driven tick for every meter and live display
+
+  ==============================================================================
+*/
+
+#include "UiFrameScheduler.h"
+
+namespace
+{
+/// False if the component is hidden, or clipped away by its parents (e.g. scrolled out of a viewport)
+bool isOnScreen(const juce::Component& component)
+{
+    if (!component.isShowing())
+        return false;
+
+    auto area = component.getLocalBounds();
+    for (auto* child = &component; auto* parent = child->getParentComponent(); child = parent)
+    {
+        area = parent->getLocalArea(child, area).getIntersection(parent->getLocalBounds());
+        if (area.isEmpty())
+            return false;
+    }
+    return true;
+}
+} // namespace
+
+//==============================================================================
+UiFrameScheduler::Client::Client(juce::Component* ownerComponent, double maxHz, std::function<void()> callback,
+                                 UiFrameScheduler& schedulerToUse)
+    : scheduler(schedulerToUse), owner(ownerComponent), hasOwner(ownerComponent != nullptr),
+      onFrame(std::move(callback))
+{
+    setMaxHz(maxHz);
+    scheduler.clients.add(this);
+}
+
+UiFrameScheduler::Client::~Client()
+{
+    scheduler.clients.remove(this);
+}
+
+void UiFrameScheduler::Client::setMaxHz(double newMaxHz)
+{
+    intervalMs = newMaxHz > 0.0 ? 1000.0 / newMaxHz : 0.0;
+}
+
+void UiFrameScheduler::Client::frame(double nowMs)
+{
+    if (nowMs < nextDueMs)
+        return;
+
+    // Keep to the requested rate on average at any refresh rate, but don't try to catch up after a stall
+    nextDueMs = nowMs - nextDueMs > intervalMs ? nowMs + intervalMs : nextDueMs + intervalMs;
+
+    if (hasOwner && (owner == nullptr || !isOnScreen(*owner)))
+        return;
+
+    onFrame();
+}
+
+//==============================================================================
+UiFrameScheduler& UiFrameScheduler::getInstance()
+{
+    static UiFrameScheduler instance;
+    return instance;
+}
+
+void UiFrameScheduler::attachTo(juce::Component* component)
+{
+    vBlank.reset();
+    if (component != nullptr)
+        vBlank = std::make_unique<juce::VBlankAttachment>(
+            component, [this]() { dispatchFrame(juce::Time::getMillisecondCounterHiRes()); });
+}
+
+void UiFrameScheduler::dispatchFrame(double nowMs)
+{
+    // A client can delete others (or itself) from its callback
+    clients.call([nowMs](Client& client) { client.frame(nowMs); });
+}
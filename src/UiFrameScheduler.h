@@ -0,0 +1,108 @@
+/*
+  ==============================================================================
+
+    UiFrameScheduler.h
+    One display-refresh driven tick for every meter and live display
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+
+//==============================================================================
+/**
+    A counter the producer of some display data (usually the audio or
+    analysis thread) bumps each time it publishes, so the UI can tell whether
+    there is anything new to draw without reading the data itself.
+*/
+class DisplayVersion
+{
+  public:
+    /// Producer side. Lock-free and allocation-free.
+    void bump() noexcept { count.fetch_add(1, std::memory_order_release); }
+
+    juce::uint32 get() const noexcept { return count.load(std::memory_order_acquire); }
+
+    /// UI side: true (and lastSeen updated) if there has been a bump since lastSeen
+    bool changedSince(juce::uint32& lastSeen) const noexcept
+    {
+        const auto current = get();
+        if (current == lastSeen)
+            return false;
+        lastSeen = current;
+        return true;
+    }
+
+  private:
+    std::atomic<juce::uint32> count{0};
+};
+
+//==============================================================================
+/**
+    Drives every meter, tuner, scope and node refresh from a single
+    VBlankAttachment on the main window, in place of a Timer each.
+
+    Each display registers a Client with the most updates a second it needs
+    (0 for every frame). On each display refresh the scheduler calls the
+    clients that are due and whose owner is on screen; a client checks its
+    DisplayVersion or cached values and repaints only what changed. Hidden
+    editors, displays scrolled out of view, and every client while the window
+    is minimised, cost nothing.
+
+    Message thread only.
+*/
+class UiFrameScheduler
+{
+  public:
+    //==========================================================================
+    class Client
+    {
+      public:
+        /// owner may be null, for a client that isn't tied to a component
+        Client(juce::Component* owner, double maxHz, std::function<void()> onFrame,
+               UiFrameScheduler& scheduler = UiFrameScheduler::getInstance());
+        ~Client();
+
+        void setMaxHz(double newMaxHz);
+
+      private:
+        friend class UiFrameScheduler;
+
+        /// Calls onFrame if the client is due and its owner is on screen
+        void frame(double nowMs);
+
+        UiFrameScheduler& scheduler;
+        juce::Component::SafePointer<juce::Component> owner;
+        const bool hasOwner;
+        std::function<void()> onFrame;
+        double intervalMs = 0.0;
+        double nextDueMs = 0.0;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Client)
+    };
+
+    UiFrameScheduler() = default;
+    ~UiFrameScheduler() = default;
+
+    static UiFrameScheduler& getInstance();
+
+    /// Follows component's display refresh; null stops the frames
+    void attachTo(juce::Component* component);
+
+    /// Runs one frame. Called by the attachment; public for tests.
+    void dispatchFrame(double nowMs);
+
+    int getNumClients() const { return clients.size(); }
+
+  private:
+    juce::ListenerList<Client> clients;
+    std::unique_ptr<juce::VBlankAttachment> vBlank;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(UiFrameScheduler)
+};
@@ -26,10 +26,8 @@ using namespace std;
 
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
-VuMeterControl::VuMeterControl(VuMeterProcessor* proc) : processor(proc), levelLeft(0.0f), levelRight(0.0f)
+VuMeterControl::VuMeterControl(VuMeterProcessor* proc) : processor(proc), levelLeft(-60.0f), levelRight(-60.0f)
 {
-    startTimer(60);
-
     setSize(64, 128);
 }
 
@@ -114,23 +112,23 @@ void VuMeterControl::paint(Graphics& g)
 void VuMeterControl::resized() {}
 
 //------------------------------------------------------------------------------
-void VuMeterControl::timerCallback()
+void VuMeterControl::updateLevels()
 {
-    if (processor)
+    if (processor && processor->getDisplayVersion().changedSince(lastVersion))
     {
         float levLeft = processor->getLeftLevel();
         float levRight = processor->getRightLevel();
         const float minus60 = powf(10.0f, (-60.0f / 20.0f));
 
-        if (levLeft > minus60)
-            levelLeft = 20.0f * log10f(levLeft);
-        else
-            levelLeft = -60.0f;
+        levLeft = (levLeft > minus60) ? 20.0f * log10f(levLeft) : -60.0f;
+        levRight = (levRight > minus60) ? 20.0f * log10f(levRight) : -60.0f;
+
+        // A tenth of a dB is less than a pixel at any meter size.
+        if ((fabsf(levLeft - levelLeft) < 0.1f) && (fabsf(levRight - levelRight) < 0.1f))
+            return;
 
-        if (levRight > minus60)
-            levelRight = 20.0f * log10f(levRight);
-        else
-            levelRight = -60.0f;
+        levelLeft = levLeft;
+        levelRight = levRight;
 
         repaint();
     }
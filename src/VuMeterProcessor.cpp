@@ -98,6 +98,7 @@ void VuMeterProcessor::processBlock(AudioSampleBuffer& buffer, MidiBuffer& midiM
 
     levelLeft.store(curLeft);
     levelRight.store(curRight);
+    displayVersion.bump();
 }
 
 //------------------------------------------------------------------------------
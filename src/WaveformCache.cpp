@@ -0,0 +1,580 @@
+/*
+  ==============================================================================
+
+    WaveformCache.cpp
+    Waveform overviews of audio files, built in the background and kept on disk
+
+  ==============================================================================
+*/
+
+#include "WaveformCache.h"
+
+#include "AudioSingletons.h"
+#include "DiskIOScheduler.h"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <limits>
+
+namespace
+{
+constexpr int fileMagic = 0x46574250; // "PBWF"
+constexpr int fileVersion = 1;
+constexpr int sourceMagic = 0x53574250; // "PBWS": the cache file's header, ahead of the pyramid
+constexpr const char* fileExtension = ".pbwf";
+constexpr int maxFileChannels = 64;
+
+constexpr int chunkSamples = 65536; // Per time slice, so the thread can back off between them
+constexpr int busyWaitMs = 10;
+constexpr int idleWaitMs = 500; // get() wakes the worker when there's something to do
+constexpr int stopTimeoutMs = 2000;
+
+juce::int8 toByte(float sample)
+{
+    return static_cast<juce::int8>(juce::roundToInt(juce::jlimit(-1.0f, 1.0f, sample) * 127.0f));
+}
+
+/// FNV-1a, continued from hash
+juce::uint64 hashBytes(const void* data, size_t numBytes, juce::uint64 hash = 0xcbf29ce484222325ull)
+{
+    const auto* bytes = static_cast<const juce::uint8*>(data);
+    for (size_t i = 0; i < numBytes; ++i)
+        hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+    return hash;
+}
+} // namespace
+
+//==============================================================================
+WaveformPyramid::WaveformPyramid(int channels, double rate)
+    : numChannels(channels), sampleRate(rate), levels(1), binMin(static_cast<size_t>(channels)),
+      binMax(static_cast<size_t>(channels))
+{
+}
+
+void WaveformPyramid::addBlock(const juce::AudioBuffer<float>& block, int numSamplesInBlock)
+{
+    const int channels = juce::jmin(numChannels, block.getNumChannels());
+
+    for (int i = 0; i < numSamplesInBlock;)
+    {
+        const int todo = juce::jmin(numSamplesInBlock - i, baseSamplesPerBin - binCount);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            // Channels the block doesn't have are silent
+            const auto range =
+                ch < channels ? juce::FloatVectorOperations::findMinAndMax(block.getReadPointer(ch, i), todo)
+                              : juce::Range<float>();
+            const auto c = static_cast<size_t>(ch);
+            binMin[c] = binCount == 0 ? range.getStart() : juce::jmin(binMin[c], range.getStart());
+            binMax[c] = binCount == 0 ? range.getEnd() : juce::jmax(binMax[c], range.getEnd());
+        }
+
+        binCount += todo;
+        numSamples += todo;
+        i += todo;
+
+        if (binCount == baseSamplesPerBin)
+            addBin();
+    }
+}
+
+void WaveformPyramid::finish()
+{
+    if (binCount > 0)
+        addBin();
+    buildLevels();
+}
+
+void WaveformPyramid::addBin()
+{
+    auto& base = levels.front();
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        base.data.push_back(toByte(binMin[static_cast<size_t>(ch)]));
+        base.data.push_back(toByte(binMax[static_cast<size_t>(ch)]));
+    }
+    ++base.numBins;
+    binCount = 0;
+}
+
+void WaveformPyramid::buildLevels()
+{
+    levels.resize(1);
+    if (numChannels <= 0)
+        return;
+
+    const size_t stride = static_cast<size_t>(numChannels) * 2;
+    while (levels.back().numBins > 1)
+    {
+        const auto& fine = levels.back();
+
+        Level coarse;
+        coarse.numBins = (fine.numBins + 1) / 2;
+        coarse.data.resize(static_cast<size_t>(coarse.numBins) * stride);
+
+        for (juce::int64 bin = 0; bin < coarse.numBins; ++bin)
+        {
+            const auto* a = fine.data.data() + static_cast<size_t>(bin * 2) * stride;
+            // An odd bin out at the end stands alone
+            const auto* b = bin * 2 + 1 < fine.numBins ? a + stride : a;
+            auto* out = coarse.data.data() + static_cast<size_t>(bin) * stride;
+
+            for (size_t i = 0; i < stride; i += 2)
+            {
+                out[i] = juce::jmin(a[i], b[i]);
+                out[i + 1] = juce::jmax(a[i + 1], b[i + 1]);
+            }
+        }
+
+        levels.push_back(std::move(coarse));
+    }
+}
+
+//==============================================================================
+juce::Range<float> WaveformPyramid::getRange(int channel, juce::int64 startSample, juce::int64 endSample) const
+{
+    if (levels.empty() || levels.front().numBins == 0 || endSample <= startSample || channel < 0 ||
+        channel >= numChannels)
+        return {};
+
+    // The coarsest level whose bins are no wider than the span, so only a few bins are read
+    int level = 0;
+    while (level + 1 < getNumLevels() && getSamplesPerBin(level + 1) <= endSample - startSample)
+        ++level;
+
+    const auto& l = levels[static_cast<size_t>(level)];
+    const auto samplesPerBin = getSamplesPerBin(level);
+    const auto first = juce::jlimit<juce::int64>(0, l.numBins - 1, startSample / samplesPerBin);
+    const auto last = juce::jlimit<juce::int64>(first, l.numBins - 1, (endSample - 1) / samplesPerBin);
+
+    int low = std::numeric_limits<juce::int8>::max();
+    int high = std::numeric_limits<juce::int8>::min();
+    for (auto bin = first; bin <= last; ++bin)
+    {
+        const auto index = static_cast<size_t>((bin * numChannels + channel) * 2);
+        low = juce::jmin(low, static_cast<int>(l.data[index]));
+        high = juce::jmax(high, static_cast<int>(l.data[index + 1]));
+    }
+    return {static_cast<float>(low) / 127.0f, static_cast<float>(high) / 127.0f};
+}
+
+void WaveformPyramid::drawChannels(juce::Graphics& g, juce::Rectangle<int> area, double startSeconds,
+                                   double endSeconds) const
+{
+    const auto clip = g.getClipBounds().getIntersection(area);
+    if (numChannels <= 0 || clip.isEmpty() || endSeconds <= startSeconds)
+        return;
+
+    const double firstSample = startSeconds * sampleRate;
+    const double samplesPerPixel = (endSeconds - startSeconds) * sampleRate / area.getWidth();
+    const float channelHeight = static_cast<float>(area.getHeight()) / static_cast<float>(numChannels);
+
+    juce::RectangleList<float> waveform;
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        const float halfHeight = channelHeight * 0.5f;
+        const float centreY = static_cast<float>(area.getY()) + channelHeight * static_cast<float>(ch) + halfHeight;
+
+        for (int x = clip.getX(); x < clip.getRight(); ++x)
+        {
+            const auto offset = static_cast<double>(x - area.getX());
+            const auto start = static_cast<juce::int64>(firstSample + offset * samplesPerPixel);
+            const auto next = static_cast<juce::int64>(firstSample + (offset + 1.0) * samplesPerPixel);
+            const auto end = juce::jmax(start + 1, next);
+            if (start >= numSamples)
+                break;
+
+            const auto range = getRange(ch, start, end);
+            const float top = centreY - range.getEnd() * halfHeight;
+            const float bottom = centreY - range.getStart() * halfHeight;
+            waveform.addWithoutMerging({static_cast<float>(x), top, 1.0f, juce::jmax(1.0f, bottom - top)});
+        }
+    }
+    g.fillRectList(waveform);
+}
+
+size_t WaveformPyramid::getMemoryUsage() const
+{
+    size_t bytes = 0;
+    for (const auto& level : levels)
+        bytes += level.data.size();
+    return bytes;
+}
+
+//==============================================================================
+void WaveformPyramid::writeTo(juce::OutputStream& out) const
+{
+    out.writeInt(fileMagic);
+    out.writeInt(fileVersion);
+    out.writeInt(numChannels);
+    out.writeDouble(sampleRate);
+    out.writeInt64(numSamples);
+    out.writeInt(baseSamplesPerBin);
+
+    const auto& base = levels.front();
+    out.writeInt64(base.numBins);
+    out.write(base.data.data(), base.data.size());
+}
+
+bool WaveformPyramid::readFrom(juce::InputStream& in)
+{
+    *this = {};
+
+    if (in.readInt() != fileMagic || in.readInt() != fileVersion)
+        return false;
+
+    const int channels = in.readInt();
+    const double rate = in.readDouble();
+    const auto samples = in.readInt64();
+    const int samplesPerBin = in.readInt();
+    const auto bins = in.readInt64();
+
+    if (channels < 1 || channels > maxFileChannels || rate <= 0.0 || samples < 0 ||
+        samplesPerBin != baseSamplesPerBin || bins != (samples + baseSamplesPerBin - 1) / baseSamplesPerBin ||
+        bins > std::numeric_limits<int>::max() / (channels * 2))
+        return false;
+
+    Level base;
+    base.numBins = bins;
+    base.data.resize(static_cast<size_t>(bins * channels * 2));
+    if (in.read(base.data.data(), static_cast<int>(base.data.size())) != static_cast<int>(base.data.size()))
+        return false;
+
+    *this = WaveformPyramid(channels, rate);
+    numSamples = samples;
+    levels.front() = std::move(base);
+    buildLevels();
+    return true;
+}
+
+//==============================================================================
+WaveformCache& WaveformCache::getInstance()
+{
+    static WaveformCache instance;
+    return instance;
+}
+
+WaveformCache::WaveformCache()
+{
+    worker.addTimeSliceClient(this);
+    worker.startThread(juce::Thread::Priority::low);
+}
+
+WaveformCache::~WaveformCache()
+{
+    shutdown();
+}
+
+void WaveformCache::shutdown()
+{
+    worker.stopThread(stopTimeoutMs);
+    reader.reset();
+}
+
+//==============================================================================
+void WaveformCache::setDirectory(const juce::File& newDirectory)
+{
+    const juce::ScopedLock sl(lock);
+    directory = newDirectory;
+    pruneNeeded = true;
+}
+
+juce::File WaveformCache::getDirectory() const
+{
+    const juce::ScopedLock sl(lock);
+    if (directory != juce::File())
+        return directory;
+    return juce::File::getSpecialLocation(juce::File::tempDirectory).getChildFile("Pedalboard3 Waveforms");
+}
+
+void WaveformCache::setDiskLimit(juce::int64 bytes)
+{
+    const juce::ScopedLock sl(lock);
+    diskLimit = bytes;
+    pruneNeeded = true;
+}
+
+//==============================================================================
+std::shared_ptr<const WaveformPyramid> WaveformCache::get(const juce::File& file)
+{
+    if (!file.existsAsFile())
+        return nullptr;
+
+    {
+        const juce::ScopedLock sl(lock);
+
+        // A file that couldn't be read has an entry too, so it isn't tried again until it changes
+        if (auto* entry = find(file))
+            return entry->pyramid;
+
+        const bool queued = std::find(queue.begin(), queue.end(), file) != queue.end();
+        if (queued || (jobRunning && jobFile == file))
+            return nullptr;
+
+        queue.push_back(file);
+    }
+
+    worker.notify();
+    return nullptr;
+}
+
+bool WaveformCache::isBusy() const
+{
+    const juce::ScopedLock sl(lock);
+    return !queue.empty() || jobRunning;
+}
+
+void WaveformCache::clear()
+{
+    const juce::ScopedLock sl(lock);
+    entries.clear();
+    queue.clear();
+}
+
+juce::String WaveformCache::getFileHash(const juce::File& file)
+{
+    juce::FileInputStream in(file);
+    if (!in.openedOk())
+        return {};
+
+    const auto size = in.getTotalLength();
+    juce::MemoryBlock data;
+    in.readIntoMemoryBlock(data, hashedBytes);
+    if (size > hashedBytes)
+    {
+        in.setPosition(juce::jmax<juce::int64>(hashedBytes, size - hashedBytes));
+        in.readIntoMemoryBlock(data, hashedBytes);
+    }
+
+    const auto hash = hashBytes(data.getData(), data.getSize(), hashBytes(&size, sizeof(size)));
+    return juce::String::toHexString(size) + "-" + juce::String::toHexString(static_cast<juce::int64>(hash));
+}
+
+//==============================================================================
+int WaveformCache::useTimeSlice()
+{
+    // Overviews can always wait for a stream that's running low
+    if (DiskIOScheduler::getInstance().isThrottlingThumbnails())
+        return busyWaitMs;
+
+    if (reader != nullptr)
+    {
+        buildNextChunk();
+        return 0;
+    }
+
+    bool prune;
+    {
+        const juce::ScopedLock sl(lock);
+        prune = pruneNeeded;
+    }
+    if (prune)
+        pruneDirectory();
+
+    return startNextJob() ? 0 : idleWaitMs;
+}
+
+bool WaveformCache::startNextJob()
+{
+    {
+        const juce::ScopedLock sl(lock);
+        if (queue.empty())
+        {
+            jobRunning = false;
+            return false;
+        }
+
+        jobFile = queue.front();
+        queue.erase(queue.begin());
+        jobRunning = true;
+    }
+
+    // Taken before the file is read, so an edit made while it's being built isn't masked
+    jobModified = jobFile.getLastModificationTime();
+    jobSize = jobFile.getSize();
+    jobHash = getFileHash(jobFile);
+
+    // Saved by an earlier session, or under another name. The hash only samples the file, so
+    // an edit in the middle keeps it; the size and modification time saved alongside catch that.
+    const auto cacheFile = getCacheFile(jobHash);
+    if (jobHash.isNotEmpty() && cacheFile.existsAsFile())
+    {
+        juce::FileInputStream fileIn(cacheFile);
+        juce::GZIPDecompressorInputStream in(fileIn);
+
+        const bool hasHeader = fileIn.openedOk() && in.readInt() == sourceMagic;
+        const auto size = hasHeader ? in.readInt64() : 0;
+        const auto modified = hasHeader ? in.readInt64() : 0;
+        const bool current = hasHeader && size == jobSize && modified == jobModified.toMilliseconds();
+
+        auto pyramid = std::make_shared<WaveformPyramid>();
+        if (current && pyramid->readFrom(in))
+        {
+            // Pruning goes by modification time, so this counts as a use
+            cacheFile.setLastModificationTime(juce::Time::getCurrentTime());
+            finishJob(std::move(pyramid), false);
+            return true;
+        }
+
+        if (hasHeader && !current)
+        {
+            // Rebuilt below, and saved over it
+            spdlog::debug("[WaveformCache] {} is out of date", cacheFile.getFileName().toStdString());
+        }
+        else
+        {
+            spdlog::warn("[WaveformCache] Discarding unreadable {}", cacheFile.getFileName().toStdString());
+            cacheFile.deleteFile();
+        }
+    }
+
+    reader.reset(AudioFormatManagerSingleton::getInstance().createReaderFor(jobFile));
+    if (reader == nullptr || reader->sampleRate <= 0.0 || reader->numChannels == 0)
+    {
+        reader.reset();
+        finishJob(nullptr, false);
+        return true;
+    }
+
+    spdlog::debug("[WaveformCache] Building {}", jobFile.getFileName().toStdString());
+    building = std::make_shared<WaveformPyramid>(static_cast<int>(reader->numChannels), reader->sampleRate);
+    readBuffer.setSize(static_cast<int>(reader->numChannels), chunkSamples, false, false, true);
+    readPosition = 0;
+    return true;
+}
+
+void WaveformCache::buildNextChunk()
+{
+    const auto remaining = reader->lengthInSamples - readPosition;
+    const int numToRead = static_cast<int>(juce::jmin<juce::int64>(chunkSamples, remaining));
+
+    const bool read = numToRead > 0 && reader->read(&readBuffer, 0, numToRead, readPosition, true, true);
+    if (read)
+    {
+        building->addBlock(readBuffer, numToRead);
+        readPosition += numToRead;
+    }
+
+    if (!read || readPosition >= reader->lengthInSamples)
+    {
+        reader.reset();
+        building->finish();
+        finishJob(std::move(building), jobHash.isNotEmpty());
+    }
+}
+
+void WaveformCache::finishJob(std::shared_ptr<WaveformPyramid> pyramid, bool save)
+{
+    if (pyramid != nullptr && save)
+    {
+        const auto cacheFile = getCacheFile(jobHash);
+        cacheFile.getParentDirectory().createDirectory();
+
+        // Written to a temporary first, so a crash can't leave half a file to be read next time
+        juce::TemporaryFile temp(cacheFile);
+        {
+            juce::FileOutputStream fileOut(temp.getFile());
+            if (fileOut.openedOk())
+            {
+                juce::GZIPCompressorOutputStream out(fileOut);
+                out.writeInt(sourceMagic);
+                out.writeInt64(jobSize);
+                out.writeInt64(jobModified.toMilliseconds());
+                pyramid->writeTo(out);
+            }
+        }
+
+        if (temp.overwriteTargetFileWithTemporary())
+            spdlog::debug("[WaveformCache] Saved {} ({} bytes)", cacheFile.getFileName().toStdString(),
+                          cacheFile.getSize());
+        else
+            spdlog::warn("[WaveformCache] Could not save {}", cacheFile.getFullPathName().toStdString());
+    }
+
+    const bool ready = pyramid != nullptr;
+
+    Entry entry;
+    entry.pyramid = std::move(pyramid);
+    entry.modified = jobModified;
+    entry.fileSize = jobSize;
+
+    {
+        const juce::ScopedLock sl(lock);
+        entry.lastUsed = ++useCounter;
+        entries[jobFile.getFullPathName()] = std::move(entry);
+
+        while (static_cast<int>(entries.size()) > maxEntries)
+        {
+            auto oldest = std::min_element(entries.begin(), entries.end(), [](const auto& a, const auto& b) {
+                return a.second.lastUsed < b.second.lastUsed;
+            });
+            entries.erase(oldest);
+        }
+
+        jobRunning = false;
+        if (save)
+            pruneNeeded = true;
+    }
+
+    if (ready)
+        sendChangeMessage();
+}
+
+//==============================================================================
+juce::File WaveformCache::getCacheFile(const juce::String& hash) const
+{
+    return getDirectory().getChildFile(hash + fileExtension);
+}
+
+void WaveformCache::pruneDirectory()
+{
+    juce::File folder;
+    juce::int64 limit = 0;
+    {
+        const juce::ScopedLock sl(lock);
+        pruneNeeded = false;
+        folder = getDirectory();
+        limit = diskLimit;
+    }
+
+    auto files = folder.findChildFiles(juce::File::findFiles, false, juce::String("*") + fileExtension);
+    juce::int64 total = 0;
+    for (const auto& file : files)
+        total += file.getSize();
+    if (total <= limit)
+        return;
+
+    // Least recently used first
+    std::sort(files.begin(), files.end(), [](const juce::File& a, const juce::File& b) {
+        return a.getLastModificationTime() < b.getLastModificationTime();
+    });
+
+    int deleted = 0;
+    for (const auto& file : files)
+    {
+        if (total <= limit)
+            break;
+        total -= file.getSize();
+        file.deleteFile();
+        ++deleted;
+    }
+    spdlog::info("[WaveformCache] Pruned {} cached waveforms", deleted);
+}
+
+WaveformCache::Entry* WaveformCache::find(const juce::File& file)
+{
+    auto it = entries.find(file.getFullPathName());
+    if (it == entries.end())
+        return nullptr;
+
+    if (file.getLastModificationTime() != it->second.modified || file.getSize() != it->second.fileSize)
+    {
+        entries.erase(it);
+        return nullptr;
+    }
+
+    it->second.lastUsed = ++useCounter;
+    return &it->second;
+}
@@ -0,0 +1,196 @@
+/*
+  ==============================================================================
+
+    WaveformCache.h
+    Waveform overviews of audio files, built in the background and kept on disk
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <juce_graphics/juce_graphics.h>
+
+#include <map>
+#include <memory>
+#include <vector>
+
+//==============================================================================
+/**
+    The min/max overview of an audio file at every zoom, for drawing.
+
+    The finest level holds one 8-bit min/max pair per channel for every
+    baseSamplesPerBin samples; each level above halves the resolution, so any
+    view reads at most a couple of pairs per pixel whatever its length. Only
+    the finest level is saved, and the rest are rebuilt on load, which is
+    quicker than reading them.
+*/
+class WaveformPyramid
+{
+  public:
+    static constexpr int baseSamplesPerBin = 256;
+
+    WaveformPyramid() = default;
+    WaveformPyramid(int numChannels, double sampleRate);
+
+    //==========================================================================
+    // Building
+
+    /// Adds the next numSamples of the file
+    void addBlock(const juce::AudioBuffer<float>& block, int numSamples);
+    /// Closes the last bin and builds the coarser levels. Call once every block is in.
+    void finish();
+
+    //==========================================================================
+    // Reading
+
+    int getNumChannels() const { return numChannels; }
+    double getSampleRate() const { return sampleRate; }
+    juce::int64 getNumSamples() const { return numSamples; }
+    double getLengthSeconds() const { return sampleRate > 0.0 ? static_cast<double>(numSamples) / sampleRate : 0.0; }
+
+    int getNumLevels() const { return static_cast<int>(levels.size()); }
+    juce::int64 getNumBins(int level) const { return levels[static_cast<size_t>(level)].numBins; }
+    static juce::int64 getSamplesPerBin(int level) { return static_cast<juce::int64>(baseSamplesPerBin) << level; }
+
+    /// The lowest and highest sample of channel over [startSample, endSample), read from the
+    /// coarsest level that still resolves that span
+    juce::Range<float> getRange(int channel, juce::int64 startSample, juce::int64 endSample) const;
+
+    /// Draws each channel in its own strip of area, in the current colour
+    void drawChannels(juce::Graphics& g, juce::Rectangle<int> area, double startSeconds, double endSeconds) const;
+
+    size_t getMemoryUsage() const;
+
+    //==========================================================================
+    // Storage
+
+    void writeTo(juce::OutputStream& out) const;
+    /// False (and left empty) if the stream doesn't hold a valid pyramid
+    bool readFrom(juce::InputStream& in);
+
+  private:
+    struct Level
+    {
+        /// Per bin, per channel: min then max
+        std::vector<juce::int8> data;
+        juce::int64 numBins = 0;
+    };
+
+    void addBin();
+    void buildLevels();
+
+    int numChannels = 0;
+    double sampleRate = 0.0;
+    juce::int64 numSamples = 0;
+    std::vector<Level> levels;
+
+    // The finest-level bin being filled
+    std::vector<float> binMin, binMax;
+    int binCount = 0;
+};
+
+//==============================================================================
+/**
+    Builds WaveformPyramids for the File Player and Looper displays, and saves
+    them so a file's waveform shows the moment it's opened again.
+
+    Files are read on a low-priority thread of their own, a slice at a time,
+    and the work backs off while any disk stream is starved (see
+    DiskIOScheduler), so a long backing track can't hold up recording or
+    playback. Finished pyramids are kept in memory, least recently used
+    first, and written to the cache folder named by the file's hash, so the
+    same audio is found again after a move or rename. The hash only samples
+    the file, so the file's size and modification time are saved with the
+    pyramid, and an edited or re-recorded file is rebuilt even if its hash
+    hasn't changed.
+
+    A change message is sent whenever a pyramid is ready.
+*/
+class WaveformCache : public juce::ChangeBroadcaster, private juce::TimeSliceClient
+{
+  public:
+    static constexpr int maxEntries = 16;
+    static constexpr juce::int64 defaultDiskLimit = static_cast<juce::int64>(256) * 1024 * 1024;
+    /// Bytes hashed from each end of a file for its cache key
+    static constexpr int hashedBytes = 64 * 1024;
+
+    static WaveformCache& getInstance();
+
+    /// Stops the worker. Call once at exit, before the AudioFormatManager
+    /// singleton is killed.
+    void shutdown();
+
+    //==========================================================================
+    // Configuration
+
+    /// Where pyramids are saved; the temp folder until this is set
+    void setDirectory(const juce::File& newDirectory);
+    juce::File getDirectory() const;
+
+    /// Oldest files are deleted once the folder grows past this
+    void setDiskLimit(juce::int64 bytes);
+
+    //==========================================================================
+    // Lookup (message thread)
+
+    /// The pyramid for file if it's ready; otherwise queues it and returns nullptr
+    std::shared_ptr<const WaveformPyramid> get(const juce::File& file);
+
+    /// True while queued files are outstanding
+    bool isBusy() const;
+
+    /// Drops the pyramids held in memory, and any queued work. The disk cache is kept.
+    void clear();
+
+    /// The file's cache key: a hash of its size and its first and last hashedBytes
+    static juce::String getFileHash(const juce::File& file);
+
+  private:
+    WaveformCache();
+    ~WaveformCache() override;
+
+    struct Entry
+    {
+        std::shared_ptr<const WaveformPyramid> pyramid;
+        juce::Time modified; // Of the file, so edits on disk aren't masked
+        juce::int64 fileSize = 0;
+        juce::uint32 lastUsed = 0;
+    };
+
+    int useTimeSlice() override;
+    /// Starts the next queued file, or returns false if there's nothing to do
+    bool startNextJob();
+    /// Reads the next chunk of the file being built
+    void buildNextChunk();
+    /// Keeps the finished pyramid, in memory and (if built here) on disk
+    void finishJob(std::shared_ptr<WaveformPyramid> pyramid, bool save);
+
+    juce::File getCacheFile(const juce::String& hash) const;
+    void pruneDirectory();
+    Entry* find(const juce::File& file);
+
+    juce::TimeSliceThread worker{"Waveform cache"};
+
+    // The file being built (worker thread only)
+    juce::File jobFile;
+    juce::String jobHash;
+    juce::Time jobModified;
+    juce::int64 jobSize = 0;
+    std::unique_ptr<juce::AudioFormatReader> reader;
+    std::shared_ptr<WaveformPyramid> building;
+    juce::AudioBuffer<float> readBuffer;
+    juce::int64 readPosition = 0;
+
+    mutable juce::CriticalSection lock;
+    std::map<juce::String, Entry> entries; // By full path
+    std::vector<juce::File> queue;
+    juce::File directory;
+    juce::int64 diskLimit = defaultDiskLimit;
+    juce::uint32 useCounter = 0;
+    bool jobRunning = false;
+    bool pruneNeeded = true;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WaveformCache)
+};
@@ -18,39 +18,35 @@
 //	----------------------------------------------------------------------------
 
 #include "WaveformDisplay.h"
-#include "AudioSingletons.h"
 #include "ColourScheme.h"
+#include "WaveformCache.h"
 
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
 WaveformDisplay::WaveformDisplay(AudioThumbnail *thumb, bool deleteThumb):
-/*thumbnail(512,
-		  AudioFormatManagerSingleton::getInstance(),
-		  AudioThumbnailCacheSingleton::getInstance()),*/
+thumbnail(thumb),
 readPointer(0.0f),
 newReadPointer(0.0f),
 backgroundColour(ColourScheme::getInstance().colours["Window Background"]),
 deleteThumbnail(deleteThumb)
 {
-	if(thumb)
-		thumbnail = thumb;
-	else
-	{
-		thumbnail = new AudioThumbnail(512,
-									   AudioFormatManagerSingleton::getInstance(),
-									   AudioThumbnailCacheSingleton::getInstance());
-	}
-	thumbnail->addChangeListener(this);
+	if(thumbnail)
+		thumbnail->addChangeListener(this);
+	WaveformCache::getInstance().addChangeListener(this);
 }
 
 //------------------------------------------------------------------------------
 WaveformDisplay::~WaveformDisplay()
 {
-	//Necessary?
-	thumbnail->removeChangeListener(this);
+	WaveformCache::getInstance().removeChangeListener(this);
 
-	if(deleteThumbnail)
-		delete thumbnail;
+	if(thumbnail)
+	{
+		thumbnail->removeChangeListener(this);
+
+		if(deleteThumbnail)
+			delete thumbnail;
+	}
 }
 
 //------------------------------------------------------------------------------
@@ -58,7 +54,7 @@ void WaveformDisplay::paint(Graphics& g)
 {
 	float x;
 	String tempstr;
-	const double length = thumbnail->getTotalLength();
+	const double length = getLength();
 	const Rectangle<int> tempRect(1, 1, getWidth()-2, getHeight()-2);
 
 	g.fillAll(ColourScheme::getInstance().colours["Window Background"]);
@@ -68,9 +64,12 @@ void WaveformDisplay::paint(Graphics& g)
 
 	if(length > 0)
 	{
-		//Draw the thumbnail.
+		//Draw the waveform.
 		g.setColour(ColourScheme::getInstance().colours["Waveform Colour"]);
-		thumbnail->drawChannels(g, tempRect, 0.0, length, 1.0f);
+		if(pyramid)
+			pyramid->drawChannels(g, tempRect, 0.0, length);
+		else
+			thumbnail->drawChannels(g, tempRect, 0.0, length, 1.0f);
 
 		//Draw the readPointer.
 		g.setColour(ColourScheme::getInstance().colours["Text Colour"].withAlpha(0.25f));
@@ -94,6 +93,14 @@ void WaveformDisplay::paint(Graphics& g)
 //------------------------------------------------------------------------------
 void WaveformDisplay::changeListenerCallback(ChangeBroadcaster *source)
 {
+	//Some file's overview is ready; see if it's ours.
+	if((source == &WaveformCache::getInstance()) && (currentFile != File()))
+	{
+		if(pyramid)
+			return;
+		pyramid = WaveformCache::getInstance().get(currentFile);
+	}
+
 	repaint();
 }
 
@@ -102,7 +109,7 @@ void WaveformDisplay::mouseDown(const MouseEvent &e)
 {
 	float x = (float)e.x;
 
-	if((x > 0.0f) && (x < (getWidth()-1)) && (thumbnail->getTotalLength() > 0))
+	if((x > 0.0f) && (x < (getWidth()-1)) && (getLength() > 0))
 	{
 		newReadPointer = x/(float)(getWidth()-2);
 		sendChangeMessage();
@@ -114,7 +121,7 @@ void WaveformDisplay::mouseDrag(const MouseEvent &e)
 {
 	float x = (float)e.x;
 
-	if((x > 0.0f) && (x < (getWidth()-1)) && (thumbnail->getTotalLength() > 0))
+	if((x > 0.0f) && (x < (getWidth()-1)) && (getLength() > 0))
 	{
 		newReadPointer = x/(float)(getWidth()-2);
 		sendChangeMessage();
@@ -124,11 +131,28 @@ void WaveformDisplay::mouseDrag(const MouseEvent &e)
 //------------------------------------------------------------------------------
 void WaveformDisplay::setFile(const File& file)
 {
-	AudioThumbnailCacheSingleton::getInstance().clear();
-	thumbnail->setSource(new FileInputSource(file));
-	if(file == File())
-		thumbnail->reset(2, 44100.0);
+	currentFile = file;
 	readPointer = 0.0f;
+
+	//Built in the background; changeListenerCallback() picks it up if it isn't
+	//ready yet.
+	pyramid = WaveformCache::getInstance().get(file);
+
+	if((file == File()) && thumbnail)
+		thumbnail->reset(2, 44100.0);
+
+	repaint();
+}
+
+//------------------------------------------------------------------------------
+double WaveformDisplay::getLength() const
+{
+	if(pyramid)
+		return pyramid->getLengthSeconds();
+	else if((currentFile == File()) && thumbnail)
+		return thumbnail->getTotalLength();
+
+	return 0.0;
 }
 
 //------------------------------------------------------------------------------
@@ -22,21 +22,34 @@
 
 #include <JuceHeader.h>
 
+#include <memory>
+
+class WaveformPyramid;
+
 //------------------------------------------------------------------------------
 ///	A component that displays a waveform.
+/*!
+	Files are drawn from the WaveformCache, so they show as soon as their
+	overview is built (or straight away, if it's been seen before). The
+	thumbnail, if there is one, is for audio that isn't a file yet: it's drawn
+	after setFile(File()), e.g. while the Looper records.
+ */
 class WaveformDisplay : public Component,
 						public ChangeListener,
 						public ChangeBroadcaster
 {
   public:
 	///	Constructor.
+	/*!
+		\param thumb A live thumbnail to draw when no file is set. May be 0.
+	 */
 	WaveformDisplay(AudioThumbnail *thumb = 0, bool deleteThumb = true);
 	///	Destructor.
 	~WaveformDisplay();
 
 	///	Draws the background and the waveform.
 	void paint(Graphics& g);
-	///	So we can update the thumbnail as it is loaded.
+	///	So we can update the thumbnail as it is loaded, or the file's overview when it's ready.
 	void changeListenerCallback(ChangeBroadcaster *source);
 
 	///	So the user can click and drag to move through the sound file.
@@ -56,8 +69,15 @@ class WaveformDisplay : public Component,
 
 
   private:
-	///	The current thumbnail.
+	///	The length of whatever we're drawing, in seconds.
+	double getLength() const;
+
+	///	The live thumbnail, or 0.
     AudioThumbnail *thumbnail;
+	///	The current file's overview, once the WaveformCache has it.
+	std::shared_ptr<const WaveformPyramid> pyramid;
+	///	The current file.
+	File currentFile;
 
 	///	The current position of the read pointer.
 	float readPointer;
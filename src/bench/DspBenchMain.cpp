@@ -0,0 +1,422 @@
+/*
+  ==============================================================================
+
+    DspBenchMain.cpp
+
+    DSP micro-benchmarks.
+    Times the built-in processors' processBlock, and the kernels inside them,
+    across block sizes and channel counts. Run with
+    --benchmark_out=<file> --benchmark_out_format=json and compare two runs
+    with Google Benchmark's tools/compare.py.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+
+#include "../BypassableInstance.h"
+#include "../CrossfadeMixer.h"
+#include "../DawMixerProcessor.h"
+#include "../DawSplitterProcessor.h"
+#include "../IRLoaderProcessor.h"
+#include "../NAMProcessor.h"
+#include "../PitchDetector.h"
+#include "../SafetyLimiter.h"
+#include "../SettingsManager.h"
+#include "../TunerProcessor.h"
+#include "../VuMeterDsp.h"
+
+#include <benchmark/benchmark.h>
+#include <spdlog/spdlog.h>
+
+#include <cmath>
+#include <functional>
+#include <vector>
+
+namespace
+{
+constexpr double sampleRate = 48000.0;
+constexpr int minBlockSize = 16;
+constexpr int maxBlockSize = 2048;
+
+/// A bass note and its third harmonic, peaking near 0 dBFS so the limiter has work to do
+float testSignal(int sample)
+{
+    const double t = sample / sampleRate;
+    return static_cast<float>(0.7 * std::sin(juce::MathConstants<double>::twoPi * 110.0 * t) +
+                              0.3 * std::sin(juce::MathConstants<double>::twoPi * 330.0 * t));
+}
+
+void fillTestSignal(juce::AudioBuffer<float>& buffer)
+{
+    for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+    {
+        for (int i = 0; i < buffer.getNumSamples(); ++i)
+            buffer.setSample(channel, i, testSignal(i));
+    }
+}
+
+constexpr int loadTimeoutMs = 10000;
+
+/// Prepares processor for numChannels x blockSize and times processBlock. The
+/// input is restored before every block, so in-place processing can't let the
+/// signal drift into silence or denormals between iterations.
+///
+/// Processors that load in the background after prepareToPlay (the IR
+/// convolvers) pass isReady: the timing waits for it, and runs the processor
+/// non-realtime so the convolution is timed in full rather than skipped when
+/// its worker is late.
+void runProcessor(benchmark::State& state, juce::AudioProcessor& processor, int numChannels, int blockSize,
+                  std::function<bool()> isReady = {})
+{
+    const juce::ScopedNoDenormals noDenormals;
+    processor.prepareToPlay(sampleRate, blockSize);
+
+    if (isReady)
+    {
+        processor.setNonRealtime(true);
+
+        const auto deadline = juce::Time::getMillisecondCounter() + loadTimeoutMs;
+        while (!isReady())
+        {
+            if (juce::Time::getMillisecondCounter() > deadline)
+            {
+                state.SkipWithError("Timed out waiting for the impulse response to load");
+                processor.releaseResources();
+                return;
+            }
+            juce::Thread::sleep(1);
+        }
+    }
+
+    juce::AudioBuffer<float> source(numChannels, blockSize);
+    fillTestSignal(source);
+    juce::AudioBuffer<float> buffer(numChannels, blockSize);
+    juce::MidiBuffer midi;
+
+    for (auto _ : state)
+    {
+        for (int channel = 0; channel < numChannels; ++channel)
+            buffer.copyFrom(channel, 0, source, channel, 0, blockSize);
+
+        processor.processBlock(buffer, midi);
+        benchmark::DoNotOptimize(buffer.getWritePointer(0));
+        benchmark::ClobberMemory();
+    }
+
+    processor.releaseResources();
+    state.SetItemsProcessed(state.iterations() * blockSize);
+}
+
+/// Block sizes by powers of two, crossed with each channel count
+void blockSizesAndChannels(benchmark::internal::Benchmark* benchmark, const std::vector<int64_t>& channels)
+{
+    benchmark->ArgNames({"block", "channels"});
+    benchmark->ArgsProduct({benchmark::CreateRange(minBlockSize, maxBlockSize, 2), channels});
+    benchmark->Unit(benchmark::kMicrosecond);
+}
+
+void upToStereo(benchmark::internal::Benchmark* benchmark)
+{
+    blockSizesAndChannels(benchmark, {1, 2});
+}
+
+void upToEightChannels(benchmark::internal::Benchmark* benchmark)
+{
+    blockSizesAndChannels(benchmark, {1, 2, 8});
+}
+
+/// For the mixer and splitter the second argument is the strip count
+void stripCounts(benchmark::internal::Benchmark* benchmark)
+{
+    blockSizesAndChannels(benchmark, {2, 8, 32});
+    benchmark->ArgNames({"block", "strips"});
+}
+
+//==============================================================================
+/// A plugin that passes audio straight through, for timing what the bypass wrapper adds
+class PassThroughPlugin : public juce::AudioPluginInstance
+{
+  public:
+    explicit PassThroughPlugin(int numChannels)
+        : juce::AudioPluginInstance(
+              BusesProperties()
+                  .withInput("Input", juce::AudioChannelSet::canonicalChannelSet(numChannels), true)
+                  .withOutput("Output", juce::AudioChannelSet::canonicalChannelSet(numChannels), true))
+    {
+    }
+
+    const juce::String getName() const override { return "Pass Through"; }
+    void prepareToPlay(double, int) override {}
+    void releaseResources() override {}
+    void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override {}
+    double getTailLengthSeconds() const override { return 0.0; }
+    bool acceptsMidi() const override { return false; }
+    bool producesMidi() const override { return false; }
+    bool hasEditor() const override { return false; }
+    juce::AudioProcessorEditor* createEditor() override { return nullptr; }
+    int getNumPrograms() override { return 1; }
+    int getCurrentProgram() override { return 0; }
+    void setCurrentProgram(int) override {}
+    const juce::String getProgramName(int) override { return {}; }
+    void changeProgramName(int, const juce::String&) override {}
+    void getStateInformation(juce::MemoryBlock&) override {}
+    void setStateInformation(const void*, int) override {}
+
+    void fillInPluginDescription(juce::PluginDescription& description) const override
+    {
+        description.name = getName();
+        description.pluginFormatName = "Benchmark";
+        description.numInputChannels = getTotalNumInputChannels();
+        description.numOutputChannels = getTotalNumOutputChannels();
+    }
+};
+
+//==============================================================================
+/// Half a second of decaying noise, written once as a WAV for the convolvers
+const juce::File& getTestImpulseResponse()
+{
+    static const juce::TemporaryFile file(".wav");
+    static const bool written = []()
+    {
+        const int length = static_cast<int>(sampleRate / 2);
+        juce::AudioBuffer<float> ir(1, length);
+        juce::Random random(1);
+        for (int i = 0; i < length; ++i)
+            ir.setSample(0, i, (random.nextFloat() * 2.0f - 1.0f) * std::exp(-6.0f * i / length));
+
+        juce::WavAudioFormat wav;
+        std::unique_ptr<juce::AudioFormatWriter> writer(
+            wav.createWriterFor(new juce::FileOutputStream(file.getFile()), sampleRate, 1, 24, {}, 0));
+        return writer != nullptr && writer->writeFromAudioSampleBuffer(ir, 0, length);
+    }();
+
+    jassert(written);
+    juce::ignoreUnused(written);
+    return file.getFile();
+}
+
+/// A small LSTM model, or the one named by PEDALBOARD3_BENCH_NAM_MODEL to time a real capture
+juce::File getTestNamModel()
+{
+    const auto custom = juce::SystemStats::getEnvironmentVariable("PEDALBOARD3_BENCH_NAM_MODEL", {});
+    if (custom.isNotEmpty())
+        return juce::File::getCurrentWorkingDirectory().getChildFile(custom);
+
+    static const juce::TemporaryFile file(".nam");
+    static const bool written = []()
+    {
+        constexpr int hiddenSize = 8;
+
+        // One layer: gate weights and biases, initial hidden and cell state, then the head
+        constexpr int numWeights =
+            4 * hiddenSize * (1 + hiddenSize) + 4 * hiddenSize + 2 * hiddenSize + hiddenSize + 1;
+        juce::Array<juce::var> weights;
+        juce::Random random(1);
+        for (int i = 0; i < numWeights; ++i)
+            weights.add((random.nextFloat() * 2.0f - 1.0f) * 0.2f);
+
+        auto* config = new juce::DynamicObject();
+        config->setProperty("num_layers", 1);
+        config->setProperty("input_size", 1);
+        config->setProperty("hidden_size", hiddenSize);
+
+        auto* model = new juce::DynamicObject();
+        model->setProperty("version", "0.5.4");
+        model->setProperty("architecture", "LSTM");
+        model->setProperty("config", config);
+        model->setProperty("weights", weights);
+        model->setProperty("sample_rate", sampleRate);
+        return file.getFile().replaceWithText(juce::JSON::toString(juce::var(model)));
+    }();
+
+    jassert(written);
+    juce::ignoreUnused(written);
+    return file.getFile();
+}
+} // namespace
+
+//==============================================================================
+// Infrastructure
+
+void BM_SafetyLimiter(benchmark::State& state)
+{
+    SafetyLimiterProcessor limiter;
+    runProcessor(state, limiter, static_cast<int>(state.range(1)), static_cast<int>(state.range(0)));
+}
+BENCHMARK(BM_SafetyLimiter)->Apply(upToStereo);
+
+void BM_CrossfadeMixer(benchmark::State& state)
+{
+    // Fading the whole time, back and forth, since a settled mixer is a plain copy
+    class AlwaysFading : public CrossfadeMixerProcessor
+    {
+      public:
+        void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midi) override
+        {
+            if (!isFading())
+            {
+                fadingIn ? startFadeIn(100) : startFadeOut(100);
+                fadingIn = !fadingIn;
+            }
+            CrossfadeMixerProcessor::processBlock(buffer, midi);
+        }
+
+      private:
+        bool fadingIn = false;
+    };
+
+    AlwaysFading mixer;
+    runProcessor(state, mixer, static_cast<int>(state.range(1)), static_cast<int>(state.range(0)));
+}
+BENCHMARK(BM_CrossfadeMixer)->Apply(upToStereo);
+
+void BM_BypassableInstance(benchmark::State& state)
+{
+    const int numChannels = static_cast<int>(state.range(1));
+    BypassableInstance instance(new PassThroughPlugin(numChannels));
+    instance.setBypass(state.range(2) != 0);
+    runProcessor(state, instance, numChannels, static_cast<int>(state.range(0)));
+}
+BENCHMARK(BM_BypassableInstance)
+    ->ArgNames({"block", "channels", "bypassed"})
+    ->ArgsProduct({benchmark::CreateRange(minBlockSize, maxBlockSize, 2), {1, 2, 8}, {0, 1}})
+    ->Unit(benchmark::kMicrosecond);
+
+//==============================================================================
+// Mixing
+
+void BM_DawMixer(benchmark::State& state)
+{
+    DawMixerProcessor mixer;
+    while (mixer.getNumStrips() < state.range(1))
+        mixer.addStrip();
+
+    const int numChannels = juce::jmax(mixer.getTotalNumInputChannels(), mixer.getTotalNumOutputChannels());
+    runProcessor(state, mixer, numChannels, static_cast<int>(state.range(0)));
+}
+BENCHMARK(BM_DawMixer)->Apply(stripCounts);
+
+void BM_DawSplitter(benchmark::State& state)
+{
+    DawSplitterProcessor splitter;
+    while (splitter.getNumStrips() < state.range(1))
+        splitter.addStrip();
+
+    const int numChannels = juce::jmax(splitter.getTotalNumInputChannels(), splitter.getTotalNumOutputChannels());
+    runProcessor(state, splitter, numChannels, static_cast<int>(state.range(0)));
+}
+BENCHMARK(BM_DawSplitter)->Apply(stripCounts);
+
+void BM_VuMeterDsp(benchmark::State& state)
+{
+    const int blockSize = static_cast<int>(state.range(0));
+    const int numChannels = static_cast<int>(state.range(1));
+
+    std::vector<VuMeterDsp> meters(static_cast<size_t>(numChannels));
+    for (auto& meter : meters)
+        meter.init(static_cast<float>(sampleRate));
+
+    juce::AudioBuffer<float> buffer(numChannels, blockSize);
+    fillTestSignal(buffer);
+
+    for (auto _ : state)
+    {
+        for (int channel = 0; channel < numChannels; ++channel)
+            meters[static_cast<size_t>(channel)].process(buffer.getReadPointer(channel), blockSize);
+        benchmark::DoNotOptimize(meters.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * blockSize);
+}
+BENCHMARK(BM_VuMeterDsp)->Apply(upToEightChannels);
+
+//==============================================================================
+// Tuner
+
+/// The YIN analysis the tuner's background thread runs, by window size
+void BM_PitchDetector(benchmark::State& state)
+{
+    PitchDetector detector;
+    detector.setWindowSize(static_cast<int>(state.range(0)));
+
+    std::vector<float> samples(static_cast<size_t>(detector.getWindowSize()));
+    for (size_t i = 0; i < samples.size(); ++i)
+        samples[i] = testSignal(static_cast<int>(i));
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(detector.detect(samples.data(), sampleRate));
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(samples.size()));
+}
+BENCHMARK(BM_PitchDetector)->ArgName("window")->RangeMultiplier(2)->Range(512, 8192)->Unit(benchmark::kMicrosecond);
+
+/// What the tuner costs the audio thread: queueing input for the analyser
+void BM_TunerProcessor(benchmark::State& state)
+{
+    TunerProcessor tuner;
+    runProcessor(state, tuner, 1, static_cast<int>(state.range(0)));
+}
+BENCHMARK(BM_TunerProcessor)
+    ->ArgName("block")
+    ->RangeMultiplier(2)
+    ->Range(minBlockSize, maxBlockSize)
+    ->Unit(benchmark::kMicrosecond);
+
+//==============================================================================
+// Amp and cab
+
+void BM_NAMProcessor(benchmark::State& state)
+{
+    NAMProcessor nam;
+    if (!nam.loadModel(getTestNamModel()))
+    {
+        state.SkipWithError("Could not load the NAM model");
+        return;
+    }
+
+    std::function<bool()> isReady;
+    if (state.range(1) != 0)
+    {
+        nam.loadIR(getTestImpulseResponse());
+        nam.setIREnabled(true);
+        isReady = [&nam] { return nam.isIRReady(); };
+    }
+
+    runProcessor(state, nam, 1, static_cast<int>(state.range(0)), isReady);
+}
+BENCHMARK(BM_NAMProcessor)
+    ->ArgNames({"block", "cab"})
+    ->ArgsProduct({benchmark::CreateRange(minBlockSize, maxBlockSize, 2), {0, 1}})
+    ->Unit(benchmark::kMicrosecond);
+
+void BM_IRLoader(benchmark::State& state)
+{
+    IRLoaderProcessor loader;
+    loader.loadIRFile(getTestImpulseResponse());
+    if (!loader.isIRLoaded())
+    {
+        state.SkipWithError("Could not load the impulse response");
+        return;
+    }
+
+    runProcessor(state, loader, static_cast<int>(state.range(1)), static_cast<int>(state.range(0)),
+                 [&loader] { return loader.isIRReady(); });
+}
+BENCHMARK(BM_IRLoader)->Apply(upToStereo);
+
+//==============================================================================
+int main(int argc, char** argv)
+{
+    const juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    spdlog::set_level(spdlog::level::warn);
+    SettingsManager::getInstance().initialise();
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+        return 1;
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
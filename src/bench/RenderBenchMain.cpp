@@ -0,0 +1,548 @@
+/*
+  ==============================================================================
+
+    RenderBenchMain.cpp
+
+    Offline render benchmark.
+    Loads a setlist or filter graph, renders it through a dummy audio device
+    as fast as it will go, and reports block timings, per-node costs and
+    patch-switch latencies as JSON.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+
+#include "../AudioSingletons.h"
+#include "../BypassableInstance.h"
+#include "../DspProfiler.h"
+#include "../FilterGraph.h"
+#include "../IRLoaderProcessor.h"
+#include "../InternalFilters.h"
+#include "../NAMProcessor.h"
+#include "../OscMappingManager.h"
+#include "../SettingsManager.h"
+#include "../SubGraphProcessor.h"
+
+#include <spdlog/sinks/stdout_sinks.h>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+struct BenchSettings
+{
+    juce::File file;
+    juce::File output; // stdout if unset
+    double sampleRate = 48000.0;
+    int blockSize = 256;
+    double seconds = 10.0; // Rendered per patch
+    int numInputs = 2;
+    int numOutputs = 2;
+    juce::String signal = "sine";
+    double maxP99Load = 0.0; // Fail if any patch's 99th percentile block exceeds this; 0 to never fail
+};
+
+juce::int64 ticksToNanos(juce::int64 ticks)
+{
+    return static_cast<juce::int64>(juce::Time::highResolutionTicksToSeconds(ticks) * 1.0e9);
+}
+
+double ticksToMillis(juce::int64 ticks)
+{
+    return juce::Time::highResolutionTicksToSeconds(ticks) * 1000.0;
+}
+
+//==============================================================================
+/// Stands in for a sound card, so AudioProcessorPlayer sets the graph up as it does in the app
+class BenchDevice : public juce::AudioIODevice
+{
+  public:
+    explicit BenchDevice(const BenchSettings& benchSettings)
+        : juce::AudioIODevice("Offline Benchmark", "Benchmark"), settings(benchSettings)
+    {
+    }
+
+    juce::StringArray getOutputChannelNames() override { return getChannelNames("Output", settings.numOutputs); }
+    juce::StringArray getInputChannelNames() override { return getChannelNames("Input", settings.numInputs); }
+    juce::Array<double> getAvailableSampleRates() override { return {settings.sampleRate}; }
+    juce::Array<int> getAvailableBufferSizes() override { return {settings.blockSize}; }
+    int getDefaultBufferSize() override { return settings.blockSize; }
+
+    juce::String open(const juce::BigInteger&, const juce::BigInteger&, double, int) override { return {}; }
+    void close() override {}
+    bool isOpen() override { return true; }
+    void start(juce::AudioIODeviceCallback*) override {}
+    void stop() override {}
+    bool isPlaying() override { return true; }
+    juce::String getLastError() override { return {}; }
+
+    int getCurrentBufferSizeSamples() override { return settings.blockSize; }
+    double getCurrentSampleRate() override { return settings.sampleRate; }
+    int getCurrentBitDepth() override { return 32; }
+    juce::BigInteger getActiveOutputChannels() const override { return getChannelMask(settings.numOutputs); }
+    juce::BigInteger getActiveInputChannels() const override { return getChannelMask(settings.numInputs); }
+    int getOutputLatencyInSamples() override { return 0; }
+    int getInputLatencyInSamples() override { return 0; }
+
+  private:
+    static juce::StringArray getChannelNames(const juce::String& prefix, int numChannels)
+    {
+        juce::StringArray names;
+        for (int i = 1; i <= numChannels; ++i)
+            names.add(prefix + " " + juce::String(i));
+        return names;
+    }
+
+    static juce::BigInteger getChannelMask(int numChannels)
+    {
+        juce::BigInteger mask;
+        mask.setRange(0, numChannels, true);
+        return mask;
+    }
+
+    const BenchSettings& settings;
+};
+
+//==============================================================================
+/// Drives the graph the way the device callback does, one timed block at a time
+class Renderer
+{
+  public:
+    Renderer(FilterGraph& filterGraph, const BenchSettings& benchSettings)
+        : settings(benchSettings), device(benchSettings),
+          input(juce::jmax(1, benchSettings.numInputs), benchSettings.blockSize),
+          output(benchSettings.numOutputs, benchSettings.blockSize)
+    {
+        filterGraph.setDeviceChannelCounts(settings.numInputs, settings.numOutputs);
+        player.setProcessor(&filterGraph.getGraph());
+        player.audioDeviceAboutToStart(&device);
+    }
+
+    ~Renderer()
+    {
+        player.audioDeviceStopped();
+        player.setProcessor(nullptr);
+    }
+
+    /// Renders one block of the test signal and returns how long the graph took
+    juce::int64 renderBlock()
+    {
+        fillInput();
+
+        const auto start = juce::Time::getHighResolutionTicks();
+        player.audioDeviceIOCallbackWithContext(input.getArrayOfReadPointers(), settings.numInputs,
+                                                output.getArrayOfWritePointers(), settings.numOutputs,
+                                                settings.blockSize, {});
+        return ticksToNanos(juce::Time::getHighResolutionTicks() - start);
+    }
+
+  private:
+    void fillInput()
+    {
+        if (settings.signal == "silence")
+        {
+            input.clear();
+            return;
+        }
+
+        const bool noise = settings.signal == "noise";
+        const double increment = juce::MathConstants<double>::twoPi * 220.0 / settings.sampleRate;
+        for (int i = 0; i < settings.blockSize; ++i)
+        {
+            const float sample =
+                noise ? (random.nextFloat() * 2.0f - 1.0f) * 0.25f : static_cast<float>(std::sin(phase)) * 0.25f;
+            phase = std::fmod(phase + increment, juce::MathConstants<double>::twoPi);
+
+            for (int channel = 0; channel < input.getNumChannels(); ++channel)
+                input.setSample(channel, i, sample);
+        }
+    }
+
+    const BenchSettings& settings;
+    BenchDevice device;
+    juce::AudioProcessorPlayer player;
+    juce::AudioBuffer<float> input;
+    juce::AudioBuffer<float> output;
+    juce::Random random{1};
+    double phase = 0.0;
+};
+
+//==============================================================================
+/// One patch of the file: its name, and its graph (null for an empty patch)
+struct Patch
+{
+    juce::String name;
+    const juce::XmlElement* graph = nullptr;
+};
+
+/// Every Patch of a .pdl setlist, or the single graph of a .filtergraph
+std::unique_ptr<juce::XmlElement> loadPatches(const juce::File& file, std::vector<Patch>& patches)
+{
+    auto root = juce::XmlDocument::parse(file);
+    if (root == nullptr)
+        return nullptr;
+
+    if (root->hasTagName("FILTERGRAPH"))
+    {
+        patches.push_back({file.getFileNameWithoutExtension(), root.get()});
+        return root;
+    }
+
+    forEachXmlChildElementWithTagName(*root, patch, "Patch")
+        patches.push_back({patch->getStringAttribute("name"), patch->getChildByName("FILTERGRAPH")});
+    return root;
+}
+
+//==============================================================================
+constexpr int irLoadTimeoutMs = 10000;
+
+/// IR kernels load in the background once a node is prepared, so a patch's
+/// timings would leave its convolution out until they're in. Puts every
+/// IR Loader and NAM cabinet in the graph (effect racks included) into
+/// non-realtime mode, so a late worker is waited for rather than skipped,
+/// and waits for their kernels. False if one didn't load in time.
+bool waitForImpulseResponses(juce::AudioProcessorGraph& rootGraph)
+{
+    std::vector<std::function<bool()>> pending;
+    std::function<void(juce::AudioProcessorGraph&)> collectIn = [&](juce::AudioProcessorGraph& graph)
+    {
+        for (auto* node : graph.getNodes())
+        {
+            auto* processor = node->getProcessor();
+            if (auto* bypassable = dynamic_cast<BypassableInstance*>(processor))
+                processor = bypassable->getPlugin();
+
+            if (auto* irLoader = dynamic_cast<IRLoaderProcessor*>(processor))
+            {
+                irLoader->setNonRealtime(true);
+                if (irLoader->isIRLoaded() || irLoader->isIR2Loaded())
+                    pending.push_back([irLoader] { return irLoader->isIRReady(); });
+            }
+            else if (auto* nam = dynamic_cast<NAMProcessor*>(processor))
+            {
+                nam->setNonRealtime(true);
+                if (nam->isIRLoaded())
+                    pending.push_back([nam] { return nam->isIRReady(); });
+            }
+            else if (auto* subGraph = dynamic_cast<SubGraphProcessor*>(processor))
+            {
+                collectIn(subGraph->getInternalGraph());
+            }
+        }
+    };
+    collectIn(rootGraph);
+
+    const auto deadline = juce::Time::getMillisecondCounter() + irLoadTimeoutMs;
+    for (const auto& isReady : pending)
+    {
+        while (!isReady())
+        {
+            if (juce::Time::getMillisecondCounter() > deadline)
+                return false;
+            juce::Thread::sleep(1);
+        }
+    }
+    return true;
+}
+
+//==============================================================================
+/// Switches patch as PluginField::loadFromXml does, timing each stage
+juce::var switchPatch(FilterGraph& filterGraph, Renderer& renderer, const Patch& patch,
+                      OscMappingManager& oscManager, const BenchSettings& settings)
+{
+    // The fade out runs in audio time, so count the blocks it takes rather than the time they took here
+    int fadeBlocks = 0;
+    if (auto* crossfader = filterGraph.getCrossfadeMixer())
+    {
+        crossfader->startFadeOut(100);
+        const int maxFadeBlocks = static_cast<int>(settings.sampleRate / settings.blockSize) + 1;
+        while (crossfader->isFading() && fadeBlocks < maxFadeBlocks)
+        {
+            renderer.renderBlock();
+            ++fadeBlocks;
+        }
+    }
+
+    const auto loadStart = juce::Time::getHighResolutionTicks();
+    if (patch.graph != nullptr)
+        filterGraph.restoreFromXml(*patch.graph, oscManager);
+    else
+        filterGraph.clear();
+    const auto rebuildStart = juce::Time::getHighResolutionTicks();
+    filterGraph.getGraph().rebuild();
+    const auto rebuildEnd = juce::Time::getHighResolutionTicks();
+
+    // restoreFromXml replaces the infrastructure nodes, crossfader included
+    if (auto* crossfader = filterGraph.getCrossfadeMixer())
+        crossfader->startFadeIn(100);
+    const double firstBlockMs = static_cast<double>(renderer.renderBlock()) / 1.0e6;
+
+    const double fadeOutMs = fadeBlocks * settings.blockSize * 1000.0 / settings.sampleRate;
+    const double loadMs = ticksToMillis(rebuildStart - loadStart);
+    const double rebuildMs = ticksToMillis(rebuildEnd - rebuildStart);
+
+    auto* stats = new juce::DynamicObject();
+    stats->setProperty("fadeOutMs", fadeOutMs);
+    stats->setProperty("loadMs", loadMs);
+    stats->setProperty("rebuildMs", rebuildMs);
+    stats->setProperty("firstBlockMs", firstBlockMs);
+    stats->setProperty("totalMs", fadeOutMs + loadMs + rebuildMs + firstBlockMs);
+    return stats;
+}
+
+/// The distribution of block times, against the block's real-time budget
+juce::var summariseBlocks(std::vector<juce::int64> nanos, const BenchSettings& settings, bool& overLimit)
+{
+    auto* stats = new juce::DynamicObject();
+    stats->setProperty("blocks", static_cast<int>(nanos.size()));
+    if (nanos.empty())
+        return stats;
+
+    std::sort(nanos.begin(), nanos.end());
+    const auto percentile = [&nanos](double fraction)
+    {
+        const auto rank = static_cast<size_t>(std::ceil(fraction * static_cast<double>(nanos.size())));
+        return static_cast<double>(nanos[juce::jlimit<size_t>(1, nanos.size(), rank) - 1]);
+    };
+
+    const double budget = settings.blockSize * 1.0e9 / settings.sampleRate;
+    double total = 0.0;
+    int overruns = 0;
+    std::array<int, DspLoadMeter::numBins> histogram{};
+    for (const auto duration : nanos)
+    {
+        total += static_cast<double>(duration);
+        if (static_cast<double>(duration) > budget)
+            ++overruns;
+        ++histogram[static_cast<size_t>(DspLoadMeter::getBin(duration))];
+    }
+
+    const double mean = total / static_cast<double>(nanos.size());
+    const double p99 = percentile(0.99);
+    const double max = static_cast<double>(nanos.back());
+
+    stats->setProperty("budgetMicros", budget / 1000.0);
+    stats->setProperty("meanMicros", mean / 1000.0);
+    stats->setProperty("p50Micros", percentile(0.5) / 1000.0);
+    stats->setProperty("p90Micros", percentile(0.9) / 1000.0);
+    stats->setProperty("p99Micros", p99 / 1000.0);
+    stats->setProperty("p999Micros", percentile(0.999) / 1000.0);
+    stats->setProperty("maxMicros", max / 1000.0);
+    stats->setProperty("meanLoad", mean / budget);
+    stats->setProperty("p99Load", p99 / budget);
+    stats->setProperty("maxLoad", max / budget);
+    stats->setProperty("overruns", overruns);
+    stats->setProperty("realTimeFactor", total > 0.0 ? budget * static_cast<double>(nanos.size()) / total : 0.0);
+
+    // The same quarter-octave bins as the DSP profiler, leaving out the empty ones
+    juce::Array<juce::var> bins;
+    for (int bin = 0; bin < DspLoadMeter::numBins; ++bin)
+    {
+        if (histogram[static_cast<size_t>(bin)] == 0)
+            continue;
+
+        auto* entry = new juce::DynamicObject();
+        entry->setProperty("upToMicros", DspLoadMeter::getBinUpperNanos(bin) / 1000.0);
+        entry->setProperty("blocks", histogram[static_cast<size_t>(bin)]);
+        bins.add(entry);
+    }
+    stats->setProperty("histogram", bins);
+
+    overLimit = settings.maxP99Load > 0.0 && p99 / budget > settings.maxP99Load;
+    return stats;
+}
+
+/// Each node's cost since the last update, most expensive first
+juce::var readNodeCosts()
+{
+    auto& profiler = DspProfiler::getInstance();
+    profiler.update();
+
+    auto loads = profiler.getLoads();
+    std::sort(loads.begin(), loads.end(), [](const auto& a, const auto& b) { return a.meanMicros > b.meanMicros; });
+
+    juce::Array<juce::var> nodes;
+    for (const auto& load : loads)
+    {
+        if (load.blocks == 0)
+            continue;
+
+        auto* node = new juce::DynamicObject();
+        node->setProperty("name", load.name);
+        node->setProperty("blocks", static_cast<juce::int64>(load.blocks));
+        node->setProperty("meanMicros", load.meanMicros);
+        node->setProperty("p99Micros", load.p99Micros);
+        node->setProperty("maxMicros", load.maxMicros);
+        node->setProperty("meanLoad", load.meanLoad);
+        node->setProperty("p99Load", load.p99Load);
+        node->setProperty("maxLoad", load.maxLoad);
+        nodes.add(node);
+    }
+    return nodes;
+}
+
+//==============================================================================
+void printUsage()
+{
+    std::cerr << "Usage: Pedalboard3Bench <setlist.pdl | graph.filtergraph> [options]\n"
+                 "\n"
+                 "Renders every patch through a dummy audio device as fast as possible and\n"
+                 "prints block timings, per-node costs and patch-switch latencies as JSON.\n"
+                 "\n"
+                 "  --sample-rate <hz>      Default 48000\n"
+                 "  --block-size <samples>  Default 256\n"
+                 "  --seconds <seconds>     Audio rendered per patch, default 10\n"
+                 "  --inputs <channels>     Default 2\n"
+                 "  --outputs <channels>    Default 2\n"
+                 "  --signal <type>         sine, noise or silence; default sine\n"
+                 "  --output <file>         Write the JSON here instead of stdout\n"
+                 "  --max-p99-load <ratio>  Exit with 1 if any patch's 99th percentile block\n"
+                 "                          takes more than this fraction of its budget\n";
+}
+
+bool parseSettings(const juce::ArgumentList& args, BenchSettings& settings)
+{
+    if (args.size() == 0 || args[0].isOption())
+        return false;
+    settings.file = args[0].resolveAsFile();
+
+    const auto option = [&args](const char* name, const juce::String& fallback)
+    {
+        const auto value = args.getValueForOption(name);
+        return value.isNotEmpty() ? value : fallback;
+    };
+
+    settings.sampleRate = option("--sample-rate", "48000").getDoubleValue();
+    settings.blockSize = option("--block-size", "256").getIntValue();
+    settings.seconds = option("--seconds", "10").getDoubleValue();
+    settings.numInputs = option("--inputs", "2").getIntValue();
+    settings.numOutputs = option("--outputs", "2").getIntValue();
+    settings.signal = option("--signal", "sine");
+    settings.maxP99Load = option("--max-p99-load", "0").getDoubleValue();
+
+    const auto output = args.getValueForOption("--output");
+    if (output.isNotEmpty())
+        settings.output = juce::File::getCurrentWorkingDirectory().getChildFile(output.unquoted());
+
+    return settings.sampleRate > 0.0 && settings.blockSize > 0 && settings.blockSize <= 8192 &&
+           settings.seconds > 0.0 && settings.numInputs >= 0 && settings.numOutputs > 0 &&
+           (settings.signal == "sine" || settings.signal == "noise" || settings.signal == "silence");
+}
+} // namespace
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    const juce::ArgumentList args(argc, argv);
+    BenchSettings settings;
+    if (args.containsOption("--help|-h") || !parseSettings(args, settings))
+    {
+        printUsage();
+        return 2;
+    }
+
+    const juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    // The results go to stdout, so keep the log out of them
+    spdlog::set_default_logger(spdlog::stderr_logger_mt("bench"));
+    spdlog::set_level(spdlog::level::warn);
+
+    SettingsManager::getInstance().initialise();
+    AudioPluginFormatManagerSingleton::getInstance().addFormat(new InternalPluginFormat);
+
+    std::vector<Patch> patches;
+    const auto root = loadPatches(settings.file, patches);
+    if (root == nullptr || patches.empty())
+    {
+        std::cerr << "Could not read any patches from " << settings.file.getFullPathName() << std::endl;
+        return 2;
+    }
+
+    juce::Array<juce::var> patchResults;
+    bool failed = false;
+    {
+        juce::ApplicationCommandManager commandManager;
+        OscMappingManager oscManager(&commandManager);
+        FilterGraph filterGraph;
+        Renderer renderer(filterGraph, settings);
+
+        auto& profiler = DspProfiler::getInstance();
+        profiler.setEnabled(true);
+
+        const auto numBlocks =
+            static_cast<size_t>(std::ceil(settings.seconds * settings.sampleRate / settings.blockSize));
+        std::vector<juce::int64> blockNanos;
+        blockNanos.reserve(numBlocks);
+
+        for (size_t i = 0; i < patches.size(); ++i)
+        {
+            const auto switchStats = switchPatch(filterGraph, renderer, patches[i], oscManager, settings);
+
+            // The switch is timed as the app sees it; the blocks below are timed with the IRs in
+            if (!waitForImpulseResponses(filterGraph.getGraph()))
+            {
+                std::cerr << "Patch " << i << " (" << patches[i].name << "): impulse responses didn't load"
+                          << std::endl;
+                failed = true;
+            }
+
+            // Leave the switch's blocks out of the node costs
+            profiler.update();
+
+            blockNanos.clear();
+            for (size_t block = 0; block < numBlocks; ++block)
+                blockNanos.push_back(renderer.renderBlock());
+
+            bool overLimit = false;
+            auto* result = new juce::DynamicObject();
+            result->setProperty("index", static_cast<int>(i));
+            result->setProperty("name", patches[i].name);
+            result->setProperty("switch", switchStats);
+            result->setProperty("blocks", summariseBlocks(blockNanos, settings, overLimit));
+            result->setProperty("nodes", readNodeCosts());
+            patchResults.add(result);
+
+            if (overLimit)
+            {
+                std::cerr << "Patch " << i << " (" << patches[i].name << ") is over the p99 load limit" << std::endl;
+                failed = true;
+            }
+        }
+
+        profiler.setEnabled(false);
+    }
+
+    auto* results = new juce::DynamicObject();
+    results->setProperty("file", settings.file.getFullPathName());
+    results->setProperty("sampleRate", settings.sampleRate);
+    results->setProperty("blockSize", settings.blockSize);
+    results->setProperty("inputs", settings.numInputs);
+    results->setProperty("outputs", settings.numOutputs);
+    results->setProperty("secondsPerPatch", settings.seconds);
+    results->setProperty("signal", settings.signal);
+    results->setProperty("patches", patchResults);
+
+    const auto json = juce::JSON::toString(juce::var(results));
+    if (settings.output != juce::File())
+    {
+        if (!settings.output.replaceWithText(json))
+        {
+            std::cerr << "Could not write " << settings.output.getFullPathName() << std::endl;
+            return 2;
+        }
+    }
+    else
+    {
+        std::cout << json << std::endl;
+    }
+
+    AudioPluginFormatManagerSingleton::killInstance();
+    return failed ? 1 : 0;
+}
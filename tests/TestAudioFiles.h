@@ -0,0 +1,43 @@
+/**
+ * @file TestAudioFiles.h
+ * @brief Temporary audio files for the tests that read or write them
+ */
+
+#pragma once
+
+#include <catch2/catch_test_macros.hpp>
+#include <juce_audio_formats/juce_audio_formats.h>
+
+#include <memory>
+
+/// A file in the temp folder that doesn't exist yet, named after prefix
+inline juce::File tempTestFile(const juce::String& prefix, const juce::String& suffix)
+{
+    return juce::File::getSpecialLocation(juce::File::tempDirectory).getNonexistentChildFile(prefix, suffix, false);
+}
+
+/// A WAV writer appending to file, or nullptr if it can't be opened. 32 bits is floating point.
+inline std::unique_ptr<juce::AudioFormatWriter> createTestWavWriter(const juce::File& file, int numChannels,
+                                                                    double sampleRate, int bitsPerSample)
+{
+    auto stream = std::make_unique<juce::FileOutputStream>(file);
+    if (!stream->openedOk())
+        return nullptr;
+
+    juce::WavAudioFormat wav;
+    std::unique_ptr<juce::AudioFormatWriter> writer(wav.createWriterFor(
+        stream.get(), sampleRate, static_cast<unsigned int>(numChannels), bitsPerSample, {}, 0));
+    if (writer != nullptr)
+        stream.release(); // The writer owns it now
+    return writer;
+}
+
+/// Writes the whole of buffer to file as a WAV, replacing whatever was there
+inline void writeTestWav(const juce::File& file, const juce::AudioBuffer<float>& buffer, double sampleRate,
+                         int bitsPerSample)
+{
+    file.deleteFile();
+    const auto writer = createTestWavWriter(file, buffer.getNumChannels(), sampleRate, bitsPerSample);
+    REQUIRE(writer != nullptr);
+    REQUIRE(writer->writeFromAudioSampleBuffer(buffer, 0, buffer.getNumSamples()));
+}
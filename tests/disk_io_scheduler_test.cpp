@@ -0,0 +1,201 @@
+/**
+ * @file disk_io_scheduler_test.cpp
+ * @brief Tests for the prioritised disk I/O queues and the write-behind DiskWriter
+ *
+ * These tests verify:
+ * 1. Write and read queues run on their own threads, not the thumbnail thread
+ * 2. Thumbnail throttling follows the low/high watermarks with hysteresis
+ * 3. DiskWriter writes every queued sample and feeds its data receiver
+ * 4. A block that doesn't fit is dropped and counted as an overrun
+ * 5. ReadAheadSource registers as a read stream, reports its headroom and counts underruns
+ */
+
+#include "../src/DiskWriter.h"
+#include "../src/ReadAheadSource.h"
+#include "TestAudioFiles.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+namespace
+{
+struct FakeStream : DiskIOScheduler::Stream
+{
+    float getHeadroom() const override { return headroom.load(); }
+    std::atomic<float> headroom{1.0f};
+};
+
+struct CountingReceiver : DiskWriter::IncomingDataReceiver
+{
+    void reset(int, double, juce::int64) override { samples = 0; }
+    void addBlock(juce::int64, const juce::AudioBuffer<float>&, int, int numSamples) override { samples += numSamples; }
+    std::atomic<juce::int64> samples{0};
+};
+} // namespace
+
+// ============================================================================
+// Queue Tests
+// ============================================================================
+
+TEST_CASE("DiskIOScheduler gives streaming its own threads", "[diskio]")
+{
+    auto& scheduler = DiskIOScheduler::getInstance();
+
+    auto& write = scheduler.getThread(DiskIOScheduler::Queue::Write);
+    auto& read = scheduler.getThread(DiskIOScheduler::Queue::Read);
+    auto& thumbnail = scheduler.getThread(DiskIOScheduler::Queue::Thumbnail);
+
+    REQUIRE(&write != &read);
+    REQUIRE(&write != &thumbnail);
+    REQUIRE(&read != &thumbnail);
+    REQUIRE(write.isThreadRunning());
+    REQUIRE(read.isThreadRunning());
+}
+
+TEST_CASE("DiskIOScheduler throttles thumbnails between the watermarks", "[diskio]")
+{
+    auto& scheduler = DiskIOScheduler::getInstance();
+    FakeStream stream;
+    scheduler.addStream(DiskIOScheduler::Queue::Read, &stream);
+    scheduler.resetStats();
+
+    REQUIRE_FALSE(scheduler.updateThrottle());
+
+    stream.headroom = DiskIOScheduler::lowWatermark - 0.1f;
+    REQUIRE(scheduler.updateThrottle());
+
+    // Recovering past the low watermark isn't enough; it has to clear the high one
+    stream.headroom = (DiskIOScheduler::lowWatermark + DiskIOScheduler::highWatermark) / 2.0f;
+    REQUIRE(scheduler.updateThrottle());
+
+    stream.headroom = DiskIOScheduler::highWatermark + 0.1f;
+    REQUIRE_FALSE(scheduler.updateThrottle());
+
+    const auto stats = scheduler.getStats(DiskIOScheduler::Queue::Read);
+    REQUIRE(stats.streams >= 1);
+    REQUIRE(stats.lowestHeadroom <= DiskIOScheduler::lowWatermark);
+
+    scheduler.removeStream(&stream);
+    REQUIRE_FALSE(scheduler.updateThrottle());
+}
+
+// ============================================================================
+// DiskWriter Tests
+// ============================================================================
+
+TEST_CASE("DiskWriter writes every queued sample", "[diskio]")
+{
+    const auto file = tempTestFile("Pedalboard3DiskWriterTest", ".wav");
+    CountingReceiver receiver;
+
+    constexpr int blockSize = 512;
+    constexpr int numBlocks = 200;
+    juce::AudioBuffer<float> block(2, blockSize);
+    block.clear();
+
+    {
+        auto* writer = createTestWavWriter(file, 2, 48000.0, 16).release();
+        REQUIRE(writer != nullptr);
+
+        DiskWriter diskWriter(writer, 8192);
+        diskWriter.setDataReceiver(&receiver);
+
+        for (int i = 0; i < numBlocks; ++i)
+        {
+            while (!diskWriter.write(block.getArrayOfReadPointers(), blockSize))
+                juce::Thread::sleep(1);
+        }
+        // Deleting the writer flushes what's still buffered
+    }
+
+    juce::WavAudioFormat wav;
+    std::unique_ptr<juce::AudioFormatReader> reader(wav.createReaderFor(new juce::FileInputStream(file), true));
+    REQUIRE(reader != nullptr);
+    REQUIRE(reader->lengthInSamples == static_cast<juce::int64>(blockSize) * numBlocks);
+    REQUIRE(receiver.samples == static_cast<juce::int64>(blockSize) * numBlocks);
+
+    file.deleteFile();
+}
+
+TEST_CASE("DiskWriter counts an overrun instead of blocking", "[diskio]")
+{
+    const auto file = tempTestFile("Pedalboard3DiskWriterTest", ".wav");
+    auto& scheduler = DiskIOScheduler::getInstance();
+    scheduler.resetStats();
+
+    {
+        auto* writer = createTestWavWriter(file, 2, 48000.0, 16).release();
+        REQUIRE(writer != nullptr);
+
+        DiskWriter diskWriter(writer, 1024);
+        REQUIRE(diskWriter.getHeadroom() > 0.99f);
+
+        // Bigger than the whole buffer, so it can never fit
+        juce::AudioBuffer<float> block(2, 4096);
+        block.clear();
+        REQUIRE_FALSE(diskWriter.write(block.getArrayOfReadPointers(), block.getNumSamples()));
+        REQUIRE(diskWriter.getOverruns() == 1);
+    }
+
+    REQUIRE(scheduler.getStats(DiskIOScheduler::Queue::Write).overruns == 1);
+    file.deleteFile();
+}
+
+// ============================================================================
+// ReadAheadSource Tests
+// ============================================================================
+
+TEST_CASE("ReadAheadSource reports its headroom and underruns on the read queue", "[diskio]")
+{
+    auto& scheduler = DiskIOScheduler::getInstance();
+    const int streamsBefore = scheduler.getStats(DiskIOScheduler::Queue::Read).streams;
+    scheduler.resetStats();
+
+    constexpr double sampleRate = 48000.0;
+    constexpr int bufferSize = 32768;
+    constexpr int blockSize = 512;
+    juce::AudioBuffer<float> audio(2, static_cast<int>(sampleRate) * 4);
+    for (int channel = 0; channel < 2; ++channel)
+        for (int i = 0; i < audio.getNumSamples(); ++i)
+            audio.setSample(channel, i, static_cast<float>(i % 1000) / 1000.0f);
+    juce::MemoryAudioSource memory(audio, false);
+
+    {
+        ReadAheadSource readAhead(&memory, bufferSize);
+        REQUIRE(scheduler.getStats(DiskIOScheduler::Queue::Read).streams == streamsBefore + 1);
+
+        juce::AudioBuffer<float> block(2, blockSize);
+        const juce::AudioSourceChannelInfo info(&block, 0, blockSize);
+
+        // Nothing has been read yet
+        readAhead.getNextAudioBlock(info);
+        REQUIRE(scheduler.getStats(DiskIOScheduler::Queue::Read).underruns == 1);
+
+        // Prefills before it returns
+        readAhead.setNextReadPosition(0);
+        readAhead.prepareToPlay(blockSize, sampleRate);
+        REQUIRE(readAhead.getHeadroom() > DiskIOScheduler::lowWatermark);
+
+        // Played faster than real time, but never before the read thread has got there
+        int mismatches = 0;
+        for (int position = 0; position < static_cast<int>(sampleRate); position += blockSize)
+        {
+            for (int i = 0; i < 1000 && readAhead.getHeadroom() * bufferSize < blockSize; ++i)
+                juce::Thread::sleep(1);
+
+            readAhead.getNextAudioBlock(info);
+            for (int i = 0; i < blockSize; ++i)
+                if (block.getSample(1, i) != audio.getSample(1, position + i))
+                    ++mismatches;
+        }
+        REQUIRE(mismatches == 0);
+        REQUIRE(scheduler.getStats(DiskIOScheduler::Queue::Read).underruns == 1);
+
+        readAhead.releaseResources();
+    }
+
+    REQUIRE(scheduler.getStats(DiskIOScheduler::Queue::Read).streams == streamsBefore);
+}
@@ -0,0 +1,134 @@
+/**
+ * @file dsp_profiler_test.cpp
+ * @brief Tests for the per-node DSP load meters and their summaries
+ *
+ * These tests verify:
+ * 1. Durations land in quarter-octave bins whose upper edges contain them
+ * 2. A window's mean, p99 and max, in time and as a share of the budget
+ * 3. Each summary covers only the blocks since the previous reading
+ * 4. Nothing is recorded while profiling is off
+ */
+
+#include "../src/DspProfiler.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+#include <limits>
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+namespace
+{
+constexpr double sampleRate = 48000.0;
+constexpr int blockSize = 256; // 5333us of budget per block
+
+class ProfiledProcessor : public juce::AudioProcessor
+{
+  public:
+    ProfiledProcessor() { setRateAndBufferSizeDetails(sampleRate, blockSize); }
+
+    const juce::String getName() const override { return "Profiled"; }
+    void prepareToPlay(double, int) override {}
+    void releaseResources() override {}
+    void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override
+    {
+        const DspLoadMeter::ScopedMeasurement measurement(meter, blockSize);
+    }
+
+    double getTailLengthSeconds() const override { return 0.0; }
+    bool acceptsMidi() const override { return false; }
+    bool producesMidi() const override { return false; }
+    juce::AudioProcessorEditor* createEditor() override { return nullptr; }
+    bool hasEditor() const override { return false; }
+    int getNumPrograms() override { return 1; }
+    int getCurrentProgram() override { return 0; }
+    void setCurrentProgram(int) override {}
+    const juce::String getProgramName(int) override { return {}; }
+    void changeProgramName(int, const juce::String&) override {}
+    void getStateInformation(juce::MemoryBlock&) override {}
+    void setStateInformation(const void*, int) override {}
+
+    DspLoadMeter meter{*this};
+};
+} // namespace
+
+// ============================================================================
+// Meter Tests
+// ============================================================================
+
+TEST_CASE("DspLoadMeter bins contain their durations", "[profiler]")
+{
+    REQUIRE(DspLoadMeter::getBin(0) == 0);
+    REQUIRE(DspLoadMeter::getBin(999) == 0);
+
+    int lastBin = 0;
+    for (juce::int64 nanos = 1000; nanos < 50000000; nanos = nanos * 11 / 10)
+    {
+        const int bin = DspLoadMeter::getBin(nanos);
+        REQUIRE(bin >= lastBin);
+        REQUIRE(static_cast<double>(nanos) < DspLoadMeter::getBinUpperNanos(bin));
+        REQUIRE(static_cast<double>(nanos) >= DspLoadMeter::getBinUpperNanos(bin - 1));
+        lastBin = bin;
+    }
+
+    REQUIRE(DspLoadMeter::getBin(std::numeric_limits<juce::int64>::max()) == DspLoadMeter::numBins - 1);
+}
+
+TEST_CASE("DspProfiler summarises a window of blocks", "[profiler]")
+{
+    ProfiledProcessor processor;
+    auto& meter = processor.meter;
+    const auto start = meter.read();
+
+    // 99 blocks of 100us and one 2ms spike
+    for (int i = 0; i < 99; ++i)
+        meter.addMeasurement(100000, blockSize);
+    meter.addMeasurement(2000000, blockSize);
+
+    const auto first = meter.read();
+    const auto load = DspProfiler::summarise(start, first);
+    const double budgetMicros = 1.0e6 * blockSize / sampleRate;
+
+    REQUIRE(load.blocks == 100);
+    REQUIRE_THAT(load.meanMicros, Catch::Matchers::WithinAbs(119.0, 0.01));
+    REQUIRE(load.p99Micros >= 100.0);
+    REQUIRE(load.p99Micros < 120.0);
+    REQUIRE_THAT(load.maxMicros, Catch::Matchers::WithinAbs(2000.0, 0.01));
+    REQUIRE_THAT(load.meanLoad, Catch::Matchers::WithinAbs(119.0 / budgetMicros, 1.0e-4));
+    REQUIRE_THAT(load.maxLoad, Catch::Matchers::WithinAbs(2000.0 / budgetMicros, 1.0e-4));
+
+    SECTION("The next window only has the blocks since")
+    {
+        for (int i = 0; i < 10; ++i)
+            meter.addMeasurement(50000, blockSize);
+
+        const auto next = DspProfiler::summarise(first, meter.read());
+        REQUIRE(next.blocks == 10);
+        REQUIRE_THAT(next.meanMicros, Catch::Matchers::WithinAbs(50.0, 0.01));
+        REQUIRE_THAT(next.maxMicros, Catch::Matchers::WithinAbs(50.0, 0.01));
+        REQUIRE(next.p99Micros <= 50.0);
+    }
+
+    SECTION("An idle window is empty")
+    {
+        const auto idle = DspProfiler::summarise(first, meter.read());
+        REQUIRE(idle.blocks == 0);
+        REQUIRE(idle.meanLoad == 0.0f);
+    }
+}
+
+TEST_CASE("DspLoadMeter records nothing while profiling is off", "[profiler]")
+{
+    REQUIRE_FALSE(DspProfiler::isEnabled());
+
+    ProfiledProcessor processor;
+    juce::AudioBuffer<float> buffer(2, blockSize);
+    juce::MidiBuffer midi;
+    for (int i = 0; i < 10; ++i)
+        processor.processBlock(buffer, midi);
+
+    REQUIRE(processor.meter.read().blocks == 0);
+}
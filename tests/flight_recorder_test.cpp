@@ -0,0 +1,173 @@
+/**
+ * @file flight_recorder_test.cpp
+ * @brief Tests for the audio callback deadline monitor and its trace dumps
+ *
+ * These tests verify:
+ * 1. A callback that overruns its period freezes the recorder after the post-miss window
+ * 2. The dump holds the callbacks, node timings, events and active patch, oldest first
+ * 3. A callback that starts late is a miss too, and the ring keeps only the newest history
+ * 4. Files that aren't traces are rejected
+ */
+
+#include "../src/FlightRecorder.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+namespace
+{
+constexpr double sampleRate = 48000.0;
+
+/// Runs one callback through the recorder, with a single node inside it
+void runCallback(FlightRecorder& recorder, juce::int64 startNanos, juce::int64 durationNanos, int numSamples)
+{
+    recorder.beginCallback();
+    recorder.recordNode(7, durationNanos / 2);
+    recorder.addCallback(startNanos, durationNanos, numSamples);
+}
+
+juce::File makeOutputDirectory()
+{
+    return juce::File::getSpecialLocation(juce::File::tempDirectory).getNonexistentChildFile("FlightRecorderTest", "");
+}
+
+/// The disk write thread dumps a frozen recorder; wait for it to finish
+bool waitForDump(const FlightRecorder& recorder, int previousDumps)
+{
+    for (int i = 0; i < 200 && recorder.getNumDumps() == previousDumps; ++i)
+        juce::Thread::sleep(25);
+    return recorder.getNumDumps() > previousDumps;
+}
+} // namespace
+
+// ============================================================================
+// Recorder Tests
+// ============================================================================
+
+TEST_CASE("FlightRecorder dumps the history around an overrun", "[flightrecorder]")
+{
+    const auto directory = makeOutputDirectory();
+    auto& recorder = FlightRecorder::getInstance();
+    recorder.setOutputDirectory(directory);
+    recorder.setEnabled(true);
+    recorder.prepare(sampleRate, 480); // 10ms periods
+
+    recorder.setActivePatch(3, "Verse");
+    recorder.recordEvent(FlightRecorder::EventSource::MidiCc, 1, 64, 127.0f);
+    recorder.recordEvent(FlightRecorder::EventSource::Osc, 0, 0, 0.5f, "/pedalboard3/param/1");
+
+    const juce::int64 period = 10000000;
+    const int previousMisses = recorder.getNumMisses();
+    const int previousDumps = recorder.getNumDumps();
+
+    for (int i = 0; i < 200; ++i)
+        runCallback(recorder, i * period, 2000000, 480);
+    REQUIRE(recorder.getNumMisses() == previousMisses);
+
+    // 15ms of work in a 10ms period, then the post-miss window
+    runCallback(recorder, 200 * period, 15000000, 480);
+    REQUIRE(recorder.getNumMisses() == previousMisses + 1);
+
+    const int postMiss = static_cast<int>(FlightRecorder::postMissSeconds * sampleRate / 480);
+    for (int i = 1; i < postMiss; ++i)
+        runCallback(recorder, (200 + i) * period, 2000000, 480);
+    REQUIRE_FALSE(recorder.isFrozen());
+
+    runCallback(recorder, (200 + postMiss) * period, 2000000, 480);
+
+    REQUIRE(waitForDump(recorder, previousDumps));
+    REQUIRE_FALSE(recorder.isFrozen());
+
+    FlightRecorder::Trace trace;
+    REQUIRE(FlightRecorder::readTrace(recorder.getLastDump(), trace));
+
+    REQUIRE(trace.sampleRate == sampleRate);
+    REQUIRE(trace.blockSize == 480);
+    REQUIRE(trace.patchIndex == 3);
+    REQUIRE(trace.patchName == "Verse");
+
+    REQUIRE(trace.callbacks.size() == static_cast<size_t>(201 + postMiss));
+    for (size_t i = 1; i < trace.callbacks.size(); ++i)
+        REQUIRE(trace.callbacks[i].sequence == trace.callbacks[i - 1].sequence + 1);
+
+    const auto missed = std::find_if(trace.callbacks.begin(), trace.callbacks.end(),
+                                     [](const auto& record) { return record.flags != 0; });
+    REQUIRE(missed != trace.callbacks.end());
+    REQUIRE(missed->sequence == trace.missSequence);
+    REQUIRE(missed->flags == FlightRecorder::Overran);
+    REQUIRE(missed->durationNanos == 15000000);
+    REQUIRE(missed->intervalNanos == period);
+    REQUIRE(missed - trace.callbacks.begin() == 200);
+
+    REQUIRE(trace.nodes.size() == trace.callbacks.size());
+    REQUIRE(trace.nodes.front().sequence == trace.callbacks.front().sequence);
+    REQUIRE(trace.nodes.front().node == 7);
+    REQUIRE(trace.nodes.front().nanos == 1000000);
+
+    REQUIRE(trace.events.size() == 3);
+    REQUIRE(trace.events[0].source == FlightRecorder::EventSource::PatchChange);
+    REQUIRE(trace.events[1].source == FlightRecorder::EventSource::MidiCc);
+    REQUIRE(trace.events[1].number == 64);
+    REQUIRE(juce::String(trace.events[2].address) == "/pedalboard3/param/1");
+
+    recorder.setEnabled(false);
+    recorder.release();
+    directory.deleteRecursively();
+}
+
+TEST_CASE("FlightRecorder catches late callbacks and keeps the newest history", "[flightrecorder]")
+{
+    const auto directory = makeOutputDirectory();
+    auto& recorder = FlightRecorder::getInstance();
+    recorder.setOutputDirectory(directory);
+    recorder.setEnabled(true);
+    recorder.prepare(sampleRate, 4800); // 100ms periods
+
+    const auto capacity = static_cast<size_t>((FlightRecorder::historySeconds + FlightRecorder::postMissSeconds) * 10);
+    const int postMiss = static_cast<int>(FlightRecorder::postMissSeconds * 10);
+    const int previousDumps = recorder.getNumDumps();
+
+    // Well past any earlier test's hold-off
+    const juce::int64 period = 100000000;
+    const juce::int64 start = juce::int64{1000000} * 1000000;
+    juce::int64 time = start;
+    for (int i = 0; i < 300; ++i, time += period)
+        runCallback(recorder, time, 1000000, 4800);
+
+    // Quick to run, but starting two periods after the last one
+    time += period;
+    runCallback(recorder, time, 1000000, 4800);
+    for (int i = 0; i < postMiss; ++i)
+        runCallback(recorder, time += period, 1000000, 4800);
+
+    REQUIRE(waitForDump(recorder, previousDumps));
+
+    FlightRecorder::Trace trace;
+    REQUIRE(FlightRecorder::readTrace(recorder.getLastDump(), trace));
+    REQUIRE(trace.callbacks.size() == capacity);
+    REQUIRE(trace.callbacks.back().startNanos == time);
+
+    const auto& missed = trace.callbacks[capacity - 1 - static_cast<size_t>(postMiss)];
+    REQUIRE(missed.sequence == trace.missSequence);
+    REQUIRE(missed.flags == FlightRecorder::Late);
+    REQUIRE(missed.intervalNanos == 2 * period);
+
+    recorder.setEnabled(false);
+    recorder.release();
+    directory.deleteRecursively();
+}
+
+TEST_CASE("FlightRecorder rejects files that aren't traces", "[flightrecorder]")
+{
+    juce::TemporaryFile file;
+    file.getFile().replaceWithText("not a trace");
+
+    FlightRecorder::Trace trace;
+    REQUIRE_FALSE(FlightRecorder::readTrace(file.getFile(), trace));
+    REQUIRE_FALSE(FlightRecorder::readTrace(juce::File(), trace));
+}
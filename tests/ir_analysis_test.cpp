@@ -0,0 +1,196 @@
+/**
+ * @file ir_analysis_test.cpp
+ * @brief Tests for load-time impulse response analysis
+ *
+ * These tests verify:
+ * 1. The noise floor is found in a noisy tail and ignored in a decaying one
+ * 2. The tail is cut where the decay meets the floor, and pre-delay is stripped on request
+ * 3. Minimum-phase conversion keeps the energy and moves it to the front
+ * 4. The convolution cost estimate follows IR length
+ */
+
+#include "../src/IRAnalysis.h"
+#include "../src/PartitionedConvolver.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+#include <cmath>
+
+using Catch::Matchers::WithinAbs;
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+namespace
+{
+constexpr double testSampleRate = 48000.0;
+
+/// Exponential decay (60 dB over decayTime seconds) sitting on white noise
+/// at noiseDb, starting after preDelay samples
+juce::AudioBuffer<float> makeNoisyIR(int length, int preDelay, double decayTime, float noiseDb)
+{
+    juce::Random random(1234);
+    const float noise = juce::Decibels::decibelsToGain(noiseDb);
+    const double decayPerSample = std::log(1000.0) / (decayTime * testSampleRate);
+
+    juce::AudioBuffer<float> ir(1, length);
+    for (int i = 0; i < length; ++i)
+    {
+        float sample = noise * (random.nextFloat() * 2.0f - 1.0f);
+        if (i >= preDelay)
+            sample += static_cast<float>(std::exp(-decayPerSample * (i - preDelay))) *
+                      (random.nextFloat() * 2.0f - 1.0f);
+        ir.setSample(0, i, sample);
+    }
+    return ir;
+}
+
+float getEnergy(const juce::AudioBuffer<float>& ir, int first, int last)
+{
+    float energy = 0.0f;
+    for (int i = first; i < juce::jmin(last, ir.getNumSamples()); ++i)
+        energy += ir.getSample(0, i) * ir.getSample(0, i);
+    return energy;
+}
+} // namespace
+
+// ============================================================================
+// Noise Floor Tests
+// ============================================================================
+
+TEST_CASE("IRAnalysis estimates the noise floor of a noisy tail", "[iranalysis]")
+{
+    // Noise sits about 70 dB below the loudest envelope window
+    const auto ir = makeNoisyIR(24000, 0, 0.1, -70.0f);
+    const float floorDb = IRAnalysis::estimateNoiseFloorDb(ir, testSampleRate);
+
+    REQUIRE(floorDb > -80.0f);
+    REQUIRE(floorDb < -60.0f);
+}
+
+TEST_CASE("IRAnalysis finds no floor in a tail that is still decaying", "[iranalysis]")
+{
+    const auto ir = makeNoisyIR(4800, 0, 0.5, -140.0f);
+    REQUIRE(IRAnalysis::estimateNoiseFloorDb(ir, testSampleRate) == -120.0f);
+}
+
+// ============================================================================
+// Trimming Tests
+// ============================================================================
+
+TEST_CASE("IRAnalysis cuts the tail at the noise floor and strips pre-delay", "[iranalysis]")
+{
+    // 500 ms capture, decay reaches the -70 dB floor after ~120 ms
+    auto ir = makeNoisyIR(24000, 240, 0.1, -70.0f);
+
+    IRAnalysis::Options options;
+    options.stripLeadingSilence = true;
+    const auto report = IRAnalysis::process(ir, testSampleRate, options);
+
+    REQUIRE(report.originalLength == 24000);
+    REQUIRE(report.leadingSamplesRemoved > 200);
+    REQUIRE(report.leadingSamplesRemoved < 250);
+    REQUIRE(report.length == ir.getNumSamples());
+    REQUIRE(report.getLengthMs() > 50.0);
+    REQUIRE(report.getLengthMs() < 150.0);
+
+    // Faded out rather than cut mid-waveform
+    REQUIRE(std::abs(ir.getSample(0, ir.getNumSamples() - 1)) < 1.0e-3f);
+}
+
+TEST_CASE("IRAnalysis keeps pre-delay unless asked, and caps how much it strips", "[iranalysis]")
+{
+    const auto original = makeNoisyIR(24000, 240, 0.1, -70.0f);
+
+    auto kept = original;
+    REQUIRE(IRAnalysis::process(kept, testSampleRate, {}).leadingSamplesRemoved == 0);
+
+    auto capped = original;
+    IRAnalysis::Options options;
+    options.stripLeadingSilence = true;
+    options.maxLeadingSamples = 100;
+    REQUIRE(IRAnalysis::process(capped, testSampleRate, options).leadingSamplesRemoved == 100);
+    REQUIRE(capped.getSample(0, 140) == original.getSample(0, 240));
+}
+
+TEST_CASE("IRAnalysis leaves the IR alone when trimming is disabled", "[iranalysis]")
+{
+    auto ir = makeNoisyIR(24000, 240, 0.1, -70.0f);
+
+    IRAnalysis::Options options;
+    options.trimTail = false;
+    options.stripLeadingSilence = false;
+
+    const auto report = IRAnalysis::process(ir, testSampleRate, options);
+    REQUIRE(report.length == 24000);
+    REQUIRE(ir.getNumSamples() == 24000);
+}
+
+TEST_CASE("IRAnalysis empties a silent IR", "[iranalysis]")
+{
+    juce::AudioBuffer<float> ir(2, 4800);
+    ir.clear();
+
+    const auto report = IRAnalysis::process(ir, testSampleRate, {});
+    REQUIRE(ir.getNumSamples() == 0);
+    REQUIRE(report.length == 0);
+}
+
+// ============================================================================
+// Minimum Phase Tests
+// ============================================================================
+
+TEST_CASE("IRAnalysis minimum-phase conversion front-loads the energy", "[iranalysis]")
+{
+    // A delayed, symmetric (linear-phase) pulse
+    juce::AudioBuffer<float> ir(1, 512);
+    ir.clear();
+    for (int i = -20; i <= 20; ++i)
+        ir.setSample(0, 200 + i, std::exp(-0.02f * static_cast<float>(i * i)));
+
+    const float energyBefore = getEnergy(ir, 0, 512);
+    IRAnalysis::makeMinimumPhase(ir);
+
+    // Same magnitude response, so (almost) the same energy
+    REQUIRE_THAT(getEnergy(ir, 0, 512), WithinAbs(energyBefore, energyBefore * 0.02f));
+
+    // Nearly all of it now arrives in the first few samples
+    REQUIRE(getEnergy(ir, 0, 30) > 0.95f * energyBefore);
+}
+
+TEST_CASE("IRAnalysis reports minimum phase and a shorter IR", "[iranalysis]")
+{
+    auto linear = makeNoisyIR(24000, 0, 0.1, -70.0f);
+    auto minimum = linear;
+
+    IRAnalysis::Options options;
+    options.minimumPhase = true;
+
+    const auto linearReport = IRAnalysis::process(linear, testSampleRate, {});
+    const auto minimumReport = IRAnalysis::process(minimum, testSampleRate, options);
+
+    REQUIRE(minimumReport.minimumPhase);
+    REQUIRE(minimumReport.length <= linearReport.length);
+}
+
+// ============================================================================
+// Cost Tests
+// ============================================================================
+
+TEST_CASE("PartitionedConvolver cost estimate grows with IR length", "[iranalysis]")
+{
+    const double shortCost = PartitionedConvolver::estimateCostPerSample(2400, 64);
+    const double longCost = PartitionedConvolver::estimateCostPerSample(48000, 64);
+
+    REQUIRE(PartitionedConvolver::estimateCostPerSample(0, 64) == 0.0);
+    REQUIRE(shortCost > 0.0);
+    REQUIRE(longCost > shortCost);
+
+    IRAnalysis::Report report;
+    report.originalCost = longCost;
+    report.cost = shortCost;
+    REQUIRE(report.getComputeSavings() > 0.0);
+    REQUIRE(report.getComputeSavings() < 1.0);
+}
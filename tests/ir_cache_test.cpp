@@ -0,0 +1,133 @@
+/**
+ * @file ir_cache_test.cpp
+ * @brief Tests for the shared IR kernel cache
+ *
+ * These tests verify:
+ * 1. Identical loads share one kernel
+ * 2. Different formats get separate kernels
+ * 3. Unused kernels are evicted LRU-first, in-use kernels never
+ */
+
+#include "../src/IRCache.h"
+#include "TestAudioFiles.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cmath>
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+namespace
+{
+juce::File writeTestIR(int length)
+{
+    auto file = juce::File::createTempFile(".wav");
+
+    juce::AudioBuffer<float> ir(1, length);
+    for (int i = 0; i < length; ++i)
+        ir.setSample(0, i, 0.5f * std::exp(-4.0f * i / length) * (i % 2 == 0 ? 1.0f : -1.0f));
+
+    writeTestWav(file, ir, 48000.0, 24);
+    return file;
+}
+} // namespace
+
+// ============================================================================
+// Sharing Tests
+// ============================================================================
+
+TEST_CASE("IRCache shares kernels between identical loads", "[ircache]")
+{
+    auto& cache = IRCache::getInstance();
+    cache.purgeUnused();
+
+    const auto file = writeTestIR(4800);
+
+    auto first = cache.getKernel(file, 48000.0, 64);
+    auto second = cache.getKernel(file, 48000.0, 64);
+    REQUIRE(first != nullptr);
+    REQUIRE(first == second);
+
+    SECTION("Different head size builds a separate kernel")
+    {
+        auto other = cache.getKernel(file, 48000.0, 128);
+        REQUIRE(other != nullptr);
+        REQUIRE(other != first);
+        REQUIRE(other->headSize == 128);
+    }
+
+    SECTION("Different sample rate builds a separate kernel")
+    {
+        auto other = cache.getKernel(file, 96000.0, 64);
+        REQUIRE(other != nullptr);
+        REQUIRE(other != first);
+        REQUIRE(other->length > first->length);
+    }
+
+    first.reset();
+    second.reset();
+    cache.purgeUnused();
+    file.deleteFile();
+}
+
+TEST_CASE("IRCache returns nullptr for unreadable files", "[ircache]")
+{
+    auto file = juce::File::createTempFile(".wav");
+    file.replaceWithText("not audio");
+
+    REQUIRE(IRCache::getInstance().getKernel(file, 48000.0, 64) == nullptr);
+    file.deleteFile();
+}
+
+// ============================================================================
+// Eviction Tests
+// ============================================================================
+
+TEST_CASE("IRCache evicts unused kernels least recently used first", "[ircache]")
+{
+    auto& cache = IRCache::getInstance();
+    cache.purgeUnused();
+    const auto previousLimit = cache.getMemoryLimit();
+
+    const auto fileA = writeTestIR(4800);
+    const auto fileB = writeTestIR(4800);
+    const auto fileC = writeTestIR(4800);
+
+    auto held = cache.getKernel(fileA, 48000.0, 64);
+    const size_t kernelBytes = held->getMemoryUsage();
+
+    // Room for exactly one unused kernel
+    cache.setMemoryLimit(kernelBytes + kernelBytes / 2);
+
+    cache.getKernel(fileB, 48000.0, 64); // Released immediately
+    cache.getKernel(fileC, 48000.0, 64); // Released immediately
+
+    // The next lookup trims the unused set back to one kernel (B goes).
+    // A is still held, so it survives although it is the oldest.
+    const auto missesBefore = cache.getStats().misses;
+    auto again = cache.getKernel(fileA, 48000.0, 64);
+    REQUIRE(again == held);
+    REQUIRE(cache.getStats().misses == missesBefore);
+
+    auto stats = cache.getStats();
+    REQUIRE(stats.entries == 2);
+    REQUIRE(stats.entriesInUse == 1);
+
+    // C is still cached, B was evicted
+    cache.getKernel(fileC, 48000.0, 64);
+    REQUIRE(cache.getStats().misses == missesBefore);
+    cache.getKernel(fileB, 48000.0, 64);
+    REQUIRE(cache.getStats().misses == missesBefore + 1);
+
+    held.reset();
+    again.reset();
+    cache.setMemoryLimit(previousLimit);
+    cache.purgeUnused();
+    REQUIRE(cache.getStats().entries == 0);
+
+    fileA.deleteFile();
+    fileB.deleteFile();
+    fileC.deleteFile();
+}
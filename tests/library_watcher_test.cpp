@@ -0,0 +1,147 @@
+/**
+ * @file library_watcher_test.cpp
+ * @brief Tests for the background NAM model / IR catalogue
+ *
+ * These tests verify:
+ * 1. A file added under a watched root is catalogued with its metadata
+ * 2. A file replaced with different audio is re-read
+ * 3. A removed file is dropped, and the catalogue is saved on shutdown
+ * 4. An unwatched root is dropped from the catalogue, but a root inside it is kept
+ */
+
+#include "../src/LibraryWatcher.h"
+#include "TestAudioFiles.h"
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <functional>
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+namespace
+{
+constexpr double sampleRate = 48000.0;
+
+juce::File tempFile(const juce::String& suffix)
+{
+    return tempTestFile("Pedalboard3LibraryWatcherTest", suffix);
+}
+
+/// Writes a silent mono IR of the given length, replacing file in one rename
+/// the way downloads and most editors do
+void writeImpulseResponse(const juce::File& file, int length)
+{
+    juce::AudioBuffer<float> audio(1, length);
+    audio.clear();
+    audio.setSample(0, 0, 1.0f);
+
+    const auto temp = file.getSiblingFile(file.getFileNameWithoutExtension() + ".part");
+    writeTestWav(temp, audio, sampleRate, 24);
+    REQUIRE(temp.moveFileTo(file));
+}
+
+/// Polls until condition holds; the poll fallback only looks every couple of seconds
+bool waitFor(const std::function<bool()>& condition)
+{
+    for (int i = 0; i < 1000 && !condition(); ++i)
+        juce::Thread::sleep(10);
+    return condition();
+}
+} // namespace
+
+// ============================================================================
+// Catalogue Tests
+// ============================================================================
+
+TEST_CASE("LibraryWatcher follows files being added, changed and removed", "[librarywatcher]")
+{
+    const auto root = tempFile("");
+    REQUIRE(root.createDirectory());
+    const auto snapshot = tempFile(".json");
+    const auto ir = root.getChildFile("Cab.wav");
+
+    {
+        LibraryWatcher watcher(snapshot);
+        watcher.watchDirectory(root);
+        REQUIRE(waitFor([&]() { return !watcher.isScanning(); }));
+        REQUIRE(watcher.getImpulseResponses(root).empty());
+
+        const auto durationIs = [&](double seconds)
+        {
+            const auto irs = watcher.getImpulseResponses(root);
+            return irs.size() == 1 && irs.front().durationSeconds == Catch::Approx(seconds);
+        };
+
+        // Added
+        writeImpulseResponse(ir, 4800);
+        REQUIRE(waitFor([&]() { return durationIs(0.1); }));
+        REQUIRE(watcher.getImpulseResponses(root).front().name == "Cab");
+        REQUIRE(watcher.getImpulseResponses(root).front().sampleRate == sampleRate);
+
+        // Changed
+        writeImpulseResponse(ir, 9600);
+        REQUIRE(waitFor([&]() { return durationIs(0.2); }));
+
+        // Removed
+        REQUIRE(ir.deleteFile());
+        REQUIRE(waitFor([&]() { return watcher.getImpulseResponses(root).empty(); }));
+
+        // Nothing else under the root is picked up
+        REQUIRE(root.getChildFile("notes.txt").replaceWithText("not an IR"));
+        juce::Thread::sleep(300);
+        REQUIRE(watcher.getImpulseResponses(root).empty());
+        REQUIRE(watcher.getModels(root).empty());
+
+        watcher.shutdown();
+    }
+
+    // The root is remembered for the next session
+    REQUIRE(snapshot.existsAsFile());
+    REQUIRE(snapshot.loadFileAsString().contains("Pedalboard3LibraryWatcherTest"));
+
+    snapshot.deleteFile();
+    root.deleteRecursively();
+}
+
+TEST_CASE("LibraryWatcher forgets a root that is no longer watched", "[librarywatcher]")
+{
+    const auto root = tempFile("");
+    const auto nested = root.getChildFile("Cabs");
+    REQUIRE(nested.createDirectory());
+    const auto snapshot = tempFile(".json");
+    writeImpulseResponse(root.getChildFile("Top.wav"), 4800);
+    writeImpulseResponse(nested.getChildFile("Cab.wav"), 4800);
+
+    {
+        LibraryWatcher watcher(snapshot);
+        watcher.watchDirectory(root);
+        watcher.watchDirectory(nested);
+        REQUIRE(waitFor([&]() { return watcher.getImpulseResponses(root).size() == 2; }));
+
+        // The nested root keeps its entries; the rest goes
+        watcher.unwatchDirectory(root);
+        REQUIRE(waitFor([&]() { return watcher.getImpulseResponses(root).size() == 1; }));
+        REQUIRE(watcher.getImpulseResponses(nested).size() == 1);
+
+        // Unwatching something that isn't a root does nothing
+        watcher.unwatchDirectory(root);
+        juce::Thread::sleep(300);
+        REQUIRE(watcher.getImpulseResponses(nested).size() == 1);
+
+        watcher.shutdown();
+    }
+
+    // Only the nested root is remembered for the next session
+    {
+        LibraryWatcher watcher(snapshot);
+        REQUIRE(watcher.getImpulseResponses(root).size() == 1);
+        REQUIRE(watcher.getImpulseResponses(root).front().name == "Cab");
+        watcher.shutdown();
+    }
+
+    snapshot.deleteFile();
+    root.deleteRecursively();
+}
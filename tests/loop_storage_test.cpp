@@ -0,0 +1,242 @@
+/**
+ * @file loop_storage_test.cpp
+ * @brief Tests for the looper's disk-backed loop storage
+ *
+ * These tests verify:
+ * 1. Chunks are sized in time, from the actual sample rate
+ * 2. A loop much longer than the RAM window records and plays back exactly
+ * 3. Loops imported from a file play back exactly, with the scratch file grown a chunk at a time
+ * 4. Recording falls short, rather than blocking, when a chunk isn't ready
+ * 5. Overdub layers mix down, and undo/redo switch layers without dropouts
+ */
+
+#include "../src/LoopStorage.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+namespace
+{
+// A low rate keeps long loops (in chunks) cheap to test
+constexpr double testSampleRate = 1000.0;
+constexpr int blockSize = 256;
+
+float expectedSample(int channel, juce::int64 position)
+{
+    const float value = static_cast<float>(position % 977) / 977.0f;
+    return channel == 0 ? value : -value;
+}
+
+void fillBlock(juce::AudioBuffer<float>& block, juce::int64 position, int numSamples)
+{
+    for (int channel = 0; channel < 2; ++channel)
+        for (int i = 0; i < numSamples; ++i)
+            block.setSample(channel, i, expectedSample(channel, position + i));
+}
+
+/// Records length samples, servicing the storage between blocks as the
+/// background thread would
+void record(LoopStorage& storage, juce::int64 length)
+{
+    juce::AudioBuffer<float> block(2, blockSize);
+
+    for (juce::int64 position = 0; position < length;)
+    {
+        const int numSamples = static_cast<int>(juce::jmin<juce::int64>(blockSize, length - position));
+        fillBlock(block, position, numSamples);
+
+        REQUIRE(storage.write(block, 0, position, numSamples) == numSamples);
+        position += numSamples;
+        storage.service(position, position, true);
+    }
+    storage.service(0, length, false);
+}
+
+/// Plays numSamples from the start of a loop of length samples, wrapping,
+/// and returns the number of samples that didn't match (the recorded take
+/// plus dubLevel)
+int playAndCount(LoopStorage& storage, juce::int64 length, juce::int64 numSamples, float dubLevel = 0.0f)
+{
+    juce::AudioBuffer<float> block(2, blockSize);
+    juce::int64 position = 0;
+    int mismatches = 0;
+
+    for (juce::int64 played = 0; played < numSamples;)
+    {
+        storage.service(position, length, false);
+
+        const int numToPlay = static_cast<int>(juce::jmin<juce::int64>(blockSize, length - position));
+        block.clear();
+        storage.addTo(block, 0, position, numToPlay, 1.0f, 1.0f);
+
+        for (int channel = 0; channel < 2; ++channel)
+            for (int i = 0; i < numToPlay; ++i)
+                if (block.getSample(channel, i) != expectedSample(channel, position + i) + dubLevel)
+                    ++mismatches;
+
+        played += numToPlay;
+        position = (position + numToPlay) % length;
+    }
+    return mismatches;
+}
+
+/// Overdubs a constant dubLevel over one pass of the loop, playing it as the
+/// audio thread would. Returns false if the layer wasn't ready in time.
+bool overdubPass(LoopStorage& storage, juce::int64 length, float dubLevel)
+{
+    juce::AudioBuffer<float> input(2, blockSize), output(2, blockSize);
+    for (int channel = 0; channel < 2; ++channel)
+        juce::FloatVectorOperations::fill(input.getWritePointer(channel), dubLevel, blockSize);
+
+    for (juce::int64 position = 0; position < length;)
+    {
+        storage.service(position, length, false);
+
+        const int numSamples = static_cast<int>(juce::jmin<juce::int64>(blockSize, length - position));
+        output.clear();
+        storage.addTo(output, 0, position, numSamples, 1.0f, 1.0f);
+        if (!storage.overdub(input, 0, position, numSamples))
+            return false;
+
+        position += numSamples;
+    }
+    return true;
+}
+} // namespace
+
+// ============================================================================
+// Layout Tests
+// ============================================================================
+
+TEST_CASE("LoopStorage sizes chunks from the sample rate", "[loopstorage]")
+{
+    LoopStorage storage;
+
+    storage.prepare(44100.0);
+    REQUIRE(storage.getChunkSize() == static_cast<int>(44100.0 * LoopStorage::chunkSeconds));
+
+    storage.prepare(96000.0);
+    REQUIRE(storage.getChunkSize() == static_cast<int>(96000.0 * LoopStorage::chunkSeconds));
+    REQUIRE(storage.getResidentBytes() % (static_cast<size_t>(storage.getChunkSize()) * 2 * sizeof(float)) == 0);
+}
+
+// ============================================================================
+// Record / Playback Tests
+// ============================================================================
+
+TEST_CASE("LoopStorage records and plays a loop far longer than its RAM window", "[loopstorage]")
+{
+    LoopStorage storage;
+    storage.prepare(testSampleRate);
+
+    const size_t residentBytes = storage.getResidentBytes();
+
+    // Ten minutes at the test rate: 300 chunks, ten scratch segments
+    const auto length = static_cast<juce::int64>(600.0 * testSampleRate) + 123;
+    record(storage, length);
+
+    REQUIRE(storage.getResidentBytes() == residentBytes);
+    REQUIRE(static_cast<size_t>(length) * 2 * sizeof(float) > 10 * residentBytes);
+    REQUIRE(storage.getScratchBytes() >= length * 2 * static_cast<juce::int64>(sizeof(float)));
+
+    // Twice round, to cover the wrap back to the head
+    REQUIRE(playAndCount(storage, length, 2 * length) == 0);
+    REQUIRE(storage.getUnderruns() == 0);
+}
+
+TEST_CASE("LoopStorage plays back an imported loop", "[loopstorage]")
+{
+    LoopStorage storage;
+    storage.prepare(testSampleRate);
+
+    const juce::int64 length = 37 * storage.getChunkSize() / 2;
+    juce::AudioBuffer<float> block(2, 1000);
+
+    for (juce::int64 position = 0; position < length; position += 1000)
+    {
+        const int numSamples = static_cast<int>(juce::jmin<juce::int64>(1000, length - position));
+        fillBlock(block, position, numSamples);
+
+        // The scratch file grows a chunk per call, so a new segment takes a few
+        for (int i = 0; i < 100 && !storage.reserve(position + numSamples); ++i)
+        {
+        }
+        REQUIRE(storage.import(block, numSamples, position));
+    }
+
+    REQUIRE(playAndCount(storage, length, length + 5000) == 0);
+    REQUIRE(storage.getUnderruns() == 0);
+
+    // A new segment is written over several calls, not all at once
+    const juce::int64 before = storage.getScratchBytes();
+    REQUIRE_FALSE(storage.reserve(before / 2 / static_cast<juce::int64>(sizeof(float)) + 1));
+    REQUIRE(storage.getScratchBytes() == before);
+}
+
+TEST_CASE("LoopStorage write stops short at a chunk that isn't ready", "[loopstorage]")
+{
+    LoopStorage storage;
+    storage.prepare(testSampleRate);
+
+    // Without service() running, only the initial window is ready
+    juce::AudioBuffer<float> block(2, blockSize);
+    fillBlock(block, 0, blockSize);
+
+    juce::int64 position = 0;
+    int written = blockSize;
+    while (written == blockSize)
+    {
+        written = storage.write(block, 0, position, blockSize);
+        position += written;
+    }
+
+    REQUIRE(position % storage.getChunkSize() == 0);
+    REQUIRE(position >= (LoopStorage::headChunks + LoopStorage::lookaheadChunks) * storage.getChunkSize());
+    REQUIRE(storage.getUnderruns() > 0);
+}
+
+// ============================================================================
+// Layer Tests
+// ============================================================================
+
+TEST_CASE("LoopStorage mixes overdub layers and switches them with undo/redo", "[loopstorage]")
+{
+    LoopStorage storage;
+    storage.prepare(testSampleRate);
+
+    // Longer than the RAM window, so layers have to round-trip the scratch file
+    const juce::int64 length = 31 * static_cast<juce::int64>(storage.getChunkSize()) + 77;
+    record(storage, length);
+
+    REQUIRE_FALSE(storage.canUndoLayer());
+    REQUIRE(storage.beginOverdub(0, length));
+    REQUIRE(storage.isOverdubbing());
+    REQUIRE(overdubPass(storage, length, 0.25f));
+    storage.endOverdub();
+    storage.service(0, length, false);
+
+    REQUIRE(storage.getNumLayers() == 1);
+    REQUIRE(playAndCount(storage, length, length + 3000, 0.25f) == 0);
+
+    // The previous version is already resident, so it plays straight away
+    REQUIRE(storage.undoLayer());
+    juce::AudioBuffer<float> block(2, blockSize);
+    REQUIRE(storage.addTo(block, 0, 0, blockSize, 1.0f, 1.0f) == blockSize);
+    REQUIRE(playAndCount(storage, length, length) == 0);
+    REQUIRE(storage.getNumLayers() == 0);
+    REQUIRE_FALSE(storage.canUndoLayer());
+
+    REQUIRE(storage.redoLayer());
+    REQUIRE(playAndCount(storage, length, length, 0.25f) == 0);
+    REQUIRE(storage.getUnderruns() == 0);
+
+    // A new layer after an undo discards the redo history
+    REQUIRE(storage.undoLayer());
+    REQUIRE(storage.canRedoLayer());
+    REQUIRE(storage.beginOverdub(0, length));
+    REQUIRE_FALSE(storage.canRedoLayer());
+    storage.endOverdub();
+}
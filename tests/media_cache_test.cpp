@@ -0,0 +1,166 @@
+/**
+ * @file media_cache_test.cpp
+ * @brief Tests for the setlist media prefetch cache
+ *
+ * These tests verify:
+ * 1. Preloaded audio in the window is decoded ahead and picked up instantly
+ * 2. MIDI files are held whole, and dropped once the file changes on disk
+ * 3. Eviction is least recently used first and never touches the window
+ */
+
+#include "../src/MediaCache.h"
+#include "TestAudioFiles.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+namespace
+{
+constexpr double sampleRate = 48000.0;
+
+juce::File tempFile(const juce::String& suffix)
+{
+    return tempTestFile("Pedalboard3MediaCacheTest", suffix);
+}
+
+juce::File writeSineFile(int length)
+{
+    const auto file = tempFile(".wav");
+
+    juce::AudioBuffer<float> audio(2, length);
+    for (int c = 0; c < 2; ++c)
+        for (int i = 0; i < length; ++i)
+            audio.setSample(c, i, std::sin(static_cast<float>(i) * 0.01f));
+
+    writeTestWav(file, audio, sampleRate, 32);
+    return file;
+}
+
+bool waitUntilIdle(const MediaCache& cache)
+{
+    for (int i = 0; i < 500 && cache.isBusy(); ++i)
+        juce::Thread::sleep(10);
+    return !cache.isBusy();
+}
+
+/// The cache is a singleton, so every test starts from empty
+MediaCache& freshCache()
+{
+    auto& cache = MediaCache::getInstance();
+    cache.clear();
+    cache.setMemoryLimit(MediaCache::defaultMemoryLimit);
+    cache.setSampleRate(sampleRate);
+    return cache;
+}
+
+std::shared_ptr<const juce::AudioBuffer<float>> makeAudio(int length)
+{
+    auto audio = std::make_shared<juce::AudioBuffer<float>>(2, length);
+    audio->clear();
+    return audio;
+}
+} // namespace
+
+// ============================================================================
+// Prefetch Tests
+// ============================================================================
+
+TEST_CASE("MediaCache decodes the window's backing tracks ahead of time", "[mediacache]")
+{
+    auto& cache = freshCache();
+    const auto file = writeSineFile(48000);
+
+    cache.setWindow({{file, MediaReference::Kind::PreloadedAudio}});
+    REQUIRE(waitUntilIdle(cache));
+
+    auto cached = cache.getAudio(file, sampleRate);
+    REQUIRE(cached != nullptr);
+    REQUIRE(cached->getNumSamples() == 48000);
+    REQUIRE(cache.getMemoryUsage() == 2 * 48000 * sizeof(float));
+
+    // A player loading the file gets the prefetched audio without decoding
+    AudioPreloader preloader;
+    preloader.load(file, sampleRate);
+    REQUIRE_FALSE(preloader.isLoading());
+    REQUIRE(preloader.getAudio() == cached);
+
+    cache.clear();
+    file.deleteFile();
+}
+
+TEST_CASE("MediaCache holds MIDI files until they change", "[mediacache]")
+{
+    auto& cache = freshCache();
+    const auto file = tempFile(".mid");
+
+    juce::MidiMessageSequence track;
+    track.addEvent(juce::MidiMessage::noteOn(1, 60, 0.8f), 0.0);
+    track.addEvent(juce::MidiMessage::noteOff(1, 60), 480.0);
+    juce::MidiFile midi;
+    midi.setTicksPerQuarterNote(480);
+    midi.addTrack(track);
+    {
+        juce::FileOutputStream out(file);
+        REQUIRE(midi.writeTo(out));
+    }
+
+    cache.setWindow({{file, MediaReference::Kind::MidiFile}});
+    REQUIRE(waitUntilIdle(cache));
+
+    auto data = cache.getFileData(file);
+    REQUIRE(data != nullptr);
+    REQUIRE(static_cast<juce::int64>(data->getSize()) == file.getSize());
+
+    // Edited on disk: the cached copy must not be used
+    file.setLastModificationTime(juce::Time::getCurrentTime() + juce::RelativeTime::hours(1));
+    REQUIRE(cache.getFileData(file) == nullptr);
+    REQUIRE(cache.getMemoryUsage() == 0);
+
+    cache.clear();
+    file.deleteFile();
+}
+
+// ============================================================================
+// Eviction Tests
+// ============================================================================
+
+TEST_CASE("MediaCache evicts the least recently used file outside the window", "[mediacache]")
+{
+    auto& cache = freshCache();
+    const size_t entryBytes = 2 * 1000 * sizeof(float);
+    cache.setMemoryLimit(3 * entryBytes);
+
+    const auto pinned = tempFile(".wav");
+    const auto older = tempFile(".flac");
+    const auto newer = tempFile(".aiff");
+    const auto latest = tempFile(".ogg");
+
+    cache.setWindow({{pinned, MediaReference::Kind::PreloadedAudio}});
+    REQUIRE(waitUntilIdle(cache));
+
+    cache.addAudio(pinned, sampleRate, makeAudio(1000));
+    cache.addAudio(older, sampleRate, makeAudio(1000));
+    cache.addAudio(newer, sampleRate, makeAudio(1000));
+    REQUIRE(cache.getMemoryUsage() == 3 * entryBytes);
+
+    // Touch older, so newer becomes the least recently used
+    REQUIRE(cache.getAudio(older, sampleRate) != nullptr);
+
+    cache.addAudio(latest, sampleRate, makeAudio(1000));
+    REQUIRE(cache.getMemoryUsage() == 3 * entryBytes);
+    REQUIRE(cache.getAudio(pinned, sampleRate) != nullptr);
+    REQUIRE(cache.getAudio(older, sampleRate) != nullptr);
+    REQUIRE(cache.getAudio(newer, sampleRate) == nullptr);
+    REQUIRE(cache.getAudio(latest, sampleRate) != nullptr);
+
+    // Nothing is ever evicted from the window to make room
+    cache.setMemoryLimit(entryBytes);
+    REQUIRE(cache.getAudio(pinned, sampleRate) != nullptr);
+    cache.addAudio(newer, sampleRate, makeAudio(1000));
+    REQUIRE(cache.getAudio(newer, sampleRate) == nullptr);
+
+    cache.clear();
+}
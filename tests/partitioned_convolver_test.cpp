@@ -0,0 +1,342 @@
+/**
+ * @file partitioned_convolver_test.cpp
+ * @brief Tests for the non-uniform partitioned convolution engine
+ *
+ * These tests verify:
+ * 1. Output matches direct (time-domain) convolution with zero latency
+ * 2. Correctness holds for host blocks that don't align to the head size
+ * 3. Mono IRs are applied to both channels
+ * 4. Two IRs blend with equal-power gains, before and after pre-mixing
+ * 5. IR file reading trims silence and normalises
+ * 6. IR files load in the background, and a clear() supersedes a pending load
+ */
+
+#include "../src/PartitionedConvolver.h"
+#include "TestAudioFiles.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+#include <cmath>
+#include <vector>
+
+using Catch::Matchers::WithinAbs;
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+namespace
+{
+juce::AudioBuffer<float> makeDecayingIR(int numChannels, int length, juce::uint32 seed)
+{
+    juce::Random random(static_cast<juce::int64>(seed));
+    juce::AudioBuffer<float> ir(numChannels, length);
+    for (int ch = 0; ch < numChannels; ++ch)
+        for (int i = 0; i < length; ++i)
+            ir.setSample(ch, i, (random.nextFloat() * 2.0f - 1.0f) * std::exp(-4.0f * i / length));
+    return ir;
+}
+
+std::vector<float> directConvolve(const std::vector<float>& input, const float* ir, int irLength)
+{
+    std::vector<float> output(input.size(), 0.0f);
+    for (size_t n = 0; n < input.size(); ++n)
+    {
+        double sum = 0.0;
+        for (int k = 0; k < irLength && k <= static_cast<int>(n); ++k)
+            sum += static_cast<double>(ir[k]) * input[n - static_cast<size_t>(k)];
+        output[n] = static_cast<float>(sum);
+    }
+    return output;
+}
+
+/// Streams input through the convolver using the given repeating block sizes
+std::vector<std::vector<float>> runConvolver(PartitionedConvolver& convolver, const std::vector<float>& input,
+                                             const std::vector<int>& blockSizes, int numChannels)
+{
+    std::vector<std::vector<float>> output(static_cast<size_t>(numChannels), std::vector<float>(input.size()));
+    juce::AudioBuffer<float> block;
+
+    // Faster than real time, so the worker is often still busy when a tail job falls due
+    convolver.setNonRealtime(true);
+
+    size_t position = 0;
+    size_t blockIndex = 0;
+    while (position < input.size())
+    {
+        const int size = static_cast<int>(
+            std::min(static_cast<size_t>(blockSizes[blockIndex++ % blockSizes.size()]), input.size() - position));
+        block.setSize(numChannels, size, false, false, true);
+        for (int ch = 0; ch < numChannels; ++ch)
+            std::copy(input.begin() + position, input.begin() + position + size, block.getWritePointer(ch));
+
+        convolver.process(block);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            std::copy(block.getReadPointer(ch), block.getReadPointer(ch) + size, output[ch].begin() + position);
+        position += static_cast<size_t>(size);
+    }
+    return output;
+}
+
+juce::File writeIRFile(const juce::AudioBuffer<float>& ir)
+{
+    auto file = juce::File::createTempFile(".wav");
+    writeTestWav(file, ir, 48000.0, 24);
+    return file;
+}
+
+bool waitUntilLoaded(const PartitionedConvolver& convolver)
+{
+    for (int i = 0; i < 500 && !convolver.isLoaded(); ++i)
+        juce::Thread::sleep(10);
+    return convolver.isLoaded();
+}
+
+std::vector<float> makeNoise(int length, juce::uint32 seed)
+{
+    juce::Random random(static_cast<juce::int64>(seed));
+    std::vector<float> input(static_cast<size_t>(length));
+    for (auto& sample : input)
+        sample = random.nextFloat() * 2.0f - 1.0f;
+    return input;
+}
+} // namespace
+
+// ============================================================================
+// Layout Tests
+// ============================================================================
+
+TEST_CASE("PartitionedConvolver head size follows block size", "[convolver]")
+{
+    REQUIRE(PartitionedConvolver::chooseHeadSize(16) == 32);
+    REQUIRE(PartitionedConvolver::chooseHeadSize(64) == 64);
+    REQUIRE(PartitionedConvolver::chooseHeadSize(100) == 128);
+    REQUIRE(PartitionedConvolver::chooseHeadSize(2048) == 128);
+}
+
+TEST_CASE("PartitionedConvolver kernel covers the whole IR", "[convolver]")
+{
+    const auto ir = makeDecayingIR(1, 20000, 1);
+    PartitionedConvolver::Kernel kernel(ir, 64);
+
+    REQUIRE(kernel.segments.size() == 3);
+    REQUIRE_FALSE(kernel.segments[0].background);
+    REQUIRE(kernel.segments[1].background);
+
+    // Levels are contiguous: each tail level starts at twice its partition
+    // size, inside the range covered by the previous level
+    REQUIRE(kernel.segments.front().offset == 64);
+    for (size_t i = 1; i < kernel.segments.size(); ++i)
+    {
+        const auto& previous = kernel.segments[i - 1];
+        const auto& segment = kernel.segments[i];
+        REQUIRE(segment.offset == 2 * segment.partitionSize);
+        REQUIRE(segment.offset <= previous.offset + previous.numPartitions * previous.partitionSize);
+    }
+
+    const auto& last = kernel.segments.back();
+    REQUIRE(last.offset + last.numPartitions * last.partitionSize >= 20000);
+}
+
+// ============================================================================
+// Correctness Tests
+// ============================================================================
+
+TEST_CASE("PartitionedConvolver matches direct convolution", "[convolver]")
+{
+    const int irLength = 20000;
+    const auto ir = makeDecayingIR(1, irLength, 2);
+    const auto input = makeNoise(48000, 3);
+    const auto expected = directConvolve(input, ir.getReadPointer(0), irLength);
+
+    SECTION("Aligned blocks")
+    {
+        PartitionedConvolver convolver;
+        convolver.prepare(48000.0, 64);
+        convolver.setKernel(std::make_shared<const PartitionedConvolver::Kernel>(ir, convolver.getHeadSize()));
+
+        const auto output = runConvolver(convolver, input, {64}, 1);
+        for (size_t i = 0; i < input.size(); i += 37)
+            REQUIRE_THAT(output[0][i], WithinAbs(expected[i], 1.0e-3));
+    }
+
+    SECTION("Irregular blocks")
+    {
+        PartitionedConvolver convolver;
+        convolver.prepare(48000.0, 512);
+        convolver.setKernel(std::make_shared<const PartitionedConvolver::Kernel>(ir, convolver.getHeadSize()));
+
+        const auto output = runConvolver(convolver, input, {512, 17, 300, 1, 128}, 1);
+        for (size_t i = 0; i < input.size(); i += 37)
+            REQUIRE_THAT(output[0][i], WithinAbs(expected[i], 1.0e-3));
+    }
+}
+
+TEST_CASE("PartitionedConvolver has no added latency", "[convolver]")
+{
+    juce::AudioBuffer<float> ir(1, 1);
+    ir.setSample(0, 0, 1.0f);
+
+    PartitionedConvolver convolver;
+    convolver.prepare(48000.0, 128);
+    convolver.setKernel(std::make_shared<const PartitionedConvolver::Kernel>(ir, convolver.getHeadSize()));
+
+    const auto input = makeNoise(1024, 4);
+    const auto output = runConvolver(convolver, input, {128}, 1);
+    for (size_t i = 0; i < input.size(); ++i)
+        REQUIRE_THAT(output[0][i], WithinAbs(input[i], 1.0e-6));
+}
+
+TEST_CASE("PartitionedConvolver applies mono IR to both channels", "[convolver]")
+{
+    const auto ir = makeDecayingIR(1, 3000, 5);
+    const auto input = makeNoise(8192, 6);
+    const auto expected = directConvolve(input, ir.getReadPointer(0), 3000);
+
+    PartitionedConvolver convolver;
+    convolver.prepare(44100.0, 256);
+    convolver.setKernel(std::make_shared<const PartitionedConvolver::Kernel>(ir, convolver.getHeadSize()));
+
+    const auto output = runConvolver(convolver, input, {256}, 2);
+    for (size_t i = 0; i < input.size(); i += 11)
+    {
+        REQUIRE_THAT(output[0][i], WithinAbs(expected[i], 1.0e-3));
+        REQUIRE_THAT(output[1][i], WithinAbs(expected[i], 1.0e-3));
+    }
+}
+
+TEST_CASE("PartitionedConvolver outputs silence when cleared", "[convolver]")
+{
+    PartitionedConvolver convolver;
+    convolver.prepare(48000.0, 64);
+    convolver.setKernel(std::make_shared<const PartitionedConvolver::Kernel>(makeDecayingIR(2, 500, 7), 64));
+    convolver.clear();
+
+    REQUIRE_FALSE(convolver.isLoaded());
+
+    const auto output = runConvolver(convolver, makeNoise(512, 8), {64}, 2);
+    for (const auto& channel : output)
+        for (float sample : channel)
+            REQUIRE(sample == 0.0f);
+}
+
+// ============================================================================
+// Dual-IR Blend Tests
+// ============================================================================
+
+TEST_CASE("PartitionedConvolver blends two IRs with equal-power gains", "[convolver]")
+{
+    // Different lengths so the two kernels have different level layouts
+    const auto irA = makeDecayingIR(1, 3000, 9);
+    const auto irB = makeDecayingIR(1, 20000, 10);
+    const auto input = makeNoise(48000, 11);
+
+    const float blend = 0.3f;
+    const float gainA = std::cos(blend * juce::MathConstants<float>::halfPi);
+    const float gainB = std::sin(blend * juce::MathConstants<float>::halfPi);
+
+    const auto convolvedA = directConvolve(input, irA.getReadPointer(0), irA.getNumSamples());
+    const auto convolvedB = directConvolve(input, irB.getReadPointer(0), irB.getNumSamples());
+
+    PartitionedConvolver convolver;
+    convolver.prepare(48000.0, 128);
+    convolver.setKernels(std::make_shared<const PartitionedConvolver::Kernel>(irA, convolver.getHeadSize()),
+                         std::make_shared<const PartitionedConvolver::Kernel>(irB, convolver.getHeadSize()));
+    convolver.setBlend(blend);
+    REQUIRE(convolver.isBlending());
+
+    // First half runs straight after the blend changed (two kernels per
+    // partition); the pause lets the worker pre-mix for the second half
+    const std::vector<float> firstHalf(input.begin(), input.begin() + 24000);
+    const std::vector<float> secondHalf(input.begin() + 24000, input.end());
+
+    auto output = runConvolver(convolver, firstHalf, {128}, 1)[0];
+
+    juce::Thread::sleep(300);
+    const auto rest = runConvolver(convolver, secondHalf, {128}, 1)[0];
+    REQUIRE(convolver.isUsingPremixedBlend());
+    output.insert(output.end(), rest.begin(), rest.end());
+
+    for (size_t i = 0; i < input.size(); i += 37)
+        REQUIRE_THAT(output[i], WithinAbs(gainA * convolvedA[i] + gainB * convolvedB[i], 1.0e-3));
+}
+
+TEST_CASE("PartitionedConvolver blend extremes select a single IR", "[convolver]")
+{
+    const auto irA = makeDecayingIR(1, 2000, 12);
+    const auto irB = makeDecayingIR(1, 2000, 13);
+    const auto input = makeNoise(4096, 14);
+
+    PartitionedConvolver convolver;
+    convolver.prepare(48000.0, 64);
+    convolver.setKernels(std::make_shared<const PartitionedConvolver::Kernel>(irA, 64),
+                         std::make_shared<const PartitionedConvolver::Kernel>(irB, 64));
+
+    convolver.setBlend(1.0f);
+    const auto output = runConvolver(convolver, input, {64}, 1)[0];
+    const auto expected = directConvolve(input, irB.getReadPointer(0), irB.getNumSamples());
+    for (size_t i = 0; i < input.size(); i += 7)
+        REQUIRE_THAT(output[i], WithinAbs(expected[i], 1.0e-3));
+}
+
+// ============================================================================
+// IR File Tests
+// ============================================================================
+
+TEST_CASE("PartitionedConvolver reads, trims and normalises IR files", "[convolver]")
+{
+    juce::AudioBuffer<float> source(1, 1200);
+    source.clear();
+    for (int i = 0; i < 1000; ++i)
+        source.setSample(0, 100 + i, 0.5f * std::exp(-0.01f * i));
+    auto file = writeIRFile(source);
+
+    IRAnalysis::Options options;
+    options.stripLeadingSilence = true;
+
+    const auto ir = PartitionedConvolver::readImpulseResponse(file, 48000.0, options);
+    REQUIRE(ir.getNumChannels() == 1);
+    REQUIRE(ir.getNumSamples() < 1000);
+    REQUIRE(std::abs(ir.getSample(0, 0)) > 0.0f);
+
+    float power = 0.0f;
+    for (int i = 0; i < ir.getNumSamples(); ++i)
+        power += ir.getSample(0, i) * ir.getSample(0, i);
+    REQUIRE_THAT(std::sqrt(power), WithinAbs(0.125, 1.0e-3));
+
+    const auto resampled = PartitionedConvolver::readImpulseResponse(file, 96000.0, options);
+    REQUIRE(resampled.getNumSamples() > ir.getNumSamples() * 3 / 2);
+
+    file.deleteFile();
+}
+
+TEST_CASE("PartitionedConvolver loads IR files in the background", "[convolver]")
+{
+    const auto file = writeIRFile(makeDecayingIR(1, 4800, 15));
+
+    PartitionedConvolver convolver;
+    REQUIRE_FALSE(convolver.loadImpulseResponse(file.getSiblingFile("missing.wav")));
+
+    // Not prepared yet: the load waits for the format
+    REQUIRE(convolver.loadImpulseResponse(file));
+    juce::Thread::sleep(100);
+    REQUIRE_FALSE(convolver.isLoaded());
+
+    convolver.prepare(48000.0, 64);
+    REQUIRE(waitUntilLoaded(convolver));
+    const auto report = convolver.getAnalysis();
+    REQUIRE(report != nullptr);
+    REQUIRE(report->length > 0);
+
+    SECTION("clear() drops a load still in progress")
+    {
+        REQUIRE(convolver.loadImpulseResponse(file));
+        convolver.clear();
+        juce::Thread::sleep(200);
+        REQUIRE_FALSE(convolver.isLoaded());
+    }
+
+    file.deleteFile();
+}
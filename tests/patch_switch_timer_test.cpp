@@ -0,0 +1,164 @@
+/**
+ * @file patch_switch_timer_test.cpp
+ * @brief Tests for the stage-by-stage patch switch latency measurement
+ *
+ * These tests verify:
+ * 1. A Program Change switch is timed from its arrival to the first audible output block
+ * 2. A switch cut short by the next one is kept as silent, and left out of the audible-only stats
+ * 3. Nothing is timed while switch timing is off, and the JSON export carries the stats and histograms
+ */
+
+#include "../src/PatchSwitchTimer.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <vector>
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+namespace
+{
+constexpr int blockSize = 256;
+
+/// Feeds one stereo block of a constant level to the timer
+void outputBlock(PatchSwitchTimer& timer, float level)
+{
+    std::vector<float> left(blockSize, level), right(blockSize, -level);
+    const float* channels[] = {left.data(), right.data()};
+    timer.processOutput(channels, 2, blockSize);
+}
+
+PatchSwitchTimer& startTiming()
+{
+    auto& timer = PatchSwitchTimer::getInstance();
+    timer.setEnabled(true);
+    timer.clearHistory();
+    return timer;
+}
+} // namespace
+
+// ============================================================================
+// Timer Tests
+// ============================================================================
+
+TEST_CASE("PatchSwitchTimer times a Program Change switch to the first audible block", "[patchswitchtimer]")
+{
+    auto& timer = startTiming();
+
+    PatchSwitchTimer::programChangeReceived();
+    juce::Thread::sleep(5);
+
+    timer.beginSwitch(2);
+    juce::Thread::sleep(2);
+    timer.markStage(PatchSwitchTimer::SavePrevious);
+    juce::Thread::sleep(5);
+    timer.markStage(PatchSwitchTimer::CrossfadeWait);
+    juce::Thread::sleep(2);
+    timer.markStage(PatchSwitchTimer::RestoreGraph);
+    timer.endSwitch();
+
+    // Silence (and the fade's first whisper) doesn't count as the patch being heard
+    outputBlock(timer, 0.0f);
+    outputBlock(timer, 0.0005f);
+    timer.update();
+    REQUIRE(timer.getHistory().empty());
+
+    juce::Thread::sleep(3);
+    outputBlock(timer, 0.5f);
+    timer.update();
+    REQUIRE(timer.getHistory().size() == 1);
+
+    const auto& record = timer.getHistory().front();
+    REQUIRE(record.patch == 2);
+    REQUIRE(record.fromProgramChange);
+    REQUIRE(record.audible);
+    REQUIRE(record.stageMs[PatchSwitchTimer::Queue] >= 4.0);
+    REQUIRE(record.stageMs[PatchSwitchTimer::CrossfadeWait] >= 4.0);
+    REQUIRE(record.stageMs[PatchSwitchTimer::FirstAudible] >= 2.0);
+    REQUIRE(record.stageMs[PatchSwitchTimer::RebuildComponents] == 0.0);
+
+    // The stages cover the whole switch
+    double sum = 0.0;
+    for (const auto ms : record.stageMs)
+        sum += ms;
+    REQUIRE(record.totalMs >= 17.0);
+    REQUIRE(record.totalMs >= sum - 0.01);
+    REQUIRE(record.totalMs <= sum + 0.01);
+
+    // Later blocks belong to no switch
+    outputBlock(timer, 0.5f);
+    timer.update();
+    REQUIRE(timer.getHistory().size() == 1);
+}
+
+TEST_CASE("PatchSwitchTimer keeps a superseded switch as silent", "[patchswitchtimer]")
+{
+    auto& timer = startTiming();
+
+    timer.beginSwitch(0);
+    timer.endSwitch();
+    outputBlock(timer, 0.0f);
+
+    // The next switch starts before the first was heard
+    timer.beginSwitch(1);
+    REQUIRE(timer.getHistory().size() == 1);
+    timer.endSwitch();
+    outputBlock(timer, 0.25f);
+    timer.update();
+
+    const auto& history = timer.getHistory();
+    REQUIRE(history.size() == 2);
+    REQUIRE_FALSE(history[0].audible);
+    REQUIRE_FALSE(history[0].fromProgramChange);
+    REQUIRE(history[1].audible);
+
+    // Both count for the stages they reached; only the heard one for the audible stage and total
+    REQUIRE(timer.getStats(PatchSwitchTimer::SavePrevious).count == 2);
+    REQUIRE(timer.getStats(PatchSwitchTimer::FirstAudible).count == 1);
+    REQUIRE(timer.getStats(PatchSwitchTimer::numStages).count == 1);
+
+    // Neither came from a Program Change, so there's no queue to measure
+    REQUIRE(timer.getStats(PatchSwitchTimer::Queue).count == 0);
+}
+
+TEST_CASE("PatchSwitchTimer records nothing while off and exports its histograms", "[patchswitchtimer]")
+{
+    auto& timer = startTiming();
+    timer.setEnabled(false);
+
+    PatchSwitchTimer::programChangeReceived();
+    timer.beginSwitch(4);
+    timer.endSwitch();
+    outputBlock(timer, 0.5f);
+    timer.update();
+    REQUIRE(timer.getHistory().empty());
+
+    timer.setEnabled(true);
+    for (int patch = 0; patch < 3; ++patch)
+    {
+        timer.beginSwitch(patch);
+        timer.markStage(PatchSwitchTimer::RestoreGraph);
+        timer.endSwitch();
+        outputBlock(timer, 0.5f);
+        timer.update();
+    }
+    REQUIRE(timer.getHistory().size() == 3);
+
+    // Every timed switch lands in exactly one bin
+    int binned = 0;
+    for (const auto count : timer.getHistogram(PatchSwitchTimer::numStages))
+        binned += count;
+    REQUIRE(binned == 3);
+
+    const auto json = timer.toJson();
+    REQUIRE(json["switches"].size() == 3);
+    REQUIRE(json["binUpperMs"].size() == PatchSwitchTimer::numBins - 1);
+    REQUIRE(json["stages"].size() == PatchSwitchTimer::numStages + 1);
+
+    const auto total = json["stages"][PatchSwitchTimer::numStages];
+    REQUIRE(total["stage"].toString() == "Total");
+    REQUIRE(static_cast<int>(total["count"]) == 3);
+    REQUIRE(total["histogram"].size() == PatchSwitchTimer::numBins);
+}
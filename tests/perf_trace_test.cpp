@@ -0,0 +1,148 @@
+/**
+ * @file perf_trace_test.cpp
+ * @brief Tests for the timeline zones and their Chrome trace export
+ *
+ * These tests verify:
+ * 1. Zones record nothing while tracing is off
+ * 2. Each thread gets its own named track, with nested zones inside their parents
+ * 3. A thread's buffer keeps the newest zones once it wraps
+ */
+
+#include "../src/PerfTrace.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+namespace
+{
+class TracedThread : public juce::Thread
+{
+  public:
+    TracedThread() : juce::Thread("Trace Worker") {}
+
+    void run() override
+    {
+        const PerfTrace::Zone zone("Worker zone", "test");
+        juce::Thread::sleep(2);
+    }
+};
+
+juce::var exportTrace()
+{
+    juce::MemoryOutputStream out;
+    PerfTrace::getInstance().writeChromeTrace(out);
+    return juce::JSON::parse(out.toString());
+}
+
+/// The complete ("X") events, and the thread names by tid
+void splitEvents(const juce::var& trace, juce::Array<juce::var>& zones, juce::NamedValueSet& threadNames)
+{
+    const auto* events = trace["traceEvents"].getArray();
+    REQUIRE(events != nullptr);
+
+    for (const auto& event : *events)
+    {
+        if (event["ph"].toString() == "X")
+            zones.add(event);
+        else if (event["name"].toString() == "thread_name")
+            threadNames.set(event["tid"].toString(), event["args"]["name"]);
+    }
+}
+} // namespace
+
+// ============================================================================
+// Trace Tests
+// ============================================================================
+
+TEST_CASE("PerfTrace records nothing while off", "[perftrace]")
+{
+    auto& trace = PerfTrace::getInstance();
+    trace.start();
+    trace.stop();
+    REQUIRE_FALSE(PerfTrace::isEnabled());
+
+    {
+        const PerfTrace::Zone zone("Ignored", "test");
+    }
+
+    REQUIRE(trace.getNumEvents() == 0);
+}
+
+TEST_CASE("PerfTrace exports a track per thread", "[perftrace]")
+{
+    auto& trace = PerfTrace::getInstance();
+    trace.start();
+    PerfTrace::nameThread("Test main");
+
+    {
+        const PerfTrace::Zone outer("Outer", "test");
+        juce::Thread::sleep(2);
+        const PerfTrace::Zone inner("Inner", "test");
+        juce::Thread::sleep(2);
+    }
+
+    TracedThread worker;
+    worker.startThread();
+    REQUIRE(worker.waitForThreadToExit(5000));
+
+    trace.stop();
+    REQUIRE(trace.getNumEvents() == 3);
+
+    juce::Array<juce::var> zones;
+    juce::NamedValueSet threadNames;
+    splitEvents(exportTrace(), zones, threadNames);
+
+    REQUIRE(zones.size() == 3);
+    REQUIRE(threadNames.size() == 2);
+
+    juce::var outer, inner, worked;
+    for (const auto& zone : zones)
+    {
+        const auto name = zone["name"].toString();
+        if (name == "Outer")
+            outer = zone;
+        else if (name == "Inner")
+            inner = zone;
+        else if (name == "Worker zone")
+            worked = zone;
+    }
+
+    REQUIRE(outer["cat"].toString() == "test");
+    REQUIRE(threadNames[outer["tid"].toString()].toString() == "Test main");
+    REQUIRE(threadNames[worked["tid"].toString()].toString() == "Trace Worker");
+    REQUIRE(outer["tid"] == inner["tid"]);
+    REQUIRE(outer["tid"] != worked["tid"]);
+
+    // Inner sits within Outer on the timeline
+    const double outerStart = outer["ts"];
+    const double innerStart = inner["ts"];
+    REQUIRE(innerStart >= outerStart);
+    REQUIRE(innerStart + static_cast<double>(inner["dur"]) <= outerStart + static_cast<double>(outer["dur"]));
+    REQUIRE(static_cast<double>(outer["dur"]) >= 4000.0);
+}
+
+TEST_CASE("PerfTrace keeps the newest zones when a thread's buffer wraps", "[perftrace]")
+{
+    auto& trace = PerfTrace::getInstance();
+    trace.start();
+
+    for (int i = 0; i < PerfTrace::eventsPerThread + 100; ++i)
+    {
+        const PerfTrace::Zone zone(i < 100 ? "Old" : "New", "test");
+    }
+
+    trace.stop();
+    REQUIRE(trace.getNumEvents() == PerfTrace::eventsPerThread);
+
+    juce::Array<juce::var> zones;
+    juce::NamedValueSet threadNames;
+    splitEvents(exportTrace(), zones, threadNames);
+
+    // The oldest slot is left out of a wrapped ring
+    REQUIRE(zones.size() == PerfTrace::eventsPerThread - 1);
+    for (const auto& zone : zones)
+        REQUIRE(zone["name"].toString() == "New");
+}
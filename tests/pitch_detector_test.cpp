@@ -0,0 +1,118 @@
+/**
+ * @file pitch_detector_test.cpp
+ * @brief Tests for the FFT-based YIN pitch detector used by the tuner
+ *
+ * These tests verify:
+ * 1. Guitar-range fundamentals are detected to within a cent
+ * 2. Longer windows resolve low B on bass
+ * 3. Silence and noise report no pitch
+ * 4. Window sizing follows the lowest frequency
+ */
+
+#include "../src/PitchDetector.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+#include <cmath>
+#include <vector>
+
+using Catch::Matchers::WithinAbs;
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+namespace
+{
+/// Plucked-string-like tone: fundamental plus decaying harmonics
+std::vector<float> makeTone(float frequency, double sampleRate, int length)
+{
+    std::vector<float> tone(static_cast<size_t>(length));
+    for (int i = 0; i < length; ++i)
+    {
+        const double t = i / sampleRate;
+        double sample = 0.0;
+        for (int harmonic = 1; harmonic <= 5; ++harmonic)
+            sample += std::sin(juce::MathConstants<double>::twoPi * frequency * harmonic * t) / harmonic;
+        tone[static_cast<size_t>(i)] = static_cast<float>(0.3 * sample);
+    }
+    return tone;
+}
+
+float getCentsError(float detected, float expected)
+{
+    return 1200.0f * std::log2(detected / expected);
+}
+} // namespace
+
+// ============================================================================
+// Detection Tests
+// ============================================================================
+
+TEST_CASE("PitchDetector finds guitar string fundamentals", "[pitchdetector]")
+{
+    constexpr double sampleRate = 48000.0;
+    PitchDetector detector;
+    detector.setWindowSize(PitchDetector::getWindowSizeFor(sampleRate, 70.0f));
+
+    for (float frequency : {82.41f, 110.0f, 146.83f, 196.0f, 246.94f, 329.63f})
+    {
+        const auto tone = makeTone(frequency, sampleRate, detector.getWindowSize());
+        const float detected = detector.detect(tone.data(), sampleRate);
+
+        INFO("Frequency " << frequency);
+        REQUIRE(detected > 0.0f);
+        REQUIRE_THAT(getCentsError(detected, frequency), WithinAbs(0.0, 1.0));
+    }
+}
+
+TEST_CASE("PitchDetector resolves bass low B with a longer window", "[pitchdetector]")
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr float lowB = 30.87f;
+
+    PitchDetector detector;
+    detector.setWindowSize(PitchDetector::getWindowSizeFor(sampleRate, 27.0f));
+
+    const auto tone = makeTone(lowB, sampleRate, detector.getWindowSize());
+    const float detected = detector.detect(tone.data(), sampleRate);
+
+    REQUIRE(detected > 0.0f);
+    REQUIRE_THAT(getCentsError(detected, lowB), WithinAbs(0.0, 1.0));
+}
+
+TEST_CASE("PitchDetector reports no pitch for silence and noise", "[pitchdetector]")
+{
+    PitchDetector detector;
+    detector.setWindowSize(2048);
+
+    std::vector<float> signal(2048, 0.0f);
+    REQUIRE(detector.detect(signal.data(), 48000.0) == 0.0f);
+
+    juce::Random random(42);
+    for (auto& sample : signal)
+        sample = random.nextFloat() * 2.0f - 1.0f;
+    REQUIRE(detector.detect(signal.data(), 48000.0) == 0.0f);
+}
+
+// ============================================================================
+// Window Size Tests
+// ============================================================================
+
+TEST_CASE("PitchDetector window grows for lower ranges", "[pitchdetector]")
+{
+    const int guitar = PitchDetector::getWindowSizeFor(48000.0, 70.0f);
+    const int bass = PitchDetector::getWindowSizeFor(48000.0, 27.0f);
+
+    REQUIRE(juce::isPowerOfTwo(guitar));
+    REQUIRE(juce::isPowerOfTwo(bass));
+    REQUIRE(bass > guitar);
+
+    // Lag search (W/2) must cover the lowest period
+    REQUIRE(bass / 2 > 48000.0 / 27.0);
+
+    PitchDetector detector;
+    detector.setWindowSize(3000);
+    REQUIRE(detector.getWindowSize() == 4096);
+}
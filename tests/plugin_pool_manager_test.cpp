@@ -7,6 +7,7 @@
  * 2. Boundary conditions (empty patches, single patch, edge positions)
  * 3. Preload range management
  * 4. Configuration setters
+ * 5. Media file extraction from patch state
  *
  * Note: These tests verify logic without actual plugin loading since
  * that requires full JUCE/audio initialization.
@@ -323,6 +324,81 @@ TEST_CASE("PluginPoolManager Extracts Nested Rack Plugins", "[poolmanager][rack]
     REQUIRE(hasRack);
 }
 
+namespace
+{
+/// A FILTER for an internal processor whose state is the given XML
+std::unique_ptr<juce::XmlElement> createInternalFilter(const juce::String& name, const juce::XmlElement& state)
+{
+    juce::PluginDescription desc;
+    desc.name = name;
+    desc.pluginFormatName = "Internal";
+    desc.fileOrIdentifier = name;
+
+    juce::MemoryBlock stateData;
+    juce::AudioProcessor::copyXmlToBinary(state, stateData);
+
+    auto stateElem = std::make_unique<juce::XmlElement>("STATE");
+    stateElem->addTextElement(stateData.toBase64Encoding());
+
+    auto filter = std::make_unique<juce::XmlElement>("FILTER");
+    filter->addChildElement(desc.createXml().release());
+    filter->addChildElement(stateElem.release());
+    return filter;
+}
+} // namespace
+
+TEST_CASE("PluginPoolManager Extracts Patch Media", "[poolmanager][media]")
+{
+    const auto root = juce::File::getSpecialLocation(juce::File::tempDirectory);
+    const auto backingTrack = root.getChildFile("Backing.wav");
+    const auto clickTrack = root.getChildFile("Click.wav");
+    const auto loop = root.getChildFile("Loop.wav");
+    const auto midiFile = root.getChildFile("Keys.mid");
+
+    juce::XmlElement preloadedPlayer("Pedalboard3FilePlayerSettings");
+    preloadedPlayer.setAttribute("file", backingTrack.getFullPathName());
+    preloadedPlayer.setAttribute("preload", true);
+
+    juce::XmlElement streamedPlayer("Pedalboard3FilePlayerSettings");
+    streamedPlayer.setAttribute("file", clickTrack.getFullPathName());
+
+    juce::XmlElement looper("Pedalboard3LooperSettings");
+    looper.setAttribute("soundFile", loop.getFullPathName());
+
+    juce::XmlElement midiPlayer("MidiFilePlayer");
+    midiPlayer.setAttribute("file", midiFile.getFullPathName());
+
+    // An empty player contributes nothing
+    juce::XmlElement emptyPlayer("Pedalboard3FilePlayerSettings");
+    emptyPlayer.setAttribute("file", "");
+
+    // The MIDI player sits inside a rack
+    juce::XmlElement rack("RACK");
+    rack.addChildElement(createInternalFilter("MIDI File Player", midiPlayer).release());
+
+    auto graphXml = std::make_unique<juce::XmlElement>("FILTERGRAPH");
+    graphXml->addChildElement(createInternalFilter("File Player", preloadedPlayer).release());
+    graphXml->addChildElement(createInternalFilter("File Player", streamedPlayer).release());
+    graphXml->addChildElement(createInternalFilter("File Player", emptyPlayer).release());
+    graphXml->addChildElement(createInternalFilter("Looper", looper).release());
+    graphXml->addChildElement(createInternalFilter("Effect Rack", rack).release());
+
+    juce::XmlElement patchXml("Patch");
+    patchXml.addChildElement(graphXml.release());
+
+    auto media = PluginPoolManager::extractMediaFromPatchForTest(&patchXml);
+
+    REQUIRE(media.size() == 4);
+    REQUIRE(media[0].file == backingTrack);
+    REQUIRE(media[0].kind == MediaReference::Kind::PreloadedAudio);
+    REQUIRE(media[1].file == clickTrack);
+    REQUIRE(media[1].kind == MediaReference::Kind::StreamedAudio);
+    REQUIRE(media[2].file == loop);
+    REQUIRE(media[2].kind == MediaReference::Kind::StreamedAudio);
+    REQUIRE(media[3].file == midiFile);
+    REQUIRE(media[3].kind == MediaReference::Kind::MidiFile);
+}
+
 // =============================================================================
 // Mutation Testing Patterns
 // =============================================================================
@@ -0,0 +1,160 @@
+/**
+ * @file preloaded_audio_test.cpp
+ * @brief Tests for whole-file preloading and the in-memory playback source
+ *
+ * These tests verify:
+ * 1. A file at the playback rate is preloaded sample for sample
+ * 2. A file at another rate is converted to the playback rate ahead of time
+ * 3. Seeks land on the exact sample
+ * 4. Looping wraps at the last sample, inside the block
+ * 5. Without looping, playback runs past the end so the transport stops
+ */
+
+#include "../src/PreloadedAudio.h"
+#include "TestAudioFiles.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+namespace
+{
+/// Sample i of channel c is i / 100000, negated on the right channel
+float rampSample(int channel, int index)
+{
+    const float value = static_cast<float>(index) / 100000.0f;
+    return channel == 0 ? value : -value;
+}
+
+juce::File writeRampFile(double sampleRate, int length)
+{
+    const auto file = tempTestFile("Pedalboard3PreloadTest", ".wav");
+
+    juce::AudioBuffer<float> audio(2, length);
+    for (int c = 0; c < 2; ++c)
+        for (int i = 0; i < length; ++i)
+            audio.setSample(c, i, rampSample(c, i));
+
+    writeTestWav(file, audio, sampleRate, 32);
+    return file;
+}
+
+std::shared_ptr<const juce::AudioBuffer<float>> preload(AudioPreloader& preloader, const juce::File& file,
+                                                        double sampleRate)
+{
+    preloader.load(file, sampleRate);
+    for (int i = 0; i < 500 && preloader.isLoading(); ++i)
+        juce::Thread::sleep(10);
+    return preloader.getAudio();
+}
+
+std::shared_ptr<const juce::AudioBuffer<float>> makeRamp(int length)
+{
+    auto audio = std::make_shared<juce::AudioBuffer<float>>(2, length);
+    for (int c = 0; c < 2; ++c)
+        for (int i = 0; i < length; ++i)
+            audio->setSample(c, i, rampSample(c, i));
+    return audio;
+}
+} // namespace
+
+// ============================================================================
+// Preloader Tests
+// ============================================================================
+
+TEST_CASE("AudioPreloader loads a file at the playback rate exactly", "[preload]")
+{
+    const auto file = writeRampFile(48000.0, 100000);
+    AudioPreloader preloader;
+
+    auto audio = preload(preloader, file, 48000.0);
+    REQUIRE(audio != nullptr);
+    REQUIRE(preloader.getFile() == file);
+    REQUIRE(preloader.getSampleRate() == 48000.0);
+    REQUIRE(audio->getNumChannels() == 2);
+    REQUIRE(audio->getNumSamples() == 100000);
+
+    for (int i : {0, 1, 65535, 65536, 99999})
+    {
+        REQUIRE(audio->getSample(0, i) == rampSample(0, i));
+        REQUIRE(audio->getSample(1, i) == rampSample(1, i));
+    }
+
+    preloader.clear();
+    REQUIRE(preloader.getAudio() == nullptr);
+    file.deleteFile();
+}
+
+TEST_CASE("AudioPreloader converts the sample rate ahead of time", "[preload]")
+{
+    const auto file = writeRampFile(44100.0, 88200);
+    AudioPreloader preloader;
+
+    auto audio = preload(preloader, file, 48000.0);
+    REQUIRE(audio != nullptr);
+    REQUIRE(preloader.getSampleRate() == 48000.0);
+
+    // Two seconds of audio either way
+    REQUIRE(audio->getNumSamples() == 96000);
+
+    // A ramp stays a ramp: output sample i sits at input position i * 44100 / 48000
+    for (int i : {1000, 48000, 90000})
+    {
+        const auto expected = static_cast<float>(i * 44100.0 / 48000.0 / 100000.0);
+        REQUIRE_THAT(audio->getSample(0, i), Catch::Matchers::WithinAbs(expected, 1.0e-4));
+        REQUIRE_THAT(audio->getSample(1, i), Catch::Matchers::WithinAbs(-expected, 1.0e-4));
+    }
+
+    file.deleteFile();
+}
+
+// ============================================================================
+// Playback Tests
+// ============================================================================
+
+TEST_CASE("PreloadedAudioSource seeks to the exact sample", "[preload]")
+{
+    PreloadedAudioSource source(makeRamp(10000));
+    juce::AudioBuffer<float> block(2, 64);
+
+    source.setNextReadPosition(1234);
+    source.getNextAudioBlock(juce::AudioSourceChannelInfo(block));
+
+    REQUIRE(block.getSample(0, 0) == rampSample(0, 1234));
+    REQUIRE(block.getSample(1, 63) == rampSample(1, 1234 + 63));
+    REQUIRE(source.getNextReadPosition() == 1234 + 64);
+}
+
+TEST_CASE("PreloadedAudioSource loops at the last sample", "[preload]")
+{
+    PreloadedAudioSource source(makeRamp(1000));
+    source.setLooping(true);
+    juce::AudioBuffer<float> block(2, 64);
+
+    source.setNextReadPosition(990);
+    source.getNextAudioBlock(juce::AudioSourceChannelInfo(block));
+
+    REQUIRE(block.getSample(0, 9) == rampSample(0, 999));
+    REQUIRE(block.getSample(0, 10) == rampSample(0, 0));
+    REQUIRE(block.getSample(0, 63) == rampSample(0, 53));
+    REQUIRE(source.getNextReadPosition() == 54);
+}
+
+TEST_CASE("PreloadedAudioSource runs past the end without looping", "[preload]")
+{
+    PreloadedAudioSource source(makeRamp(1000));
+    juce::AudioBuffer<float> block(2, 64);
+
+    source.setNextReadPosition(990);
+    source.getNextAudioBlock(juce::AudioSourceChannelInfo(block));
+
+    REQUIRE(block.getSample(0, 9) == rampSample(0, 999));
+    REQUIRE(block.getSample(0, 10) == 0.0f);
+    REQUIRE(block.getSample(1, 63) == 0.0f);
+
+    // AudioTransportSource stops once the position passes the length
+    REQUIRE(source.getNextReadPosition() > source.getTotalLength() + 1);
+}
@@ -0,0 +1,186 @@
+/**
+ * @file scope_capture_test.cpp
+ * @brief Tests for the oscilloscope's triggered, triple-buffered capture
+ *
+ * These tests verify:
+ * 1. Rising-edge frames start at the trigger level, on a rising slope
+ * 2. A frame held by the UI is never written while the audio side publishes more
+ * 3. Pitch sync locks every frame to the same phase of a harmonic-rich tone
+ * 4. Decimated frames keep each point's minimum and maximum
+ * 5. Without a trigger, the auto timeout still publishes frames
+ */
+
+#include "../src/ScopeCapture.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+#include <cmath>
+#include <vector>
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+namespace
+{
+constexpr double sampleRate = 48000.0;
+constexpr int blockSize = 256;
+
+/// A tone whose strong second harmonic crosses zero twice more per period
+float harmonicTone(double frequency, juce::int64 index)
+{
+    const double phase = juce::MathConstants<double>::twoPi * frequency * static_cast<double>(index) / sampleRate;
+    return static_cast<float>(0.4 * std::sin(phase) + 0.4 * std::sin(2.0 * phase + 1.2));
+}
+
+float sine(double frequency, juce::int64 index)
+{
+    return static_cast<float>(
+        0.5 * std::sin(juce::MathConstants<double>::twoPi * frequency * static_cast<double>(index) / sampleRate));
+}
+
+/// Pushes numSamples of generator in audio-sized blocks, starting at position
+template <typename Generator>
+juce::int64 pushSignal(ScopeCapture& capture, juce::int64 position, juce::int64 numSamples, Generator generator)
+{
+    std::vector<float> block(blockSize);
+    for (juce::int64 done = 0; done < numSamples; done += blockSize)
+    {
+        for (int i = 0; i < blockSize; ++i)
+            block[static_cast<size_t>(i)] = generator(position + done + i);
+        capture.push(block.data(), blockSize);
+    }
+    return position + numSamples;
+}
+} // namespace
+
+// ============================================================================
+// Trigger Tests
+// ============================================================================
+
+TEST_CASE("ScopeCapture starts frames on the rising edge", "[scope]")
+{
+    ScopeCapture capture;
+    capture.prepare(sampleRate);
+    capture.setTriggerMode(ScopeCapture::TriggerMode::RisingEdge);
+    capture.setTriggerLevel(0.25f);
+
+    REQUIRE(capture.acquireLatestFrame() == nullptr);
+
+    pushSignal(capture, 0, 24000, [](juce::int64 i) { return sine(220.0, i); });
+
+    const auto* frame = capture.acquireLatestFrame();
+    REQUIRE(frame != nullptr);
+    REQUIRE(frame->triggered);
+    REQUIRE(frame->decimation == 1);
+
+    // At most one sample's step past the level, and still rising
+    const float maxStep = static_cast<float>(0.5 * juce::MathConstants<double>::twoPi * 220.0 / sampleRate);
+    REQUIRE(frame->maximum[0] >= 0.25f);
+    REQUIRE(frame->maximum[0] < 0.25f + maxStep);
+    REQUIRE(frame->maximum[1] > frame->maximum[0]);
+
+    // Nothing new until more audio arrives
+    REQUIRE(capture.acquireLatestFrame() == nullptr);
+}
+
+TEST_CASE("ScopeCapture never writes the frame the UI holds", "[scope]")
+{
+    ScopeCapture capture;
+    capture.prepare(sampleRate);
+    capture.setTriggerMode(ScopeCapture::TriggerMode::FreeRun);
+
+    auto position = pushSignal(capture, 0, 1024, [](juce::int64 i) { return static_cast<float>(i) / 1.0e5f; });
+    const auto* held = capture.acquireLatestFrame();
+    REQUIRE(held != nullptr);
+
+    const auto copy = *held;
+    const auto firstSequence = held->sequence;
+
+    // Many more frames published while the UI is still drawing the held one
+    position = pushSignal(capture, position, 51200, [](juce::int64 i) { return -static_cast<float>(i) / 1.0e5f; });
+    REQUIRE(held->sequence == firstSequence);
+    REQUIRE(held->maximum == copy.maximum);
+
+    // The next acquire gets the newest complete frame
+    const auto* latest = capture.acquireLatestFrame();
+    REQUIRE(latest != nullptr);
+    REQUIRE(latest != held);
+    REQUIRE(latest->sequence > firstSequence);
+    REQUIRE(latest->maximum[ScopeCapture::frameSize - 1] == -static_cast<float>(position - 1) / 1.0e5f);
+}
+
+TEST_CASE("ScopeCapture pitch sync locks to the fundamental", "[scope]")
+{
+    ScopeCapture capture;
+    capture.prepare(sampleRate);
+    capture.setTriggerMode(ScopeCapture::TriggerMode::PitchSync);
+
+    auto tone = [](juce::int64 i) { return harmonicTone(110.0, i); };
+
+    // Let the tracking filter settle
+    auto position = pushSignal(capture, 0, 48000, tone);
+    REQUIRE(capture.acquireLatestFrame() != nullptr);
+
+    std::vector<float> starts;
+    for (int i = 0; i < 8; ++i)
+    {
+        position = pushSignal(capture, position, 4096, tone);
+        const auto* frame = capture.acquireLatestFrame();
+        REQUIRE(frame != nullptr);
+        REQUIRE(frame->triggered);
+        REQUIRE_THAT(frame->frequency, Catch::Matchers::WithinAbs(110.0, 2.0));
+        starts.push_back(frame->maximum[0]);
+    }
+
+    // Every frame begins at the same point of the period
+    for (auto start : starts)
+        REQUIRE_THAT(start, Catch::Matchers::WithinAbs(starts.front(), 0.05));
+}
+
+// ============================================================================
+// Timebase Tests
+// ============================================================================
+
+TEST_CASE("ScopeCapture keeps minimum and maximum when decimating", "[scope]")
+{
+    ScopeCapture capture;
+    capture.prepare(sampleRate);
+    capture.setTriggerMode(ScopeCapture::TriggerMode::FreeRun);
+    capture.setDecimation(12);
+    REQUIRE(capture.getDecimation() == 8);
+
+    // 3 kHz at 48 kHz: a full cycle every 16 samples, so every 8-sample point spans a peak or a trough
+    pushSignal(capture, 0, 8192, [](juce::int64 i) { return sine(3000.0, i); });
+
+    const auto* frame = capture.acquireLatestFrame();
+    REQUIRE(frame != nullptr);
+    REQUIRE(frame->decimation == 8);
+
+    float highest = -1.0f;
+    float lowest = 1.0f;
+    for (int i = 0; i < ScopeCapture::frameSize; ++i)
+    {
+        REQUIRE(frame->minimum[(size_t)i] <= frame->maximum[(size_t)i]);
+        highest = juce::jmax(highest, frame->maximum[(size_t)i]);
+        lowest = juce::jmin(lowest, frame->minimum[(size_t)i]);
+    }
+    REQUIRE_THAT(highest, Catch::Matchers::WithinAbs(0.5, 0.01));
+    REQUIRE_THAT(lowest, Catch::Matchers::WithinAbs(-0.5, 0.01));
+}
+
+TEST_CASE("ScopeCapture falls back to the auto timeout", "[scope]")
+{
+    ScopeCapture capture;
+    capture.prepare(sampleRate);
+    capture.setTriggerMode(ScopeCapture::TriggerMode::RisingEdge);
+
+    // Silence never crosses the level; a frame still arrives after the timeout
+    const auto timeout = static_cast<juce::int64>(sampleRate * ScopeCapture::autoTimeoutSeconds);
+    pushSignal(capture, 0, timeout + ScopeCapture::frameSize + blockSize, [](juce::int64) { return 0.0f; });
+
+    const auto* frame = capture.acquireLatestFrame();
+    REQUIRE(frame != nullptr);
+    REQUIRE_FALSE(frame->triggered);
+}
@@ -0,0 +1,195 @@
+/**
+ * @file stem_capture_test.cpp
+ * @brief Tests for the multichannel stem capture ring and its pre-roll
+ *
+ * These tests verify:
+ * 1. A take starts with the pre-roll audio pushed before start()
+ * 2. Per-stem mode writes one stereo file per channel pair
+ * 3. Polyphonic mode writes every channel to one file
+ * 4. A block that would overwrite unwritten audio is dropped and counted
+ */
+
+#include "../src/StemCapture.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+namespace
+{
+constexpr double sampleRate = 48000.0;
+constexpr int blockSize = 480;
+
+juce::File createTestFolder()
+{
+    auto folder = juce::File::getSpecialLocation(juce::File::tempDirectory)
+                      .getNonexistentChildFile("Pedalboard3StemCaptureTest", "", false);
+    folder.createDirectory();
+    return folder;
+}
+
+/// Channel c carries (c + 1) / 100 plus a ramp that encodes the sample's position
+float testSample(int channel, juce::int64 position)
+{
+    return static_cast<float>(channel + 1) / 100.0f + static_cast<float>(position % 1000) / 2000.0f;
+}
+
+/// Pushes numSamples of test signal in audio-sized blocks, starting at position
+juce::int64 pushSignal(StemCapture& capture, int numChannels, juce::int64 position, juce::int64 numSamples)
+{
+    juce::AudioBuffer<float> block(numChannels, blockSize);
+    for (juce::int64 done = 0; done < numSamples; done += blockSize)
+    {
+        for (int c = 0; c < numChannels; ++c)
+            for (int i = 0; i < blockSize; ++i)
+                block.setSample(c, i, testSample(c, position + done + i));
+
+        capture.push(block.getArrayOfReadPointers(), numChannels, blockSize);
+    }
+    return position + numSamples;
+}
+
+bool waitUntilStopped(const StemCapture& capture)
+{
+    for (int i = 0; i < 500 && capture.isRecording(); ++i)
+        juce::Thread::sleep(10);
+    return !capture.isRecording();
+}
+
+std::unique_ptr<juce::AudioFormatReader> openReader(const juce::File& file)
+{
+    juce::WavAudioFormat wav;
+    return std::unique_ptr<juce::AudioFormatReader>(wav.createReaderFor(new juce::FileInputStream(file), true));
+}
+} // namespace
+
+// ============================================================================
+// Pre-roll Tests
+// ============================================================================
+
+TEST_CASE("StemCapture starts a take with the pre-roll", "[stemcapture]")
+{
+    const auto folder = createTestFolder();
+    StemCapture capture;
+    capture.prepare(sampleRate, 2, 1.0);
+
+    // Three seconds of "show" before record is pressed; only the last second survives
+    auto position = pushSignal(capture, 2, 0, 144000);
+    REQUIRE(capture.start(folder, "Take", StemCapture::Format::Polyphonic, 32));
+    position = pushSignal(capture, 2, position, 24000);
+    capture.stop();
+    REQUIRE(waitUntilStopped(capture));
+
+    REQUIRE(capture.getFiles().size() == 1);
+    auto reader = openReader(capture.getFiles()[0]);
+    REQUIRE(reader != nullptr);
+    REQUIRE(reader->numChannels == 2);
+    REQUIRE(reader->lengthInSamples == 48000 + 24000);
+
+    juce::AudioBuffer<float> audio(2, static_cast<int>(reader->lengthInSamples));
+    reader->read(&audio, 0, audio.getNumSamples(), 0, true, true);
+
+    // The file begins exactly one pre-roll before start()
+    const juce::int64 firstPosition = 144000 - 48000;
+    for (int i : {0, 1, 47999, 48000, 71999})
+    {
+        REQUIRE_THAT(audio.getSample(0, i), Catch::Matchers::WithinAbs(testSample(0, firstPosition + i), 1.0e-6));
+        REQUIRE_THAT(audio.getSample(1, i), Catch::Matchers::WithinAbs(testSample(1, firstPosition + i), 1.0e-6));
+    }
+    REQUIRE(capture.getOverruns() == 0);
+
+    folder.deleteRecursively();
+}
+
+// ============================================================================
+// File Layout Tests
+// ============================================================================
+
+TEST_CASE("StemCapture writes one stereo file per stem", "[stemcapture]")
+{
+    const auto folder = createTestFolder();
+    StemCapture capture;
+    capture.prepare(sampleRate, 6, 0.0);
+
+    REQUIRE(capture.start(folder, "Take", StemCapture::Format::PerStem, 32));
+    pushSignal(capture, 6, 0, 9600);
+    capture.stop();
+    REQUIRE(waitUntilStopped(capture));
+
+    const auto files = capture.getFiles();
+    REQUIRE(files.size() == 3);
+
+    for (int stem = 0; stem < files.size(); ++stem)
+    {
+        REQUIRE(files[stem].getFileName().contains("Stem 0" + juce::String(stem + 1)));
+
+        auto reader = openReader(files[stem]);
+        REQUIRE(reader != nullptr);
+        REQUIRE(reader->numChannels == 2);
+        REQUIRE(reader->lengthInSamples == 9600);
+
+        juce::AudioBuffer<float> audio(2, 100);
+        reader->read(&audio, 0, 100, 0, true, true);
+        REQUIRE_THAT(audio.getSample(0, 10), Catch::Matchers::WithinAbs(testSample(stem * 2, 10), 1.0e-6));
+        REQUIRE_THAT(audio.getSample(1, 10), Catch::Matchers::WithinAbs(testSample(stem * 2 + 1, 10), 1.0e-6));
+    }
+
+    folder.deleteRecursively();
+}
+
+TEST_CASE("StemCapture writes a polyphonic file", "[stemcapture]")
+{
+    const auto folder = createTestFolder();
+    StemCapture capture;
+    capture.prepare(sampleRate, 8, 0.5);
+
+    pushSignal(capture, 8, 0, 4800);
+    REQUIRE(capture.start(folder, "Take", StemCapture::Format::Polyphonic, 24));
+    pushSignal(capture, 8, 4800, 4800);
+    capture.stop();
+    REQUIRE(waitUntilStopped(capture));
+
+    REQUIRE(capture.getFiles().size() == 1);
+    auto reader = openReader(capture.getFiles()[0]);
+    REQUIRE(reader != nullptr);
+    REQUIRE(reader->numChannels == 8);
+
+    // Less than a pre-roll was pushed first, so the take starts at the very beginning
+    REQUIRE(reader->lengthInSamples == 9600);
+    REQUIRE(capture.getSamplesWritten() == 9600);
+
+    folder.deleteRecursively();
+}
+
+// ============================================================================
+// Overrun Tests
+// ============================================================================
+
+TEST_CASE("StemCapture drops blocks that would overwrite unwritten audio", "[stemcapture]")
+{
+    const auto folder = createTestFolder();
+    auto& scheduler = DiskIOScheduler::getInstance();
+    scheduler.resetStats();
+
+    StemCapture capture;
+    capture.prepare(sampleRate, 2, 0.0, 0.1);
+
+    REQUIRE(capture.getHeadroom() == 1.0f);
+    REQUIRE(capture.start(folder, "Take", StemCapture::Format::Polyphonic, 16));
+
+    // Bigger than the whole ring, so it can never fit
+    juce::AudioBuffer<float> block(2, 9600);
+    block.clear();
+    capture.push(block.getArrayOfReadPointers(), 2, block.getNumSamples());
+    REQUIRE(capture.getOverruns() == 1);
+    REQUIRE(scheduler.getStats(DiskIOScheduler::Queue::Write).overruns == 1);
+
+    capture.stop();
+    REQUIRE(waitUntilStopped(capture));
+    REQUIRE(capture.getSamplesWritten() == 0);
+
+    folder.deleteRecursively();
+}
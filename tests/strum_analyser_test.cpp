@@ -0,0 +1,120 @@
+/**
+ * @file strum_analyser_test.cpp
+ * @brief Tests for the polyphonic (strum) tuner analysis
+ *
+ * These tests verify:
+ * 1. Every string of a strummed, detuned chord is measured to within 2 cents
+ * 2. Silence reports no strings
+ * 3. Tunings configure string count and window length
+ */
+
+#include "../src/StrumAnalyser.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+#include <cmath>
+#include <vector>
+
+using Catch::Matchers::WithinAbs;
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+namespace
+{
+constexpr double testSampleRate = 48000.0;
+
+/// Sum of decaying plucked strings, each with six 1/h harmonics
+std::vector<float> makeStrum(const std::vector<int>& midiNotes, const std::vector<float>& centsOffsets, int length)
+{
+    juce::Random random(7);
+    std::vector<float> strum(static_cast<size_t>(length), 0.0f);
+
+    for (size_t s = 0; s < midiNotes.size(); ++s)
+    {
+        const double frequency =
+            440.0 * std::pow(2.0, (midiNotes[s] - 69) / 12.0) * std::pow(2.0, centsOffsets[s] / 1200.0);
+
+        for (int h = 1; h <= 6; ++h)
+        {
+            const double phase = random.nextDouble() * juce::MathConstants<double>::twoPi;
+            for (int i = 0; i < length; ++i)
+            {
+                const double t = i / testSampleRate;
+                strum[static_cast<size_t>(i)] += static_cast<float>(
+                    0.1 / h * std::sin(juce::MathConstants<double>::twoPi * frequency * h * t + phase) *
+                    std::exp(-1.5 * t));
+            }
+        }
+    }
+    return strum;
+}
+} // namespace
+
+// ============================================================================
+// Analysis Tests
+// ============================================================================
+
+TEST_CASE("StrumAnalyser measures each string of a strummed chord", "[strum]")
+{
+    StrumAnalyser analyser;
+    analyser.prepare(testSampleRate, 0); // Standard
+
+    const auto& notes = StrumAnalyser::getTunings()[0].midiNotes;
+    const std::vector<float> offsets = {8.0f, -12.0f, 0.0f, 5.0f, -3.0f, 15.0f};
+    const auto strum = makeStrum(notes, offsets, analyser.getWindowSize());
+
+    StrumAnalyser::Results results;
+    REQUIRE(analyser.analyse(strum.data(), results) == 6);
+
+    for (size_t s = 0; s < notes.size(); ++s)
+    {
+        INFO("String " << s);
+        REQUIRE(results[s].detected);
+        REQUIRE(results[s].midiNote == notes[s]);
+        REQUIRE_THAT(results[s].cents, WithinAbs(offsets[s], 2.0));
+    }
+    REQUIRE_FALSE(results[6].detected);
+}
+
+TEST_CASE("StrumAnalyser reports nothing for silence", "[strum]")
+{
+    StrumAnalyser analyser;
+    analyser.prepare(testSampleRate, 0);
+
+    std::vector<float> silence(static_cast<size_t>(analyser.getWindowSize()), 0.0f);
+    StrumAnalyser::Results results;
+    const int numStrings = analyser.analyse(silence.data(), results);
+
+    for (int s = 0; s < numStrings; ++s)
+        REQUIRE_FALSE(results[static_cast<size_t>(s)].detected);
+}
+
+// ============================================================================
+// Tuning Tests
+// ============================================================================
+
+TEST_CASE("StrumAnalyser tunings set string count and window", "[strum]")
+{
+    const auto& tunings = StrumAnalyser::getTunings();
+    REQUIRE(tunings.size() >= 4);
+
+    for (const auto& tuning : tunings)
+        REQUIRE(static_cast<int>(tuning.midiNotes.size()) <= StrumAnalyser::maxStrings);
+
+    StrumAnalyser guitar, bass;
+    guitar.prepare(testSampleRate, 0);
+
+    int bassIndex = -1;
+    for (size_t i = 0; i < tunings.size(); ++i)
+        if (juce::String(tunings[i].name) == "Bass 5")
+            bassIndex = static_cast<int>(i);
+    REQUIRE(bassIndex >= 0);
+    bass.prepare(testSampleRate, bassIndex);
+
+    REQUIRE(guitar.getNumStrings() == 6);
+    REQUIRE(bass.getNumStrings() == 5);
+    REQUIRE(bass.getWindowSize() > guitar.getWindowSize());
+}
@@ -0,0 +1,172 @@
+/**
+ * @file true_peak_limiter_test.cpp
+ * @brief Tests for the output safety stage's look-ahead true-peak limiter
+ *
+ * These tests verify:
+ * 1. Audio under the threshold passes unchanged, delayed by the reported latency
+ * 2. Peaks between the samples are limited even when no sample reaches them
+ * 3. A sudden jump in level never passes the ceiling, thanks to the look-ahead
+ * 4. SafetyLimiterProcessor mutes on ultrasonic content but not on loud audio
+ */
+
+#include "../src/SafetyLimiter.h"
+#include "../src/TruePeakLimiter.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cmath>
+#include <vector>
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+namespace
+{
+constexpr double sampleRate = 48000.0;
+constexpr int blockSize = 256;
+
+std::vector<float> sine(double frequency, float amplitude, int numSamples, double phase = 0.0)
+{
+    std::vector<float> signal(static_cast<size_t>(numSamples));
+    for (int i = 0; i < numSamples; ++i)
+        signal[static_cast<size_t>(i)] = amplitude * static_cast<float>(std::sin(
+                                                         juce::MathConstants<double>::twoPi * frequency * i / sampleRate +
+                                                         phase));
+    return signal;
+}
+
+/// Limits a mono signal in place, a block at a time
+void limit(TruePeakLimiter& limiter, std::vector<float>& signal, int block = blockSize)
+{
+    for (size_t done = 0; done < signal.size(); done += static_cast<size_t>(block))
+    {
+        float* channels[] = {signal.data() + done};
+        limiter.process(channels, 1, juce::jmin(block, static_cast<int>(signal.size() - done)));
+    }
+}
+
+/// Reference true peak from [from, to): 16x interpolation with a long windowed sinc
+float truePeak(const std::vector<float>& signal, int from, int to)
+{
+    constexpr int halfLength = 64;
+    float peak = 0.0f;
+    for (int n = from; n < to; ++n)
+    {
+        for (int step = 0; step < 16; ++step)
+        {
+            const double t = n + step / 16.0;
+            double y = 0.0;
+            for (int k = n - halfLength + 1; k <= n + halfLength; ++k)
+            {
+                if (k < 0 || k >= static_cast<int>(signal.size()))
+                    continue;
+                const double d = t - k;
+                const double sinc = d == 0.0 ? 1.0 : std::sin(juce::MathConstants<double>::pi * d) /
+                                                         (juce::MathConstants<double>::pi * d);
+                y += signal[static_cast<size_t>(k)] * sinc *
+                     (0.5 + 0.5 * std::cos(juce::MathConstants<double>::pi * d / halfLength));
+            }
+            peak = juce::jmax(peak, static_cast<float>(std::abs(y)));
+        }
+    }
+    return peak;
+}
+} // namespace
+
+// ============================================================================
+// TruePeakLimiter Tests
+// ============================================================================
+
+TEST_CASE("TruePeakLimiter passes quiet audio through with its latency", "[limiter]")
+{
+    TruePeakLimiter limiter;
+    limiter.prepare(sampleRate, blockSize);
+    const int latency = limiter.getLatencySamples();
+    REQUIRE(latency > 0);
+
+    const auto input = sine(440.0, 0.5f, 8192);
+    auto output = input;
+
+    // Blocks longer than prepared for are split up internally
+    limit(limiter, output, 1024);
+
+    for (int i = 0; i < latency; ++i)
+        REQUIRE(output[static_cast<size_t>(i)] == 0.0f);
+    for (size_t i = static_cast<size_t>(latency); i < output.size(); ++i)
+        REQUIRE(output[i] == input[i - static_cast<size_t>(latency)]);
+}
+
+TEST_CASE("TruePeakLimiter limits peaks between the samples", "[limiter]")
+{
+    TruePeakLimiter limiter;
+    limiter.prepare(sampleRate, blockSize);
+
+    // A quarter of the sample rate, sampled 45 degrees off its peaks: every sample is
+    // at 0.85 but the waveform peaks at 1.2
+    auto signal = sine(sampleRate / 4.0, 1.2f, 8192, juce::MathConstants<double>::pi / 4.0);
+    REQUIRE(truePeak(signal, 1024, 1536) > 1.15f);
+
+    limit(limiter, signal);
+    REQUIRE(truePeak(signal, 4096, 4608) <= TruePeakLimiter::defaultCeiling + 0.005f);
+}
+
+TEST_CASE("TruePeakLimiter catches a sudden jump with its look-ahead", "[limiter]")
+{
+    TruePeakLimiter limiter;
+    limiter.prepare(sampleRate, blockSize);
+
+    constexpr int jump = 3000;
+    auto signal = sine(1000.0, 1.5f, 8192);
+    for (int i = 0; i < jump; ++i)
+        signal[static_cast<size_t>(i)] *= 0.1f;
+
+    limit(limiter, signal);
+
+    // Not a single sample over the ceiling, from the jump onwards
+    for (auto sample : signal)
+        REQUIRE(std::abs(sample) <= TruePeakLimiter::defaultCeiling + 0.001f);
+    REQUIRE(truePeak(signal, jump, jump + 1024) <= TruePeakLimiter::defaultCeiling + 0.005f);
+}
+
+// ============================================================================
+// SafetyLimiterProcessor Tests
+// ============================================================================
+
+TEST_CASE("SafetyLimiterProcessor mutes on ultrasonic content only", "[limiter]")
+{
+    SafetyLimiterProcessor processor;
+    processor.prepareToPlay(sampleRate, blockSize);
+    REQUIRE(processor.getLatencySamples() > 0);
+
+    auto run = [&](double frequency, float amplitude)
+    {
+        juce::AudioBuffer<float> buffer(2, blockSize);
+        juce::MidiBuffer midi;
+        for (int done = 0; done < static_cast<int>(sampleRate); done += blockSize)
+        {
+            const auto block = sine(frequency, amplitude, blockSize, juce::MathConstants<double>::twoPi * frequency *
+                                                                          done / sampleRate);
+            for (int ch = 0; ch < 2; ++ch)
+                buffer.copyFrom(ch, 0, block.data(), blockSize);
+            processor.processBlock(buffer, midi);
+        }
+    };
+
+    SECTION("A loud tone is limited, not muted")
+    {
+        run(1000.0, 1.0f);
+        REQUIRE_FALSE(processor.isMuted());
+        REQUIRE(processor.isLimiting());
+
+        run(12000.0, 1.0f);
+        REQUIRE_FALSE(processor.isMuted());
+    }
+
+    SECTION("Sustained content above 18kHz mutes")
+    {
+        run(20000.0, 0.5f);
+        REQUIRE(processor.isMuted());
+        REQUIRE(processor.checkAndClearMuteTriggered());
+    }
+}
@@ -0,0 +1,94 @@
+/**
+ * @file ui_frame_scheduler_test.cpp
+ * @brief Tests for the shared display-refresh tick and its version counters
+ *
+ * These tests verify:
+ * 1. A DisplayVersion reports each batch of bumps once
+ * 2. Clients run at their own rate on any refresh rate, without catching up after a stall
+ * 3. A client can delete another from its callback
+ */
+
+#include "../src/UiFrameScheduler.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <memory>
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+namespace
+{
+/// Runs frames at refreshHz for the given time, starting at startMs; returns the time after the last
+double runFrames(UiFrameScheduler& scheduler, double refreshHz, double seconds, double startMs = 1000.0)
+{
+    const double periodMs = 1000.0 / refreshHz;
+    const int numFrames = static_cast<int>(seconds * refreshHz);
+    for (int i = 0; i < numFrames; ++i)
+        scheduler.dispatchFrame(startMs + i * periodMs);
+    return startMs + numFrames * periodMs;
+}
+} // namespace
+
+// ============================================================================
+// Scheduler Tests
+// ============================================================================
+
+TEST_CASE("DisplayVersion reports new data once", "[uiframescheduler]")
+{
+    DisplayVersion version;
+    juce::uint32 seen = 0;
+
+    REQUIRE_FALSE(version.changedSince(seen));
+
+    version.bump();
+    version.bump();
+    REQUIRE(version.changedSince(seen));
+    REQUIRE_FALSE(version.changedSince(seen));
+
+    version.bump();
+    REQUIRE(version.changedSince(seen));
+}
+
+TEST_CASE("UiFrameScheduler runs each client at its own rate", "[uiframescheduler]")
+{
+    UiFrameScheduler scheduler;
+    int everyFrame = 0, at60 = 0, at20 = 0;
+    UiFrameScheduler::Client all(nullptr, 0.0, [&]() { ++everyFrame; }, scheduler);
+    UiFrameScheduler::Client sixty(nullptr, 60.0, [&]() { ++at60; }, scheduler);
+    UiFrameScheduler::Client twenty(nullptr, 20.0, [&]() { ++at20; }, scheduler);
+    REQUIRE(scheduler.getNumClients() == 3);
+
+    // A 144 Hz display still gives 60 and 20 updates a second on average
+    const double endMs = runFrames(scheduler, 144.0, 2.0);
+    REQUIRE(everyFrame == 288);
+    REQUIRE(at60 >= 118);
+    REQUIRE(at60 <= 121);
+    REQUIRE(at20 >= 39);
+    REQUIRE(at20 <= 41);
+
+    // After a stall (minimised window, modal loop), a client runs once rather than in a burst
+    at20 = 0;
+    scheduler.dispatchFrame(endMs + 5000.0);
+    scheduler.dispatchFrame(endMs + 5001.0);
+    scheduler.dispatchFrame(endMs + 5002.0);
+    REQUIRE(at20 == 1);
+}
+
+TEST_CASE("UiFrameScheduler copes with a client deleting another", "[uiframescheduler]")
+{
+    UiFrameScheduler scheduler;
+    int victimCalls = 0;
+    auto victim = std::make_unique<UiFrameScheduler::Client>(nullptr, 0.0, [&]() { ++victimCalls; }, scheduler);
+    UiFrameScheduler::Client killer(nullptr, 0.0, [&]() { victim.reset(); }, scheduler);
+    REQUIRE(scheduler.getNumClients() == 2);
+
+    scheduler.dispatchFrame(1000.0);
+    scheduler.dispatchFrame(1016.0);
+
+    // Whichever ran first in that frame, the victim never ran after it was deleted
+    REQUIRE(victim == nullptr);
+    REQUIRE(victimCalls <= 1);
+    REQUIRE(scheduler.getNumClients() == 1);
+}
@@ -0,0 +1,216 @@
+/**
+ * @file waveform_cache_test.cpp
+ * @brief Tests for the waveform overview pyramid and its background, on-disk cache
+ *
+ * These tests verify:
+ * 1. Every level of the pyramid gives the same peaks as the audio it was built from
+ * 2. A pyramid survives being written and read back, and a bad stream is rejected
+ * 3. The cache builds in the background, saves to disk, and finds renamed files by hash
+ * 4. A saved pyramid isn't reused for a file edited in a way its hash doesn't see
+ */
+
+#include "../src/WaveformCache.h"
+#include "TestAudioFiles.h"
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <cmath>
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+namespace
+{
+constexpr double sampleRate = 48000.0;
+constexpr float tolerance = 1.0f / 127.0f;
+
+juce::File tempFile(const juce::String& suffix)
+{
+    return tempTestFile("Pedalboard3WaveformCacheTest", suffix);
+}
+
+/// A sine in the left channel whose level ramps up from 0 to 1, and silence in the right
+juce::AudioBuffer<float> makeRamp(int length)
+{
+    juce::AudioBuffer<float> audio(2, length);
+    audio.clear();
+    for (int i = 0; i < length; ++i)
+        audio.setSample(0, i, std::sin(static_cast<float>(i) * 0.05f) * static_cast<float>(i) / length);
+    return audio;
+}
+
+juce::File writeRampFile(int length)
+{
+    const auto file = tempFile(".wav");
+    writeTestWav(file, makeRamp(length), sampleRate, 32);
+    return file;
+}
+
+WaveformPyramid buildPyramid(const juce::AudioBuffer<float>& audio, int blockSize)
+{
+    WaveformPyramid pyramid(audio.getNumChannels(), sampleRate);
+    juce::AudioBuffer<float> block(audio.getNumChannels(), blockSize);
+    for (int pos = 0; pos < audio.getNumSamples(); pos += blockSize)
+    {
+        const int n = juce::jmin(blockSize, audio.getNumSamples() - pos);
+        for (int c = 0; c < audio.getNumChannels(); ++c)
+            block.copyFrom(c, 0, audio, c, pos, n);
+        pyramid.addBlock(block, n);
+    }
+    pyramid.finish();
+    return pyramid;
+}
+
+bool waitUntilIdle(const WaveformCache& cache)
+{
+    for (int i = 0; i < 500 && cache.isBusy(); ++i)
+        juce::Thread::sleep(10);
+    return !cache.isBusy();
+}
+} // namespace
+
+// ============================================================================
+// Pyramid Tests
+// ============================================================================
+
+TEST_CASE("WaveformPyramid keeps the peaks at every level", "[waveformcache]")
+{
+    const int length = 100000;
+    const auto audio = makeRamp(length);
+
+    // An odd block size, so bins straddle blocks
+    const auto pyramid = buildPyramid(audio, 1000);
+    REQUIRE(pyramid.getNumSamples() == length);
+    REQUIRE(pyramid.getLengthSeconds() == Catch::Approx(length / sampleRate));
+    const int samplesPerBin = WaveformPyramid::baseSamplesPerBin;
+    REQUIRE(pyramid.getNumBins(0) == (length + samplesPerBin - 1) / samplesPerBin);
+    REQUIRE(pyramid.getNumBins(pyramid.getNumLevels() - 1) == 1);
+
+    // Spans of every size, each read from the level that suits it
+    for (juce::int64 span : {256, 1000, 5000, 40000, 100000})
+    {
+        const juce::int64 start = length - span;
+        const auto expected = audio.findMinMax(0, static_cast<int>(start), static_cast<int>(span));
+        const auto range = pyramid.getRange(0, start, length);
+
+        // Coarser bins can reach a little past the span, but never miss a peak inside it
+        REQUIRE(range.getEnd() >= expected.getEnd() - tolerance);
+        REQUIRE(range.getStart() <= expected.getStart() + tolerance);
+        REQUIRE(range.getEnd() <= 1.0f);
+    }
+
+    // The whole file, from the top level
+    const auto peak = audio.findMinMax(0, 0, length).getEnd();
+    REQUIRE(pyramid.getRange(0, 0, length).getEnd() == Catch::Approx(peak).margin(tolerance));
+
+    // The silent channel stays silent
+    REQUIRE(pyramid.getRange(1, 0, length).isEmpty());
+    REQUIRE(pyramid.getRange(1, 0, length).getStart() == 0.0f);
+}
+
+TEST_CASE("WaveformPyramid round-trips through a stream", "[waveformcache]")
+{
+    const int length = 30000;
+    const auto pyramid = buildPyramid(makeRamp(length), 4096);
+
+    juce::MemoryOutputStream out;
+    pyramid.writeTo(out);
+
+    WaveformPyramid loaded;
+    juce::MemoryInputStream in(out.getData(), out.getDataSize(), false);
+    REQUIRE(loaded.readFrom(in));
+    REQUIRE(loaded.getNumChannels() == 2);
+    REQUIRE(loaded.getSampleRate() == sampleRate);
+    REQUIRE(loaded.getNumSamples() == length);
+    REQUIRE(loaded.getNumLevels() == pyramid.getNumLevels());
+    REQUIRE(loaded.getMemoryUsage() == pyramid.getMemoryUsage());
+
+    for (juce::int64 start = 0; start < length; start += 2500)
+        REQUIRE(loaded.getRange(0, start, start + 2500) == pyramid.getRange(0, start, start + 2500));
+
+    // Truncated data is rejected rather than half-read
+    juce::MemoryInputStream truncated(out.getData(), out.getDataSize() / 2, false);
+    WaveformPyramid bad;
+    REQUIRE_FALSE(bad.readFrom(truncated));
+    REQUIRE(bad.getNumSamples() == 0);
+}
+
+// ============================================================================
+// Cache Tests
+// ============================================================================
+
+TEST_CASE("WaveformCache builds in the background and reuses its disk cache", "[waveformcache]")
+{
+    auto& cache = WaveformCache::getInstance();
+    const auto folder = tempFile("");
+    cache.setDirectory(folder);
+    cache.clear();
+
+    const int length = 96000;
+    const auto file = writeRampFile(length);
+
+    // Nothing yet; it's queued
+    REQUIRE(cache.get(file) == nullptr);
+    REQUIRE(waitUntilIdle(cache));
+
+    const auto pyramid = cache.get(file);
+    REQUIRE(pyramid != nullptr);
+    REQUIRE(pyramid->getNumSamples() == length);
+    REQUIRE(pyramid->getNumChannels() == 2);
+
+    const auto saved = folder.getChildFile(WaveformCache::getFileHash(file) + ".pbwf");
+    REQUIRE(saved.existsAsFile());
+    REQUIRE(saved.getSize() < static_cast<juce::int64>(pyramid->getMemoryUsage()));
+
+    // The same audio under another name is found by its hash, and read back rather than rebuilt
+    const auto hash = WaveformCache::getFileHash(file);
+    const auto renamed = tempFile(".wav");
+    REQUIRE(file.moveFileTo(renamed));
+    REQUIRE(WaveformCache::getFileHash(renamed) == hash);
+
+    cache.clear();
+    REQUIRE(cache.get(renamed) == nullptr);
+    REQUIRE(waitUntilIdle(cache));
+
+    const auto reloaded = cache.get(renamed);
+    REQUIRE(reloaded != nullptr);
+    REQUIRE(reloaded->getNumSamples() == length);
+    REQUIRE(reloaded->getRange(0, 0, length) == pyramid->getRange(0, 0, length));
+    REQUIRE(folder.findChildFiles(juce::File::findFiles, false, "*.pbwf").size() == 1);
+
+    // An edit in the middle keeps the length and the hashed ends, but the saved pyramid isn't reused.
+    // 0x3f bytes read as 0.75 at any alignment, so the silent channel picks up a peak.
+    const auto modified = renamed.getLastModificationTime();
+    {
+        juce::FileOutputStream out(renamed);
+        REQUIRE(out.openedOk());
+        REQUIRE(out.setPosition(renamed.getSize() / 2));
+        REQUIRE(out.writeRepeatedByte(0x3f, 4096));
+    }
+    REQUIRE(renamed.setLastModificationTime(modified + juce::RelativeTime::seconds(10)));
+    REQUIRE(WaveformCache::getFileHash(renamed) == hash);
+
+    cache.clear();
+    REQUIRE(cache.get(renamed) == nullptr);
+    REQUIRE(waitUntilIdle(cache));
+
+    const auto edited = cache.get(renamed);
+    REQUIRE(edited != nullptr);
+    REQUIRE(edited->getRange(1, 0, length).getEnd() > 0.7f);
+    REQUIRE(folder.findChildFiles(juce::File::findFiles, false, "*.pbwf").size() == 1);
+
+    // Something that isn't audio isn't retried every time it's asked for
+    const auto junk = tempFile(".wav");
+    REQUIRE(junk.replaceWithText("not audio"));
+    REQUIRE(cache.get(junk) == nullptr);
+    REQUIRE(waitUntilIdle(cache));
+    REQUIRE(cache.get(junk) == nullptr);
+    REQUIRE_FALSE(cache.isBusy());
+
+    cache.clear();
+    renamed.deleteFile();
+    junk.deleteFile();
+    folder.deleteRecursively();
+}